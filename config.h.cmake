@@ -82,6 +82,7 @@
 #cmakedefine USE_GEOTIFF 1
 #cmakedefine USE_UDUNITS 1
 #cmakedefine USE_EIGEN 1
+#cmakedefine USE_BLAS 1
 #cmakedefine USE_PNGLIB 1
 #cmakedefine USE_WINGDI_NOT_WINGCC 1
 #endif
@@ -18,6 +18,7 @@
 
 #include "arrayindex.hpp"
 #include "allix.hpp"
+#include "simd_dispatch.hpp"
  
 // older versions of gcc put the vtable into this file (where destructor is defined)
 AllIxBaseT::~AllIxBaseT() {}
@@ -55,6 +56,53 @@ SizeT AllIxIndicesT::size() const
 return ref->N_Elements();
 }
 
+// block-wise access of the index arrays of the integer and real types,
+// through the kernels of simd_dispatch.cpp
+static int IndexType( DType t)
+{
+  switch( t)
+    {
+    case GDL_BYTE: return SIMD_IX_BYTE;
+    case GDL_INT: return SIMD_IX_INT;
+    case GDL_UINT: return SIMD_IX_UINT;
+    case GDL_LONG: return SIMD_IX_LONG;
+    case GDL_ULONG: return SIMD_IX_ULONG;
+    case GDL_LONG64: return SIMD_IX_LONG64;
+    case GDL_ULONG64: return SIMD_IX_ULONG64;
+    case GDL_FLOAT: return SIMD_IX_FLOAT;
+    case GDL_DOUBLE: return SIMD_IX_DOUBLE;
+    default: return -1; // STRING (conversion warnings), COMPLEX
+    }
+}
+
+bool AllIxIndicesT::BlockAccess() const
+{
+  return IndexType( ref->Type()) >= 0;
+}
+
+void AllIxIndicesT::IndexBlock( SizeT* ix, SizeT s, SizeT n) const
+{
+  assert( upperSet);
+  assert( s + n <= size());
+  int t = IndexType( ref->Type());
+  if( t < 0)
+    {
+      AllIxBaseT::IndexBlock( ix, s, n);
+      return;
+    }
+  const char* v = static_cast<const char*>( ref->DataAddr()) + s * ref->Sizeof();
+  SimdIndex( static_cast<SimdIndexType>( t), ix, v, n, upper);
+}
+
+// the range check as a separate pass, IndexBlock() need not check then
+bool AllIxIndicesStrictT::BlockAccess() const
+{
+  assert( upperSet);
+  int t = IndexType( ref->Type());
+  if( t < 0) return false;
+  return SimdIndexInRange( static_cast<SimdIndexType>( t), ref->DataAddr(), size(), upper);
+}
+
 SizeT AllIxIndicesStrictT::operator[]( SizeT i) const
 {
 assert( upperSet);
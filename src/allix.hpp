@@ -34,6 +34,15 @@ public:
   virtual SizeT InitSeqAccess() = 0;
   virtual SizeT SeqAccess() =0;
 
+  // block-wise access for the (parallel) gather and scatter of
+  // Data_::Index() and AssignAt(): true if IndexBlock() can be used,
+  // which then neither throws nor warns
+  virtual bool BlockAccess() const { return false;}
+  // ix[k] = (*this)[ s + k] for k < n
+  virtual void IndexBlock( SizeT* ix, SizeT s, SizeT n) const
+  {
+    for( SizeT k = 0; k < n; ++k) ix[ k] = (*this)[ s + k];
+  }
 };
 class AllIxT: public AllIxBaseT
 {
@@ -299,6 +308,9 @@ public:
   SizeT SeqAccess(); // code in arrayindex.cpp
   
   SizeT size() const;
+  // for index arrays of the integer and real types (code in allix.cpp)
+  bool BlockAccess() const;
+  void IndexBlock( SizeT* ix, SizeT s, SizeT n) const;
   void SetUpper( SizeT u)
   {
   upper = u;
@@ -328,6 +340,8 @@ public:
   SizeT operator[]( SizeT i) const; // code in arrayindex.cpp
   SizeT InitSeqAccess();
   SizeT SeqAccess(); // code in arrayindex.cpp
+  // false also if a subscript is out of range (the sequential access throws)
+  bool BlockAccess() const;
 };
 
 
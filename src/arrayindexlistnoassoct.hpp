@@ -266,6 +266,19 @@ public:
     return allIx;
   }
 
+  // strided view of the indexed elements, if not indexed by an array
+  bool StridedView( StridedViewT& view)
+  {
+    if( ix->Indexed() || nIx <= 1)
+      return false;
+    SizeT ixStride = ix->GetStride();
+    view.offset = ix->GetS();
+    view.dim[0] = nIx;
+    view.stride[0] = (ixStride <= 1) ? 1 : ixStride;
+    view.rank = 1;
+    return true;
+  }
+
   // returns one dim long ix in case of one element array index
   // used by AssignAt functions
   SizeT LongIx() const
@@ -315,6 +328,22 @@ public:
     return var->Index( this);
   }
 
+  BaseGDL* IndexView( BaseGDL* var, IxExprListT& ix_, StridedViewReaderT& reader)
+  {
+    Init( ix_);
+    if( ix->Scalar())
+      return var->NewIx( ix->GetIx0());
+    SetVariable( var);
+    StridedViewT view;
+    if( StridedView( view))
+      {
+	BaseGDL* res = reader.Read( var, view);
+	if( res != NULL)
+	  return res;
+      }
+    return var->Index( this);
+  }
+
   // returns multi-dim index for 1st element
   // used by InsAt functions
   const dimension GetDimIx0( SizeT& destStart)
@@ -328,6 +357,8 @@ public:
   { 
     return 1;
   }
+
+  bool SingleIndexed() { return ix->Type() == ArrayIndexIndexedID;}
 }; //class ArrayIndexListOneT: public ArrayIndexListT
 
 
@@ -1678,6 +1709,25 @@ public:
     nIx = stride[acRank];
   }
 
+  // strided view for index lists without indexed subscripts (NORMAL access)
+  bool StridedView( StridedViewT& view)
+  {
+    if( accessType != NORMAL || nIterLimitGt1 == 0)
+      return false;
+    for( SizeT i=0; i<acRank; ++i)
+      if( ixList[i]->Indexed())
+	return false;
+    view.offset = baseIx;
+    for( SizeT i=0; i<acRank; ++i)
+      {
+	SizeT ixStride = ixList[i]->GetStride();
+	view.dim[ i] = nIterLimit[ i];
+	view.stride[ i] = ((ixStride <= 1) ? 1 : ixStride) * varStride[ i];
+      }
+    view.rank = acRank;
+    return true;
+  }
+
   // structure of indexed expression
   const dimension GetDim()
   {
@@ -1787,6 +1837,27 @@ public:
     return var->Index( this);
   }
 
+  BaseGDL* IndexView( BaseGDL* var, IxExprListT& ix, StridedViewReaderT& reader)
+  {
+    Init( ix);
+    SetVariable( var);
+    if( nIx == 1 && accessType != ALLINDEXED)
+    {
+      BaseGDL* res = var->NewIx( baseIx);
+      if( accessType != ALLONE)
+	res->MakeArrayFromScalar();
+      return res;
+    }
+    StridedViewT view;
+    if( StridedView( view))
+      {
+	BaseGDL* res = reader.Read( var, view);
+	if( res != NULL)
+	  return res;
+      }
+    return var->Index( this);
+  }
+
   // returns multi-dim index for 1st element
   // used by InsAt functions
   const dimension GetDimIx0( SizeT& destStart)
@@ -18,8 +18,88 @@
 #ifndef ARRAYINDEXLISTT_HPP_
 #define ARRAYINDEXLISTT_HPP_
 
+#include <algorithm>
+
 #include "arrayindex.hpp"
 
+// the elements selected by subscripts without index arrays (ranges,
+// strides, '*' and scalars, see ArrayIndexListT::StridedView()): element
+// (i0,i1,...) of var[ix] is var[ offset + i0*stride[0] + i1*stride[1] + ...],
+// i_d < dim[d]
+struct StridedViewT
+{
+  SizeT offset;
+  SizeT dim[ MAXRANK];
+  SizeT stride[ MAXRANK];
+  SizeT rank;
+
+  // merges the dimensions which are contiguous in var, drops those of size 1
+  void Merge()
+  {
+    SizeT r = 0;
+    for( SizeT d = 0; d < rank; ++d)
+      {
+	if( dim[ d] == 1) continue;
+	if( r > 0 && stride[ d] == stride[ r - 1] * dim[ r - 1])
+	  dim[ r - 1] *= dim[ d];
+	else
+	  {
+	    dim[ r] = dim[ d];
+	    stride[ r++] = stride[ d];
+	  }
+      }
+    rank = r;
+  }
+
+  // copies the elements start to stop-1 of var[ix] (from src, the data of
+  // var) to dst, by runs along the first dimension
+  template<typename T>
+  void Gather( const T* src, T* dst, SizeT start, SizeT stop) const
+  {
+    if( rank == 0)
+      {
+	if( start < stop) dst[ 0] = src[ offset];
+	return;
+      }
+    SizeT len = dim[ 0], step = stride[ 0];
+    SizeT pos[ MAXRANK];
+    SizeT rest = start / len, i0 = start % len, ix = offset;
+    for( SizeT d = 1; d < rank; ++d)
+      {
+	pos[ d] = rest % dim[ d];
+	rest /= dim[ d];
+	ix += pos[ d] * stride[ d];
+      }
+    while( start < stop)
+      {
+	SizeT n = (len - i0 < stop - start) ? len - i0 : stop - start;
+	const T* s = src + ix + i0 * step;
+	if( step == 1) std::copy( s, s + n, dst);
+	else for( SizeT i = 0; i < n; ++i) dst[ i] = s[ i * step];
+	dst += n;
+	start += n;
+	i0 = 0;
+	for( SizeT d = 1; d < rank; ++d) // next run
+	  {
+	    ix += stride[ d];
+	    if( ++pos[ d] < dim[ d]) break;
+	    ix -= pos[ d] * stride[ d];
+	    pos[ d] = 0;
+	  }
+      }
+  }
+};
+
+// reads the elements of var[ix] in place (see ArrayIndexListT::IndexView())
+class StridedViewReaderT
+{
+public:
+  virtual ~StridedViewReaderT() {}
+  // the result for var[ix], or NULL if var[ix] must be built (e.g. the
+  // type of var is not handled)
+  virtual BaseGDL* Read( BaseGDL* var, const StridedViewT& view) = 0;
+};
+
 class ArrayIndexListT
 {
 protected:
@@ -88,10 +168,23 @@ public:
   // this is called from the interpreter and ARRAYEXPRNode::Eval()
   virtual BaseGDL* Index( BaseGDL* var, IxExprListT& ix) = 0;
 
+  // strided view of the indexed elements (after SetVariable()), only for
+  // subscripts without index arrays selecting more than one element
+  virtual bool StridedView( StridedViewT& view) { return false;}
+
+  // as Index(), but when the elements selected have a strided view, the
+  // result is reader.Read() of it (if not NULL): var[ix] is not built
+  virtual BaseGDL* IndexView( BaseGDL* var, IxExprListT& ix, StridedViewReaderT& reader)
+  { return Index( var, ix);}
+
   // returns multi-dim index for 1st element
   // used by InsAt functions
   virtual const dimension GetDimIx0( SizeT& destStart) = 0;
   virtual SizeT NDim() = 0;
+
+  // one non-constant index expression [ix], no range and no other
+  // dimension (used for the fused a[WHERE(...)]=... assignment)
+  virtual bool SingleIndexed() { return false;}
 };
 
 
@@ -296,6 +389,19 @@ public:
     return allIx;
   }
 
+  // strided view of the indexed elements, if not indexed by an array
+  bool StridedView( StridedViewT& view)
+  {
+    if( ix->Indexed() || nIx <= 1)
+      return false;
+    SizeT ixStride = ix->GetStride();
+    view.offset = ix->GetS();
+    view.dim[0] = nIx;
+    view.stride[0] = (ixStride <= 1) ? 1 : ixStride;
+    view.rank = 1;
+    return true;
+  }
+
   // returns one dim long ix in case of one element array index
   // used by AssignAt functions
   SizeT LongIx() const
@@ -361,6 +467,8 @@ public:
   { 
     return 1;
   }
+
+  bool SingleIndexed() { return ix->Type() == ArrayIndexIndexedID;}
 }; //class ArrayIndexListOneT: public ArrayIndexListT
 
 
@@ -1555,6 +1663,25 @@ public:
     stride[acRank]=stride[acRank-1]*nIterLimit[acRank-1]; // index stride
   }
 
+  // strided view for index lists without indexed subscripts (NORMAL access)
+  bool StridedView( StridedViewT& view)
+  {
+    if( accessType != NORMAL || nIterLimitGt1 == 0)
+      return false;
+    for( SizeT i=0; i<acRank; ++i)
+      if( ixList[i]->Indexed())
+	return false;
+    view.offset = baseIx;
+    for( SizeT i=0; i<acRank; ++i)
+      {
+	SizeT ixStride = ixList[i]->GetStride();
+	view.dim[ i] = nIterLimit[ i];
+	view.stride[ i] = ((ixStride <= 1) ? 1 : ixStride) * varStride[ i];
+      }
+    view.rank = acRank;
+    return true;
+  }
+
   // structure of indexed expression
   const dimension GetDim()
   {
@@ -68,6 +68,8 @@ extern "C" char **environ;
 #include "typedefs.hpp"
 #include "base64.hpp"
 #include "objects.hpp"
+#include "reduce.hpp"
+#include "arrayindexlistt.hpp"
 //#include "file.hpp"
 
 
@@ -2610,66 +2612,31 @@ namespace lib {
     return new T(sum);
   }
  
+  // floating point values: fixed-block compensated sums of reduce.hpp, whose result does not depend
+  // on the number of threads (integer sums above are exact, hence reproducible anyway).
+  template<>
+  BaseGDL* total_template_generic(DFloatGDL* src, bool omitNaN)
+  {
+    return new DFloatGDL(ReduceTotal(&(*src)[0], src->N_Elements(), omitNaN));
+  }
+
+  template<>
+  BaseGDL* total_template_generic(DDoubleGDL* src, bool omitNaN)
+  {
+    return new DDoubleGDL(ReduceTotal(&(*src)[0], src->N_Elements(), omitNaN));
+  }
+
   template<>
   BaseGDL* total_template_generic(DComplexGDL* src, bool omitNaN)
   {
-    //    std::cerr << " total_template_generic_DComplexGdl " << std::endl;
-    SizeT nEl = src->N_Elements();
-    DFloat sr = 0;
-    DFloat si = 0;
-    if (!omitNaN) {
-#pragma omp  parallel for if (nEl >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= nEl)) reduction(+:sr,si)
-      for (SizeT i = 0; i < nEl; ++i) {
-        sr += (*src)[i].real();
-        si += (*src)[i].imag();
-      }
-    } else {
-#pragma omp  parallel if (nEl >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= nEl))
-      {
-        DFloat lsr = 0;
-        DFloat lsi = 0;
-#pragma omp for nowait
-        for (SizeT i = 0; i < nEl; ++i) {
-          if (isfinite((*src)[i].real())) lsr += (*src)[i].real();
-          if (isfinite((*src)[i].imag())) lsi += (*src)[i].imag();
-        }
-#pragma omp atomic
-        sr += lsr;
-        si += lsi;
-      }
-    }
-    return new DComplexGDL(std::complex<float>(sr, si));
+    DComplexDbl sum = ReduceTotal(&(*src)[0], src->N_Elements(), omitNaN);
+    return new DComplexGDL(DComplex(sum.real(), sum.imag()));
   }
 
   template<>
   BaseGDL* total_template_generic(DComplexDblGDL* src, bool omitNaN)
   {
-    //    std::cerr << " total_template_generic_DcomplexGDlDbl " << std::endl;
-    SizeT nEl = src->N_Elements();
-    DDouble sr = 0;
-    DDouble si = 0;
-    if (!omitNaN) {
-#pragma omp  parallel for if (nEl >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= nEl)) reduction(+:sr,si)
-      for (SizeT i = 0; i < nEl; ++i) {
-        sr += (*src)[i].real();
-        si += (*src)[i].imag();
-      }
-    } else {
-#pragma omp  parallel if (nEl >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= nEl))
-      {
-        DDouble lsr = 0;
-        DDouble lsi = 0;
-#pragma omp for nowait
-        for (SizeT i = 0; i < nEl; ++i) {
-          if (isfinite((*src)[i].real())) lsr += (*src)[i].real();
-          if (isfinite((*src)[i].imag())) lsi += (*src)[i].imag();
-        }
-#pragma omp atomic
-        sr += lsr;
-        si += lsi;
-      }
-    }
-    return new DComplexDblGDL(std::complex<double>(sr, si));
+    return new DComplexDblGDL(ReduceTotal(&(*src)[0], src->N_Elements(), omitNaN));
   }
 
   // total over all elements, done on Double. Avoids costly convert! 
@@ -2677,49 +2644,13 @@ namespace lib {
   template<class T>
   DDoubleGDL* total_template_double(T* src, bool omitNaN)
   {
-    //   std::cerr<<" total_template_double "<<std::endl;
-    SizeT nEl = src->N_Elements();
-    DDouble sum = 0;
-    if (!omitNaN) {
-#pragma omp  parallel for if (nEl >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= nEl)) reduction(+:sum)
-      for (SizeT i = 0; i < nEl; ++i) sum += (*src)[ i];
-    } else {
-#pragma omp  parallel if (nEl >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= nEl))
-      {
-        DDouble localsum = 0;
-#pragma omp for nowait
-        for (SizeT i = 0; i < nEl; ++i) {
-          if (isfinite((*src)[i])) localsum += (*src)[ i];
-        }
-#pragma omp atomic
-        sum += localsum;
-      }
-    }
-    return new DDoubleGDL(sum);
+    return new DDoubleGDL(ReduceTotal(&(*src)[0], src->N_Elements(), omitNaN));
   }
 
   template<class T>
   DFloatGDL* total_template_single(T* src, bool omitNaN)
   {
-    //   std::cerr<<" total_template_single "<<std::endl;
-    SizeT nEl = src->N_Elements();
-    DDouble sum = 0;
-    if (!omitNaN) {
-#pragma omp  parallel for if (nEl >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= nEl)) reduction(+:sum)
-      for (SizeT i = 0; i < nEl; ++i) sum += (*src)[ i];
-    } else {
-#pragma omp  parallel if (nEl >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= nEl))
-      {
-        DDouble localsum = 0;
-#pragma omp for nowait
-        for (SizeT i = 0; i < nEl; ++i) {
-          if (isfinite((*src)[i])) localsum += (*src)[ i];
-        }
-#pragma omp atomic
-        sum += localsum;
-      }
-    }
-    return new DFloatGDL(sum);
+    return new DFloatGDL(ReduceTotal(&(*src)[0], src->N_Elements(), omitNaN));
   }
 
   //special case for /INT  using LONG64
@@ -2730,8 +2661,9 @@ namespace lib {
     //   std::cerr<<" total_template_integer "<<std::endl;
     SizeT nEl = src->N_Elements();
     DLong64 sum = 0;
+    // each value is converted to integer before the (exact) sum: sum += float would go through float.
 #pragma omp  parallel for if (nEl >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= nEl)) reduction(+:sum)
-    for (SizeT i = 0; i < nEl; ++i) sum += (*src)[ i];
+    for (OMPInt i = 0; i < nEl; ++i) sum += static_cast<DLong64>((*src)[ i]);
     return new DLong64GDL(sum);
   }
 
@@ -2764,9 +2696,7 @@ namespace lib {
        #pragma omp parallel for if (CpuTPOOL_NTHREADS >1 && nEl >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= nEl))
       for (SizeT i = 0; i < nEl; ++i) NaN2Zero(res[i]);
     }
-    //this formulation is slightly faster on my machine
-    for (SizeT i = 1, ii = 0; i < nEl; ++i, ++ii)  res[i] += res[ii];
-//      for (SizeT i = 1; i < nEl; ++i) res[i] += res[i-1];
+    PrefixScan<ScanAdd>(res, nEl);
     return val;
   }
 
@@ -2787,38 +2717,19 @@ namespace lib {
 
     // sumStride is also the number of linear src indexing
     SizeT sumStride = srcDim.Stride(sumDimIx);
-    SizeT outerStride = srcDim.Stride(sumDimIx + 1);
-    SizeT sumLimit = nSum * sumStride;
 
-    if (omitNaN) {
-#pragma omp parallel if ((nEl/outerStride)*sumStride >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= (nEl/outerStride)*sumStride))
-      {
-#pragma omp for
-        for (SizeT o = 0; o < nEl; o += outerStride) {
-          SizeT rIx = (o / outerStride) * sumStride;
-          for (SizeT i = 0; i < sumStride; ++i) {
-            SizeT oi = o + i;
-            SizeT oiLimit = sumLimit + oi;
-            for (SizeT s = oi; s < oiLimit; s += sumStride) AddOmitNaN((*res)[ rIx], (*src)[ s]);
-            ++rIx;
-          }
-        }
-      }
-    } else {
-#pragma omp parallel if ((nEl/outerStride)*sumStride >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= (nEl/outerStride)*sumStride))
-      {
-#pragma omp for
-        for (SizeT o = 0; o < nEl; o += outerStride) {
-          SizeT rIx = (o / outerStride) * sumStride;
-          for (SizeT i = 0; i < sumStride; ++i) {
-            SizeT oi = o + i;
-            SizeT oiLimit = sumLimit + oi;
-            for (SizeT s = oi; s < oiLimit; s += sumStride) (*res)[ rIx] += (*src)[ s];
-            ++rIx;
-          }
-        }
+    // whole rows of the slice are added to the result slice (see ReduceAlongDim)
+    ReduceAlongDim(nEl, nSum, sumStride, [&](SizeT o, SizeT c0, SizeT nc) {
+      typename T::Ty* r = &(*res)[o * sumStride + c0];
+      const typename T::Ty* s = &(*src)[o * nSum * sumStride + c0];
+      if (omitNaN) {
+        for (SizeT k = 0; k < nSum; ++k, s += sumStride)
+          for (SizeT c = 0; c < nc; ++c) AddOmitNaN(r[c], s[c]);
+      } else {
+        for (SizeT k = 0; k < nSum; ++k, s += sumStride)
+          for (SizeT c = 0; c < nc; ++c) r[c] += s[c];
       }
-    }
+    });
     return res;
   }
 
@@ -2834,19 +2745,56 @@ namespace lib {
     res=static_cast<T2*>(val->DataAddr());
     const dimension& valDim = val->Dim();
     if (omitNaN) {
-      for (SizeT i = 0; i < nEl; ++i)
+#pragma omp parallel for if (CpuTPOOL_NTHREADS >1 && nEl >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= nEl))
+      for (OMPInt i = 0; i < nEl; ++i)
         NaN2Zero(res[i]);
     }
     SizeT cumStride = valDim.Stride(sumDimIx);
     SizeT outerStride = valDim.Stride(sumDimIx + 1);
-    for (SizeT o = 0; o < nEl; o += outerStride) {
-      SizeT cumLimit = o + outerStride;
-      for (SizeT i = o + cumStride, ii = o; i < cumLimit; ++i, ++ii)
-        res[ i] += res[ ii];
-    }
+    PrefixScanDim<ScanAdd>(res, nEl, cumStride, outerStride);
     return val;
   }
 
+  // the sum of ReduceTotal() of the elements of var selected by view, gathered block by block
+  template<class T>
+  static auto total_of_view(T* var, const StridedViewT& view, SizeT nEl)
+    -> decltype(ReduceTotal(static_cast<const typename T::Ty*>(NULL), nEl, false))
+  {
+    const typename T::Ty* src = &(*var)[0];
+    return ReduceTotalGathered<typename T::Ty>(nEl, false, [src, &view](typename T::Ty* buf, SizeT start, SizeT stop) {
+      view.Gather(src, buf, start, stop);
+    });
+  }
+
+  // TOTAL(var[ix]) without other parameter or keyword, ix selecting a strided view of
+  // var (see FCALL_LIB_RETNEWNode::TotalView()): the same result as total_fun(), but
+  // var[ix] is not built. NULL for the types not handled.
+  BaseGDL* total_view(BaseGDL* var, const StridedViewT& view)
+  {
+    StridedViewT v = view;
+    v.Merge();
+    SizeT nEl = 1;
+    for (SizeT d = 0; d < v.rank; ++d) nEl *= v.dim[d];
+    switch (var->Type()) {
+    case GDL_BYTE: return new DFloatGDL(total_of_view(static_cast<DByteGDL*> (var), v, nEl));
+    case GDL_INT: return new DFloatGDL(total_of_view(static_cast<DIntGDL*> (var), v, nEl));
+    case GDL_UINT: return new DFloatGDL(total_of_view(static_cast<DUIntGDL*> (var), v, nEl));
+    case GDL_LONG: return new DFloatGDL(total_of_view(static_cast<DLongGDL*> (var), v, nEl));
+    case GDL_ULONG: return new DFloatGDL(total_of_view(static_cast<DULongGDL*> (var), v, nEl));
+    case GDL_LONG64: return new DDoubleGDL(total_of_view(static_cast<DLong64GDL*> (var), v, nEl));
+    case GDL_ULONG64: return new DDoubleGDL(total_of_view(static_cast<DULong64GDL*> (var), v, nEl));
+    case GDL_FLOAT: return new DFloatGDL(total_of_view(static_cast<DFloatGDL*> (var), v, nEl));
+    case GDL_DOUBLE: return new DDoubleGDL(total_of_view(static_cast<DDoubleGDL*> (var), v, nEl));
+    case GDL_COMPLEX:
+    {
+      DComplexDbl sum = total_of_view(static_cast<DComplexGDL*> (var), v, nEl);
+      return new DComplexGDL(DComplex(sum.real(), sum.imag()));
+    }
+    case GDL_COMPLEXDBL: return new DComplexDblGDL(total_of_view(static_cast<DComplexDblGDL*> (var), v, nEl));
+    default: return NULL;
+    }
+  }
+
   BaseGDL* total_fun(EnvT* e)
   {
 
@@ -3443,36 +3391,26 @@ namespace lib {
     return new T(prod);
   }
   
+  // floating point values: fixed-block products of reduce.hpp, independent of the number of threads
+  template<>
+  BaseGDL* product_template( DFloatGDL* src, bool omitNaN) {
+    return new DFloatGDL(ReduceProduct(&(*src)[0], src->N_Elements(), omitNaN));
+  }
+
+  template<>
+  BaseGDL* product_template( DDoubleGDL* src, bool omitNaN) {
+    return new DDoubleGDL(ReduceProduct(&(*src)[0], src->N_Elements(), omitNaN));
+  }
+
   template<>
   BaseGDL* product_template( DComplexGDL* src, bool omitNaN) {
-    DComplexGDL::Ty prod = 1;
-    SizeT nEl = src->N_Elements();
-    if (!omitNaN) {
-      for (SizeT i = 0; i < nEl; ++i) {
-        prod *= (*src)[ i];
-      }
-    } else {
-      for (SizeT i = 0; i < nEl; ++i) {
-        MultOmitNaN(prod, (*src)[ i]);
-      }
-    }
-    return new DComplexGDL(prod);
+    DComplexDbl prod = ReduceProduct(&(*src)[0], src->N_Elements(), omitNaN);
+    return new DComplexGDL(DComplex(prod.real(), prod.imag()));
   }
   
   template<>
   BaseGDL* product_template( DComplexDblGDL* src, bool omitNaN) {
-    DComplexDblGDL::Ty prod = 1;
-    SizeT nEl = src->N_Elements();
-    if (!omitNaN) {
-      for (SizeT i = 0; i < nEl; ++i) {
-        prod *= (*src)[ i];
-      }
-    } else {
-      for (SizeT i = 0; i < nEl; ++i) {
-        MultOmitNaN(prod, (*src)[ i]);
-      }
-    }
-    return new DComplexDblGDL(prod);
+    return new DComplexDblGDL(ReduceProduct(&(*src)[0], src->N_Elements(), omitNaN));
   }
   
   // cumulative over all dims
@@ -3480,11 +3418,11 @@ namespace lib {
   BaseGDL* product_cu_template( T* res, bool omitNaN) {
     SizeT nEl = res->N_Elements();
     if (omitNaN) {
-      for (SizeT i = 0; i < nEl; ++i)
+#pragma omp parallel for if (CpuTPOOL_NTHREADS >1 && nEl >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= nEl))
+      for (OMPInt i = 0; i < nEl; ++i)
         Nan2One((*res)[i]);
     }
-    for (SizeT i = 1, ii = 0; i < nEl; ++i, ++ii)
-      (*res)[i] *= (*res)[ii];
+    PrefixScan<ScanMult>(&(*res)[0], nEl);
     return res;
   }
 
@@ -3548,16 +3486,13 @@ namespace lib {
     SizeT nEl = res->N_Elements();
     const dimension& resDim = res->Dim();
     if (omitNaN) {
-      for (SizeT i = 0; i < nEl; ++i)
+#pragma omp parallel for if (CpuTPOOL_NTHREADS >1 && nEl >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= nEl))
+      for (OMPInt i = 0; i < nEl; ++i)
         Nan2One((*res)[i]);
     }
     SizeT cumStride = resDim.Stride(sumDimIx);
     SizeT outerStride = resDim.Stride(sumDimIx + 1);
-    for (SizeT o = 0; o < nEl; o += outerStride) {
-      SizeT cumLimit = o + outerStride;
-      for (SizeT i = o + cumStride, ii = o; i < cumLimit; ++i, ++ii)
-        (*res)[ i] *= (*res)[ ii];
-    }
+    PrefixScanDim<ScanMult>(&(*res)[0], nEl, cumStride, outerStride);
     return res;
   }
 
@@ -3969,6 +3904,100 @@ namespace lib {
     return new DByteGDL( result ? 1 : 0 );
   }
 
+  // MIN and MAX along a dimension for the real types, by whole rows (see
+  // ReduceAlongDim), with the rules of Data_::MinMax: the first extremum
+  // wins, omitNaN skips the non-finite values (a column without finite value
+  // gives its first value, at index 0), ABSOLUTE compares absolute values.
+  inline DFloat minmax_abs(DFloat v) { return fabsf(v); }
+  inline DDouble minmax_abs(DDouble v) { return fabs(v); }
+  inline DLong64 minmax_abs(DInt v) { return llabs(v); }
+  inline DLong64 minmax_abs(DLong v) { return llabs(v); }
+  inline DLong64 minmax_abs(DLong64 v) { return llabs(v); }
+  template<typename Ty> inline Ty minmax_abs(Ty v) { return v; } // unsigned
+
+  template<bool useAbs> struct MinMaxLess {
+    template<typename Ty> static bool Less(Ty a, Ty b) { return a < b; }
+  };
+  template<> struct MinMaxLess<true> {
+    template<typename Ty> static bool Less(Ty a, Ty b) { return minmax_abs(a) < minmax_abs(b); }
+  };
+
+  template<typename T, bool useAbs>
+  static void minmax_over_dim_template(T* src, SizeT nSearch, SizeT searchStride, bool omitNaN,
+    DLongGDL* minE, DLongGDL* maxE, T* minVal, T* maxVal) {
+    typedef typename T::Ty Ty;
+    const Ty* d = &(*src)[0];
+    ReduceAlongDim(src->N_Elements(), nSearch, searchStride, [&](SizeT o, SizeT c0, SizeT nc) {
+      Ty mn[REDUCE_COLUMNS], mx[REDUCE_COLUMNS];
+      SizeT imn[REDUCE_COLUMNS], imx[REDUCE_COLUMNS];
+      bool found[REDUCE_COLUMNS];
+      SizeT base = o * nSearch * searchStride + c0;
+      for (SizeT c = 0; c < nc; ++c) {
+        mn[c] = mx[c] = d[base + c];
+        imn[c] = imx[c] = base + c;
+        found[c] = !omitNaN || std::isfinite(d[base + c]);
+      }
+      for (SizeT k = 1; k < nSearch; ++k) {
+        SizeT row = base + k * searchStride;
+        if (omitNaN) {
+          for (SizeT c = 0; c < nc; ++c) {
+            Ty v = d[row + c];
+            if (!std::isfinite(v)) continue;
+            if (!found[c]) {
+              mn[c] = mx[c] = v;
+              imn[c] = imx[c] = row + c;
+              found[c] = true;
+              continue;
+            }
+            if (MinMaxLess<useAbs>::Less(v, mn[c])) { mn[c] = v; imn[c] = row + c; }
+            if (MinMaxLess<useAbs>::Less(mx[c], v)) { mx[c] = v; imx[c] = row + c; }
+          }
+        } else {
+          for (SizeT c = 0; c < nc; ++c) {
+            Ty v = d[row + c];
+            if (MinMaxLess<useAbs>::Less(v, mn[c])) { mn[c] = v; imn[c] = row + c; }
+            if (MinMaxLess<useAbs>::Less(mx[c], v)) { mx[c] = v; imx[c] = row + c; }
+          }
+        }
+      }
+      SizeT rIx = o * searchStride + c0;
+      for (SizeT c = 0; c < nc; ++c, ++rIx) {
+        if (!found[c]) imn[c] = imx[c] = 0; // only NaNs
+        if (minE != NULL) (*minE)[rIx] = imn[c];
+        if (maxE != NULL) (*maxE)[rIx] = imx[c];
+        if (minVal != NULL) (*minVal)[rIx] = mn[c];
+        if (maxVal != NULL) (*maxVal)[rIx] = mx[c];
+      }
+    });
+  }
+
+  template<typename T>
+  static void minmax_over_dim_run(BaseGDL* p0, SizeT nSearch, SizeT searchStride, bool omitNaN, bool useAbs,
+    DLongGDL* minE, DLongGDL* maxE, BaseGDL* minVal, BaseGDL* maxVal) {
+    if (useAbs) minmax_over_dim_template<T, true>(static_cast<T*> (p0), nSearch, searchStride, omitNaN,
+      minE, maxE, static_cast<T*> (minVal), static_cast<T*> (maxVal));
+    else minmax_over_dim_template<T, false>(static_cast<T*> (p0), nSearch, searchStride, omitNaN,
+      minE, maxE, static_cast<T*> (minVal), static_cast<T*> (maxVal));
+  }
+
+  // false for the types left to Data_::MinMax (complex, string)
+  static bool minmax_over_dim(BaseGDL* p0, SizeT nSearch, SizeT searchStride, bool omitNaN, bool useAbs,
+    DLongGDL* minE, DLongGDL* maxE, BaseGDL* minVal, BaseGDL* maxVal) {
+    switch (p0->Type()) {
+    // no ABSOLUTE for the unsigned types, as in Data_::MinMax
+    case GDL_BYTE: minmax_over_dim_run<DByteGDL>(p0, nSearch, searchStride, false, false, minE, maxE, minVal, maxVal); return true;
+    case GDL_UINT: minmax_over_dim_run<DUIntGDL>(p0, nSearch, searchStride, false, false, minE, maxE, minVal, maxVal); return true;
+    case GDL_ULONG: minmax_over_dim_run<DULongGDL>(p0, nSearch, searchStride, false, false, minE, maxE, minVal, maxVal); return true;
+    case GDL_ULONG64: minmax_over_dim_run<DULong64GDL>(p0, nSearch, searchStride, false, false, minE, maxE, minVal, maxVal); return true;
+    case GDL_INT: minmax_over_dim_run<DIntGDL>(p0, nSearch, searchStride, false, useAbs, minE, maxE, minVal, maxVal); return true;
+    case GDL_LONG: minmax_over_dim_run<DLongGDL>(p0, nSearch, searchStride, false, useAbs, minE, maxE, minVal, maxVal); return true;
+    case GDL_LONG64: minmax_over_dim_run<DLong64GDL>(p0, nSearch, searchStride, false, useAbs, minE, maxE, minVal, maxVal); return true;
+    case GDL_FLOAT: minmax_over_dim_run<DFloatGDL>(p0, nSearch, searchStride, omitNaN, useAbs, minE, maxE, minVal, maxVal); return true;
+    case GDL_DOUBLE: minmax_over_dim_run<DDoubleGDL>(p0, nSearch, searchStride, omitNaN, useAbs, minE, maxE, minVal, maxVal); return true;
+    default: return false;
+    }
+  }
+
   BaseGDL* min_fun( EnvT* e) {
     SizeT nParam = e->NParam(1);
     BaseGDL* searchArr = e->GetParDefined(0);
@@ -4024,7 +4053,9 @@ namespace lib {
         minElArr = new DLongGDL(destDim);
       }
 
-      SizeT rIx = 0;
+      // real types by rows, else (complex, string) one Data_::MinMax per output
+      if (!minmax_over_dim(searchArr, nSearch, searchStride, omitNaN, absSet,
+                           minElArr, maxElArr, resArr, (maxSet ? maxVal : NULL)))
 #pragma omp parallel if ((nEl/outerStride)*searchStride >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= (nEl/outerStride)*searchStride))
       {
 #pragma omp for
@@ -4130,6 +4161,9 @@ namespace lib {
         maxElArr = new DLongGDL(destDim);
       }
 
+      // real types by rows, else (complex, string) one Data_::MinMax per output
+      if (!minmax_over_dim(searchArr, nSearch, searchStride, omitNaN, absSet,
+                           minElArr, maxElArr, (minSet ? minVal : NULL), resArr))
 #pragma omp parallel if ((nEl/outerStride)*searchStride >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= (nEl/outerStride)*searchStride))
       {
 #pragma omp for
@@ -4409,21 +4443,6 @@ namespace lib {
   }
 
 #undef ELEM_SWAP
-  //input-protected versions of above
-   DFloat quick_select_f_protect_input(const DFloat data[], SizeT arraySize, int even) { 
-    DFloat * array=(DFloat*)malloc(arraySize*sizeof(DFloat));
-    for (SizeT i = 0; i < arraySize; ++i) array[i]=data[i];
-    DFloat res=quick_select_f(array, arraySize, even);
-    free(array);
-    return res;
-   } 
-   DDouble quick_select_d_protect_input(const DDouble data[], SizeT arraySize, int even) {
-    DDouble * array=(DDouble*)malloc(arraySize*sizeof(DDouble));
-    for (SizeT i = 0; i < arraySize; ++i) array[i]=data[i];
-    DDouble res=quick_select_d(array, arraySize, even);
-    free(array);
-    return res;
-   }
   
   //simple median for double arrays with no NaNs.
   inline BaseGDL* mymedian_d(EnvT* e) {
@@ -4460,29 +4479,6 @@ namespace lib {
     free(array);
     return res;
   }
-  //simple median for double arrays whith NaNs. Remove the Nans before doing the median.
-  inline DDouble quick_select_d_filter_nan( const DDouble* arr, SizeT nEl, int even) {
-    DLong iEl = 0;
-    DDouble* array=(DDouble*)malloc(nEl*sizeof(DDouble));
-    for (SizeT i = 0; i < nEl; ++i) {
-      if (!isnan( arr[i]) ) {
-        array[iEl] = arr[i];
-        iEl++;
-      }
-    }
-    if (iEl == 0) {
-      free(array);
-      return std::numeric_limits<double>::quiet_NaN();
-    }
-    DDouble res=quick_select_d(array, iEl, even);
-    free(array);
-    return res;
-  }
-
-  inline bool hasnan_d( DDouble* arr, SizeT nEl) {
-    for (SizeT i=0; i< nEl; ++i) if (isnan( arr[i])) return true;
-    return false;
-  }
   
  inline BaseGDL* mymedian_f(EnvT* e) {
     DFloatGDL* array = e->GetParAs<DFloatGDL>(0)->Dup(); //original array is protected
@@ -4519,30 +4515,111 @@ namespace lib {
     return res;
   }
   
-  inline DFloat quick_select_f_filter_nan(const DFloat* arr, SizeT nEl, int even){
-    DLong iEl = 0;
-    DFloat * array=(DFloat*)malloc(nEl*sizeof(DFloat));
-    for (SizeT i = 0; i < nEl; ++i) {
-      if (!isnan( arr[i]) ) {
-        array[iEl] = arr[i];
-        iEl++;
+  
+  BaseGDL* SlowReliableMedian(EnvT* e); //see below.
+
+  // median of the n values of buf (which is reordered), ignoring NaNs if omitNaN (NaN if no value is left).
+  // With 'even', the median of an even number of values is the mean of the two middle ones.
+  template<typename T>
+  inline T median_select(T* buf, SizeT n, bool even, bool omitNaN) {
+    if (omitNaN) {
+      SizeT k = 0;
+      for (SizeT i = 0; i < n; ++i) if (!std::isnan(buf[i])) buf[k++] = buf[i];
+      n = k;
+      if (n == 0) return std::numeric_limits<T>::quiet_NaN();
+    }
+    SizeT mid = n / 2;
+    std::nth_element(buf, buf + mid, buf + n);
+    if (even && (n % 2) == 0) return 0.5 * (buf[mid] + *std::max_element(buf, buf + mid));
+    return buf[mid];
+  }
+
+#define MEDIAN_DIM_BLOCK 64 //slices gathered together when the median dimension is not the first one
+#define MEDIAN_DIM_BUFFER 32768 //max number of elements of the per-thread gather buffer (fits in L1/L2)
+
+  // MEDIAN(array, DIMENSION=dim): the array is seen as [inner, depth, outer] with depth the median dimension.
+  // Slices are not transposed beforehand: for dim > 1 blocks of up to MEDIAN_DIM_BLOCK adjacent slices are gathered
+  // row by row (contiguous reads of the inner dimension) into a small per-thread buffer where each slice is then
+  // contiguous for the selection. Blocks are distributed over the threads.
+  template<typename T>
+  static void median_dim_template(const T* src, T* res, const dimension& dim, SizeT medianDim, bool even, bool omitNaN) {
+    SizeT depth = dim[medianDim];
+    SizeT inner = 1;
+    for (SizeT i = 0; i < medianDim; ++i) inner *= dim[i];
+    SizeT outer = dim.NDimElementsConst() / (inner * depth);
+
+    SizeT block = MEDIAN_DIM_BUFFER / depth;
+    if (block > MEDIAN_DIM_BLOCK) block = MEDIAN_DIM_BLOCK;
+    if (block < 1) block = 1;
+    if (block > inner) block = inner;
+    SizeT nBlockPerRow = (inner + block - 1) / block;
+    OMPInt nBlocks = nBlockPerRow * outer;
+    SizeT nEl = outer * inner * depth;
+
+#pragma omp parallel if (nBlocks > 1 && nEl >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= nEl))
+    {
+      T* buf = (T*) malloc(block * depth * sizeof (T));
+#pragma omp for schedule(dynamic)
+      for (OMPInt b = 0; b < nBlocks; ++b) {
+        SizeT o = b / nBlockPerRow;
+        SizeT i0 = (b % nBlockPerRow) * block;
+        SizeT nb = (i0 + block > inner) ? inner - i0 : block;
+        const T* base = src + o * inner * depth + i0;
+        if (inner == 1) {
+          memcpy(buf, base, depth * sizeof (T));
+        } else {
+          for (SizeT k = 0; k < depth; ++k) {
+            const T* row = base + k * inner;
+            for (SizeT j = 0; j < nb; ++j) buf[j * depth + k] = row[j];
+          }
+        }
+        for (SizeT j = 0; j < nb; ++j) res[o * inner + i0 + j] = median_select(&buf[j * depth], depth, even, omitNaN);
       }
+      free(buf);
     }
-    if (iEl == 0) { 
-      free(array);
-      return std::numeric_limits<float>::quiet_NaN();
+  }
+
+  // 2D median filter of integer data with the constant-time filter: 16-bit types are
+  // offset to uint16, wider types are replaced by their rank among the distinct values
+  // of the image. Returns false (nothing done) if there are more than 65536 of them.
+#define MEDIAN_CTMF16_MEMSIZE (4*1024*1024)
+  template <typename T>
+  bool median_ctmf_integer(const T* in, T* out, int width, int height, int radius) {
+    SizeT nEl = (SizeT) width * height;
+    std::vector<uint16_t> src(nEl), dst(nEl);
+    std::vector<T> levels;
+    if (sizeof (T) <= 2) {
+      const T tmin = std::numeric_limits<T>::min();
+#pragma omp parallel for if (nEl >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= nEl))
+      for (OMPInt i = 0; i < nEl; ++i) src[i] = (uint16_t) (in[i] - tmin);
+    } else {
+      levels.assign(in, in + nEl);
+      std::sort(levels.begin(), levels.end());
+      levels.erase(std::unique(levels.begin(), levels.end()), levels.end());
+      if (levels.size() > 65536) return false;
+#pragma omp parallel for if (nEl >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= nEl))
+      for (OMPInt i = 0; i < nEl; ++i) src[i] = (uint16_t) (std::lower_bound(levels.begin(), levels.end(), in[i]) - levels.begin());
     }
-    DFloat res = quick_select_f(array, iEl, even);
-    free(array);
-    return res;
+    fastmedian::ctmf16(&src[0], &dst[0], width, height, width, width, radius, 1, MEDIAN_CTMF16_MEMSIZE);
+    if (sizeof (T) <= 2) {
+      const T tmin = std::numeric_limits<T>::min();
+#pragma omp parallel for if (nEl >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= nEl))
+      for (OMPInt i = 0; i < nEl; ++i) out[i] = (T) (dst[i] + tmin);
+    } else {
+#pragma omp parallel for if (nEl >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= nEl))
+      for (OMPInt i = 0; i < nEl; ++i) out[i] = levels[dst[i]];
+    }
+    return true;
   }
 
-  inline bool hasnan_f(DFloat* arr, SizeT nEl) {
-    for (SizeT i = 0; i < nEl; ++i) if (isnan(arr[i])) return true;
-    return false;
+  template <typename GDLT>
+  BaseGDL* median_ctmf_integer(BaseGDL* p0, int width, int height, int radius) {
+    GDLT* data = static_cast<GDLT*> (p0);
+    GDLT* res = new GDLT(data->Dim(), BaseGDL::NOZERO);
+    if (median_ctmf_integer((typename GDLT::Ty*) data->DataAddr(), (typename GDLT::Ty*) res->DataAddr(), width, height, radius)) return res;
+    GDLDelete(res);
+    return NULL;
   }
-  
-  BaseGDL* SlowReliableMedian(EnvT* e); //see below.
 
   BaseGDL* median(EnvT* e) {
     BaseGDL* p0 = e->GetParDefined(0);
@@ -4591,85 +4668,20 @@ namespace lib {
       if (dimSet && p0->Rank() > 1) {
         medianDim -= 1; // user-supplied dimensions start with 1!
 
-
         // input/output dimensions: copy srcDim to destDim
         dimension destDim = p0->Dim();
-        // make array of dims for transpose
-        DUInt* perm = new DUInt[p0->Rank()];
-        ArrayGuard<DUInt> perm_guard(perm);
-        //useful to reorder dims for transpose to order data in continuous 'medianing' order.
-        DUInt i = 0, j = 0;
-        for (i = 0; i < p0->Rank(); ++i) if (i != medianDim) {
-            perm[j + 1] = i;
-            j++;
-          }
-        perm[0] = medianDim;
-        // resize destDim
         destDim.Remove(medianDim);
-        //compute stride and number of elements of result:
-        SizeT stride = p0->Dim(medianDim);
-        int iseven = ((stride % 2) == 0 && e->KeywordSet(evenIx));
-
-        SizeT nEl = destDim.NDimElementsConst();
-
-        //transpose p0 to arrange dimensions if medianDim is > 0. Do not forget to remove transposed array.
-        bool clean_array = false;
-        if (possibleNaN) {
-          bool hasnan = false;
-          if (dbl) {
-            DDoubleGDL* input = e->GetParAs<DDoubleGDL>(0);
-            if (medianDim != 0) {
-              input = static_cast<DDoubleGDL*> (static_cast<BaseGDL*> (input)->Transpose(perm));
-              clean_array = true;
-            }
-            DDoubleGDL* res = new DDoubleGDL(destDim, BaseGDL::NOZERO);
-            //probably overkill to start multithreading in some easy cases. TBD.
-#pragma omp for private(i,hasnan)
-            for (SizeT i = 0; i < nEl; ++i) {
-              if (hasnan_d(&(*input)[i * stride], stride)) (*res)[i] = quick_select_d_filter_nan(&(*input)[i * stride], stride, iseven); //special if nan.
-              else (*res)[i] = quick_select_d_protect_input(&(*input)[i * stride], stride, iseven);
-            }
-            if (clean_array) delete input;
-            return res;
-          } else {
-            DFloatGDL* input = e->GetParAs<DFloatGDL>(0);
-            if (medianDim != 0) {
-              input = static_cast<DFloatGDL*> (static_cast<BaseGDL*> (input)->Transpose(perm));
-              clean_array = true;
-            }
-            DFloatGDL* res = new DFloatGDL(destDim, BaseGDL::NOZERO);
-            //probably overkill to start multithreading in some easy cases. TBD.
-#pragma omp for private(i)
-            for (SizeT i = 0; i < nEl; ++i) {
-              if (hasnan_f(&(*input)[i * stride], stride)) (*res)[i] = quick_select_f_filter_nan(&(*input)[i * stride], stride, iseven); //special if nan.
-              else (*res)[i] = quick_select_f_protect_input(&(*input)[i * stride], stride, iseven);            }
-            if (clean_array) delete input;
-            return res;
-          }
-        } else { //faster since no NaN handling needed.
-          if (dbl) {
-            DDoubleGDL* input = e->GetParAs<DDoubleGDL>(0);
-            if (medianDim != 0) {
-              input = static_cast<DDoubleGDL*> (static_cast<BaseGDL*> (input)->Transpose(perm));
-              clean_array = true;
-            }
-            DDoubleGDL* res = new DDoubleGDL(destDim, BaseGDL::NOZERO);
-#pragma omp for private(i)
-            for (SizeT i = 0; i < nEl; ++i) (*res)[i] = quick_select_d_protect_input(&(*input)[i * stride], stride, iseven);
-            if (clean_array) delete input;
-            return res;
-          } else {
-            DFloatGDL* input = e->GetParAs<DFloatGDL>(0);
-            if (medianDim != 0) {
-              input = static_cast<DFloatGDL*> (static_cast<BaseGDL*> (input)->Transpose(perm));
-              clean_array = true;
-            }
-            DFloatGDL* res = new DFloatGDL(destDim, BaseGDL::NOZERO);
-#pragma omp for private(i)
-            for (SizeT i = 0; i < nEl; ++i) (*res)[i] = quick_select_f_protect_input(&(*input)[i * stride], stride, iseven);
-            if (clean_array) delete input;
-            return res;
-          }
+        bool even = e->KeywordSet(evenIx);
+        if (dbl) {
+          DDoubleGDL* input = e->GetParAs<DDoubleGDL>(0);
+          DDoubleGDL* res = new DDoubleGDL(destDim, BaseGDL::NOZERO);
+          median_dim_template<DDouble>((DDouble*) input->DataAddr(), (DDouble*) res->DataAddr(), p0->Dim(), medianDim, even, possibleNaN);
+          return res;
+        } else {
+          DFloatGDL* input = e->GetParAs<DFloatGDL>(0);
+          DFloatGDL* res = new DFloatGDL(destDim, BaseGDL::NOZERO);
+          median_dim_template<DFloat>((DFloat*) input->DataAddr(), (DFloat*) res->DataAddr(), p0->Dim(), medianDim, even, possibleNaN);
+          return res;
         }
       } else {
         if (possibleNaN) {
@@ -4715,7 +4727,27 @@ namespace lib {
       
       bool iseven = ((size % 2) == 0 && e->KeywordSet(evenIx));
 
-      if (p0->Type() == GDL_BYTE && twoD && oddsize) {
+      // the constant-time filter keeps 16-bit bins: at most 255x255 pixels in the kernel.
+      bool ctmfOK = (twoD && oddsize && size < 256);
+
+      if (ctmfOK && IntType(p0->Type()) && p0->Type() != GDL_BYTE && !e->KeywordSet(doubleIx)) {
+        // same algorithm for the other integer types, through 256x256 bins histograms.
+        // Result keeps the input type.
+        BaseGDL* res = NULL;
+        switch (p0->Type()) {
+        case GDL_INT: res = median_ctmf_integer<DIntGDL>(p0, width, height, radius); break;
+        case GDL_UINT: res = median_ctmf_integer<DUIntGDL>(p0, width, height, radius); break;
+        case GDL_LONG: res = median_ctmf_integer<DLongGDL>(p0, width, height, radius); break;
+        case GDL_ULONG: res = median_ctmf_integer<DULongGDL>(p0, width, height, radius); break;
+        case GDL_LONG64: res = median_ctmf_integer<DLong64GDL>(p0, width, height, radius); break;
+        case GDL_ULONG64: res = median_ctmf_integer<DULong64GDL>(p0, width, height, radius); break;
+        default: break;
+        }
+        if (res != NULL) return res;
+        // too many distinct values: use the generic code below.
+      }
+
+      if (p0->Type() == GDL_BYTE && ctmfOK) {
         // for this special case we apply the constant-time algorithm described in Perreault et al,
         // Published in the September 2007 issue of IEEE Transactions on Image Processing. DOI: 10.1109/TIP.2007.902329 
         DByteGDL* data = e->GetParAs<DByteGDL>(0);
@@ -4734,7 +4766,8 @@ namespace lib {
             if (oddsize) { //2D fast routines are programmed with odd sizes (2*radius+1) 
               BaseGDL* res = new DDoubleGDL(data->Dim(), BaseGDL::NOZERO);
               fastmedian::median_filter_2d(width, height, radius, radius, 0, (DDouble*) data->DataAddr(), (DDouble*) res->DataAddr());
-              return res;
+              if (p0->Type() == GDL_BYTE) return res->Convert2(GDL_BYTE, BaseGDL::CONVERT); //kernels too large for ctmf
+              else return res;
             } else { //for quite a large number of pixels (100=10^2), use the next ODD value. Results are compatible within 1% for random values.
               //to be tested, but should be better for natural values.
               if (size > 10) {
@@ -4762,7 +4795,8 @@ namespace lib {
             if (oddsize) { //2D fast routines are programmed with odd sizes (2*radius+1). 
               BaseGDL* res = new DFloatGDL(data->Dim(), BaseGDL::NOZERO);
               fastmedian::median_filter_2d(width, height, radius, radius, 0, (DFloat*) data->DataAddr(), (DFloat*) res->DataAddr());
-              return res;
+              if (p0->Type() == GDL_BYTE) return res->Convert2(GDL_BYTE, BaseGDL::CONVERT); //kernels too large for ctmf
+              else return res;
             } else { //for quite a large number of pixels (100=10^2), use the next ODD value. Results are compatible within 1% for random values.
               //to be tested, but should be better for natural values.
               if (size > 10) {
@@ -5527,71 +5561,38 @@ namespace lib {
 //    return maxval;
 //  }  
 
+// the sums of MEAN and MOMENT use the fixed-block engine of reduce.hpp (in double, compensated):
+// results do not depend on the number of threads.
 template <typename Ty>  static inline Ty do_mean(const Ty* data, const SizeT sz) {
-    Ty mean = 0;
-#pragma omp parallel
-    {
-#pragma omp for reduction(+:mean)
-    for (SizeT i = 0; i < sz; ++i) mean += data[i];
-    }
-    return mean/sz;
+    return ReduceTotal(data, sz, false)/sz;
   }
 
 template <typename Ty, typename T2>  static inline Ty do_mean_cpx(const Ty* data, const SizeT sz) {
-    T2 meanr = 0;
-    T2 meani = 0;
-#pragma omp parallel
-    {
-#pragma omp for reduction(+:meanr)
-    for (SizeT i = 0; i < sz; ++i) meanr += data[i].real();
-#pragma omp for reduction(+:meani)
-    for (SizeT i = 0; i < sz; ++i) meani += data[i].imag();
-    }
-    return std::complex<T2>(meanr/sz,meani/sz);
+    DComplexDbl sum = ReduceTotal(data, sz, false);
+    return std::complex<T2>(sum.real()/sz,sum.imag()/sz);
   }
  
 template <typename Ty>  static inline Ty do_mean_nan(const Ty* data, const SizeT sz) {
-    Ty mean = 0;
-    SizeT n = 0;
-#pragma omp parallel //if (sz >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= sz))
-    {
-#pragma omp for reduction(+:mean,n)
-     for (SizeT i = 0; i < sz; ++i) {
-        Ty v = data[i];
-        if (std::isfinite(v)) {
-          n++,
-          mean += v;
-        }
-      }
-    }
-    return mean/n;
+    // sum and number of finite values
+    ReduceSums<2> s = ReduceSum<ReduceSums<2> >(sz, [data](SizeT i) {
+      ReduceSums<2> r;
+      DDouble v = data[i];
+      if (std::isfinite(v)) { r.v[0] = v; r.v[1] = 1; }
+      return r;
+    });
+    return s.v[0]/s.v[1];
   }
 
 template <typename Ty, typename T2>  static inline Ty do_mean_cpx_nan(const Ty* data, const SizeT sz) {
-    T2 meanr = 0;
-    T2 meani = 0;
-    SizeT nr = 0;
-    SizeT ni = 0;
-#pragma omp parallel //if (sz >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= sz))
-    {
-#pragma omp for reduction(+:meanr,nr)
-     for (SizeT i = 0; i < sz; ++i) {
-        T2 v = data[i].real();
-        if (std::isfinite(v)) {
-          nr++,
-          meanr += v;
-        }
-      }
-#pragma omp for reduction(+:meani,ni)
-     for (SizeT i = 0; i < sz; ++i) {
-        T2 v = data[i].imag();
-        if (std::isfinite(v)) {
-          ni++,
-          meani += v;
-        }
-      }
-    }    
-    return std::complex<T2>(meanr/nr,meani/ni);
+    ReduceSums<4> s = ReduceSum<ReduceSums<4> >(sz, [data](SizeT i) {
+      ReduceSums<4> r;
+      DDouble vr = data[i].real();
+      DDouble vi = data[i].imag();
+      if (std::isfinite(vr)) { r.v[0] = vr; r.v[1] = 1; }
+      if (std::isfinite(vi)) { r.v[2] = vi; r.v[3] = 1; }
+      return r;
+    });
+    return std::complex<T2>(s.v[0]/s.v[1],s.v[2]/s.v[3]);
   }
 
   BaseGDL* mean_fun(EnvT* e) {
@@ -5769,50 +5770,16 @@ template <typename Ty, typename T2>  static inline Ty do_mean_cpx_nan(const Ty*
     }
   }
   
+  // sums of (r^3-3ri^2, 3r^2i-i^3) and (r^4-6r^2i^2+i^4, 4r^3i-4ri^3) for r+i.i=data-mean,
+  // the third and fourth powers used by the complex skewness and kurtosis below.
   template<typename Ty>
-  static inline void do_moment(const Ty* data, const SizeT sz, Ty &mean, Ty &variance, Ty &skewness, 
-    Ty &kurtosis, Ty &mdev, Ty &sdev, const int maxmoment){
-    Ty meanl=do_mean(data,sz);
-    mean=meanl;
-    if (maxmoment==1) {
-      variance=skewness=kurtosis=mdev=sdev=std::numeric_limits<float>::quiet_NaN();
-      return;
-    }
-
-    Ty var=0;
-    Ty md=0;
-#pragma omp parallel // if (sz >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= sz))
-    {
-#pragma omp for reduction(+:var,md)
-    for (SizeT i = 0; i < sz; ++i) { Ty cdata=data[i]-meanl; var += cdata*cdata; md+=fabs(cdata);}
-    }
-    var/=(sz-1);
-    variance=var;
-    sdev=sqrt(var);
-    mdev=md/sz;
-    
-    if (maxmoment==2 || var==0 ) {
-      skewness=kurtosis=std::numeric_limits<float>::quiet_NaN();
-      return;
-    }
-    Ty skew=0;
-#pragma omp parallel // if (sz >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= sz))
-    {
-#pragma omp for reduction(+:skew)
-    for (SizeT i = 0; i < sz; ++i) { Ty cdata=data[i]-meanl; skew += (cdata*cdata*cdata)/(var*sdev); }
-    }
-    skewness=skew/sz;
-    if (maxmoment==3) {
-      kurtosis=std::numeric_limits<float>::quiet_NaN();
-      return;
-    }
-    Ty kurt=0;
-#pragma omp parallel // if (sz >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= sz))
-    {
-#pragma omp for reduction(+:kurt)
-    for (SizeT i = 0; i < sz; ++i) { Ty cdata=data[i]-meanl; kurt += (cdata*cdata*cdata*cdata)/(var*var);}
-    }
-    kurtosis=(kurt/sz)-3; 
+  static inline void cpx_third_fourth(const Ty& cdata, DDouble& a, DDouble& b, DDouble& c, DDouble& d) {
+    DDouble cdatar=cdata.real();
+    DDouble cdatai=cdata.imag();
+    a=cdatar*cdatar*cdatar-3.0*cdatar*cdatai*cdatai;
+    b=3.0*cdatar*cdatar*cdatai-cdatai*cdatai*cdatai;
+    c=cdatar*cdatar*cdatar*cdatar-6.0*cdatar*cdatar*cdatai*cdatai+cdatai*cdatai*cdatai*cdatai;
+    d=4.0*cdatar*cdatar*cdatar*cdatai-4.0*cdatar*cdatai*cdatai*cdatai;
   }
   
   template<typename Ty, typename T2>
@@ -5827,24 +5794,19 @@ template <typename Ty, typename T2>  static inline Ty do_mean_cpx_nan(const Ty*
       return;
     }
 
-    T2 mdr=0;
-    T2 varr=0;
-    T2 vari=0;
-#pragma omp parallel // if (sz >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= sz))
-    {
-#pragma omp for reduction(+:varr,vari,mdr)
-      for (SizeT i = 0; i < sz; ++i) { 
-        Ty cdata=data[i]-meanl;
-        T2 cdatar=cdata.real();
-        T2 cdatai=cdata.imag();
-        varr += (cdatar*cdatar)-(cdatai*cdatai);
-        vari += 2*cdatar*cdatai;
-        mdr += sqrt(cdatar*cdatar+cdatai*cdatai);
-      }
-    }
-    varr/=(sz-1);
-    vari/=(sz-1);
-    mdr/=sz;
+    ReduceSums<3> s = ReduceSum<ReduceSums<3> >(sz, [data, meanl](SizeT i) {
+      ReduceSums<3> r;
+      Ty cdata=data[i]-meanl;
+      DDouble cdatar=cdata.real();
+      DDouble cdatai=cdata.imag();
+      r.v[0] = (cdatar*cdatar)-(cdatai*cdatai);
+      r.v[1] = 2*cdatar*cdatai;
+      r.v[2] = sqrt(cdatar*cdatar+cdatai*cdatai);
+      return r;
+    });
+    T2 varr=s.v[0]/(sz-1);
+    T2 vari=s.v[1]/(sz-1);
+    T2 mdr=s.v[2]/sz;
     variance=std::complex<T2>(varr,vari);
     sdev=sqrt(variance);
     mdev=mdr;
@@ -5854,106 +5816,29 @@ template <typename Ty, typename T2>  static inline Ty do_mean_cpx_nan(const Ty*
         std::complex<T2>(std::numeric_limits<T2>::quiet_NaN(),std::numeric_limits<T2>::quiet_NaN());
       return;
     }
-    T2 skewr=0;
-    T2 skewi=0;
-#pragma omp parallel // if (sz >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= sz))
-    {
-#pragma omp for reduction(+:skewr,skewi)
-      for (SizeT i = 0; i < sz; ++i) { 
-        Ty cdata=data[i]-meanl;
-        T2 cdatar=cdata.real();
-        T2 cdatai=cdata.imag();
-        skewr += (cdatar*cdatar*cdatar-3.0*cdatar*cdatai*cdatai)*
-          exp(-0.75*log(varr*varr+vari*vari))*
-          cos(0.15E1*atan2(vari,varr))+(3.0*cdatar*cdatar*cdatai-cdatai*cdatai*cdatai)*
-          exp(-0.75*log(varr*varr+vari*vari))*sin(1.5*atan2(vari,varr));
-
-        skewi += (3.0*cdatar*cdatar*cdatai-cdatai*cdatai*cdatai)*
-          exp(-0.75*log(varr*varr+vari*vari))*cos(1.5*atan2(vari,varr))-
-          (cdatar*cdatar*cdatar-3.0*cdatar*cdatai*cdatai)*
-          exp(-0.75*log(varr*varr+vari*vari))*sin(1.5*atan2(vari,varr));
-      }
-    }
+    ReduceSums<4> p = ReduceSum<ReduceSums<4> >(sz, [data, meanl](SizeT i) {
+      ReduceSums<4> r;
+      cpx_third_fourth(data[i]-meanl, r.v[0], r.v[1], r.v[2], r.v[3]);
+      return r;
+    });
+    DDouble k3=exp(-0.75*log(varr*varr+vari*vari));
+    DDouble c3=cos(1.5*atan2(vari,varr));
+    DDouble s3=sin(1.5*atan2(vari,varr));
+    T2 skewr=(p.v[0]*c3+p.v[1]*s3)*k3;
+    T2 skewi=(p.v[1]*c3-p.v[0]*s3)*k3;
     skewness=std::complex<T2>(skewr/sz,skewi/sz);
     if (maxmoment==3) {
       kurtosis=std::complex<T2>(std::numeric_limits<T2>::quiet_NaN(),std::numeric_limits<T2>::quiet_NaN());
       return;
     }
-    T2 kurtr=0;
-    T2 kurti=0;
-#pragma omp parallel // if (sz >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= sz))
-    {
-#pragma omp for reduction(+:kurtr,kurti)
-      for (SizeT i = 0; i < sz; ++i) { 
-        Ty cdata=data[i]-meanl;
-        T2 cdatar=cdata.real();
-        T2 cdatai=cdata.imag();
-        kurtr += (cdatar*cdatar*cdatar*cdatar-6.0*cdatar*cdatar*cdatai*cdatai+cdatai*
-          cdatai*cdatai*cdatai)*(varr*varr-vari*vari)/(pow(varr*varr-vari*vari,2.0)+
-          4.0*varr*varr*vari*vari)+2.0*(4.0*cdatar*cdatar*cdatar*cdatai-
-          4.0*cdatar*cdatai*cdatai*cdatai)*varr*vari/
-          (pow(varr*varr-vari*vari,2.0)+
-          4.0*varr*varr*vari*vari);
-        kurti += (4.0*cdatar*cdatar*cdatar*cdatai-4.0*cdatar*cdatai*cdatai*cdatai)*
-          (varr*varr-vari*vari)/(pow(varr*varr-vari*vari,2.0)+4.0*varr*varr*vari*vari)-
-          2.0*(cdatar*cdatar*cdatar*cdatar-
-          6.0*cdatar*cdatar*cdatai*cdatai+cdatai*cdatai*cdatai*cdatai)*varr*vari/
-          (pow(varr*varr-vari*vari,2.0)+
-          4.0*varr*varr*vari*vari);
-      }
-    }
+    DDouble d4=pow(varr*varr-vari*vari,2.0)+4.0*varr*varr*vari*vari;
+    DDouble a4=(varr*varr-vari*vari)/d4;
+    DDouble b4=2.0*varr*vari/d4;
+    T2 kurtr=p.v[2]*a4+p.v[3]*b4;
+    T2 kurti=p.v[3]*a4-p.v[2]*b4;
     kurtosis=std::complex<T2>((kurtr/sz)-3,(kurti/sz)-3); 
   }
   
-  template<typename Ty>
-  static inline void do_moment_nan(const Ty* data, const SizeT sz, Ty &mean, Ty &variance, Ty &skewness, 
-    Ty &kurtosis, Ty &mdev, Ty &sdev, const int maxmoment){
-    Ty meanl=do_mean_nan(data,sz);
-    mean=meanl;
-    if (maxmoment==1 || !std::isfinite(mean)) {
-      variance=skewness=kurtosis=mdev=sdev=std::numeric_limits<float>::quiet_NaN();
-      return;
-    }
-
-    Ty var=0;
-    Ty md=0;
-    SizeT k=0;
-#pragma omp parallel //if (sz >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= sz))
-    {
-#pragma omp for reduction(+:var,md,k)
-    for (SizeT i = 0; i < sz; ++i) { Ty cdata=data[i]-meanl; if (std::isfinite(cdata)) {var += cdata*cdata; md+=fabs(cdata); k+=1;} }
-    }
-    if (k>1) var/=(k-1); else {
-      variance=skewness=kurtosis=mdev=sdev=std::numeric_limits<float>::quiet_NaN();
-      return;
-    }
-    variance=var;
-    sdev=sqrt(var);
-    mdev=md/k;
-    if (maxmoment==2 || var==0 ) {
-      skewness=kurtosis=std::numeric_limits<float>::quiet_NaN();
-      return;
-    }
-    Ty skew=0;
-#pragma omp parallel //if (sz >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= sz))
-    {
-#pragma omp for reduction(+:skew)
-    for (SizeT i = 0; i < sz; ++i) { Ty cdata=data[i]-meanl; if (std::isfinite(cdata)) skew += (cdata*cdata*cdata)/(var*sdev); }
-    }
-    skewness=skew/k;
-    if (maxmoment==3) {
-      kurtosis=std::numeric_limits<float>::quiet_NaN();
-      return;
-    }
-    Ty kurt=0;
-#pragma omp parallel // if (sz >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= sz))
-    {
-#pragma omp for reduction(+:kurt)
-    for (SizeT i = 0; i < sz; ++i) { Ty cdata=data[i]-meanl; if (std::isfinite(cdata)) kurt += (cdata*cdata*cdata*cdata)/(var*var);}
-    }
-    kurtosis=(kurt/k)-3; 
-  }
-  
   template<typename Ty, typename T2>
   static inline void do_moment_cpx_nan(const Ty* data, const SizeT sz, Ty &mean, Ty &variance, Ty &skewness, 
     Ty &kurtosis, T2 &mdev, Ty &sdev, const int maxmoment){
@@ -5965,26 +5850,20 @@ template <typename Ty, typename T2>  static inline Ty do_mean_cpx_nan(const Ty*
         mdev=std::numeric_limits<T2>::quiet_NaN();
       return;
     }
-    SizeT kr=0;
-    SizeT ki=0;
-    T2 mdr=0;
-    T2 varr=0;
-    T2 vari=0;
-#pragma omp parallel // if (sz >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= sz))
-    {
-#pragma omp for reduction(+:varr,vari,mdr,kr,ki)
-      for (SizeT i = 0; i < sz; ++i) { 
-        Ty cdata=data[i]-meanl;
-          T2 cdatar=cdata.real();
-          T2 cdatai=cdata.imag();
-        if (std::isfinite(cdatar)) {varr += cdatar*cdatar; kr++;}
-        if (std::isfinite(cdatai)) {vari += cdatai*cdatai; ki++;}
-        if (std::isfinite(cdatar))  mdr += sqrt(cdatar*cdatar+cdatai*cdatai);
-        }
-    }
-    varr/=(kr-1);
-    vari/=(ki-1);
-    mdr/=kr;
+    ReduceSums<5> s = ReduceSum<ReduceSums<5> >(sz, [data, meanl](SizeT i) {
+      ReduceSums<5> r;
+      Ty cdata=data[i]-meanl;
+      DDouble cdatar=cdata.real();
+      DDouble cdatai=cdata.imag();
+      if (std::isfinite(cdatar)) {r.v[0] = cdatar*cdatar; r.v[1] = 1; r.v[2] = sqrt(cdatar*cdatar+cdatai*cdatai);}
+      if (std::isfinite(cdatai)) {r.v[3] = cdatai*cdatai; r.v[4] = 1;}
+      return r;
+    });
+    SizeT kr=s.v[1];
+    SizeT ki=s.v[4];
+    T2 varr=s.v[0]/(kr-1);
+    T2 vari=s.v[3]/(ki-1);
+    T2 mdr=s.v[2]/kr;
     variance=std::complex<T2>(varr,vari);    
     sdev=sqrt(variance);
     mdev=mdr;
@@ -5994,57 +5873,98 @@ template <typename Ty, typename T2>  static inline Ty do_mean_cpx_nan(const Ty*
         std::complex<T2>(std::numeric_limits<T2>::quiet_NaN(),std::numeric_limits<T2>::quiet_NaN());
       return;
     }
-    T2 skewr=0;
-    T2 skewi=0;
-#pragma omp parallel // if (sz >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= sz))
-    {
-#pragma omp for reduction(+:skewr,skewi)
-      for (SizeT i = 0; i < sz; ++i) { 
-        Ty cdata=data[i]-meanl;
-          T2 cdatar=cdata.real();
-          T2 cdatai=cdata.imag();
-          if (std::isfinite(cdatar)) skewr += (cdatar*cdatar*cdatar-3.0*cdatar*cdatai*cdatai)*
-            exp(-0.75*log(varr*varr+vari*vari))*
-            cos(0.15E1*atan2(vari,varr))+(3.0*cdatar*cdatar*cdatai-cdatai*cdatai*cdatai)*
-            exp(-0.75*log(varr*varr+vari*vari))*sin(1.5*atan2(vari,varr));
-
-          if (std::isfinite(cdatai)) skewi += (3.0*cdatar*cdatar*cdatai-cdatai*cdatai*cdatai)*
-            exp(-0.75*log(varr*varr+vari*vari))*cos(1.5*atan2(vari,varr))-
-            (cdatar*cdatar*cdatar-3.0*cdatar*cdatai*cdatai)*
-            exp(-0.75*log(varr*varr+vari*vari))*sin(1.5*atan2(vari,varr));
-        }
-    }
+    // the real parts of skewness and kurtosis sum over the finite real parts, the imaginary over the finite imaginary parts
+    ReduceSums<8> p = ReduceSum<ReduceSums<8> >(sz, [data, meanl](SizeT i) {
+      ReduceSums<8> r;
+      Ty cdata=data[i]-meanl;
+      DDouble a, b, c, d;
+      cpx_third_fourth(cdata, a, b, c, d);
+      if (std::isfinite(cdata.real())) { r.v[0] = a; r.v[1] = b; r.v[2] = c; r.v[3] = d; }
+      if (std::isfinite(cdata.imag())) { r.v[4] = a; r.v[5] = b; r.v[6] = c; r.v[7] = d; }
+      return r;
+    });
+    DDouble k3=exp(-0.75*log(varr*varr+vari*vari));
+    DDouble c3=cos(1.5*atan2(vari,varr));
+    DDouble s3=sin(1.5*atan2(vari,varr));
+    T2 skewr=(p.v[0]*c3+p.v[1]*s3)*k3;
+    T2 skewi=(p.v[5]*c3-p.v[4]*s3)*k3;
     skewness=std::complex<T2>(skewr/kr,skewi/ki);
     if (maxmoment==3) {
       kurtosis=std::complex<T2>(std::numeric_limits<T2>::quiet_NaN(),std::numeric_limits<T2>::quiet_NaN());
       return;
     }
-    T2 kurtr=0;
-    T2 kurti=0;
-#pragma omp parallel // if (sz >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= sz))
-    {
-#pragma omp for reduction(+:kurtr,kurti)
-      for (SizeT i = 0; i < sz; ++i) { 
-        Ty cdata=data[i]-meanl;
-          T2 cdatar=cdata.real();
-          T2 cdatai=cdata.imag();
-          if (std::isfinite(cdatar)) kurtr += (cdatar*cdatar*cdatar*cdatar-6.0*cdatar*cdatar*cdatai*cdatai+cdatai*
-            cdatai*cdatai*cdatai)*(varr*varr-vari*vari)/(pow(varr*varr-vari*vari,2.0)+
-            4.0*varr*varr*vari*vari)+2.0*(4.0*cdatar*cdatar*cdatar*cdatai-
-            4.0*cdatar*cdatai*cdatai*cdatai)*varr*vari/
-            (pow(varr*varr-vari*vari,2.0)+
-            4.0*varr*varr*vari*vari);
-          if (std::isfinite(cdatai)) kurti += (4.0*cdatar*cdatar*cdatar*cdatai-4.0*cdatar*cdatai*cdatai*cdatai)*
-            (varr*varr-vari*vari)/(pow(varr*varr-vari*vari,2.0)+4.0*varr*varr*vari*vari)-
-            2.0*(cdatar*cdatar*cdatar*cdatar-
-            6.0*cdatar*cdatar*cdatai*cdatai+cdatai*cdatai*cdatai*cdatai)*varr*vari/
-            (pow(varr*varr-vari*vari,2.0)+
-            4.0*varr*varr*vari*vari);
-        }
-    }
+    DDouble d4=pow(varr*varr-vari*vari,2.0)+4.0*varr*varr*vari*vari;
+    DDouble a4=(varr*varr-vari*vari)/d4;
+    DDouble b4=2.0*varr*vari/d4;
+    T2 kurtr=p.v[2]*a4+p.v[3]*b4;
+    T2 kurti=p.v[7]*a4-p.v[6]*b4;
     kurtosis=std::complex<T2>((kurtr/kr)-3,(kurti/kr)-3); 
   }
   
+  // MOMENT of real values, along a dimension of size nRows and stride
+  // 'stride' (nOuter slices) or over the whole array (nRows=nEl): r[q*nOut+j]
+  // is the mean, variance, skewness, kurtosis, sdev and mdev (q=0..5) of the
+  // output j. Single pass, see ReduceMoments; MDEV needs a second one.
+  template<typename Ty>
+  static void moment_real(const Ty* data, SizeT nRows, SizeT stride, SizeT nOuter, bool omitNaN,
+    int maxmoment, bool domdev, DDouble* r) {
+    SizeT nOut = nOuter*stride;
+    std::vector<Moments> mom(nOut);
+    std::vector<DDouble> absdev(nOut);
+    if (stride == 1) {
+      // contiguous slices: in parallel if there are enough, else each one is
+#pragma omp parallel for if (nOut > 1 && nOut >= CpuTPOOL_NTHREADS && nOut*nRows >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= nOut*nRows))
+      for (OMPInt o = 0; o < nOut; ++o) {
+        mom[o] = ReduceMoments(data + o*nRows, nRows, omitNaN);
+        if (domdev) absdev[o] = ReduceAbsDev(data + o*nRows, nRows, mom[o].mean, omitNaN);
+      }
+    } else {
+      ReduceMomentsStrided(data, nRows, stride, nOuter, omitNaN, &mom[0]);
+      if (domdev) ReduceAbsDevStrided(data, nRows, stride, nOuter, omitNaN, &mom[0], &absdev[0]);
+    }
+    const DDouble nan = std::numeric_limits<DDouble>::quiet_NaN();
+    for (SizeT j = 0; j < nOut; ++j) {
+      const Moments& m = mom[j];
+      DDouble mean = (m.n > 0) ? m.mean : nan;
+      DDouble var = nan, skew = nan, kurt = nan, sdev = nan, mdev = nan;
+      if (maxmoment > 1 && (!omitNaN || (std::isfinite(mean) && m.n > 1))) {
+        var = m.m2/(m.n-1);
+        sdev = sqrt(var);
+        mdev = absdev[j]/m.n;
+        if (maxmoment > 2 && var != 0) {
+          skew = m.m3/m.n/(var*sdev);
+          if (maxmoment > 3) kurt = m.m4/m.n/(var*var)-3;
+        }
+      }
+      r[j] = mean;
+      r[j+nOut] = var;
+      r[j+2*nOut] = skew;
+      r[j+3*nOut] = kurt;
+      r[j+4*nOut] = sdev;
+      r[j+5*nOut] = mdev;
+    }
+  }
+
+  // the MOMENT result [mean, variance, skewness, kurtosis] (along the last
+  // dimension with DIMENSION) and the keywords, in the order of moment_real
+  template<typename T>
+  static BaseGDL* moment_real_result(EnvT* e, const DDouble* r, SizeT nOut, bool alongDim,
+    const dimension& auxiliaryDim, const int* kwIx, const bool* kwDo) {
+    dimension resDim = auxiliaryDim;
+    if (alongDim) resDim << 4; else resDim = dimension(4);
+    T* res = new T(resDim, BaseGDL::NOZERO);
+    for (SizeT i = 0; i < 4*nOut; ++i) (*res)[i] = r[i];
+    for (int q = 0; q < 6; ++q) {
+      if (!kwDo[q]) continue;
+      if (alongDim) {
+        T* kw = new T(auxiliaryDim, BaseGDL::NOZERO);
+        for (SizeT j = 0; j < nOut; ++j) (*kw)[j] = r[j+q*nOut];
+        e->SetKW(kwIx[q], kw);
+      } else e->SetKW(kwIx[q], new T(static_cast<typename T::Ty>(r[q])));
+    }
+    return res;
+  }
+
   BaseGDL* moment_fun(EnvT* e) {
     BaseGDL* p0 = e->GetParDefined(0);
 
@@ -6109,6 +6029,39 @@ template <typename Ty, typename T2>  static inline Ty do_mean_cpx_nan(const Ty*
         e->Throw("Illegal keyword value for DIMENSION");
     }
 
+    if (p0->Type() != GDL_COMPLEX && p0->Type() != GDL_COMPLEXDBL) {
+      // real values: read in place (no conversion, no transposition)
+      bool alongDim = (dimSet && p0->Rank() > 1);
+      SizeT nEl = p0->N_Elements();
+      SizeT nRows = nEl, stride = 1;
+      dimension auxiliaryDim = p0->Dim();
+      if (alongDim) {
+        nRows = p0->Dim(momentDim - 1);
+        stride = p0->Dim().Stride(momentDim - 1);
+        auxiliaryDim.Remove(momentDim - 1);
+      }
+      SizeT nOuter = nEl / (nRows * stride);
+      SizeT nOut = nOuter * stride;
+      std::vector<DDouble> r(6 * nOut);
+      switch (p0->Type()) {
+      case GDL_BYTE: moment_real(&(*static_cast<DByteGDL*> (p0))[0], nRows, stride, nOuter, false, maxmoment, domdev, &r[0]); break;
+      case GDL_INT: moment_real(&(*static_cast<DIntGDL*> (p0))[0], nRows, stride, nOuter, false, maxmoment, domdev, &r[0]); break;
+      case GDL_UINT: moment_real(&(*static_cast<DUIntGDL*> (p0))[0], nRows, stride, nOuter, false, maxmoment, domdev, &r[0]); break;
+      case GDL_LONG: moment_real(&(*static_cast<DLongGDL*> (p0))[0], nRows, stride, nOuter, false, maxmoment, domdev, &r[0]); break;
+      case GDL_ULONG: moment_real(&(*static_cast<DULongGDL*> (p0))[0], nRows, stride, nOuter, false, maxmoment, domdev, &r[0]); break;
+      case GDL_LONG64: moment_real(&(*static_cast<DLong64GDL*> (p0))[0], nRows, stride, nOuter, false, maxmoment, domdev, &r[0]); break;
+      case GDL_ULONG64: moment_real(&(*static_cast<DULong64GDL*> (p0))[0], nRows, stride, nOuter, false, maxmoment, domdev, &r[0]); break;
+      case GDL_FLOAT: moment_real(&(*static_cast<DFloatGDL*> (p0))[0], nRows, stride, nOuter, omitNaN, maxmoment, domdev, &r[0]); break;
+      case GDL_DOUBLE: moment_real(&(*static_cast<DDoubleGDL*> (p0))[0], nRows, stride, nOuter, omitNaN, maxmoment, domdev, &r[0]); break;
+      default: moment_real(&(*e->GetParAs<DDoubleGDL>(0))[0], nRows, stride, nOuter, false, maxmoment, domdev, &r[0]);
+      }
+      int kwIx[6] = {meanIx, varIx, skewIx, kurtIx, sdevIx, mdevIx};
+      bool kwDo[6] = {domean != 0, dovar != 0, doskew != 0, dokurt != 0, dosdev != 0, domdev != 0};
+      if (dbl) return moment_real_result<DDoubleGDL>(e, &r[0], nOut, alongDim, auxiliaryDim, kwIx, kwDo);
+      return moment_real_result<DFloatGDL>(e, &r[0], nOut, alongDim, auxiliaryDim, kwIx, kwDo);
+    }
+
+    // complex values
     if (dimSet && p0->Rank() > 1) {
       momentDim -= 1; // user-supplied dimensions start with 1!
 
@@ -6197,7 +6150,7 @@ template <typename Ty, typename T2>  static inline Ty do_mean_cpx_nan(const Ty*
         if (dosdev) e->SetKW( sdevIx, sdev );
         if (domdev) e->SetKW( mdevIx, mdev );
         return res;
-      } else if (p0->Type() == GDL_COMPLEX) {
+      } else { // GDL_COMPLEX
         DComplexGDL* input = e->GetParAs<DComplexGDL>(0);
         if (momentDim != 0) {
           input = static_cast<DComplexGDL*> (static_cast<BaseGDL*> (input)->Transpose(perm));
@@ -6257,132 +6210,6 @@ template <typename Ty, typename T2>  static inline Ty do_mean_cpx_nan(const Ty*
         if (dosdev) e->SetKW( sdevIx, sdev );
         if (domdev) e->SetKW( mdevIx, mdev );
         return res;        
-      } else {
-        if (dbl) {
-          DDoubleGDL* input = e->GetParAs<DDoubleGDL>(0);
-          if (momentDim != 0) {
-            input = static_cast<DDoubleGDL*> (static_cast<BaseGDL*> (input)->Transpose(perm));
-            clean_array = true;
-          }
-          DDoubleGDL* res = new DDoubleGDL(destDim, BaseGDL::NOZERO);
-          DDoubleGDL* mean;
-          DDoubleGDL* var;
-          DDoubleGDL* skew;
-          DDoubleGDL* kurt;
-          DDoubleGDL* sdev;
-          DDoubleGDL* mdev;
-          if (domean) mean = new DDoubleGDL(auxiliaryDim, BaseGDL::NOZERO);
-          if (dovar)   var = new DDoubleGDL(auxiliaryDim, BaseGDL::NOZERO);
-          if (doskew) skew = new DDoubleGDL(auxiliaryDim, BaseGDL::NOZERO);
-          if (dokurt) kurt = new DDoubleGDL(auxiliaryDim, BaseGDL::NOZERO);
-          if (dosdev) sdev = new DDoubleGDL(auxiliaryDim, BaseGDL::NOZERO);
-          if (domdev) mdev = new DDoubleGDL(auxiliaryDim, BaseGDL::NOZERO);
-          if (omitNaN) {
-#pragma omp parallel //if (nEl >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= nEl))
-            {
-#pragma omp for
-              for (SizeT i = 0; i < nEl; ++i) {
-                DDouble mdevl;
-                DDouble sdevl;
-                do_moment_nan(&(*input)[i * stride], stride, (*res)[i], (*res)[i+nEl], 
-                  (*res)[i+2*nEl], (*res)[i+3*nEl], mdevl, sdevl, maxmoment);
-                if (domean) (*mean)[i]=(*res)[i];
-                if (dovar ) (*var )[i]=(*res)[i+nEl];
-                if (doskew) (*skew)[i]=(*res)[i+2*nEl];
-                if (dokurt) (*kurt)[i]=(*res)[i+3*nEl];
-                if (dosdev) (*sdev)[i]=sdevl;
-                if (domdev) (*mdev)[i]=mdevl;
-              }
-            }
-          } else {
-#pragma omp parallel //if (nEl >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= nEl))
-            {
-#pragma omp for
-              for (SizeT i = 0; i < nEl; ++i) {
-                DDouble mdevl;
-                DDouble sdevl;
-                do_moment(&(*input)[i * stride], stride, (*res)[i], (*res)[i+nEl], 
-                  (*res)[i+2*nEl], (*res)[i+3*nEl], mdevl, sdevl, maxmoment);
-                if (domean) (*mean)[i]=(*res)[i];
-                if (dovar ) (*var )[i]=(*res)[i+nEl];
-                if (doskew) (*skew)[i]=(*res)[i+2*nEl];
-                if (dokurt) (*kurt)[i]=(*res)[i+3*nEl];
-                if (dosdev) (*sdev)[i]=sdevl;
-                if (domdev) (*mdev)[i]=mdevl;
-              }
-            }
-          }
-          if (clean_array) delete input;
-          if (domean) e->SetKW( meanIx, mean );
-          if (dovar ) e->SetKW( varIx, var );
-          if (doskew) e->SetKW( skewIx, skew );
-          if (dokurt) e->SetKW( kurtIx, kurt );
-          if (dosdev) e->SetKW( sdevIx, sdev );
-          if (domdev) e->SetKW( mdevIx, mdev );
-          return res;
-        } else {
-          DFloatGDL* input = e->GetParAs<DFloatGDL>(0);
-          if (momentDim != 0) {
-            input = static_cast<DFloatGDL*> (static_cast<BaseGDL*> (input)->Transpose(perm));
-            clean_array = true;
-          }
-          DFloatGDL* res = new DFloatGDL(destDim, BaseGDL::NOZERO);
-          DFloatGDL* mean;
-          DFloatGDL* var;
-          DFloatGDL* skew;
-          DFloatGDL* kurt;
-          DFloatGDL* sdev;
-          DFloatGDL* mdev;
-          if (domean) mean = new DFloatGDL(auxiliaryDim, BaseGDL::NOZERO);
-          if (dovar)   var = new DFloatGDL(auxiliaryDim, BaseGDL::NOZERO);
-          if (doskew) skew = new DFloatGDL(auxiliaryDim, BaseGDL::NOZERO);
-          if (dokurt) kurt = new DFloatGDL(auxiliaryDim, BaseGDL::NOZERO);
-          if (dosdev) sdev = new DFloatGDL(auxiliaryDim, BaseGDL::NOZERO);
-          if (domdev) mdev = new DFloatGDL(auxiliaryDim, BaseGDL::NOZERO);
-          if (omitNaN) {
-#pragma omp parallel //if (nEl >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= nEl))
-            {
-#pragma omp for
-              for (SizeT i = 0; i < nEl; ++i) {
-                DFloat mdevl;
-                DFloat sdevl;
-                do_moment_nan(&(*input)[i * stride], stride, (*res)[i], (*res)[i+nEl], 
-                  (*res)[i+2*nEl], (*res)[i+3*nEl], mdevl, sdevl, maxmoment);
-                if (domean) (*mean)[i]=(*res)[i];
-                if (dovar ) (*var )[i]=(*res)[i+nEl];
-                if (doskew) (*skew)[i]=(*res)[i+2*nEl];
-                if (dokurt) (*kurt)[i]=(*res)[i+3*nEl];
-                if (dosdev) (*sdev)[i]=sdevl;
-                if (domdev) (*mdev)[i]=mdevl;
-              }
-            }
-          } else {
-#pragma omp parallel //if (nEl >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= nEl))
-            {
-#pragma omp for
-              for (SizeT i = 0; i < nEl; ++i) {
-                DFloat mdevl;
-                DFloat sdevl;
-                do_moment(&(*input)[i * stride], stride, (*res)[i], (*res)[i+nEl], 
-                  (*res)[i+2*nEl], (*res)[i+3*nEl], mdevl, sdevl, maxmoment);
-                if (domean) (*mean)[i]=(*res)[i];
-                if (dovar ) (*var )[i]=(*res)[i+nEl];
-                if (doskew) (*skew)[i]=(*res)[i+2*nEl];
-                if (dokurt) (*kurt)[i]=(*res)[i+3*nEl];
-                if (dosdev) (*sdev)[i]=sdevl;
-                if (domdev) (*mdev)[i]=mdevl;
-              }
-            }
-          }
-          if (clean_array) delete input;
-          if (domean) e->SetKW( meanIx, mean );
-          if (dovar ) e->SetKW( varIx, var );
-          if (doskew) e->SetKW( skewIx, skew );
-          if (dokurt) e->SetKW( kurtIx, kurt );
-          if (dosdev) e->SetKW( sdevIx, sdev );
-          if (domdev) e->SetKW( mdevIx, mdev );
-          return res;
-        }
       }
     } else {
       if (p0->Type() == GDL_COMPLEXDBL || (p0->Type() == GDL_COMPLEX && dbl)) {
@@ -6407,7 +6234,7 @@ template <typename Ty, typename T2>  static inline Ty do_mean_cpx_nan(const Ty*
         (*res)[2]=skew;
         (*res)[3]=kurt;
         return res;
-      } else if (p0->Type() == GDL_COMPLEX) {
+      } else { // GDL_COMPLEX
         DComplexGDL* input = e->GetParAs<DComplexGDL>(0);
         DComplex mean;
         DComplex var;
@@ -6429,52 +6256,6 @@ template <typename Ty, typename T2>  static inline Ty do_mean_cpx_nan(const Ty*
         (*res)[2]=skew;
         (*res)[3]=kurt;
         return res;
-      } else {
-        if (dbl) {
-          DDoubleGDL* input = e->GetParAs<DDoubleGDL>(0);
-          DDouble mean;
-          DDouble var;
-          DDouble skew;
-          DDouble kurt;
-          DDouble sdev;
-          DDouble mdev;
-          if (omitNaN) do_moment_nan(&(*input)[0], input->N_Elements(), mean, var, skew, kurt, mdev, sdev, maxmoment);
-          else  do_moment(&(*input)[0], input->N_Elements(), mean, var, skew, kurt, mdev, sdev, maxmoment);
-          if (domean) e->SetKW( meanIx,new DDoubleGDL( mean) );
-          if (dovar ) e->SetKW( varIx, new DDoubleGDL( var ) );
-          if (doskew) e->SetKW( skewIx,new DDoubleGDL( skew) );
-          if (dokurt) e->SetKW( kurtIx,new DDoubleGDL( kurt) );
-          if (dosdev) e->SetKW( sdevIx,new DDoubleGDL( sdev) );
-          if (domdev) e->SetKW( mdevIx,new DDoubleGDL( mdev) );
-          DDoubleGDL* res = new DDoubleGDL(4, BaseGDL::NOZERO);
-          (*res)[0]=mean;
-          (*res)[1]=var;
-          (*res)[2]=skew;
-          (*res)[3]=kurt;
-          return res;
-        } else {
-          DFloatGDL* input = e->GetParAs<DFloatGDL>(0);
-          DFloat mean;
-          DFloat var;
-          DFloat skew;
-          DFloat kurt;
-          DFloat sdev;
-          DFloat mdev;
-          if (omitNaN) do_moment_nan(&(*input)[0], input->N_Elements(), mean, var, skew, kurt, mdev, sdev, maxmoment);
-          else  do_moment(&(*input)[0], input->N_Elements(), mean, var, skew, kurt, mdev, sdev, maxmoment);
-          if (domean) e->SetKW( meanIx,new DFloatGDL( mean) );
-          if (dovar ) e->SetKW( varIx, new DFloatGDL( var ) );
-          if (doskew) e->SetKW( skewIx,new DFloatGDL( skew) );
-          if (dokurt) e->SetKW( kurtIx,new DFloatGDL( kurt) );
-          if (dosdev) e->SetKW( sdevIx,new DFloatGDL( sdev) );
-          if (domdev) e->SetKW( mdevIx,new DFloatGDL( mdev) );
-          DFloatGDL* res = new DFloatGDL(4, BaseGDL::NOZERO);
-          (*res)[0]=mean;
-          (*res)[1]=var;
-          (*res)[2]=skew;
-          (*res)[3]=kurt;
-          return res;
-        }
       }
     }
   }
@@ -18,6 +18,8 @@
 #ifndef BASIC_FUN_HPP_
 #define BASIC_FUN_HPP_
 
+struct StridedViewT;
+
 namespace lib {
 
   // also used from basic_fun_jmg.cpp
@@ -99,6 +101,8 @@ namespace lib {
   BaseGDL* strtrim( EnvT* e);
 
   BaseGDL* total_fun( EnvT* e);
+  // TOTAL(var[ix]) read in place (see ArrayIndexListT::IndexView())
+  BaseGDL* total_view( BaseGDL* var, const StridedViewT& view);
   BaseGDL* product_fun( EnvT* e);
 
   BaseGDL* n_params( EnvT* e);
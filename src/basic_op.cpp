@@ -33,6 +33,8 @@
 #include "typetraits.hpp"
 
 #include "sigfpehandler.hpp"
+#include "blas_backend.hpp"
+#include "simd_dispatch.hpp"
 using namespace std;
 
 #if defined(USE_EIGEN)
@@ -595,6 +597,8 @@ BaseGDL* Data_<Sp>::EqOp( BaseGDL* r)
 	  (*res)[0] = (s == (*this)[0]);
 	  return res;
 	}
+      if( SimdCompare( SIMD_EQ, true, &(*res)[0], &(*this)[0], &s, nEl))
+	return res;
       TRACEOMP( __FILE__, __LINE__)
 #pragma omp parallel if (nEl >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= nEl))
 	{
@@ -610,6 +614,8 @@ BaseGDL* Data_<Sp>::EqOp( BaseGDL* r)
 	  (*res)[0] = ((*right)[0] == s);
 	  return res;
 	}
+      if( SimdCompare( SIMD_EQ, true, &(*res)[0], &(*right)[0], &s, rEl))
+	return res;
       TRACEOMP( __FILE__, __LINE__)
 #pragma omp parallel if (rEl >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= rEl))
 	{
@@ -620,6 +626,8 @@ BaseGDL* Data_<Sp>::EqOp( BaseGDL* r)
   else if( rEl < nEl) 
     {
       res= new Data_<SpDByte>( right->dim, BaseGDL::NOZERO);
+      if( SimdCompare( SIMD_EQ, false, &(*res)[0], &(*right)[0], &(*this)[0], rEl))
+	return res;
       TRACEOMP( __FILE__, __LINE__)
 #pragma omp parallel if (rEl >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= rEl))
 	{
@@ -635,6 +643,8 @@ BaseGDL* Data_<Sp>::EqOp( BaseGDL* r)
 	  (*res)[0] = ((*right)[0] == (*this)[0]);
 	  return res;
 	}
+      if( SimdCompare( SIMD_EQ, false, &(*res)[0], &(*right)[0], &(*this)[0], nEl))
+	return res;
       TRACEOMP( __FILE__, __LINE__)
 #pragma omp parallel if (nEl >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= nEl))
 	{
@@ -861,6 +871,8 @@ BaseGDL* Data_<Sp>::NeOp( BaseGDL* r)
 	  return res;
 	}
 
+      if( SimdCompare( SIMD_NE, true, &(*res)[0], &(*this)[0], &s, nEl))
+	return res;
       TRACEOMP( __FILE__, __LINE__)
 #pragma omp parallel if (nEl >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= nEl))
 	{
@@ -876,6 +888,8 @@ BaseGDL* Data_<Sp>::NeOp( BaseGDL* r)
 	  (*res)[0] = ((*right)[0] != s);
 	  return res;
 	}
+      if( SimdCompare( SIMD_NE, true, &(*res)[0], &(*right)[0], &s, rEl))
+	return res;
       TRACEOMP( __FILE__, __LINE__)
 #pragma omp parallel if (rEl >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= rEl))
 	{
@@ -886,6 +900,8 @@ BaseGDL* Data_<Sp>::NeOp( BaseGDL* r)
   else if( rEl < nEl) 
     {
       res= new Data_<SpDByte>( right->dim, BaseGDL::NOZERO);
+      if( SimdCompare( SIMD_NE, false, &(*res)[0], &(*right)[0], &(*this)[0], rEl))
+	return res;
       TRACEOMP( __FILE__, __LINE__)
 #pragma omp parallel if (rEl >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= rEl))
 	{
@@ -901,6 +917,8 @@ BaseGDL* Data_<Sp>::NeOp( BaseGDL* r)
 	  (*res)[0] = ((*right)[0] != (*this)[0]);
 	  return res;
 	}
+      if( SimdCompare( SIMD_NE, false, &(*res)[0], &(*right)[0], &(*this)[0], nEl))
+	return res;
       TRACEOMP( __FILE__, __LINE__)
 #pragma omp parallel if (nEl >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= nEl))
 	{
@@ -1123,6 +1141,8 @@ BaseGDL* Data_<Sp>::LeOp( BaseGDL* r)
 	  (*res)[0] = ((*this)[0] <= s);
 	  return res;
 	}
+      if( SimdCompare( SIMD_LE, true, &(*res)[0], &(*this)[0], &s, nEl))
+	return res;
       TRACEOMP( __FILE__, __LINE__)
 #pragma omp parallel if (nEl >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= nEl))
 	{
@@ -1138,6 +1158,8 @@ BaseGDL* Data_<Sp>::LeOp( BaseGDL* r)
 	  (*res)[0] = ((*right)[0] >= s);
 	  return res;
 	}
+      if( SimdCompare( SIMD_GE, true, &(*res)[0], &(*right)[0], &s, rEl))
+	return res;
       TRACEOMP( __FILE__, __LINE__)
 #pragma omp parallel if (rEl >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= rEl))
 	{
@@ -1148,6 +1170,8 @@ BaseGDL* Data_<Sp>::LeOp( BaseGDL* r)
   else if( rEl < nEl) 
     {
       res= new Data_<SpDByte>( right->dim, BaseGDL::NOZERO);
+      if( SimdCompare( SIMD_GE, false, &(*res)[0], &(*right)[0], &(*this)[0], rEl))
+	return res;
       TRACEOMP( __FILE__, __LINE__)
 #pragma omp parallel if (rEl >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= rEl))
 	{
@@ -1163,6 +1187,8 @@ BaseGDL* Data_<Sp>::LeOp( BaseGDL* r)
 	  (*res)[0] = ((*right)[0] >= (*this)[0]);
 	  return res;
 	}
+      if( SimdCompare( SIMD_GE, false, &(*res)[0], &(*right)[0], &(*this)[0], nEl))
+	return res;
       TRACEOMP( __FILE__, __LINE__)
 #pragma omp parallel if (nEl >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= nEl))
 	{
@@ -1224,6 +1250,8 @@ BaseGDL* Data_<Sp>::LtOp( BaseGDL* r)
 	  (*res)[0] = ((*this)[0] < s);
 	  return res;
 	}
+      if( SimdCompare( SIMD_LT, true, &(*res)[0], &(*this)[0], &s, nEl))
+	return res;
       TRACEOMP( __FILE__, __LINE__)
 #pragma omp parallel if (nEl >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= nEl))
 	{
@@ -1239,6 +1267,8 @@ BaseGDL* Data_<Sp>::LtOp( BaseGDL* r)
 	  (*res)[0] = ((*right)[0] > s);
 	  return res;
 	}
+      if( SimdCompare( SIMD_GT, true, &(*res)[0], &(*right)[0], &s, rEl))
+	return res;
       TRACEOMP( __FILE__, __LINE__)
 #pragma omp parallel if (rEl >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= rEl))
 	{
@@ -1249,6 +1279,8 @@ BaseGDL* Data_<Sp>::LtOp( BaseGDL* r)
   else if( rEl < nEl) 
     {
       res= new Data_<SpDByte>( right->dim, BaseGDL::NOZERO);
+      if( SimdCompare( SIMD_GT, false, &(*res)[0], &(*right)[0], &(*this)[0], rEl))
+	return res;
       TRACEOMP( __FILE__, __LINE__)
 #pragma omp parallel if (rEl >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= rEl))
 	{
@@ -1264,6 +1296,8 @@ BaseGDL* Data_<Sp>::LtOp( BaseGDL* r)
 	  (*res)[0] = ((*right)[0] > (*this)[0]);
 	  return res;
 	}
+      if( SimdCompare( SIMD_GT, false, &(*res)[0], &(*right)[0], &(*this)[0], nEl))
+	return res;
       TRACEOMP( __FILE__, __LINE__)
 #pragma omp parallel if (nEl >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= nEl))
 	{
@@ -1325,6 +1359,8 @@ BaseGDL* Data_<Sp>::GeOp( BaseGDL* r)
 	  (*res)[0] = ((*this)[0] >= s);
 	  return res;
 	}
+      if( SimdCompare( SIMD_GE, true, &(*res)[0], &(*this)[0], &s, nEl))
+	return res;
       TRACEOMP( __FILE__, __LINE__)
 #pragma omp parallel if (nEl >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= nEl))
 	{
@@ -1340,6 +1376,8 @@ BaseGDL* Data_<Sp>::GeOp( BaseGDL* r)
 	  (*res)[0] = ((*right)[0] <= s);
 	  return res;
 	}
+      if( SimdCompare( SIMD_LE, true, &(*res)[0], &(*right)[0], &s, rEl))
+	return res;
       TRACEOMP( __FILE__, __LINE__)
 #pragma omp parallel if (rEl >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= rEl))
 	{
@@ -1350,6 +1388,8 @@ BaseGDL* Data_<Sp>::GeOp( BaseGDL* r)
   else if( rEl < nEl) 
     {
       res= new Data_<SpDByte>( right->dim, BaseGDL::NOZERO);
+      if( SimdCompare( SIMD_LE, false, &(*res)[0], &(*right)[0], &(*this)[0], rEl))
+	return res;
       TRACEOMP( __FILE__, __LINE__)
 #pragma omp parallel if (rEl >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= rEl))
 	{
@@ -1365,6 +1405,8 @@ BaseGDL* Data_<Sp>::GeOp( BaseGDL* r)
 	  (*res)[0] = ((*right)[0] <= (*this)[0]);
 	  return res;
 	}
+      if( SimdCompare( SIMD_LE, false, &(*res)[0], &(*right)[0], &(*this)[0], nEl))
+	return res;
       TRACEOMP( __FILE__, __LINE__)
 #pragma omp parallel if (nEl >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= nEl))
 	{
@@ -1426,6 +1468,8 @@ BaseGDL* Data_<Sp>::GtOp( BaseGDL* r)
 	  (*res)[0] = ((*this)[0] > s);
 	  return res;
 	}
+      if( SimdCompare( SIMD_GT, true, &(*res)[0], &(*this)[0], &s, nEl))
+	return res;
       TRACEOMP( __FILE__, __LINE__)
 #pragma omp parallel if (nEl >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= nEl))
 	{
@@ -1441,6 +1485,8 @@ BaseGDL* Data_<Sp>::GtOp( BaseGDL* r)
 	  (*res)[0] = ((*right)[0] < s);
 	  return res;
 	}
+      if( SimdCompare( SIMD_LT, true, &(*res)[0], &(*right)[0], &s, rEl))
+	return res;
       TRACEOMP( __FILE__, __LINE__)
 #pragma omp parallel if (rEl >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= rEl))
 	{
@@ -1451,6 +1497,8 @@ BaseGDL* Data_<Sp>::GtOp( BaseGDL* r)
   else if( rEl < nEl) 
     {
       res= new Data_<SpDByte>( right->dim, BaseGDL::NOZERO);
+      if( SimdCompare( SIMD_LT, false, &(*res)[0], &(*right)[0], &(*this)[0], rEl))
+	return res;
       TRACEOMP( __FILE__, __LINE__)
 #pragma omp parallel if (rEl >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= rEl))
 	{
@@ -1466,6 +1514,8 @@ BaseGDL* Data_<Sp>::GtOp( BaseGDL* r)
 	  (*res)[0] = ((*right)[0] < (*this)[0]);
 	  return res;
 	}
+      if( SimdCompare( SIMD_LT, false, &(*res)[0], &(*right)[0], &(*this)[0], nEl))
+	return res;
       TRACEOMP( __FILE__, __LINE__)
 #pragma omp parallel if (nEl >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= nEl))
 	{
@@ -1551,6 +1601,21 @@ Data_<Sp>* Data_<Sp>::MatrixOp( BaseGDL* r, bool atranspose, bool btranspose)
 	  bt = true;
       } 
     } 
+
+    // external BLAS when built with it and enabled (see blas_backend.hpp),
+    // incompatible dimensions are left to the error reporting below
+    if( BlasType<Ty>::value)
+    {
+      SizeT m = at ? NbRow0 : NbCol0;
+      SizeT k = at ? NbCol0 : NbRow0;
+      SizeT n = bt ? NbCol1 : NbRow1;
+      if( k == static_cast<SizeT>( bt ? NbRow1 : NbCol1) && BlasGemmUsable( m, n, k))
+      {
+	Data_* res = new Data_( dimension( m, n), BaseGDL::NOZERO);
+	BlasGemm<Ty>( at, bt, m, n, k, &(*this)[0], NbCol0, &(*par1)[0], NbCol1, &(*res)[0]);
+	return res;
+      }
+    }
     
 #ifdef USE_EIGEN
 
@@ -2712,6 +2777,8 @@ Data_<Sp>* Data_<Sp>::LtMark( BaseGDL* r)
       if( (*this)[0] > (*right)[0]) (*this)[0]=(*right)[0];
       return this;
     }
+  if( SimdArith( SIMD_MIN, SIMD_VV, &(*this)[0], &(*this)[0], &(*right)[0], nEl))
+    return this;
   TRACEOMP( __FILE__, __LINE__)
 #pragma omp parallel if (nEl >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= nEl))
     {
@@ -2766,6 +2833,8 @@ Data_<Sp>* Data_<Sp>::LtMarkS( BaseGDL* r)
     }
   Ty s = (*right)[0];
   // right->Scalar(s);
+  if( SimdArith( SIMD_MIN, SIMD_VS, &(*this)[0], &(*this)[0], &(*right)[0], nEl))
+    return this;
   TRACEOMP( __FILE__, __LINE__)
 #pragma omp parallel if (nEl >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= nEl))
     {
@@ -2824,6 +2893,8 @@ Data_<Sp>* Data_<Sp>::GtMark( BaseGDL* r)
       if( (*this)[0] < (*right)[0]) (*this)[0]=(*right)[0];
       return this;
     }
+  if( SimdArith( SIMD_MAX, SIMD_VV, &(*this)[0], &(*this)[0], &(*right)[0], nEl))
+    return this;
   TRACEOMP( __FILE__, __LINE__)
 #pragma omp parallel if (nEl >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= nEl))
     {
@@ -2879,6 +2950,8 @@ Data_<Sp>* Data_<Sp>::GtMarkS( BaseGDL* r)
 
   Ty s = (*right)[0];
   // right->Scalar(s);
+  if( SimdArith( SIMD_MAX, SIMD_VS, &(*this)[0], &(*this)[0], &(*right)[0], nEl))
+    return this;
   TRACEOMP( __FILE__, __LINE__)
 #pragma omp parallel if (nEl >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= nEl))
     {
@@ -3500,6 +3573,7 @@ Data_<SpDFloat>* Data_<SpDFloat>::Pow( BaseGDL* r)
       }
       else*/
   {
+    if( SimdPow( SIMD_VV, &(*this)[0], &(*this)[0], &(*right)[0], nEl)) return this;
     TRACEOMP( __FILE__, __LINE__)
 #pragma omp parallel if (nEl >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= nEl))
       {
@@ -3643,6 +3717,7 @@ Data_<SpDFloat>* Data_<SpDFloat>::PowInv( BaseGDL* r)
   /*  if( rEl == nEl)
       dd = pow( right->dd, dd); // valarray
       else*/
+  if( SimdPow( SIMD_VV, &(*this)[0], &(*right)[0], &(*this)[0], nEl)) return this;
   TRACEOMP( __FILE__, __LINE__)
 #pragma omp parallel if (nEl >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= nEl))
     {
@@ -3668,6 +3743,7 @@ Data_<SpDDouble>* Data_<SpDDouble>::Pow( BaseGDL* r)
   /*  if( rEl == nEl)
       dd = pow( dd, right->dd); // valarray
       else*/
+  if( SimdPow( SIMD_VV, &(*this)[0], &(*this)[0], &(*right)[0], nEl)) return this;
   TRACEOMP( __FILE__, __LINE__)
 #pragma omp parallel if (nEl >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= nEl))
     {
@@ -3693,6 +3769,7 @@ Data_<SpDDouble>* Data_<SpDDouble>::PowInv( BaseGDL* r)
   /*  if( rEl == nEl)
       dd = pow( right->dd, dd); // valarray
       else*/
+  if( SimdPow( SIMD_VV, &(*this)[0], &(*right)[0], &(*this)[0], nEl)) return this;
   TRACEOMP( __FILE__, __LINE__)
 #pragma omp parallel if (nEl >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= nEl))
     {
@@ -4184,6 +4261,7 @@ Data_<SpDFloat>* Data_<SpDFloat>::PowS( BaseGDL* r)
   assert( nEl);
   Ty s = (*right)[0];
   // right->Scalar(s); 
+  if( SimdPow( SIMD_VS, &(*this)[0], &(*this)[0], &s, nEl)) return this;
   TRACEOMP( __FILE__, __LINE__)
 #pragma omp parallel if (nEl >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= nEl))
     {
@@ -4203,6 +4281,7 @@ Data_<SpDFloat>* Data_<SpDFloat>::PowInvS( BaseGDL* r)
   assert( nEl);
   Ty s = (*right)[0];
   // right->Scalar(s); 
+  if( SimdPow( SIMD_SV, &(*this)[0], &(*this)[0], &s, nEl)) return this;
   TRACEOMP( __FILE__, __LINE__)
 #pragma omp parallel if (nEl >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= nEl))
     {
@@ -4222,6 +4301,7 @@ Data_<SpDDouble>* Data_<SpDDouble>::PowS( BaseGDL* r)
   assert( nEl);
   Ty s = (*right)[0];
   // right->Scalar(s); 
+  if( SimdPow( SIMD_VS, &(*this)[0], &(*this)[0], &s, nEl)) return this;
   TRACEOMP( __FILE__, __LINE__)
 #pragma omp parallel if (nEl >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= nEl))
     {
@@ -4241,6 +4321,7 @@ Data_<SpDDouble>* Data_<SpDDouble>::PowInvS( BaseGDL* r)
   assert( nEl);
   Ty s = (*right)[0];
   // right->Scalar(s); 
+  if( SimdPow( SIMD_SV, &(*this)[0], &(*this)[0], &s, nEl)) return this;
   TRACEOMP( __FILE__, __LINE__)
 #pragma omp parallel if (nEl >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= nEl))
     {
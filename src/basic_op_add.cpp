@@ -25,6 +25,7 @@
 //#include "datatypes.hpp" // for friend declaration
 #include "nullgdl.hpp"
 #include "dinterpreter.hpp"
+#include "simd_dispatch.hpp"
 
 // needed with gcc-3.3.2
 #include <cassert>
@@ -49,6 +50,8 @@ BaseGDL* Data_<Sp>::Add( BaseGDL* r)
       (*this)[0] += (*right)[0];
       return this;
     }
+  if( SimdArith( SIMD_ADD, SIMD_VV, &(*this)[0], &(*this)[0], &(*right)[0], nEl))
+    return this;
 #ifdef USE_EIGEN
 
         Eigen::Map<Eigen::Array<Ty,Eigen::Dynamic,1> ,Eigen::Aligned> mThis(&(*this)[0], nEl);
@@ -314,6 +317,8 @@ BaseGDL* Data_<Sp>::AddS( BaseGDL* r)
   Ty s = (*right)[0];
   // right->Scalar(s);
   //  dd += s;
+  if( SimdArith( SIMD_ADD, SIMD_VS, &(*this)[0], &(*this)[0], &(*right)[0], nEl))
+    return this;
 #ifdef USE_EIGEN
 
         Eigen::Map<Eigen::Array<Ty,Eigen::Dynamic,1> ,Eigen::Aligned> mThis(&(*this)[0], nEl);
@@ -30,6 +30,7 @@
 #include <cassert>
 
 #include "sigfpehandler.hpp"
+#include "simd_dispatch.hpp"
 
 // Div
 // division: left=left/right
@@ -44,6 +45,9 @@ Data_<Sp>* Data_<Sp>::Div( BaseGDL* r)
   assert( nEl);
   //  if( !rEl || !nEl) throw GDLException("Variable is undefined.");  
 
+  if( SimdArith( SIMD_DIV, SIMD_VV, &(*this)[0], &(*this)[0], &(*right)[0], nEl))
+    return this;
+
   SizeT i = 0;
 
   if( sigsetjmp( sigFPEJmpBuf, 1) == 0)
@@ -85,6 +89,9 @@ Data_<Sp>* Data_<Sp>::DivInv( BaseGDL* r)
   //  assert( rEl);
   assert( nEl);
 
+  if( SimdArith( SIMD_DIV, SIMD_VV, &(*this)[0], &(*right)[0], &(*this)[0], nEl))
+    return this;
+
   SizeT i = 0;
 
   //  if( !rEl || !nEl) throw GDLException("Variable is undefined.");  
@@ -166,6 +173,9 @@ Data_<Sp>* Data_<Sp>::DivS( BaseGDL* r)
   assert( nEl);
   Ty s = (*right)[0];
 
+  if( SimdArith( SIMD_DIV, SIMD_VS, &(*this)[0], &(*this)[0], &(*right)[0], nEl))
+    return this;
+
   // remember: this is a template (must work for several types)
   // due to error handling the actual devision by 0
   // has to be done 
@@ -209,6 +219,9 @@ Data_<Sp>* Data_<Sp>::DivInvS( BaseGDL* r)
     return this;
   }
   
+  if( SimdArith( SIMD_DIV, SIMD_SV, &(*this)[0], &(*this)[0], &(*right)[0], nEl))
+    return this;
+
   Ty s = (*right)[0];
   SizeT i=0;
   if( sigsetjmp( sigFPEJmpBuf, 1) == 0)
@@ -25,6 +25,7 @@
 //#include "datatypes.hpp" // for friend declaration
 #include "nullgdl.hpp"
 #include "dinterpreter.hpp"
+#include "simd_dispatch.hpp"
 
 // needed with gcc-3.3.2
 #include <cassert>
@@ -46,6 +47,8 @@ Data_<Sp>* Data_<Sp>::Mult( BaseGDL* r)
       (*this)[0] *= (*right)[0];
       return this;
     }
+  if( SimdArith( SIMD_MUL, SIMD_VV, &(*this)[0], &(*this)[0], &(*right)[0], nEl))
+    return this;
 #ifdef USE_EIGEN
 
   Eigen::Map<Eigen::Array<Ty,Eigen::Dynamic,1> ,Eigen::Aligned> mThis(&(*this)[0], nEl);
@@ -99,6 +102,8 @@ Data_<Sp>* Data_<Sp>::MultS( BaseGDL* r)
   Ty s = (*right)[0];
   // right->Scalar(s);
   //  dd *= s;
+  if( SimdArith( SIMD_MUL, SIMD_VS, &(*this)[0], &(*this)[0], &(*right)[0], nEl))
+    return this;
 #ifdef USE_EIGEN
 
   Eigen::Map<Eigen::Array<Ty,Eigen::Dynamic,1> ,Eigen::Aligned> mThis(&(*this)[0], nEl);
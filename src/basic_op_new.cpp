@@ -32,6 +32,7 @@
 #include "typetraits.hpp"
 
 #include "sigfpehandler.hpp"
+#include "simd_dispatch.hpp"
 
 using namespace std;
 
@@ -927,6 +928,8 @@ BaseGDL* Data_<Sp>::AddNew( BaseGDL* r)
       return res;
     }
 
+  if( SimdArith( SIMD_ADD, SIMD_VV, &(*res)[0], &(*this)[0], &(*right)[0], nEl))
+    return res;
 #ifdef USE_EIGEN
 
         Eigen::Map<Eigen::Array<Ty,Eigen::Dynamic,1> ,Eigen::Aligned> mThis(&(*this)[0], nEl);
@@ -1012,6 +1015,8 @@ BaseGDL* Data_<Sp>::AddSNew( BaseGDL* r)
       return res;
     }
   Ty s = (*right)[0];
+  if( SimdArith( SIMD_ADD, SIMD_VS, &(*res)[0], &(*this)[0], &(*right)[0], nEl))
+    return res;
 #ifdef USE_EIGEN
 
         Eigen::Map<Eigen::Array<Ty,Eigen::Dynamic,1> ,Eigen::Aligned> mThis(&(*this)[0], nEl);
@@ -1102,6 +1107,8 @@ BaseGDL* Data_<Sp>::SubNew( BaseGDL* r)
   Ty s;
   if( right->StrictScalar(s)) 
     {
+      if( SimdArith( SIMD_SUB, SIMD_VS, &(*res)[0], &(*this)[0], &(*right)[0], nEl))
+        return res;
 #ifdef USE_EIGEN
 
         Eigen::Map<Eigen::Array<Ty,Eigen::Dynamic,1> ,Eigen::Aligned> mThis(&(*this)[0], nEl);
@@ -1122,6 +1129,8 @@ BaseGDL* Data_<Sp>::SubNew( BaseGDL* r)
     }
   else 
     {
+      if( SimdArith( SIMD_SUB, SIMD_VV, &(*res)[0], &(*this)[0], &(*right)[0], nEl))
+        return res;
 #ifdef USE_EIGEN
 
         Eigen::Map<Eigen::Array<Ty,Eigen::Dynamic,1> ,Eigen::Aligned> mThis(&(*this)[0], nEl);
@@ -1157,6 +1166,8 @@ BaseGDL* Data_<Sp>::SubInvNew( BaseGDL* r)
       (*res)[0] = (*right)[0] - (*this)[0];
       return res;
     }
+  if( SimdArith( SIMD_SUB, SIMD_VV, &(*res)[0], &(*right)[0], &(*this)[0], nEl))
+    return res;
 #ifdef USE_EIGEN
 
   Eigen::Map<Eigen::Array<Ty,Eigen::Dynamic,1> ,Eigen::Aligned> mThis(&(*this)[0], nEl);
@@ -1228,6 +1239,8 @@ BaseGDL* Data_<Sp>::SubSNew( BaseGDL* r)
     }
   
   Ty s = (*right)[0];
+  if( SimdArith( SIMD_SUB, SIMD_VS, &(*res)[0], &(*this)[0], &(*right)[0], nEl))
+    return res;
 #ifdef USE_EIGEN
 
         Eigen::Map<Eigen::Array<Ty,Eigen::Dynamic,1> ,Eigen::Aligned> mThis(&(*this)[0], nEl);
@@ -1266,6 +1279,8 @@ BaseGDL* Data_<Sp>::SubInvSNew( BaseGDL* r)
   Ty s = (*right)[0];
   // right->Scalar(s); 
   //  dd = s - dd;
+  if( SimdArith( SIMD_SUB, SIMD_SV, &(*res)[0], &(*this)[0], &(*right)[0], nEl))
+    return res;
 #ifdef USE_EIGEN
 
         Eigen::Map<Eigen::Array<Ty,Eigen::Dynamic,1> ,Eigen::Aligned> mThis(&(*this)[0], nEl);
@@ -1338,6 +1353,8 @@ Data_<Sp>* Data_<Sp>::LtMarkNew( BaseGDL* r)
       if( (*this)[0] > (*right)[0]) (*res)[0] = (*right)[0]; else (*res)[0] = (*this)[0];
       return res;
     }
+  if( SimdArith( SIMD_MIN, SIMD_VV, &(*res)[0], &(*this)[0], &(*right)[0], nEl))
+    return res;
   TRACEOMP( __FILE__, __LINE__)
 #pragma omp parallel if (nEl >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= nEl))
     {
@@ -1395,6 +1412,8 @@ Data_<Sp>* Data_<Sp>::LtMarkSNew( BaseGDL* r)
     }
   Ty s = (*right)[0];
   // right->Scalar(s);
+  if( SimdArith( SIMD_MIN, SIMD_VS, &(*res)[0], &(*this)[0], &(*right)[0], nEl))
+    return res;
   TRACEOMP( __FILE__, __LINE__)
 #pragma omp parallel if (nEl >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= nEl))
     {
@@ -1454,6 +1473,8 @@ Data_<Sp>* Data_<Sp>::GtMarkNew( BaseGDL* r)
       if( (*this)[0] < (*right)[0]) (*res)[0] = (*right)[0]; else (*res)[0] = (*this)[0];
       return res;
     }
+  if( SimdArith( SIMD_MAX, SIMD_VV, &(*res)[0], &(*this)[0], &(*right)[0], nEl))
+    return res;
   TRACEOMP( __FILE__, __LINE__)
 #pragma omp parallel if (nEl >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= nEl))
     {
@@ -1511,6 +1532,8 @@ Data_<Sp>* Data_<Sp>::GtMarkSNew( BaseGDL* r)
 
   Ty s = (*right)[0];
   // right->Scalar(s);
+  if( SimdArith( SIMD_MAX, SIMD_VS, &(*res)[0], &(*this)[0], &(*right)[0], nEl))
+    return res;
   TRACEOMP( __FILE__, __LINE__)
 #pragma omp parallel if (nEl >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= nEl))
     {
@@ -1572,6 +1595,8 @@ Data_<Sp>* Data_<Sp>::MultNew( BaseGDL* r)
       (*res)[0] = (*this)[0] * (*right)[0];
       return res;
     }
+  if( SimdArith( SIMD_MUL, SIMD_VV, &(*res)[0], &(*this)[0], &(*right)[0], nEl))
+    return res;
 #ifdef USE_EIGEN
 
         Eigen::Map<Eigen::Array<Ty,Eigen::Dynamic,1> ,Eigen::Aligned> mThis(&(*this)[0], nEl);
@@ -1627,6 +1652,8 @@ Data_<Sp>* Data_<Sp>::MultSNew( BaseGDL* r )
       return res;
     }
   Ty s = ( *right ) [0];
+  if( SimdArith( SIMD_MUL, SIMD_VS, &(*res)[0], &(*this)[0], &(*right)[0], nEl))
+    return res;
 #ifdef USE_EIGEN
 
 	Eigen::Map<Eigen::Array<Ty,Eigen::Dynamic,1> ,Eigen::Aligned> mThis(&(*this)[0], nEl);
@@ -1680,6 +1707,9 @@ Data_<Sp>* Data_<Sp>::DivNew( BaseGDL* r)
   
   Data_* res = NewResult();
 
+  if( SimdArith( SIMD_DIV, SIMD_VV, &(*res)[0], &(*this)[0], &(*right)[0], nEl))
+    return res;
+
   SizeT i = 0;
 
   if( sigsetjmp( sigFPEJmpBuf, 1) == 0)
@@ -1716,6 +1746,9 @@ Data_<Sp>* Data_<Sp>::DivInvNew( BaseGDL* r)
   //  assert( rEl);
   assert( nEl);
 
+  if( SimdArith( SIMD_DIV, SIMD_VV, &(*res)[0], &(*right)[0], &(*this)[0], nEl))
+    return res;
+
   SizeT i = 0;
 
   //  if( !rEl || !nEl) throw GDLException("Variable is undefined.");  
@@ -1789,6 +1822,8 @@ Data_<Sp>* Data_<Sp>::DivSNew( BaseGDL* r)
   Ty s = (*right)[0];
   SizeT i=0;
   Data_* res = NewResult();
+  if( SimdArith( SIMD_DIV, SIMD_VS, &(*res)[0], &(*this)[0], &(*right)[0], nEl))
+    return res;
   if( s != this->zero)
     {
       for( SizeT i=0; i < nEl; ++i)
@@ -1826,6 +1861,9 @@ Data_<Sp>* Data_<Sp>::DivInvSNew( BaseGDL* r)
     return res;    
   }
   
+  if( SimdArith( SIMD_DIV, SIMD_SV, &(*res)[0], &(*this)[0], &(*right)[0], nEl))
+    return res;
+
   Ty s = (*right)[0];
   SizeT i=0;
   if( sigsetjmp( sigFPEJmpBuf, 1) == 0)
@@ -2598,6 +2636,7 @@ Data_<SpDFloat>* Data_<SpDFloat>::PowNew( BaseGDL* r)
 	(*res)[0] = pow( (*this)[0], (*right)[0]);
 	return res;
   }
+  if( SimdPow( SIMD_VV, &(*res)[0], &(*this)[0], &(*right)[0], nEl)) return res;
   TRACEOMP( __FILE__, __LINE__)
 #pragma omp parallel if (nEl >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= nEl))
 	{
@@ -2621,6 +2660,7 @@ Data_<SpDFloat>* Data_<SpDFloat>::PowInvNew( BaseGDL* r)
 	(*res)[0] = pow( (*right)[0], (*this)[0]);
 	return res;
   }
+  if( SimdPow( SIMD_VV, &(*res)[0], &(*right)[0], &(*this)[0], nEl)) return res;
   TRACEOMP( __FILE__, __LINE__)
 #pragma omp parallel if (nEl >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= nEl))
     {
@@ -2644,6 +2684,7 @@ Data_<SpDDouble>* Data_<SpDDouble>::PowNew( BaseGDL* r)
 	(*res)[0] = pow( (*this)[0], (*right)[0]);
 	return res;
   }
+  if( SimdPow( SIMD_VV, &(*res)[0], &(*this)[0], &(*right)[0], nEl)) return res;
   TRACEOMP( __FILE__, __LINE__)
 #pragma omp parallel if (nEl >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= nEl))
 	{
@@ -2668,6 +2709,7 @@ Data_<SpDDouble>* Data_<SpDDouble>::PowInvNew( BaseGDL* r)
 	return res;
   }
 
+  if( SimdPow( SIMD_VV, &(*res)[0], &(*right)[0], &(*this)[0], nEl)) return res;
   TRACEOMP( __FILE__, __LINE__)
 #pragma omp parallel if (nEl >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= nEl))
     {
@@ -3124,6 +3166,7 @@ Data_<Sp>* Data_<Sp>::PowSNew( BaseGDL* r)
   	(*res)[0] = pow( (*this)[0], s);
 	return res;
   }
+  if( SimdPow( SIMD_VS, &(*res)[0], &(*this)[0], &s, nEl)) return res;
   TRACEOMP( __FILE__, __LINE__)
 #pragma omp parallel if (nEl >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= nEl))
     {
@@ -3149,6 +3192,7 @@ Data_<Sp>* Data_<Sp>::PowInvSNew( BaseGDL* r)
   	(*res)[0] = pow( s, (*this)[0]);
 	return res;
   }
+  if( SimdPow( SIMD_SV, &(*res)[0], &(*this)[0], &s, nEl)) return res;
   TRACEOMP( __FILE__, __LINE__)
 #pragma omp parallel if (nEl >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= nEl))
     {
@@ -27,6 +27,7 @@
 //#include "datatypes.hpp" // for friend declaration
 #include "nullgdl.hpp"
 #include "dinterpreter.hpp"
+#include "simd_dispatch.hpp"
 
 // needed with gcc-3.3.2
 #include <cassert>
@@ -48,6 +49,8 @@ BaseGDL* Data_<Sp>::Sub( BaseGDL* r)
       (*this)[0] -= (*right)[0];
       return this;
     }
+  if( SimdArith( SIMD_SUB, SIMD_VV, &(*this)[0], &(*this)[0], &(*right)[0], nEl))
+    return this;
 #ifdef USE_EIGEN
 
   Eigen::Map<Eigen::Array<Ty,Eigen::Dynamic,1> ,Eigen::Aligned> mThis(&(*this)[0], nEl);
@@ -90,6 +93,8 @@ BaseGDL* Data_<Sp>::SubInv( BaseGDL* r)
       (*this)[0] = (*right)[0] - (*this)[0];
       return this;
     }
+  if( SimdArith( SIMD_SUB, SIMD_VV, &(*this)[0], &(*right)[0], &(*this)[0], nEl))
+    return this;
 #ifdef USE_EIGEN
 
   Eigen::Map<Eigen::Array<Ty,Eigen::Dynamic,1> ,Eigen::Aligned> mThis(&(*this)[0], nEl);
@@ -340,6 +345,8 @@ Data_<Sp>* Data_<Sp>::SubS( BaseGDL* r)
   Ty s = (*right)[0];
   // right->Scalar(s); 
   //  dd -= s;
+  if( SimdArith( SIMD_SUB, SIMD_VS, &(*this)[0], &(*this)[0], &(*right)[0], nEl))
+    return this;
 #ifdef USE_EIGEN
 
         Eigen::Map<Eigen::Array<Ty,Eigen::Dynamic,1> ,Eigen::Aligned> mThis(&(*this)[0], nEl);
@@ -375,6 +382,8 @@ Data_<Sp>* Data_<Sp>::SubInvS( BaseGDL* r)
   Ty s = (*right)[0];
   // right->Scalar(s); 
   //  dd = s - dd;
+  if( SimdArith( SIMD_SUB, SIMD_SV, &(*this)[0], &(*this)[0], &(*right)[0], nEl))
+    return this;
 #ifdef USE_EIGEN
 
         Eigen::Map<Eigen::Array<Ty,Eigen::Dynamic,1> ,Eigen::Aligned> mThis(&(*this)[0], nEl);
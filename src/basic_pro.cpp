@@ -48,6 +48,8 @@
 #include "io.hpp"
 #include "basic_pro.hpp"
 #include "semshm.hpp"
+#include "blas_backend.hpp"
+#include "simd_dispatch.hpp"
 #include "graphicsdevice.hpp"
 
 #ifdef HAVE_EXT_STDIO_FILEBUF_H
@@ -69,6 +71,7 @@ namespace lib {
     static int min_eltsIx = e->KeywordIx("TPOOL_MIN_ELTS");
     static int nThreadsIx = e->KeywordIx("TPOOL_NTHREADS");
     static int vectorEableIx = e->KeywordIx("VECTOR_ENABLE");
+    static int blasIx = e->KeywordIx("BLAS");
 
     bool reset = e->KeywordSet(resetIx);
     bool restore = e->KeywordSet(restoreIx);
@@ -141,6 +144,17 @@ namespace lib {
 #ifdef _OPENMP
     omp_set_num_threads(CpuTPOOL_NTHREADS);
 #endif
+
+    // GDL extension: switch the external BLAS/LAPACK backend on or off
+    if (e->KeywordPresentAndDefined(blasIx)) {
+      bool wantBLAS = e->KeywordSet(blasIx);
+      if (wantBLAS && !BlasCompiled())
+        Warning("CPU : Warning: GDL was compiled without BLAS/LAPACK support, BLAS keyword ignored.");
+      useBLASBackend = wantBLAS && BlasCompiled();
+      DStructGDL* gdlconfig = SysVar::GDLconfig();
+      static unsigned BLASTag = gdlconfig->Desc()->TagIndex("GDL_USE_BLAS");
+      (*static_cast<DByteGDL*> (gdlconfig->GetTag(BLASTag, 0)))[0] = useBLASBackend;
+    }
   }
 
 //  // Was supposed to control some !GDL settings
@@ -1409,13 +1423,7 @@ namespace lib {
 
           char* addr = static_cast<char*> (par->DataAddr());
 
-          for (SizeT i = 0; i < nSwap; ++i) {
-            for (SizeT s = 0; s < (swapSz / 2); ++s) {
-              char tmp = *(addr + i * swapSz + s);
-              *(addr + i * swapSz + s) = *(addr + i * swapSz + swapSz - 1 - s);
-              *(addr + i * swapSz + swapSz - 1 - s) = tmp;
-            }
-          }
+          SimdByteSwap(addr, swapSz, nSwap);
         }
       }
     } else {
@@ -1436,13 +1444,7 @@ namespace lib {
 
       char* addr = static_cast<char*> (par->DataAddr());
 
-      for (SizeT i = 0; i < nSwap; ++i) {
-        for (SizeT s = 0; s < (swapSz / 2); ++s) {
-          char tmp = *(addr + i * swapSz + s);
-          *(addr + i * swapSz + s) = *(addr + i * swapSz + swapSz - 1 - s);
-          *(addr + i * swapSz + swapSz - 1 - s) = tmp;
-        }
-      }
+      SimdByteSwap(addr, swapSz, nSwap);
     }
   }
 
@@ -0,0 +1,535 @@
+/***************************************************************************
+                          blas_backend.cpp  -  optional BLAS/LAPACK backend
+                             -------------------
+    begin                : Oct 2026
+    copyright            : (C) 2026 by the GDL team
+    email                :
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "includefirst.hpp"
+
+#include <climits>
+#include <cmath>
+#include <vector>
+#include <algorithm>
+#include <complex>
+#include <atomic>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "objects.hpp"
+#include "blas_backend.hpp"
+
+#ifdef USE_BLAS
+
+// Fortran 77 interface, LP64 integers: present in every BLAS/LAPACK
+extern "C" {
+  void sgemm_( const char* ta, const char* tb, const int* m, const int* n, const int* k,
+	       const DFloat* alpha, const DFloat* a, const int* lda, const DFloat* b, const int* ldb,
+	       const DFloat* beta, DFloat* c, const int* ldc);
+  void dgemm_( const char* ta, const char* tb, const int* m, const int* n, const int* k,
+	       const DDouble* alpha, const DDouble* a, const int* lda, const DDouble* b, const int* ldb,
+	       const DDouble* beta, DDouble* c, const int* ldc);
+  void cgemm_( const char* ta, const char* tb, const int* m, const int* n, const int* k,
+	       const DComplex* alpha, const DComplex* a, const int* lda, const DComplex* b, const int* ldb,
+	       const DComplex* beta, DComplex* c, const int* ldc);
+  void zgemm_( const char* ta, const char* tb, const int* m, const int* n, const int* k,
+	       const DComplexDbl* alpha, const DComplexDbl* a, const int* lda, const DComplexDbl* b, const int* ldb,
+	       const DComplexDbl* beta, DComplexDbl* c, const int* ldc);
+
+  void sgetrf_( const int* m, const int* n, DFloat* a, const int* lda, int* ipiv, int* info);
+  void dgetrf_( const int* m, const int* n, DDouble* a, const int* lda, int* ipiv, int* info);
+  void cgetrf_( const int* m, const int* n, DComplex* a, const int* lda, int* ipiv, int* info);
+  void zgetrf_( const int* m, const int* n, DComplexDbl* a, const int* lda, int* ipiv, int* info);
+
+  void sgetri_( const int* n, DFloat* a, const int* lda, const int* ipiv, DFloat* work, const int* lwork, int* info);
+  void dgetri_( const int* n, DDouble* a, const int* lda, const int* ipiv, DDouble* work, const int* lwork, int* info);
+  void cgetri_( const int* n, DComplex* a, const int* lda, const int* ipiv, DComplex* work, const int* lwork, int* info);
+  void zgetri_( const int* n, DComplexDbl* a, const int* lda, const int* ipiv, DComplexDbl* work, const int* lwork, int* info);
+
+  void ssyevr_( const char* jobz, const char* range, const char* uplo, const int* n, DFloat* a, const int* lda,
+		const DFloat* vl, const DFloat* vu, const int* il, const int* iu, const DFloat* abstol, int* m, DFloat* w,
+		DFloat* z, const int* ldz, int* isuppz, DFloat* work, const int* lwork, int* iwork, const int* liwork, int* info);
+  void ssyevd_( const char* jobz, const char* uplo, const int* n, DFloat* a, const int* lda, DFloat* w,
+		DFloat* work, const int* lwork, int* iwork, const int* liwork, int* info);
+  void ssygvx_( const int* itype, const char* jobz, const char* range, const char* uplo, const int* n,
+		DFloat* a, const int* lda, DFloat* b, const int* ldb, const DFloat* vl, const DFloat* vu, const int* il, const int* iu,
+		const DFloat* abstol, int* m, DFloat* w, DFloat* z, const int* ldz, DFloat* work, const int* lwork,
+		int* iwork, int* ifail, int* info);
+  void ssygvd_( const int* itype, const char* jobz, const char* uplo, const int* n, DFloat* a, const int* lda,
+		DFloat* b, const int* ldb, DFloat* w, DFloat* work, const int* lwork, int* iwork, const int* liwork, int* info);
+  void sgesdd_( const char* jobz, const int* m, const int* n, DFloat* a, const int* lda, DFloat* s,
+		DFloat* u, const int* ldu, DFloat* vt, const int* ldvt, DFloat* work, const int* lwork, int* iwork, int* info);
+  void sgesvd_( const char* jobu, const char* jobvt, const int* m, const int* n, DFloat* a, const int* lda, DFloat* s,
+		DFloat* u, const int* ldu, DFloat* vt, const int* ldvt, DFloat* work, const int* lwork, int* info);
+  void dsyevr_( const char* jobz, const char* range, const char* uplo, const int* n, DDouble* a, const int* lda,
+		const DDouble* vl, const DDouble* vu, const int* il, const int* iu, const DDouble* abstol, int* m, DDouble* w,
+		DDouble* z, const int* ldz, int* isuppz, DDouble* work, const int* lwork, int* iwork, const int* liwork, int* info);
+  void dsyevd_( const char* jobz, const char* uplo, const int* n, DDouble* a, const int* lda, DDouble* w,
+		DDouble* work, const int* lwork, int* iwork, const int* liwork, int* info);
+  void dsygvx_( const int* itype, const char* jobz, const char* range, const char* uplo, const int* n,
+		DDouble* a, const int* lda, DDouble* b, const int* ldb, const DDouble* vl, const DDouble* vu, const int* il, const int* iu,
+		const DDouble* abstol, int* m, DDouble* w, DDouble* z, const int* ldz, DDouble* work, const int* lwork,
+		int* iwork, int* ifail, int* info);
+  void dsygvd_( const int* itype, const char* jobz, const char* uplo, const int* n, DDouble* a, const int* lda,
+		DDouble* b, const int* ldb, DDouble* w, DDouble* work, const int* lwork, int* iwork, const int* liwork, int* info);
+  void dgesdd_( const char* jobz, const int* m, const int* n, DDouble* a, const int* lda, DDouble* s,
+		DDouble* u, const int* ldu, DDouble* vt, const int* ldvt, DDouble* work, const int* lwork, int* iwork, int* info);
+  void dgesvd_( const char* jobu, const char* jobvt, const int* m, const int* n, DDouble* a, const int* lda, DDouble* s,
+		DDouble* u, const int* ldu, DDouble* vt, const int* ldvt, DDouble* work, const int* lwork, int* info);
+  void cheevr_( const char* jobz, const char* range, const char* uplo, const int* n, DComplex* a, const int* lda,
+		const DFloat* vl, const DFloat* vu, const int* il, const int* iu, const DFloat* abstol, int* m, DFloat* w,
+		DComplex* z, const int* ldz, int* isuppz, DComplex* work, const int* lwork, DFloat* rwork, const int* lrwork, int* iwork, const int* liwork, int* info);
+  void cheevd_( const char* jobz, const char* uplo, const int* n, DComplex* a, const int* lda, DFloat* w,
+		DComplex* work, const int* lwork, DFloat* rwork, const int* lrwork, int* iwork, const int* liwork, int* info);
+  void chegvx_( const int* itype, const char* jobz, const char* range, const char* uplo, const int* n,
+		DComplex* a, const int* lda, DComplex* b, const int* ldb, const DFloat* vl, const DFloat* vu, const int* il, const int* iu,
+		const DFloat* abstol, int* m, DFloat* w, DComplex* z, const int* ldz, DComplex* work, const int* lwork, DFloat* rwork,
+		int* iwork, int* ifail, int* info);
+  void chegvd_( const int* itype, const char* jobz, const char* uplo, const int* n, DComplex* a, const int* lda,
+		DComplex* b, const int* ldb, DFloat* w, DComplex* work, const int* lwork, DFloat* rwork, const int* lrwork, int* iwork, const int* liwork, int* info);
+  void cgesdd_( const char* jobz, const int* m, const int* n, DComplex* a, const int* lda, DFloat* s,
+		DComplex* u, const int* ldu, DComplex* vt, const int* ldvt, DComplex* work, const int* lwork, DFloat* rwork, int* iwork, int* info);
+  void cgesvd_( const char* jobu, const char* jobvt, const int* m, const int* n, DComplex* a, const int* lda, DFloat* s,
+		DComplex* u, const int* ldu, DComplex* vt, const int* ldvt, DComplex* work, const int* lwork, DFloat* rwork, int* info);
+  void zheevr_( const char* jobz, const char* range, const char* uplo, const int* n, DComplexDbl* a, const int* lda,
+		const DDouble* vl, const DDouble* vu, const int* il, const int* iu, const DDouble* abstol, int* m, DDouble* w,
+		DComplexDbl* z, const int* ldz, int* isuppz, DComplexDbl* work, const int* lwork, DDouble* rwork, const int* lrwork, int* iwork, const int* liwork, int* info);
+  void zheevd_( const char* jobz, const char* uplo, const int* n, DComplexDbl* a, const int* lda, DDouble* w,
+		DComplexDbl* work, const int* lwork, DDouble* rwork, const int* lrwork, int* iwork, const int* liwork, int* info);
+  void zhegvx_( const int* itype, const char* jobz, const char* range, const char* uplo, const int* n,
+		DComplexDbl* a, const int* lda, DComplexDbl* b, const int* ldb, const DDouble* vl, const DDouble* vu, const int* il, const int* iu,
+		const DDouble* abstol, int* m, DDouble* w, DComplexDbl* z, const int* ldz, DComplexDbl* work, const int* lwork, DDouble* rwork,
+		int* iwork, int* ifail, int* info);
+  void zhegvd_( const int* itype, const char* jobz, const char* uplo, const int* n, DComplexDbl* a, const int* lda,
+		DComplexDbl* b, const int* ldb, DDouble* w, DComplexDbl* work, const int* lwork, DDouble* rwork, const int* lrwork, int* iwork, const int* liwork, int* info);
+  void zgesdd_( const char* jobz, const int* m, const int* n, DComplexDbl* a, const int* lda, DDouble* s,
+		DComplexDbl* u, const int* ldu, DComplexDbl* vt, const int* ldvt, DComplexDbl* work, const int* lwork, DDouble* rwork, int* iwork, int* info);
+  void zgesvd_( const char* jobu, const char* jobvt, const int* m, const int* n, DComplexDbl* a, const int* lda, DDouble* s,
+		DComplexDbl* u, const int* ldu, DComplexDbl* vt, const int* ldvt, DComplexDbl* work, const int* lwork, DDouble* rwork, int* info);
+}
+
+// thread control of the usual implementations, resolved only if linked in
+#if defined(__GNUC__) && !defined(_WIN32)
+extern "C" {
+  void openblas_set_num_threads( int) __attribute__((weak));
+  void bli_thread_set_num_threads( long) __attribute__((weak));
+  void MKL_Set_Num_Threads( int) __attribute__((weak));
+}
+#define BLAS_HAS_THREAD_CONTROL
+#endif
+
+namespace {
+
+  // GDL's own OpenMP loops are bypassed for calls sent to the backend, so the
+  // library gets !CPU's thread count instead, or one thread for small problems
+  // and when we are already inside a parallel region (no nested teams).
+  void BlasSetThreads( SizeT nOp)
+  {
+#ifdef BLAS_HAS_THREAD_CONTROL
+    // last count set; also reached from callers running in parallel
+    static std::atomic<int> current( -1);
+    int nThreads = CpuTPOOL_NTHREADS;
+    if( nOp < CpuTPOOL_MIN_ELTS || (CpuTPOOL_MAX_ELTS != 0 && CpuTPOOL_MAX_ELTS > nOp))
+      nThreads = 1;
+#ifdef _OPENMP
+    if( omp_in_parallel()) nThreads = 1;
+#endif
+    if( nThreads < 1) nThreads = 1;
+    if( current.exchange( nThreads) == nThreads) return;
+    if( openblas_set_num_threads != NULL) openblas_set_num_threads( nThreads);
+    if( bli_thread_set_num_threads != NULL) bli_thread_set_num_threads( nThreads);
+    if( MKL_Set_Num_Threads != NULL) MKL_Set_Num_Threads( nThreads);
+#endif
+  }
+
+  template<typename T> struct LapackFn;
+  template<> struct LapackFn<DFloat> {
+    typedef DFloat Real;
+    static void gemm( const char* ta, const char* tb, const int* m, const int* n, const int* k,
+		      const DFloat* al, const DFloat* a, const int* lda, const DFloat* b, const int* ldb,
+		      const DFloat* be, DFloat* c, const int* ldc)
+    { sgemm_( ta, tb, m, n, k, al, a, lda, b, ldb, be, c, ldc);}
+    static void getrf( const int* m, const int* n, DFloat* a, const int* lda, int* ipiv, int* info)
+    { sgetrf_( m, n, a, lda, ipiv, info);}
+    static void getri( const int* n, DFloat* a, const int* lda, const int* ipiv, DFloat* w, const int* lw, int* info)
+    { sgetri_( n, a, lda, ipiv, w, lw, info);}
+    static const bool isComplex = false;
+    static void syevr( const char* jz, const char* rg, const char* ul, const int* n, DFloat* a, const int* lda,
+		       const DFloat* vl, const DFloat* vu, const int* il, const int* iu, const DFloat* tol, int* m, DFloat* w,
+		       DFloat* z, const int* ldz, int* isz, DFloat* wk, const int* lw, DFloat* rw, const int* lrw,
+		       int* iw, const int* liw, int* info)
+    { ssyevr_( jz, rg, ul, n, a, lda, vl, vu, il, iu, tol, m, w, z, ldz, isz, wk, lw, iw, liw, info);}
+    static void syevd( const char* jz, const char* ul, const int* n, DFloat* a, const int* lda, DFloat* w,
+		       DFloat* wk, const int* lw, DFloat* rw, const int* lrw, int* iw, const int* liw, int* info)
+    { ssyevd_( jz, ul, n, a, lda, w, wk, lw, iw, liw, info);}
+    static void sygvx( const int* it, const char* jz, const char* rg, const char* ul, const int* n,
+		       DFloat* a, const int* lda, DFloat* b, const int* ldb, const DFloat* vl, const DFloat* vu,
+		       const int* il, const int* iu, const DFloat* tol, int* m, DFloat* w, DFloat* z, const int* ldz,
+		       DFloat* wk, const int* lw, DFloat* rw, int* iw, int* ifail, int* info)
+    { ssygvx_( it, jz, rg, ul, n, a, lda, b, ldb, vl, vu, il, iu, tol, m, w, z, ldz, wk, lw, iw, ifail, info);}
+    static void sygvd( const int* it, const char* jz, const char* ul, const int* n, DFloat* a, const int* lda,
+		       DFloat* b, const int* ldb, DFloat* w, DFloat* wk, const int* lw, DFloat* rw, const int* lrw,
+		       int* iw, const int* liw, int* info)
+    { ssygvd_( it, jz, ul, n, a, lda, b, ldb, w, wk, lw, iw, liw, info);}
+    static void gesdd( const char* jz, const int* m, const int* n, DFloat* a, const int* lda, DFloat* s,
+		       DFloat* u, const int* ldu, DFloat* vt, const int* ldvt, DFloat* wk, const int* lw, DFloat* rw,
+		       int* iw, int* info)
+    { sgesdd_( jz, m, n, a, lda, s, u, ldu, vt, ldvt, wk, lw, iw, info);}
+    static void gesvd( const char* ju, const char* jvt, const int* m, const int* n, DFloat* a, const int* lda, DFloat* s,
+		       DFloat* u, const int* ldu, DFloat* vt, const int* ldvt, DFloat* wk, const int* lw, DFloat* rw, int* info)
+    { sgesvd_( ju, jvt, m, n, a, lda, s, u, ldu, vt, ldvt, wk, lw, info);}
+  };
+  template<> struct LapackFn<DDouble> {
+    typedef DDouble Real;
+    static void gemm( const char* ta, const char* tb, const int* m, const int* n, const int* k,
+		      const DDouble* al, const DDouble* a, const int* lda, const DDouble* b, const int* ldb,
+		      const DDouble* be, DDouble* c, const int* ldc)
+    { dgemm_( ta, tb, m, n, k, al, a, lda, b, ldb, be, c, ldc);}
+    static void getrf( const int* m, const int* n, DDouble* a, const int* lda, int* ipiv, int* info)
+    { dgetrf_( m, n, a, lda, ipiv, info);}
+    static void getri( const int* n, DDouble* a, const int* lda, const int* ipiv, DDouble* w, const int* lw, int* info)
+    { dgetri_( n, a, lda, ipiv, w, lw, info);}
+    static const bool isComplex = false;
+    static void syevr( const char* jz, const char* rg, const char* ul, const int* n, DDouble* a, const int* lda,
+		       const DDouble* vl, const DDouble* vu, const int* il, const int* iu, const DDouble* tol, int* m, DDouble* w,
+		       DDouble* z, const int* ldz, int* isz, DDouble* wk, const int* lw, DDouble* rw, const int* lrw,
+		       int* iw, const int* liw, int* info)
+    { dsyevr_( jz, rg, ul, n, a, lda, vl, vu, il, iu, tol, m, w, z, ldz, isz, wk, lw, iw, liw, info);}
+    static void syevd( const char* jz, const char* ul, const int* n, DDouble* a, const int* lda, DDouble* w,
+		       DDouble* wk, const int* lw, DDouble* rw, const int* lrw, int* iw, const int* liw, int* info)
+    { dsyevd_( jz, ul, n, a, lda, w, wk, lw, iw, liw, info);}
+    static void sygvx( const int* it, const char* jz, const char* rg, const char* ul, const int* n,
+		       DDouble* a, const int* lda, DDouble* b, const int* ldb, const DDouble* vl, const DDouble* vu,
+		       const int* il, const int* iu, const DDouble* tol, int* m, DDouble* w, DDouble* z, const int* ldz,
+		       DDouble* wk, const int* lw, DDouble* rw, int* iw, int* ifail, int* info)
+    { dsygvx_( it, jz, rg, ul, n, a, lda, b, ldb, vl, vu, il, iu, tol, m, w, z, ldz, wk, lw, iw, ifail, info);}
+    static void sygvd( const int* it, const char* jz, const char* ul, const int* n, DDouble* a, const int* lda,
+		       DDouble* b, const int* ldb, DDouble* w, DDouble* wk, const int* lw, DDouble* rw, const int* lrw,
+		       int* iw, const int* liw, int* info)
+    { dsygvd_( it, jz, ul, n, a, lda, b, ldb, w, wk, lw, iw, liw, info);}
+    static void gesdd( const char* jz, const int* m, const int* n, DDouble* a, const int* lda, DDouble* s,
+		       DDouble* u, const int* ldu, DDouble* vt, const int* ldvt, DDouble* wk, const int* lw, DDouble* rw,
+		       int* iw, int* info)
+    { dgesdd_( jz, m, n, a, lda, s, u, ldu, vt, ldvt, wk, lw, iw, info);}
+    static void gesvd( const char* ju, const char* jvt, const int* m, const int* n, DDouble* a, const int* lda, DDouble* s,
+		       DDouble* u, const int* ldu, DDouble* vt, const int* ldvt, DDouble* wk, const int* lw, DDouble* rw, int* info)
+    { dgesvd_( ju, jvt, m, n, a, lda, s, u, ldu, vt, ldvt, wk, lw, info);}
+  };
+  template<> struct LapackFn<DComplex> {
+    typedef DFloat Real;
+    static void gemm( const char* ta, const char* tb, const int* m, const int* n, const int* k,
+		      const DComplex* al, const DComplex* a, const int* lda, const DComplex* b, const int* ldb,
+		      const DComplex* be, DComplex* c, const int* ldc)
+    { cgemm_( ta, tb, m, n, k, al, a, lda, b, ldb, be, c, ldc);}
+    static void getrf( const int* m, const int* n, DComplex* a, const int* lda, int* ipiv, int* info)
+    { cgetrf_( m, n, a, lda, ipiv, info);}
+    static void getri( const int* n, DComplex* a, const int* lda, const int* ipiv, DComplex* w, const int* lw, int* info)
+    { cgetri_( n, a, lda, ipiv, w, lw, info);}
+    static const bool isComplex = true;
+    static void syevr( const char* jz, const char* rg, const char* ul, const int* n, DComplex* a, const int* lda,
+		       const DFloat* vl, const DFloat* vu, const int* il, const int* iu, const DFloat* tol, int* m, DFloat* w,
+		       DComplex* z, const int* ldz, int* isz, DComplex* wk, const int* lw, DFloat* rw, const int* lrw,
+		       int* iw, const int* liw, int* info)
+    { cheevr_( jz, rg, ul, n, a, lda, vl, vu, il, iu, tol, m, w, z, ldz, isz, wk, lw, rw, lrw, iw, liw, info);}
+    static void syevd( const char* jz, const char* ul, const int* n, DComplex* a, const int* lda, DFloat* w,
+		       DComplex* wk, const int* lw, DFloat* rw, const int* lrw, int* iw, const int* liw, int* info)
+    { cheevd_( jz, ul, n, a, lda, w, wk, lw, rw, lrw, iw, liw, info);}
+    static void sygvx( const int* it, const char* jz, const char* rg, const char* ul, const int* n,
+		       DComplex* a, const int* lda, DComplex* b, const int* ldb, const DFloat* vl, const DFloat* vu,
+		       const int* il, const int* iu, const DFloat* tol, int* m, DFloat* w, DComplex* z, const int* ldz,
+		       DComplex* wk, const int* lw, DFloat* rw, int* iw, int* ifail, int* info)
+    { chegvx_( it, jz, rg, ul, n, a, lda, b, ldb, vl, vu, il, iu, tol, m, w, z, ldz, wk, lw, rw, iw, ifail, info);}
+    static void sygvd( const int* it, const char* jz, const char* ul, const int* n, DComplex* a, const int* lda,
+		       DComplex* b, const int* ldb, DFloat* w, DComplex* wk, const int* lw, DFloat* rw, const int* lrw,
+		       int* iw, const int* liw, int* info)
+    { chegvd_( it, jz, ul, n, a, lda, b, ldb, w, wk, lw, rw, lrw, iw, liw, info);}
+    static void gesdd( const char* jz, const int* m, const int* n, DComplex* a, const int* lda, DFloat* s,
+		       DComplex* u, const int* ldu, DComplex* vt, const int* ldvt, DComplex* wk, const int* lw, DFloat* rw,
+		       int* iw, int* info)
+    { cgesdd_( jz, m, n, a, lda, s, u, ldu, vt, ldvt, wk, lw, rw, iw, info);}
+    static void gesvd( const char* ju, const char* jvt, const int* m, const int* n, DComplex* a, const int* lda, DFloat* s,
+		       DComplex* u, const int* ldu, DComplex* vt, const int* ldvt, DComplex* wk, const int* lw, DFloat* rw, int* info)
+    { cgesvd_( ju, jvt, m, n, a, lda, s, u, ldu, vt, ldvt, wk, lw, rw, info);}
+  };
+  template<> struct LapackFn<DComplexDbl> {
+    typedef DDouble Real;
+    static void gemm( const char* ta, const char* tb, const int* m, const int* n, const int* k,
+		      const DComplexDbl* al, const DComplexDbl* a, const int* lda, const DComplexDbl* b, const int* ldb,
+		      const DComplexDbl* be, DComplexDbl* c, const int* ldc)
+    { zgemm_( ta, tb, m, n, k, al, a, lda, b, ldb, be, c, ldc);}
+    static void getrf( const int* m, const int* n, DComplexDbl* a, const int* lda, int* ipiv, int* info)
+    { zgetrf_( m, n, a, lda, ipiv, info);}
+    static void getri( const int* n, DComplexDbl* a, const int* lda, const int* ipiv, DComplexDbl* w, const int* lw, int* info)
+    { zgetri_( n, a, lda, ipiv, w, lw, info);}
+    static const bool isComplex = true;
+    static void syevr( const char* jz, const char* rg, const char* ul, const int* n, DComplexDbl* a, const int* lda,
+		       const DDouble* vl, const DDouble* vu, const int* il, const int* iu, const DDouble* tol, int* m, DDouble* w,
+		       DComplexDbl* z, const int* ldz, int* isz, DComplexDbl* wk, const int* lw, DDouble* rw, const int* lrw,
+		       int* iw, const int* liw, int* info)
+    { zheevr_( jz, rg, ul, n, a, lda, vl, vu, il, iu, tol, m, w, z, ldz, isz, wk, lw, rw, lrw, iw, liw, info);}
+    static void syevd( const char* jz, const char* ul, const int* n, DComplexDbl* a, const int* lda, DDouble* w,
+		       DComplexDbl* wk, const int* lw, DDouble* rw, const int* lrw, int* iw, const int* liw, int* info)
+    { zheevd_( jz, ul, n, a, lda, w, wk, lw, rw, lrw, iw, liw, info);}
+    static void sygvx( const int* it, const char* jz, const char* rg, const char* ul, const int* n,
+		       DComplexDbl* a, const int* lda, DComplexDbl* b, const int* ldb, const DDouble* vl, const DDouble* vu,
+		       const int* il, const int* iu, const DDouble* tol, int* m, DDouble* w, DComplexDbl* z, const int* ldz,
+		       DComplexDbl* wk, const int* lw, DDouble* rw, int* iw, int* ifail, int* info)
+    { zhegvx_( it, jz, rg, ul, n, a, lda, b, ldb, vl, vu, il, iu, tol, m, w, z, ldz, wk, lw, rw, iw, ifail, info);}
+    static void sygvd( const int* it, const char* jz, const char* ul, const int* n, DComplexDbl* a, const int* lda,
+		       DComplexDbl* b, const int* ldb, DDouble* w, DComplexDbl* wk, const int* lw, DDouble* rw, const int* lrw,
+		       int* iw, const int* liw, int* info)
+    { zhegvd_( it, jz, ul, n, a, lda, b, ldb, w, wk, lw, rw, lrw, iw, liw, info);}
+    static void gesdd( const char* jz, const int* m, const int* n, DComplexDbl* a, const int* lda, DDouble* s,
+		       DComplexDbl* u, const int* ldu, DComplexDbl* vt, const int* ldvt, DComplexDbl* wk, const int* lw, DDouble* rw,
+		       int* iw, int* info)
+    { zgesdd_( jz, m, n, a, lda, s, u, ldu, vt, ldvt, wk, lw, rw, iw, info);}
+    static void gesvd( const char* ju, const char* jvt, const int* m, const int* n, DComplexDbl* a, const int* lda, DDouble* s,
+		       DComplexDbl* u, const int* ldu, DComplexDbl* vt, const int* ldvt, DComplexDbl* wk, const int* lw, DDouble* rw, int* info)
+    { zgesvd_( ju, jvt, m, n, a, lda, s, u, ldu, vt, ldvt, wk, lw, rw, info);}
+  };
+
+  template<typename T>
+  void BlasGemmT( bool at, bool bt, SizeT m, SizeT n, SizeT k,
+		  const T* a, SizeT lda, const T* b, SizeT ldb, T* c)
+  {
+    BlasSetThreads( m * n * k);
+    const char ta = at ? 'T' : 'N';
+    const char tb = bt ? 'T' : 'N';
+    const int im = m, in = n, ik = k, ilda = lda, ildb = ldb, ildc = m;
+    const T one = 1;
+    const T zero = 0;
+    LapackFn<T>::gemm( &ta, &tb, &im, &in, &ik, &one, a, &ilda, b, &ildb, &zero, c, &ildc);
+  }
+
+  template<typename T>
+  int LapackInvertT( SizeT n, T* a, double& lnDet)
+  {
+    if( !useBLASBackend || n > static_cast<SizeT>( INT_MAX / n)) return -1;
+    BlasSetThreads( n * n * n);
+
+    const int in = n;
+    std::vector<int> ipiv( n);
+    int info = 0;
+    LapackFn<T>::getrf( &in, &in, a, &in, &ipiv[0], &info);
+    if( info < 0) return -1;
+
+    lnDet = 0;
+    for( SizeT i = 0; i < n; ++i)
+      lnDet += std::log( static_cast<double>( std::abs( a[ i * (n + 1)])));
+    if( info > 0)
+      {
+	std::fill( a, a + n * n, T( 0));
+	return 1;
+      }
+
+    // workspace query first
+    T wq = 0;
+    int lwork = -1;
+    LapackFn<T>::getri( &in, a, &in, &ipiv[0], &wq, &lwork, &info);
+    lwork = std::max( static_cast<int>( std::abs( wq)), 1);
+    std::vector<T> work( lwork);
+    LapackFn<T>::getri( &in, a, &in, &ipiv[0], &work[0], &lwork, &info);
+    if( info < 0) return -1;
+    return 0;
+  }
+
+  inline int WorkSize( double q) { return std::max( static_cast<int>( q + 0.5), 1);}
+  template<typename T>
+  inline int WorkSize( std::complex<T> q) { return WorkSize( static_cast<double>( q.real()));}
+
+  template<typename T>
+  int LapackSymEigenT( SizeT n, T* a, T* b, int itype, bool divConquer,
+		       int range, SizeT il, SizeT iu, double vl, double vu, double abstol,
+		       typename LapackFn<T>::Real* w, T* z, SizeT& nFound)
+  {
+    typedef typename LapackFn<T>::Real Real;
+    if( !useBLASBackend || n > static_cast<SizeT>( INT_MAX / n)) return -1;
+    BlasSetThreads( n * n * n);
+
+    const char jobz = (z != NULL) ? 'V' : 'N';
+    const char rng = (range == 1) ? 'I' : ((range == 2) ? 'V' : 'A');
+    const char uplo = 'L';
+    const int in = n, iType = itype;
+    const int iIl = (range == 1) ? il + 1 : 1;
+    const int iIu = (range == 1) ? iu + 1 : n;
+    const Real rVl = vl, rVu = vu, rTol = abstol;
+    T zDummy = 0;
+    T* zz = (z != NULL) ? z : &zDummy;
+    const int ldz = (z != NULL) ? n : 1;
+    int m = n, info = 0;
+
+    // workspace query first
+    T wq = 0;
+    Real rwq = 1;
+    int iwq = 1;
+    int lwork = -1, lrwork = -1, liwork = -1;
+    std::vector<int> isuppz, ifail;
+    if( divConquer)
+      {
+	if( b == NULL)
+	  LapackFn<T>::syevd( &jobz, &uplo, &in, a, &in, w, &wq, &lwork, &rwq, &lrwork, &iwq, &liwork, &info);
+	else
+	  LapackFn<T>::sygvd( &iType, &jobz, &uplo, &in, a, &in, b, &in, w, &wq, &lwork, &rwq, &lrwork, &iwq, &liwork, &info);
+      }
+    else if( b == NULL)
+      {
+	isuppz.resize( 2 * n);
+	LapackFn<T>::syevr( &jobz, &rng, &uplo, &in, a, &in, &rVl, &rVu, &iIl, &iIu, &rTol, &m, w,
+			    zz, &ldz, &isuppz[0], &wq, &lwork, &rwq, &lrwork, &iwq, &liwork, &info);
+      }
+    else
+      {
+	// ?sygvx: fixed iwork (5n) and rwork (7n), set after the query
+	ifail.resize( n);
+	LapackFn<T>::sygvx( &iType, &jobz, &rng, &uplo, &in, a, &in, b, &in, &rVl, &rVu, &iIl, &iIu, &rTol,
+			    &m, w, zz, &ldz, &wq, &lwork, &rwq, &iwq, &ifail[0], &info);
+      }
+    if( info < 0) return -1;
+    if( !divConquer && b != NULL)
+      {
+	rwq = 7 * n;
+	iwq = 5 * n;
+      }
+
+    lwork = WorkSize( wq);
+    lrwork = LapackFn<T>::isComplex ? WorkSize( static_cast<double>( rwq)) : 1;
+    liwork = std::max( iwq, 1);
+    std::vector<T> work( lwork);
+    std::vector<Real> rwork( lrwork);
+    std::vector<int> iwork( liwork);
+    if( divConquer)
+      {
+	if( b == NULL)
+	  LapackFn<T>::syevd( &jobz, &uplo, &in, a, &in, w, &work[0], &lwork, &rwork[0], &lrwork,
+			      &iwork[0], &liwork, &info);
+	else
+	  LapackFn<T>::sygvd( &iType, &jobz, &uplo, &in, a, &in, b, &in, w, &work[0], &lwork, &rwork[0], &lrwork,
+			      &iwork[0], &liwork, &info);
+	m = n;
+	// eigenvectors were returned in a
+	if( info == 0 && z != NULL) std::copy( a, a + n * n, z);
+      }
+    else if( b == NULL)
+      LapackFn<T>::syevr( &jobz, &rng, &uplo, &in, a, &in, &rVl, &rVu, &iIl, &iIu, &rTol, &m, w,
+			  zz, &ldz, &isuppz[0], &work[0], &lwork, &rwork[0], &lrwork, &iwork[0], &liwork, &info);
+    else
+      LapackFn<T>::sygvx( &iType, &jobz, &rng, &uplo, &in, a, &in, b, &in, &rVl, &rVu, &iIl, &iIu, &rTol,
+			  &m, w, zz, &ldz, &work[0], &lwork, &rwork[0], &iwork[0], &ifail[0], &info);
+    if( info < 0) return -1;
+    nFound = (info == 0) ? m : 0;
+    return info;
+  }
+
+  template<typename T>
+  int LapackSVDT( SizeT m, SizeT n, T* a, bool divConquer,
+		  typename LapackFn<T>::Real* s, T* u, T* vt)
+  {
+    typedef typename LapackFn<T>::Real Real;
+    if( !useBLASBackend || m > static_cast<SizeT>( INT_MAX / n)) return -1;
+    const SizeT k = std::min( m, n);
+    const SizeT mx = std::max( m, n);
+    BlasSetThreads( m * n * k);
+
+    const char job = 'S';
+    const int im = m, in = n, ik = k;
+    int info = 0;
+    // rwork is only used by the complex routines
+    std::vector<Real> rwork;
+    if( LapackFn<T>::isComplex)
+      rwork.resize( divConquer ? std::max( 5 * k * k + 5 * k, 2 * mx * k + 2 * k * k + k) : 5 * k);
+    else
+      rwork.resize( 1);
+    std::vector<int> iwork( divConquer ? 8 * k : 1);
+
+    T wq = 0;
+    int lwork = -1;
+    if( divConquer)
+      LapackFn<T>::gesdd( &job, &im, &in, a, &im, s, u, &im, vt, &ik, &wq, &lwork, &rwork[0], &iwork[0], &info);
+    else
+      LapackFn<T>::gesvd( &job, &job, &im, &in, a, &im, s, u, &im, vt, &ik, &wq, &lwork, &rwork[0], &info);
+    if( info < 0) return -1;
+
+    lwork = WorkSize( wq);
+    std::vector<T> work( lwork);
+    if( divConquer)
+      LapackFn<T>::gesdd( &job, &im, &in, a, &im, s, u, &im, vt, &ik, &work[0], &lwork, &rwork[0], &iwork[0], &info);
+    else
+      LapackFn<T>::gesvd( &job, &job, &im, &in, a, &im, s, u, &im, vt, &ik, &work[0], &lwork, &rwork[0], &info);
+    if( info < 0) return -1;
+    return info;
+  }
+
+} // namespace
+
+bool BlasCompiled() { return true;}
+
+bool BlasGemmUsable( SizeT m, SizeT n, SizeT k)
+{
+  if( !useBLASBackend) return false;
+  // Fortran integers: every dimension (and the leading ones) must fit
+  return m > 0 && n > 0 && k > 0 &&
+    m <= static_cast<SizeT>( INT_MAX) && n <= static_cast<SizeT>( INT_MAX) && k <= static_cast<SizeT>( INT_MAX);
+}
+
+template<> void BlasGemm<DFloat>( bool at, bool bt, SizeT m, SizeT n, SizeT k,
+  const DFloat* a, SizeT lda, const DFloat* b, SizeT ldb, DFloat* c)
+{ BlasGemmT( at, bt, m, n, k, a, lda, b, ldb, c);}
+template<> void BlasGemm<DDouble>( bool at, bool bt, SizeT m, SizeT n, SizeT k,
+  const DDouble* a, SizeT lda, const DDouble* b, SizeT ldb, DDouble* c)
+{ BlasGemmT( at, bt, m, n, k, a, lda, b, ldb, c);}
+template<> void BlasGemm<DComplex>( bool at, bool bt, SizeT m, SizeT n, SizeT k,
+  const DComplex* a, SizeT lda, const DComplex* b, SizeT ldb, DComplex* c)
+{ BlasGemmT( at, bt, m, n, k, a, lda, b, ldb, c);}
+template<> void BlasGemm<DComplexDbl>( bool at, bool bt, SizeT m, SizeT n, SizeT k,
+  const DComplexDbl* a, SizeT lda, const DComplexDbl* b, SizeT ldb, DComplexDbl* c)
+{ BlasGemmT( at, bt, m, n, k, a, lda, b, ldb, c);}
+
+template<> int LapackInvert<DFloat>( SizeT n, DFloat* a, double& lnDet)
+{ return LapackInvertT( n, a, lnDet);}
+template<> int LapackInvert<DDouble>( SizeT n, DDouble* a, double& lnDet)
+{ return LapackInvertT( n, a, lnDet);}
+template<> int LapackInvert<DComplex>( SizeT n, DComplex* a, double& lnDet)
+{ return LapackInvertT( n, a, lnDet);}
+template<> int LapackInvert<DComplexDbl>( SizeT n, DComplexDbl* a, double& lnDet)
+{ return LapackInvertT( n, a, lnDet);}
+
+template<> int LapackSymEigen<DFloat>( SizeT n, DFloat* a, DFloat* b, int itype, bool divConquer,
+  int range, SizeT il, SizeT iu, double vl, double vu, double abstol, DFloat* w, DFloat* z, SizeT& nFound)
+{ return LapackSymEigenT( n, a, b, itype, divConquer, range, il, iu, vl, vu, abstol, w, z, nFound);}
+template<> int LapackSymEigen<DDouble>( SizeT n, DDouble* a, DDouble* b, int itype, bool divConquer,
+  int range, SizeT il, SizeT iu, double vl, double vu, double abstol, DDouble* w, DDouble* z, SizeT& nFound)
+{ return LapackSymEigenT( n, a, b, itype, divConquer, range, il, iu, vl, vu, abstol, w, z, nFound);}
+template<> int LapackSymEigen<DComplex>( SizeT n, DComplex* a, DComplex* b, int itype, bool divConquer,
+  int range, SizeT il, SizeT iu, double vl, double vu, double abstol, DFloat* w, DComplex* z, SizeT& nFound)
+{ return LapackSymEigenT( n, a, b, itype, divConquer, range, il, iu, vl, vu, abstol, w, z, nFound);}
+template<> int LapackSymEigen<DComplexDbl>( SizeT n, DComplexDbl* a, DComplexDbl* b, int itype, bool divConquer,
+  int range, SizeT il, SizeT iu, double vl, double vu, double abstol, DDouble* w, DComplexDbl* z, SizeT& nFound)
+{ return LapackSymEigenT( n, a, b, itype, divConquer, range, il, iu, vl, vu, abstol, w, z, nFound);}
+
+template<> int LapackSVD<DFloat>( SizeT m, SizeT n, DFloat* a, bool divConquer, DFloat* s, DFloat* u, DFloat* vt)
+{ return LapackSVDT( m, n, a, divConquer, s, u, vt);}
+template<> int LapackSVD<DDouble>( SizeT m, SizeT n, DDouble* a, bool divConquer, DDouble* s, DDouble* u, DDouble* vt)
+{ return LapackSVDT( m, n, a, divConquer, s, u, vt);}
+template<> int LapackSVD<DComplex>( SizeT m, SizeT n, DComplex* a, bool divConquer, DFloat* s, DComplex* u, DComplex* vt)
+{ return LapackSVDT( m, n, a, divConquer, s, u, vt);}
+template<> int LapackSVD<DComplexDbl>( SizeT m, SizeT n, DComplexDbl* a, bool divConquer, DDouble* s, DComplexDbl* u, DComplexDbl* vt)
+{ return LapackSVDT( m, n, a, divConquer, s, u, vt);}
+
+#else // USE_BLAS
+
+bool BlasCompiled() { return false;}
+bool BlasGemmUsable( SizeT m, SizeT n, SizeT k) { return false;}
+
+#endif // USE_BLAS
@@ -0,0 +1,121 @@
+/***************************************************************************
+                          blas_backend.hpp  -  optional BLAS/LAPACK backend
+                             -------------------
+    begin                : Oct 2026
+    copyright            : (C) 2026 by the GDL team
+    email                :
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+// When GDL is configured with -DBLAS=ON, matrix products (#, ##,
+// MATRIX_MULTIPLY), INVERT, LA_EIGENQL, EIGENQL and LA_SVD are handed to the
+// BLAS/LAPACK found at build time (OpenBLAS, BLIS, MKL, reference...) through the Fortran interface,
+// so no cblas/lapacke header is needed.
+// The backend is used only while 'useBLASBackend' is true: it is set at
+// startup (--no-blas, GDL_NO_BLAS), reported in !GDL.GDL_USE_BLAS and can be
+// changed at any time with CPU, BLAS=0|1.
+// The library's own threads replace GDL's OpenMP loops for these calls;
+// their number follows !CPU.TPOOL_NTHREADS/TPOOL_MIN_ELTS/TPOOL_MAX_ELTS and
+// drops to one when called from inside a GDL parallel region.
+
+#ifndef BLAS_BACKEND_HPP_
+#define BLAS_BACKEND_HPP_
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "typedefs.hpp"
+
+// types handled by the ?gemm / ?getrf / ?getri routines,
+// Real is the type of eigenvalues and singular values
+template<typename T> struct BlasType { static const bool value = false; typedef T Real;};
+template<> struct BlasType<DFloat> { static const bool value = true; typedef DFloat Real;};
+template<> struct BlasType<DDouble> { static const bool value = true; typedef DDouble Real;};
+template<> struct BlasType<DComplex> { static const bool value = true; typedef DFloat Real;};
+template<> struct BlasType<DComplexDbl> { static const bool value = true; typedef DDouble Real;};
+
+// true if GDL was compiled with an external BLAS/LAPACK
+bool BlasCompiled();
+
+// true if a (m x k) * (k x n) product may be sent to the backend now:
+// compiled in, enabled, sizes representable by the Fortran integer.
+bool BlasGemmUsable( SizeT m, SizeT n, SizeT k);
+
+// c(m,n) = op(a) * op(b), all column-major (GDL layout),
+// op(a) is (m x k), op(b) is (k x n); 'at'/'bt' select the transposes.
+// lda/ldb are the leading dimensions of a and b as stored.
+// Only the BlasType<> types are implemented, call after BlasGemmUsable().
+template<typename T>
+inline void BlasGemm( bool at, bool bt, SizeT m, SizeT n, SizeT k,
+		      const T* a, SizeT lda, const T* b, SizeT ldb, T* c) {}
+
+// in-place inversion of the (n x n) matrix a via LU (?getrf + ?getri).
+// returns 0 on success, 1 if a is exactly singular (a is then zeroed),
+// -1 if the backend cannot be used. 'lnDet' receives ln|det(a)|.
+template<typename T>
+inline int LapackInvert( SizeT n, T* a, double& lnDet) { return -1;}
+
+// eigenvalues (ascending) and optionally eigenvectors of the symmetric or
+// Hermitian (n x n) column-major matrix a (lower triangle used, destroyed).
+// b != NULL: generalized problem of type itype (1: A x = l B x,
+// 2: A B x = l x, 3: B A x = l x), b positive definite, destroyed.
+// divConquer selects ?syevd/?sygvd (whole spectrum only), otherwise
+// ?syevr/?sygvx compute the subset only: range 0: all, 1: indices il..iu
+// (0-based), 2: eigenvalues in (vl,vu]. abstol: 0 for LAPACK's default.
+// w (n) receives the nFound eigenvalues, z (n x n, or NULL for values only)
+// the corresponding eigenvectors as columns.
+// returns LAPACK's info (> 0: no convergence or b not positive definite),
+// -1 if the backend cannot be used.
+template<typename T>
+inline int LapackSymEigen( SizeT n, T* a, T* b, int itype, bool divConquer,
+			   int range, SizeT il, SizeT iu, double vl, double vu, double abstol,
+			   typename BlasType<T>::Real* w, T* z, SizeT& nFound) { return -1;}
+
+// thin SVD a = u * diag(s) * vt of the column-major (m x n) matrix a
+// (destroyed), k = min(m,n): s (k) descending, u (m x k), vt (k x n) = V^H.
+// divConquer selects ?gesdd, otherwise ?gesvd.
+// returns LAPACK's info (> 0: no convergence), -1 if the backend cannot be used.
+template<typename T>
+inline int LapackSVD( SizeT m, SizeT n, T* a, bool divConquer,
+		      typename BlasType<T>::Real* s, T* u, T* vt) { return -1;}
+
+#ifdef USE_BLAS
+template<> void BlasGemm<DFloat>( bool at, bool bt, SizeT m, SizeT n, SizeT k,
+  const DFloat* a, SizeT lda, const DFloat* b, SizeT ldb, DFloat* c);
+template<> void BlasGemm<DDouble>( bool at, bool bt, SizeT m, SizeT n, SizeT k,
+  const DDouble* a, SizeT lda, const DDouble* b, SizeT ldb, DDouble* c);
+template<> void BlasGemm<DComplex>( bool at, bool bt, SizeT m, SizeT n, SizeT k,
+  const DComplex* a, SizeT lda, const DComplex* b, SizeT ldb, DComplex* c);
+template<> void BlasGemm<DComplexDbl>( bool at, bool bt, SizeT m, SizeT n, SizeT k,
+  const DComplexDbl* a, SizeT lda, const DComplexDbl* b, SizeT ldb, DComplexDbl* c);
+
+template<> int LapackInvert<DFloat>( SizeT n, DFloat* a, double& lnDet);
+template<> int LapackInvert<DDouble>( SizeT n, DDouble* a, double& lnDet);
+template<> int LapackInvert<DComplex>( SizeT n, DComplex* a, double& lnDet);
+template<> int LapackInvert<DComplexDbl>( SizeT n, DComplexDbl* a, double& lnDet);
+
+template<> int LapackSymEigen<DFloat>( SizeT n, DFloat* a, DFloat* b, int itype, bool divConquer,
+  int range, SizeT il, SizeT iu, double vl, double vu, double abstol, DFloat* w, DFloat* z, SizeT& nFound);
+template<> int LapackSymEigen<DDouble>( SizeT n, DDouble* a, DDouble* b, int itype, bool divConquer,
+  int range, SizeT il, SizeT iu, double vl, double vu, double abstol, DDouble* w, DDouble* z, SizeT& nFound);
+template<> int LapackSymEigen<DComplex>( SizeT n, DComplex* a, DComplex* b, int itype, bool divConquer,
+  int range, SizeT il, SizeT iu, double vl, double vu, double abstol, DFloat* w, DComplex* z, SizeT& nFound);
+template<> int LapackSymEigen<DComplexDbl>( SizeT n, DComplexDbl* a, DComplexDbl* b, int itype, bool divConquer,
+  int range, SizeT il, SizeT iu, double vl, double vu, double abstol, DDouble* w, DComplexDbl* z, SizeT& nFound);
+
+template<> int LapackSVD<DFloat>( SizeT m, SizeT n, DFloat* a, bool divConquer, DFloat* s, DFloat* u, DFloat* vt);
+template<> int LapackSVD<DDouble>( SizeT m, SizeT n, DDouble* a, bool divConquer, DDouble* s, DDouble* u, DDouble* vt);
+template<> int LapackSVD<DComplex>( SizeT m, SizeT n, DComplex* a, bool divConquer, DFloat* s, DComplex* u, DComplex* vt);
+template<> int LapackSVD<DComplexDbl>( SizeT m, SizeT n, DComplexDbl* a, bool divConquer, DDouble* s, DComplexDbl* u, DComplexDbl* vt);
+#endif
+
+#endif
@@ -24,6 +24,7 @@
 //#include "datatypes.hpp"
 #include "dstructgdl.hpp"
 #include "real2int.hpp"
+#include "simd_dispatch.hpp"
 #include "ofmt.hpp" // OutAuto
 
 #include "dinterpreter.hpp"
@@ -33,9 +34,11 @@ using namespace std;
 //#define TRACE_CONVERT2 cout << "Convert2 " << this->TypeStr() << " -> " << destTy << "\tn " << dd.size() << "\tmode " << mode << endl;
 #define TRACE_CONVERT2
 
+// the pairs with SIMD kernels (see simd_dispatch.hpp) return after SimdConvert()
 #define DO_CONVERT_START(tnew)  {bool dopar=(CpuTPOOL_NTHREADS >1 && nEl >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= nEl));\
         Data_<tnew>* dest=new Data_<tnew>( dim, BaseGDL::NOZERO);\
         if( nEl == 1) { (*dest)[0]=(*this)[0]; if( (mode & BaseGDL::CONVERT) != 0) delete this; return dest;}\
+        if( SimdConvert( &(*dest)[0], &(*this)[0], nEl)) { if( (mode & BaseGDL::CONVERT) != 0) delete this; return dest;}\
         if(!dopar) {for( SizeT i=0; i < nEl; ++i) (*dest)[i]=(*this)[i]; if( (mode & BaseGDL::CONVERT) != 0) delete this; return dest; }
 
 #define DO_CONVERT_START_CPX(tnew)  {bool dopar=(CpuTPOOL_NTHREADS >1 && nEl >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= nEl));\
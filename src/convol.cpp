@@ -21,6 +21,7 @@
 #include "nullgdl.hpp"
 #include "dstructgdl.hpp"
 #include "dinterpreter.hpp"
+#include "convol.hpp"
 
 template<typename T>
 inline bool gdlValid( const T &value )
@@ -148,6 +149,29 @@ namespace lib {
       e->Throw( "Expression must be an array in this context: "+
 		e->GetParString(1));
     
+    // SEPARABLE with a 1-D kernel: the same kernel along every dimension of the array
+    static int separableIx = e->KeywordIx("SEPARABLE");
+    Guard<BaseGDL> p1OuterGuard;
+    if (p1->Rank() == 1 && p0->Rank() > 1 && e->KeywordSet(separableIx)) {
+      for (long r = 0; r < p0->Rank(); ++r)
+        if (p0->Dim(r) < p1->Dim(0))
+          e->Throw("Incompatible dimensions for Array and Kernel.");
+      // expanded in the type the kernel gets below (for BYTE, INT and UINT arrays LONG,
+      // for FLOAT and COMPLEX the double precision types), the taps of a BYTE or INT kernel
+      // would overflow in their own type
+      DType kType = p0->Type();
+      if (kType == GDL_BYTE || kType == GDL_INT || kType == GDL_UINT) kType = GDL_LONG;
+      else if (kType == GDL_FLOAT) kType = GDL_DOUBLE;
+      else if (kType == GDL_COMPLEX) kType = GDL_COMPLEXDBL;
+      Guard<BaseGDL> k1Guard;
+      if (p1->Type() != kType) {
+        p1 = p1->Convert2(kType, BaseGDL::COPY);
+        k1Guard.Reset(p1);
+      }
+      p1 = convol_outer_kernel(p1, p0->Rank());
+      p1OuterGuard.Reset(p1);
+    }
+
     if( p0->N_Elements() < p1->N_Elements())
       e->Throw( "Incompatible dimensions for Array and Kernel.");
 
@@ -368,6 +392,33 @@ namespace lib {
       memcpy((*missing).DataAddr(), &tmp, sizeof(tmp));
     }
     BaseGDL* result;
+    /***********************************Parameter FFT****************************************/
+    // GDL extension: FFT=1 forces the FFT (overlap-save) method, FFT=0 the direct one.
+    // By default the cheapest according to convol_fft_preferred(). FLOAT and DOUBLE only.
+    static int fftIx = e->KeywordIx("FFT");
+    if (p0->Type() == GDL_DOUBLE) {
+      bool useFFT;
+      if (e->KeywordPresent(fftIx)) useFFT = e->KeywordSet(fftIx);
+      else useFFT = convol_fft_preferred(p0->Dim(), p1->Dim(), doNan, doInvalid, normalize, edgeMode);
+      result = NULL;
+      // separable kernels: successive 1D passes, unless the method is forced by FFT= or SEPARABLE=0
+      bool trySeparable = !e->KeywordPresent(fftIx) && !(e->KeywordPresent(separableIx) && !e->KeywordSet(separableIx));
+      if (trySeparable) result = convol_separable(static_cast<DDoubleGDL*>(p0), static_cast<DDoubleGDL*>(p1),
+          (*static_cast<DDoubleGDL*>(scale))[0], (*static_cast<DDoubleGDL*>(bias))[0],
+          center, normalize, edgeMode, doNan, (*static_cast<DDoubleGDL*>(missing))[0],
+          (*static_cast<DDoubleGDL*>(invalid))[0], doInvalid);
+      if (useFFT && result == NULL) result = convol_fft(static_cast<DDoubleGDL*>(p0), static_cast<DDoubleGDL*>(p1),
+          (*static_cast<DDoubleGDL*>(scale))[0], (*static_cast<DDoubleGDL*>(bias))[0],
+          center, normalize, edgeMode, doNan, (*static_cast<DDoubleGDL*>(missing))[0],
+          (*static_cast<DDoubleGDL*>(invalid))[0], doInvalid);
+      if (result != NULL) {
+        if (deprecise) {
+          Guard<BaseGDL> resultGuard(result);
+          return result->Convert2(GDL_FLOAT, BaseGDL::COPY);
+        }
+        return result;
+      }
+    }
     //handle transpositions
     if (doTranspose) {
       BaseGDL* input;
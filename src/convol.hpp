@@ -30,6 +30,22 @@ namespace lib {
 
   BaseGDL* convol_fun( EnvT* e);
 
+  // FFT (overlap-save) method for DOUBLE arrays, in convol_fft.cpp. convol_fft() returns NULL
+  // if the array holds NaN or Inf values without /NAN (use the direct method).
+  bool convol_fft_preferred(const dimension& aDim, const dimension& kDim, bool doNan, bool doInvalid, bool normalize, int edgeMode);
+  BaseGDL* convol_fft(DDoubleGDL* array, DDoubleGDL* kernel, DDouble scale, DDouble bias,
+    bool center, bool normalize, int edgeMode,
+    bool doNan, DDouble missing, DDouble invalid, bool doInvalid);
+
+  // separable kernels, in convol_separable.cpp. convol_separable() returns NULL if the kernel is
+  // not a product of 1D kernels, or if the array holds NaN, Inf or INVALID values (use another method).
+  // convol_outer_kernel() expands a 1D kernel k to k (x) k (x) ... of the given rank; k must
+  // have the type of the direct method (LONG, ULONG, LONG64, ULONG64, DOUBLE or DCOMPLEX).
+  BaseGDL* convol_separable(DDoubleGDL* array, DDoubleGDL* kernel, DDouble scale, DDouble bias,
+    bool center, bool normalize, int edgeMode,
+    bool doNan, DDouble missing, DDouble invalid, bool doInvalid);
+  BaseGDL* convol_outer_kernel(BaseGDL* kernel, int rank);
+
 } // namespace
 
 
@@ -0,0 +1,460 @@
+/***************************************************************************
+                          convol_fft.cpp  -  FFT (overlap-save) path of convol()
+                             -------------------
+    begin                : Oct 19 2026
+    copyright            : (C) 2026 by the GDL team
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+// Direct convolution (convol_inc*.cpp) costs nKel multiply-adds per element. For large
+// kernels on DOUBLE (and FLOAT, computed in DOUBLE) arrays, convol_fun() switches to the
+// overlap-save method implemented here: the result is cut into tiles of power-of-2 sizes,
+// each tile (plus the halo needed by the kernel, taken from the array according to the
+// EDGE_* mode) is multiplied by the transform of the kernel in Fourier space. Tiles are
+// independent and processed in parallel. FFTW is used if available, GSL otherwise.
+//
+// Semantics are those of convol_inc0.cpp (no edge keyword) and convol_inc1.cpp (EDGE_*):
+// invalid values (/NAN, INVALID=) and out-of-array values with EDGE_ZERO do not contribute,
+// neither to the sum, nor to the NORMALIZE scale, nor to the count of valid values (which
+// gives MISSING when zero). These are obtained by convolving the mask of valid values,
+// packed in the imaginary part of the transformed tile. Without mask, two tiles are
+// packed in one complex transform (the kernel is real).
+
+#include "includefirst.hpp"
+
+#include <complex>
+#include <cmath>
+#include <vector>
+
+#include "datatypes.hpp"
+#include "convol.hpp"
+
+#ifdef USE_FFTW
+#include "fftw3.h"
+#else
+#include <gsl/gsl_fft_complex.h>
+#endif
+
+namespace lib {
+
+  using namespace std;
+
+  // largest tile, in elements (16 bytes each, 3 buffers per thread)
+#define CONVOL_FFT_MAX_TILE (1<<20)
+  // cost of one FFT flop (5 N log2(N) per transform), in direct multiply-adds.
+  // Measured, errs on the side of the direct method.
+#define CONVOL_FFT_FLOP_RATIO 2.0
+  // never use the FFT method automatically for kernels smaller than that
+#define CONVOL_FFT_MIN_KERNEL 64
+
+  // Tile geometry. All arrays have 'rank' valid entries, dimension 0 varying fastest.
+  struct ConvolFFTGeometry {
+    int rank;
+    SizeT dim[MAXRANK]; // array
+    SizeT kd[MAXRANK];  // kernel, padded with 1
+    SizeT T[MAXRANK];   // tile (transform) size, power of 2
+    SizeT B[MAXRANK];   // valid output per tile: T-kd+1
+    SizeT nt[MAXRANK];  // number of tiles
+    SizeT tVol, nTiles, nA, nKel;
+
+    ConvolFFTGeometry(const dimension& aDim, const dimension& kDim) {
+      rank = aDim.Rank();
+      nA = 1;
+      nKel = 1;
+      for (int d = 0; d < rank; ++d) {
+        dim[d] = aDim[d];
+        kd[d] = (d < kDim.Rank() && kDim[d] > 0) ? kDim[d] : 1;
+        nA *= dim[d];
+        nKel *= kd[d];
+      }
+      // per dimension, the tile minimizing (T/B)*log2(T), i.e. the transform work per
+      // valid output, without exceeding what is needed to cover the whole dimension.
+      for (int d = 0; d < rank; ++d) {
+        SizeT tMax = 1;
+        while (tMax < dim[d] + kd[d] - 1) tMax <<= 1;
+        SizeT best = tMax;
+        double bestCost = 1e300;
+        for (SizeT t = 1; t <= tMax; t <<= 1) {
+          if (t < kd[d]) continue;
+          double cost = (double) t / (t - kd[d] + 1) * (1.0 + log2((double) t));
+          if (cost < bestCost) {
+            bestCost = cost;
+            best = t;
+          }
+        }
+        T[d] = best;
+      }
+      // shrink the largest tile dimensions while the tile is too big
+      for (;;) {
+        tVol = 1;
+        for (int d = 0; d < rank; ++d) tVol *= T[d];
+        if (tVol <= CONVOL_FFT_MAX_TILE) break;
+        int dMax = -1;
+        for (int d = 0; d < rank; ++d) if (T[d] / 2 >= 2 * kd[d] && (dMax < 0 || T[d] > T[dMax])) dMax = d;
+        if (dMax < 0) break;
+        T[dMax] /= 2;
+      }
+      nTiles = 1;
+      for (int d = 0; d < rank; ++d) {
+        B[d] = T[d] - kd[d] + 1;
+        nt[d] = (dim[d] + B[d] - 1) / B[d];
+        nTiles *= nt[d];
+      }
+    }
+
+    // approximate work, in units of a direct multiply-add
+    double DirectCost() const {
+      return (double) nA * nKel;
+    }
+
+    double FFTCost(int nTransformsPerTile) const {
+      return (double) nTiles * nTransformsPerTile * 5.0 * tVol * log2((double) tVol) * CONVOL_FFT_FLOP_RATIO;
+    }
+  };
+
+  // In-place N-dimensional complex transforms of a tile (unnormalized)
+  class ConvolFFTPlan {
+    int rank;
+    SizeT T[MAXRANK];
+    SizeT tVol;
+#ifdef USE_FFTW
+    fftw_plan forward, backward;
+#endif
+  public:
+
+    ConvolFFTPlan(const ConvolFFTGeometry& g) : rank(g.rank), tVol(g.tVol) {
+      for (int d = 0; d < rank; ++d) T[d] = g.T[d];
+#ifdef USE_FFTW
+      int n[MAXRANK];
+      for (int d = 0; d < rank; ++d) n[d] = (int) T[rank - 1 - d];
+      DComplexDbl* buf = Alloc();
+      forward = fftw_plan_dft(rank, n, (fftw_complex*) buf, (fftw_complex*) buf, FFTW_FORWARD, FFTW_ESTIMATE);
+      backward = fftw_plan_dft(rank, n, (fftw_complex*) buf, (fftw_complex*) buf, FFTW_BACKWARD, FFTW_ESTIMATE);
+      Free(buf);
+#endif
+    }
+
+    ~ConvolFFTPlan() {
+#ifdef USE_FFTW
+      fftw_destroy_plan(forward);
+      fftw_destroy_plan(backward);
+#endif
+    }
+
+    DComplexDbl* Alloc() const {
+#ifdef USE_FFTW
+      DComplexDbl* p = (DComplexDbl*) fftw_malloc(tVol * sizeof (DComplexDbl));
+#else
+      DComplexDbl* p = (DComplexDbl*) malloc(tVol * sizeof (DComplexDbl));
+#endif
+      if (p == NULL) throw GDLException("CONVOL: cannot allocate FFT buffers.");
+      return p;
+    }
+
+    void Free(DComplexDbl* p) const {
+#ifdef USE_FFTW
+      fftw_free(p);
+#else
+      free(p);
+#endif
+    }
+
+    void Forward(DComplexDbl* buf) const {
+#ifdef USE_FFTW
+      fftw_execute_dft(forward, (fftw_complex*) buf, (fftw_complex*) buf);
+#else
+      Transform(buf, true);
+#endif
+    }
+
+    void Backward(DComplexDbl* buf) const {
+#ifdef USE_FFTW
+      fftw_execute_dft(backward, (fftw_complex*) buf, (fftw_complex*) buf);
+#else
+      Transform(buf, false);
+#endif
+    }
+
+  private:
+#ifndef USE_FFTW
+    // 1D radix-2 transforms along each dimension in turn
+    void Transform(DComplexDbl* buf, bool direct) const {
+      SizeT stride = 1;
+      for (int d = 0; d < rank; ++d) {
+        SizeT n = T[d];
+        if (n > 1) {
+          for (SizeT outer = 0; outer < tVol; outer += n * stride) {
+            for (SizeT inner = 0; inner < stride; ++inner) {
+              double* line = (double*) &buf[outer + inner];
+              if (direct) gsl_fft_complex_radix2_forward(line, stride, n);
+              else gsl_fft_complex_radix2_backward(line, stride, n);
+            }
+          }
+        }
+        stride *= n;
+      }
+    }
+#endif
+  };
+
+  bool convol_fft_preferred(const dimension& aDim, const dimension& kDim, bool doNan, bool doInvalid, bool normalize, int edgeMode) {
+    ConvolFFTGeometry g(aDim, kDim);
+    if (g.nKel < CONVOL_FFT_MIN_KERNEL) return false;
+    // the mask is needed as soon as values may be skipped
+    bool withMask = (doNan || doInvalid || edgeMode == 3);
+    int nTransforms = withMask ? 2 + (normalize ? 1 : 0) + ((doNan || doInvalid) ? 1 : 0) : 1; // 2 per pair of tiles without mask
+    return g.FFTCost(nTransforms) < g.DirectCost();
+  }
+
+  // Index along dimension d of the array element used at position 'pos' (may be out of the
+  // array), following convol_inc1.cpp. -1 if the element is outside the array with EDGE_ZERO.
+  // With no edge mode, points needing an outside element are not computed: anything in the
+  // array will do.
+  static inline long ConvolFFTEdgeIndex(long pos, long n, int edgeMode) {
+    if (pos >= 0 && pos < n) return pos;
+    switch (edgeMode) {
+    case 1: // wrap
+      pos %= n;
+      return (pos < 0) ? pos + n : pos;
+    case 3: // zero
+      return -1;
+    case 4: // mirror
+      pos = (pos < 0) ? -pos : 2 * n - pos - 1;
+      break;
+    default: // none or truncate
+      break;
+    }
+    return (pos < 0) ? 0 : ((pos >= n) ? n - 1 : pos);
+  }
+
+  BaseGDL* convol_fft(DDoubleGDL* array, DDoubleGDL* kernel, DDouble scale, DDouble bias,
+    bool center, bool normalize, int edgeMode,
+    bool doNan, DDouble missing, DDouble invalid, bool doInvalid) {
+    ConvolFFTGeometry g(array->Dim(), kernel->Dim());
+    const int rank = g.rank;
+    const DDouble* a = &(*array)[0];
+    const DDouble* k = &(*kernel)[0];
+    const SizeT nA = g.nA;
+
+    // as in Convol(), only bother with invalid values if there are some. Without /NAN, a NaN
+    // or Inf would spread over its whole tile: leave these arrays to the direct method.
+    bool nonFinite = false, found = false;
+#pragma omp parallel for reduction(||:nonFinite,found) if (nA >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= nA))
+    for (OMPInt i = 0; i < nA; ++i) {
+      if (!std::isfinite(a[i])) {
+        if (doNan || (doInvalid && a[i] == invalid)) found = true;
+        else nonFinite = true;
+      } else if (doInvalid && a[i] == invalid) found = true;
+    }
+    if (nonFinite) return NULL;
+    if (!found) doNan = doInvalid = false;
+    const bool countValid = (doNan || doInvalid);
+    const bool withMask = (countValid || edgeMode == 3);
+
+    DDouble sumAbsK = 0;
+    for (SizeT i = 0; i < g.nKel; ++i) sumAbsK += fabs(k[i]);
+    if (normalize) {
+      scale = sumAbsK;
+      bias = 0;
+    } else if (scale == 0) scale = 1;
+    // results of masked transforms below that are only rounding errors
+    const DDouble epsScale = sumAbsK * 1e-10;
+
+    // kernel in tile coordinates: element m of tile dimension d multiplies tile input u+m for output
+    // u. lo[d] is the position in the array of tile input 0 relative to output 0.
+    long lo[MAXRANK];
+    long aBeg[MAXRANK], aEnd[MAXRANK];
+    SizeT kStride[MAXRANK + 1], tStride[MAXRANK + 1], aStride[MAXRANK + 1];
+    kStride[0] = tStride[0] = aStride[0] = 1;
+    for (int d = 0; d < rank; ++d) {
+      lo[d] = center ? -(long) (g.kd[d] / 2) : -(long) (g.kd[d] - 1);
+      aBeg[d] = center ? g.kd[d] / 2 : g.kd[d] - 1;
+      aEnd[d] = center ? g.dim[d] - (g.kd[d] - 1) / 2 : g.dim[d];
+      kStride[d + 1] = kStride[d] * g.kd[d];
+      tStride[d + 1] = tStride[d] * g.T[d];
+      aStride[d + 1] = aStride[d] * g.dim[d];
+    }
+
+    ConvolFFTPlan plan(g);
+    const SizeT tVol = g.tVol;
+    const DDouble norm = 1.0 / tVol;
+
+    // transforms of the kernel, of |kernel| and of ones (count of valid values), reversed
+    // so that the circular convolution gives a correlation, normalized.
+    vector<DComplexDbl*> kHat(3, (DComplexDbl*) NULL);
+    for (int iKer = 0; iKer < 3; ++iKer) {
+      if (iKer == 1 && !(withMask && normalize)) continue;
+      if (iKer == 2 && !countValid) continue;
+      DComplexDbl* h = plan.Alloc();
+      for (SizeT i = 0; i < tVol; ++i) h[i] = 0;
+      for (SizeT i = 0; i < g.nKel; ++i) {
+        SizeT hIx = 0;
+        SizeT kIx = 0;
+        for (int d = 0; d < rank; ++d) {
+          SizeT m = (i / kStride[d]) % g.kd[d];
+          SizeT src = center ? m : g.kd[d] - 1 - m;
+          kIx += src * kStride[d];
+          hIx += ((g.T[d] - m) % g.T[d]) * tStride[d];
+        }
+        DDouble v = (iKer == 0) ? k[kIx] : ((iKer == 1) ? fabs(k[kIx]) : 1.0);
+        h[hIx] = v * norm;
+      }
+      plan.Forward(h);
+      kHat[iKer] = h;
+    }
+
+    // without mask, tiles go by pairs (real and imaginary parts)
+    const SizeT perItem = withMask ? 1 : 2;
+    const SizeT nItems = (g.nTiles + perItem - 1) / perItem;
+    const int nThreads = (CpuTPOOL_NTHREADS > 1 && nItems > 1) ? CpuTPOOL_NTHREADS : 1;
+
+    // the work buffers of each thread, allocated here as plan.Alloc() may throw
+    // (an exception must not leave the parallel region)
+    vector<DComplexDbl*> work(2 * nThreads, (DComplexDbl*) NULL);
+    try {
+      for (SizeT i = 0; i < work.size(); ++i) work[i] = plan.Alloc();
+    } catch (...) {
+      for (SizeT i = 0; i < work.size(); ++i) if (work[i] != NULL) plan.Free(work[i]);
+      for (int iKer = 0; iKer < 3; ++iKer) if (kHat[iKer] != NULL) plan.Free(kHat[iKer]);
+      throw;
+    }
+
+    DDoubleGDL* res = new DDoubleGDL(array->Dim(), BaseGDL::NOZERO);
+    DDouble* r = &(*res)[0];
+
+#pragma omp parallel num_threads(nThreads)
+    {
+#ifdef _OPENMP
+      const int thread = omp_get_thread_num();
+#else
+      const int thread = 0;
+#endif
+      DComplexDbl* z = work[2 * thread];
+      DComplexDbl* w = work[2 * thread + 1];
+      vector<DDouble> sum(perItem * tVol), scl(withMask && normalize ? tVol : 0), cnt(countValid ? tVol : 0);
+      // per dimension, offset in the array of each tile input position (-1: outside, EDGE_ZERO)
+      vector<long> srcMap[MAXRANK];
+      for (int d = 0; d < rank; ++d) srcMap[d].resize(g.T[d]);
+      long X0[2][MAXRANK];
+      SizeT idx[MAXRANK + 1];
+      const SizeT T0 = g.T[0];
+      const SizeT nRows = tVol / T0;
+
+#pragma omp for schedule(dynamic)
+      for (OMPInt item = 0; item < nItems; ++item) {
+        SizeT nHere = 0;
+        for (SizeT p = 0; p < perItem; ++p) {
+          SizeT tile = item * perItem + p;
+          if (tile >= g.nTiles) break;
+          ++nHere;
+          SizeT t = tile;
+          for (int d = 0; d < rank; ++d) {
+            X0[p][d] = (t % g.nt[d]) * g.B[d];
+            t /= g.nt[d];
+            for (SizeT uD = 0; uD < g.T[d]; ++uD) {
+              long e = ConvolFFTEdgeIndex(X0[p][d] + lo[d] + (long) uD, g.dim[d], edgeMode);
+              srcMap[d][uD] = (e < 0) ? -1 : e * (long) aStride[d];
+            }
+          }
+          // gather the tile input, row by row
+          for (int d = 0; d <= rank; ++d) idx[d] = 0;
+          for (SizeT row = 0; row < nRows; ++row) {
+            long base = 0;
+            bool in = true;
+            for (int d = 1; d < rank; ++d) {
+              long off = srcMap[d][idx[d]];
+              if (off < 0) in = false;
+              base += off;
+            }
+            DComplexDbl* zRow = &z[row * T0];
+            for (SizeT u0 = 0; u0 < T0; ++u0) {
+              DDouble v = 0, valid = 0;
+              long off = srcMap[0][u0];
+              if (in && off >= 0) {
+                v = a[base + off];
+                valid = 1;
+                if ((doNan && !std::isfinite(v)) || (doInvalid && v == invalid)) {
+                  v = 0;
+                  valid = 0;
+                }
+              }
+              if (p == 0) zRow[u0] = DComplexDbl(v, withMask ? valid : 0);
+              else zRow[u0] = DComplexDbl(zRow[u0].real(), v);
+            }
+            for (int d = 1; d < rank; ++d) {
+              if (++idx[d] < g.T[d]) break;
+              idx[d] = 0;
+            }
+          }
+        }
+        if (nHere == 0) continue;
+        plan.Forward(z);
+
+        for (int iKer = 0; iKer < 3; ++iKer) {
+          if (kHat[iKer] == NULL) continue;
+          const DComplexDbl* h = kHat[iKer];
+          for (SizeT u = 0; u < tVol; ++u) w[u] = z[u] * h[u];
+          plan.Backward(w);
+          if (iKer == 0) {
+            for (SizeT u = 0; u < tVol; ++u) sum[u] = w[u].real();
+            if (!withMask) for (SizeT u = 0; u < tVol; ++u) sum[tVol + u] = w[u].imag();
+          } else if (iKer == 1) {
+            for (SizeT u = 0; u < tVol; ++u) scl[u] = w[u].imag();
+          } else {
+            for (SizeT u = 0; u < tVol; ++u) cnt[u] = w[u].imag();
+          }
+        }
+
+        // scatter the valid part of the tile(s)
+        for (SizeT p = 0; p < nHere; ++p) {
+          const DDouble* s = &sum[p * tVol];
+          SizeT n0 = min(g.B[0], g.dim[0] - X0[p][0]);
+          for (int d = 0; d <= rank; ++d) idx[d] = 0;
+          for (SizeT row = 0; row < nRows; ++row) {
+            long base = 0;
+            bool out = true, regular = true;
+            for (int d = 1; d < rank; ++d) {
+              long x = X0[p][d] + (long) idx[d];
+              if (idx[d] >= g.B[d] || x >= (long) g.dim[d]) out = false;
+              if (x < aBeg[d] || x >= aEnd[d]) regular = false;
+              base += x * (long) aStride[d];
+            }
+            if (out) {
+              SizeT u = row * T0;
+              for (SizeT u0 = 0; u0 < n0; ++u0, ++u) {
+                long x = X0[p][0] + (long) u0;
+                DDouble v;
+                if (edgeMode == 0 && (!regular || x < aBeg[0] || x >= aEnd[0])) {
+                  v = 0;
+                } else {
+                  DDouble curScale = scale;
+                  if (withMask && normalize) curScale = (scl[u] > epsScale) ? scl[u] : 0;
+                  v = (curScale == 0) ? missing : s[u] / curScale;
+                  v += bias;
+                  if (countValid && cnt[u] < 0.5) v = missing;
+                }
+                r[base + x] = v;
+              }
+            }
+            for (int d = 1; d < rank; ++d) {
+              if (++idx[d] < g.T[d]) break;
+              idx[d] = 0;
+            }
+          }
+        }
+      }
+    }
+    for (SizeT i = 0; i < work.size(); ++i) plan.Free(work[i]);
+    for (int iKer = 0; iKer < 3; ++iKer) if (kHat[iKer] != NULL) plan.Free(kHat[iKer]);
+    return res;
+  }
+
+} // namespace
@@ -0,0 +1,275 @@
+/***************************************************************************
+                          convol_separable.cpp  -  separable kernels in convol()
+                             -------------------
+    begin                : Oct 19 2026
+    copyright            : (C) 2026 by the GDL team
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+// A kernel K of rank n is separable if K[i0,i1,...] = k0[i0]*k1[i1]*... (a rank-1 tensor:
+// Gaussians, boxcars, outer products of 1D filters). The convolution is then done by n
+// successive 1D passes, costing sum(kDim) instead of product(kDim) operations per element.
+// Edge modes are separable too: each pass picks its elements following convol_inc1.cpp,
+// and with EDGE_ZERO the NORMALIZE scale is the product of the in-array sums of |k_d|.
+// Only the masks of /NAN and INVALID= are not: arrays with invalid values are left to the
+// direct method.
+
+#include "includefirst.hpp"
+
+#include <cmath>
+#include <vector>
+
+#include "datatypes.hpp"
+#include "convol.hpp"
+
+namespace lib {
+
+  using namespace std;
+
+  // relative tolerance of the rank-1 test. Passes reproduce the direct sums to rounding.
+#define CONVOL_SEPARABLE_TOL 1e-12
+
+  // Finds k_d (one per array dimension, of length kDim[d], 1 for missing kernel dimensions) with
+  // K = k0 (x) k1 (x) ... Numerically this is the rank-1 test of the SVD: the factors are the
+  // fibers of K through its largest element, and the product must give back every element.
+  static bool convol_separable_factors(const DDouble* k, const dimension& kDim, int rank, vector<DDouble> factor[MAXRANK]) {
+    int kRank = kDim.Rank();
+    SizeT kd[MAXRANK], kStride[MAXRANK + 1];
+    SizeT nKel = 1;
+    int nDims = 0; // dimensions of length > 1
+    kStride[0] = 1;
+    for (int d = 0; d < rank; ++d) {
+      kd[d] = (d < kRank && kDim[d] > 0) ? kDim[d] : 1;
+      kStride[d + 1] = kStride[d] * kd[d];
+      nKel *= kd[d];
+      if (kd[d] > 1) ++nDims;
+    }
+    if (nDims < 2) return false;
+
+    SizeT pivot = 0;
+    DDouble kMax = 0;
+    for (SizeT i = 0; i < nKel; ++i) if (fabs(k[i]) > kMax) {
+        kMax = fabs(k[i]);
+        pivot = i;
+      }
+    if (kMax == 0) return false;
+
+    // fibers through the pivot; the first dimension of length > 1 carries K[pivot], the others
+    // are divided by it
+    SizeT pIx[MAXRANK];
+    bool first = true;
+    for (int d = 0; d < rank; ++d) {
+      pIx[d] = (pivot / kStride[d]) % kd[d];
+      factor[d].assign(kd[d], 1);
+      if (kd[d] == 1) continue;
+      SizeT base = pivot - pIx[d] * kStride[d];
+      DDouble norm = first ? 1 : k[pivot];
+      for (SizeT i = 0; i < kd[d]; ++i) factor[d][i] = k[base + i * kStride[d]] / norm;
+      first = false;
+    }
+
+    const DDouble tol = CONVOL_SEPARABLE_TOL * kMax;
+    for (SizeT i = 0; i < nKel; ++i) {
+      DDouble p = 1;
+      for (int d = 0; d < rank; ++d) p *= factor[d][(i / kStride[d]) % kd[d]];
+      if (fabs(p - k[i]) > tol) return false;
+    }
+    return true;
+  }
+
+  // same as ConvolFFTEdgeIndex() in convol_fft.cpp
+  static inline long ConvolSepEdgeIndex(long pos, long n, int edgeMode) {
+    if (pos >= 0 && pos < n) return pos;
+    switch (edgeMode) {
+    case 1: // wrap
+      pos %= n;
+      return (pos < 0) ? pos + n : pos;
+    case 3: // zero
+      return -1;
+    case 4: // mirror
+      pos = (pos < 0) ? -pos : 2 * n - pos - 1;
+      break;
+    default: // none or truncate
+      break;
+    }
+    return (pos < 0) ? 0 : ((pos >= n) ? n - 1 : pos);
+  }
+
+  // 1D pass along dimension d: out[.., x, ..] = sum_i k[i] * in[.., edge(x + off_i), ..].
+  // Lines along dimension 0 are done one by one, otherwise whole rows of the first
+  // dimensions (contiguous) are accumulated at once.
+  static void ConvolSepPass(const DDouble* in, DDouble* out, const SizeT* dim, int rank, int d,
+    const vector<DDouble>& k, bool center, int edgeMode) {
+    SizeT inner = 1, outer = 1;
+    for (int e = 0; e < d; ++e) inner *= dim[e];
+    for (int e = d + 1; e < rank; ++e) outer *= dim[e];
+    const long n = dim[d];
+    const long kd = k.size();
+
+    // for each position along d, the element used by each kernel element (-1: none)
+    vector<long> map(n * kd);
+    for (long x = 0; x < n; ++x) for (long i = 0; i < kd; ++i) {
+        long off = center ? i - kd / 2 : -i;
+        map[x * kd + i] = ConvolSepEdgeIndex(x + off, n, edgeMode);
+      }
+
+    const SizeT nLines = outer * n;
+    const SizeT nEl = nLines * inner;
+#pragma omp parallel for if (CpuTPOOL_NTHREADS > 1 && nEl * kd >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= nEl * kd))
+    for (OMPInt line = 0; line < nLines; ++line) {
+      SizeT o = line / n;
+      long x = line % n;
+      const DDouble* src = in + o * n * inner;
+      DDouble* dst = out + (o * n + x) * inner;
+      const long* m = &map[x * kd];
+      if (inner == 1) {
+        DDouble s = 0;
+        for (long i = 0; i < kd; ++i) if (m[i] >= 0) s += src[m[i]] * k[i];
+        *dst = s;
+      } else {
+        for (SizeT j = 0; j < inner; ++j) dst[j] = 0;
+        for (long i = 0; i < kd; ++i) {
+          if (m[i] < 0) continue;
+          const DDouble* row = src + m[i] * inner;
+          const DDouble ki = k[i];
+          for (SizeT j = 0; j < inner; ++j) dst[j] += row[j] * ki;
+        }
+      }
+    }
+  }
+
+  BaseGDL* convol_separable(DDoubleGDL* array, DDoubleGDL* kernel, DDouble scale, DDouble bias,
+    bool center, bool normalize, int edgeMode,
+    bool doNan, DDouble missing, DDouble invalid, bool doInvalid) {
+    const int rank = array->Rank();
+    vector<DDouble> factor[MAXRANK];
+    if (!convol_separable_factors(&(*kernel)[0], kernel->Dim(), rank, factor)) return NULL;
+
+    const DDouble* a = &(*array)[0];
+    const SizeT nA = array->N_Elements();
+    // values to be skipped, or NaN/Inf without /NAN (as in convol_fft())
+    bool special = false;
+#pragma omp parallel for reduction(||:special) if (nA >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= nA))
+    for (OMPInt i = 0; i < nA; ++i) {
+      if (!std::isfinite(a[i]) || (doInvalid && a[i] == invalid)) special = true;
+    }
+    if (special) return NULL;
+
+    SizeT dim[MAXRANK];
+    for (int d = 0; d < rank; ++d) dim[d] = array->Dim(d);
+
+    DDouble sumAbsK = 0;
+    const DDouble* k = &(*kernel)[0];
+    for (SizeT i = 0; i < kernel->N_Elements(); ++i) sumAbsK += fabs(k[i]);
+    if (normalize) {
+      scale = sumAbsK;
+      bias = 0;
+    } else if (scale == 0) scale = 1;
+
+    DDoubleGDL* res = new DDoubleGDL(array->Dim(), BaseGDL::NOZERO);
+    DDouble* r = &(*res)[0];
+    vector<DDouble> tmp;
+    const DDouble* in = a;
+    // passes alternate between res and tmp, ending in res
+    int nPass = 0;
+    for (int d = 0; d < rank; ++d) if (factor[d].size() > 1) ++nPass;
+    if (nPass > 1) tmp.resize(nA);
+    DDouble* bufs[2] = {(nPass % 2) ? r : &tmp[0], (nPass % 2) ? &tmp[0] : r};
+    int iPass = 0;
+    for (int d = 0; d < rank; ++d) {
+      if (factor[d].size() <= 1) continue;
+      DDouble* out = bufs[iPass % 2];
+      ConvolSepPass(in, out, dim, rank, d, factor[d], center, edgeMode);
+      in = out;
+      ++iPass;
+    }
+    // with EDGE_ZERO, /NORMALIZE only counts the kernel elements falling inside the array
+    vector<DDouble> partScale[MAXRANK];
+    const bool partial = (normalize && edgeMode == 3);
+    long aBeg[MAXRANK], aEnd[MAXRANK];
+    SizeT aStride[MAXRANK + 1];
+    aStride[0] = 1;
+    for (int d = 0; d < rank; ++d) {
+      long kd = factor[d].size();
+      aBeg[d] = center ? kd / 2 : kd - 1;
+      aEnd[d] = center ? dim[d] - (kd - 1) / 2 : dim[d];
+      aStride[d + 1] = aStride[d] * dim[d];
+      if (partial) {
+        partScale[d].assign(dim[d], 0);
+        for (long x = 0; x < (long) dim[d]; ++x) for (long i = 0; i < kd; ++i) {
+            long off = center ? i - kd / 2 : -i;
+            if (x + off >= 0 && x + off < (long) dim[d]) partScale[d][x] += fabs(factor[d][i]);
+          }
+      }
+    }
+
+#pragma omp parallel for if (nA >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= nA))
+    for (OMPInt i = 0; i < nA; ++i) {
+      bool regular = true;
+      DDouble curScale = scale;
+      if (edgeMode == 0 || partial) {
+        if (partial) curScale = 1;
+        for (int d = 0; d < rank; ++d) {
+          long x = (i / aStride[d]) % dim[d];
+          if (x < aBeg[d] || x >= aEnd[d]) regular = false;
+          if (partial) curScale *= partScale[d][x];
+        }
+      }
+      if (edgeMode == 0 && !regular) {
+        r[i] = 0;
+        continue;
+      }
+      DDouble v = (curScale == 0) ? missing : in[i] / curScale;
+      r[i] = v + bias;
+    }
+    return res;
+  }
+
+  // the products of the taps are formed in a wider type, then converted to the kernel type
+  // as Convert2() does (the kernel already has the type used by the direct method)
+  template <typename Ty> struct ConvolOuterWide { typedef DLong64 type; };
+  template <> struct ConvolOuterWide<DULong> { typedef DULong64 type; };
+  template <> struct ConvolOuterWide<DULong64> { typedef DULong64 type; };
+  template <> struct ConvolOuterWide<DDouble> { typedef DDouble type; };
+  template <> struct ConvolOuterWide<DComplexDbl> { typedef DComplexDbl type; };
+
+  template <typename T>
+  static BaseGDL* ConvolOuterKernel(T* k, int rank) {
+    typedef typename T::Ty Ty;
+    typedef typename ConvolOuterWide<Ty>::type Wide;
+    const SizeT n = k->N_Elements();
+    SizeT d[MAXRANK];
+    for (int r = 0; r < rank; ++r) d[r] = n;
+    T* res = new T(dimension(d, rank), BaseGDL::NOZERO);
+    const SizeT nOut = res->N_Elements();
+    for (SizeT i = 0; i < nOut; ++i) {
+      Wide p = (*k)[i % n];
+      SizeT t = i / n;
+      for (int r = 1; r < rank; ++r, t /= n) p *= static_cast<Wide>((*k)[t % n]);
+      (*res)[i] = static_cast<Ty>(p);
+    }
+    return res;
+  }
+
+  BaseGDL* convol_outer_kernel(BaseGDL* kernel, int rank) {
+    switch (kernel->Type()) {
+    case GDL_LONG: return ConvolOuterKernel(static_cast<DLongGDL*>(kernel), rank);
+    case GDL_ULONG: return ConvolOuterKernel(static_cast<DULongGDL*>(kernel), rank);
+    case GDL_LONG64: return ConvolOuterKernel(static_cast<DLong64GDL*>(kernel), rank);
+    case GDL_ULONG64: return ConvolOuterKernel(static_cast<DULong64GDL*>(kernel), rank);
+    case GDL_DOUBLE: return ConvolOuterKernel(static_cast<DDoubleGDL*>(kernel), rank);
+    case GDL_COMPLEXDBL: return ConvolOuterKernel(static_cast<DComplexDblGDL*>(kernel), rank);
+    default: // convol_fun() converts the kernel to one of the above first
+      throw GDLException("CONVOL: Kernel type not supported.");
+    }
+  }
+
+} // namespace
@@ -25,9 +25,14 @@
 #include "datatypes.hpp" // for friend declaration
 #include "nullgdl.hpp"
 #include "dinterpreter.hpp"
+#include "simd_dispatch.hpp"
 
 // needed with gcc-3.3.2
 #include <cassert>
+#include <algorithm>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
 
 #define INCLUDE_DATATYPESREF_CPP 1
 #include "datatypesref.cpp"
@@ -556,6 +561,7 @@ BaseGDL* Data_<SpDFloat>::Log()
       (*n)[ 0] = log( (*this)[ 0]);
       return n;
     }
+  if( SimdMath( SIMD_LOG, &(*n)[ 0], &(*this)[ 0], nEl)) return n;
 #pragma omp parallel for if (nEl >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= nEl))
       for( SizeT i=0; i<nEl; ++i) (*n)[ i] = log( (*this)[ i]);
   return n;
@@ -570,6 +576,7 @@ BaseGDL* Data_<SpDDouble>::Log()
       (*n)[ 0] = log( (*this)[ 0]);
       return n;
     }
+  if( SimdMath( SIMD_LOG, &(*n)[ 0], &(*this)[ 0], nEl)) return n;
 #pragma omp parallel for if (nEl >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= nEl))
     for( SizeT i=0; i<nEl; ++i)  (*n)[ i] = log( (*this)[ i]);
   return n;
@@ -584,6 +591,7 @@ BaseGDL* Data_<SpDComplex>::Log()
       (*n)[ 0] = log( (*this)[ 0]);
       return n;
     }
+  if( SimdMath( SIMD_LOG, &(*n)[ 0], &(*this)[ 0], nEl)) return n;
 #pragma omp parallel for if (nEl >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= nEl))
     for( SizeT i=0; i<nEl; ++i) (*n)[ i] = log( (*this)[ i]);
   return n;
@@ -598,6 +606,7 @@ BaseGDL* Data_<SpDComplexDbl>::Log()
       (*n)[ 0] = log( (*this)[ 0]);
       return n;
     }
+  if( SimdMath( SIMD_LOG, &(*n)[ 0], &(*this)[ 0], nEl)) return n;
 #pragma omp parallel for if (nEl >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= nEl))
     for( SizeT i=0; i<nEl; ++i) (*n)[ i] = log( (*this)[ i]);
   return n;
@@ -624,6 +633,7 @@ BaseGDL* Data_<SpDFloat>::LogThis()
       (*this)[ 0] = log( (*this)[ 0]);
       return this;
     }
+  if( SimdMath( SIMD_LOG, &(*this)[ 0], &(*this)[ 0], nEl)) return this;
 #pragma omp parallel for if (nEl >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= nEl))
     for( SizeT i=0; i<nEl; ++i) (*this)[ i] = log( (*this)[ i]);
   return this;
@@ -637,6 +647,7 @@ BaseGDL* Data_<SpDDouble>::LogThis()
       (*this)[ 0] = log( (*this)[ 0]);
       return this;
     }
+  if( SimdMath( SIMD_LOG, &(*this)[ 0], &(*this)[ 0], nEl)) return this;
 #pragma omp parallel for if (nEl >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= nEl))
     for( SizeT i=0; i<nEl; ++i) (*this)[ i] = log( (*this)[ i]);
   return this;
@@ -650,6 +661,7 @@ BaseGDL* Data_<SpDComplex>::LogThis()
       (*this)[ 0] = log( (*this)[ 0]);
       return this;
     }
+  if( SimdMath( SIMD_LOG, &(*this)[ 0], &(*this)[ 0], nEl)) return this;
 #pragma omp parallel for if (nEl >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= nEl))
     for( SizeT i=0; i<nEl; ++i) (*this)[ i] = log( (*this)[ i]);
   return this;
@@ -663,6 +675,7 @@ BaseGDL* Data_<SpDComplexDbl>::LogThis()
       (*this)[ 0] = log( (*this)[ 0]);
       return this;
     }
+  if( SimdMath( SIMD_LOG, &(*this)[ 0], &(*this)[ 0], nEl)) return this;
 #pragma omp parallel for if (nEl >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= nEl))
     for( SizeT i=0; i<nEl; ++i) (*this)[ i] = log( (*this)[ i]);
   return this;
@@ -686,6 +699,7 @@ BaseGDL* Data_<SpDFloat>::Log10()
       (*n)[ 0] = log10( (*this)[ 0]);
       return n;
     }
+  if( SimdMath( SIMD_LOG10, &(*n)[ 0], &(*this)[ 0], nEl)) return n;
 #pragma omp parallel for if (nEl >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= nEl))
     for( SizeT i=0; i<nEl; ++i) (*n)[ i] = log10( (*this)[ i]);
   return n;
@@ -700,6 +714,7 @@ BaseGDL* Data_<SpDDouble>::Log10()
       (*n)[ 0] = log10( (*this)[ 0]);
       return n;
     }
+  if( SimdMath( SIMD_LOG10, &(*n)[ 0], &(*this)[ 0], nEl)) return n;
 #pragma omp parallel for if (nEl >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= nEl))
     for( SizeT i=0; i<nEl; ++i) (*n)[ i] = log10( (*this)[ i]);
   return n;
@@ -753,6 +768,7 @@ BaseGDL* Data_<SpDFloat>::Log10This()
       (*this)[ 0] = log10( (*this)[ 0]);
       return this;
     }
+  if( SimdMath( SIMD_LOG10, &(*this)[ 0], &(*this)[ 0], nEl)) return this;
   TRACEOMP( __FILE__, __LINE__)
 #pragma omp parallel for if (nEl >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= nEl))
     for( SizeT i=0; i<nEl; ++i)
@@ -773,6 +789,7 @@ BaseGDL* Data_<SpDDouble>::Log10This()
       (*this)[ 0] = log10( (*this)[ 0]);
       return this;
     }
+  if( SimdMath( SIMD_LOG10, &(*this)[ 0], &(*this)[ 0], nEl)) return this;
   TRACEOMP( __FILE__, __LINE__)
 #pragma omp parallel for if (nEl >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= nEl))
     for( SizeT i=0; i<nEl; ++i)
@@ -1217,6 +1234,86 @@ BaseGDL* Data_<Sp>::CShift( DLong s[ MAXRANK]) const {
 
 
 
+// blocked kernels for Transpose(). A transpose is done as a batch of 2D transposes between the
+// fastest dimension of the source and the one becoming the fastest of the result, each split
+// recursively (cache-oblivious) down to TRANSPOSE_LEAF x TRANSPOSE_LEAF tiles, themselves done by
+// 4x4 (4 bytes) or 2x2 (8 bytes) transposes in SSE registers.
+#define TRANSPOSE_LEAF 64
+// size of the blocks distributed to threads along the larger side of a 2D transpose
+#define TRANSPOSE_PAR_BLOCK 256
+
+// element size for the SSE kernels, 0: plain copy
+template<typename T> struct TransposeSIMDSize { static const int value = sizeof(T); };
+template<> struct TransposeSIMDSize<DString> { static const int value = 0; };
+
+// dst[i1 + i0*dStride] = src[i0 + i1*sStride], i0 < n0, i1 < n1
+template<int size> struct TransposeLeaf {
+  template<typename T>
+  static void Do(const T* src, T* dst, SizeT n0, SizeT n1, SizeT sStride, SizeT dStride) {
+    for (SizeT i0 = 0; i0 < n0; ++i0)
+      for (SizeT i1 = 0; i1 < n1; ++i1) dst[i1 + i0 * dStride] = src[i0 + i1 * sStride];
+  }
+};
+#if defined(__SSE2__)
+template<> struct TransposeLeaf<4> {
+  template<typename T>
+  static void Do(const T* src, T* dst, SizeT n0, SizeT n1, SizeT sStride, SizeT dStride) {
+    SizeT m0 = n0 & ~(SizeT) 3, m1 = n1 & ~(SizeT) 3;
+    for (SizeT i1 = 0; i1 < m1; i1 += 4) {
+      for (SizeT i0 = 0; i0 < m0; i0 += 4) {
+        const T* s = src + i0 + i1 * sStride;
+        __m128 r0 = _mm_loadu_ps((const float*) (s));
+        __m128 r1 = _mm_loadu_ps((const float*) (s + sStride));
+        __m128 r2 = _mm_loadu_ps((const float*) (s + 2 * sStride));
+        __m128 r3 = _mm_loadu_ps((const float*) (s + 3 * sStride));
+        _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+        T* d = dst + i1 + i0 * dStride;
+        _mm_storeu_ps((float*) (d), r0);
+        _mm_storeu_ps((float*) (d + dStride), r1);
+        _mm_storeu_ps((float*) (d + 2 * dStride), r2);
+        _mm_storeu_ps((float*) (d + 3 * dStride), r3);
+      }
+    }
+    // borders
+    if (m0 < n0) TransposeLeaf<0>::Do(src + m0, dst + m0 * dStride, n0 - m0, n1, sStride, dStride);
+    if (m1 < n1) TransposeLeaf<0>::Do(src + m1 * sStride, dst + m1, m0, n1 - m1, sStride, dStride);
+  }
+};
+template<> struct TransposeLeaf<8> {
+  template<typename T>
+  static void Do(const T* src, T* dst, SizeT n0, SizeT n1, SizeT sStride, SizeT dStride) {
+    SizeT m0 = n0 & ~(SizeT) 1, m1 = n1 & ~(SizeT) 1;
+    for (SizeT i1 = 0; i1 < m1; i1 += 2) {
+      for (SizeT i0 = 0; i0 < m0; i0 += 2) {
+        const T* s = src + i0 + i1 * sStride;
+        __m128d r0 = _mm_loadu_pd((const double*) (s));
+        __m128d r1 = _mm_loadu_pd((const double*) (s + sStride));
+        T* d = dst + i1 + i0 * dStride;
+        _mm_storeu_pd((double*) (d), _mm_unpacklo_pd(r0, r1));
+        _mm_storeu_pd((double*) (d + dStride), _mm_unpackhi_pd(r0, r1));
+      }
+    }
+    if (m0 < n0) TransposeLeaf<0>::Do(src + m0, dst + m0 * dStride, n0 - m0, n1, sStride, dStride);
+    if (m1 < n1) TransposeLeaf<0>::Do(src + m1 * sStride, dst + m1, m0, n1 - m1, sStride, dStride);
+  }
+};
+#endif
+
+template<typename T>
+static void TransposeBlocked(const T* src, T* dst, SizeT n0, SizeT n1, SizeT sStride, SizeT dStride) {
+  if (n0 <= TRANSPOSE_LEAF && n1 <= TRANSPOSE_LEAF) {
+    TransposeLeaf<TransposeSIMDSize<T>::value>::Do(src, dst, n0, n1, sStride, dStride);
+  } else if (n0 >= n1) { // halves, multiple of 8 to keep the SSE kernels on full tiles
+    SizeT h = ((n0 / 2) + 7) & ~(SizeT) 7;
+    TransposeBlocked(src, dst, h, n1, sStride, dStride);
+    TransposeBlocked(src + h, dst + h * dStride, n0 - h, n1, sStride, dStride);
+  } else {
+    SizeT h = ((n1 / 2) + 7) & ~(SizeT) 7;
+    TransposeBlocked(src, dst, n0, h, sStride, dStride);
+    TransposeBlocked(src + h * sStride, dst + h, n0, n1 - h, sStride, dStride);
+  }
+}
+
 // assumes *perm is already checked according to uniqness and length
 // dim[i]_out = dim[perm[i]]_in
 // helper function for Transpose()
@@ -1270,73 +1367,110 @@ BaseGDL* Data_<Sp>::Transpose( DUInt* perm) {
     perm = &permDefault[ MAXRANK - rank];
   }
 
-  //new version, parallell the job on a multithreaded machine. Gain is 3/4 number of threads.  
   SizeT resDim[ MAXRANK]; // permutated!
   for (SizeT d = 0; d < rank; ++d) {
     resDim[ d] = this->dim[ perm[ d]];
   }
 
   Data_* res = new Data_(dimension(resDim, rank), BaseGDL::NOZERO);
+  SizeT nElem = dd.size();
+  if (nElem == 0) return res;
+
+  // reduce the permutation: drop dimensions of size 1, merge dimensions that stay adjacent
+  // (a permutation of the merged dimensions has the same memory layout).
+  long newIx[ MAXRANK];
+  SizeT nDim = 0;
+  for (SizeT d = 0; d < rank; ++d) newIx[ d] = (this->dim[ d] > 1) ? nDim++ : -1;
+  SizeT mPerm[ MAXRANK]; // merged permutation, in source dimension numbers first
+  SizeT mLen[ MAXRANK]; // number of source dimensions merged in each
+  SizeT mRank = 0;
+  for (SizeT d = 0; d < rank; ++d) {
+    long ix = newIx[ perm[ d]];
+    if (ix < 0) continue;
+    if (mRank > 0 && (SizeT) ix == mPerm[ mRank - 1] + mLen[ mRank - 1]) {
+      ++mLen[ mRank - 1];
+    } else {
+      mPerm[ mRank] = ix;
+      mLen[ mRank++] = 1;
+    }
+  }
+  // renumber the merged dimensions in source order, with their sizes
+  SizeT srcDim[ MAXRANK], srcStride[ MAXRANK + 1], resStride[ MAXRANK + 1];
+  SizeT srcDims[ MAXRANK]; // non-trivial source dimensions
+  for (SizeT d = 0; d < rank; ++d) if (newIx[ d] >= 0) srcDims[ newIx[ d]] = this->dim[ d];
+  SizeT mSrcOrder[ MAXRANK]; // merged dimension at each source position
+  for (SizeT m = 0; m < mRank; ++m) {
+    SizeT pos = 0;
+    for (SizeT k = 0; k < mRank; ++k) if (mPerm[ k] < mPerm[ m]) ++pos;
+    mSrcOrder[ pos] = m;
+  }
+  for (SizeT pos = 0; pos < mRank; ++pos) {
+    SizeT m = mSrcOrder[ pos];
+    srcDim[ pos] = 1;
+    for (SizeT k = 0; k < mLen[ m]; ++k) srcDim[ pos] *= srcDims[ mPerm[ m] + k];
+    mPerm[ m] = pos;
+  }
+  srcStride[ 0] = resStride[ 0] = 1;
+  for (SizeT d = 0; d < mRank; ++d) {
+    srcStride[ d + 1] = srcStride[ d] * srcDim[ d];
+    resStride[ d + 1] = resStride[ d] * srcDim[ mPerm[ d]];
+  }
 
-  // src stride
-  SizeT srcStride[ MAXRANK+1];
-  this->dim.Stride(srcStride, rank);
+  const Ty* src = &(*this)[ 0];
+  Ty* dst = &(*res)[ 0];
+  bool parallel = (nElem >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= nElem));
 
-  SizeT nElem = dd.size();
-  long chunksize = nElem;
-  long nchunk = 1;
-  if (nElem > CpuTPOOL_MIN_ELTS) { //no use start parallel threading for small numbers.
-    chunksize = nElem / ((CpuTPOOL_NTHREADS > 32) ? 32 : CpuTPOOL_NTHREADS);
-    nchunk = nElem / chunksize;
-    if (chunksize * nchunk < nElem) ++nchunk;
-  } else {
-    nchunk = 1;
-    chunksize = nElem;
+  if (mRank <= 1) { // same memory layout
+    std::copy(src, src + nElem, dst);
+    return res;
   }
-  //compute start parameter for each multiWalk chunks:
-  // pool of accelerators
-  SizeT srcDimPool[nchunk][MAXRANK];
-  for (SizeT i = 0; i < rank; ++i) for (int iloop = 0; iloop < nchunk; ++iloop) srcDimPool[iloop][i] = 0;
-  //template accelerator
-  SizeT templateDim[MAXRANK];
-  for (SizeT i = 0; i < rank; ++i) templateDim[i] = 0;
-
-  //compute iloop's accelerator with fast direct method
-  for (long iloop = 0; iloop < nchunk; ++iloop) {
-    SizeT e = iloop*chunksize;
-    SizeT sizeleft = e;
-    for (long i = 0; i < rank; ++i) {
-      DUInt pi = perm[i]; //note the transpose effect.
-      sizeleft /= resDim[i];
-      templateDim[pi] = e - sizeleft * resDim[i];
-      e = sizeleft;
+
+  if (mPerm[ 0] == 0) {
+    // the leading dimension is kept: copies of contiguous blocks
+    SizeT len = srcDim[ 0];
+    OMPInt nBlocks = nElem / len;
+#pragma omp parallel for if (parallel)
+    for (OMPInt b = 0; b < nBlocks; ++b) {
+      SizeT rest = b, srcIx = 0;
+      for (SizeT d = 1; d < mRank; ++d) {
+        SizeT n = srcDim[ mPerm[ d]];
+        srcIx += (rest % n) * srcStride[ mPerm[ d]];
+        rest /= n;
+      }
+      std::copy(src + srcIx, src + srcIx + len, dst + b * len);
     }
-    //memorize current state accelerator for chunk iloop:
-    for (long j = 0; j < rank; ++j) srcDimPool[iloop][j] = templateDim[j];
+    return res;
   }
 
-#pragma omp parallel num_threads(nchunk) 
-  {
-#pragma omp for 
-    for (long iloop = 0; iloop < nchunk; ++iloop) {
-      // populate src multi dim
-      SizeT srcDim[MAXRANK];
-      for (SizeT i = 0; i < rank; ++i) srcDim[i] = srcDimPool[iloop][i];
-      //inner loop
-      for (SizeT e = iloop * chunksize; (e < (iloop + 1) * chunksize && e < nElem); ++e) {
-        // src multi dim to one dim src offset index
-        SizeT ix = 0;
-        for (SizeT i = 0; i < rank; ++i) ix += srcDim[i] * srcStride[i];
-        (*res)[ e] = (*this)[ ix];
-        // update src multi dim for next dest offset index: here is the transpose effect.
-        for (SizeT i = 0; i < rank; ++i) {
-          DUInt pi = perm[i];
-          srcDim[pi]++;
-          if (srcDim[pi] < resDim[i]) break;
-          srcDim[pi] = 0;
-        }
-      }
+  // batch of 2D transposes between source dimension 0 (result dimension q) and result dimension 0
+  // (source dimension p), over the other dimensions.
+  SizeT p = mPerm[ 0], q = 0;
+  while (mPerm[ q] != 0) ++q;
+  SizeT n0 = srcDim[ 0], n1 = srcDim[ p];
+  SizeT sStride = srcStride[ p], dStride = resStride[ q];
+  // blocks along the larger side, for the threads
+  bool split0 = (n0 >= n1);
+  SizeT nSplit = split0 ? n0 : n1;
+  SizeT nPerBatch = (nSplit + TRANSPOSE_PAR_BLOCK - 1) / TRANSPOSE_PAR_BLOCK;
+  OMPInt nBatch = nElem / (n0 * n1);
+  OMPInt nItems = nBatch * nPerBatch;
+#pragma omp parallel for if (parallel)
+  for (OMPInt item = 0; item < nItems; ++item) {
+    SizeT rest = item / nPerBatch;
+    SizeT blk = item % nPerBatch;
+    SizeT srcIx = 0, resIx = 0;
+    for (SizeT d = 1; d < mRank; ++d) {
+      if (d == q) continue;
+      SizeT n = srcDim[ mPerm[ d]];
+      SizeT i = rest % n;
+      rest /= n;
+      srcIx += i * srcStride[ mPerm[ d]];
+      resIx += i * resStride[ d];
     }
+    SizeT beg = blk * TRANSPOSE_PAR_BLOCK;
+    SizeT len = std::min((SizeT) TRANSPOSE_PAR_BLOCK, nSplit - beg);
+    if (split0) TransposeBlocked(src + srcIx + beg, dst + resIx + beg * dStride, len, n1, sStride, dStride);
+    else TransposeBlocked(src + srcIx + beg * sStride, dst + resIx + beg, n0, len, sStride, dStride);
   }
   return res;
 }
@@ -3059,6 +3193,112 @@ void Data_<Sp>::AssignAtIx( RangeT ixR, BaseGDL* srcIn)
     (*this)[ixR] = (*static_cast<Data_*>(srcIn))[0];
 }
 
+// gather and scatter through index arrays (AllIxBaseT::BlockAccess()):
+// the indices are converted by blocks of IX_BLOCK, in parallel for large
+// index arrays
+static const SizeT IX_BLOCK = 1024;
+
+inline bool IxParallel( SizeT nCp)
+{
+  return CpuTPOOL_NTHREADS > 1 && nCp >= CpuTPOOL_MIN_ELTS &&
+    (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= nCp);
+}
+
+// dst[ c] = src[ allIx[ c]]
+template<typename T>
+static void IxGather( const T* src, T* dst, const AllIxBaseT* allIx, SizeT nCp)
+{
+  const OMPInt nBlk = (nCp + IX_BLOCK - 1) / IX_BLOCK;
+#pragma omp parallel for if( IxParallel( nCp))
+  for( OMPInt b = 0; b < nBlk; ++b)
+    {
+      SizeT ix[ IX_BLOCK];
+      SizeT s = b * IX_BLOCK;
+      SizeT n = (nCp - s < IX_BLOCK) ? nCp - s : IX_BLOCK;
+      allIx->IndexBlock( ix, s, n);
+      T* out = dst + s;
+      for( SizeT k = 0; k < n; ++k) out[ k] = src[ ix[ k]];
+    }
+}
+
+// dst[ allIx[ c]] = src[ c * srcStep] (srcStep 0 for a scalar)
+// as the sequential loop, the last of repeated indices wins:
+// - monotonic indices, where repeated ones are adjacent, are split in
+//   blocks, each block leaving the run of the index starting the next
+//   block to that one
+// - otherwise each thread writes its part of dst, going through all indices
+template<typename T>
+static void IxScatter( T* dst, SizeT nDst, const T* src, SizeT srcStep,
+		       const AllIxBaseT* allIx, SizeT nCp)
+{
+  const OMPInt nBlk = (nCp + IX_BLOCK - 1) / IX_BLOCK;
+  if( !IxParallel( nCp))
+    {
+      SizeT ix[ IX_BLOCK];
+      for( OMPInt b = 0; b < nBlk; ++b)
+	{
+	  SizeT s = b * IX_BLOCK;
+	  SizeT n = (nCp - s < IX_BLOCK) ? nCp - s : IX_BLOCK;
+	  allIx->IndexBlock( ix, s, n);
+	  for( SizeT k = 0; k < n; ++k) dst[ ix[ k]] = src[ (s + k) * srcStep];
+	}
+      return;
+    }
+
+  int up = 1, down = 1;
+#pragma omp parallel for reduction(&:up,down)
+  for( OMPInt b = 0; b < nBlk; ++b)
+    {
+      SizeT ix[ IX_BLOCK + 1];
+      SizeT s = b * IX_BLOCK;
+      SizeT n = (nCp - s < IX_BLOCK) ? nCp - s : IX_BLOCK;
+      if( b > 0) { --s; ++n;} // with the last index of the previous block
+      allIx->IndexBlock( ix, s, n);
+      int u = 1, d = 1;
+      for( SizeT k = 1; k < n; ++k)
+	{
+	  u &= (ix[ k - 1] <= ix[ k]);
+	  d &= (ix[ k - 1] >= ix[ k]);
+	}
+      up &= u;
+      down &= d;
+    }
+
+  if( up || down)
+    {
+#pragma omp parallel for
+      for( OMPInt b = 0; b < nBlk; ++b)
+	{
+	  SizeT ix[ IX_BLOCK + 1];
+	  SizeT s = b * IX_BLOCK;
+	  SizeT n = (nCp - s < IX_BLOCK) ? nCp - s : IX_BLOCK;
+	  bool last = (s + n == nCp);
+	  allIx->IndexBlock( ix, s, last ? n : n + 1);
+	  SizeT e = n;
+	  if( !last)
+	    while( e > 0 && ix[ e - 1] == ix[ n]) --e;
+	  for( SizeT k = 0; k < e; ++k) dst[ ix[ k]] = src[ (s + k) * srcStep];
+	}
+      return;
+    }
+
+  const OMPInt nPart = CpuTPOOL_NTHREADS;
+#pragma omp parallel for
+  for( OMPInt p = 0; p < nPart; ++p)
+    {
+      SizeT lo = nDst * p / nPart;
+      SizeT len = nDst * (p + 1) / nPart - lo;
+      SizeT ix[ IX_BLOCK];
+      for( SizeT s = 0; s < nCp; s += IX_BLOCK)
+	{
+	  SizeT n = (nCp - s < IX_BLOCK) ? nCp - s : IX_BLOCK;
+	  allIx->IndexBlock( ix, s, n);
+	  for( SizeT k = 0; k < n; ++k)
+	    if( ix[ k] - lo < len) dst[ ix[ k]] = src[ (s + k) * srcStep];
+	}
+    }
+}
+
 // assigns srcIn to this at ixList, if ixList is NULL does linear copy
 // assumes: ixList has this already set as variable
 // used by DotAccessDescT::DoAssign
@@ -3092,6 +3332,11 @@ void Data_<Sp>::AssignAt( BaseGDL* srcIn, ArrayIndexListT* ixList, SizeT offset)
 	  SizeT nCp=ixList->N_Elements();
 	  
 	  AllIxBaseT* allIx = ixList->BuildIx();
+	  if( allIx->BlockAccess())
+	    {
+	      IxScatter( &(*this)[ 0], dd.size(), &scalar, 0, allIx, nCp);
+	      return;
+	    }
 	  /*#pragma omp parallel if (nCp >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= nCp))
 	    {
 	    #pragma omp for*/
@@ -3143,6 +3388,11 @@ void Data_<Sp>::AssignAt( BaseGDL* srcIn, ArrayIndexListT* ixList, SizeT offset)
 				       " source expression.");
 		  
 		  AllIxBaseT* allIx = ixList->BuildIx();
+		  if( allIx->BlockAccess() && src != this) // a[ix]=a: sequential
+		    {
+		      IxScatter( &(*this)[ 0], dd.size(), &(*src)[ 0], 1, allIx, nCp);
+		      return;
+		    }
 		  /*#pragma omp parallel if (nCp >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= nCp))
 		    {
 		    #pragma omp for*/
@@ -3158,6 +3408,11 @@ void Data_<Sp>::AssignAt( BaseGDL* srcIn, ArrayIndexListT* ixList, SizeT offset)
 				       " source expression.");
 		  
 		  AllIxBaseT* allIx = ixList->BuildIx();
+		  if( allIx->BlockAccess() && src != this) // a[ix]=a: sequential
+		    {
+		      IxScatter( &(*this)[ 0], dd.size(), &(*src)[ offset], 1, allIx, nCp);
+		      return;
+		    }
 		  /*#pragma omp parallel if (nCp >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= nCp))
 		    {
 		    #pragma omp for*/
@@ -3192,6 +3447,11 @@ void Data_<Sp>::AssignAt( BaseGDL* srcIn, ArrayIndexListT* ixList)
 	{
 	  Ty scalar=(*src)[0];
 	  AllIxBaseT* allIx = ixList->BuildIx();
+	  if( allIx->BlockAccess())
+	    {
+	      IxScatter( &(*this)[ 0], dd.size(), &scalar, 0, allIx, nCp);
+	      return;
+	    }
 	  (*this)[ allIx->InitSeqAccess()]=scalar;
 	  /*#pragma omp parallel if (nCp >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= nCp))
 	    {
@@ -3220,6 +3480,11 @@ void Data_<Sp>::AssignAt( BaseGDL* srcIn, ArrayIndexListT* ixList)
 			       " source expression.");
 	  
 	  AllIxBaseT* allIx = ixList->BuildIx();
+	  if( allIx->BlockAccess() && src != this) // a[ix]=a: sequential
+	    {
+	      IxScatter( &(*this)[ 0], dd.size(), &(*src)[ 0], 1, allIx, nCp);
+	      return;
+	    }
 	  (*this)[ allIx->InitSeqAccess()]=(*src)[0];
 	  /*#pragma omp parallel if (nCp >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= nCp))
 	    {
@@ -3675,6 +3940,26 @@ Data_<Sp>* Data_<Sp>::CatArray( ExprListT& exprList,
   return catArr;
 }
 
+// copies the strided view (see ArrayIndexListT::StridedView()) of src to dst,
+// by runs along the first dimension after merging the dimensions which are
+// contiguous in src
+template<typename T>
+static void StridedViewCopy( const T* src, T* dst, StridedViewT view)
+{
+  view.Merge();
+  if (view.rank == 0) {
+    dst[ 0] = src[ view.offset];
+    return;
+  }
+  SizeT len = view.dim[ 0];
+  SizeT nRuns = 1;
+  for (SizeT d = 1; d < view.rank; ++d) nRuns *= view.dim[ d];
+  SizeT nEl = len * nRuns;
+#pragma omp parallel for if (nEl >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= nEl))
+  for (OMPInt r = 0; r < nRuns; ++r)
+    view.Gather( src, dst + r * len, r * len, (r + 1) * len);
+}
+
 // returns (*this)[ ixList]
 template<class Sp>
 Data_<Sp>* Data_<Sp>::Index( ArrayIndexListT* ixList)
@@ -3685,6 +3970,14 @@ Data_<Sp>* Data_<Sp>::Index( ArrayIndexListT* ixList)
 
   SizeT nCp=ixList->N_Elements();
 
+  // ranges and scalars only: block copies, without going through AllIxBaseT
+  StridedViewT view;
+  if( nCp > 1 && ixList->StridedView( view))
+    {
+      StridedViewCopy( &(*this)[ 0], &(*res)[ 0], view);
+      return res;
+    }
+
   //  cout << "nCP = " << nCp << endl;
   //  cout << "dim = " << this->dim << endl;
   
@@ -3696,6 +3989,11 @@ Data_<Sp>* Data_<Sp>::Index( ArrayIndexListT* ixList)
       (*res)[0]=(*this)[ (*allIx)[ 0]];
       return res;
     }
+  if( allIx->BlockAccess())
+    {
+      IxGather( &(*this)[ 0], &(*res)[ 0], allIx, nCp);
+      return res;
+    }
   //   else
   //   {
   /*#pragma omp parallel if (nCp >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= nCp))
@@ -4584,6 +4882,11 @@ Data_<Sp>* Data_<Sp>::NewIx( AllIxBaseT* ix, const dimension* dIn)
 {
   SizeT nCp = ix->size();
   Data_* res=Data_::New( *dIn, BaseGDL::NOZERO);
+  if( nCp > 1 && ix->BlockAccess())
+    {
+      IxGather( &(*this)[ 0], &(*res)[ 0], ix, nCp);
+      return res;
+    }
   /*#pragma omp parallel if (nCp >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= nCp))
     {
     #pragma omp for*/
@@ -4742,7 +5045,7 @@ SizeT Data_<SpDFloat>::GetAsIndex( SizeT i) const
 {
   if( (*this)[i] <= 0.0)
     return 0;
-  return Real2Int<SizeT,float>((*this)[i]);
+  return Real2Index<float>((*this)[i]);
 }	
 template<>
 SizeT Data_<SpDFloat>::GetAsIndexStrict( SizeT i) const
@@ -4752,14 +5055,14 @@ SizeT Data_<SpDFloat>::GetAsIndexStrict( SizeT i) const
 		       "contains out of range (<0) subscript (at index: " + i2s(i) + ").",true,false);
   if( (*this)[i] <= 0.0)
     return 0;
-  return Real2Int<SizeT,float>((*this)[i]);
+  return Real2Index<float>((*this)[i]);
 }	
 template<>
 SizeT Data_<SpDDouble>::GetAsIndex( SizeT i) const
 {
   if( (*this)[i] <= 0.0)
     return 0;
-  return Real2Int<SizeT,double>((*this)[i]);
+  return Real2Index<double>((*this)[i]);
 }	
 template<>
 SizeT Data_<SpDDouble>::GetAsIndexStrict( SizeT i) const
@@ -4769,7 +5072,7 @@ SizeT Data_<SpDDouble>::GetAsIndexStrict( SizeT i) const
 		       "contains out of range (<0) subscript (at index: " + i2s(i) + ").",true,false);
   if( (*this)[i] <= 0.0)
     return 0;
-  return Real2Int<SizeT,double>((*this)[i]);
+  return Real2Index<double>((*this)[i]);
 }	
 template<>
 SizeT Data_<SpDString>::GetAsIndex( SizeT i) const
@@ -4808,7 +5111,7 @@ SizeT Data_<SpDComplex>::GetAsIndex( SizeT i) const
 {
   if( real((*this)[i]) <= 0.0)
     return 0;
-  return Real2Int<SizeT,float>(real((*this)[i]));
+  return Real2Index<float>(real((*this)[i]));
 }	
 template<>
 SizeT Data_<SpDComplex>::GetAsIndexStrict( SizeT i) const
@@ -4818,14 +5121,14 @@ SizeT Data_<SpDComplex>::GetAsIndexStrict( SizeT i) const
 		       "contains out of range (<0) subscript (at index: " + i2s(i) + ").",true,false);
   if( real((*this)[i]) <= 0.0)
     return 0;
-  return Real2Int<SizeT,float>(real((*this)[i]));
+  return Real2Index<float>(real((*this)[i]));
 }	
 template<>
 SizeT Data_<SpDComplexDbl>::GetAsIndex( SizeT i) const
 {
   if( real((*this)[i]) <= 0.0)
     return 0;
-  return Real2Int<SizeT,double>(real((*this)[i]));
+  return Real2Index<double>(real((*this)[i]));
 }	
 template<>
 SizeT Data_<SpDComplexDbl>::GetAsIndexStrict( SizeT i) const
@@ -4835,7 +5138,7 @@ SizeT Data_<SpDComplexDbl>::GetAsIndexStrict( SizeT i) const
 		       "contains out of range (<0) subscript (at index: " + i2s(i) + ").",true,false);
   if( real((*this)[i]) <= 0.0)
     return 0;
-  return Real2Int<SizeT,double>(real((*this)[i]));
+  return Real2Index<double>(real((*this)[i]));
 }	
 
 #include "instantiate_templates.hpp"
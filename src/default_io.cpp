@@ -35,6 +35,7 @@
 #include "gdljournal.hpp"
 #include "list.hpp"
 #include "hash.hpp"
+#include "simd_dispatch.hpp"
 
 using namespace std;
 
@@ -1549,21 +1550,16 @@ ostream& Data_<Sp>::Write( ostream& os, bool swapEndian, bool compress, XDR *xdr
   if ( swapEndian && (sizeof (Ty) != 1) ) {
     char* cData = reinterpret_cast<char*> (&(*this)[0]);
     SizeT cCount = count * sizeof (Ty);
-    if ( Data_<Sp>::IS_COMPLEX ) {
-      char *swapBuf = (char*) malloc( sizeof (char) * sizeof (Ty) / 2 );
-      for ( SizeT i = 0; i < cCount; i += sizeof (Ty) / 2 ) {
-        SizeT src = i + sizeof (Ty) / 2 - 1;
-        for ( SizeT dst = 0; dst<sizeof (Ty) / 2; dst++ ) swapBuf[dst]=cData[ src--];
-        os.write( swapBuf, sizeof (Ty) / 2 );
-      }
-      free( swapBuf );
-    } else {
-      char swapBuf[ sizeof (Ty)];
-      for ( SizeT i = 0; i < cCount; i += sizeof (Ty) ) {
-        SizeT src = i + sizeof (Ty) - 1;
-        for ( SizeT dst = 0; dst<sizeof (Ty); dst++ ) swapBuf[dst] = cData[ src--];
-        os.write( swapBuf, sizeof (Ty) );
-      }
+    // complex: real and imaginary parts are swapped separately
+    SizeT swapSz = Data_<Sp>::IS_COMPLEX ? sizeof (Ty) / 2 : sizeof (Ty);
+    // swapped copies of 64 kB (a multiple of swapSz) blocks
+    const SizeT chunk = 65536;
+    vector<char> swapBuf( (cCount < chunk) ? cCount : chunk );
+    for ( SizeT i = 0; i < cCount; i += chunk ) {
+      SizeT n = (cCount - i < chunk) ? cCount - i : chunk;
+      memcpy( &swapBuf[0], cData + i, n );
+      SimdByteSwap( &swapBuf[0], swapSz, n / swapSz );
+      os.write( &swapBuf[0], n );
     }
   } else if ( xdrs != NULL ) {
     long fac = 1;
@@ -1679,23 +1675,11 @@ bool compress, XDR *xdrs ) {
   if ( swapEndian && (sizeof (Ty) != 1) ) {
     char* cData = reinterpret_cast<char*> (&(*this)[0]);
     SizeT cCount = count * sizeof (Ty);
-
-    if ( Data_<Sp>::IS_COMPLEX ) {
-      char *swapBuf = (char*) malloc( sizeof (char) * sizeof (Ty) / 2 );
-      for ( SizeT i = 0; i < cCount; i += sizeof (Ty) / 2 ) {
-        os.read( swapBuf, sizeof (Ty) / 2 );
-        SizeT src = i + sizeof (Ty) / 2 - 1;
-        for ( SizeT dst = 0; dst<sizeof (Ty) / 2; dst++ ) cData[ src--] = swapBuf[dst];
-      }
-      free( swapBuf );
-    } else {
-      char swapBuf[ sizeof (Ty)];
-      for ( SizeT i = 0; i < cCount; i += sizeof (Ty) ) {
-        os.read( swapBuf, sizeof (Ty) );
-        SizeT src = i + sizeof (Ty) - 1;
-        for ( SizeT dst = 0; dst<sizeof (Ty); dst++ ) cData[ src--] = swapBuf[dst];
-      }
-    }
+    // read as is, then swapped in place
+    // complex: real and imaginary parts are swapped separately
+    os.read( cData, cCount );
+    SizeT swapSz = Data_<Sp>::IS_COMPLEX ? sizeof (Ty) / 2 : sizeof (Ty);
+    SimdByteSwap( cData, swapSz, cCount / swapSz );
   } else if ( xdrs != NULL ) {
     long fac = 1;
     if ( sizeof (Ty) == 2 ) fac = 2;
@@ -46,6 +46,8 @@
 #include "terminfo.hpp"
 #include "sigfpehandler.hpp"
 #include "gdleventhandler.hpp"
+#include "blas_backend.hpp"
+#include "simd_dispatch.hpp"
 
 #ifdef _OPENMP
 #include <omp.h>
@@ -234,6 +236,7 @@ int main(int argc, char *argv[])
   usePlatformDeviceName=false;
   forceWxWidgetsUglyFonts = false;
   useDSFMTAcceleration = true;
+  useBLASBackend = BlasCompiled();
   iAmANotebook=false; //option --notebook
  #ifdef HAVE_LIBWXWIDGETS 
   useWxWidgets=true;
@@ -268,6 +271,11 @@ int main(int argc, char *argv[])
       cerr << "                     Using this option may render some historical widgets unworkable (as they are based on fixed sizes)." << endl;
       cerr << "  --no-dSFMT         Tells GDL not to use double precision SIMD oriented Fast Mersenne Twister(dSFMT) for random doubles." << endl;
       cerr << "                     Also disable by setting the environment variable GDL_NO_DSFMT to a non-null value." << endl;
+      cerr << "  --no-blas          Tells GDL not to use the external BLAS/LAPACK (if compiled in) for matrix multiply and INVERT." << endl;
+      cerr << "                     Also disable by setting the environment variable GDL_NO_BLAS to a non-null value." << endl;
+      cerr << "                     Can be changed later with CPU, BLAS=0|1." << endl;
+      cerr << "  The environment variable GDL_SIMD (generic, avx2, avx512) limits the SIMD kernels used for" << endl;
+      cerr << "                     the array arithmetic, by default the best ones for the CPU (see !GDL.GDL_SIMD)." << endl;
 #ifdef _WIN32
       cerr << "  --posix (Windows only): paths will be posix paths (experimental)." << endl;
 #endif
@@ -364,6 +372,10 @@ int main(int argc, char *argv[])
       {
            useDSFMTAcceleration = false;
       }
+      else if (string(argv[a]) == "--no-blas")
+      {
+           useBLASBackend = false;
+      }
       else if (string(argv[a]) == "--widget-compat")
       {
           forceWxWidgetsUglyFonts = true;
@@ -457,6 +469,16 @@ int main(int argc, char *argv[])
   DStructGDL* gdlconfig = SysVar::GDLconfig();
   unsigned  DSFMTTag= gdlconfig->Desc()->TagIndex("GDL_USE_DSFMT");
   (*static_cast<DByteGDL*> (gdlconfig->GetTag(DSFMTTag, 0)))[0]=useDSFMTAcceleration;
+
+  //same for the BLAS/LAPACK backend
+  if (useBLASBackend && (GetEnvString("GDL_NO_BLAS").length() > 0)) useBLASBackend=false;
+  unsigned  BLASTag= gdlconfig->Desc()->TagIndex("GDL_USE_BLAS");
+  (*static_cast<DByteGDL*> (gdlconfig->GetTag(BLASTag, 0)))[0]=useBLASBackend;
+
+  //SIMD kernels selected for this CPU (and GDL_SIMD)
+  SimdInit();
+  unsigned  SIMDTag= gdlconfig->Desc()->TagIndex("GDL_SIMD");
+  (*static_cast<DStringGDL*> (gdlconfig->GetTag(SIMDTag, 0)))[0]=SimdName(SimdSelected());
   
   //same for use of wxwidgets
   unsigned  useWXTAG= gdlconfig->Desc()->TagIndex("GDL_USE_WX");
@@ -123,6 +123,7 @@ extern "C" {
 #include "gdlhelp.hpp"
 #include "nullgdl.hpp"
 #include "terminfo.hpp"
+#include "simd_dispatch.hpp"
 
 
 // for sorting compiled pro/fun lists by name
@@ -260,6 +261,8 @@ static void help_info()
 	    "look for *.pro files (e.g. in CVS in src/pro/)." << '\n';
 	  cout << '\n';
 	  cout << "* HELP, /KEYS for useful CLI keys shortcuts." << '\n';
+	  cout << '\n';
+	  cout << SimdInfo() << '\n';
 	  cout << '\n';
 		return;
 }
@@ -25,6 +25,7 @@
 #include "basic_fun.hpp"
 #include "gsl_fun.hpp"
 #include "dinterpreter.hpp"
+#include "matrix_batched.hpp"
 
 #include <gsl/gsl_sys.h>
 #include <gsl/gsl_linalg.h>
@@ -45,6 +46,9 @@ namespace lib {
 
   void ludc_pro( EnvT* e)
   {
+    // GDL extension: (n,n,m) stack of matrices
+    if (e->GetNumericParDefined(0)->Rank() == 3) { ludc_batched(e); return; }
+
     //  cout << szdbl << " " <<szflt << " " << szlng << " " szlng64 << endl;
 
     SizeT nParam=e->NParam(1);
@@ -139,6 +143,9 @@ namespace lib {
   
   BaseGDL* lusol_fun( EnvT* e)
   {
+    // GDL extension: (n,n,m) stack of matrices
+    if (e->GetNumericParDefined(0)->Rank() == 3) return lusol_batched(e);
+
     SizeT nParam=e->NParam(1);
 //    int s;
     
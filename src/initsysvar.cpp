@@ -690,6 +690,8 @@ namespace SysVar
 
     gdlStruct->NewTag("EPOCH", new DLongGDL((long) t_of_day));
     gdlStruct->NewTag("GDL_USE_DSFMT", new DByteGDL(1));
+    gdlStruct->NewTag("GDL_USE_BLAS", new DByteGDL(0));
+    gdlStruct->NewTag("GDL_SIMD", new DStringGDL(""));
     gdlStruct->NewTag("GDL_USE_WX", new DByteGDL(0));
 #ifdef _WIN32
     std::string use_posix=GetEnvString("GDL_USE_POSIX");
@@ -15,5 +15,491 @@
  *                                                                         *
  ***************************************************************************/
 
-//#include <lapackpp.h>
+// LA_EIGENQL, EIGENQL and LA_SVD: computed by LAPACK when GDL is compiled
+// with -DBLAS=ON and the backend is enabled (see blas_backend.hpp), by
+// Eigen3 otherwise. Float input stays in single precision.
+
+#include "includefirst.hpp"
+
+#include <cmath>
+#include <complex>
+#include <vector>
+#include <algorithm>
+
+#include "datatypes.hpp"
+#include "envt.hpp"
+#include "objects.hpp"
+#include "blas_backend.hpp"
+#include "lapack.hpp"
+
+#if defined(USE_EIGEN)
+#include <Eigen/Core>
+#include <Eigen/Cholesky>
+#include <Eigen/Eigenvalues>
+#include <Eigen/SVD>
+#endif
+
+namespace lib {
+
+  using namespace std;
+
+  namespace {
+
+    // GDL stores the IDL matrix A (column index first) so that the
+    // column-major view of the data is A^T: for the symmetric/Hermitian
+    // problems A^T = conj(A), the complex input is conjugated once.
+    template<typename T> inline T LaConj( T x) { return x;}
+    inline DComplex LaConj( DComplex x) { return std::conj( x);}
+    inline DComplexDbl LaConj( DComplexDbl x) { return std::conj( x);}
+
+    // keeps the eigenvalues (ascending) and eigenvector columns of the
+    // requested subset, as ?syevr does. Returns their number.
+    template<typename T, typename R>
+    SizeT SelectEigen( SizeT n, int range, SizeT il, SizeT iu, double vl, double vu, R* w, T* z)
+    {
+      SizeT nFound = 0;
+      for( SizeT i = 0; i < n; ++i)
+	{
+	  bool keep = true;
+	  if( range == 1) keep = (i >= il && i <= iu);
+	  else if( range == 2) keep = (w[ i] > vl && w[ i] <= vu);
+	  if( !keep) continue;
+	  if( nFound != i)
+	    {
+	      w[ nFound] = w[ i];
+	      if( z != NULL) std::copy( z + i * n, z + (i + 1) * n, z + nFound * n);
+	    }
+	  ++nFound;
+	}
+      return nFound;
+    }
+
+#if defined(USE_EIGEN)
+    template<typename T>
+    int EigenSymEigen( SizeT n, T* a, T* b, int itype, typename BlasType<T>::Real* w, T* z)
+    {
+      typedef Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic> Mat;
+      typedef Eigen::Matrix<typename BlasType<T>::Real, Eigen::Dynamic, 1> Vec;
+      Mat A = Eigen::Map<Mat>( a, n, n);
+      int options = (z != NULL) ? Eigen::ComputeEigenvectors : Eigen::EigenvaluesOnly;
+      if( b == NULL)
+	{
+	  Eigen::SelfAdjointEigenSolver<Mat> es( A, options);
+	  if( es.info() != Eigen::Success) return 1;
+	  Eigen::Map<Vec>( w, n) = es.eigenvalues();
+	  if( z != NULL) Eigen::Map<Mat>( z, n, n) = es.eigenvectors();
+	  return 0;
+	}
+      Mat B = Eigen::Map<Mat>( b, n, n);
+      // LAPACK's code for a B that is not positive definite
+      if( Eigen::LLT<Mat>( B).info() != Eigen::Success) return n + 1;
+      options |= (itype == 2) ? Eigen::ABx_lx : ((itype == 3) ? Eigen::BAx_lx : Eigen::Ax_lBx);
+      Eigen::GeneralizedSelfAdjointEigenSolver<Mat> es( A, B, options);
+      if( es.info() != Eigen::Success) return 1;
+      Eigen::Map<Vec>( w, n) = es.eigenvalues();
+      if( z != NULL) Eigen::Map<Mat>( z, n, n) = es.eigenvectors();
+      return 0;
+    }
+
+    template<typename T>
+    int EigenSVD( SizeT m, SizeT n, T* a, typename BlasType<T>::Real* s, T* u, T* vt)
+    {
+      typedef Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic> Mat;
+      typedef Eigen::Matrix<typename BlasType<T>::Real, Eigen::Dynamic, 1> Vec;
+      const SizeT k = std::min( m, n);
+      Mat A = Eigen::Map<Mat>( a, m, n);
+#if EIGEN_VERSION_AT_LEAST(3,3,0)
+      Eigen::BDCSVD<Mat> svd( A, Eigen::ComputeThinU | Eigen::ComputeThinV);
+#else
+      Eigen::JacobiSVD<Mat> svd( A, Eigen::ComputeThinU | Eigen::ComputeThinV);
+#endif
+      Eigen::Map<Vec>( s, k) = svd.singularValues();
+      Eigen::Map<Mat>( u, m, k) = svd.matrixU();
+      Eigen::Map<Mat>( vt, k, n) = svd.matrixV().adjoint();
+      return 0;
+    }
+#endif
+
+    // see LapackSymEigen() for the arguments
+    template<typename T>
+    int SymEigen( EnvT* e, SizeT n, T* a, T* b, int itype, bool divConquer,
+		  int range, SizeT il, SizeT iu, double vl, double vu, double abstol,
+		  typename BlasType<T>::Real* w, T* z, SizeT& nFound)
+    {
+      int info = LapackSymEigen<T>( n, a, b, itype, divConquer, range, il, iu, vl, vu, abstol, w, z, nFound);
+      if( info >= 0) return info;
+#if defined(USE_EIGEN)
+      info = EigenSymEigen<T>( n, a, b, itype, w, z);
+      nFound = (info == 0) ? SelectEigen( n, range, il, iu, vl, vu, w, z) : 0;
+      return info;
+#else
+      e->Throw( "GDL was compiled without support for Eigen3 or LAPACK");
+      return -1;
+#endif
+    }
+
+    // see LapackSVD() for the arguments
+    template<typename T>
+    int SVD( EnvT* e, SizeT m, SizeT n, T* a, bool divConquer,
+	     typename BlasType<T>::Real* s, T* u, T* vt)
+    {
+      int info = LapackSVD<T>( m, n, a, divConquer, s, u, vt);
+      if( info >= 0) return info;
+#if defined(USE_EIGEN)
+      return EigenSVD<T>( m, n, a, s, u, vt);
+#else
+      e->Throw( "GDL was compiled without support for Eigen3 or LAPACK");
+      return -1;
+#endif
+    }
+
+    template<class Data, class RData>
+    BaseGDL* LaEigenqlTyped( EnvT* e, BaseGDL* p0, BaseGDL* p1, int itype, bool divConquer,
+			     int range, SizeT il, SizeT iu, double vl, double vu, double abstol,
+			     BaseGDL** vectors, DLong& info)
+    {
+      typedef typename Data::Ty T;
+      typedef typename RData::Ty R;
+      const SizeT n = p0->Dim( 0);
+
+      Data* a = static_cast<Data*>( p0->Convert2( Data::t, BaseGDL::COPY));
+      Guard<Data> aGuard( a);
+      for( SizeT i = 0; i < n * n; ++i) (*a)[ i] = LaConj( (*a)[ i]);
+      Data* b = NULL;
+      Guard<Data> bGuard;
+      if( p1 != NULL)
+	{
+	  b = static_cast<Data*>( p1->Convert2( Data::t, BaseGDL::COPY));
+	  bGuard.Init( b);
+	  for( SizeT i = 0; i < n * n; ++i) (*b)[ i] = LaConj( (*b)[ i]);
+	}
+
+      vector<R> w( n);
+      vector<T> z;
+      if( vectors != NULL) z.resize( n * n);
+      SizeT nFound = 0;
+      info = SymEigen<T>( e, n, &(*a)[ 0], (b != NULL) ? &(*b)[ 0] : NULL, itype, divConquer,
+			  range, il, iu, vl, vu, abstol, &w[ 0], (vectors != NULL) ? &z[ 0] : NULL, nFound);
+      if( info != 0) return new RData( dimension( n));
+      if( nFound == 0)
+	e->Throw( "No eigenvalue in SEARCH_RANGE.");
+
+      RData* res = new RData( dimension( nFound), BaseGDL::NOZERO);
+      std::copy( w.begin(), w.begin() + nFound, &(*res)[ 0]);
+      if( vectors != NULL)
+	{
+	  // the eigenvectors are the rows: EIGENVECTORS[*,i]
+	  Data* vec = new Data( dimension( n, nFound), BaseGDL::NOZERO);
+	  std::copy( z.begin(), z.begin() + n * nFound, &(*vec)[ 0]);
+	  *vectors = vec;
+	}
+      return res;
+    }
+
+    template<class Data>
+    BaseGDL* EigenqlTyped( EnvT* e, BaseGDL* p0, bool absolute, bool ascending,
+			   BaseGDL** vectors, BaseGDL** residual)
+    {
+      typedef typename Data::Ty T;
+      const SizeT n = p0->Dim( 0);
+
+      Data* a = static_cast<Data*>( p0->Convert2( Data::t, BaseGDL::COPY));
+      Guard<Data> aGuard( a);
+      Data* orig = NULL;
+      Guard<Data> origGuard;
+      if( residual != NULL)
+	{
+	  orig = a->Dup();
+	  origGuard.Init( orig);
+	}
+
+      const bool needVectors = (vectors != NULL || residual != NULL);
+      vector<T> w( n);
+      vector<T> z;
+      if( needVectors) z.resize( n * n);
+      SizeT nFound = 0;
+      int info = SymEigen<T>( e, n, &(*a)[ 0], static_cast<T*>( NULL), 1, false, 0, 0, n - 1, 0., 0., 0.,
+			      &w[ 0], needVectors ? &z[ 0] : NULL, nFound);
+      if( info != 0)
+	e->Throw( "Eigenvalues failed to converge.");
+
+      // descending order unless /ASCENDING, on |lambda| with /ABSOLUTE
+      vector<SizeT> order( n);
+      for( SizeT i = 0; i < n; ++i) order[ i] = ascending ? i : n - 1 - i;
+      if( absolute)
+	{
+	  vector<T> key( n);
+	  for( SizeT i = 0; i < n; ++i) key[ i] = std::abs( w[ i]);
+	  for( SizeT i = 1; i < n; ++i)
+	    {
+	      SizeT o = order[ i];
+	      SizeT j = i;
+	      for( ; j > 0 && (ascending ? key[ order[ j - 1]] > key[ o] : key[ order[ j - 1]] < key[ o]); --j)
+		order[ j] = order[ j - 1];
+	      order[ j] = o;
+	    }
+	}
+
+      Data* res = new Data( dimension( n), BaseGDL::NOZERO);
+      for( SizeT i = 0; i < n; ++i) (*res)[ i] = w[ order[ i]];
+
+      if( vectors != NULL)
+	{
+	  Data* vec = new Data( dimension( n, n), BaseGDL::NOZERO);
+	  for( SizeT i = 0; i < n; ++i)
+	    std::copy( &z[ order[ i] * n], &z[ order[ i] * n] + n, &(*vec)[ i * n]);
+	  *vectors = vec;
+	}
+      if( residual != NULL)
+	{
+	  // RESIDUAL[*,i] = A ## x_i - lambda_i * x_i
+	  Data* resid = new Data( dimension( n, n), BaseGDL::NOZERO);
+	  const T* A = &(*orig)[ 0];
+#pragma omp parallel for if (n*n >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= n*n))
+	  for( OMPInt i = 0; i < n; ++i)
+	    {
+	      const T* x = &z[ order[ i] * n];
+	      const T lambda = w[ order[ i]];
+	      for( SizeT r = 0; r < n; ++r)
+		{
+		  T sum = 0;
+		  for( SizeT c = 0; c < n; ++c) sum += A[ c + r * n] * x[ c];
+		  (*resid)[ r + i * n] = sum - lambda * x[ r];
+		}
+	    }
+	  *residual = resid;
+	}
+      return res;
+    }
+
+    template<class Data, class RData>
+    void LaSvdTyped( EnvT* e, BaseGDL* p0, bool divConquer, DLong& info)
+    {
+      typedef typename Data::Ty T;
+      // with the IDL matrix A of ncol columns and nrow rows, the column-major
+      // view of the data is A^T = U' S V'^H (ncol x nrow), so A = U S V^H
+      // with U = conj(V') and V = conj(U'). U is V'^H as LAPACK returns it,
+      // only V needs a transpose.
+      const SizeT m = p0->Dim( 0);
+      const SizeT n = p0->Dim( 1);
+      const SizeT k = std::min( m, n);
+
+      Data* a = static_cast<Data*>( p0->Convert2( Data::t, BaseGDL::COPY));
+      Guard<Data> aGuard( a);
+      RData* w = new RData( dimension( k), BaseGDL::NOZERO);
+      Guard<RData> wGuard( w);
+      Data* u = new Data( dimension( k, n), BaseGDL::NOZERO);
+      Guard<Data> uGuard( u);
+      vector<T> up( m * k);
+
+      info = SVD<T>( e, m, n, &(*a)[ 0], divConquer, &(*w)[ 0], &up[ 0], &(*u)[ 0]);
+      if( info != 0) return;
+
+      Data* v = new Data( dimension( k, m), BaseGDL::NOZERO);
+      for( SizeT r = 0; r < m; ++r)
+	for( SizeT c = 0; c < k; ++c)
+	  (*v)[ c + r * k] = LaConj( up[ r + c * m]);
+
+      e->SetPar( 1, wGuard.release());
+      e->SetPar( 2, uGuard.release());
+      e->SetPar( 3, v);
+    }
+
+  } // namespace
+
+  BaseGDL* la_eigenql_fun( EnvT* e)
+  {
+    SizeT nParam = e->NParam( 1);
+
+    static int doubleIx = e->KeywordIx( "DOUBLE");
+    static int eigenvectorsIx = e->KeywordIx( "EIGENVECTORS");
+    static int generalizedIx = e->KeywordIx( "GENERALIZED");
+    static int methodIx = e->KeywordIx( "METHOD");
+    static int rangeIx = e->KeywordIx( "RANGE");
+    static int search_rangeIx = e->KeywordIx( "SEARCH_RANGE");
+    static int statusIx = e->KeywordIx( "STATUS");
+    static int toleranceIx = e->KeywordIx( "TOLERANCE");
+
+    BaseGDL* p0 = e->GetNumericParDefined( 0);
+    if( p0->Rank() != 2 || p0->Dim( 0) != p0->Dim( 1))
+      e->Throw( "Input must be a square matrix: " + e->GetParString( 0));
+    const SizeT n = p0->Dim( 0);
+
+    BaseGDL* p1 = NULL;
+    if( nParam > 1)
+      {
+	p1 = e->GetNumericParDefined( 1);
+	if( p1->Rank() != 2 || p1->Dim( 0) != n || p1->Dim( 1) != n)
+	  e->Throw( "Input must have the same dimensions as A: " + e->GetParString( 1));
+      }
+
+    bool isComplex = (p0->Type() == GDL_COMPLEX || p0->Type() == GDL_COMPLEXDBL);
+    bool isDouble = (p0->Type() == GDL_DOUBLE || p0->Type() == GDL_COMPLEXDBL);
+    if( p1 != NULL)
+      {
+	isComplex = isComplex || p1->Type() == GDL_COMPLEX || p1->Type() == GDL_COMPLEXDBL;
+	isDouble = isDouble || p1->Type() == GDL_DOUBLE || p1->Type() == GDL_COMPLEXDBL;
+      }
+    if( e->KeywordPresent( doubleIx)) isDouble = e->KeywordSet( doubleIx);
+
+    DLong itype = 1;
+    e->AssureLongScalarKWIfPresent( generalizedIx, itype);
+    if( itype < 1 || itype > 3)
+      e->Throw( "GENERALIZED must be 1, 2 or 3.");
+    DLong method = 0;
+    e->AssureLongScalarKWIfPresent( methodIx, method);
+    if( method < 0 || method > 2)
+      e->Throw( "METHOD must be 0, 1 or 2.");
+
+    int range = 0;
+    SizeT il = 0, iu = n - 1;
+    DDouble vl = 0, vu = 0;
+    if( e->KeywordPresent( rangeIx))
+      {
+	DLongGDL* r = e->GetKWAs<DLongGDL>( rangeIx);
+	if( r->N_Elements() != 2)
+	  e->Throw( "RANGE must be a 2-element vector.");
+	if( (*r)[ 0] < 0 || (*r)[ 1] < (*r)[ 0] || (*r)[ 1] >= static_cast<DLong>( n))
+	  e->Throw( "RANGE must be within [0," + i2s( n - 1) + "] and in increasing order.");
+	il = (*r)[ 0];
+	iu = (*r)[ 1];
+	range = 1;
+      }
+    if( e->KeywordPresent( search_rangeIx))
+      {
+	if( range != 0)
+	  e->Throw( "Conflicting keywords: RANGE and SEARCH_RANGE.");
+	DDoubleGDL* r = e->GetKWAs<DDoubleGDL>( search_rangeIx);
+	if( r->N_Elements() != 2)
+	  e->Throw( "SEARCH_RANGE must be a 2-element vector.");
+	vl = (*r)[ 0];
+	vu = (*r)[ 1];
+	if( !(vl < vu))
+	  e->Throw( "SEARCH_RANGE must be in increasing order.");
+	range = 2;
+      }
+    // divide and conquer computes the whole spectrum
+    if( method == 1 && range != 0)
+      e->Throw( "METHOD=1 cannot be used with RANGE or SEARCH_RANGE.");
+
+    DDouble tolerance = 0;
+    e->AssureDoubleScalarKWIfPresent( toleranceIx, tolerance);
+
+    BaseGDL* vectors = NULL;
+    BaseGDL** vectorsP = e->KeywordPresent( eigenvectorsIx) ? &vectors : NULL;
+    DLong info = 0;
+    BaseGDL* res;
+    if( isComplex)
+      {
+	if( isDouble)
+	  res = LaEigenqlTyped<DComplexDblGDL, DDoubleGDL>( e, p0, p1, itype, method == 1, range, il, iu,
+							    vl, vu, tolerance, vectorsP, info);
+	else
+	  res = LaEigenqlTyped<DComplexGDL, DFloatGDL>( e, p0, p1, itype, method == 1, range, il, iu,
+							vl, vu, tolerance, vectorsP, info);
+      }
+    else
+      {
+	if( isDouble)
+	  res = LaEigenqlTyped<DDoubleGDL, DDoubleGDL>( e, p0, p1, itype, method == 1, range, il, iu,
+							vl, vu, tolerance, vectorsP, info);
+	else
+	  res = LaEigenqlTyped<DFloatGDL, DFloatGDL>( e, p0, p1, itype, method == 1, range, il, iu,
+						      vl, vu, tolerance, vectorsP, info);
+      }
+
+    if( info != 0 && !e->KeywordPresent( statusIx))
+      {
+	delete res;
+	if( p1 != NULL && info > static_cast<DLong>( n))
+	  e->Throw( "B is not positive definite.");
+	e->Throw( "Eigenvalues failed to converge.");
+      }
+    if( e->KeywordPresent( statusIx))
+      e->SetKW( statusIx, new DLongGDL( info));
+    if( vectors != NULL)
+      e->SetKW( eigenvectorsIx, vectors);
+    return res;
+  }
+
+  BaseGDL* eigenql_fun( EnvT* e)
+  {
+    e->NParam( 1);
+
+    static int absoluteIx = e->KeywordIx( "ABSOLUTE");
+    static int ascendingIx = e->KeywordIx( "ASCENDING");
+    static int doubleIx = e->KeywordIx( "DOUBLE");
+    static int eigenvectorsIx = e->KeywordIx( "EIGENVECTORS");
+    static int residualIx = e->KeywordIx( "RESIDUAL");
+
+    BaseGDL* p0 = e->GetNumericParDefined( 0);
+    if( p0->Type() == GDL_COMPLEX || p0->Type() == GDL_COMPLEXDBL)
+      e->Throw( "Complex expression not allowed in this context: " + e->GetParString( 0));
+    if( p0->Rank() != 2 || p0->Dim( 0) != p0->Dim( 1))
+      e->Throw( "Input must be a square matrix: " + e->GetParString( 0));
+
+    bool isDouble = (p0->Type() == GDL_DOUBLE) || e->KeywordSet( doubleIx);
+    bool absolute = e->KeywordSet( absoluteIx);
+    bool ascending = e->KeywordSet( ascendingIx);
+
+    // /OVERWRITE is accepted: the input is always copied
+    BaseGDL* vectors = NULL;
+    BaseGDL* residual = NULL;
+    BaseGDL** vectorsP = e->KeywordPresent( eigenvectorsIx) ? &vectors : NULL;
+    BaseGDL** residualP = e->KeywordPresent( residualIx) ? &residual : NULL;
+    BaseGDL* res;
+    if( isDouble)
+      res = EigenqlTyped<DDoubleGDL>( e, p0, absolute, ascending, vectorsP, residualP);
+    else
+      res = EigenqlTyped<DFloatGDL>( e, p0, absolute, ascending, vectorsP, residualP);
+
+    if( vectors != NULL) e->SetKW( eigenvectorsIx, vectors);
+    if( residual != NULL) e->SetKW( residualIx, residual);
+    return res;
+  }
+
+  void la_svd_pro( EnvT* e)
+  {
+    e->NParam( 4);
+
+    static int doubleIx = e->KeywordIx( "DOUBLE");
+    static int divide_conquerIx = e->KeywordIx( "DIVIDE_CONQUER");
+    static int statusIx = e->KeywordIx( "STATUS");
+
+    BaseGDL* p0 = e->GetNumericParDefined( 0);
+    if( p0->Rank() != 2)
+      e->Throw( "Argument must be a 2-D matrix: " + e->GetParString( 0));
+
+    e->AssureGlobalPar( 1); // W
+    e->AssureGlobalPar( 2); // U
+    e->AssureGlobalPar( 3); // V
+
+    bool isComplex = (p0->Type() == GDL_COMPLEX || p0->Type() == GDL_COMPLEXDBL);
+    bool isDouble = (p0->Type() == GDL_DOUBLE || p0->Type() == GDL_COMPLEXDBL);
+    if( e->KeywordPresent( doubleIx)) isDouble = e->KeywordSet( doubleIx);
+    bool divConquer = e->KeywordSet( divide_conquerIx);
+
+    DLong info = 0;
+    if( isComplex)
+      {
+	if( isDouble)
+	  LaSvdTyped<DComplexDblGDL, DDoubleGDL>( e, p0, divConquer, info);
+	else
+	  LaSvdTyped<DComplexGDL, DFloatGDL>( e, p0, divConquer, info);
+      }
+    else
+      {
+	if( isDouble)
+	  LaSvdTyped<DDoubleGDL, DDoubleGDL>( e, p0, divConquer, info);
+	else
+	  LaSvdTyped<DFloatGDL, DFloatGDL>( e, p0, divConquer, info);
+      }
+
+    if( e->KeywordPresent( statusIx))
+      e->SetKW( statusIx, new DLongGDL( info));
+    else if( info != 0)
+      e->Throw( "SVD failed to converge.");
+  }
+
+} // namespace lib
 
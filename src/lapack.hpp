@@ -0,0 +1,32 @@
+/***************************************************************************
+                          lapack.hpp  -  lapack routines
+                             -------------------
+    begin                : Oct 2026
+    copyright            : (C) 2026 by the GDL team
+    email                :
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef LAPACK_HPP_
+#define LAPACK_HPP_
+
+#include "datatypes.hpp"
+#include "envt.hpp"
+
+namespace lib {
+
+  BaseGDL* la_eigenql_fun( EnvT* e);
+  BaseGDL* eigenql_fun( EnvT* e);
+  void la_svd_pro( EnvT* e);
+
+}
+
+#endif
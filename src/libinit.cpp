@@ -41,6 +41,8 @@
 #include "file.hpp"
 
 #include "gsl_fun.hpp"
+#include "lapack.hpp"
+#include "sparse.hpp"
 
 #include "where.hpp"
 #include "convol.hpp"
@@ -114,7 +116,9 @@ void LibInit()
 
 
   const string cpuKey[]={ "RESET","RESTORE","TPOOL_MAX_ELTS", "TPOOL_MIN_ELTS",
-					"TPOOL_NTHREADS","VECTOR_ENABLE",KLISTEND};
+					"TPOOL_NTHREADS","VECTOR_ENABLE",
+					"BLAS", //GDL extension
+					KLISTEND};
   new DLibPro(lib::cpu_pro,string("CPU"),0,cpuKey);
   
 // removed, see comments in basic_pro.cpp 
@@ -127,6 +131,27 @@ void LibInit()
   const string svdcKey[]={"COLUMN","ITMAX","DOUBLE",KLISTEND};
   new DLibPro(lib::svdc,string("SVDC"),4,svdcKey);
 
+  const string la_svdKey[]={"DOUBLE","DIVIDE_CONQUER","STATUS",KLISTEND};
+  new DLibPro(lib::la_svd_pro,string("LA_SVD"),4,la_svdKey);
+  const string la_eigenqlKey[]={"DOUBLE","EIGENVECTORS","GENERALIZED","METHOD",
+				"RANGE","SEARCH_RANGE","STATUS","TOLERANCE",KLISTEND};
+  const string la_eigenqlWarnKey[]={"FAILED",KLISTEND};
+  new DLibFunRetNew(lib::la_eigenql_fun,string("LA_EIGENQL"),2,la_eigenqlKey,la_eigenqlWarnKey);
+  const string eigenqlKey[]={"ABSOLUTE","ASCENDING","DOUBLE","EIGENVECTORS",
+			     "OVERWRITE","RESIDUAL",KLISTEND};
+  new DLibFunRetNew(lib::eigenql_fun,string("EIGENQL"),1,eigenqlKey);
+
+  const string sprsinKey[]={"COLUMN","DOUBLE","THRESHOLD",KLISTEND};
+  new DLibFunRetNew(lib::sprsin_fun,string("SPRSIN"),4,sprsinKey);
+  new DLibFunRetNew(lib::fulstr_fun,string("FULSTR"),1);
+  const string sprsaxKey[]={"DOUBLE",KLISTEND};
+  new DLibFunRetNew(lib::sprsax_fun,string("SPRSAX"),2,sprsaxKey);
+  const string sprsabKey[]={"DOUBLE","THRESHOLD",KLISTEND};
+  new DLibFunRetNew(lib::sprsab_fun,string("SPRSAB"),2,sprsabKey);
+  new DLibFunRetNew(lib::sprstp_fun,string("SPRSTP"),1);
+  const string linbcgKey[]={"DOUBLE","ITOL","TOL","ITER","ITMAX",KLISTEND};
+  new DLibFunRetNew(lib::linbcg_fun,string("LINBCG"),3,linbcgKey);
+
   new DLibFunRetNew(lib::temporary_fun,string("TEMPORARY"),1);
   
   new DLibFunRetNew(lib::terminal_size_fun,string("TERMINAL_SIZE"),2);
@@ -175,7 +200,10 @@ void LibInit()
   new DLibFunRetNew(lib::rebin_fun,string("REBIN"),9,rebinKey);
 
   const string convolKey[]={"CENTER","EDGE_TRUNCATE","EDGE_WRAP","EDGE_ZERO", "EDGE_MIRROR",
-			    "BIAS","NORMALIZE","NAN", "INVALID", "MISSING",KLISTEND};
+			    "BIAS","NORMALIZE","NAN", "INVALID", "MISSING",
+			    "FFT", //GDL extension
+			    "SEPARABLE", //GDL extension
+			    KLISTEND};
   new DLibFunRetNew(lib::convol_fun,string("CONVOL"),3,convolKey);
 
   const string smoothKey[]={"NAN", "EDGE_MIRROR", "EDGE_WRAP","EDGE_TRUNCATE", "EDGE_ZERO", "MISSING", KLISTEND};
@@ -279,6 +307,10 @@ void LibInit()
   new DLibFunRetNew(lib::sort_fun,string("SORT"),1,sortKey,NULL,true);
   const string gdlsortKey[]={"L64","QUICK","MERGE","RADIX","INSERT","AUTO",KLISTEND}; //,"CHECK"
   new DLibFunRetNew(lib::gdl_sort_fun,string("GDL_SORT"),1,gdlsortKey,NULL,true);
+  const string uniqKey[]={"UNSORTED",KLISTEND}; //UNSORTED is a GDL extension
+  new DLibFunRetNew(lib::uniq_fun,string("UNIQ"),2,uniqKey,NULL,true);
+  const string value_locateKey[]={"L64",KLISTEND};
+  new DLibFunRetNew(lib::value_locate_fun,string("VALUE_LOCATE"),2,value_locateKey,NULL,true);
 
   const string medianKey[]={"EVEN","DOUBLE","DIMENSION",KLISTEND};
   new DLibFunRetNew(lib::median,string("MEDIAN"),2,medianKey);
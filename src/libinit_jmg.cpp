@@ -104,7 +104,9 @@ void LibInit_jmg()
 
 #if defined(HAVE_LIBGSL) && defined(HAVE_LIBGSLCBLAS)
   
-  const string invertKey[]={"DOUBLE","GSL","EIGEN",KLISTEND};
+  const string invertKey[]={"DOUBLE","GSL","EIGEN",
+			     "LAPACK", //GDL extension
+			     KLISTEND};
   new DLibFunRetNew(lib::AC_invert_fun,string("INVERT"),2,invertKey);
 
   // if FFTw not available, FFT in the GSL used (slower)
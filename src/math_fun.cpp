@@ -34,6 +34,7 @@
 #include "math_utl.hpp"
 #include "math_fun.hpp"
 #include "dinterpreter.hpp"
+#include "simd_dispatch.hpp"
 
 //#define GDL_DEBUG
 #undef GDL_DEBUG
@@ -632,6 +633,7 @@ namespace lib {
         (*res)[0] = sin ((*p0C)[0]);
         return res;
       }
+    if (SimdMath(SIMD_SIN, &(*res)[0], &(*p0C)[0], nEl)) return res;
 #pragma omp parallel for if (nEl >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= nEl))
     for (SizeT i = 0; i < nEl; ++i) (*res)[ i] = sin ((*p0C)[ i]);
     return res;
@@ -647,6 +649,7 @@ namespace lib {
         (*p0C)[0] = sin ((*p0C)[0]);
         return p0;
       }
+    if (SimdMath(SIMD_SIN, &(*p0C)[0], &(*p0C)[0], nEl)) return p0;
 #pragma omp parallel for if (nEl >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= nEl))
     for (SizeT i = 0; i < nEl; ++i) (*p0C)[ i] = sin ((*p0C)[ i]);
     return p0;
@@ -668,6 +671,7 @@ namespace lib {
     else
       {
         DFloatGDL* res = static_cast<DFloatGDL*> (p0->Convert2 (GDL_FLOAT, BaseGDL::COPY));
+        if (SimdMath(SIMD_SIN, &(*res)[0], &(*res)[0], nEl)) return res;
 #pragma omp parallel for if (nEl >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= nEl))
         for (SizeT i = 0; i < nEl; ++i)(*res)[ i] = sin ((*res)[ i]);
         return res;
@@ -684,6 +688,7 @@ namespace lib {
       (*res)[0] = cos((*p0C)[0]);
       return res;
     }
+    if (SimdMath(SIMD_COS, &(*res)[0], &(*p0C)[0], nEl)) return res;
 #pragma omp parallel for if (nEl >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= nEl))
     for (SizeT i = 0; i < nEl; ++i) (*res)[ i] = cos((*p0C)[ i]);
     return res;
@@ -697,6 +702,7 @@ namespace lib {
       (*p0C)[0] = cos((*p0C)[0]);
       return p0;
     }
+    if (SimdMath(SIMD_COS, &(*p0C)[0], &(*p0C)[0], nEl)) return p0;
 #pragma omp parallel for if (nEl >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= nEl))
     for (SizeT i = 0; i < nEl; ++i) (*p0C)[ i] = cos((*p0C)[ i]);
     return p0;
@@ -720,6 +726,7 @@ namespace lib {
       else return cos_fun_template_grab< DFloatGDL>(p0);
     else {
       DFloatGDL* res = static_cast<DFloatGDL*> (p0->Convert2(GDL_FLOAT, BaseGDL::COPY));
+      if (SimdMath(SIMD_COS, &(*res)[0], &(*res)[0], nEl)) return res;
 #pragma omp parallel for if (nEl >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= nEl))
       for (SizeT i = 0; i < nEl; ++i)(*res)[ i] = cos((*res)[ i]);
       return res;
@@ -736,6 +743,7 @@ namespace lib {
       (*res)[0] = tan((*p0C)[0]);
       return res;
     }
+    if (SimdMath(SIMD_TAN, &(*res)[0], &(*p0C)[0], nEl)) return res;
 #pragma omp parallel for if (nEl >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= nEl))
     for (SizeT i = 0; i < nEl; ++i) (*res)[ i] = tan((*p0C)[ i]);
     return res;
@@ -749,6 +757,7 @@ namespace lib {
       (*p0C)[0] = tan((*p0C)[0]);
       return p0;
     }
+    if (SimdMath(SIMD_TAN, &(*p0C)[0], &(*p0C)[0], nEl)) return p0;
 #pragma omp parallel for if (nEl >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= nEl))
     for (SizeT i = 0; i < nEl; ++i) (*p0C)[ i] = tan((*p0C)[ i]);
     return p0;
@@ -772,6 +781,7 @@ namespace lib {
       else return tan_fun_template_grab< DFloatGDL>(p0);
     else {
       DFloatGDL* res = static_cast<DFloatGDL*> (p0->Convert2(GDL_FLOAT, BaseGDL::COPY));
+      if (SimdMath(SIMD_TAN, &(*res)[0], &(*res)[0], nEl)) return res;
 #pragma omp parallel for if (nEl >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= nEl))
       for (SizeT i = 0; i < nEl; ++i)(*res)[ i] = tan((*res)[ i]);
       return res;
@@ -1042,6 +1052,7 @@ namespace lib {
       (*res)[0] = exp((*p0C)[0]);
       return res;
     }
+    if (SimdMath(SIMD_EXP, &(*res)[0], &(*p0C)[0], nEl)) return res;
 #pragma omp parallel for if (nEl >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= nEl))
     for (SizeT i = 0; i < nEl; ++i) (*res)[ i] = exp((*p0C)[ i]);
     return res;
@@ -1055,6 +1066,7 @@ namespace lib {
       (*p0C)[0] = exp((*p0C)[0]);
       return p0;
     }
+    if (SimdMath(SIMD_EXP, &(*p0C)[0], &(*p0C)[0], nEl)) return p0;
 #pragma omp parallel for if (nEl >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= nEl))
     for (SizeT i = 0; i < nEl; ++i) (*p0C)[ i] = exp((*p0C)[ i]);
     return p0;
@@ -1078,6 +1090,7 @@ namespace lib {
       else return exp_fun_template_grab< DFloatGDL>(p0);
     else {
       DFloatGDL* res = static_cast<DFloatGDL*> (p0->Convert2(GDL_FLOAT, BaseGDL::COPY));
+      if (SimdMath(SIMD_EXP, &(*res)[0], &(*res)[0], nEl)) return res;
 #pragma omp parallel for if (nEl >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= nEl))
       for (SizeT i = 0; i < nEl; ++i)(*res)[ i] = exp((*res)[ i]);
       return res;
@@ -1583,6 +1596,7 @@ namespace lib {
             (*res)[ 0] = atan((*p0D)[ 0]);
             return res;
           }
+          if (SimdMath(SIMD_ATAN, &(*res)[0], &(*p0D)[0], nEl)) return res;
 #pragma omp parallel for if (nEl >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= nEl))
           for (SizeT i = 0; i < nEl; ++i) (*res)[ i] = atan((*p0D)[i]);
           return res;
@@ -1593,6 +1607,7 @@ namespace lib {
             (*res)[ 0] = atan((*p0F)[ 0]);
             return res;
           }
+          if (SimdMath(SIMD_ATAN, &(*res)[0], &(*p0F)[0], nEl)) return res;
 #pragma omp parallel for if (nEl >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= nEl))
           for (SizeT i = 0; i < nEl; ++i) (*res)[ i] = atan((*p0F)[i]);
           return res;
@@ -1622,6 +1637,7 @@ namespace lib {
             (*res)[ 0] = atan((*res)[ 0]);
             return res;
           }
+          if (SimdMath(SIMD_ATAN, &(*res)[0], &(*res)[0], nEl)) return res;
 #pragma omp parallel for if (nEl >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= nEl))
           for (SizeT i = 0; i < nEl; ++i) (*res)[ i] = atan((*res)[i]);
           return res;
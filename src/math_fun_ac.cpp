@@ -188,6 +188,7 @@
 #include "includefirst.hpp"
 #include "initsysvar.hpp"  // Used to define Double Infinity and Double NaN
 #include "math_fun_ac.hpp"
+#include "matrix_batched.hpp"
 #include <gsl/gsl_sf_bessel.h>
 
 #ifdef _MSC_VER
@@ -1383,11 +1384,13 @@ namespace lib {
     bool at = e->KeywordSet(atIx);
     bool bt = e->KeywordSet(btIx);
 
-    if (a->Rank() > 2)
+    // GDL extension: stacks of matrices as (n1,n2,m) arrays
+    bool batched = (a->Rank() == 3 || b->Rank() == 3);
+    if (a->Rank() > 2 && !batched)
       {
 	e->Throw("Array must have 1 or 2 dimensions: " + e->GetParString(0));
       }
-    if (b->Rank() > 2)
+    if (b->Rank() > 2 && !batched)
       {
 	e->Throw("Array must have 1 or 2 dimensions: " + e->GetParString(1));
       }
@@ -1421,6 +1424,8 @@ namespace lib {
 	  }
       }
 
+    if (batched) return matrix_multiply_batched(e, a, b, at, bt);
+
     // might use eigen3
     return a->MatrixOp( b, at, bt);
   }
@@ -0,0 +1,554 @@
+/***************************************************************************
+                          matrix_batched.cpp  -  linear algebra on stacks
+                                                 of small matrices
+                             -------------------
+    begin                : Oct 2026
+    copyright            : (C) 2026 by the GDL team
+    email                :
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "includefirst.hpp"
+
+#include <cmath>
+#include <complex>
+#include <vector>
+#include <limits>
+#include <algorithm>
+
+#include "datatypes.hpp"
+#include "envt.hpp"
+#include "dinterpreter.hpp"
+#include "matrix_batched.hpp"
+
+// sizes for which the kernels are instantiated with a compile-time size
+#define BATCHED_MAX_FIXED_N 8
+
+// calls FUN<T,n> for 2 <= n <= BATCHED_MAX_FIXED_N, FUN<T,0> (run-time size) otherwise
+#define BATCHED_DISPATCH( FUN, T, n, ARGS)	\
+  switch( n) {					\
+  case 2: FUN<T,2> ARGS; break;			\
+  case 3: FUN<T,3> ARGS; break;			\
+  case 4: FUN<T,4> ARGS; break;			\
+  case 5: FUN<T,5> ARGS; break;			\
+  case 6: FUN<T,6> ARGS; break;			\
+  case 7: FUN<T,7> ARGS; break;			\
+  case 8: FUN<T,8> ARGS; break;			\
+  default: FUN<T,0> ARGS;			\
+  }
+
+namespace lib {
+
+  using namespace std;
+
+  namespace {
+
+    template<typename T> struct BatchedReal { typedef T type;};
+    template<> struct BatchedReal<DComplex> { typedef DFloat type;};
+    template<> struct BatchedReal<DComplexDbl> { typedef DDouble type;};
+
+    // All factorizations use the row-major view a[i*n+j] (i.e. the GDL
+    // element A[j,i]), as the GSL based LUDC/LUSOL and the Eigen based
+    // CHOLDC/CHOLSOL do, so that results are interchangeable with them.
+
+    // LU with partial pivoting: P A = L U, L unit lower, both stored in a.
+    // perm is a gsl_permutation-like vector (row i of P A is row perm[i] of A).
+    // returns 0, 1 if a pivot is exactly zero, 2 if a pivot is tiny wrt. the
+    // largest element (accuracy probably lost)
+    template<typename T, int N>
+    inline int BatchedLU( T* a, SizeT nRun, DLong* perm)
+    {
+      typedef typename BatchedReal<T>::type R;
+      const SizeT n = (N > 0) ? N : nRun;
+
+      R aMax = 0;
+      for( SizeT i = 0; i < n * n; ++i) aMax = max( aMax, static_cast<R>( abs( a[i])));
+      const R tiny = aMax * n * numeric_limits<R>::epsilon();
+
+      for( SizeT i = 0; i < n; ++i) perm[i] = i;
+      int status = 0;
+      for( SizeT j = 0; j < n; ++j)
+	{
+	  SizeT p = j;
+	  R big = abs( a[j * n + j]);
+	  for( SizeT i = j + 1; i < n; ++i)
+	    {
+	      R v = abs( a[i * n + j]);
+	      if( v > big) { big = v; p = i;}
+	    }
+	  if( p != j)
+	    {
+	      for( SizeT k = 0; k < n; ++k) swap( a[j * n + k], a[p * n + k]);
+	      swap( perm[j], perm[p]);
+	    }
+	  if( big == 0) { status = 1; continue;}
+	  if( big <= tiny && status == 0) status = 2;
+
+	  const T inv = T( 1) / a[j * n + j];
+	  for( SizeT i = j + 1; i < n; ++i)
+	    {
+	      const T l = (a[i * n + j] *= inv);
+	      for( SizeT k = j + 1; k < n; ++k) a[i * n + k] -= l * a[j * n + k];
+	    }
+	}
+      return status;
+    }
+
+    // solves A x = b from the BatchedLU() factors
+    template<typename T, int N>
+    inline void BatchedLUSolve( const T* lu, SizeT nRun, const DLong* perm, const T* b, T* x)
+    {
+      const SizeT n = (N > 0) ? N : nRun;
+      for( SizeT i = 0; i < n; ++i)
+	{
+	  T s = b[perm[i]];
+	  for( SizeT k = 0; k < i; ++k) s -= lu[i * n + k] * x[k];
+	  x[i] = s;
+	}
+      for( SizeT i = n; i-- > 0;)
+	{
+	  T s = x[i];
+	  for( SizeT k = i + 1; k < n; ++k) s -= lu[i * n + k] * x[k];
+	  x[i] = s / lu[i * n + i];
+	}
+    }
+
+    // in-place inverse from BatchedLU(), solving directly into the columns
+    // of a; returns the BatchedLU() status, a is zeroed if singular.
+    // fixed sizes work on local arrays, luBuf/permBuf (n*n and n) otherwise
+    template<typename T, int N>
+    inline int BatchedInvert( T* a, SizeT nRun, T* luBuf, DLong* permBuf)
+    {
+      const SizeT n = (N > 0) ? N : nRun;
+      T luLoc[(N > 0) ? N * N : 1];
+      DLong permLoc[(N > 0) ? N : 1];
+      T* lu = (N > 0) ? luLoc : luBuf;
+      DLong* perm = (N > 0) ? permLoc : permBuf;
+
+      copy( a, a + n * n, lu);
+      int status = BatchedLU<T,N>( lu, n, perm);
+      if( status == 1)
+	{
+	  fill( a, a + n * n, T( 0));
+	  return status;
+	}
+      for( SizeT j = 0; j < n; ++j)
+	{
+	  // L y = P e_j, then U x = y
+	  for( SizeT i = 0; i < n; ++i)
+	    {
+	      T s = (perm[i] == static_cast<DLong>( j)) ? T( 1) : T( 0);
+	      for( SizeT k = 0; k < i; ++k) s -= lu[i * n + k] * a[k * n + j];
+	      a[i * n + j] = s;
+	    }
+	  for( SizeT i = n; i-- > 0;)
+	    {
+	      T s = a[i * n + j];
+	      for( SizeT k = i + 1; k < n; ++k) s -= lu[i * n + k] * a[k * n + j];
+	      a[i * n + j] = s / lu[i * n + i];
+	    }
+	}
+      return status;
+    }
+
+    // Cholesky A = L L^T (Numerical Recipes choldc convention): uses the
+    // upper triangle of a, returns L below the diagonal of a and its
+    // diagonal in p, the upper triangle is left untouched.
+    template<typename T, int N>
+    inline bool BatchedCholesky( T* a, SizeT nRun, T* p)
+    {
+      const SizeT n = (N > 0) ? N : nRun;
+      for( SizeT i = 0; i < n; ++i)
+	for( SizeT j = i; j < n; ++j)
+	  {
+	    T s = a[i * n + j];
+	    for( SizeT k = 0; k < i; ++k) s -= a[i * n + k] * a[j * n + k];
+	    if( i == j)
+	      {
+		if( !(s > 0)) return false;
+		p[i] = sqrt( s);
+	      }
+	    else
+	      a[j * n + i] = s / p[i];
+	  }
+      return true;
+    }
+
+    // solves A x = b from the BatchedCholesky() factors
+    template<typename T, int N>
+    inline void BatchedCholSolve( const T* a, SizeT nRun, const T* p, const T* b, T* x)
+    {
+      const SizeT n = (N > 0) ? N : nRun;
+      for( SizeT i = 0; i < n; ++i)
+	{
+	  T s = b[i];
+	  for( SizeT k = 0; k < i; ++k) s -= a[i * n + k] * x[k];
+	  x[i] = s / p[i];
+	}
+      for( SizeT i = n; i-- > 0;)
+	{
+	  T s = x[i];
+	  for( SizeT k = i + 1; k < n; ++k) s -= a[k * n + i] * x[k];
+	  x[i] = s / p[i];
+	}
+    }
+
+    // c(m,n) = op(a) # op(b) in the column-major GDL layout (see MatrixOp):
+    // op(a) is (m x k), op(b) is (k x n). N > 0 only for m == k == n == N.
+    template<typename T, int N>
+    inline void BatchedGemm( bool at, bool bt, SizeT mRun, SizeT kRun, SizeT nRun,
+			     const T* a, const T* b, T* c)
+    {
+      const SizeT m = (N > 0) ? N : mRun;
+      const SizeT k = (N > 0) ? N : kRun;
+      const SizeT n = (N > 0) ? N : nRun;
+      for( SizeT j = 0; j < n; ++j)
+	{
+	  T* cj = c + j * m;
+	  for( SizeT i = 0; i < m; ++i) cj[i] = 0;
+	  for( SizeT l = 0; l < k; ++l)
+	    {
+	      const T blj = bt ? b[j + l * n] : b[l + j * k];
+	      if( !at)
+		{
+		  const T* al = a + l * m;
+		  for( SizeT i = 0; i < m; ++i) cj[i] += al[i] * blj;
+		}
+	      else
+		for( SizeT i = 0; i < m; ++i) cj[i] += a[l + i * k] * blj;
+	    }
+	}
+    }
+
+    // --- loops over the stacks, in parallel ----------------------------
+
+    template<typename T, int N>
+    void InvertStack( T* data, SizeT n, SizeT m, DLong* status)
+    {
+      const SizeT nn = n * n;
+      SizeT nOp = m * nn * n;
+#pragma omp parallel if (nOp >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= nOp))
+      {
+	// only used by the run-time size kernel
+	vector<T> lu( (N > 0) ? 1 : nn);
+	vector<DLong> perm( (N > 0) ? 1 : n);
+#pragma omp for
+	for( OMPInt s = 0; s < m; ++s)
+	  status[s] = BatchedInvert<T,N>( data + s * nn, n, &lu[0], &perm[0]);
+      }
+    }
+
+    template<typename T, int N>
+    void LUStack( T* data, SizeT n, SizeT m, DLong* perm)
+    {
+      const SizeT nn = n * n;
+      SizeT nOp = m * nn * n;
+#pragma omp parallel for if (nOp >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= nOp))
+      for( OMPInt s = 0; s < m; ++s)
+	BatchedLU<T,N>( data + s * nn, n, perm + s * n);
+    }
+
+    template<typename T, int N>
+    void LUSolveStack( const T* lu, SizeT n, SizeT m, const DLong* perm, const T* b, T* x)
+    {
+      const SizeT nn = n * n;
+      SizeT nOp = m * nn;
+#pragma omp parallel for if (nOp >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= nOp))
+      for( OMPInt s = 0; s < m; ++s)
+	BatchedLUSolve<T,N>( lu + s * nn, n, perm + s * n, b + s * n, x + s * n);
+    }
+
+    template<typename T, int N>
+    void CholeskyStack( T* data, SizeT n, SizeT m, T* p, char* ok)
+    {
+      const SizeT nn = n * n;
+      SizeT nOp = m * nn * n;
+#pragma omp parallel for if (nOp >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= nOp))
+      for( OMPInt s = 0; s < m; ++s)
+	ok[s] = BatchedCholesky<T,N>( data + s * nn, n, p + s * n);
+    }
+
+    template<typename T, int N>
+    void CholSolveStack( const T* a, SizeT n, SizeT m, const T* p, const T* b, T* x)
+    {
+      const SizeT nn = n * n;
+      SizeT nOp = m * nn;
+#pragma omp parallel for if (nOp >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= nOp))
+      for( OMPInt s = 0; s < m; ++s)
+	BatchedCholSolve<T,N>( a + s * nn, n, p + s * n, b + s * n, x + s * n);
+    }
+
+    // aStride/bStride are 0 for an operand applied to every matrix of the other stack
+    template<typename T, int N>
+    void GemmStack( bool at, bool bt, SizeT mm, SizeT kk, SizeT nn, SizeT m,
+		    const T* a, SizeT aStride, const T* b, SizeT bStride, T* c)
+    {
+      const SizeT cStride = mm * nn;
+      SizeT nOp = m * mm * kk * nn;
+#pragma omp parallel for if (nOp >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= nOp))
+      for( OMPInt s = 0; s < m; ++s)
+	BatchedGemm<T,N>( at, bt, mm, kk, nn, a + s * aStride, b + s * bStride, c + s * cStride);
+    }
+
+    // --- typed drivers ---------------------------------------------------
+
+    template<class Data>
+    BaseGDL* InvertTyped( BaseGDL* p0, DType type, SizeT n, SizeT m, DLong* status)
+    {
+      typedef typename Data::Ty Ty;
+      Data* res = static_cast<Data*>( p0->Convert2( type, BaseGDL::COPY));
+      Guard<Data> resGuard( res);
+      BATCHED_DISPATCH( InvertStack, Ty, n, (&(*res)[0], n, m, status))
+      return resGuard.release();
+    }
+
+    template<class Data>
+    BaseGDL* MultiplyTyped( BaseGDL* a, BaseGDL* b, bool at, bool bt,
+			    SizeT mm, SizeT kk, SizeT nn, SizeT m, bool aStack, bool bStack)
+    {
+      typedef typename Data::Ty Ty;
+      Data* aD = static_cast<Data*>( a);
+      Data* bD = static_cast<Data*>( b);
+      SizeT resDim[3] = { mm, nn, m};
+      Data* res = new Data( dimension( resDim, 3), BaseGDL::NOZERO);
+      SizeT aStride = aStack ? mm * kk : 0;
+      SizeT bStride = bStack ? kk * nn : 0;
+      if( mm == kk && kk == nn)
+	{
+	  BATCHED_DISPATCH( GemmStack, Ty, mm,
+			    (at, bt, mm, kk, nn, m, &(*aD)[0], aStride, &(*bD)[0], bStride, &(*res)[0]))
+	}
+      else
+	GemmStack<Ty,0>( at, bt, mm, kk, nn, m, &(*aD)[0], aStride, &(*bD)[0], bStride, &(*res)[0]);
+      return res;
+    }
+
+    template<class Data>
+    void LUDCTyped( EnvT* e, BaseGDL* p0, DType type, SizeT n, SizeT m)
+    {
+      typedef typename Data::Ty Ty;
+      Data* res = static_cast<Data*>( p0->Convert2( type, BaseGDL::COPY));
+      Guard<Data> resGuard( res);
+      DLongGDL* perm = new DLongGDL( dimension( n, m), BaseGDL::NOZERO);
+      Guard<DLongGDL> permGuard( perm);
+      BATCHED_DISPATCH( LUStack, Ty, n, (&(*res)[0], n, m, &(*perm)[0]))
+      e->SetPar( 0, resGuard.release());
+      e->SetPar( 1, permGuard.release());
+    }
+
+    template<class Data>
+    BaseGDL* LUSolTyped( EnvT* e, SizeT n, SizeT m, DLongGDL* perm)
+    {
+      typedef typename Data::Ty Ty;
+      Data* lu = e->GetParAs<Data>( 0);
+      Data* b = e->GetParAs<Data>( 2);
+      Data* res = new Data( dimension( n, m), BaseGDL::NOZERO);
+      BATCHED_DISPATCH( LUSolveStack, Ty, n, (&(*lu)[0], n, m, &(*perm)[0], &(*b)[0], &(*res)[0]))
+      return res;
+    }
+
+    template<class Data>
+    void CholDCTyped( EnvT* e, BaseGDL* p0, DType type, SizeT n, SizeT m)
+    {
+      typedef typename Data::Ty Ty;
+      Data* res = static_cast<Data*>( p0->Convert2( type, BaseGDL::COPY));
+      Guard<Data> resGuard( res);
+      Data* p = new Data( dimension( n, m), BaseGDL::NOZERO);
+      Guard<Data> pGuard( p);
+      vector<char> ok( m);
+      BATCHED_DISPATCH( CholeskyStack, Ty, n, (&(*res)[0], n, m, &(*p)[0], &ok[0]))
+      for( SizeT s = 0; s < m; ++s)
+	if( !ok[s])
+	  e->Throw( "Array is not positive definite: " + e->GetParString( 0) +
+		    " (matrix " + i2s( s) + ")");
+      e->SetPar( 0, resGuard.release());
+      e->SetPar( 1, pGuard.release());
+    }
+
+    template<class Data>
+    BaseGDL* CholSolTyped( EnvT* e, SizeT n, SizeT m)
+    {
+      typedef typename Data::Ty Ty;
+      Data* a = e->GetParAs<Data>( 0);
+      Data* p = e->GetParAs<Data>( 1);
+      Data* b = e->GetParAs<Data>( 2);
+      Data* res = new Data( dimension( n, m), BaseGDL::NOZERO);
+      BATCHED_DISPATCH( CholSolveStack, Ty, n, (&(*a)[0], n, m, &(*p)[0], &(*b)[0], &(*res)[0]))
+      return res;
+    }
+
+    // (n,n,m) first argument, returns n and m
+    void BatchedCheckStack( EnvT* e, BaseGDL* p0, SizeT& n, SizeT& m)
+    {
+      if( p0->Rank() != 3 || p0->Dim( 0) != p0->Dim( 1))
+	e->Throw( "Input must be a square matrix or a stack of square matrices: " + e->GetParString( 0));
+      n = p0->Dim( 0);
+      m = p0->Dim( 2);
+    }
+
+    // one vector of n elements per matrix
+    void BatchedCheckVectors( EnvT* e, SizeT ix, SizeT n, SizeT m)
+    {
+      BaseGDL* p = e->GetNumericParDefined( ix);
+      if( p->N_Elements() != n * m)
+	e->Throw( "Arguments sizes mismatch: " + e->GetParString( ix) + " must have " +
+		  i2s( n) + " x " + i2s( m) + " elements.");
+    }
+
+  } // namespace
+
+  BaseGDL* invert_batched( EnvT* e, bool hasDouble)
+  {
+    BaseGDL* p0 = e->GetNumericParDefined( 0);
+    SizeT n, m;
+    BatchedCheckStack( e, p0, n, m);
+
+    SizeT nParam = e->NParam( 1);
+    if( nParam == 2) e->AssureGlobalPar( 1);
+
+    DLongGDL* status = new DLongGDL( dimension( m), BaseGDL::NOZERO);
+    Guard<DLongGDL> statusGuard( status);
+
+    BaseGDL* res;
+    if( p0->Type() == GDL_COMPLEXDBL)
+      res = InvertTyped<DComplexDblGDL>( p0, GDL_COMPLEXDBL, n, m, &(*status)[0]);
+    else if( p0->Type() == GDL_COMPLEX)
+      res = InvertTyped<DComplexGDL>( p0, GDL_COMPLEX, n, m, &(*status)[0]);
+    else if( p0->Type() == GDL_DOUBLE || hasDouble)
+      res = InvertTyped<DDoubleGDL>( p0, GDL_DOUBLE, n, m, &(*status)[0]);
+    else
+      res = InvertTyped<DFloatGDL>( p0, GDL_FLOAT, n, m, &(*status)[0]);
+
+    if( nParam == 2) e->SetPar( 1, statusGuard.release());
+    return res;
+  }
+
+  void ludc_batched( EnvT* e)
+  {
+    e->NParam( 2);
+    BaseGDL* p0 = e->GetNumericParDefined( 0);
+    SizeT n, m;
+    BatchedCheckStack( e, p0, n, m);
+    e->AssureGlobalPar( 1);
+
+    if( p0->Type() == GDL_COMPLEXDBL || p0->Type() == GDL_COMPLEX)
+      e->Throw( "Input type cannot be COMPLEX, please use LA_LUDC (not ready)");
+
+    static int doubleIx = e->KeywordIx( "DOUBLE");
+    if( p0->Type() == GDL_DOUBLE || e->KeywordSet( doubleIx))
+      LUDCTyped<DDoubleGDL>( e, p0, GDL_DOUBLE, n, m);
+    else
+      LUDCTyped<DFloatGDL>( e, p0, GDL_FLOAT, n, m);
+  }
+
+  BaseGDL* lusol_batched( EnvT* e)
+  {
+    e->NParam( 3);
+    BaseGDL* p0 = e->GetNumericParDefined( 0);
+    SizeT n, m;
+    BatchedCheckStack( e, p0, n, m);
+    BatchedCheckVectors( e, 1, n, m);
+    BatchedCheckVectors( e, 2, n, m);
+
+    if( p0->Type() == GDL_COMPLEXDBL || p0->Type() == GDL_COMPLEX)
+      e->Throw( "Input type cannot be COMPLEX, please use LA_LUDC (not ready)");
+
+    DLongGDL* perm = e->GetParAs<DLongGDL>( 1);
+    for( SizeT i = 0; i < n * m; ++i)
+      if( (*perm)[i] < 0 || (*perm)[i] >= static_cast<DLong>( n))
+	e->Throw( "Index out of range, not an LUDC permutation: " + e->GetParString( 1));
+
+    static int doubleIx = e->KeywordIx( "DOUBLE");
+    if( p0->Type() == GDL_DOUBLE || e->GetPar( 2)->Type() == GDL_DOUBLE || e->KeywordSet( doubleIx))
+      return LUSolTyped<DDoubleGDL>( e, n, m, perm);
+    return LUSolTyped<DFloatGDL>( e, n, m, perm);
+  }
+
+  void choldc_batched( EnvT* e)
+  {
+    e->NParam( 2);
+    BaseGDL* p0 = e->GetNumericParDefined( 0);
+    SizeT n, m;
+    BatchedCheckStack( e, p0, n, m);
+    e->AssureGlobalPar( 1);
+
+    // like the single matrix version, complex input is used by its real part
+    static int doubleIx = e->KeywordIx( "DOUBLE");
+    if( p0->Type() == GDL_DOUBLE || p0->Type() == GDL_COMPLEXDBL || e->KeywordSet( doubleIx))
+      CholDCTyped<DDoubleGDL>( e, p0, GDL_DOUBLE, n, m);
+    else
+      CholDCTyped<DFloatGDL>( e, p0, GDL_FLOAT, n, m);
+  }
+
+  BaseGDL* cholsol_batched( EnvT* e)
+  {
+    e->NParam( 3);
+    BaseGDL* p0 = e->GetNumericParDefined( 0);
+    SizeT n, m;
+    BatchedCheckStack( e, p0, n, m);
+    BatchedCheckVectors( e, 1, n, m);
+    BatchedCheckVectors( e, 2, n, m);
+
+    static int doubleIx = e->KeywordIx( "DOUBLE");
+    DType t0 = p0->Type();
+    DType t2 = e->GetPar( 2)->Type();
+    if( t0 == GDL_DOUBLE || t0 == GDL_COMPLEXDBL || t2 == GDL_DOUBLE || t2 == GDL_COMPLEXDBL ||
+	e->KeywordSet( doubleIx))
+      return CholSolTyped<DDoubleGDL>( e, n, m);
+    return CholSolTyped<DFloatGDL>( e, n, m);
+  }
+
+  BaseGDL* matrix_multiply_batched( EnvT* e, BaseGDL* a, BaseGDL* b, bool at, bool bt)
+  {
+    if( a->Rank() > 3)
+      e->Throw( "Array must have 1, 2 or 3 dimensions: " + e->GetParString( 0));
+    if( b->Rank() > 3)
+      e->Throw( "Array must have 1, 2 or 3 dimensions: " + e->GetParString( 1));
+
+    // an operand of rank <= 2 is applied to every matrix of the other stack
+    bool aStack = a->Rank() == 3;
+    bool bStack = b->Rank() == 3;
+    SizeT m = aStack ? a->Dim( 2) : b->Dim( 2);
+    if( aStack && bStack && a->Dim( 2) != b->Dim( 2))
+      e->Throw( "Stacks of matrices must have the same number of matrices: " +
+		e->GetParString( 0) + ", " + e->GetParString( 1));
+
+    SizeT a0 = max( a->Dim( 0), static_cast<SizeT>( 1));
+    SizeT a1 = max( a->Dim( 1), static_cast<SizeT>( 1));
+    SizeT b0 = max( b->Dim( 0), static_cast<SizeT>( 1));
+    SizeT b1 = max( b->Dim( 1), static_cast<SizeT>( 1));
+    SizeT mm = at ? a1 : a0;
+    SizeT kk = at ? a0 : a1;
+    SizeT nn = bt ? b0 : b1;
+    if( kk != (bt ? b1 : b0))
+      e->Throw( "Operands of matrix multiply have incompatible dimensions: " +
+		e->GetParString( 0) + ", " + e->GetParString( 1) + ".");
+
+    switch( a->Type())
+      {
+      case GDL_BYTE: return MultiplyTyped<DByteGDL>( a, b, at, bt, mm, kk, nn, m, aStack, bStack);
+      case GDL_INT: return MultiplyTyped<DIntGDL>( a, b, at, bt, mm, kk, nn, m, aStack, bStack);
+      case GDL_UINT: return MultiplyTyped<DUIntGDL>( a, b, at, bt, mm, kk, nn, m, aStack, bStack);
+      case GDL_LONG: return MultiplyTyped<DLongGDL>( a, b, at, bt, mm, kk, nn, m, aStack, bStack);
+      case GDL_ULONG: return MultiplyTyped<DULongGDL>( a, b, at, bt, mm, kk, nn, m, aStack, bStack);
+      case GDL_LONG64: return MultiplyTyped<DLong64GDL>( a, b, at, bt, mm, kk, nn, m, aStack, bStack);
+      case GDL_ULONG64: return MultiplyTyped<DULong64GDL>( a, b, at, bt, mm, kk, nn, m, aStack, bStack);
+      case GDL_FLOAT: return MultiplyTyped<DFloatGDL>( a, b, at, bt, mm, kk, nn, m, aStack, bStack);
+      case GDL_DOUBLE: return MultiplyTyped<DDoubleGDL>( a, b, at, bt, mm, kk, nn, m, aStack, bStack);
+      case GDL_COMPLEX: return MultiplyTyped<DComplexGDL>( a, b, at, bt, mm, kk, nn, m, aStack, bStack);
+      case GDL_COMPLEXDBL: return MultiplyTyped<DComplexDblGDL>( a, b, at, bt, mm, kk, nn, m, aStack, bStack);
+      default: break;
+      }
+    e->Throw( "Array type cannot be " + a->TypeStr() + " here: " + e->GetParString( 0));
+    return NULL;
+  }
+
+}
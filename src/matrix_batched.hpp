@@ -0,0 +1,48 @@
+/***************************************************************************
+                          matrix_batched.hpp  -  linear algebra on stacks
+                                                 of small matrices
+                             -------------------
+    begin                : Oct 2026
+    copyright            : (C) 2026 by the GDL team
+    email                :
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+// GDL extension: INVERT, LUDC, LUSOL, CHOLDC, CHOLSOL and MATRIX_MULTIPLY
+// accept a stack of m matrices as an (n,n,m) array (vectors as (n,m)) and
+// process each of them independently, in parallel over m. Kernels are
+// instantiated for each size up to BATCHED_MAX_FIXED_N so that the compiler
+// fully unrolls them, larger sizes use the generic kernels.
+// The called routines only dispatch here when the first argument has rank 3.
+
+#ifndef MATRIX_BATCHED_HPP_
+#define MATRIX_BATCHED_HPP_
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "datatypes.hpp"
+#include "envt.hpp"
+
+namespace lib {
+
+  BaseGDL* invert_batched( EnvT* e, bool hasDouble);
+  void ludc_batched( EnvT* e);
+  BaseGDL* lusol_batched( EnvT* e);
+  void choldc_batched( EnvT* e);
+  BaseGDL* cholsol_batched( EnvT* e);
+  // a and b already promoted to the same type
+  BaseGDL* matrix_multiply_batched( EnvT* e, BaseGDL* a, BaseGDL* b, bool at, bool bt);
+
+}
+
+#endif
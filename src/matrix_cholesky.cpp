@@ -31,6 +31,7 @@
 #include "dinterpreter.hpp"
 
 #include "gsl_fun.hpp"
+#include "matrix_batched.hpp"
 
 #if defined(USE_EIGEN)
 #include <Eigen/LU>
@@ -139,6 +140,8 @@ namespace lib {
 
   BaseGDL* cholsol_fun ( EnvT* e)
   {
+    // GDL extension: (n,n,m) stack of matrices
+    if (e->GetNumericParDefined(0)->Rank() == 3) return cholsol_batched(e);
 
     //    set_num_threads();
     
@@ -561,6 +564,8 @@ void la_choldc_pro( EnvT* e)
 
   void choldc_pro( EnvT* e) 
   {
+    // GDL extension: (n,n,m) stack of matrices
+    if (e->GetNumericParDefined(0)->Rank() == 3) { choldc_batched(e); return; }
 
     BaseGDL* p0 = e->GetNumericParDefined( 0);
     //BaseGDL* p0 = e->GetParDefined( 0);
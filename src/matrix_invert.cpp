@@ -51,6 +51,8 @@ The GSL is mandatory. Eigen3 is not mandatory. */
 #include <gsl/gsl_linalg.h>
 
 #include "matrix_invert.hpp"
+#include "blas_backend.hpp"
+#include "matrix_batched.hpp"
 //#include "gsl_errorhandler.hpp"
 
 #define LOG10E 0.434294
@@ -106,14 +108,29 @@ namespace lib {
   {
     static int GSLIx=e->KeywordIx("GSL");
     static int EIGENIx=e->KeywordIx("EIGEN");
-    if (e->KeywordSet(GSLIx) && e->KeywordSet(EIGENIx))
+    static int LAPACKIx=e->KeywordIx("LAPACK");
+    if ((e->KeywordSet(GSLIx) + e->KeywordSet(EIGENIx) + e->KeywordSet(LAPACKIx)) > 1)
       e->Throw("Conflicting keywords");
     
     static int DOUBLEIx=e->KeywordIx("DOUBLE");
     bool hasDouble=e->KeywordSet(DOUBLEIx);
+
+    // GDL extension: (n,n,m) stack of matrices
+    if (e->GetNumericParDefined(0)->Rank() == 3) return invert_batched(e, hasDouble);
     
     matrix_input_check_dims(e);
 
+    // external LAPACK: on request, or by default when the BLAS backend is on
+    // (CPU, BLAS=1). Otherwise, or if it declines, the usual way below.
+    if (e->KeywordSet(LAPACKIx) && !BlasCompiled())
+      Warning("LAPACK Invert not available, Eigen or GSL used");
+    if (e->KeywordSet(LAPACKIx) ||
+	(useBLASBackend && !e->KeywordSet(GSLIx) && !e->KeywordSet(EIGENIx)))
+      {
+	BaseGDL* res=invert_lapack_fun(e, hasDouble);
+	if (res != NULL) return res;
+      }
+
 #if defined(USE_EIGEN)
     bool Eigen_flag=TRUE;
 #else
@@ -443,6 +460,44 @@ namespace lib {
   }
 
 
+  template< typename T>
+  BaseGDL* invert_lapack_template( EnvT* e, BaseGDL* p0, DType type)
+  {
+    T* res = static_cast<T*>(p0->Convert2( type, BaseGDL::COPY));
+    Guard<T> resGuard( res);
+
+    double lnDet;
+    int status=LapackInvert( p0->Dim(0), &(*res)[0], lnDet);
+    if (status < 0) return NULL;
+
+    // same convention as the GSL version
+    long singular=status;
+    if (singular == 0 && abs(lnDet) * LOG10E < 1e-5) singular = 2;
+
+    if (e->NParam(1) == 2) e->SetPar(1,new DLongGDL( singular));
+    return resGuard.release();
+  }
+
+  // returns NULL when the external LAPACK cannot be used
+  // (not compiled in, switched off, one element matrix)
+  BaseGDL* invert_lapack_fun( EnvT* e, bool hasDouble)
+  {
+    BaseGDL* p0 = e->GetParDefined( 0);
+    if (!BlasCompiled() || !useBLASBackend || p0->N_Elements() == 1) return NULL;
+
+    // related to "status" param : see comment in "invert_gsl_fun"
+    SizeT nParam=e->NParam(1);
+    if (nParam == 2) e->AssureGlobalPar( 1);
+
+    if (p0->Type() == GDL_COMPLEX)
+      return invert_lapack_template<DComplexGDL>(e, p0, GDL_COMPLEX);
+    if (p0->Type() == GDL_COMPLEXDBL)
+      return invert_lapack_template<DComplexDblGDL>(e, p0, GDL_COMPLEXDBL);
+    if ((p0->Type() == GDL_DOUBLE) || hasDouble)
+      return invert_lapack_template<DDoubleGDL>(e, p0, GDL_DOUBLE);
+    return invert_lapack_template<DFloatGDL>(e, p0, GDL_FLOAT);
+  }
+
 #if defined(USE_EIGEN)
   BaseGDL* invert_eigen_fun( EnvT* e, bool hasDouble)
   {
@@ -37,6 +37,7 @@ namespace lib {
 
   BaseGDL* invert_eigen_fun( EnvT* e, bool hasDouble);
   BaseGDL* invert_gsl_fun( EnvT* e, bool hasDouble);
+  BaseGDL* invert_lapack_fun( EnvT* e, bool hasDouble);
 
   BaseGDL* AC_invert_fun( EnvT* e);
  
@@ -729,62 +729,105 @@ static inline void histogram_muladd( const uint16_t a, const uint16_t x[16],
     }
 }
 
+/*
+ * Modified for GDL: ctmf_helper() is a template over the pixel type P and the
+ * number L of 4-bit histogram tiers: L=2 is the coarse/fine histogram of the
+ * original 8-bit code, L=4 covers 16-bit pixels. Tier 0 (16 bins) of the
+ * kernel histogram is kept up to date for every pixel, while each 16-bin
+ * segment of the deeper tiers is only brought up to date when the search for
+ * the median goes through it ("coarse-to-fine"), as done originally for the
+ * fine level. Everything stays O(1) per pixel, with 4 scans of 16 bins for
+ * 16-bit data. Bins remain 16 bit wide, hence the kernel must not hold more
+ * than 65535 pixels (r <= 127).
+ *
+ * The helper only produces output rows [row0,row1), so that an image can be
+ * cut into tiles (stripes x bands of rows) processed in parallel. Borders are
+ * replicated as in the original code.
+ */
+#define CTMF_STALE (-(1<<30))
+
+static inline uint16_t* ctmf_alloc( size_t count )
+{
+#if defined(__SSE2__) || defined(__MMX__)
+    uint16_t* p = (uint16_t*) _mm_malloc( count * sizeof(uint16_t), 16 );
+#else
+    uint16_t* p = (uint16_t*) malloc( count * sizeof(uint16_t) );
+#endif
+    if ( p == NULL ) throw std::bad_alloc();
+    memset( p, 0, count * sizeof(uint16_t) );
+    return p;
+}
+
+static inline void ctmf_free( uint16_t* p )
+{
+#if defined(__SSE2__) || defined(__MMX__)
+    _mm_free( p );
+#else
+    free( p );
+#endif
+}
+
+template <typename P, int L>
 static void ctmf_helper(
-        const unsigned char* const src, unsigned char* const dst,
+        const P* const src, P* const dst,
         const int width, const int height,
         const int src_step, const int dst_step,
         const int r, const int cn,
-        const int pad_left, const int pad_right
+        const int pad_left, const int pad_right,
+        const int row0, const int row1
         )
 {
     const int m = height, n = width;
-    int i, j, k, c;
-    const unsigned char *p, *q;
+    const int t = 2*r*r + 2*r;
+    int i, j, l, c;
+    const P *p, *q;
 
-    Histogram H[4];
-    uint16_t *h_coarse, *h_fine, luc[4][16];
+    /* h[l]: column histograms of tier l, segment-major: 16 * ( n*seg + column ) + bin.
+     * H[l]: kernel histogram of tier l, 16 * seg + bin; luc[l][seg]: next column
+     * to be added to segment seg. A channel is handled as 16^l more segments. */
+    uint16_t *h[L], *H[L];
+    int *luc[L];
+    int nseg[L];
 
     assert( src );
     assert( dst );
     assert( r >= 0 );
     assert( width >= 2*r+1 );
-    assert( height >= 2*r+1 );
+    assert( (2*r+1)*(2*r+1) <= 65535 );
     assert( src_step != 0 );
     assert( dst_step != 0 );
 
-    /* SSE2 and MMX need aligned memory, provided by _mm_malloc(). */
-#if defined(__SSE2__) || defined(__MMX__)
-    h_coarse = (uint16_t*) _mm_malloc(  1 * 16 * n * cn * sizeof(uint16_t), 16 );
-    h_fine   = (uint16_t*) _mm_malloc( 16 * 16 * n * cn * sizeof(uint16_t), 16 );
-    memset( h_coarse, 0,  1 * 16 * n * cn * sizeof(uint16_t) );
-    memset( h_fine,   0, 16 * 16 * n * cn * sizeof(uint16_t) );
-#else
-    h_coarse = (uint16_t*) calloc(  1 * 16 * n * cn, sizeof(uint16_t) );
-    h_fine   = (uint16_t*) calloc( 16 * 16 * n * cn, sizeof(uint16_t) );
-#endif
+    for ( l = 0; l < L; ++l ) {
+        nseg[l] = 1 << (4*l);
+        h[l]   = ctmf_alloc( (size_t) 16 * nseg[l] * n * cn );
+        H[l]   = ctmf_alloc( (size_t) 16 * nseg[l] * cn );
+        luc[l] = new int[ nseg[l] * cn ];
+    }
 
-    /* First row initialization */
-    for ( j = 0; j < n; ++j ) {
-        for ( c = 0; c < cn; ++c ) {
-            COP( c, j, src[cn*j+c], += r+1 );
-        }
+#define CTMF_COP(c,j,x,op) \
+    for ( int lev = 0; lev < L; ++lev ) { \
+        int seg = nseg[lev]*(c) + ( (int)(x) >> (4*(L-lev)) ); \
+        h[lev][ 16*(n*seg+(j)) + ( ((int)(x) >> (4*(L-1-lev))) & 0xF ) ] op; \
     }
-    for ( i = 0; i < r; ++i ) {
+
+    /* Column histograms hold rows row0-r-1 .. row0+r-1, border replicated. */
+    for ( i = row0-r-1; i < row0+r; ++i ) {
+        p = src + src_step * MIN( m-1, MAX( 0, i ) );
         for ( j = 0; j < n; ++j ) {
             for ( c = 0; c < cn; ++c ) {
-                COP( c, j, src[src_step*i+cn*j+c], ++ );
+                CTMF_COP( c, j, p[cn*j+c], ++ );
             }
         }
     }
 
-    for ( i = 0; i < m; ++i ) {
+    for ( i = row0; i < row1; ++i ) {
 
         /* Update column histograms for entire row. */
         p = src + src_step * MAX( 0, i-r-1 );
         q = p + cn * n;
         for ( j = 0; p != q; ++j ) {
             for ( c = 0; c < cn; ++c, ++p ) {
-                COP( c, j, *p, -- );
+                CTMF_COP( c, j, *p, -- );
             }
         }
 
@@ -792,130 +835,94 @@ static void ctmf_helper(
         q = p + cn * n;
         for ( j = 0; p != q; ++j ) {
             for ( c = 0; c < cn; ++c, ++p ) {
-                COP( c, j, *p, ++ );
+                CTMF_COP( c, j, *p, ++ );
             }
         }
 
-        /* First column initialization */
-        memset( H, 0, cn*sizeof(H[0]) );
-        memset( luc, 0, cn*sizeof(luc[0]) );
+        /* First column initialization: tier 0 only, deeper segments are stale. */
+        memset( H[0], 0, 16 * cn * sizeof(uint16_t) );
+        for ( l = 1; l < L; ++l ) {
+            for ( int s = 0; s < nseg[l] * cn; ++s ) luc[l][s] = CTMF_STALE;
+        }
         if ( pad_left ) {
             for ( c = 0; c < cn; ++c ) {
-                histogram_muladd( r, &h_coarse[16*n*c], H[c].coarse );
+                histogram_muladd( r, &h[0][16*n*c], &H[0][16*c] );
             }
         }
         for ( j = 0; j < (pad_left ? r : 2*r); ++j ) {
             for ( c = 0; c < cn; ++c ) {
-                histogram_add( &h_coarse[16*(n*c+j)], H[c].coarse );
-            }
-        }
-        for ( c = 0; c < cn; ++c ) {
-            for ( k = 0; k < 16; ++k ) {
-                histogram_muladd( 2*r+1, &h_fine[16*n*(16*c+k)], &H[c].fine[k][0] );
+                histogram_add( &h[0][16*(n*c+j)], &H[0][16*c] );
             }
         }
 
         for ( j = pad_left ? 0 : r; j < (pad_right ? n : n-r); ++j ) {
             for ( c = 0; c < cn; ++c ) {
-                const uint16_t t = 2*r*r + 2*r;
-                uint16_t sum = 0, *segment;
-                int b;
-
-                histogram_add( &h_coarse[16*(n*c + MIN(j+r,n-1))], H[c].coarse );
-
-                /* Find median at coarse level */
-                for ( k = 0; k < 16 ; ++k ) {
-                    sum += H[c].coarse[k];
-                    if ( sum > t ) {
-                        sum -= H[c].coarse[k];
-                        break;
+                int sum = 0, seg = c, k = 0;
+
+                histogram_add( &h[0][16*(n*c + MIN(j+r,n-1))], &H[0][16*c] );
+
+                for ( l = 0; l < L; ++l ) {
+                    uint16_t *segment = &H[l][16*seg];
+
+                    if ( l > 0 ) {
+                        /* Update corresponding histogram segment */
+                        int *lu = &luc[l][seg];
+                        const uint16_t *col = &h[l][16*n*seg];
+                        if ( *lu <= j-r ) {
+                            memset( segment, 0, 16 * sizeof(uint16_t) );
+                            for ( *lu = j-r; *lu < j+r+1; ++*lu ) {
+                                histogram_add( &col[16*MIN(MAX(*lu,0),n-1)], segment );
+                            }
+                        }
+                        else {
+                            for ( ; *lu < j+r+1; ++*lu ) {
+                                histogram_sub( &col[16*MAX(*lu-2*r-1,0)], segment );
+                                histogram_add( &col[16*MIN(*lu,n-1)], segment );
+                            }
+                        }
                     }
-                }
-                assert( k < 16 );
 
-                /* Update corresponding histogram segment */
-                if ( luc[c][k] <= j-r ) {
-                    memset( &H[c].fine[k], 0, 16 * sizeof(uint16_t) );
-                    for ( luc[c][k] = j-r; luc[c][k] < MIN(j+r+1,n); ++luc[c][k] ) {
-                        histogram_add( &h_fine[16*(n*(16*c+k)+luc[c][k])], H[c].fine[k] );
-                    }
-                    if ( luc[c][k] < j+r+1 ) {
-                        histogram_muladd( j+r+1 - n, &h_fine[16*(n*(16*c+k)+(n-1))], &H[c].fine[k][0] );
-                        luc[c][k] = j+r+1;
-                    }
-                }
-                else {
-                    for ( ; luc[c][k] < j+r+1; ++luc[c][k] ) {
-                        histogram_sub( &h_fine[16*(n*(16*c+k)+MAX(luc[c][k]-2*r-1,0))], H[c].fine[k] );
-                        histogram_add( &h_fine[16*(n*(16*c+k)+MIN(luc[c][k],n-1))], H[c].fine[k] );
+                    /* Find median in segment */
+                    for ( k = 0; k < 16 ; ++k ) {
+                        sum += segment[k];
+                        if ( sum > t ) {
+                            sum -= segment[k];
+                            break;
+                        }
                     }
+                    assert( k < 16 );
+                    seg = 16*seg + k;
                 }
 
-                histogram_sub( &h_coarse[16*(n*c+MAX(j-r,0))], H[c].coarse );
+                histogram_sub( &h[0][16*(n*c+MAX(j-r,0))], &H[0][16*c] );
 
-                /* Find median in segment */
-                segment = H[c].fine[k];
-                for ( b = 0; b < 16 ; ++b ) {
-                    sum += segment[b];
-                    if ( sum > t ) {
-                        dst[dst_step*i+cn*j+c] = 16*k + b;
-                        break;
-                    }
-                }
-                assert( b < 16 );
+                dst[dst_step*i+cn*j+c] = (P) ( seg - (c << (4*L)) );
             }
         }
     }
 
+#undef CTMF_COP
+
 #if defined(__SSE2__) || defined(__MMX__)
     _mm_empty();
-    _mm_free(h_coarse);
-    _mm_free(h_fine);
-#else
-    free(h_coarse);
-    free(h_fine);
 #endif
+    for ( l = 0; l < L; ++l ) {
+        delete[] luc[l];
+        ctmf_free( H[l] );
+        ctmf_free( h[l] );
+    }
 }
 
-/**
- * \brief Constant-time median filtering
- *
- * This function does a median filtering of an 8-bit image. The source image is
- * processed as if it was padded with zeros. The median kernel is square with
- * odd dimensions. Images of arbitrary size may be processed.
- *
- * To process multi-channel images, you must call this function multiple times,
- * changing the source and destination adresses and steps such that each channel
- * is processed as an independent single-channel image.
- *
- * Processing images of arbitrary bit depth is not supported.
- *
- * The computing time is O(1) per pixel, independent of the radius of the
- * filter. The algorithm's initialization is O(r*width), but it is negligible.
- * Memory usage is simple: it will be as big as the cache size, or smaller if
- * the image is small. For efficiency, the histograms' bins are 16-bit wide.
- * This may become too small and lead to overflow as \a r increases.
- *
- * \param src           Source image data.
- * \param dst           Destination image data. Must be preallocated.
- * \param width         Image width, in pixels.
- * \param height        Image height, in pixels.
- * \param src_step      Distance between adjacent pixels on the same column in
- *                      the source image, in bytes.
- * \param dst_step      Distance between adjacent pixels on the same column in
- *                      the destination image, in bytes.
- * \param r             Median filter radius. The kernel will be a 2*r+1 by
- *                      2*r+1 square.
- * \param cn            Number of channels. For example, a grayscale image would
- *                      have cn=1 while an RGB image would have cn=3.
- * \param memsize       Maximum amount of memory to use, in bytes. Set this to
- *                      the size of the L2 cache, then vary it slightly and
- *                      measure the processing time to find the optimal value.
- *                      For example, a 512 kB L2 cache would have
- *                      memsize=512*1024 initially.
+#undef CTMF_STALE
+
+/*
+ * Splits the image in vertical stripes (see below) and, when there are not
+ * enough stripes to feed all threads, each stripe in bands of rows. Tiles are
+ * independent and processed in parallel.
  */
-void ctmf(
-        const unsigned char* const src, unsigned char* const dst,
+template <typename P, int L>
+static void ctmf_tiled(
+        const P* const src, P* const dst,
         const int width, const int height,
         const int src_step, const int dst_step,
         const int r, const int cn, const long unsigned int memsize
@@ -950,9 +957,14 @@ void ctmf(
      * A flag is passed to ctmf_helper() so that it treats these cases as if the
      * image was zero-padded.
      */
-    int stripes = (int) ceil( (double) (width - 2*r) / (memsize / sizeof(Histogram) - 2*r) );
+    long unsigned int column_size = 0;
+    for ( int l = 0; l < L; ++l ) column_size += (long unsigned int) cn * 16 * (1 << (4*l)) * sizeof(uint16_t);
+    int capacity = (int) MIN( memsize / column_size, (long unsigned int) width );
+    capacity = MAX( capacity, 4*r+2 ); /* a stripe must leave room for its overlap */
+    int stripes = (int) ceil( (double) (width - 2*r) / (capacity - 2*r) );
     int stripe_size = (int) ceil( (double) ( width + stripes*2*r - 2*r ) / stripes );
 
+    std::vector<int> stripe_start, stripe_width;
     int i;
 
     for ( i = 0; i < width; i += stripe_size - 2*r ) {
@@ -961,14 +973,96 @@ void ctmf(
         if ( i + stripe_size - 2*r >= width || width - (i + stripe_size - 2*r) < 2*r+1 ) {
             stripe = width - i;
         }
-
-        ctmf_helper( src + cn*i, dst + cn*i, stripe, height, src_step, dst_step, r, cn,
-                i == 0, stripe == width - i );
-
+        stripe_start.push_back( i );
+        stripe_width.push_back( stripe );
         if ( stripe == width - i ) {
             break;
         }
     }
+
+    /* Bands are only worth their 2r+1 rows of initialization if they are tall enough. */
+    const int nstripes = stripe_start.size();
+    int bands = 1;
+    if ( CpuTPOOL_NTHREADS > 1 && nstripes < 2*CpuTPOOL_NTHREADS ) {
+        bands = ( 2*CpuTPOOL_NTHREADS + nstripes - 1 ) / nstripes;
+        bands = MAX( 1, MIN( bands, height / MAX( 4*r+2, 16 ) ) );
+    }
+    const int ntiles = nstripes * bands;
+
+#pragma omp parallel for schedule(dynamic) if (CpuTPOOL_NTHREADS > 1 && ntiles > 1)
+    for ( int tile = 0; tile < ntiles; ++tile ) {
+        int s = tile / bands, band = tile % bands;
+        int x0 = stripe_start[s], w = stripe_width[s];
+        int y0 = (int) ( (long) height * band / bands );
+        int y1 = (int) ( (long) height * (band+1) / bands );
+        ctmf_helper<P,L>( src + cn*x0, dst + cn*x0, w, height, src_step, dst_step, r, cn,
+                x0 == 0, w == width - x0, y0, y1 );
+    }
+}
+
+/**
+ * \brief Constant-time median filtering
+ *
+ * This function does a median filtering of an 8-bit image. The source image is
+ * processed as if it was padded with zeros. The median kernel is square with
+ * odd dimensions. Images of arbitrary size may be processed.
+ *
+ * To process multi-channel images, you must call this function multiple times,
+ * changing the source and destination adresses and steps such that each channel
+ * is processed as an independent single-channel image.
+ *
+ * Processing images of arbitrary bit depth is not supported (but see ctmf16()).
+ *
+ * The computing time is O(1) per pixel, independent of the radius of the
+ * filter. The algorithm's initialization is O(r*width), but it is negligible.
+ * Memory usage is simple: it will be as big as the cache size, or smaller if
+ * the image is small. For efficiency, the histograms' bins are 16-bit wide.
+ * This may become too small and lead to overflow as \a r increases.
+ *
+ * \param src           Source image data.
+ * \param dst           Destination image data. Must be preallocated.
+ * \param width         Image width, in pixels.
+ * \param height        Image height, in pixels.
+ * \param src_step      Distance between adjacent pixels on the same column in
+ *                      the source image, in bytes.
+ * \param dst_step      Distance between adjacent pixels on the same column in
+ *                      the destination image, in bytes.
+ * \param r             Median filter radius. The kernel will be a 2*r+1 by
+ *                      2*r+1 square.
+ * \param cn            Number of channels. For example, a grayscale image would
+ *                      have cn=1 while an RGB image would have cn=3.
+ * \param memsize       Maximum amount of memory to use, in bytes. Set this to
+ *                      the size of the L2 cache, then vary it slightly and
+ *                      measure the processing time to find the optimal value.
+ *                      For example, a 512 kB L2 cache would have
+ *                      memsize=512*1024 initially.
+ */
+void ctmf(
+        const unsigned char* const src, unsigned char* const dst,
+        const int width, const int height,
+        const int src_step, const int dst_step,
+        const int r, const int cn, const long unsigned int memsize
+        )
+{
+    ctmf_tiled<unsigned char,2>( src, dst, width, height, src_step, dst_step, r, cn, memsize );
+}
+
+/**
+ * \brief Constant-time median filtering of 16-bit images
+ *
+ * Same as ctmf() for 16-bit pixels, using 4 histogram tiers instead of 2.
+ * Steps are given in pixels, not bytes. Each column histogram weighs about
+ * 140 kB, so \a memsize should rather be sized on the L3 cache.
+ * Signed or wider integer data must be mapped to uint16 by the caller.
+ */
+void ctmf16(
+        const uint16_t* const src, uint16_t* const dst,
+        const int width, const int height,
+        const int src_step, const int dst_step,
+        const int r, const int cn, const long unsigned int memsize
+        )
+{
+    ctmf_tiled<uint16_t,4>( src, dst, width, height, src_step, dst_step, r, cn, memsize );
 }
 
 //unused for the time being:
@@ -111,6 +111,9 @@ volatile bool forceWxWidgetsUglyFonts;
 //do we favor SIMD-accelerated random number generation?
 volatile bool useDSFMTAcceleration;
 
+//do we send matrix products and inversions to the external BLAS/LAPACK?
+volatile bool useBLASBackend;
+
 void ResetObjects()
 {
 #ifdef HAVE_LIBWXWIDGETS
@@ -76,6 +76,8 @@ extern volatile bool useWxWidgetsForGraphics;
 extern volatile bool forceWxWidgetsUglyFonts;
 //do we favor SIMD-accelerated random number generation?
 extern volatile bool useDSFMTAcceleration;
+//do we send matrix products and inversions to the external BLAS/LAPACK?
+extern volatile bool useBLASBackend;
 extern volatile bool usePlatformDeviceName;
 extern          int  debugMode;
 
@@ -31,6 +31,7 @@ enum RetCode {
 };
 
 class EnvT;
+class StridedViewReaderT;
 typedef void     (*LibPro)(EnvT*);
 typedef BaseGDL* (*LibFun)(EnvT*);
 typedef BaseGDL* (*LibFunDirect)(BaseGDL* param,bool canGrab);
@@ -1617,6 +1618,7 @@ class ARRAYEXPRNode: public DefaultNode
 public:
   explicit ARRAYEXPRNode( const RefDNode& refNode): DefaultNode( refNode) {}
   BaseGDL* Eval(); // caller receives ownership
+  BaseGDL* EvalView( StridedViewReaderT* reader);
   BaseGDL** LExpr(BaseGDL* r);
   //BaseGDL** LEval(); 
 };
@@ -28,6 +28,7 @@ email                : m_schellens@users.sf.net
 //#include "envt.hpp"
 #include "gdlexception.hpp"
 #include "nullgdl.hpp"
+#include "where.hpp"
 
 // illegal
 BaseGDL** ProgNode::LExpr( BaseGDL* right)
@@ -190,7 +191,44 @@ BaseGDL** ARRAYEXPRNode::LExpr( BaseGDL* right) // 'right' is not owned
 
 //       IxExprListT      cleanupList; // for cleanup
     ProgNodeP ax = this->getFirstChild()->getNextSibling();
-    aL=interpreter->arrayindex_list( ax, true);
+    ProgNodeP wx = ax->getFirstChild();
+    if( wx != NULL && wx->getType() == GDLTokenTypes::FCALL_LIB_RETNEW &&
+	wx->libFunFun == lib::where_fun && ax->arrIxListNoAssoc->SingleIndexed())
+    {
+      // a[WHERE(...)]=right: stored directly at the true elements if
+      // possible, else the result of WHERE is the index
+      Guard<lib::WhereMaskT> mask;
+      EnvT* newEnv = static_cast<FCALL_LIB_RETNEWNode*>( wx)->WhereCompareEnv( mask);
+      if( newEnv == NULL)
+      {
+	newEnv=new EnvT( wx, wx->libFun);
+	interpreter->parameter_def_nocheck( wx->getFirstChild(), newEnv);
+      }
+      Guard<EnvT> guardEnv( newEnv);
+
+      BaseGDL* ix;
+      try {
+	if( mask.get() != NULL)
+	  ix = lib::where_mask_assign( newEnv, mask.get(), *res, right);
+	else
+	  ix = lib::where_assign( newEnv, *res, right);
+      }
+      catch( GDLException& ex)
+      {
+	ex.SetErrorNodeP( this);
+	throw ex;
+      }
+      if( ix == NULL)
+	return res;
+
+      aL = ax->arrIxListNoAssoc;
+      aL->GetCleanupIx()->push_back( ix);
+      IxExprListT ixExprList;
+      ixExprList.push_back( ix);
+      aL->Init( ixExprList);
+    }
+    else
+      aL=interpreter->arrayindex_list( ax, true);
     
   }
   guard.reset(aL);
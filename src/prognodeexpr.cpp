@@ -33,6 +33,8 @@
 #include "basic_fun_jmg.hpp"
 
 #include "initsysvar.hpp"
+#include "simd_dispatch.hpp"
+#include "where.hpp"
 
 using namespace std;
 
@@ -110,6 +112,62 @@ BaseGDL* ProgNode::Eval()
 
 
 
+template<class Sp, class SpS>
+static BaseGDL* SimdMixedArithT( SimdArithOp op, bool inv, BaseGDL* hi, BaseGDL* lo,
+				 const dimension& dim, SizeT nEl)
+{
+  Data_<Sp>* res = new Data_<Sp>( dim, BaseGDL::NOZERO);
+  if( !SimdConvertArith( op, inv, &(*res)[0], &(*static_cast<Data_<Sp>*>( hi))[0],
+			 &(*static_cast<Data_<SpS>*>( lo))[0], nEl))
+    {
+      delete res;
+      return NULL;
+    }
+  return res;
+}
+
+template<class Sp>
+static BaseGDL* SimdMixedArithT( SimdArithOp op, bool inv, BaseGDL* hi, BaseGDL* lo,
+				 const dimension& dim, SizeT nEl)
+{
+  switch( lo->Type())
+    {
+    case GDL_BYTE: return SimdMixedArithT<Sp, SpDByte>( op, inv, hi, lo, dim, nEl);
+    case GDL_INT: return SimdMixedArithT<Sp, SpDInt>( op, inv, hi, lo, dim, nEl);
+    case GDL_UINT: return SimdMixedArithT<Sp, SpDUInt>( op, inv, hi, lo, dim, nEl);
+    case GDL_LONG: return SimdMixedArithT<Sp, SpDLong>( op, inv, hi, lo, dim, nEl);
+    case GDL_FLOAT: return SimdMixedArithT<Sp, SpDFloat>( op, inv, hi, lo, dim, nEl);
+    default: return NULL;
+    }
+}
+
+// array op array where the superior type is GDL_FLOAT or GDL_DOUBLE and the
+// other one BYTE, INT, UINT, LONG or FLOAT: the inferior operand is
+// converted block by block within the operation (SimdConvertArith())
+// instead of into a promoted copy.
+// Returns NULL (nothing done) for all other operands.
+static BaseGDL* SimdMixedArith( SimdArithOp op, BaseGDL* e1, BaseGDL* e2)
+{
+  DType aTy=e1->Type();
+  DType bTy=e2->Type();
+  if( aTy == bTy) return NULL;
+  if( e1->StrictScalar() || e2->StrictScalar()) return NULL;
+  // as AdjustTypes(): e1 is converted if inferior
+  bool inv = DTypeOrder[aTy] < DTypeOrder[bTy];
+  BaseGDL* hi = inv ? e2 : e1;
+  BaseGDL* lo = inv ? e1 : e2;
+  // result: the smaller array, e1 if same size
+  SizeT nEl1 = e1->N_Elements();
+  SizeT nEl2 = e2->N_Elements();
+  const dimension& dim = (nEl1 <= nEl2) ? e1->Dim() : e2->Dim();
+  SizeT nEl = (nEl1 <= nEl2) ? nEl1 : nEl2;
+  if( hi->Type() == GDL_FLOAT)
+    return SimdMixedArithT<SpDFloat>( op, inv, hi, lo, dim, nEl);
+  if( hi->Type() == GDL_DOUBLE)
+    return SimdMixedArithT<SpDDouble>( op, inv, hi, lo, dim, nEl);
+  return NULL;
+}
+
 // converts inferior type to superior type
 // for not (yet) overloaded operators
 void ProgNode::AdjustTypes(Guard<BaseGDL>& a, Guard<BaseGDL>& b)
@@ -955,6 +1013,9 @@ BaseGDL* PLUSNode::Eval()
       // GDL_COMPLEX op GDL_DOUBLE = GDL_COMPLEXDBL
   else 
   {
+    res = SimdMixedArith( SIMD_ADD, e1.get(), e2.get());
+    if( res != NULL) return res;
+
     DType cxTy = PromoteComplexOperand( aTy, bTy);
     if( cxTy != GDL_UNDEF)
     {
@@ -1021,6 +1082,9 @@ BaseGDL* MINUSNode::Eval()
       // GDL_COMPLEX op GDL_DOUBLE = GDL_COMPLEXDBL
   else 
   {
+    res = SimdMixedArith( SIMD_SUB, e1.get(), e2.get());
+    if( res != NULL) return res;
+
     DType cxTy = PromoteComplexOperand( aTy, bTy);
     if( cxTy != GDL_UNDEF)
     {
@@ -1131,6 +1195,8 @@ BaseGDL* ASTERIXNode::Eval()
 	BaseGDL* res;
 	Guard<BaseGDL> e1 ( op1->Eval() );
 	Guard<BaseGDL> e2 ( op2->Eval() );
+	res= SimdMixedArith ( SIMD_MUL, e1.get(), e2.get() );
+	if ( res != NULL ) return res;
 	AdjustTypes ( e1,e2 );
 	if ( e1->StrictScalar() )
 	{
@@ -1206,6 +1272,8 @@ BaseGDL* SLASHNode::Eval()
 { BaseGDL* res;
  Guard<BaseGDL> e1( op1->Eval());
  Guard<BaseGDL> e2( op2->Eval());
+ res= SimdMixedArith( SIMD_DIV, e1.get(), e2.get());
+ if( res != NULL) return res;
  AdjustTypes(e1,e2);
  if( e1->StrictScalar())
    {
@@ -1714,6 +1782,9 @@ BaseGDL* PLUSNC12Node::Eval()
       return e2->AddInvNew( e1); // smaller + larger
     }
   }
+  BaseGDL* fused = SimdMixedArith( SIMD_ADD, e1, e2);
+  if( fused != NULL) return fused;
+
   Guard<BaseGDL> g1;
   Guard<BaseGDL> g2;
   DType cxTy = PromoteComplexOperand( aTy, bTy);
@@ -1848,6 +1919,9 @@ BaseGDL* PLUSNCNode::Eval()
   }
   else // aTy != bTy
   {
+    res = SimdMixedArith( SIMD_ADD, e1, e2);
+    if( res != NULL) return res;
+
     DType cxTy = PromoteComplexOperand( aTy, bTy);
     if( cxTy != GDL_UNDEF)
     {
@@ -1995,6 +2069,9 @@ BaseGDL* MINUSNC12Node::Eval()
     }
   }
 
+  BaseGDL* fused = SimdMixedArith( SIMD_SUB, e1, e2);
+  if( fused != NULL) return fused;
+
   Guard<BaseGDL> g1;
   Guard<BaseGDL> g2;
 
@@ -2115,6 +2192,9 @@ BaseGDL* MINUSNCNode::Eval()
   }
   else // aTy != bTy
   {
+    res = SimdMixedArith( SIMD_SUB, e1, e2);
+    if( res != NULL) return res;
+
     DType cxTy = PromoteComplexOperand( aTy, bTy);
     if( cxTy != GDL_UNDEF)
     {
@@ -2343,6 +2423,9 @@ BaseGDL* ASTERIXNC12Node::Eval()
     }
   }
   
+  BaseGDL* fused = SimdMixedArith( SIMD_MUL, e1, e2);
+  if( fused != NULL) return fused;
+
   Guard<BaseGDL> g1;
   Guard<BaseGDL> g2;
 
@@ -2672,6 +2755,9 @@ BaseGDL* SLASHNC12Node::Eval()
       return e2->DivInvNew( e1); // smaller + larger
     }
   }
+  BaseGDL* fused = SimdMixedArith( SIMD_DIV, e1, e2);
+  if( fused != NULL) return fused;
+
   Guard<BaseGDL> g1;
   Guard<BaseGDL> g2;
 
@@ -3169,9 +3255,243 @@ BaseGDL** FCALL_LIB_RETNEWNode::LEval()
     throw GDLException(this,"Internal error: FCALL_LIB_RETNEW as left expr.");
 }
 
+// the operator of the comparison node c
+static bool WhereComparison( ProgNodeP c, SimdCmpOp& op)
+{
+  switch( c->getType())
+  {
+  case GDLTokenTypes::EQ_OP: op = SIMD_EQ; return true;
+  case GDLTokenTypes::NE_OP: op = SIMD_NE; return true;
+  case GDLTokenTypes::LE_OP: op = SIMD_LE; return true;
+  case GDLTokenTypes::LT_OP: op = SIMD_LT; return true;
+  case GDLTokenTypes::GE_OP: op = SIMD_GE; return true;
+  case GDLTokenTypes::GT_OP: op = SIMD_GT; return true;
+  default: return false;
+  }
+}
+
+// c is a comparison, or AND, OR, ~ of such conditions
+static bool WhereFusable( ProgNodeP c)
+{
+  SimdCmpOp op;
+  switch( c->getType())
+  {
+  case GDLTokenTypes::AND_OP:
+  case GDLTokenTypes::OR_OP:
+    return WhereFusable( c->getFirstChild()) &&
+      WhereFusable( c->getFirstChild()->getNextSibling());
+  case GDLTokenTypes::LOG_NEG:
+    return WhereFusable( c->getFirstChild());
+  default:
+    return WhereComparison( c, op);
+  }
+}
+
+// e1 AND e2, e1 OR e2 as AND_OPNode::Eval(), OR_OPNode::Eval()
+BaseGDL* FCALL_LIB_RETNEWNode::WhereLogicalValue( bool isAnd, Guard<BaseGDL>& e1, Guard<BaseGDL>& e2)
+{
+  BaseGDL* res;
+  AdjustTypes( e1, e2);
+  if( e1->StrictScalar())
+    {
+      res = isAnd ? e2->AndOpS( e1.get()) : e2->OrOpS( e1.get());
+      e2.release();
+    }
+  else if( e2->StrictScalar())
+    {
+      res = isAnd ? e1->AndOpInvS( e2.get()) : e1->OrOpInvS( e2.get());
+      e1.release();
+    }
+  else if( e1->N_Elements() <= e2->N_Elements())
+    {
+      res = isAnd ? e1->AndOpInv( e2.get()) : e1->OrOpInv( e2.get());
+      e1.release();
+    }
+  else
+    {
+      res = isAnd ? e2->AndOp( e1.get()) : e2->OrOp( e1.get());
+      e2.release();
+    }
+  return res;
+}
+
+// the condition c of WHERE (WhereFusable()) reduced to its mask, NULL
+// being returned, or, if one of its comparisons is not of real numeric
+// operands, its value
+BaseGDL* FCALL_LIB_RETNEWNode::WhereCondition( ProgNodeP c, Guard<lib::WhereMaskT>& mask)
+{
+  if( c->getType() == GDLTokenTypes::AND_OP || c->getType() == GDLTokenTypes::OR_OP)
+    {
+      Guard<lib::WhereMaskT> m1;
+      Guard<lib::WhereMaskT> m2;
+      Guard<BaseGDL> v1( WhereCondition( c->getFirstChild(), m1));
+      Guard<BaseGDL> v2( WhereCondition( c->getFirstChild()->getNextSibling(), m2));
+      bool isAnd = (c->getType() == GDLTokenTypes::AND_OP);
+      if( m1.get() != NULL && m2.get() != NULL)
+	{
+	  mask.Reset( lib::where_logical_mask( m1.get(), m2.get(), isAnd));
+	  return NULL;
+	}
+      if( m1.get() != NULL)
+	v1.reset( lib::where_mask_value( m1.get()));
+      if( m2.get() != NULL)
+	v2.reset( lib::where_mask_value( m2.get()));
+      return WhereLogicalValue( isAnd, v1, v2);
+    }
+  if( c->getType() == GDLTokenTypes::LOG_NEG)
+    {
+      Guard<BaseGDL> v1( WhereCondition( c->getFirstChild(), mask));
+      if( mask.get() != NULL)
+	{
+	  lib::where_neg_mask( mask.get());
+	  return NULL;
+	}
+      return v1->LogNeg();
+    }
+
+  SimdCmpOp op;
+  WhereComparison( c, op);
+  bool nc = (dynamic_cast<BinaryExprNC*>( c) != NULL);
+  bool eq = (op == SIMD_EQ || op == SIMD_NE);
+  Guard<BaseGDL> g1;
+  Guard<BaseGDL> g2;
+  BaseGDL *e1, *e2;
+  if( nc)
+    {
+      if( eq)
+	static_cast<BinaryExprNC*>( c)->AdjustTypesNCNull( g1, e1, g2, e2);
+      else
+	static_cast<BinaryExprNC*>( c)->AdjustTypesNC( g1, e1, g2, e2);
+    }
+  else
+    {
+      g1.reset( c->getFirstChild()->Eval());
+      g2.reset( c->getFirstChild()->getNextSibling()->Eval());
+      if( eq)
+	AdjustTypesObj( g1, g2);
+      else
+	AdjustTypes( g1, g2);
+      e1 = g1.get();
+      e2 = g2.get();
+    }
+
+  BaseGDL* cond = NULL;
+  mask.Reset( lib::where_compare_mask( e1, e2, op));
+  if( mask.get() == NULL)
+    {
+      // order is critical for EQ and NE: overload might just be defined
+      // for one of the object types
+      if( eq && e2 != NULL && e2->Type() == GDL_OBJ && e1->Type() != GDL_OBJ)
+	cond = (op == SIMD_EQ) ? e2->EqOp( e1) : e2->NeOp( e1);
+      else switch( op)
+	{
+	case SIMD_EQ: cond = e1->EqOp( e2); break;
+	case SIMD_NE: cond = e1->NeOp( e2); break;
+	case SIMD_LE: cond = e1->LeOp( e2); break;
+	case SIMD_LT: cond = e1->LtOp( e2); break;
+	case SIMD_GE: cond = e1->GeOp( e2); break;
+	default: cond = e1->GtOp( e2); break;
+	}
+    }
+  if( eq && !nc)
+    {
+      if( g1.Get() == NullGDL::GetSingleInstance())
+	g1.Release();
+      if( g2.Get() == NullGDL::GetSingleInstance())
+	g2.Release();
+    }
+  return cond;
+}
+
+// WHERE(cond[, ...]), cond being a comparison, or AND, OR, ~ of
+// comparisons: the operands of each comparison are evaluated (and
+// converted) as by its Eval(), then reduced directly to the mask of WHERE
+// (lib::where_compare_mask()), and the masks are combined word by word,
+// before the other parameters are defined. The first parameter of the
+// returned environment is then left undefined.
+// When the operands of a comparison are not of a real numeric type, the
+// condition is computed as by its Eval() and is the first parameter, mask
+// being unset.
+// Returns NULL, without evaluating anything, if the first parameter is not
+// such a condition.
+EnvT* FCALL_LIB_RETNEWNode::WhereCompareEnv( Guard<lib::WhereMaskT>& mask)
+{
+  ProgNodeP par = this->getFirstChild();
+  if( par == NULL || par->getType() != GDLTokenTypes::PARAEXPR)
+    return NULL;
+  ProgNodeP c = par->getFirstChild();
+  if( !WhereFusable( c))
+    return NULL;
+
+  BaseGDL* cond = WhereCondition( c, mask);
+
+  EnvT* newEnv=new EnvT( this, this->libFun);
+  newEnv->SetNextParUnchecked( cond);
+  ProgNode::interpreter->parameter_def_nocheck( par->getNextSibling(), newEnv);
+  return newEnv;
+}
+
+// reads TOTAL(a[ix]) in place (lib::total_view())
+class TotalViewReaderT: public StridedViewReaderT
+{
+public:
+  bool done;
+  TotalViewReaderT(): done( false) {}
+  BaseGDL* Read( BaseGDL* var, const StridedViewT& view)
+  {
+    BaseGDL* res = lib::total_view( var, view);
+    done = (res != NULL);
+    return res;
+  }
+};
+
+// TOTAL(a[ix]) without other parameter or keyword, ix made of ranges and
+// scalars: the selected elements are summed where they are, a[ix] is not
+// built. Otherwise TOTAL of a[ix] as usual. Returns NULL, without
+// evaluating anything, if the call is not of this form.
+BaseGDL* FCALL_LIB_RETNEWNode::TotalView()
+{
+  ProgNodeP par = this->getFirstChild();
+  if( par == NULL || par->getType() != GDLTokenTypes::PARAEXPR ||
+      par->getNextSibling() != NULL)
+    return NULL;
+  ProgNodeP a = par->getFirstChild();
+  if( a->getType() != GDLTokenTypes::ARRAYEXPR)
+    return NULL;
+
+  TotalViewReaderT reader;
+  BaseGDL* p0 = static_cast<ARRAYEXPRNode*>( a)->EvalView( &reader);
+  if( reader.done)
+    return p0;
+
+  EnvT* newEnv=new EnvT( this, this->libFun);
+  Guard<EnvT> guardEnv( newEnv);
+  newEnv->SetNextParUnchecked( p0);
+  return lib::total_fun( newEnv);
+}
+
 BaseGDL* FCALL_LIB_RETNEWNode::Eval()
 {
 // 	match(antlr::RefAST(_t),FCALL_LIB_RETNEW);
+    if( this->libFunFun == lib::total_fun)
+    {
+      BaseGDL* res = TotalView();
+      if( res != NULL)
+        return res;
+    }
+    if( this->libFunFun == lib::where_fun)
+    {
+      Guard<lib::WhereMaskT> mask;
+      EnvT* newEnv = WhereCompareEnv( mask);
+      if( newEnv != NULL)
+      {
+        Guard<EnvT> guardEnv( newEnv);
+        if( mask.get() != NULL)
+          return lib::where_mask_fun( newEnv, mask.get());
+        return lib::where_fun( newEnv);
+      }
+    }
+
     EnvT* newEnv=new EnvT( this, this->libFun);
 
     ProgNode::interpreter->parameter_def_nocheck(this->getFirstChild(), newEnv);
@@ -4141,6 +4461,13 @@ BaseGDL* DOTNode::Eval()
 } // DOTNode::Eval
 
 BaseGDL* ARRAYEXPRNode::Eval()
+{
+    return EvalView( NULL);
+}
+
+// Eval(), the strided view of the indexed elements of a variable (not
+// ASSOC) being passed to reader if not NULL (see ArrayIndexListT::IndexView())
+BaseGDL* ARRAYEXPRNode::EvalView( StridedViewReaderT* reader)
 {
     BaseGDL* res;
 
@@ -4300,6 +4627,8 @@ empty:
     else
     {
         ArrayIndexListGuard guard(aL);
+        if( reader != NULL)
+            return aL->IndexView( r, ixExprList, *reader);
         return aL->Index( r, ixExprList);
     }
     assert( false);
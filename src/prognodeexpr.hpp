@@ -21,6 +21,8 @@
 #include "prognode.hpp"
 #include "dpro.hpp"
 
+namespace lib { struct WhereMaskT;}
+
 
 class UnaryExpr: public DefaultNode
 {
@@ -107,6 +109,13 @@ public:
   {}
   BaseGDL** LEval();
   BaseGDL* Eval();
+  // WHERE(a op b), and AND, OR, ~ of comparisons
+  EnvT* WhereCompareEnv( Guard<lib::WhereMaskT>& mask);
+  // TOTAL(a[ix])
+  BaseGDL* TotalView();
+private:
+  static BaseGDL* WhereCondition( ProgNodeP c, Guard<lib::WhereMaskT>& mask);
+  static BaseGDL* WhereLogicalValue( bool isAnd, Guard<BaseGDL>& e1, Guard<BaseGDL>& e2);
 };
 
 class FCALL_LIB_DIRECTNode: public LeafNode
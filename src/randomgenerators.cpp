@@ -25,6 +25,7 @@
 #include "nullgdl.hpp"
 
 #include "gsl_fun.hpp"
+#include "simd_dispatch.hpp"
 
 #ifdef _MSC_VER
 #include "gtdhelper.hpp" //for gettimeofday()
@@ -68,13 +69,41 @@ namespace lib {
 #define GSL_M_E  2.7182818284590452354 /* e */
 
   //our own struct to keep up things related to parallel seeds
-  //it will contain all 128-bit internal state arrays, one per thread.
-  //as the number of threads is not known, it will be initialized at start.
+  //it will contain all 128-bit internal state arrays, one per substream (DSFMT_NSTREAMS).
   struct DSFMT_STATE {
     dsfmt_t **r; 
  };
  typedef struct DSFMT_STATE dsfmt_state;
-#define DEFINE_NCHUNK_FOR_dSFMT  int nchunk = (nEl >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= nEl)) ? CpuTPOOL_NTHREADS : 1;
+
+  // Reproducible parallel streams: the nEl values are cut into blocks that depend only on nEl, block b
+  // being always drawn from state b. The number of states (substreams) is fixed, not taken from the
+  // host, and the threads only decide where each block is computed: the values obtained for a given
+  // seed are the same on any machine, with or without OpenMP, and for any !CPU setting.
+  static const int DSFMT_NSTREAMS = 64;
+  static const SizeT DSFMT_MIN_BLOCK = 65536; //smaller arrays use the first state only, as before.
+
+  inline SizeT dsfmt_nblocks(SizeT nEl)
+  {
+    SizeT nblocks = nEl / DSFMT_MIN_BLOCK;
+    if (nblocks > (SizeT) DSFMT_NSTREAMS) nblocks = DSFMT_NSTREAMS;
+    return (nblocks < 1) ? 1 : nblocks;
+  }
+
+  // fill(dsfmt_t* r, T* res, SizeT n) draws n values from r.
+  template <typename T, typename Fill>
+  int random_blocks(T* res, dsfmt_state state, SizeT nEl, Fill fill)
+  {
+    SizeT nblocks = dsfmt_nblocks(nEl);
+    int nthreads = (nblocks > 1 && nEl >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= nEl)) ?
+      std::min((SizeT) CpuTPOOL_NTHREADS, nblocks) : 1;
+#pragma omp parallel for num_threads(nthreads) if (nthreads > 1) schedule(static,1)
+    for (OMPInt b = 0; b < nblocks; ++b) {
+      SizeT start_index = b * nEl / nblocks;
+      SizeT stop_index = (b + 1) * nEl / nblocks;
+      fill(state.r[b], res + start_index, stop_index - start_index);
+    }
+    return 0;
+  }
  
 
 // This function could prove to be way faster than the function below, provided the parallelization insures
@@ -92,49 +121,13 @@ namespace lib {
 //    return 0;
 //  }
   
-  int random_uniform(double* res, dsfmt_state state, SizeT nEl)
+  template <typename T>
+  int random_uniform(T* res, dsfmt_state state, SizeT nEl)
   {
     //no difficulty as we do not use aligned functions here.
-    DEFINE_NCHUNK_FOR_dSFMT
-    SizeT chunksize = nEl / nchunk;
-
-#pragma omp parallel num_threads(nchunk) if (nchunk > 1)
-    {
-      int thread_id = currentThreadNumber();
-      SizeT start_index, stop_index;
-      start_index = thread_id * chunksize;
-      if (thread_id != nchunk-1) //robust wrt. use of threads or not.
-      {
-        stop_index = start_index + chunksize;
-      } else {
-        stop_index = nEl;
-      }
-      SizeT i;
-      for (i=start_index; i<stop_index; ++i) res[i] = dsfmt_genrand_close_open(state.r[thread_id]);
-    }
-    return 0;
-  }
-
-  int random_uniform(float* res, dsfmt_state state, SizeT nEl)
-  {
-    DEFINE_NCHUNK_FOR_dSFMT
-    SizeT chunksize = nEl / nchunk;
-
-#pragma omp parallel num_threads(nchunk) if (nchunk > 1)
-    {
-      int thread_id = currentThreadNumber();
-      SizeT start_index, stop_index;
-      start_index = thread_id * chunksize;
-      if (thread_id != nchunk-1) //robust wrt. use of threads or not.
-      {
-        stop_index = start_index + chunksize;
-      } else {
-        stop_index = nEl;
-      }
-      SizeT i;
-      for (i=start_index; i<stop_index; ++i) res[i] = (float) dsfmt_genrand_close_open(state.r[thread_id]);
-    }
-    return 0;
+    return random_blocks(res, state, nEl, [](dsfmt_t* r, T* out, SizeT n) {
+      for (SizeT i = 0; i < n; ++i) out[i] = (T) dsfmt_genrand_close_open(r);
+    });
   }
 
   double dsfmt_gauss(dsfmt_t *r, const double sigma)
@@ -201,46 +194,35 @@ namespace lib {
 //    return 0;
 //  }
 
-  int random_normal(double* res, dsfmt_state state, SizeT nEl)
+  // Normal deviates by tiles: the uniforms of a tile are drawn first, then the Box-Muller transform,
+  // which uses both values of each pair and has no rejection, runs as a branch-free loop the compiler
+  // vectorizes (the boxMuller kernel of simd_dispatch.cpp, with the log, sin and cos of simd_math.hpp).
+  static const SizeT DSFMT_TILE = 256;
+
+  template <typename T>
+  void dsfmt_gauss_fill(dsfmt_t *r, T* res, SizeT n)
   {
-    DEFINE_NCHUNK_FOR_dSFMT
-    SizeT chunksize = nEl / nchunk;
-    #pragma omp parallel num_threads(nchunk) if (nchunk > 1)
-    {
-      int thread_id = currentThreadNumber();
-      SizeT start_index, stop_index;
-      start_index = thread_id * chunksize;
-      if (thread_id != nchunk-1) //robust wrt. use of threads or not.
-      {
-        stop_index = start_index + chunksize;
-      } else {
-        stop_index = nEl;
+    double u[DSFMT_TILE], v[DSFMT_TILE], z[2 * DSFMT_TILE];
+    SizeT done = 0;
+    while (done < n) {
+      SizeT npairs = std::min(DSFMT_TILE, (n - done + 1) / 2);
+      for (SizeT i = 0; i < npairs; ++i) {
+        u[i] = dsfmt_genrand_open_close(r); // (0,1]: log(u) is finite
+        v[i] = dsfmt_genrand_close_open(r);
       }
-      SizeT i;
-      for (i=start_index; i<stop_index; ++i) res[i] = dsfmt_gauss(state.r[thread_id],1.0);
+      SimdK().boxMuller(z, u, v, npairs);
+      SizeT m = std::min(2 * npairs, n - done); //an odd block discards its last value
+      for (SizeT i = 0; i < m; ++i) res[done + i] = (T) z[i];
+      done += m;
     }
-    return 0;
   }
-  
-  int random_normal( float* res, dsfmt_state state, SizeT nEl)
+
+  template <typename T>
+  int random_normal(T* res, dsfmt_state state, SizeT nEl)
   {
-    DEFINE_NCHUNK_FOR_dSFMT
-    SizeT chunksize = nEl / nchunk;
-    #pragma omp parallel num_threads(nchunk) if (nchunk > 1)
-    {
-      int thread_id = currentThreadNumber();
-      SizeT start_index, stop_index;
-      start_index = thread_id * chunksize;
-      if (thread_id != nchunk-1) //robust wrt. use of threads or not.
-      {
-        stop_index = start_index + chunksize;
-      } else {
-        stop_index = nEl;
-      }
-      SizeT i;
-      for (i=start_index; i<stop_index; ++i) res[i] = (float) dsfmt_gauss(state.r[thread_id],1.0);
-    }
-    return 0;
+    return random_blocks(res, state, nEl, [](dsfmt_t* r, T* out, SizeT n) {
+      dsfmt_gauss_fill(r, out, n);
+    });
   }
  
   //gamma, poisson and binomial distributions code taken from GSL and updated to use dSFMT generator.
@@ -296,6 +278,8 @@ namespace lib {
     return x;
   }
 
+  double dsfmt_ran_gamma(dsfmt_t * r, const double a, const double b);
+
   static double
   dsfmt_ran_gamma_int(dsfmt_t * r, const unsigned int a)
   {
@@ -314,7 +298,7 @@ namespace lib {
 
       return -log(prod);
     } else {
-      return dsfmt_gamma_large(r, (double) a);
+      return dsfmt_ran_gamma(r, (double) a, 1.0); //Marsaglia-Tsang: much faster than dsfmt_gamma_large()
     }
   }
 
@@ -464,180 +448,175 @@ namespace lib {
 
   }
 
-  int random_gamma(double* res, dsfmt_state state, SizeT nEl, DLong n)
+  // Gamma deviates of (integer) order a >= 1 by tiles, with the method of Marsaglia and Tsang
+  // (as dsfmt_ran_gamma() below): a tile of normal and uniform candidates is drawn, the acceptance
+  // test is computed for the whole tile without branches, then the accepted values are kept in order.
+  // About 2% of the candidates are rejected, whatever a.
+  template <typename T>
+  void dsfmt_gamma_fill(dsfmt_t *r, T* res, SizeT n, const double a)
   {
-    DEFINE_NCHUNK_FOR_dSFMT
-    SizeT chunksize = nEl / nchunk;
-#pragma omp parallel num_threads(nchunk) if (nchunk > 1)
-    {
-      int thread_id = currentThreadNumber();
-      SizeT start_index, stop_index;
-      start_index = thread_id * chunksize;
-      if (thread_id != nchunk - 1) //robust wrt. use of threads or not.
-      {
-        stop_index = start_index + chunksize;
-      } else {
-        stop_index = nEl;
+    const double d = a - 1.0 / 3.0;
+    const double c = (1.0 / 3.0) / sqrt(d);
+    double x[DSFMT_TILE], u[DSFMT_TILE], g[DSFMT_TILE];
+    SizeT done = 0;
+    while (done < n) {
+      dsfmt_gauss_fill(r, x, DSFMT_TILE);
+      for (SizeT i = 0; i < DSFMT_TILE; ++i) u[i] = dsfmt_genrand_open_open(r);
+      for (SizeT i = 0; i < DSFMT_TILE; ++i) {
+        double v = 1.0 + c * x[i];
+        double v3 = (v > 0) ? v * v * v : 1.0;
+        double x2 = x[i] * x[i];
+        bool accept = (v > 0) & ((u[i] < 1 - 0.0331 * x2 * x2) | (log(u[i]) < 0.5 * x2 + d * (1 - v3 + log(v3))));
+        g[i] = accept ? d * v3 : -1.0;
       }
-      SizeT i;
-      for (i = start_index; i < stop_index; ++i) res[i] = dsfmt_ran_gamma_knuth(state.r[thread_id], 1.0 * n, 1.0);
+      for (SizeT i = 0; i < DSFMT_TILE && done < n; ++i) if (g[i] >= 0) res[done++] = (T) g[i];
     }
-    return 0;
   }
 
-  int random_gamma(float* res, dsfmt_state state, SizeT nEl, DLong n)
+  template <typename T>
+  int random_gamma(T* res, dsfmt_state state, SizeT nEl, DLong n)
   {
-    DEFINE_NCHUNK_FOR_dSFMT
-    SizeT chunksize = nEl / nchunk;
-#pragma omp parallel num_threads(nchunk) if (nchunk > 1)
-    {
-      int thread_id = currentThreadNumber();
-      SizeT start_index, stop_index;
-      start_index = thread_id * chunksize;
-      if (thread_id != nchunk - 1) //robust wrt. use of threads or not.
-      {
-        stop_index = start_index + chunksize;
-      } else {
-        stop_index = nEl;
-      }
-      SizeT i;
-      for (i = start_index; i < stop_index; ++i) res[i] = (float) dsfmt_ran_gamma_knuth(state.r[thread_id], 1.0 * n, 1.0);
-    }
-    return 0;
+    const double a = n;
+    return random_blocks(res, state, nEl, [a](dsfmt_t* r, T* out, SizeT nb) {
+      dsfmt_gamma_fill(r, out, nb, a);
+    });
   }
-  
-  int random_binomial(double* res, dsfmt_state state, SizeT nEl, DDoubleGDL* binomialKey)
+
+  // Discrete deviates by inversion, by tiles: the CDF is tabulated once around the mode, then for a
+  // tile of uniforms the smallest k with u < cdf[k] is found by a binary search whose steps depend
+  // only on the table size, a branch-free loop over the tile the compiler can vectorize (gathers).
+  // The tails where the probability is below DSFMT_INV_TAIL times the one of the mode are left
+  // out of the table (a mass below 1e-18); larger tables than DSFMT_INV_MAX go to the scalar methods.
+  static const double DSFMT_INV_TAIL = 1e-20;
+  static const SizeT DSFMT_INV_MAX = 1 << 22;
+
+  // pm: probability of the mode m; up(k) = P(k+1)/P(k), down(k) = P(k-1)/P(k); the support is [0,kMax].
+  // Fills cdf for k in [kLo, kLo+cdf.size()), returns false if larger than maxSize.
+  template <typename Up, typename Down>
+  bool dsfmt_inversion_table(double m, double pm, double kMax, Up up, Down down, SizeT maxSize,
+    double& kLo, std::vector<double>& cdf)
   {
-    //Note: Binomial values are not same IDL.    
-    DULong n = (DULong) (*binomialKey)[0];
-    DDouble p = (DDouble) (*binomialKey)[1];
-    DEFINE_NCHUNK_FOR_dSFMT
-    SizeT chunksize = nEl / nchunk;
-    #pragma omp parallel num_threads(nchunk) if (nchunk > 1)
-    {
-      int thread_id = currentThreadNumber();
-      SizeT start_index, stop_index;
-      start_index = thread_id * chunksize;
-      if (thread_id != nchunk - 1) //robust wrt. use of threads or not.
-      {
-        stop_index = start_index + chunksize;
-      } else {
-        stop_index = nEl;
+    std::vector<double> lo, hi;
+    double pk = pm;
+    for (double k = m; k < kMax; ++k) {
+      pk *= up(k);
+      if (!(pk >= DSFMT_INV_TAIL * pm)) break;
+      hi.push_back(pk);
+      if (hi.size() > maxSize) return false;
+    }
+    pk = pm;
+    for (double k = m; k > 0; --k) {
+      pk *= down(k);
+      if (!(pk >= DSFMT_INV_TAIL * pm)) break;
+      lo.push_back(pk);
+      if (lo.size() + hi.size() >= maxSize) return false;
+    }
+    kLo = m - lo.size();
+    cdf.resize(lo.size() + 1 + hi.size());
+    SizeT j = 0;
+    double sum = 0;
+    for (SizeT i = lo.size(); i > 0; --i) cdf[j++] = (sum += lo[i - 1]);
+    cdf[j++] = (sum += pm);
+    for (SizeT i = 0; i < hi.size(); ++i) cdf[j++] = (sum += hi[i]);
+    for (SizeT i = 0; i < cdf.size(); ++i) cdf[i] /= sum;
+    cdf.back() = 1.0; // u < 1 always falls in the table
+    return true;
+  }
+
+  template <typename T>
+  void dsfmt_inversion_fill(dsfmt_t *r, T* res, SizeT n, const double* cdf, SizeT w, double kLo)
+  {
+    double u[DSFMT_TILE];
+    SizeT pos[DSFMT_TILE];
+    for (SizeT done = 0; done < n; done += DSFMT_TILE) {
+      SizeT m = std::min(DSFMT_TILE, n - done);
+      for (SizeT i = 0; i < m; ++i) {
+        u[i] = dsfmt_genrand_close_open(r);
+        pos[i] = 0;
+      }
+      for (SizeT len = w; len > 1;) {
+        SizeT half = len / 2;
+        for (SizeT i = 0; i < m; ++i) pos[i] += (cdf[pos[i] + half] <= u[i]) ? half : 0;
+        len -= half;
       }
-      SizeT i;
-      for (i = start_index; i < stop_index; ++i) res[i] = dsfmt_ran_binomial_knuth(state.r[thread_id], p, n);
+      for (SizeT i = 0; i < m; ++i) res[done + i] = (T) (kLo + pos[i] + ((cdf[pos[i]] <= u[i]) ? 1 : 0));
     }
-    return 0;    
   }
-  
-  int random_binomial(float* res, dsfmt_state state, SizeT nEl, DDoubleGDL* binomialKey)
+
+  template <typename T>
+  int random_inversion(T* res, dsfmt_state state, SizeT nEl, const std::vector<double>& cdf, double kLo)
+  {
+    return random_blocks(res, state, nEl, [&cdf, kLo](dsfmt_t* r, T* out, SizeT nb) {
+      dsfmt_inversion_fill(r, out, nb, &cdf[0], cdf.size(), kLo);
+    });
+  }
+
+  // table sizes worth building for nEl values
+  inline SizeT dsfmt_inversion_max(SizeT nEl)
+  {
+    return std::min(DSFMT_INV_MAX, std::max(nEl, (SizeT) 1024));
+  }
+
+  template <typename T>
+  int random_binomial(T* res, dsfmt_state state, SizeT nEl, DDoubleGDL* binomialKey)
   {
     //Note: Binomial values are not same IDL.    
     DULong n = (DULong) (*binomialKey)[0];
     DDouble p = (DDouble) (*binomialKey)[1];
-    DEFINE_NCHUNK_FOR_dSFMT
-    SizeT chunksize = nEl / nchunk;
-    #pragma omp parallel num_threads(nchunk) if (nchunk > 1)
-    {
-      int thread_id = currentThreadNumber();
-      SizeT start_index, stop_index;
-      start_index = thread_id * chunksize;
-      if (thread_id != nchunk - 1) //robust wrt. use of threads or not.
-      {
-        stop_index = start_index + chunksize;
-      } else {
-        stop_index = nEl;
-      }
-      SizeT i;
-      for (i = start_index; i < stop_index; ++i) res[i] = (float) dsfmt_ran_binomial_knuth(state.r[thread_id], p, n);
-    }
-    return 0;    
-  }
-  
-  int random_poisson(double* res, dsfmt_state state, SizeT nEl, DDoubleGDL* poissonKey)
-  {
-    DDouble mu = (DDouble) (*poissonKey)[0];
-    DEFINE_NCHUNK_FOR_dSFMT
-    SizeT chunksize = nEl / nchunk;
-    #pragma omp parallel num_threads(nchunk) if (nchunk > 1)
-    {
-      int thread_id = currentThreadNumber();
-      SizeT start_index, stop_index;
-      start_index = thread_id * chunksize;
-      if (thread_id != nchunk - 1) //robust wrt. use of threads or not.
-      {
-        stop_index = start_index + chunksize;
-      } else {
-        stop_index = nEl;
-      }
-      SizeT i;
-      for (i = start_index; i < stop_index; ++i) res[i] = dsfmt_ran_poisson(state.r[thread_id], mu);
-    }
-    return 0;
+    std::vector<double> cdf;
+    double kLo;
+    if (p == 0 || p == 1) {
+      cdf.assign(1, 1.0);
+      kLo = (p == 0) ? 0 : n;
+      return random_inversion(res, state, nEl, cdf, kLo);
+    }
+    const double q = 1 - p;
+    double m = std::min(floor((n + 1.0) * p), (double) n);
+    double pm = exp(lgamma(n + 1.0) - lgamma(m + 1) - lgamma(n - m + 1) + m * log(p) + (n - m) * log(q));
+    if (dsfmt_inversion_table(m, pm, n,
+      [n, p, q](double k) { return (n - k) / (k + 1) * (p / q); },
+      [n, p, q](double k) { return k / (n - k + 1) * (q / p); },
+      dsfmt_inversion_max(nEl), kLo, cdf))
+      return random_inversion(res, state, nEl, cdf, kLo);
+    return random_blocks(res, state, nEl, [n, p](dsfmt_t* r, T* out, SizeT nb) {
+      for (SizeT i = 0; i < nb; ++i) out[i] = (T) dsfmt_ran_binomial_knuth(r, p, n);
+    });
   }
 
-  int random_poisson(float* res, dsfmt_state state, SizeT nEl, DDoubleGDL* poissonKey)
+  template <typename T>
+  int random_poisson(T* res, dsfmt_state state, SizeT nEl, DDoubleGDL* poissonKey)
   {
     DDouble mu = (DDouble) (*poissonKey)[0];
-    DEFINE_NCHUNK_FOR_dSFMT
-    SizeT chunksize = nEl / nchunk;
-    #pragma omp parallel num_threads(nchunk) if (nchunk > 1)
-    {
-      int thread_id = currentThreadNumber();
-      SizeT start_index, stop_index;
-      start_index = thread_id * chunksize;
-      if (thread_id != nchunk-1) //robust wrt. use of threads or not.
-      {
-        stop_index = start_index + chunksize;
-      } else {
-        stop_index = nEl;
-      }
-      SizeT i;
-      for (i=start_index; i<stop_index; ++i) res[i] = (float) dsfmt_ran_poisson(state.r[thread_id], mu);
-    }
-    return 0;
+    std::vector<double> cdf;
+    double kLo = 0;
+    if (mu == 0) {
+      cdf.assign(1, 1.0);
+      return random_inversion(res, state, nEl, cdf, kLo);
+    }
+    double m = floor(mu);
+    double pm = exp(m * log(mu) - mu - lgamma(m + 1));
+    if (dsfmt_inversion_table(m, pm, std::numeric_limits<double>::infinity(),
+      [mu](double k) { return mu / (k + 1); },
+      [mu](double k) { return k / mu; },
+      dsfmt_inversion_max(nEl), kLo, cdf))
+      return random_inversion(res, state, nEl, cdf, kLo);
+    return random_blocks(res, state, nEl, [mu](dsfmt_t* r, T* out, SizeT nb) {
+      for (SizeT i = 0; i < nb; ++i) out[i] = (T) dsfmt_ran_poisson(r, mu);
+    });
   }
 
   int random_dlong(DLong* res, dsfmt_state state, SizeT nEl)
   {
-    DEFINE_NCHUNK_FOR_dSFMT
-    SizeT chunksize = nEl / nchunk;
-    #pragma omp parallel num_threads(nchunk) if (nchunk > 1)
-    {
-      int thread_id = currentThreadNumber();
-      SizeT start_index, stop_index;
-      start_index = thread_id * chunksize;
-      if (thread_id != nchunk - 1) //robust wrt. use of threads or not.
-      {
-        stop_index = start_index + chunksize;
-      } else {
-        stop_index = nEl;
-      }
-      SizeT i;
-      for (i = start_index; i < stop_index; ++i) res[i] = dsfmt_genrand_int31(state.r[thread_id]); //int31 as in [0..2^31-1] 
-    }
-    return 0;
+    return random_blocks(res, state, nEl, [](dsfmt_t* r, DLong* out, SizeT n) {
+      for (SizeT i = 0; i < n; ++i) out[i] = dsfmt_genrand_int31(r); //int31 as in [0..2^31-1] 
+    });
   }
 
   int random_dulong(DULong* res, dsfmt_state state, SizeT nEl)
   {
-    DEFINE_NCHUNK_FOR_dSFMT
-    SizeT chunksize = nEl / nchunk;
-    #pragma omp parallel num_threads(nchunk) if (nchunk > 1)
-    {
-      int thread_id = currentThreadNumber();
-      SizeT start_index, stop_index;
-      start_index = thread_id * chunksize;
-      if (thread_id != nchunk - 1) //robust wrt. use of threads or not.
-      {
-        stop_index = start_index + chunksize;
-      } else {
-        stop_index = nEl;
-      }
-      SizeT i;
-      for (i = start_index; i < stop_index; ++i) res[i] = dsfmt_genrand_uint32(state.r[thread_id]); //int31 as in [0..2^31-1] 
-    }
-    return 0;
+    return random_blocks(res, state, nEl, [](dsfmt_t* r, DULong* out, SizeT n) {
+      for (SizeT i = 0; i < n; ++i) out[i] = dsfmt_genrand_uint32(r);
+    });
   }  
   
   void set_random_state(dsfmt_t *dsfmt_mem, const DULong64* seedState, const int pos)
@@ -650,13 +629,13 @@ namespace lib {
   void get_random_state(EnvT* e, dsfmt_state state, const DULong seed)
   {
     if (e->GlobalPar(0)) {
-      DULong64GDL* ret = new DULong64GDL(dimension(1+(DSFMT_N64+1)*maxNumberOfThreads()), BaseGDL::NOZERO);
+      DULong64GDL* ret = new DULong64GDL(dimension(1+(DSFMT_N64+1)*DSFMT_NSTREAMS), BaseGDL::NOZERO);
       DULong64* newstate = (DULong64*) (ret->DataAddr());
       long k=0;
       newstate[k++] = seed;
-      for (int ithread=0; ithread < maxNumberOfThreads() ; ++ithread) {
-        newstate[k++] = state.r[ithread]->idx;
-        uint64_t *psfmt64 = &(state.r[ithread]->status[0].u[0]);
+      for (int istream=0; istream < DSFMT_NSTREAMS ; ++istream) {
+        newstate[k++] = state.r[istream]->idx;
+        uint64_t *psfmt64 = &(state.r[istream]->status[0].u[0]);
         for (int j = 0; j < DSFMT_N64; ++j) newstate[k++] = psfmt64[j];
       }
       e->SetPar(0, ret);
@@ -674,14 +653,16 @@ namespace lib {
   // written by the authors above. It permits to "jump" the seed to a new state as if 2^{128} 
   // random numbers had been generated in the meantime. (This in a random series with a period of 2^19937 !).
   // Note: 2^128 is already way larger than the number of particles in the Universe.
-  // The implementation creates maxNumberOfThreads() seed states, separated by a 2^{128} state jump,
-  // and run TPOOL_NTHREADS in parallell, each continuing with its own seed.
+  // The implementation creates DSFMT_NSTREAMS seed states, separated by a 2^{128} state jump.
+  // Large arrays are cut in at most DSFMT_NSTREAMS blocks, each drawn from its own state, and
+  // the blocks are run TPOOL_NTHREADS in parallel (see random_blocks()): for a given seed the values
+  // do not depend on the number of threads actually used.
   
   // The price to pay is that **the produced random numbers are not the same as IDL**.
   // To get values comparable with IDL, but slowly, use the /RAN1 switch (1) (or do not enable dSFMT).  
   // Moreover, the seed arrays are different. Switching from one to another is *NOT* possible as the
-  // types and seed lengths are different. Besides, our dSFMT seed is, because of the use of parallel threads
-  // to speed up the random generator, approx NTHREADS larger than the IDL one (not a big deal!).
+  // types and seed lengths are different. Besides, our dSFMT seed is, because of the use of parallel substreams
+  // to speed up the random generator, approx DSFMT_NSTREAMS larger than the IDL one (not a big deal!).
   
   // (1) Why /RAN1? Because this option is present in IDL, and, instead of throwing an error on it,
   // we use it also as a compatibility switch. But in our case the compatibility is with IDL8+
@@ -689,17 +670,17 @@ namespace lib {
   
 #include "dSFMT/dSFMT-jump.c"
 
- //this initializes parallel states up to min of max_allowed_threads and omp_max_threads.
- //independently of the fact that only a subset of theses thtreads will be used in loops.
+ //this initializes the DSFMT_NSTREAMS parallel states,
+ //independently of the fact that only a subset of them will be used in loops.
  void init_seeds(dsfmt_state state, DULong seed) {
    //populate with seed template state 'temp'
    dsfmt_t temp;   
    dsfmt_init_gen_rand(&temp, seed);
    //sucessively push by 2^128 and copy to next place
-   //Note: we use the maximum number of threads allowed as this seed can be replayed
-   //after changing the number of threads to be used.
+   //Note: the number of states does not depend on the host, so that this seed can be replayed
+   //on any machine and after changing the number of threads to be used.
    memcpy((void*)(state.r[0]),(void*)&temp,sizeof(temp));
-   for (int i=1; i<maxNumberOfThreads(); ++i) {
+   for (int i=1; i<DSFMT_NSTREAMS; ++i) {
      dSFMT_jump(&temp, poly_128);
      memcpy((void*)(state.r[i]),(void*)&temp,sizeof(temp));
    }
@@ -733,8 +714,8 @@ namespace lib {
     static dsfmt_state dsfmt_mem;
     //initialize only once!
     if (dsfmt_mem.r==NULL) {
-      dsfmt_mem.r=(dsfmt_t**)malloc(maxNumberOfThreads()*sizeof(dsfmt_t*));
-      {for (int i=0; i< maxNumberOfThreads() ; ++i) dsfmt_mem.r[i]=(dsfmt_t*)malloc(sizeof(dsfmt_t));}
+      dsfmt_mem.r=(dsfmt_t**)malloc(DSFMT_NSTREAMS*sizeof(dsfmt_t*));
+      {for (int i=0; i< DSFMT_NSTREAMS ; ++i) dsfmt_mem.r[i]=(dsfmt_t*)malloc(sizeof(dsfmt_t));}
     }
 
     SizeT nParam = e->NParam(1);
@@ -750,25 +731,25 @@ namespace lib {
     if (!isAnull) { //something is passed
       // IDL does not check that the seed sequence has been changed: as long as it is a 628 element Ulong, it takes it
       // and use it as the current sequence (try with "all zeroes").
-      // for us, a valid seed sequence is the content of dsfmt_mem.r, i.e, (DSFMT_N64+1)*maxNumberOfThreads(), 
+      // for us, a valid seed sequence is the content of dsfmt_mem.r, i.e, (DSFMT_N64+1)*DSFMT_NSTREAMS, 
       // plus the memory of the initial seed value.
       if (p0->Type() == GDL_ULONG64) { //good chances we have here a genuine dSFMT seed!
         DULong64GDL* p0L = e->IfDefGetParAs< DULong64GDL>(0);
-        if (p0L->N_Elements() == 1 + (DSFMT_N64 + 1) * maxNumberOfThreads()) {
+        if (p0L->N_Elements() == 1 + (DSFMT_N64 + 1) * DSFMT_NSTREAMS) {
           long k = 0;
           seed = (*p0L)[k++]; //hopefully it is always compatible with an unisgned int32 as reslut of a saved previous seed.
-          for (int ithread = 0; ithread < maxNumberOfThreads(); ++ithread) {
+          for (int istream = 0; istream < DSFMT_NSTREAMS; ++istream) {
             int pos = (*p0L)[k++];
             DULong64 sequence[DSFMT_N64];
             for (int i = 0; i < DSFMT_N64; ++i) sequence[i] = (*p0L)[k++];
-            set_random_state(dsfmt_mem.r[ithread], sequence, pos); //initialize each thread seed 
+            set_random_state(dsfmt_mem.r[istream], sequence, pos); //initialize each substream seed 
           }
           initialized=true;
         } else { // not a seed sequence: take first value as 32 bit UNsigned integer (for dSFMT compatibility).
           DULongGDL* p02L = e->IfDefGetParAs< DULongGDL>(0);
           if (p02L->N_Elements() > 0) {
             seed = (*p02L)[0];
-            //this initialize all the maxNumberOfThreads() parallel states, as a new seed has been given.
+            //this initialize all the DSFMT_NSTREAMS parallel states, as a new seed has been given.
             init_seeds(dsfmt_mem, seed);
             initialized=true;
           }
@@ -777,7 +758,7 @@ namespace lib {
         DULongGDL* p0L = e->IfDefGetParAs< DULongGDL>(0);
         if (p0L->N_Elements() > 0) {
           seed = (*p0L)[0];
-          //this initialize all the maxNumberOfThreads() parallel states, as a new seed has been given.
+          //this initialize all the DSFMT_NSTREAMS parallel states, as a new seed has been given.
           init_seeds(dsfmt_mem, seed);
           initialized=true;
         }
@@ -20,6 +20,8 @@
 
 #include <limits>
 
+#include "typedefs.hpp"
+
 template< typename IntT, typename RealT>
 inline IntT Real2Int( const RealT r)
 {
@@ -38,6 +40,16 @@ inline IntT Real2Int( const RealT r)
 }
 
 
+// subscript from a real value: <= 0 gives 0, values too large for an index
+// (and NaN) the largest index, to be clipped to (or rejected as) out of range
+template< typename RealT>
+inline SizeT Real2Index( const RealT r)
+{
+  if( r <= 0) return 0;
+  if( !(r < static_cast< RealT>( 9.2e18))) return std::numeric_limits< SizeT>::max();
+  return static_cast< SizeT>( static_cast< DLong64>( r));
+}
+
 template< typename RealT>
 inline DByte Real2DByte( const RealT r)
 {
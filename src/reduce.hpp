@@ -0,0 +1,528 @@
+/***************************************************************************
+                          reduce.hpp  -  deterministic parallel sums and products
+                             -------------------
+    begin                : Oct 2026
+    copyright            : (C) 2026 by the GDL team
+    email                :
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+// Reduction engine of TOTAL, PRODUCT, MEAN and MOMENT for floating point
+// values. The elements are cut in blocks of REDUCE_BLOCK elements starting
+// at 0, each block is reduced on REDUCE_LANES interleaved accumulators
+// (a loop the compiler vectorizes) folded pairwise, and the block results are
+// combined in block order, with Neumaier's compensated summation for sums.
+// The blocks are computed in parallel, but nothing depends on which thread
+// did what: the result is bit-identical for any !CPU setting.
+// Values are accumulated in double (float input included), the caller
+// converts the result back if needed.
+// 'get(i)' returns the (converted, NaN-filtered...) contribution of element i.
+// Integer sums and products are exact (modulo wrap-around) and keep their
+// OpenMP reductions.
+// Then the reductions along a dimension, the single-pass moments of MOMENT
+// and the prefix scans of the /CUMULATIVE options.
+
+#ifndef REDUCE_HPP_
+#define REDUCE_HPP_
+
+#include <cmath>
+#include <complex>
+#include <vector>
+
+#include "typedefs.hpp"
+
+namespace lib {
+
+  const SizeT REDUCE_BLOCK = 4096;
+  const int REDUCE_LANES = 8;
+
+  // several sums computed in the same pass (e.g. the moments and the count of finite values)
+  template<int K>
+  struct ReduceSums
+  {
+    DDouble v[K];
+    ReduceSums() { for (int k = 0; k < K; ++k) v[k] = 0; }
+    ReduceSums& operator+=(const ReduceSums& o) { for (int k = 0; k < K; ++k) v[k] += o.v[k]; return *this; }
+  };
+
+  // Neumaier: s + c is the sum, c gathers the rounding errors
+  inline void CompensatedAdd(DDouble& s, DDouble& c, DDouble v)
+  {
+    DDouble t = s + v;
+    if (std::fabs(s) >= std::fabs(v)) c += (s - t) + v; else c += (v - t) + s;
+    s = t;
+  }
+
+  inline DDouble CompensatedResult(DDouble s, DDouble c)
+  {
+    return std::isfinite(s) ? s + c : s; // c is meaningless once s is Inf or NaN
+  }
+
+  inline void CompensatedAdd(DComplexDbl& s, DComplexDbl& c, DComplexDbl v)
+  {
+    DDouble sr = s.real(), si = s.imag(), cr = c.real(), ci = c.imag();
+    CompensatedAdd(sr, cr, v.real());
+    CompensatedAdd(si, ci, v.imag());
+    s = DComplexDbl(sr, si);
+    c = DComplexDbl(cr, ci);
+  }
+
+  inline DComplexDbl CompensatedResult(DComplexDbl s, DComplexDbl c)
+  {
+    return DComplexDbl(CompensatedResult(s.real(), c.real()), CompensatedResult(s.imag(), c.imag()));
+  }
+
+  template<int K>
+  inline void CompensatedAdd(ReduceSums<K>& s, ReduceSums<K>& c, const ReduceSums<K>& v)
+  {
+    for (int k = 0; k < K; ++k) CompensatedAdd(s.v[k], c.v[k], v.v[k]);
+  }
+
+  template<int K>
+  inline ReduceSums<K> CompensatedResult(const ReduceSums<K>& s, const ReduceSums<K>& c)
+  {
+    ReduceSums<K> r;
+    for (int k = 0; k < K; ++k) r.v[k] = CompensatedResult(s.v[k], c.v[k]);
+    return r;
+  }
+
+  template<typename A, typename Get>
+  inline A ReduceBlockSum(Get& get, SizeT start, SizeT stop)
+  {
+    A lane[REDUCE_LANES];
+    for (int l = 0; l < REDUCE_LANES; ++l) lane[l] = A();
+    SizeT i = start;
+    for (; i + REDUCE_LANES <= stop; i += REDUCE_LANES)
+      for (int l = 0; l < REDUCE_LANES; ++l) lane[l] += get(i + l);
+    for (int l = 0; i < stop; ++i, ++l) lane[l] += get(i);
+    for (int w = REDUCE_LANES / 2; w > 0; w /= 2)
+      for (int l = 0; l < w; ++l) lane[l] += lane[l + w];
+    return lane[0];
+  }
+
+  template<typename A, typename Get>
+  inline A ReduceBlockProduct(Get& get, SizeT start, SizeT stop)
+  {
+    A lane[REDUCE_LANES];
+    for (int l = 0; l < REDUCE_LANES; ++l) lane[l] = A(1);
+    SizeT i = start;
+    for (; i + REDUCE_LANES <= stop; i += REDUCE_LANES)
+      for (int l = 0; l < REDUCE_LANES; ++l) lane[l] *= get(i + l);
+    for (int l = 0; i < stop; ++i, ++l) lane[l] *= get(i);
+    for (int w = REDUCE_LANES / 2; w > 0; w /= 2)
+      for (int l = 0; l < w; ++l) lane[l] *= lane[l + w];
+    return lane[0];
+  }
+
+  // the block results, computed in parallel when worth it
+  template<typename A, typename Get, typename Block>
+  inline void ReduceBlocks(SizeT nEl, Get& get, Block block, std::vector<A>& partial)
+  {
+    SizeT nBlocks = (nEl + REDUCE_BLOCK - 1) / REDUCE_BLOCK;
+    partial.resize(nBlocks);
+#pragma omp parallel for if (nBlocks > 1 && nEl >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= nEl))
+    for (OMPInt b = 0; b < nBlocks; ++b) {
+      SizeT start = b * REDUCE_BLOCK;
+      SizeT stop = (start + REDUCE_BLOCK < nEl) ? start + REDUCE_BLOCK : nEl;
+      partial[b] = block(get, start, stop);
+    }
+  }
+
+  template<typename A, typename Get>
+  A ReduceSum(SizeT nEl, Get get)
+  {
+    if (nEl <= REDUCE_BLOCK) return ReduceBlockSum<A>(get, 0, nEl);
+    std::vector<A> partial;
+    ReduceBlocks(nEl, get, ReduceBlockSum<A, Get>, partial);
+    A s = A(), c = A();
+    for (SizeT b = 0; b < partial.size(); ++b) CompensatedAdd(s, c, partial[b]);
+    return CompensatedResult(s, c);
+  }
+
+  template<typename A, typename Get>
+  A ReduceProduct(SizeT nEl, Get get)
+  {
+    if (nEl <= REDUCE_BLOCK) return ReduceBlockProduct<A>(get, 0, nEl);
+    std::vector<A> partial;
+    ReduceBlocks(nEl, get, ReduceBlockProduct<A, Get>, partial);
+    A p = A(1);
+    for (SizeT b = 0; b < partial.size(); ++b) p *= partial[b];
+    return p;
+  }
+
+  // TOTAL of real values (any numeric type), in double
+  template<typename Ty>
+  DDouble ReduceTotal(const Ty* data, SizeT nEl, bool omitNaN)
+  {
+    if (omitNaN) return ReduceSum<DDouble>(nEl, [data](SizeT i) {
+        DDouble v = data[i];
+        return std::isfinite(v) ? v : 0.0;
+      });
+    return ReduceSum<DDouble>(nEl, [data](SizeT i) { return static_cast<DDouble>(data[i]); });
+  }
+
+  // complex values: real and imaginary parts are filtered separately, as in AddOmitNaN
+  template<typename Ty>
+  DComplexDbl ReduceTotal(const std::complex<Ty>* data, SizeT nEl, bool omitNaN)
+  {
+    if (omitNaN) return ReduceSum<DComplexDbl>(nEl, [data](SizeT i) {
+        DDouble r = data[i].real(), im = data[i].imag();
+        return DComplexDbl(std::isfinite(r) ? r : 0.0, std::isfinite(im) ? im : 0.0);
+      });
+    return ReduceSum<DComplexDbl>(nEl, [data](SizeT i) { return DComplexDbl(data[i].real(), data[i].imag()); });
+  }
+
+  // ReduceTotal() of nEl values which are not stored in an array: gather(buf, start, stop)
+  // writes the values start to stop-1 to buf (e.g. from a strided view of a variable).
+  // Each block is gathered then summed as by ReduceTotal(), and the blocks are combined
+  // the same way: the result is the one of ReduceTotal() on the gathered array.
+  template<typename Ty, typename Gather>
+  auto ReduceTotalGathered(SizeT nEl, bool omitNaN, Gather gather)
+    -> decltype(ReduceTotal(static_cast<const Ty*>(NULL), nEl, omitNaN))
+  {
+    typedef decltype(ReduceTotal(static_cast<const Ty*>(NULL), nEl, omitNaN)) A;
+    SizeT nBlocks = (nEl + REDUCE_BLOCK - 1) / REDUCE_BLOCK;
+    std::vector<A> partial(nBlocks);
+#pragma omp parallel for if (nBlocks > 1 && nEl >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= nEl))
+    for (OMPInt b = 0; b < nBlocks; ++b) {
+      Ty buf[REDUCE_BLOCK];
+      SizeT start = b * REDUCE_BLOCK;
+      SizeT stop = (start + REDUCE_BLOCK < nEl) ? start + REDUCE_BLOCK : nEl;
+      gather(buf, start, stop);
+      partial[b] = ReduceTotal(static_cast<const Ty*>(buf), stop - start, omitNaN);
+    }
+    if (nBlocks == 1) return partial[0];
+    A s = A(), c = A();
+    for (SizeT b = 0; b < nBlocks; ++b) CompensatedAdd(s, c, partial[b]);
+    return CompensatedResult(s, c);
+  }
+
+  template<typename Ty>
+  DDouble ReduceProduct(const Ty* data, SizeT nEl, bool omitNaN)
+  {
+    if (omitNaN) return ReduceProduct<DDouble>(nEl, [data](SizeT i) {
+        DDouble v = data[i];
+        return std::isfinite(v) ? v : 1.0;
+      });
+    return ReduceProduct<DDouble>(nEl, [data](SizeT i) { return static_cast<DDouble>(data[i]); });
+  }
+
+  template<typename Ty>
+  DComplexDbl ReduceProduct(const std::complex<Ty>* data, SizeT nEl, bool omitNaN)
+  {
+    if (omitNaN) return ReduceProduct<DComplexDbl>(nEl, [data](SizeT i) {
+        DDouble r = data[i].real(), im = data[i].imag();
+        return DComplexDbl(std::isfinite(r) ? r : 1.0, std::isfinite(im) ? im : 1.0);
+      });
+    return ReduceProduct<DComplexDbl>(nEl, [data](SizeT i) { return DComplexDbl(data[i].real(), data[i].imag()); });
+  }
+
+  // Reductions along a dimension (size nRows, stride 'stride') of an array of
+  // nEl elements: output c of the outer slice o gathers the elements
+  // o*nRows*stride + k*stride + c. Rather than walking each output with the
+  // stride, task(o, c0, nc) accumulates whole rows of nc <= REDUCE_COLUMNS
+  // contiguous columns into the outputs c0..c0+nc-1 of the slice (an inner
+  // loop the compiler vectorizes); the tasks are independent and run in
+  // parallel. Each output still sees its values in increasing k order.
+  const SizeT REDUCE_COLUMNS = 512;
+
+  template<typename Task>
+  void ReduceAlongDim(SizeT nEl, SizeT nRows, SizeT stride, Task task)
+  {
+    SizeT nOuter = nEl / (nRows * stride);
+    SizeT nChunks = (stride + REDUCE_COLUMNS - 1) / REDUCE_COLUMNS;
+    OMPInt nTasks = nOuter * nChunks;
+#pragma omp parallel for if (nTasks > 1 && nEl >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= nEl))
+    for (OMPInt t = 0; t < nTasks; ++t) {
+      SizeT c0 = (t % nChunks) * REDUCE_COLUMNS;
+      task(t / nChunks, c0, (c0 + REDUCE_COLUMNS < stride) ? REDUCE_COLUMNS : stride - c0);
+    }
+  }
+
+  // Central moments of real values, for MOMENT (and VARIANCE, STDDEV,
+  // SKEWNESS, KURTOSIS): the data are read once. Each block of
+  // REDUCE_BLOCK values is reduced while it is in cache (its mean, then the
+  // sums of the 2nd to 4th powers of the deviations to that mean) and the
+  // blocks are merged in order with the pairwise formulas of Chan et al.
+  // and Pebay, as stable as a two-pass computation and independent of the
+  // number of threads. Non-finite values are skipped with omitNaN.
+  struct Moments
+  {
+    DDouble n, mean, m2, m3, m4; // count, mean, sums of (x-mean)^2,3,4
+    Moments() : n(0), mean(0), m2(0), m3(0), m4(0) {}
+  };
+
+  inline void MomentsMerge(Moments& a, const Moments& b)
+  {
+    if (b.n == 0) return;
+    if (a.n == 0) { a = b; return; }
+    DDouble n = a.n + b.n;
+    DDouble d = b.mean - a.mean;
+    DDouble dn = d / n;
+    DDouble dn2 = dn * dn;
+    DDouble nab = a.n * b.n;
+    DDouble t2 = d * dn * nab;
+    a.m4 += b.m4 + t2 * dn2 * (a.n * a.n - nab + b.n * b.n)
+      + 6 * dn2 * (a.n * a.n * b.m2 + b.n * b.n * a.m2) + 4 * dn * (a.n * b.m3 - b.n * a.m3);
+    a.m3 += b.m3 + t2 * dn * (a.n - b.n) + 3 * dn * (a.n * b.m2 - b.n * a.m2);
+    a.m2 += b.m2 + t2;
+    a.mean += b.n * dn;
+    a.n = n;
+  }
+
+  template<typename Ty>
+  inline Moments MomentsBlock(const Ty* data, SizeT start, SizeT stop, bool omitNaN)
+  {
+    Moments r;
+    if (omitNaN) {
+      auto get = [data](SizeT i) {
+        ReduceSums<2> s;
+        DDouble v = data[i];
+        if (std::isfinite(v)) { s.v[0] = v; s.v[1] = 1; }
+        return s;
+      };
+      ReduceSums<2> s = ReduceBlockSum<ReduceSums<2> >(get, start, stop);
+      r.n = s.v[1];
+      if (r.n == 0) return r;
+      r.mean = s.v[0] / r.n;
+    } else {
+      auto get = [data](SizeT i) { return static_cast<DDouble>(data[i]); };
+      r.n = stop - start;
+      r.mean = ReduceBlockSum<DDouble>(get, start, stop) / r.n;
+    }
+    DDouble mean = r.mean;
+    auto dev = [data, mean, omitNaN](SizeT i) {
+      ReduceSums<3> s;
+      DDouble d = data[i] - mean;
+      if (!omitNaN || std::isfinite(d)) { DDouble d2 = d * d; s.v[0] = d2; s.v[1] = d2 * d; s.v[2] = d2 * d2; }
+      return s;
+    };
+    ReduceSums<3> s = ReduceBlockSum<ReduceSums<3> >(dev, start, stop);
+    r.m2 = s.v[0];
+    r.m3 = s.v[1];
+    r.m4 = s.v[2];
+    return r;
+  }
+
+  template<typename Ty>
+  Moments ReduceMoments(const Ty* data, SizeT nEl, bool omitNaN)
+  {
+    if (nEl <= REDUCE_BLOCK) return MomentsBlock(data, 0, nEl, omitNaN);
+    SizeT nBlocks = (nEl + REDUCE_BLOCK - 1) / REDUCE_BLOCK;
+    std::vector<Moments> partial(nBlocks);
+#pragma omp parallel for if (nEl >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= nEl))
+    for (OMPInt b = 0; b < nBlocks; ++b) {
+      SizeT start = b * REDUCE_BLOCK;
+      SizeT stop = (start + REDUCE_BLOCK < nEl) ? start + REDUCE_BLOCK : nEl;
+      partial[b] = MomentsBlock(data, start, stop, omitNaN);
+    }
+    Moments m;
+    for (SizeT b = 0; b < nBlocks; ++b) MomentsMerge(m, partial[b]);
+    return m;
+  }
+
+  // Moments along a dimension of stride 'stride' > 1 and size nRows: the
+  // output c of outer slice o gathers data[o*nRows*stride + k*stride + c].
+  // Up to MOMENT_COLUMNS columns are reduced together by blocks of
+  // MOMENT_ROWS rows, the inner loops running over contiguous columns.
+  const SizeT MOMENT_COLUMNS = 256;
+  const SizeT MOMENT_ROWS = 64;
+
+  template<typename Ty>
+  void ReduceMomentsStrided(const Ty* data, SizeT nRows, SizeT stride, SizeT nOuter, bool omitNaN, Moments* out)
+  {
+    SizeT nChunks = (stride + MOMENT_COLUMNS - 1) / MOMENT_COLUMNS;
+    OMPInt nTasks = nOuter * nChunks;
+    SizeT nEl = nOuter * nRows * stride;
+#pragma omp parallel for if (nTasks > 1 && nEl >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= nEl))
+    for (OMPInt t = 0; t < nTasks; ++t) {
+      SizeT o = t / nChunks;
+      SizeT c0 = (t % nChunks) * MOMENT_COLUMNS;
+      SizeT nc = (c0 + MOMENT_COLUMNS < stride) ? MOMENT_COLUMNS : stride - c0;
+      const Ty* base = data + o * nRows * stride + c0;
+      Moments* acc = out + o * stride + c0;
+      for (SizeT c = 0; c < nc; ++c) acc[c] = Moments();
+      DDouble n[MOMENT_COLUMNS], sum[MOMENT_COLUMNS], m2[MOMENT_COLUMNS], m3[MOMENT_COLUMNS], m4[MOMENT_COLUMNS];
+      for (SizeT k0 = 0; k0 < nRows; k0 += MOMENT_ROWS) {
+        SizeT k1 = (k0 + MOMENT_ROWS < nRows) ? k0 + MOMENT_ROWS : nRows;
+        for (SizeT c = 0; c < nc; ++c) n[c] = sum[c] = m2[c] = m3[c] = m4[c] = 0;
+        for (SizeT k = k0; k < k1; ++k) {
+          const Ty* row = base + k * stride;
+          if (omitNaN) {
+            for (SizeT c = 0; c < nc; ++c) {
+              DDouble v = row[c];
+              bool ok = std::isfinite(v);
+              sum[c] += ok ? v : 0;
+              n[c] += ok ? 1 : 0;
+            }
+          } else for (SizeT c = 0; c < nc; ++c) sum[c] += row[c];
+        }
+        if (!omitNaN) for (SizeT c = 0; c < nc; ++c) n[c] = k1 - k0;
+        for (SizeT c = 0; c < nc; ++c) sum[c] = (n[c] > 0) ? sum[c] / n[c] : 0; // block means
+        for (SizeT k = k0; k < k1; ++k) {
+          const Ty* row = base + k * stride;
+          for (SizeT c = 0; c < nc; ++c) {
+            DDouble d = row[c] - sum[c];
+            if (omitNaN && !std::isfinite(d)) continue;
+            DDouble d2 = d * d;
+            m2[c] += d2;
+            m3[c] += d2 * d;
+            m4[c] += d2 * d2;
+          }
+        }
+        for (SizeT c = 0; c < nc; ++c) {
+          Moments b;
+          b.n = n[c];
+          b.mean = sum[c];
+          b.m2 = m2[c];
+          b.m3 = m3[c];
+          b.m4 = m4[c];
+          MomentsMerge(acc[c], b);
+        }
+      }
+    }
+  }
+
+  // sums of |x-mean| (MDEV needs the final mean, hence a second pass)
+  template<typename Ty>
+  DDouble ReduceAbsDev(const Ty* data, SizeT nEl, DDouble mean, bool omitNaN)
+  {
+    if (omitNaN) return ReduceSum<DDouble>(nEl, [data, mean](SizeT i) {
+        DDouble d = data[i] - mean;
+        return std::isfinite(d) ? std::fabs(d) : 0.0;
+      });
+    return ReduceSum<DDouble>(nEl, [data, mean](SizeT i) { return std::fabs(data[i] - mean); });
+  }
+
+  template<typename Ty>
+  void ReduceAbsDevStrided(const Ty* data, SizeT nRows, SizeT stride, SizeT nOuter, bool omitNaN,
+    const Moments* mom, DDouble* out)
+  {
+    SizeT nChunks = (stride + MOMENT_COLUMNS - 1) / MOMENT_COLUMNS;
+    OMPInt nTasks = nOuter * nChunks;
+    SizeT nEl = nOuter * nRows * stride;
+#pragma omp parallel for if (nTasks > 1 && nEl >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= nEl))
+    for (OMPInt t = 0; t < nTasks; ++t) {
+      SizeT o = t / nChunks;
+      SizeT c0 = (t % nChunks) * MOMENT_COLUMNS;
+      SizeT nc = (c0 + MOMENT_COLUMNS < stride) ? MOMENT_COLUMNS : stride - c0;
+      const Ty* base = data + o * nRows * stride + c0;
+      const Moments* m = mom + o * stride + c0;
+      DDouble* acc = out + o * stride + c0;
+      for (SizeT c = 0; c < nc; ++c) acc[c] = 0;
+      for (SizeT k = 0; k < nRows; ++k) {
+        const Ty* row = base + k * stride;
+        for (SizeT c = 0; c < nc; ++c) {
+          DDouble d = std::fabs(row[c] - m[c].mean);
+          if (omitNaN && !std::isfinite(d)) continue;
+          acc[c] += d;
+        }
+      }
+    }
+  }
+
+  // Prefix scans of TOTAL and PRODUCT /CUMULATIVE, in place.
+  // Flat case: fixed blocks of SCAN_BLOCK elements, element i of block b is
+  // offset_b op (prefix of block b up to i), offset_b combining the totals of
+  // the previous blocks in order. In parallel this takes two passes (block
+  // totals, then the scans from their offsets), serially one: both give the
+  // same values. Arrays of one block are the plain sequential scan.
+  const SizeT SCAN_BLOCK = 65536;
+  // Scan along a dimension: the slices of the previous index are combined
+  // with the current one columns by columns, a contiguous loop the compiler
+  // vectorizes; the tasks (outer slice, SCAN_COLUMNS columns) are independent.
+  const SizeT SCAN_COLUMNS = 1024;
+
+  struct ScanAdd
+  {
+    template<typename Ty> static Ty Identity() { return Ty(0); }
+    template<typename Ty> static void Apply(Ty& a, const Ty& b) { a += b; }
+  };
+
+  struct ScanMult
+  {
+    template<typename Ty> static Ty Identity() { return Ty(1); }
+    template<typename Ty> static void Apply(Ty& a, const Ty& b) { a *= b; }
+  };
+
+  template<typename Op, typename Ty>
+  inline Ty ScanBlock(Ty* res, SizeT start, SizeT stop, const Ty& offset, bool first)
+  {
+    Ty local = res[start];
+    if (!first) { res[start] = offset; Op::Apply(res[start], local); }
+    for (SizeT i = start + 1; i < stop; ++i) {
+      Op::Apply(local, res[i]);
+      if (first) res[i] = local; else { res[i] = offset; Op::Apply(res[i], local); }
+    }
+    return local;
+  }
+
+  template<typename Op, typename Ty>
+  void PrefixScan(Ty* res, SizeT nEl)
+  {
+    SizeT nBlocks = (nEl + SCAN_BLOCK - 1) / SCAN_BLOCK;
+    bool parallel = (nBlocks > 1 && CpuTPOOL_NTHREADS > 1 && nEl >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= nEl));
+    if (!parallel) {
+      Ty offset = Op::template Identity<Ty>();
+      for (SizeT b = 0; b < nBlocks; ++b) {
+        SizeT start = b * SCAN_BLOCK;
+        SizeT stop = (start + SCAN_BLOCK < nEl) ? start + SCAN_BLOCK : nEl;
+        Ty total = ScanBlock<Op>(res, start, stop, offset, b == 0);
+        if (b == 0) offset = total; else Op::Apply(offset, total);
+      }
+      return;
+    }
+    std::vector<Ty> offset(nBlocks);
+#pragma omp parallel for
+    for (OMPInt b = 0; b < nBlocks; ++b) {
+      SizeT start = b * SCAN_BLOCK;
+      SizeT stop = (start + SCAN_BLOCK < nEl) ? start + SCAN_BLOCK : nEl;
+      Ty total = res[start];
+      for (SizeT i = start + 1; i < stop; ++i) Op::Apply(total, res[i]);
+      offset[b] = total;
+    }
+    // exclusive scan of the block totals, as the serial pass does it
+    Ty running = offset[0];
+    for (SizeT b = 1; b < nBlocks; ++b) {
+      Ty total = offset[b];
+      offset[b] = running;
+      Op::Apply(running, total);
+    }
+#pragma omp parallel for
+    for (OMPInt b = 0; b < nBlocks; ++b) {
+      SizeT start = b * SCAN_BLOCK;
+      SizeT stop = (start + SCAN_BLOCK < nEl) ? start + SCAN_BLOCK : nEl;
+      ScanBlock<Op>(res, start, stop, offset[b], b == 0);
+    }
+  }
+
+  // cumStride, outerStride: strides of the scanned dimension and of the next one
+  template<typename Op, typename Ty>
+  void PrefixScanDim(Ty* res, SizeT nEl, SizeT cumStride, SizeT outerStride)
+  {
+    SizeT nChunks = (cumStride + SCAN_COLUMNS - 1) / SCAN_COLUMNS;
+    OMPInt nTasks = (nEl / outerStride) * nChunks;
+#pragma omp parallel for if (nTasks > 1 && nEl >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= nEl))
+    for (OMPInt t = 0; t < nTasks; ++t) {
+      SizeT o = (t / nChunks) * outerStride;
+      SizeT c0 = (t % nChunks) * SCAN_COLUMNS;
+      SizeT c1 = (c0 + SCAN_COLUMNS < cumStride) ? c0 + SCAN_COLUMNS : cumStride;
+      for (SizeT k = o + cumStride; k < o + outerStride; k += cumStride) {
+        Ty* cur = res + k;
+        const Ty* prev = cur - cumStride;
+        for (SizeT i = c0; i < c1; ++i) Op::Apply(cur[i], prev[i]);
+      }
+    }
+  }
+
+} // namespace lib
+
+#endif
@@ -0,0 +1,707 @@
+/***************************************************************************
+                          simd_dispatch.cpp  -  run time selection of SIMD kernels
+                             -------------------
+    begin                : Oct 2026
+    copyright            : (C) 2026 by the GDL team
+    email                :
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "includefirst.hpp"
+
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <type_traits>
+
+#include "simd_dispatch.hpp"
+#include "simd_math.hpp"
+#include "real2int.hpp"
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define SIMD_X86 1
+#endif
+
+SimdKernelsT simdKernels = { -1};
+
+// the loops, inlined in the per instruction set functions below, where
+// the compiler vectorizes them for that set ('omp simd' also at -O2)
+
+template<int Op, typename T> SIMD_INLINE T SimdArithOne( T x, T y)
+{
+  switch( Op)
+  {
+  case SIMD_ADD: return x + y;
+  case SIMD_SUB: return x - y;
+  case SIMD_MUL: return x * y;
+  case SIMD_DIV: return x / y;
+  case SIMD_MIN: return (x > y) ? y : x; // as Data_::LtMark()
+  default: return (x < y) ? y : x;       // as Data_::GtMark()
+  }
+}
+
+template<int Op, int Form, typename T>
+SIMD_INLINE void SimdArithLoop( T* res, const T* a, const T* b, SizeT n)
+{
+  const T s = b[ 0];
+  if( Form == SIMD_VV)
+  {
+#pragma omp simd
+    for( SizeT i = 0; i < n; ++i) res[ i] = SimdArithOne<Op>( a[ i], b[ i]);
+  }
+  else if( Form == SIMD_VS)
+  {
+#pragma omp simd
+    for( SizeT i = 0; i < n; ++i) res[ i] = SimdArithOne<Op>( a[ i], s);
+  }
+  else
+  {
+#pragma omp simd
+    for( SizeT i = 0; i < n; ++i) res[ i] = SimdArithOne<Op>( s, a[ i]);
+  }
+}
+
+template<int Op, typename T> SIMD_INLINE DByte SimdCmpOne( T x, T y)
+{
+  switch( Op)
+  {
+  case SIMD_EQ: return x == y;
+  case SIMD_NE: return x != y;
+  case SIMD_LE: return x <= y;
+  case SIMD_LT: return x < y;
+  case SIMD_GE: return x >= y;
+  default: return x > y;
+  }
+}
+
+template<int Op, int Form, typename T>
+SIMD_INLINE void SimdCmpLoop( DByte* res, const T* a, const T* b, SizeT n)
+{
+  const T s = b[ 0];
+  if( Form == SIMD_VV)
+  {
+#pragma omp simd
+    for( SizeT i = 0; i < n; ++i) res[ i] = SimdCmpOne<Op>( a[ i], b[ i]);
+  }
+  else
+  {
+#pragma omp simd
+    for( SizeT i = 0; i < n; ++i) res[ i] = SimdCmpOne<Op>( a[ i], s);
+  }
+}
+
+template<typename U> SIMD_INLINE U SimdSwapOne( U x);
+template<> SIMD_INLINE DUInt SimdSwapOne( DUInt x) { return static_cast<DUInt>( (x >> 8) | (x << 8));}
+#if defined(__GNUC__)
+template<> SIMD_INLINE DULong SimdSwapOne( DULong x) { return __builtin_bswap32( x);}
+template<> SIMD_INLINE DULong64 SimdSwapOne( DULong64 x) { return __builtin_bswap64( x);}
+#else
+template<> SIMD_INLINE DULong SimdSwapOne( DULong x)
+{
+  return (x >> 24) | ((x >> 8) & 0xFF00) | ((x << 8) & 0xFF0000) | (x << 24);
+}
+template<> SIMD_INLINE DULong64 SimdSwapOne( DULong64 x)
+{
+  return (static_cast<DULong64>( SimdSwapOne<DULong>( static_cast<DULong>( x))) << 32) |
+    SimdSwapOne<DULong>( static_cast<DULong>( x >> 32));
+}
+#endif
+
+// p needs not be aligned
+template<typename U>
+SIMD_INLINE void SimdSwapLoop( char* p, SizeT n)
+{
+#pragma omp simd
+  for( SizeT i = 0; i < n; ++i)
+  {
+    U x;
+    memcpy( &x, p + i * sizeof( U), sizeof( U));
+    x = SimdSwapOne<U>( x);
+    memcpy( p + i * sizeof( U), &x, sizeof( U));
+  }
+}
+
+// FLOAT and DOUBLE to an integer type truncate like the plain cast of
+// Convert2(), to BYTE, INT and UINT through LONG like the scalar code
+template<typename D, typename S> SIMD_INLINE D SimdCvtOne( S x)
+{
+  typedef typename std::conditional< std::numeric_limits<D>::is_integer &&
+    !std::numeric_limits<S>::is_integer, DLong, D>::type Via;
+  return static_cast<D>( static_cast<Via>( x));
+}
+
+template<typename D, typename S>
+SIMD_INLINE void SimdCvtLoop( void* res, const void* a, SizeT n)
+{
+  D* r = static_cast<D*>( res);
+  const S* s = static_cast<const S*>( a);
+#pragma omp simd
+  for( SizeT i = 0; i < n; ++i) r[ i] = SimdCvtOne<D>( s[ i]);
+}
+
+// subscripts as GetAsIndex() and GetAsIndexStrict()
+template<typename T> SIMD_INLINE SizeT SimdIndexOne( T v)
+{
+  return (v <= 0) ? 0 : static_cast<SizeT>( v);
+}
+template<> SIMD_INLINE SizeT SimdIndexOne( DFloat v) { return Real2Index( v);}
+template<> SIMD_INLINE SizeT SimdIndexOne( DDouble v) { return Real2Index( v);}
+
+template<typename T> SIMD_INLINE bool SimdIndexBad( T v, SizeT upper)
+{
+  return static_cast<DULong64>( v) > upper; // also < 0
+}
+template<> SIMD_INLINE bool SimdIndexBad( DFloat v, SizeT upper)
+{
+  return (v <= -1) | (Real2Index( v) > upper);
+}
+template<> SIMD_INLINE bool SimdIndexBad( DDouble v, SizeT upper)
+{
+  return (v <= -1) | (Real2Index( v) > upper);
+}
+
+template<typename T>
+SIMD_INLINE void SimdIndexLoop( SizeT* ix, const void* v, SizeT n, SizeT upper)
+{
+  const T* a = static_cast<const T*>( v);
+#pragma omp simd
+  for( SizeT i = 0; i < n; ++i)
+  {
+    SizeT x = SimdIndexOne( a[ i]);
+    ix[ i] = (x > upper) ? upper : x;
+  }
+}
+
+template<typename T>
+SIMD_INLINE bool SimdInRangeLoop( const void* v, SizeT n, SizeT upper)
+{
+  const T* a = static_cast<const T*>( v);
+  int bad = 0;
+#pragma omp simd reduction(|:bad)
+  for( SizeT i = 0; i < n; ++i) bad |= SimdIndexBad( a[ i], upper);
+  return bad == 0;
+}
+
+template<int Op, typename T> SIMD_INLINE T SimdMathOne( T x)
+{
+  switch( Op)
+  {
+  case SIMD_SIN: return SimdTrig<0>( x);
+  case SIMD_COS: return SimdTrig<1>( x);
+  case SIMD_TAN: return SimdTrig<2>( x);
+  case SIMD_ATAN: return SimdAtan( x);
+  case SIMD_EXP: return SimdExp( x);
+  case SIMD_LOG: return SimdLog( x);
+  default: return SimdLog10( x);
+  }
+}
+
+// the argument checks compare the bits: a floating point comparison
+// raises the invalid flag for NaN
+template<typename T> struct SimdUInt { typedef DULong64 type;};
+template<> struct SimdUInt<DFloat> { typedef DULong type;};
+
+template<typename T> SIMD_INLINE typename SimdUInt<T>::type SimdUBits( T x)
+{
+  typename SimdUInt<T>::type u;
+  memcpy( &u, &x, sizeof( u));
+  return u;
+}
+// |x| <= hi
+template<typename T> SIMD_INLINE bool SimdAbsLE( T x, T hi)
+{
+  typedef typename SimdUInt<T>::type U;
+  return (SimdUBits( x) & ~(static_cast<U>( 1) << (8 * sizeof( U) - 1))) <= SimdUBits( hi);
+}
+// 0 < x < Inf
+template<typename T> SIMD_INLINE bool SimdPositive( T x)
+{
+  return SimdUBits( x) - 1 < SimdUBits( std::numeric_limits<T>::max());
+}
+
+// arguments for which the functions of simd_math.hpp are used: the
+// chunks with others (large, Inf, NaN, log of <= 0...) are done by the
+// libm, whose floating point exception flags (CHECK_MATH) are kept
+template<int Op, typename T> SIMD_INLINE bool SimdMathOk( T x)
+{
+  switch( Op)
+  {
+  case SIMD_ATAN: return true;
+  case SIMD_EXP: return SimdAbsLE( x, static_cast<T>( 708.0)); // normal results
+  case SIMD_LOG: case SIMD_LOG10: return SimdPositive( x);
+  default: return SimdAbsLE( x, SimdTrigMax<T>());
+  }
+}
+
+template<int Op, typename T> T SimdMathLibm( T x)
+{
+  switch( Op)
+  {
+  case SIMD_SIN: return std::sin( x);
+  case SIMD_COS: return std::cos( x);
+  case SIMD_TAN: return std::tan( x);
+  case SIMD_ATAN: return std::atan( x);
+  case SIMD_EXP: return std::exp( x);
+  case SIMD_LOG: return std::log( x);
+  default: return std::log10( x);
+  }
+}
+
+static const SizeT SIMD_MATH_CHUNK = 256;
+
+template<int Op, typename T>
+SIMD_INLINE void SimdMathLoop( T* res, const T* a, SizeT n)
+{
+  for( SizeT o = 0; o < n; o += SIMD_MATH_CHUNK)
+  {
+    const SizeT m = (n - o < SIMD_MATH_CHUNK) ? n - o : SIMD_MATH_CHUNK;
+    const T* ac = a + o;
+    T* rc = res + o;
+    int bad = 0;
+#pragma omp simd reduction(|:bad)
+    for( SizeT i = 0; i < m; ++i) bad |= !SimdMathOk<Op>( ac[ i]);
+    if( bad)
+    {
+      for( SizeT i = 0; i < m; ++i) rc[ i] = SimdMathLibm<Op>( ac[ i]);
+      continue;
+    }
+#pragma omp simd
+    for( SizeT i = 0; i < m; ++i) rc[ i] = SimdMathOne<Op>( ac[ i]);
+  }
+}
+
+// x ^ y: the chunks with x or y not finite, x = 0, subnormal DOUBLE x,
+// x < 0 and y not integral or |y| > 2^30 are done by the libm, as are
+// those where a result is not a normal number (SimdPow() sets ok)
+template<typename T> inline T SimdPowMin();
+template<> inline DFloat SimdPowMin<DFloat>() { return std::numeric_limits<DFloat>::denorm_min();}
+template<> inline DDouble SimdPowMin<DDouble>() { return std::numeric_limits<DDouble>::min();}
+
+template<typename T> SIMD_INLINE bool SimdPowOk( T x, T y)
+{
+  typedef typename SimdUInt<T>::type U;
+  const int signBit = 8 * sizeof( U) - 1;
+  const U ax = SimdUBits( x) & ~(static_cast<U>( 1) << signBit);
+  const bool xOk = (ax >= SimdUBits( SimdPowMin<T>())) & (ax <= SimdUBits( std::numeric_limits<T>::max()));
+  DULong64 yb;
+  const bool yInt = SimdRound( static_cast<DDouble>( y), yb) == static_cast<DDouble>( y);
+  return xOk & SimdAbsLE( y, static_cast<T>( 1073741824.0)) & ((SimdUBits( x) >> signBit) == 0 || yInt);
+}
+
+template<int Form, typename T>
+SIMD_INLINE void SimdPowLoop( T* res, const T* a, const T* b, SizeT n)
+{
+  for( SizeT o = 0; o < n; o += SIMD_MATH_CHUNK)
+  {
+    const SizeT m = (n - o < SIMD_MATH_CHUNK) ? n - o : SIMD_MATH_CHUNK;
+    const T* ac = a + o;
+    const T* bc = (Form == SIMD_VV) ? b + o : b;
+    T* rc = res + o;
+    int bad = 0;
+#pragma omp simd reduction(|:bad)
+    for( SizeT i = 0; i < m; ++i)
+    {
+      const T x = (Form == SIMD_SV) ? bc[ 0] : ac[ i];
+      const T y = (Form == SIMD_SV) ? ac[ i] : ((Form == SIMD_VS) ? bc[ 0] : bc[ i]);
+      bad |= !SimdPowOk( x, y);
+    }
+    if( !bad)
+    {
+      // res may be a or b: the libm needs them if a result is not normal
+      T tmp[ SIMD_MATH_CHUNK];
+#pragma omp simd reduction(|:bad)
+      for( SizeT i = 0; i < m; ++i)
+      {
+	const T x = (Form == SIMD_SV) ? bc[ 0] : ac[ i];
+	const T y = (Form == SIMD_SV) ? ac[ i] : ((Form == SIMD_VS) ? bc[ 0] : bc[ i]);
+	bool ok;
+	tmp[ i] = SimdPow( x, y, ok);
+	bad |= !ok;
+      }
+      if( !bad)
+      {
+	memcpy( rc, tmp, m * sizeof( T));
+	continue;
+      }
+    }
+    for( SizeT i = 0; i < m; ++i)
+    {
+      const T x = (Form == SIMD_SV) ? bc[ 0] : ac[ i];
+      const T y = (Form == SIMD_SV) ? ac[ i] : ((Form == SIMD_VS) ? bc[ 0] : bc[ i]);
+      rc[ i] = std::pow( x, y);
+    }
+  }
+}
+
+// complex functions, in double:
+// exp(x + iy) = exp(x) (cos(y) + i sin(y)), sin, cos and log see
+// simd_math.hpp; the libm for the chunks where a result may overflow,
+// |x| (|y| for exp) is large, or Inf, NaN, and log(0)
+template<typename T> inline T SimdCExpMax();
+template<> inline DFloat SimdCExpMax<DFloat>() { return 88.0f;}
+template<> inline DDouble SimdCExpMax<DDouble>() { return 708.0;}
+// for log(x + iy), x and y 0 or in [SimdCLogMin, SimdCLogMax]
+template<typename T> inline T SimdCLogMin();
+template<> inline DFloat SimdCLogMin<DFloat>() { return std::numeric_limits<DFloat>::denorm_min();}
+template<> inline DDouble SimdCLogMin<DDouble>() { return 1.0e-150;}
+template<typename T> inline T SimdCLogMax();
+template<> inline DFloat SimdCLogMax<DFloat>() { return std::numeric_limits<DFloat>::max();}
+template<> inline DDouble SimdCLogMax<DDouble>() { return 1.0e150;}
+
+template<int Op, typename T> SIMD_INLINE bool SimdCMathOk( T x, T y)
+{
+  typedef typename SimdUInt<T>::type U;
+  const U sign = static_cast<U>( 1) << (8 * sizeof( U) - 1);
+  const T trigMax = static_cast<T>( SimdTrigMax<DDouble>());
+  switch( Op)
+  {
+  case SIMD_EXP: return SimdAbsLE( x, SimdCExpMax<T>()) & SimdAbsLE( y, trigMax);
+  case SIMD_LOG:
+  {
+    const U ax = SimdUBits( x) & ~sign;
+    const U ay = SimdUBits( y) & ~sign;
+    const U lo = SimdUBits( SimdCLogMin<T>());
+    const U hi = SimdUBits( SimdCLogMax<T>());
+    return (ax == 0 || (ax >= lo && ax <= hi)) & (ay == 0 || (ay >= lo && ay <= hi)) & ((ax | ay) != 0);
+  }
+  default: return SimdAbsLE( x, trigMax) & SimdAbsLE( y, SimdCExpMax<T>());
+  }
+}
+
+template<int Op, typename T> std::complex<T> SimdCMathLibm( const std::complex<T>& z)
+{
+  switch( Op)
+  {
+  case SIMD_SIN: return std::sin( z);
+  case SIMD_COS: return std::cos( z);
+  case SIMD_EXP: return std::exp( z);
+  default: return std::log( z);
+  }
+}
+
+template<int Op, typename T>
+SIMD_INLINE void SimdCMathLoop( std::complex<T>* res, const std::complex<T>* a, SizeT n)
+{
+  for( SizeT o = 0; o < n; o += SIMD_MATH_CHUNK)
+  {
+    const SizeT m = (n - o < SIMD_MATH_CHUNK) ? n - o : SIMD_MATH_CHUNK;
+    // std::complex<T> is laid out as T[2]
+    const T* ac = reinterpret_cast<const T*>( a + o);
+    T* rc = reinterpret_cast<T*>( res + o);
+    int bad = 0;
+#pragma omp simd reduction(|:bad)
+    for( SizeT i = 0; i < m; ++i) bad |= !SimdCMathOk<Op>( ac[ 2 * i], ac[ 2 * i + 1]);
+    if( bad)
+    {
+      for( SizeT i = 0; i < m; ++i) res[ o + i] = SimdCMathLibm<Op>( a[ o + i]);
+      continue;
+    }
+#pragma omp simd
+    for( SizeT i = 0; i < m; ++i)
+    {
+      const DDouble x = ac[ 2 * i];
+      const DDouble y = ac[ 2 * i + 1];
+      DDouble re, im;
+      if( Op == SIMD_EXP)
+      {
+	DDouble e = SimdExp( x);
+	DDouble s, c;
+	SimdSinCos( y, s, c);
+	re = e * c;
+	im = e * s;
+      }
+      else if( Op == SIMD_LOG) SimdCLog( x, y, re, im);
+      else SimdCTrig<Op == SIMD_SIN ? 0 : 1>( x, y, re, im);
+      rc[ 2 * i] = static_cast<T>( re);
+      rc[ 2 * i + 1] = static_cast<T>( im);
+    }
+  }
+}
+
+// normal deviates: 2 pi v is in the domain of SimdSinCos(), u > 0
+SIMD_INLINE void SimdBoxMullerLoop( DDouble* z, const DDouble* u, const DDouble* v, SizeT n)
+{
+#pragma omp simd
+  for( SizeT i = 0; i < n; ++i)
+  {
+    DDouble rho = std::sqrt( -2.0 * SimdLog( u[ i]));
+    DDouble s, c;
+    SimdSinCos( 6.28318530717958647693 * v[ i], s, c);
+    z[ 2 * i] = rho * c;
+    z[ 2 * i + 1] = rho * s;
+  }
+}
+
+// one structure per instruction set, its functions compiled for that set
+#define SIMD_VARIANT( ISA, TARGET)					\
+  struct ISA {								\
+    template<int Op, int Form, typename T>				\
+    TARGET static void Arith( T* res, const T* a, const T* b, SizeT n)	\
+    { SimdArithLoop<Op, Form>( res, a, b, n);}				\
+    template<int Op, int Form, typename T>				\
+    TARGET static void Cmp( DByte* res, const T* a, const T* b, SizeT n) \
+    { SimdCmpLoop<Op, Form>( res, a, b, n);}				\
+    template<typename U>						\
+    TARGET static void Swap( char* p, SizeT n)				\
+    { SimdSwapLoop<U>( p, n);}						\
+    template<int Op, typename T>					\
+    TARGET static void Math( T* res, const T* a, SizeT n)		\
+    { SimdMathLoop<Op>( res, a, n);}					\
+    template<int Form, typename T>					\
+    TARGET static void Pow( T* res, const T* a, const T* b, SizeT n)	\
+    { SimdPowLoop<Form>( res, a, b, n);}				\
+    template<int Op, typename T>					\
+    TARGET static void CMath( std::complex<T>* res, const std::complex<T>* a, SizeT n) \
+    { SimdCMathLoop<Op, T>( res, a, n);}				\
+    template<typename D, typename S>					\
+    TARGET static void Cvt( void* res, const void* a, SizeT n)		\
+    { SimdCvtLoop<D, S>( res, a, n);}					\
+    template<typename T>						\
+    TARGET static void Index( SizeT* ix, const void* v, SizeT n, SizeT upper) \
+    { SimdIndexLoop<T>( ix, v, n, upper);}				\
+    template<typename T>						\
+    TARGET static bool InRange( const void* v, SizeT n, SizeT upper)	\
+    { return SimdInRangeLoop<T>( v, n, upper);}				\
+    TARGET static void BoxMuller( DDouble* z, const DDouble* u, const DDouble* v, SizeT n) \
+    { SimdBoxMullerLoop( z, u, v, n);}					\
+  };
+
+SIMD_VARIANT( SimdGenericISA, )
+#ifdef SIMD_X86
+SIMD_VARIANT( SimdAVX2ISA, __attribute__((target("avx2"))))
+SIMD_VARIANT( SimdAVX512ISA, __attribute__((target("avx512f,avx512bw,avx512vl,avx512dq"))))
+#endif
+
+template<class ISA, typename T, int Op>
+static void SimdFillArith( SimdFloatKernelsT<T>& k)
+{
+  k.arith[ Op][ SIMD_VV] = &ISA::template Arith<Op, SIMD_VV, T>;
+  k.arith[ Op][ SIMD_VS] = &ISA::template Arith<Op, SIMD_VS, T>;
+  k.arith[ Op][ SIMD_SV] = &ISA::template Arith<Op, SIMD_SV, T>;
+}
+
+template<class ISA, typename T, int Op>
+static void SimdFillCmp( SimdFloatKernelsT<T>& k)
+{
+  k.cmp[ Op][ 0] = &ISA::template Cmp<Op, SIMD_VV, T>;
+  k.cmp[ Op][ 1] = &ISA::template Cmp<Op, SIMD_VS, T>;
+}
+
+template<class ISA, typename T>
+static void SimdFill( SimdFloatKernelsT<T>& k)
+{
+  SimdFillArith<ISA, T, SIMD_ADD>( k);
+  SimdFillArith<ISA, T, SIMD_SUB>( k);
+  SimdFillArith<ISA, T, SIMD_MUL>( k);
+  SimdFillArith<ISA, T, SIMD_DIV>( k);
+  SimdFillArith<ISA, T, SIMD_MIN>( k);
+  SimdFillArith<ISA, T, SIMD_MAX>( k);
+  SimdFillCmp<ISA, T, SIMD_EQ>( k);
+  SimdFillCmp<ISA, T, SIMD_NE>( k);
+  SimdFillCmp<ISA, T, SIMD_LE>( k);
+  SimdFillCmp<ISA, T, SIMD_LT>( k);
+  SimdFillCmp<ISA, T, SIMD_GE>( k);
+  SimdFillCmp<ISA, T, SIMD_GT>( k);
+  k.math[ SIMD_SIN] = &ISA::template Math<SIMD_SIN, T>;
+  k.math[ SIMD_COS] = &ISA::template Math<SIMD_COS, T>;
+  k.math[ SIMD_TAN] = &ISA::template Math<SIMD_TAN, T>;
+  k.math[ SIMD_ATAN] = &ISA::template Math<SIMD_ATAN, T>;
+  k.math[ SIMD_EXP] = &ISA::template Math<SIMD_EXP, T>;
+  k.math[ SIMD_LOG] = &ISA::template Math<SIMD_LOG, T>;
+  k.math[ SIMD_LOG10] = &ISA::template Math<SIMD_LOG10, T>;
+  k.pow[ SIMD_VV] = &ISA::template Pow<SIMD_VV, T>;
+  k.pow[ SIMD_VS] = &ISA::template Pow<SIMD_VS, T>;
+  k.pow[ SIMD_SV] = &ISA::template Pow<SIMD_SV, T>;
+  for( int op = 0; op < SIMD_NMATH; ++op) k.cmath[ op] = NULL;
+  k.cmath[ SIMD_SIN] = &ISA::template CMath<SIMD_SIN, T>;
+  k.cmath[ SIMD_COS] = &ISA::template CMath<SIMD_COS, T>;
+  k.cmath[ SIMD_EXP] = &ISA::template CMath<SIMD_EXP, T>;
+  k.cmath[ SIMD_LOG] = &ISA::template CMath<SIMD_LOG, T>;
+}
+
+template<int I> struct SimdCvtTy;
+template<> struct SimdCvtTy<SIMD_CVT_BYTE> { typedef DByte type;};
+template<> struct SimdCvtTy<SIMD_CVT_INT> { typedef DInt type;};
+template<> struct SimdCvtTy<SIMD_CVT_UINT> { typedef DUInt type;};
+template<> struct SimdCvtTy<SIMD_CVT_LONG> { typedef DLong type;};
+template<> struct SimdCvtTy<SIMD_CVT_FLOAT> { typedef DFloat type;};
+template<> struct SimdCvtTy<SIMD_CVT_DOUBLE> { typedef DDouble type;};
+
+template<class ISA, int From, int To>
+static void SimdFillCvt( SimdKernelsT& k)
+{
+  k.cvt[ From][ To] = &ISA::template Cvt<typename SimdCvtTy<To>::type, typename SimdCvtTy<From>::type>;
+}
+
+// integer type I to and from FLOAT and DOUBLE
+template<class ISA, int I>
+static void SimdFillCvtReal( SimdKernelsT& k)
+{
+  SimdFillCvt<ISA, I, SIMD_CVT_FLOAT>( k);
+  SimdFillCvt<ISA, I, SIMD_CVT_DOUBLE>( k);
+  SimdFillCvt<ISA, SIMD_CVT_FLOAT, I>( k);
+  SimdFillCvt<ISA, SIMD_CVT_DOUBLE, I>( k);
+}
+
+template<class ISA, typename T>
+static void SimdFillIndex( SimdKernelsT& k, SimdIndexType t)
+{
+  k.index[ t] = &ISA::template Index<T>;
+  k.inRange[ t] = &ISA::template InRange<T>;
+}
+
+template<class ISA>
+static void SimdFill( SimdKernelsT& k)
+{
+  SimdFill<ISA, DFloat>( k.f);
+  SimdFill<ISA, DDouble>( k.d);
+  k.swap[ 0] = &ISA::template Swap<DUInt>;
+  k.swap[ 1] = &ISA::template Swap<DULong>;
+  k.swap[ 2] = &ISA::template Swap<DULong64>;
+  SimdFillCvtReal<ISA, SIMD_CVT_BYTE>( k);
+  SimdFillCvtReal<ISA, SIMD_CVT_INT>( k);
+  SimdFillCvtReal<ISA, SIMD_CVT_UINT>( k);
+  SimdFillCvtReal<ISA, SIMD_CVT_LONG>( k);
+  SimdFillCvt<ISA, SIMD_CVT_FLOAT, SIMD_CVT_DOUBLE>( k);
+  SimdFillCvt<ISA, SIMD_CVT_DOUBLE, SIMD_CVT_FLOAT>( k);
+  SimdFillIndex<ISA, DByte>( k, SIMD_IX_BYTE);
+  SimdFillIndex<ISA, DInt>( k, SIMD_IX_INT);
+  SimdFillIndex<ISA, DUInt>( k, SIMD_IX_UINT);
+  SimdFillIndex<ISA, DLong>( k, SIMD_IX_LONG);
+  SimdFillIndex<ISA, DULong>( k, SIMD_IX_ULONG);
+  SimdFillIndex<ISA, DLong64>( k, SIMD_IX_LONG64);
+  SimdFillIndex<ISA, DULong64>( k, SIMD_IX_ULONG64);
+  SimdFillIndex<ISA, DFloat>( k, SIMD_IX_FLOAT);
+  SimdFillIndex<ISA, DDouble>( k, SIMD_IX_DOUBLE);
+  k.boxMuller = &ISA::BoxMuller;
+}
+
+static SimdLevel simdBest = SIMD_GENERIC;
+static std::string simdRequest; // GDL_SIMD
+
+SimdLevel SimdBest()
+{
+  SimdK();
+  return simdBest;
+}
+
+SimdLevel SimdSelected()
+{
+  return static_cast<SimdLevel>( SimdK().level);
+}
+
+const char* SimdName( SimdLevel level)
+{
+  switch( level)
+  {
+  case SIMD_AVX2: return "AVX2";
+  case SIMD_AVX512: return "AVX512";
+  default:
+#if defined(__AVX512F__)
+    return "AVX512 (baseline)";
+#elif defined(__AVX2__)
+    return "AVX2 (baseline)";
+#elif defined(__SSE2__)
+    return "SSE2";
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+    return "NEON";
+#elif defined(__ALTIVEC__)
+    return "ALTIVEC";
+#else
+    return "GENERIC";
+#endif
+  }
+}
+
+void SimdInit()
+{
+  SimdLevel best = SIMD_GENERIC;
+#ifdef SIMD_X86
+  __builtin_cpu_init();
+  if( __builtin_cpu_supports( "avx2")) best = SIMD_AVX2;
+  if( __builtin_cpu_supports( "avx512f") && __builtin_cpu_supports( "avx512bw") &&
+      __builtin_cpu_supports( "avx512vl") && __builtin_cpu_supports( "avx512dq"))
+    best = SIMD_AVX512;
+#endif
+  simdBest = best;
+
+  SimdLevel level = best;
+  const char* env = getenv( "GDL_SIMD");
+  if( env != NULL && env[ 0] != 0)
+  {
+    simdRequest = env;
+    std::string r = simdRequest;
+    std::transform( r.begin(), r.end(), r.begin(), ::tolower);
+    SimdLevel want = best;
+    if( r == "generic" || r == "sse2" || r == "neon" || r == "none") want = SIMD_GENERIC;
+    else if( r == "avx2") want = SIMD_AVX2;
+    else if( r == "avx512" || r == "avx-512") want = SIMD_AVX512;
+    if( want < level) level = want; // never above what the CPU supports
+  }
+
+  switch( level)
+  {
+#ifdef SIMD_X86
+  case SIMD_AVX512: SimdFill<SimdAVX512ISA>( simdKernels); break;
+  case SIMD_AVX2: SimdFill<SimdAVX2ISA>( simdKernels); break;
+#endif
+  default: SimdFill<SimdGenericISA>( simdKernels); level = SIMD_GENERIC;
+  }
+  simdKernels.level = level;
+}
+
+std::string SimdInfo()
+{
+  SimdLevel level = SimdSelected();
+  std::string s = std::string( "* SIMD kernels: ") + SimdName( level);
+  if( level != simdBest)
+    s += std::string( " (best for this CPU: ") + SimdName( simdBest) + ")";
+  if( !simdRequest.empty())
+    s += ", GDL_SIMD=" + simdRequest;
+  return s;
+}
+
+void SimdByteSwap( void* p, SizeT size, SizeT n)
+{
+  int k;
+  switch( size)
+  {
+  case 1: return;
+  case 2: k = 0; break;
+  case 4: k = 1; break;
+  case 8: k = 2; break;
+  default:
+  {
+    char* c = static_cast<char*>( p);
+    for( SizeT i = 0; i < n; ++i, c += size)
+      std::reverse( c, c + size);
+    return;
+  }
+  }
+  void (*swap)( char*, SizeT) = SimdK().swap[ k];
+  char* c = static_cast<char*>( p);
+  if( !SimdParallel( n))
+  {
+    swap( c, n);
+    return;
+  }
+  const OMPInt nBlk = (n + SIMD_BLOCK - 1) / SIMD_BLOCK;
+#pragma omp parallel for
+  for( OMPInt i = 0; i < nBlk; ++i)
+  {
+    SizeT o = i * SIMD_BLOCK;
+    SizeT m = (n - o < SIMD_BLOCK) ? n - o : SIMD_BLOCK;
+    swap( c + o * size, m);
+  }
+}
@@ -0,0 +1,302 @@
+/***************************************************************************
+                          simd_dispatch.hpp  -  run time selection of SIMD kernels
+                             -------------------
+    begin                : Oct 2026
+    copyright            : (C) 2026 by the GDL team
+    email                :
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+// The hot element-wise loops (FLOAT and DOUBLE arithmetic, the < and >
+// operators, comparisons, byte swapping) are compiled once per instruction
+// set: the baseline of the build (SSE2 on x86_64, NEON on aarch64) and, on
+// x86 with GCC or clang, AVX2 and AVX-512 through the 'target' attribute.
+// The first use selects the best set supported by the running CPU; the
+// environment variable GDL_SIMD (generic, avx2, avx512) can lower the
+// choice, e.g. for testing. The code path in use is reported by
+// HELP, /INFO and in !GDL.GDL_SIMD.
+// SIN, COS, TAN, ATAN, EXP, ALOG, ALOG10 and the power operator of FLOAT
+// and DOUBLE, and SIN, COS, EXP and ALOG of the complex types, use the
+// vectorizable functions of simd_math.hpp (see there for their accuracy).
+// Conversions between BYTE, INT, UINT, LONG and FLOAT or DOUBLE have kernels
+// too, truncating like the plain C++ cast of Convert2(), and so has the
+// conversion of index arrays to subscripts (SimdIndex()), and the
+// Box-Muller transform of RANDOMN.
+// The Simd...() helpers split large arrays in blocks handled in parallel,
+// following !CPU.TPOOL_MIN_ELTS/TPOOL_MAX_ELTS like the loops they replace,
+// and return false for the types without kernels so that the caller's
+// generic loop is used.
+
+#ifndef SIMD_DISPATCH_HPP_
+#define SIMD_DISPATCH_HPP_
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <string>
+#include <complex>
+
+#include "typedefs.hpp"
+
+enum SimdLevel { SIMD_GENERIC = 0, SIMD_AVX2, SIMD_AVX512};
+
+// res = a op b; min and max are the < and > operators of GDL
+enum SimdArithOp { SIMD_ADD = 0, SIMD_SUB, SIMD_MUL, SIMD_DIV, SIMD_MIN, SIMD_MAX, SIMD_NARITH};
+// VV: res[i] = a[i] op b[i], VS: res[i] = a[i] op b[0], SV: res[i] = b[0] op a[i]
+enum SimdForm { SIMD_VV = 0, SIMD_VS, SIMD_SV, SIMD_NFORM};
+enum SimdCmpOp { SIMD_EQ = 0, SIMD_NE, SIMD_LE, SIMD_LT, SIMD_GE, SIMD_GT, SIMD_NCMP};
+// res = f(a)
+enum SimdMathOp { SIMD_SIN = 0, SIMD_COS, SIMD_TAN, SIMD_ATAN, SIMD_EXP, SIMD_LOG, SIMD_LOG10, SIMD_NMATH};
+// element types of the conversion kernels
+enum SimdCvtType { SIMD_CVT_BYTE = 0, SIMD_CVT_INT, SIMD_CVT_UINT, SIMD_CVT_LONG, SIMD_CVT_FLOAT, SIMD_CVT_DOUBLE, SIMD_NCVT};
+// element types of the index arrays
+enum SimdIndexType { SIMD_IX_BYTE = 0, SIMD_IX_INT, SIMD_IX_UINT, SIMD_IX_LONG, SIMD_IX_ULONG,
+		     SIMD_IX_LONG64, SIMD_IX_ULONG64, SIMD_IX_FLOAT, SIMD_IX_DOUBLE, SIMD_NIX};
+
+template<typename T> struct SimdFloatKernelsT {
+  void (*arith[ SIMD_NARITH][ SIMD_NFORM])( T* res, const T* a, const T* b, SizeT n);
+  // VV and VS forms only
+  void (*cmp[ SIMD_NCMP][ 2])( DByte* res, const T* a, const T* b, SizeT n);
+  void (*math[ SIMD_NMATH])( T* res, const T* a, SizeT n);
+  // res = a ^ b
+  void (*pow[ SIMD_NFORM])( T* res, const T* a, const T* b, SizeT n);
+  // functions of the complex type of T, NULL for those without kernel
+  void (*cmath[ SIMD_NMATH])( std::complex<T>* res, const std::complex<T>* a, SizeT n);
+};
+
+struct SimdKernelsT {
+  int level; // SimdLevel, -1 before SimdInit()
+  SimdFloatKernelsT<DFloat> f;
+  SimdFloatKernelsT<DDouble> d;
+  void (*swap[ 3])( char* p, SizeT n); // 2, 4 and 8 byte elements
+  // cvt[ from][ to], NULL if neither type is FLOAT or DOUBLE (or the same)
+  void (*cvt[ SIMD_NCVT][ SIMD_NCVT])( void* res, const void* a, SizeT n);
+  void (*index[ SIMD_NIX])( SizeT* ix, const void* v, SizeT n, SizeT upper);
+  bool (*inRange[ SIMD_NIX])( const void* v, SizeT n, SizeT upper);
+  // z[2i] + i z[2i+1] = sqrt(-2 log(u[i])) exp(2 i pi v[i]), u in ]0,1], v in [0,1[
+  void (*boxMuller)( DDouble* z, const DDouble* u, const DDouble* v, SizeT n);
+};
+
+extern SimdKernelsT simdKernels;
+
+// selects the kernels, called at startup and by the first use
+void SimdInit();
+// best level supported by this CPU and level in use
+SimdLevel SimdBest();
+SimdLevel SimdSelected();
+// "SSE2", "NEON", "AVX2"... for the level, the baseline for SIMD_GENERIC
+const char* SimdName( SimdLevel level);
+// one line description for HELP, /INFO
+std::string SimdInfo();
+
+inline const SimdKernelsT& SimdK()
+{
+  if( simdKernels.level < 0) SimdInit();
+  return simdKernels;
+}
+
+template<typename T> struct SimdFloat
+{ static const bool value = false;
+  static const SimdFloatKernelsT<T>* Kernels() { return NULL;}};
+template<> struct SimdFloat<DFloat>
+{ static const bool value = true;
+  static const SimdFloatKernelsT<DFloat>* Kernels() { return &SimdK().f;}};
+template<> struct SimdFloat<DDouble>
+{ static const bool value = true;
+  static const SimdFloatKernelsT<DDouble>* Kernels() { return &SimdK().d;}};
+
+// elements per block of the parallel loops
+static const SizeT SIMD_BLOCK = 16384;
+
+inline bool SimdParallel( SizeT n)
+{
+  return n > SIMD_BLOCK && n >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= n);
+}
+
+// res = a op b (see SimdForm), res may be a or b
+template<typename T>
+inline void SimdBinary( void (*k)( T*, const T*, const T*, SizeT), SimdForm form, T* res, const T* a, const T* b, SizeT n)
+{
+  if( !SimdParallel( n))
+  {
+    k( res, a, b, n);
+    return;
+  }
+  const bool bVec = (form == SIMD_VV);
+  const OMPInt nBlk = (n + SIMD_BLOCK - 1) / SIMD_BLOCK;
+#pragma omp parallel for
+  for( OMPInt i = 0; i < nBlk; ++i)
+  {
+    SizeT o = i * SIMD_BLOCK;
+    SizeT m = (n - o < SIMD_BLOCK) ? n - o : SIMD_BLOCK;
+    k( res + o, a + o, bVec ? b + o : b, m);
+  }
+}
+
+template<typename T>
+inline bool SimdArith( SimdArithOp op, SimdForm form, T* res, const T* a, const T* b, SizeT n)
+{
+  if( !SimdFloat<T>::value) return false;
+  SimdBinary( SimdFloat<T>::Kernels()->arith[ op][ form], form, res, a, b, n);
+  return true;
+}
+
+// res = a ^ b (see SimdForm), res may be a or b
+template<typename T>
+inline bool SimdPow( SimdForm form, T* res, const T* a, const T* b, SizeT n)
+{
+  if( !SimdFloat<T>::value) return false;
+  SimdBinary( SimdFloat<T>::Kernels()->pow[ form], form, res, a, b, n);
+  return true;
+}
+
+// res = (a op b) (VV, or VS if bScalar)
+template<typename T>
+inline bool SimdCompare( SimdCmpOp op, bool bScalar, DByte* res, const T* a, const T* b, SizeT n)
+{
+  if( !SimdFloat<T>::value) return false;
+  void (*k)( DByte*, const T*, const T*, SizeT) = SimdFloat<T>::Kernels()->cmp[ op][ bScalar ? 1 : 0];
+  if( !SimdParallel( n))
+  {
+    k( res, a, b, n);
+    return true;
+  }
+  const OMPInt nBlk = (n + SIMD_BLOCK - 1) / SIMD_BLOCK;
+#pragma omp parallel for
+  for( OMPInt i = 0; i < nBlk; ++i)
+  {
+    SizeT o = i * SIMD_BLOCK;
+    SizeT m = (n - o < SIMD_BLOCK) ? n - o : SIMD_BLOCK;
+    k( res + o, a + o, bScalar ? b : b + o, m);
+  }
+  return true;
+}
+
+// res = f(a), res may be a
+template<typename T>
+inline void SimdUnary( void (*k)( T*, const T*, SizeT), T* res, const T* a, SizeT n)
+{
+  if( !SimdParallel( n))
+  {
+    k( res, a, n);
+    return;
+  }
+  const OMPInt nBlk = (n + SIMD_BLOCK - 1) / SIMD_BLOCK;
+#pragma omp parallel for
+  for( OMPInt i = 0; i < nBlk; ++i)
+  {
+    SizeT o = i * SIMD_BLOCK;
+    SizeT m = (n - o < SIMD_BLOCK) ? n - o : SIMD_BLOCK;
+    k( res + o, a + o, m);
+  }
+}
+
+template<typename T>
+inline bool SimdMath( SimdMathOp op, T* res, const T* a, SizeT n)
+{
+  if( !SimdFloat<T>::value) return false;
+  SimdUnary( SimdFloat<T>::Kernels()->math[ op], res, a, n);
+  return true;
+}
+// complex: SIN, COS, EXP and LOG
+inline bool SimdMath( SimdMathOp op, DComplex* res, const DComplex* a, SizeT n)
+{
+  if( SimdK().f.cmath[ op] == NULL) return false;
+  SimdUnary( SimdK().f.cmath[ op], res, a, n);
+  return true;
+}
+inline bool SimdMath( SimdMathOp op, DComplexDbl* res, const DComplexDbl* a, SizeT n)
+{
+  if( SimdK().d.cmath[ op] == NULL) return false;
+  SimdUnary( SimdK().d.cmath[ op], res, a, n);
+  return true;
+}
+
+template<typename T> struct SimdCvt { static const int value = -1;};
+template<> struct SimdCvt<DByte> { static const int value = SIMD_CVT_BYTE;};
+template<> struct SimdCvt<DInt> { static const int value = SIMD_CVT_INT;};
+template<> struct SimdCvt<DUInt> { static const int value = SIMD_CVT_UINT;};
+template<> struct SimdCvt<DLong> { static const int value = SIMD_CVT_LONG;};
+template<> struct SimdCvt<DFloat> { static const int value = SIMD_CVT_FLOAT;};
+template<> struct SimdCvt<DDouble> { static const int value = SIMD_CVT_DOUBLE;};
+
+// res[i] = a[i] converted to D
+template<typename D, typename S>
+inline bool SimdConvert( D* res, const S* a, SizeT n)
+{
+  const int from = SimdCvt<S>::value;
+  const int to = SimdCvt<D>::value;
+  if( from < 0 || to < 0) return false;
+  void (*k)( void*, const void*, SizeT) = SimdK().cvt[ from][ to];
+  if( k == NULL) return false;
+  if( !SimdParallel( n))
+  {
+    k( res, a, n);
+    return true;
+  }
+  const OMPInt nBlk = (n + SIMD_BLOCK - 1) / SIMD_BLOCK;
+#pragma omp parallel for
+  for( OMPInt i = 0; i < nBlk; ++i)
+  {
+    SizeT o = i * SIMD_BLOCK;
+    SizeT m = (n - o < SIMD_BLOCK) ? n - o : SIMD_BLOCK;
+    k( res + o, a + o, m);
+  }
+  return true;
+}
+
+// elements converted at once by SimdConvertArith(), in L1 cache
+static const SizeT SIMD_CVT_CHUNK = 1024;
+
+// res[i] = a[i] op T(b[i]), or T(b[i]) op a[i] if inv: the mixed type
+// operation without the promoted copy of b; res may be a
+template<typename T, typename S>
+inline bool SimdConvertArith( SimdArithOp op, bool inv, T* res, const T* a, const S* b, SizeT n)
+{
+  if( !SimdFloat<T>::value) return false;
+  const int from = SimdCvt<S>::value;
+  const int to = SimdCvt<T>::value;
+  if( from < 0 || to < 0) return false;
+  void (*cvt)( void*, const void*, SizeT) = SimdK().cvt[ from][ to];
+  if( cvt == NULL) return false;
+  void (*k)( T*, const T*, const T*, SizeT) = SimdFloat<T>::Kernels()->arith[ op][ SIMD_VV];
+  const OMPInt nBlk = (n + SIMD_CVT_CHUNK - 1) / SIMD_CVT_CHUNK;
+#pragma omp parallel for if( SimdParallel( n))
+  for( OMPInt i = 0; i < nBlk; ++i)
+  {
+    T tmp[ SIMD_CVT_CHUNK];
+    SizeT o = i * SIMD_CVT_CHUNK;
+    SizeT m = (n - o < SIMD_CVT_CHUNK) ? n - o : SIMD_CVT_CHUNK;
+    cvt( tmp, b + o, m);
+    if( inv) k( res + o, tmp, a + o, m);
+    else k( res + o, a + o, tmp, m);
+  }
+  return true;
+}
+
+// ix[k] = v[k] as subscript (see GetAsIndex()) clipped to upper, the
+// elements of v being of type t
+inline void SimdIndex( SimdIndexType t, SizeT* ix, const void* v, SizeT n, SizeT upper)
+{
+  SimdK().index[ t]( ix, v, n, upper);
+}
+// true if all of v are valid subscripts (see GetAsIndexStrict()) <= upper
+inline bool SimdIndexInRange( SimdIndexType t, const void* v, SizeT n, SizeT upper)
+{
+  return SimdK().inRange[ t]( v, n, upper);
+}
+
+// reverses in place the bytes of each of the n elements of 'size'
+// (2, 4 or 8) bytes at p, any other size is reversed by the plain loop
+void SimdByteSwap( void* p, SizeT size, SizeT n);
+
+#endif
@@ -0,0 +1,512 @@
+/***************************************************************************
+                          simd_math.hpp  -  vectorizable elementary functions
+                             -------------------
+    begin                : Oct 2026
+    copyright            : (C) 2026 by the GDL team
+    email                :
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+// Branch free versions of exp, log, log10, sin, cos, tan, atan and pow,
+// and of sin, cos and log of complex numbers, written so that the
+// compiler vectorizes the loops calling them (the kernels of
+// simd_dispatch.cpp). The algorithms and coefficients are the ones of
+// fdlibm/musl; the FLOAT versions compute in double and round once.
+// Maximum errors measured against the long double libm (the complex
+// functions and atan, pow against the __float128 one), for each part of
+// the complex results:
+//   DOUBLE  exp, log, log10, sin, cos, atan, pow: 1 ulp   tan: 2.5 ulp
+//           complex log: 2 ulp   complex sin, cos: 3 ulp
+//   FLOAT   all: 1 ulp
+// simd_dispatch.cpp is compiled with -ffp-contract=off: without FMA
+// contraction the results are the same, to the bit, for every instruction
+// set (and GDL_SIMD), and so are these bounds.
+// sin, cos and tan are valid for |x| <= SimdTrigMax<T>() only, the
+// kernels use the libm above (and for Inf and NaN); the domains of pow
+// and of the complex functions are given with them.
+
+#ifndef SIMD_MATH_HPP_
+#define SIMD_MATH_HPP_
+
+#include <cstring>
+#include <limits>
+
+#include "typedefs.hpp"
+
+#if defined(__GNUC__)
+#define SIMD_INLINE inline __attribute__((always_inline))
+#else
+#define SIMD_INLINE inline
+#endif
+
+SIMD_INLINE DULong64 SimdBits( DDouble x) { DULong64 u; memcpy( &u, &x, sizeof( u)); return u;}
+SIMD_INLINE DDouble SimdDouble( DULong64 u) { DDouble x; memcpy( &x, &u, sizeof( x)); return x;}
+
+// rounds to the nearest integer, 'bits' gets the integer in its low bits
+static const DDouble SIMD_ROUND = 6755399441055744.0; // 1.5 * 2^52
+static const DULong64 SIMD_ROUND_BITS = 0x4338000000000000ULL;
+SIMD_INLINE DDouble SimdRound( DDouble x, DULong64& bits)
+{
+  DDouble r = x + SIMD_ROUND;
+  bits = SimdBits( r);
+  return r - SIMD_ROUND;
+}
+// (double) k for |k| < 2^51, without the int64 conversion (AVX-512 only)
+SIMD_INLINE DDouble SimdInt2Double( DLong64 k)
+{
+  return SimdDouble( SIMD_ROUND_BITS + static_cast<DULong64>( k)) - SIMD_ROUND;
+}
+
+// exp ***************************************************************
+SIMD_INLINE DDouble SimdExp( DDouble x)
+{
+  // beyond: Inf or 0 anyway (NaN passes the comparisons)
+  DDouble xc = x > 709.8 ? 709.8 : x;
+  xc = xc < -745.2 ? -745.2 : xc;
+  DULong64 kb;
+  DDouble kd = SimdRound( xc * 1.44269504088896338700e+00, kb);
+  DLong64 k = static_cast<DLong64>( kb - SIMD_ROUND_BITS);
+  // kd * ln2hi is exact
+  DDouble r = (xc - kd * 6.93147180369123816490e-01) - kd * 1.90821492927058770002e-10;
+  DDouble t = r * r;
+  DDouble c = r - t * (1.66666666666666019037e-01 + t * (-2.77777777770155933842e-03 +
+	      t * (6.61375632143793436117e-05 + t * (-1.65339022054652515390e-06 +
+	      t * 4.13813679705723846039e-08))));
+  DDouble y = 1.0 - ((r * c) / (c - 2.0) - r);
+  // 2^k in two factors: the result may be subnormal or overflow
+  DLong64 k1 = k >> 1;
+  DLong64 k2 = k - k1;
+  return y * SimdDouble( static_cast<DULong64>( k1 + 1023) << 52) *
+    SimdDouble( static_cast<DULong64>( k2 + 1023) << 52);
+}
+
+// log, log10 ********************************************************
+// x = 2^k (1+f), 1+f in [sqrt(2)/2, sqrt(2)[, s = f/(2+f)
+SIMD_INLINE void SimdLogReduce( DDouble x, DDouble& dk, DDouble& f, DDouble& hfsq, DDouble& s, DDouble& R)
+{
+  const bool sub = x < 2.2250738585072014e-308;
+  DDouble xs = sub ? x * 18014398509481984.0 : x; // 2^54
+  DULong64 ix = SimdBits( xs);
+  DULong64 hx = (ix >> 32) + (0x3ff00000 - 0x3fe6a09e);
+  DLong64 k = static_cast<DLong64>( hx >> 20) - 0x3ff - (sub ? 54 : 0);
+  hx = (hx & 0x000fffff) + 0x3fe6a09e;
+  ix = (hx << 32) | (ix & 0xffffffffULL);
+  dk = SimdInt2Double( k);
+  f = SimdDouble( ix) - 1.0;
+  hfsq = 0.5 * f * f;
+  s = f / (2.0 + f);
+  DDouble z = s * s;
+  DDouble w = z * z;
+  DDouble t1 = w * (3.999999999940941908e-01 + w * (2.222219843214978396e-01 + w * 1.531383769920937332e-01));
+  DDouble t2 = z * (6.666666666666735130e-01 + w * (2.857142874366239149e-01 +
+		w * (1.818357216161805012e-01 + w * 1.479819860511658591e-01)));
+  R = t2 + t1;
+}
+
+// log(0) = -Inf, log(<0) = NaN, log(Inf) = Inf, log(NaN) = NaN
+SIMD_INLINE DDouble SimdLogSpecial( DDouble x, DDouble y)
+{
+  const DDouble inf = std::numeric_limits<DDouble>::infinity();
+  y = (x == 0) ? -inf : y;
+  y = (x < 0) ? std::numeric_limits<DDouble>::quiet_NaN() : y;
+  y = (x == inf || x != x) ? x : y;
+  return y;
+}
+
+SIMD_INLINE DDouble SimdLog( DDouble x)
+{
+  DDouble dk, f, hfsq, s, R;
+  SimdLogReduce( x, dk, f, hfsq, s, R);
+  DDouble y = s * (hfsq + R) + dk * 1.90821492927058770002e-10 - hfsq + f + dk * 6.93147180369123816490e-01;
+  return SimdLogSpecial( x, y);
+}
+
+SIMD_INLINE DDouble SimdLog10( DDouble x)
+{
+  DDouble dk, f, hfsq, s, R;
+  SimdLogReduce( x, dk, f, hfsq, s, R);
+  // f - hfsq in hi + lo, hi with 20 significant bits
+  DDouble hi = SimdDouble( SimdBits( f - hfsq) & 0xffffffff00000000ULL);
+  DDouble lo = f - hi - hfsq + s * (hfsq + R);
+  DDouble valHi = hi * 4.34294481878168880939e-01;
+  DDouble y = dk * 3.01029995663611771306e-01;
+  DDouble valLo = dk * 3.69423907715893078616e-13 + (lo + hi) * 2.50829467116452752298e-11 +
+    lo * 4.34294481878168880939e-01;
+  DDouble w = y + valHi;
+  valLo += (y - w) + valHi;
+  return SimdLogSpecial( x, valLo + w);
+}
+
+// sin, cos, tan *****************************************************
+// x = q pi/2 + (r + rr), |r| <= pi/4, for |q| < 2^20: the steps of
+// fdlibm's __ieee754_rem_pio2, all done (no branch)
+template<typename T> inline T SimdTrigMax();
+template<> inline DDouble SimdTrigMax<DDouble>() { return 1.0e6;}
+template<> inline DFloat SimdTrigMax<DFloat>() { return 1.0e8f;}
+
+SIMD_INLINE DDouble SimdTrigReduce( DDouble x, DULong64& q, DDouble& rr)
+{
+  DDouble fn = SimdRound( x * 6.36619772367581382433e-01, q);
+  DDouble t = x - fn * 1.57079632673412561417e+00; // exact
+  DDouble w = fn * 6.07710050630396597660e-11;
+  DDouble r = t - w;
+  DDouble d2 = (t - r) - w; // rounding error of t - w
+  t = r;
+  w = fn * 2.02226624871116645580e-21;
+  r = t - w;
+  w = fn * 8.47842766036889956997e-32 - ((t - r) - w) - d2;
+  DDouble y = r - w;
+  rr = (r - y) - w;
+  return y;
+}
+
+// fdlibm __kernel_sin, __kernel_cos: x + y, |x| <= pi/4, |y| << |x|
+SIMD_INLINE DDouble SimdSinKernel( DDouble x, DDouble y)
+{
+  DDouble z = x * x;
+  DDouble v = z * x;
+  DDouble r = 8.33333333332248946124e-03 + z * (-1.98412698298579493134e-04 + z * (2.75573137070700676789e-06 +
+	      z * (-2.50507602534068634195e-08 + z * 1.58969099521155010221e-10)));
+  return x - ((z * (0.5 * y - v * r) - y) - v * -1.66666666666666324348e-01);
+}
+
+SIMD_INLINE DDouble SimdCosKernel( DDouble x, DDouble y)
+{
+  DDouble z = x * x;
+  DDouble r = z * (4.16666666666666019037e-02 + z * (-1.38888888888741095749e-03 +
+	      z * (2.48015872894767294178e-05 + z * (-2.75573143513906633035e-07 +
+	      z * (2.08757232129817482790e-09 + z * -1.13596475577881948265e-11)))));
+  DDouble hz = 0.5 * z;
+  DDouble w = 1.0 - hz;
+  return w + (((1.0 - w) - hz) + (z * r - x * y));
+}
+
+// Op: 0 sin, 1 cos, 2 tan; sin(-0) and tan(-0) are -0
+template<int Op>
+SIMD_INLINE DDouble SimdTrig( DDouble x)
+{
+  DULong64 q;
+  DDouble rr;
+  DDouble r = SimdTrigReduce( x, q, rr);
+  DDouble s = SimdSinKernel( r, rr);
+  DDouble c = SimdCosKernel( r, rr);
+  const bool odd = (q & 1) != 0;
+  if( Op == 2) // one division: no spurious division by zero
+    return (x == 0) ? x : (odd ? -c : s) / (odd ? s : c);
+  DDouble y;
+  bool neg;
+  if( Op == 0)
+  {
+    y = odd ? c : s;
+    neg = (q & 2) != 0;
+  }
+  else
+  {
+    y = odd ? s : c;
+    neg = ((q + 1) & 2) != 0;
+  }
+  y = neg ? -y : y;
+  return (Op == 0 && x == 0) ? x : y;
+}
+
+SIMD_INLINE void SimdSinCos( DDouble x, DDouble& sinx, DDouble& cosx)
+{
+  DULong64 q;
+  DDouble rr;
+  DDouble r = SimdTrigReduce( x, q, rr);
+  DDouble s = SimdSinKernel( r, rr);
+  DDouble c = SimdCosKernel( r, rr);
+  const bool odd = (q & 1) != 0;
+  sinx = odd ? c : s;
+  cosx = odd ? s : c;
+  sinx = (q & 2) ? -sinx : sinx;
+  sinx = (x == 0) ? x : sinx;
+  cosx = ((q + 1) & 2) ? -cosx : cosx;
+}
+
+// FLOAT: reduction and kernels of musl (__rem_pio2f, __sindf...) in double
+SIMD_INLINE DDouble SimdTrigReduceF( DDouble x, DULong64& q)
+{
+  DDouble kd = SimdRound( x * 6.36619772367581382433e-01, q);
+  return (x - kd * 1.57079631090164184570e+00) - kd * 1.58932547735281966916e-08;
+}
+
+SIMD_INLINE DDouble SimdSinKernelF( DDouble x)
+{
+  DDouble z = x * x;
+  DDouble w = z * z;
+  DDouble r = -1.98393348360966317347e-04 + z * 2.7183114939898219064e-06;
+  DDouble s = z * x;
+  return (x + s * (-1.66666666416265235595e-01 + z * 8.3333293858894631756e-03)) + s * w * r;
+}
+
+SIMD_INLINE DDouble SimdCosKernelF( DDouble x)
+{
+  DDouble z = x * x;
+  DDouble w = z * z;
+  DDouble r = -1.38867637746099294692e-03 + z * 2.43904487962774090654e-05;
+  return ((1.0 + z * -4.99999997251031003120e-01) + w * 4.16666233237390631894e-02) + (w * z) * r;
+}
+
+SIMD_INLINE DDouble SimdTanKernelF( DDouble x, bool odd)
+{
+  DDouble z = x * x;
+  DDouble r = 2.97435743359967304927e-03 + z * 9.46564784943673166728e-03;
+  DDouble t = 5.33812378445670393523e-02 + z * 2.45283181166547278873e-02;
+  DDouble w = z * z;
+  DDouble s = z * x;
+  DDouble u = 3.33331395030791399758e-01 + z * 1.33392002712976742718e-01;
+  r = (x + s * u) + (s * w) * (t + w * r);
+  return odd ? -1.0 / r : r;
+}
+
+template<int Op>
+SIMD_INLINE DFloat SimdTrig( DFloat xf)
+{
+  DULong64 q;
+  DDouble r = SimdTrigReduceF( xf, q);
+  const bool odd = (q & 1) != 0;
+  if( Op == 2)
+    return (xf == 0) ? xf : static_cast<DFloat>( SimdTanKernelF( r, odd));
+  DDouble s = SimdSinKernelF( r);
+  DDouble c = SimdCosKernelF( r);
+  DDouble y;
+  bool neg;
+  if( Op == 0)
+  {
+    y = odd ? c : s;
+    neg = (q & 2) != 0;
+  }
+  else
+  {
+    y = odd ? s : c;
+    neg = ((q + 1) & 2) != 0;
+  }
+  y = neg ? -y : y;
+  return (Op == 0 && xf == 0) ? xf : static_cast<DFloat>( y);
+}
+
+// atan **************************************************************
+// fdlibm's s_atan: |x| is reduced to one of 5 intervals by
+// atan(|x|) = atan(c) + atan((a|x| + b) / (c' + d|x|)), the selection
+// done on the bits (no comparison of NaN)
+SIMD_INLINE DDouble SimdAtan( DDouble x)
+{
+  const DULong64 sign = SimdBits( x) & 0x8000000000000000ULL;
+  DULong64 ix = SimdBits( x) ^ sign;
+  // beyond 2^66, atan(x) = pi/2 (and no underflow of -1/x squared)
+  ix = (ix > 0x4410000000000000ULL && ix <= 0x7ff0000000000000ULL) ? 0x4410000000000000ULL : ix;
+  const DDouble ax = SimdDouble( ix);
+  const DULong64 hx = ix >> 32;
+  const bool id0 = hx >= 0x3fdc0000; // 0.4375
+  const bool id1 = hx >= 0x3fe60000; // 0.6875
+  const bool id2 = hx >= 0x3ff30000; // 1.1875
+  const bool id3 = hx >= 0x40038000; // 2.4375
+  DDouble a = id3 ? 0.0 : (id1 ? 1.0 : 2.0);
+  DDouble b = id3 ? -1.0 : (id2 ? -1.5 : -1.0);
+  DDouble c = id3 ? 0.0 : (id1 ? 1.0 : 2.0);
+  DDouble d = id2 ? (id3 ? 1.0 : 1.5) : 1.0;
+  DDouble hi = id3 ? 1.57079632679489655800e+00 : (id2 ? 9.82793723247329054082e-01 :
+	       (id1 ? 7.85398163397448278999e-01 : 4.63647609000806093515e-01));
+  DDouble lo = id3 ? 6.12323399573676603587e-17 : (id2 ? 1.39033110312309984516e-17 :
+	       (id1 ? 3.06161699786838301793e-17 : 2.26987774529616870924e-17));
+  DDouble t = id0 ? (a * ax + b) / (c + d * ax) : ax;
+  // below 2^-27, atan(x) = x
+  DDouble tp = (hx < 0x3e400000) ? 0.0 : t;
+  DDouble z = tp * tp;
+  DDouble w = z * z;
+  DDouble s1 = z * (3.33333333333329318027e-01 + w * (1.42857142725034663711e-01 + w * (9.09088713343650656196e-02 +
+	       w * (6.66107313738753120669e-02 + w * (4.97687799461593236017e-02 + w * 1.62858201153657823623e-02)))));
+  DDouble s2 = w * (-1.99999999998764832476e-01 + w * (-1.11111104054623557880e-01 + w * (-7.69187620504482999495e-02 +
+	       w * (-5.83357013379057348645e-02 + w * -3.65315727442169155270e-02))));
+  DDouble y = id0 ? hi - ((t * (s1 + s2) - lo) - t) : t - t * (s1 + s2);
+  return SimdDouble( SimdBits( y) | sign);
+}
+
+// pow ***************************************************************
+// fdlibm's e_pow for x normal, y integral if x < 0, |y| <= 2^30:
+// log2|x| = t1 + t2, t1 on 21 bits, y log2|x| = p_h + p_l = n + z and
+// 2^z 2^n. ok is false if |y log2|x|| > 1020, where the result might
+// not be a normal number (the caller uses the libm then).
+SIMD_INLINE DDouble SimdHi( DDouble x) { return SimdDouble( SimdBits( x) & 0xffffffff00000000ULL);}
+
+SIMD_INLINE DDouble SimdPow( DDouble x, DDouble y, bool& ok)
+{
+  const DULong64 ix = SimdBits( x) & 0x7fffffffffffffffULL;
+  const DULong64 j = (ix >> 32) & 0x000fffff;
+  // |x| = 2^n ax, ax in [sqrt(3)/2, sqrt(3)[, bp = 1 or 1.5
+  const bool k1 = j > 0x3988E && j < 0xBB67A;
+  const bool up = j >= 0xBB67A;
+  DLong64 n = static_cast<DLong64>( ix >> 52) - 0x3ff + (up ? 1 : 0);
+  const DULong64 hx = up ? (j | 0x3ff00000) - 0x00100000 : (j | 0x3ff00000);
+  const DDouble ax = SimdDouble( (hx << 32) | (ix & 0xffffffffULL));
+  const DDouble bp = k1 ? 1.5 : 1.0;
+  const DDouble dp_h = k1 ? 5.84962487220764160156e-01 : 0.0;
+  const DDouble dp_l = k1 ? 1.35003920212974897128e-08 : 0.0;
+  // ss = s_h + s_l = (ax - bp) / (ax + bp)
+  DDouble u = ax - bp;
+  DDouble v = 1.0 / (ax + bp);
+  const DDouble ss = u * v;
+  const DDouble s_h = SimdHi( ss);
+  DDouble t_h = SimdDouble( (((hx >> 1) | 0x20000000) + 0x00080000 + (k1 ? 0x40000 : 0)) << 32);
+  DDouble t_l = ax - (t_h - bp);
+  const DDouble s_l = v * ((u - s_h * t_h) - s_h * t_l);
+  // log(ax)
+  DDouble s2 = ss * ss;
+  DDouble r = s2 * s2 * (5.99999999999994648725e-01 + s2 * (4.28571428578550184252e-01 +
+	      s2 * (3.33333329818377432918e-01 + s2 * (2.72728123808534006489e-01 +
+	      s2 * (2.30660745775561754067e-01 + s2 * 2.06975017800338417784e-01)))));
+  r += s_l * (s_h + ss);
+  s2 = s_h * s_h;
+  t_h = SimdHi( 3.0 + s2 + r);
+  t_l = r - ((t_h - 3.0) - s2);
+  u = s_h * t_h;
+  v = s_l * t_h + t_l * ss;
+  DDouble p_h = SimdHi( u + v);
+  DDouble p_l = v - (p_h - u);
+  // log2(ax) = (ss + ...) 2/(3 log2) = n + dp_h + z_h + z_l
+  const DDouble z_h = 9.61796700954437255859e-01 * p_h;
+  const DDouble z_l = -7.02846165095275826516e-09 * p_h + p_l * 9.61796693925975554329e-01 + dp_l;
+  DDouble t = SimdInt2Double( n);
+  const DDouble t1 = SimdHi( ((z_h + z_l) + dp_h) + t);
+  const DDouble t2 = z_l - (((t1 - t) - dp_h) - z_h);
+  // (y1 + y2) (t1 + t2), y1 t1 exact
+  const DDouble y1 = SimdHi( y);
+  p_l = (y - y1) * t1 + y * t2;
+  p_h = y1 * t1;
+  DDouble z = p_l + p_h;
+  ok = (SimdBits( z) & 0x7fffffffffffffffULL) <= 0x408fe00000000000ULL; // 1020
+  DULong64 nb;
+  const DDouble nd = SimdRound( ok ? z : 0.0, nb);
+  p_h -= nd; // exact
+  // 2^(p_h + p_l)
+  t = SimdHi( p_l + p_h);
+  u = t * 6.93147182464599609375e-01;
+  v = (p_l - (t - p_h)) * 6.93147180559945286227e-01 + t * -1.90465429995776804525e-09;
+  z = u + v;
+  const DDouble w = v - (z - u);
+  t = z * z;
+  DDouble c = z - t * (1.66666666666666019037e-01 + t * (-2.77777777770155933842e-03 +
+	      t * (6.61375632143793436117e-05 + t * (-1.65339022054652515390e-06 +
+	      t * 4.13813679705723846039e-08))));
+  r = (z * c) / (c - 2.0) - (w + z * w);
+  z = 1.0 - (r - z);
+  // x < 0: the sign of the result is the parity of y
+  DULong64 yb;
+  SimdRound( y, yb);
+  const DULong64 neg = (SimdBits( x) >> 63) & yb & 1;
+  return SimdDouble( (SimdBits( z) + ((nb - SIMD_ROUND_BITS) << 52)) ^ (neg << 63));
+}
+
+// complex log, sin, cos *********************************************
+// atan2(y, x), x and y finite, not both 0: t = atan(min/max) and
+// atan2 = +-t, pi/2 +- t or pi - t, pi/2 and pi in hi + lo
+SIMD_INLINE DDouble SimdAtan2( DDouble y, DDouble x)
+{
+  const DULong64 ax = SimdBits( x) & 0x7fffffffffffffffULL;
+  const DULong64 ay = SimdBits( y) & 0x7fffffffffffffffULL;
+  const bool swap = ay > ax;
+  const bool neg = (SimdBits( x) >> 63) != 0;
+  const DDouble t = SimdAtan( swap ? SimdDouble( ax) / SimdDouble( ay) : SimdDouble( ay) / SimdDouble( ax));
+  const DDouble hi = swap ? 1.57079632679489655800e+00 : (neg ? 3.14159265358979311600e+00 : 0.0);
+  const DDouble lo = swap ? 6.12323399573676603587e-17 : (neg ? 1.22464679914735317720e-16 : 0.0);
+  const DDouble a = (hi + (swap != neg ? -t : t)) + lo;
+  return SimdDouble( SimdBits( a) | (SimdBits( y) & 0x8000000000000000ULL));
+}
+
+// x^2 = hi + lo exactly (Dekker), for |x| in [1e-150, 1e150]
+SIMD_INLINE void SimdSquare( DDouble x, DDouble& hi, DDouble& lo)
+{
+  const DDouble c = 134217729.0 * x; // 2^27 + 1
+  const DDouble xh = c - (c - x);
+  const DDouble xl = x - xh;
+  hi = x * x;
+  lo = ((xh * xh - hi) + 2.0 * xh * xl) + xl * xl;
+}
+
+// a + b = s + e exactly
+SIMD_INLINE DDouble SimdTwoSum( DDouble a, DDouble b, DDouble& e)
+{
+  const DDouble s = a + b;
+  const DDouble bb = s - a;
+  e = (a - (s - bb)) + (b - bb);
+  return s;
+}
+
+// log(x + iy) = log(x^2 + y^2) / 2 + i atan2(y, x). x^2 + y^2 = s + e
+// + xl + yl exactly; for s in [0.5, 2], u = x^2 + y^2 - 1 is summed
+// without cancellation and log(1 + u) = log(w) + (u - (w - 1)) / w,
+// w = 1 + u rounded
+SIMD_INLINE void SimdCLog( DDouble x, DDouble y, DDouble& re, DDouble& im)
+{
+  DDouble xh, xl, yh, yl, e, e1, e2, e3;
+  SimdSquare( x, xh, xl);
+  SimdSquare( y, yh, yl);
+  const DDouble s = SimdTwoSum( xh, yh, e);
+  DDouble u = SimdTwoSum( s - 1.0, e, e1); // s - 1 exact
+  u = SimdTwoSum( u, xl, e2);
+  u = SimdTwoSum( u, yl, e3);
+  u += e1 + e2 + e3;
+  const DDouble w = 1.0 + u;
+  const bool near = s >= 0.5 && s <= 2.0;
+  const DDouble c = near ? (u - (w - 1.0)) / w : ((e + xl) + yl) / s;
+  re = 0.5 * (SimdLog( near ? w : s) + c);
+  im = SimdAtan2( y, x);
+}
+
+// sinh and cosh of |y| <= 708, sinh(y) by its series up to 1
+SIMD_INLINE void SimdSinhCosh( DDouble y, DDouble& sh, DDouble& ch)
+{
+  const DULong64 ay = SimdBits( y) & 0x7fffffffffffffffULL;
+  const DDouble e = SimdExp( SimdDouble( ay));
+  const DDouble ie = 1.0 / e;
+  ch = 0.5 * (e + ie);
+  const DDouble z = y * y;
+  const DDouble p = y + y * z * (1.66666666666666657415e-01 + z * (8.33333333333333321769e-03 +
+		    z * (1.98412698412698412526e-04 + z * (2.75573192239858925110e-06 +
+		    z * (2.50521083854417202239e-08 + z * (1.60590438368216133409e-10 +
+		    z * (7.64716373181981640551e-13 + z * (2.81145725434552059811e-15 +
+		    z * 8.22063524662432949554e-18))))))));
+  const DDouble big = SimdDouble( SimdBits( 0.5 * (e - ie)) | (SimdBits( y) & 0x8000000000000000ULL));
+  sh = (ay <= 0x3ff0000000000000ULL) ? p : big;
+}
+
+// sin(x + iy) = sin x cosh y + i cos x sinh y
+// cos(x + iy) = cos x cosh y - i sin x sinh y
+template<int Op>
+SIMD_INLINE void SimdCTrig( DDouble x, DDouble y, DDouble& re, DDouble& im)
+{
+  DDouble s, c, sh, ch;
+  SimdSinCos( x, s, c);
+  SimdSinhCosh( y, sh, ch);
+  re = (Op == 0 ? s : c) * ch;
+  im = (Op == 0 ? c * sh : -(s * sh));
+}
+
+SIMD_INLINE DFloat SimdExp( DFloat x) { return static_cast<DFloat>( SimdExp( static_cast<DDouble>( x)));}
+SIMD_INLINE DFloat SimdLog( DFloat x) { return static_cast<DFloat>( SimdLog( static_cast<DDouble>( x)));}
+SIMD_INLINE DFloat SimdLog10( DFloat x)
+{
+  return static_cast<DFloat>( SimdLog( static_cast<DDouble>( x)) * 4.34294481903251827651e-01);
+}
+SIMD_INLINE DFloat SimdAtan( DFloat x) { return static_cast<DFloat>( SimdAtan( static_cast<DDouble>( x)));}
+// |y log|x|| <= 87: the result is a normal FLOAT
+SIMD_INLINE DFloat SimdPow( DFloat x, DFloat y, bool& ok)
+{
+  DDouble t = static_cast<DDouble>( y) * SimdLog( SimdDouble( SimdBits( x) & 0x7fffffffffffffffULL));
+  ok = (SimdBits( t) & 0x7fffffffffffffffULL) <= 0x4055c00000000000ULL; // 87
+  DULong64 yb;
+  SimdRound( y, yb);
+  const DULong64 neg = (SimdBits( x) >> 63) & yb & 1;
+  return static_cast<DFloat>( SimdDouble( SimdBits( SimdExp( ok ? t : 0.0)) ^ (neg << 63)));
+}
+
+#endif
@@ -70,6 +70,9 @@ inline static SizeT transposed1Index(const SizeT inputindex, const SizeT* srcDim
 
   return ix;
 }
+// rows smoothed together by each thread in smooth2d.hpp, smooth2dnans.hpp
+#define SMOOTH_BLOCK 32
+
 // include repeatedly smooth_inc for all useful types.
 
 #define SMOOTH_Ty DByte
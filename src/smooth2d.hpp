@@ -1,5 +1,5 @@
 /***************************************************************************
-                          smooth2d.hpp -- smooth accelerated 2d
+                          smooth2d.hpp -- smooth accelerated 2d and 3d
                              -------------------
     begin                : May 30 2017
     copyright            : (C) 2017 by G. Duvert
@@ -15,154 +15,61 @@
  *                                                                         *
  ***************************************************************************/
 
-// to be included from datatypes.cpp
+// to be included from smooth_inc.cpp, with sDim[sRank] the dimensions of src.
 #ifdef INCLUDE_SMOOTH_2D
-SizeT w1 = width[0] / 2;
-SizeT w2 = width[1] / 2;
-SizeT nEl = dimx*dimy;
-SMOOTH_Ty* tmp=(SMOOTH_Ty*)malloc(nEl*sizeof(SMOOTH_Ty));
-//parallelizing all that stuff is more complicated than a single pragma...
-//#pragma omp parallel if (nEl >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= nEl))
-{
- for (SizeT j = 0; j < dimy; ++j) {
-  DDouble z;
-  DDouble n = 0;
-  DDouble mean = 0;
-  for (SizeT i = j * dimx; i < j * dimx + (2 * w1 + 1);) {
-   DDouble v = src[i++];
-   n += 1.0;
-   z = 1. / n;
-   mean = (1. - z) * mean + z * v;
-  }
-
-#if defined(USE_EDGE)  
-  //start: use mean1
-  DDouble mean1 = mean;
-  for (SizeT i = 0; i < w1; ++i) {
-   tmp[j + (w1 - i) * dimy] = mean1;
-   DDouble v = src[2 * w1 - i + j * dimx];
-   mean1 -= z*v;
 
-#if defined (EDGE_WRAP)  
-   v = src[dimx - i - 1 + j * dimx];
-#elif defined (EDGE_TRUNCATE)  
-   v = src[0 + j * dimx];
-#elif defined (EDGE_MIRROR)  
-   v = src[i + j * dimx];
+#if defined (EDGE_WRAP)
+#define SMOOTH_1D_ROW Smooth1DWrap
+#elif defined (EDGE_TRUNCATE)
+#define SMOOTH_1D_ROW Smooth1DTruncate
+#elif defined (EDGE_MIRROR)
+#define SMOOTH_1D_ROW Smooth1DMirror
 #elif defined (EDGE_ZERO)
-   v = 0;
-#endif
-   mean1 += z*v;
-  }
-  tmp[j + 0 * dimy] = mean1;
-#else //just transpose
-  for (SizeT i = 0; i < w1; ++i) tmp[j + i * dimy] = src[i + j * dimx];
-#endif      
-
-  //middle: use mean & n
-  for (SizeT i = w1; i < dimx - w1 - 1;) {
-   tmp[j + i * dimy] = mean;
-   DDouble v = src[i - w1 + j * dimx];
-   mean -= z*v;
-   v = src[(i++) + w1 + 1 + j * dimx];
-   mean += z*v;
-  }
-  tmp[j + (dimx - w1 - 1) * dimy] = mean;
-
-#if defined(USE_EDGE)  
-  //end: use mean
-
-  for (SizeT i = dimx - 1 - w1; i < dimx - 1; ++i) {
-   tmp[j + i * dimy] = mean;
-   DDouble v = src[i - w1 + j * dimx];
-   mean -= z*v;
-
-#if defined (EDGE_WRAP)  
-   v = src[i - dimx + w1 + 1 + j * dimx];
-#elif defined (EDGE_TRUNCATE)  
-   v = src[dimx - 1 + j * dimx];
-#elif defined (EDGE_MIRROR)  
-   v = src[2 * dimx - i - w1 - 2 + j * dimx];
-#elif defined (EDGE_ZERO)
-   v = 0;
-#endif
-   mean += z*v;
-  }
-  tmp[j + (dimx - 1) * dimy] = mean;
+#define SMOOTH_1D_ROW Smooth1DZero
 #else
-  for (SizeT i = dimx - w1; i < dimx; ++i) tmp[j + i * dimy] = src[i + j * dimx];
+#define SMOOTH_1D_ROW Smooth1D
 #endif
- }
-
- for (SizeT j = 0; j < dimx; ++j) {
-  DDouble z;
-  DDouble n = 0;
-  DDouble mean = 0;
-  for (SizeT i = j * dimy; i < j * dimy + (2 * w2 + 1);) {
-   DDouble v = tmp[i++];
-   n += 1.0;
-   z = 1. / n;
-   mean = (1. - z) * mean + z * v;
-  }
 
-#if defined(USE_EDGE)  
-  //start: use mean1
-  DDouble mean1 = mean;
-  for (SizeT i = 0; i < w2; ++i) {
-   dest[j + (w2 - i) * dimx] = mean1;
-   DDouble v = tmp[2 * w2 - i + j * dimy];
-   mean1 -= z*v;
-
-#if defined (EDGE_WRAP)  
-   v = tmp[dimy - i - 1 + j * dimy];
-#elif defined (EDGE_TRUNCATE)  
-   v = tmp[0 + j * dimy];
-#elif defined (EDGE_MIRROR)  
-   v = tmp[i + j * dimy];
-#elif defined (EDGE_ZERO)
-   v = 0;
-#endif
-   mean1 += z*v;
-  }
-  dest[j + 0 * dimx] = mean1;
-#else //just transpose
-  for (SizeT i = 0; i < w2; ++i) dest[j + i * dimx] = tmp[i + j * dimy];
-#endif
-
-  //middle: use mean
-  for (SizeT i = w2; i < dimy - w2 - 1;) {
-   dest[j + i * dimx] = mean;
-   DDouble v = tmp[i - w2 + j * dimy];
-   mean -= z*v;
-   v = tmp[(i++) + w2 + 1 + j * dimy];
-   mean += z*v;
-  }
-  dest[j + (dimy - w2 - 1) * dimx] = mean;
-
-#if defined(USE_EDGE)  
-  //end: use mean
-  for (SizeT i = dimy - 1 - w2; i < dimy - 1; ++i) {
-   dest[j + i * dimx] = mean;
-   DDouble v = tmp[i - w2 + j * dimy];
-   mean -= z*v;
-
-#if defined (EDGE_WRAP)  
-   v = tmp[i - dimy + w2 + 1 + j * dimy];
-#elif defined (EDGE_TRUNCATE)  
-   v = tmp[dimy - 1 + j * dimy];
-#elif defined (EDGE_MIRROR)  
-   v = tmp[2 * dimy - i - w2 - 2 + j * dimy];
-#elif defined (EDGE_ZERO)
-   v = 0;
-#endif
-   mean += z*v;
+// Each pass smoothes the rows along the first dimension and writes them transposed, (d0,d1,...) -> (d1,...,d0),
+// so that after sRank passes all dimensions are done and in their original order. Threads take blocks of
+// SMOOTH_BLOCK rows, smoothed in a private buffer that is then written out SMOOTH_BLOCK elements at a time.
+SizeT nEl = 1;
+SizeT curDim[MAXRANK];
+for (int r = 0; r < sRank; ++r) {
+ curDim[r] = sDim[r];
+ nEl *= sDim[r];
+}
+SMOOTH_Ty* tmp = (SMOOTH_Ty*) malloc(nEl * sizeof (SMOOTH_Ty));
+const SMOOTH_Ty* in = src;
+for (int p = 0; p < sRank; ++p) {
+ SMOOTH_Ty* out = ((sRank - 1 - p) % 2 == 0) ? dest : tmp; // the last pass writes to dest
+ const SizeT dimx = curDim[0];
+ const SizeT dimy = nEl / dimx;
+ const SizeT w = width[p] / 2;
+ const OMPInt nBlocks = (dimy + SMOOTH_BLOCK - 1) / SMOOTH_BLOCK;
+#pragma omp parallel if (nEl >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= nEl))
+ {
+  SMOOTH_Ty* buf = (SMOOTH_Ty*) malloc(SMOOTH_BLOCK * dimx * sizeof (SMOOTH_Ty));
+#pragma omp for
+  for (OMPInt b = 0; b < nBlocks; ++b) {
+   const SizeT j0 = b * SMOOTH_BLOCK;
+   const SizeT nj = (dimy - j0 < SMOOTH_BLOCK) ? dimy - j0 : SMOOTH_BLOCK;
+   // values where no mean is written (edges without edge mode) stay as they are
+   memcpy(buf, in + j0 * dimx, nj * dimx * sizeof (SMOOTH_Ty));
+   if (w > 0) for (SizeT k = 0; k < nj; ++k) SMOOTH_1D_ROW(in + (j0 + k) * dimx, buf + k * dimx, dimx, w);
+   for (SizeT i = 0; i < dimx; ++i) {
+    SMOOTH_Ty* o = out + j0 + i * dimy;
+    for (SizeT k = 0; k < nj; ++k) o[k] = buf[k * dimx + i];
+   }
   }
-  dest[j + (dimy - 1) * dimx] = mean;
-#else
-  for (SizeT i = dimy - w2; i < dimy; ++i) dest[j + i * dimx] = tmp[i + j * dimy];
-#endif
+  free(buf);
  }
+ // rotate the dimensions
+ for (int r = 0; r < sRank - 1; ++r) curDim[r] = curDim[r + 1];
+ curDim[sRank - 1] = dimx;
+ in = out;
 }
 free(tmp);
 
+#undef SMOOTH_1D_ROW
 #endif
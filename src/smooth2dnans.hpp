@@ -1,5 +1,5 @@
 /***************************************************************************
-                          smooth2dnans.hpp -- nan version of smooth accelerated 2d
+                          smooth2dnans.hpp -- nan version of smooth accelerated 2d and 3d
                              -------------------
     begin                : May 30 2017
     copyright            : (C) 2017 by G. Duvert
@@ -15,248 +15,61 @@
  *                                                                         *
  ***************************************************************************/
 
-// to be included from datatypes.cpp
+// to be included from smooth_inc.cpp, with sDim[sRank] the dimensions of src.
 #ifdef INCLUDE_SMOOTH_2D_NAN
 
-SizeT w1 = width[0] / 2;
-SizeT w2 = width[1] / 2;
-SizeT nEl = dimx*dimy;
-SMOOTH_Ty* tmp=(SMOOTH_Ty*)malloc(nEl*sizeof(SMOOTH_Ty));
-//parallelizing all that stuff is more complicated than a single pragma...
-//#pragma omp parallel if (nEl >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= nEl))
-{
- for (SizeT j = 0; j < dimy; ++j) {
-  DDouble z;
-  DDouble n = 0;
-  DDouble mean = 0;
-  for (SizeT i = j * dimx; i < j * dimx + (2 * w1 + 1);) {
-   DDouble v = src[i++];
-   if (isfinite(v)) {
-    n += 1.0;
-    z = 1. / n;
-    mean = (1. - z) * mean + z * v;
-   }
-  }
-
-#if defined(USE_EDGE)  
-  //start: use mean1, n1
-  DDouble mean1 = mean;
-  DDouble n1 = n;
-  for (SizeT i = 0; i < w1; ++i) {
-   if (n1 > 0) tmp[j + (w1 - i) * dimy] = mean1;
-   DDouble v = src[2 * w1 - i + j * dimx];
-   if (isfinite(v)) {
-    mean1 *= n1;
-    mean1 -= v;
-    n1 -= 1.0;
-    mean1 /= n1;
-   }
-
-   if (n1 <= 0) mean1 = 0;
-
-#if defined (EDGE_WRAP)  
-   v = src[dimx - i - 1 + j * dimx];
-   if (isfinite(v)) {
-#elif defined (EDGE_TRUNCATE)  
-   v = src[0 + j * dimx];
-   if (isfinite(v)) {
-#elif defined (EDGE_MIRROR)  
-   v = src[i + j * dimx];
-   if (isfinite(v)) {
+#if defined (EDGE_WRAP)
+#define SMOOTH_1D_ROW Smooth1DWrapNan
+#elif defined (EDGE_TRUNCATE)
+#define SMOOTH_1D_ROW Smooth1DTruncateNan
+#elif defined (EDGE_MIRROR)
+#define SMOOTH_1D_ROW Smooth1DMirrorNan
 #elif defined (EDGE_ZERO)
-   v = 0;
-   {
-#endif
-    mean1 *= n1;
-    if (n1 < 2 * w1 + 1) n1 += 1.0;
-    mean1 += v;
-    mean1 /= n1;
-   }
-  }
-  if (n1 > 0) tmp[j + 0 * dimy] = mean1;
-#else //just transpose
-  for (SizeT i = 0; i < w1; ++i) tmp[j + i * dimy] = src[i + j * dimx];
-#endif      
-
-  //middle: use mean & n
-  for (SizeT i = w1; i < dimx - w1 - 1;) {
-   tmp[j + i * dimy] = (n > 0) ? mean : src[i + j * dimx];
-   DDouble v = src[i - w1 + j * dimx];
-   if (isfinite(v)) {
-    mean *= n;
-    mean -= v;
-    n -= 1.0;
-    mean /= n;
-   }
-   if (n <= 0) mean = 0;
-
-   v = src[(i++) + w1 + 1 + j * dimx];
-   if (isfinite(v)) {
-    mean *= n;
-    if (n < 2 * w1 + 1) n += 1.0;
-    mean += v;
-    mean /= n;
-   }
-  }
-  tmp[j + (dimx - w1 - 1) * dimy] = (n > 0) ? mean : src[ dimx - w1 - 1 + j * dimx];
-
-#if defined(USE_EDGE)  
-  //end: use mean2 & n as we go in the same direction...
-  DDouble mean2 = mean;
-
-  for (SizeT i = dimx - 1 - w1; i < dimx - 1; ++i) {
-   if (n > 0) tmp[j + i * dimy] = mean2;
-   DDouble v = src[i - w1 + j * dimx];
-   if (isfinite(v)) {
-    mean2 *= n;
-    mean2 -= v;
-    n -= 1.0;
-    mean2 /= n;
-   }
-
-   if (n <= 0) mean2 = 0;
-
-#if defined (EDGE_WRAP)  
-   v = src[i - dimx + w1 + 1 + j * dimx];
-   if (isfinite(v)) {
-#elif defined (EDGE_TRUNCATE)  
-   v = src[dimx - 1 + j * dimx];
-   if (isfinite(v)) {
-#elif defined (EDGE_MIRROR)  
-   v = src[2 * dimx - i - w1 - 2 + j * dimx];
-   if (isfinite(v)) {
-#elif defined (EDGE_ZERO)
-   v = 0;
-   {
-#endif
-    mean2 *= n;
-    if (n < 2 * w1 + 1) n += 1.0;
-    mean2 += v;
-    mean2 /= n;
-   }
-  }
-  if (n > 0) tmp[j + (dimx - 1) * dimy] = mean2;
+#define SMOOTH_1D_ROW Smooth1DZeroNan
 #else
-  for (SizeT i = dimx - w1; i < dimx; ++i) tmp[j + i * dimy] = src[i + j * dimx];
-#endif
- }
-
- for (SizeT j = 0; j < dimx; ++j) {
-  DDouble z;
-  DDouble n = 0;
-  DDouble mean = 0;
-  for (SizeT i = j * dimy; i < j * dimy + (2 * w2 + 1);) {
-   DDouble v = tmp[i++];
-   if (isfinite(v)) {
-    n += 1.0;
-    z = 1. / n;
-    mean = (1. - z) * mean + z * v;
-   }
-  }
-
-#if defined(USE_EDGE)  
-  //start: use mean1, n1
-  DDouble mean1 = mean;
-  DDouble n1 = n;
-  for (SizeT i = 0; i < w2; ++i) {
-   if (n1 > 0) dest[j + (w2 - i) * dimx] = mean1;
-   DDouble v = tmp[2 * w2 - i + j * dimy];
-   if (isfinite(v)) {
-    mean1 *= n1;
-    mean1 -= v;
-    n1 -= 1.0;
-    mean1 /= n1;
-   }
-
-   if (n1 <= 0) mean1 = 0;
-
-#if defined (EDGE_WRAP)  
-   v = tmp[dimy - i - 1 + j * dimy];
-   if (isfinite(v)) {
-#elif defined (EDGE_TRUNCATE)  
-   v = tmp[0 + j * dimy];
-   if (isfinite(v)) {
-#elif defined (EDGE_MIRROR)  
-   v = tmp[i + j * dimy];
-   if (isfinite(v)) {
-#elif defined (EDGE_ZERO)
-   v = 0;
-   {
-#endif
-    mean1 *= n1;
-    if (n1 < 2 * w2 + 1) n1 += 1.0;
-    mean1 += v;
-    mean1 /= n1;
-   }
-  }
-  if (n1 > 0) dest[j + 0 * dimx] = mean1;
-#else //just transpose
-  for (SizeT i = 0; i < w2; ++i) dest[j + i * dimx] = tmp[i + j * dimy];
+#define SMOOTH_1D_ROW Smooth1DNan
 #endif
 
-  //middle: use mean & n
-  for (SizeT i = w2; i < dimy - w2 - 1;) {
-   dest[j + i * dimx] = (n > 0) ? mean : tmp[i + j * dimy];
-   DDouble v = tmp[i - w2 + j * dimy];
-   if (isfinite(v)) {
-    mean *= n;
-    mean -= v;
-    n -= 1.0;
-    mean /= n;
-   }
-   if (n <= 0) mean = 0;
-
-   v = tmp[(i++) + w2 + 1 + j * dimy];
-   if (isfinite(v)) {
-    mean *= n;
-    if (n < 2 * w2 + 1) n += 1.0;
-    mean += v;
-    mean /= n;
-   }
-  }
-  dest[j + (dimy - w2 - 1) * dimx] = (n > 0) ? mean : tmp[dimy - w2 - 1 + j * dimy];
-
-#if defined(USE_EDGE)  
-  //end: use mean2 & n as we go in the same direction...
-  DDouble mean2 = mean;
-
-  for (SizeT i = dimy - 1 - w2; i < dimy - 1; ++i) {
-   if (n > 0) dest[j + i * dimx] = mean2;
-   DDouble v = tmp[i - w2 + j * dimy];
-   if (isfinite(v)) {
-    mean2 *= n;
-    mean2 -= v;
-    n -= 1.0;
-    mean2 /= n;
-   }
-
-   if (n <= 0) mean2 = 0;
-
-#if defined (EDGE_WRAP)  
-   v = tmp[i - dimy + w2 + 1 + j * dimy];
-   if (isfinite(v)) {
-#elif defined (EDGE_TRUNCATE)  
-   v = tmp[dimy - 1 + j * dimy];
-   if (isfinite(v)) {
-#elif defined (EDGE_MIRROR)  
-   v = tmp[2 * dimy - i - w2 - 2 + j * dimy];
-   if (isfinite(v)) {
-#elif defined (EDGE_ZERO)
-   v = 0;
-   {
-#endif
-    mean2 *= n;
-    if (n < 2 * w2 + 1) n += 1.0;
-    mean2 += v;
-    mean2 /= n;
+// Each pass smoothes the rows along the first dimension and writes them transposed, (d0,d1,...) -> (d1,...,d0),
+// so that after sRank passes all dimensions are done and in their original order. Threads take blocks of
+// SMOOTH_BLOCK rows, smoothed in a private buffer that is then written out SMOOTH_BLOCK elements at a time.
+SizeT nEl = 1;
+SizeT curDim[MAXRANK];
+for (int r = 0; r < sRank; ++r) {
+ curDim[r] = sDim[r];
+ nEl *= sDim[r];
+}
+SMOOTH_Ty* tmp = (SMOOTH_Ty*) malloc(nEl * sizeof (SMOOTH_Ty));
+const SMOOTH_Ty* in = src;
+for (int p = 0; p < sRank; ++p) {
+ SMOOTH_Ty* out = ((sRank - 1 - p) % 2 == 0) ? dest : tmp; // the last pass writes to dest
+ const SizeT dimx = curDim[0];
+ const SizeT dimy = nEl / dimx;
+ const SizeT w = width[p] / 2;
+ const OMPInt nBlocks = (dimy + SMOOTH_BLOCK - 1) / SMOOTH_BLOCK;
+#pragma omp parallel if (nEl >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= nEl))
+ {
+  SMOOTH_Ty* buf = (SMOOTH_Ty*) malloc(SMOOTH_BLOCK * dimx * sizeof (SMOOTH_Ty));
+#pragma omp for
+  for (OMPInt b = 0; b < nBlocks; ++b) {
+   const SizeT j0 = b * SMOOTH_BLOCK;
+   const SizeT nj = (dimy - j0 < SMOOTH_BLOCK) ? dimy - j0 : SMOOTH_BLOCK;
+   // values where no mean is written (edges without edge mode, only NaNs around) stay as they are
+   memcpy(buf, in + j0 * dimx, nj * dimx * sizeof (SMOOTH_Ty));
+   if (w > 0) for (SizeT k = 0; k < nj; ++k) SMOOTH_1D_ROW(in + (j0 + k) * dimx, buf + k * dimx, dimx, w);
+   for (SizeT i = 0; i < dimx; ++i) {
+    SMOOTH_Ty* o = out + j0 + i * dimy;
+    for (SizeT k = 0; k < nj; ++k) o[k] = buf[k * dimx + i];
    }
   }
-  if (n > 0) dest[j + (dimy - 1) * dimx] = mean2;
-#else
-  for (SizeT i = dimy - w2; i < dimy; ++i) dest[j + i * dimx] = tmp[i + j * dimy];
-#endif
+  free(buf);
  }
+ // rotate the dimensions
+ for (int r = 0; r < sRank - 1; ++r) curDim[r] = curDim[r + 1];
+ curDim[sRank - 1] = dimx;
+ in = out;
 }
 free(tmp);
 
+#undef SMOOTH_1D_ROW
 #endif
@@ -59,27 +59,27 @@ void SmoothPolyDMirrorNan(SMOOTH_Ty* srcIn, SMOOTH_Ty* destIn, const SizeT* data
 
 
 #define INCLUDE_SMOOTH_1D
-void Smooth1D(SMOOTH_Ty* data, SMOOTH_Ty* res, SizeT dimx, SizeT w) {
+void Smooth1D(const SMOOTH_Ty* data, SMOOTH_Ty* res, SizeT dimx, SizeT w) {
 #include "smooth1d.hpp"
 }
 //subset having edges
 #define USE_EDGE
-void Smooth1DWrap(SMOOTH_Ty* data, SMOOTH_Ty* res, SizeT dimx, SizeT w) {
+void Smooth1DWrap(const SMOOTH_Ty* data, SMOOTH_Ty* res, SizeT dimx, SizeT w) {
 #define EDGE_WRAP
 #include "smooth1d.hpp"
 #undef EDGE_WRAP
 }
-void Smooth1DTruncate(SMOOTH_Ty* data, SMOOTH_Ty* res, SizeT dimx, SizeT w) {
+void Smooth1DTruncate(const SMOOTH_Ty* data, SMOOTH_Ty* res, SizeT dimx, SizeT w) {
 #define EDGE_TRUNCATE
 #include "smooth1d.hpp"
 #undef EDGE_TRUNCATE
 }
-void Smooth1DMirror(SMOOTH_Ty* data, SMOOTH_Ty* res, SizeT dimx, SizeT w) {
+void Smooth1DMirror(const SMOOTH_Ty* data, SMOOTH_Ty* res, SizeT dimx, SizeT w) {
 #define EDGE_MIRROR
 #include "smooth1d.hpp"
 #undef EDGE_MIRROR
 }
-void Smooth1DZero(SMOOTH_Ty* data, SMOOTH_Ty* res, SizeT dimx, SizeT w) {
+void Smooth1DZero(const SMOOTH_Ty* data, SMOOTH_Ty* res, SizeT dimx, SizeT w) {
 #define EDGE_ZERO
 #include "smooth1d.hpp"
 #undef EDGE_ZERO
@@ -89,27 +89,27 @@ void Smooth1DZero(SMOOTH_Ty* data, SMOOTH_Ty* res, SizeT dimx, SizeT w) {
 
 //smooth 1d functions for Nans.
 #define INCLUDE_SMOOTH_1D_NAN
-void Smooth1DNan(SMOOTH_Ty* data, SMOOTH_Ty* res, SizeT dimx, SizeT w) {
+void Smooth1DNan(const SMOOTH_Ty* data, SMOOTH_Ty* res, SizeT dimx, SizeT w) {
 #include "smooth1dnans.hpp"
 }
 //subset having edges
 #define USE_EDGE
-void Smooth1DWrapNan(SMOOTH_Ty* data, SMOOTH_Ty* res, SizeT dimx, SizeT w) {
+void Smooth1DWrapNan(const SMOOTH_Ty* data, SMOOTH_Ty* res, SizeT dimx, SizeT w) {
 #define EDGE_WRAP
 #include "smooth1dnans.hpp"
 #undef EDGE_WRAP
 }
-void Smooth1DTruncateNan(SMOOTH_Ty* data, SMOOTH_Ty* res, SizeT dimx, SizeT w) {
+void Smooth1DTruncateNan(const SMOOTH_Ty* data, SMOOTH_Ty* res, SizeT dimx, SizeT w) {
 #define EDGE_TRUNCATE
 #include "smooth1dnans.hpp"
 #undef EDGE_TRUNCATE
 }
-void Smooth1DMirrorNan(SMOOTH_Ty* data, SMOOTH_Ty* res, SizeT dimx, SizeT w) {
+void Smooth1DMirrorNan(const SMOOTH_Ty* data, SMOOTH_Ty* res, SizeT dimx, SizeT w) {
 #define EDGE_MIRROR
 #include "smooth1dnans.hpp"
 #undef EDGE_MIRROR
 }
-void Smooth1DZeroNan(SMOOTH_Ty* data, SMOOTH_Ty* res, SizeT dimx, SizeT w) {
+void Smooth1DZeroNan(const SMOOTH_Ty* data, SMOOTH_Ty* res, SizeT dimx, SizeT w) {
 #define EDGE_ZERO
 #include "smooth1dnans.hpp"
 #undef EDGE_ZERO
@@ -117,29 +117,67 @@ void Smooth1DZeroNan(SMOOTH_Ty* data, SMOOTH_Ty* res, SizeT dimx, SizeT w) {
 #undef USE_EDGE
 #undef INCLUDE_SMOOTH_1D_NAN
 
-//smooth 2d functions.
+//smooth 2d and 3d functions.
 #define INCLUDE_SMOOTH_2D
 void Smooth2D(const SMOOTH_Ty* src, SMOOTH_Ty* dest, const SizeT dimx, const SizeT dimy, const DLong* width) {
+  const SizeT sDim[2] = {dimx, dimy};
+  const int sRank = 2;
+#include "smooth2d.hpp"
+}
+void Smooth3D(const SMOOTH_Ty* src, SMOOTH_Ty* dest, const SizeT* sDim, const DLong* width) {
+  const int sRank = 3;
 #include "smooth2d.hpp"
 }
 //subset having edges
 #define USE_EDGE
 void Smooth2DWrap(const SMOOTH_Ty* src, SMOOTH_Ty* dest, const SizeT dimx, const SizeT dimy, const DLong* width) {
+  const SizeT sDim[2] = {dimx, dimy};
+  const int sRank = 2;
+#define EDGE_WRAP
+#include "smooth2d.hpp"
+#undef EDGE_WRAP
+}
+void Smooth3DWrap(const SMOOTH_Ty* src, SMOOTH_Ty* dest, const SizeT* sDim, const DLong* width) {
+  const int sRank = 3;
 #define EDGE_WRAP
 #include "smooth2d.hpp"
 #undef EDGE_WRAP
 }
 void Smooth2DTruncate(const SMOOTH_Ty* src, SMOOTH_Ty* dest, const SizeT dimx, const SizeT dimy, const DLong* width) {
+  const SizeT sDim[2] = {dimx, dimy};
+  const int sRank = 2;
+#define EDGE_TRUNCATE
+#include "smooth2d.hpp"
+#undef EDGE_TRUNCATE
+}
+void Smooth3DTruncate(const SMOOTH_Ty* src, SMOOTH_Ty* dest, const SizeT* sDim, const DLong* width) {
+  const int sRank = 3;
 #define EDGE_TRUNCATE
 #include "smooth2d.hpp"
 #undef EDGE_TRUNCATE
 }
 void Smooth2DMirror(const SMOOTH_Ty* src, SMOOTH_Ty* dest, const SizeT dimx, const SizeT dimy, const DLong* width) {
+  const SizeT sDim[2] = {dimx, dimy};
+  const int sRank = 2;
+#define EDGE_MIRROR
+#include "smooth2d.hpp"
+#undef EDGE_MIRROR
+}
+void Smooth3DMirror(const SMOOTH_Ty* src, SMOOTH_Ty* dest, const SizeT* sDim, const DLong* width) {
+  const int sRank = 3;
 #define EDGE_MIRROR
 #include "smooth2d.hpp"
 #undef EDGE_MIRROR
 }
 void Smooth2DZero(const SMOOTH_Ty* src, SMOOTH_Ty* dest, const SizeT dimx, const SizeT dimy, const DLong* width) {
+  const SizeT sDim[2] = {dimx, dimy};
+  const int sRank = 2;
+#define EDGE_ZERO
+#include "smooth2d.hpp"
+#undef EDGE_ZERO
+}
+void Smooth3DZero(const SMOOTH_Ty* src, SMOOTH_Ty* dest, const SizeT* sDim, const DLong* width) {
+  const int sRank = 3;
 #define EDGE_ZERO
 #include "smooth2d.hpp"
 #undef EDGE_ZERO
@@ -147,29 +185,67 @@ void Smooth2DZero(const SMOOTH_Ty* src, SMOOTH_Ty* dest, const SizeT dimx, const
 #undef USE_EDGE
 #undef INCLUDE_SMOOTH_2D
 
-//smooth 2d functions for Nans.
+//smooth 2d and 3d functions for Nans.
 #define INCLUDE_SMOOTH_2D_NAN
 void Smooth2DNan(const SMOOTH_Ty* src, SMOOTH_Ty* dest, const SizeT dimx, const SizeT dimy, const DLong* width) {
+  const SizeT sDim[2] = {dimx, dimy};
+  const int sRank = 2;
+#include "smooth2dnans.hpp"
+}
+void Smooth3DNan(const SMOOTH_Ty* src, SMOOTH_Ty* dest, const SizeT* sDim, const DLong* width) {
+  const int sRank = 3;
 #include "smooth2dnans.hpp"
 }
 //subset having edges
 #define USE_EDGE
 void Smooth2DWrapNan(const SMOOTH_Ty* src, SMOOTH_Ty* dest, const SizeT dimx, const SizeT dimy, const DLong* width) {
+  const SizeT sDim[2] = {dimx, dimy};
+  const int sRank = 2;
+#define EDGE_WRAP
+#include "smooth2dnans.hpp"
+#undef EDGE_WRAP
+}
+void Smooth3DWrapNan(const SMOOTH_Ty* src, SMOOTH_Ty* dest, const SizeT* sDim, const DLong* width) {
+  const int sRank = 3;
 #define EDGE_WRAP
 #include "smooth2dnans.hpp"
 #undef EDGE_WRAP
 }
 void Smooth2DTruncateNan(const SMOOTH_Ty* src, SMOOTH_Ty* dest, const SizeT dimx, const SizeT dimy, const DLong* width) {
+  const SizeT sDim[2] = {dimx, dimy};
+  const int sRank = 2;
+#define EDGE_TRUNCATE
+#include "smooth2dnans.hpp"
+#undef EDGE_TRUNCATE
+}
+void Smooth3DTruncateNan(const SMOOTH_Ty* src, SMOOTH_Ty* dest, const SizeT* sDim, const DLong* width) {
+  const int sRank = 3;
 #define EDGE_TRUNCATE
 #include "smooth2dnans.hpp"
 #undef EDGE_TRUNCATE
 }
 void Smooth2DMirrorNan(const SMOOTH_Ty* src, SMOOTH_Ty* dest, const SizeT dimx, const SizeT dimy, const DLong* width) {
+  const SizeT sDim[2] = {dimx, dimy};
+  const int sRank = 2;
+#define EDGE_MIRROR
+#include "smooth2dnans.hpp"
+#undef EDGE_MIRROR
+}
+void Smooth3DMirrorNan(const SMOOTH_Ty* src, SMOOTH_Ty* dest, const SizeT* sDim, const DLong* width) {
+  const int sRank = 3;
 #define EDGE_MIRROR
 #include "smooth2dnans.hpp"
 #undef EDGE_MIRROR
 }
 void Smooth2DZeroNan(const SMOOTH_Ty* src, SMOOTH_Ty* dest, const SizeT dimx, const SizeT dimy, const DLong* width) {
+  const SizeT sDim[2] = {dimx, dimy};
+  const int sRank = 2;
+#define EDGE_ZERO
+#include "smooth2dnans.hpp"
+#undef EDGE_ZERO
+}
+void Smooth3DZeroNan(const SMOOTH_Ty* src, SMOOTH_Ty* dest, const SizeT* sDim, const DLong* width) {
+  const int sRank = 3;
 #define EDGE_ZERO
 #include "smooth2dnans.hpp"
 #undef EDGE_ZERO
@@ -235,6 +311,19 @@ BaseGDL* Data_<SMOOTH_SP>::Smooth(DLong* width, int edgeMode,
       } else if (edgeMode==4) {
         Smooth2DMirrorNan((SMOOTH_Ty*)data->DataAddr(), (SMOOTH_Ty*)res->DataAddr(), dimx, dimy,  width);
       }
+    } else if (srcRank==3) {
+      SizeT srcDim[3] = {data->Dim(0), data->Dim(1), data->Dim(2)};
+      if (edgeMode==0){
+        Smooth3DNan((SMOOTH_Ty*)data->DataAddr(), (SMOOTH_Ty*)res->DataAddr(), srcDim,  width);
+      } else if (edgeMode==1) {
+        Smooth3DWrapNan((SMOOTH_Ty*)data->DataAddr(), (SMOOTH_Ty*)res->DataAddr(), srcDim,  width);
+      } else if (edgeMode==2) {
+        Smooth3DTruncateNan((SMOOTH_Ty*)data->DataAddr(), (SMOOTH_Ty*)res->DataAddr(), srcDim,  width);
+      } else if (edgeMode==3) {
+        Smooth3DZeroNan((SMOOTH_Ty*)data->DataAddr(), (SMOOTH_Ty*)res->DataAddr(), srcDim,  width);
+      } else if (edgeMode==4) {
+        Smooth3DMirrorNan((SMOOTH_Ty*)data->DataAddr(), (SMOOTH_Ty*)res->DataAddr(), srcDim,  width);
+      }
     } else {
       long rank = data->Rank();
       SizeT srcDim[MAXRANK];
@@ -288,6 +377,19 @@ BaseGDL* Data_<SMOOTH_SP>::Smooth(DLong* width, int edgeMode,
       } else if (edgeMode==4) {
         Smooth2DMirror((SMOOTH_Ty*)data->DataAddr(), (SMOOTH_Ty*)res->DataAddr(), dimx, dimy,  width);
       }
+    } else if (srcRank==3) {
+      SizeT srcDim[3] = {data->Dim(0), data->Dim(1), data->Dim(2)};
+      if (edgeMode==0){
+        Smooth3D((SMOOTH_Ty*)data->DataAddr(), (SMOOTH_Ty*)res->DataAddr(), srcDim,  width);
+      } else if (edgeMode==1) {
+        Smooth3DWrap((SMOOTH_Ty*)data->DataAddr(), (SMOOTH_Ty*)res->DataAddr(), srcDim,  width);
+      } else if (edgeMode==2) {
+        Smooth3DTruncate((SMOOTH_Ty*)data->DataAddr(), (SMOOTH_Ty*)res->DataAddr(), srcDim,  width);
+      } else if (edgeMode==3) {
+        Smooth3DZero((SMOOTH_Ty*)data->DataAddr(), (SMOOTH_Ty*)res->DataAddr(), srcDim,  width);
+      } else if (edgeMode==4) {
+        Smooth3DMirror((SMOOTH_Ty*)data->DataAddr(), (SMOOTH_Ty*)res->DataAddr(), srcDim,  width);
+      }
     } else  {
       long rank = data->Rank();
       SizeT srcDim[MAXRANK];
@@ -21,6 +21,9 @@
 #include "envt.hpp"
 #include "dinterpreter.hpp"
 
+#include <unordered_map>
+#include <limits>
+
 namespace lib {
 #define INSERTION_SORT_THRESHOLD 256  //after, merge is better (floats)
 #define QUICK_SORT_THRESHOLD 0 //never better
@@ -1637,7 +1640,130 @@ template <typename T, typename IndexT>
     for (SizeT i = 0; i < high - low + 1; ++i) aux[i] = i;
     AdaptiveSortIndexAuxWithNaN(aux, index, low, high, val);
     delete[] aux;
-  } 
+  }
+//------------------String Sorting ----------------------------------------------------------------------------------
+// Strings are sorted with a MSD multikey radix scheme: each string is represented by a cached 64 bit key made of its
+// next STRING_SORT_KEY_BYTES bytes (big-endian, so that the integer order is the byte order of std::string::compare)
+// with, in the low byte, the number of bytes actually present (so that "ab" sorts before "ab\0").
+// All the keys are radix-sorted (stable) at once, then only the runs of equal keys whose strings are not exhausted
+// are refined with the next bytes. The strings themselves are thus never compared, and their common prefixes are
+// read only once. Runs are independent and are refined in parallel. The result is stable.
+#define STRING_SORT_KEY_BYTES 7
+#define STRING_SORT_RADIX_THRESHOLD 4096 //runs shorter than this are sorted on (key,index) pairs by std::sort
+
+  inline DULong64 StringSortKey(const DString& s, SizeT depth)
+  {
+    SizeT len = s.length();
+    SizeT n = (len > depth) ? std::min<SizeT>(len - depth, STRING_SORT_KEY_BYTES) : 0;
+    DULong64 key = n;
+    if (n > 0) {
+      const DByte* c = reinterpret_cast<const DByte*> (s.data()) + depth;
+      for (SizeT i = 0; i < n; ++i) key |= static_cast<DULong64> (c[i]) << (8 * (STRING_SORT_KEY_BYTES - i));
+    }
+    return key;
+  }
+
+  // stable sort of index[lo..hi-1] (and key[lo..hi-1] alongside) on key.
+  template<typename IndexT>
+  static void StringSortKeys(IndexT* index, DULong64* key, SizeT lo, SizeT hi)
+  {
+    SizeT n = hi - lo;
+    if (n < 2) return;
+    if (n < STRING_SORT_RADIX_THRESHOLD) {
+      // elements of a run are always in increasing index order, sorting on the pair keeps the sort stable.
+      std::vector<std::pair<DULong64, IndexT> > pairs(n);
+      for (SizeT i = 0; i < n; ++i) pairs[i] = std::make_pair(key[lo + i], index[lo + i]);
+      std::sort(pairs.begin(), pairs.end());
+      for (SizeT i = 0; i < n; ++i) {
+        key[lo + i] = pairs[i].first;
+        index[lo + i] = pairs[i].second;
+      }
+      return;
+    }
+    IndexT* ranks = RadixSort<IndexT>(&(key[lo]), n);
+    IndexT* sortedIndex = new IndexT[n];
+    DULong64* sortedKey = new DULong64[n];
+    for (SizeT i = 0; i < n; ++i) {
+      sortedIndex[i] = index[lo + ranks[i]];
+      sortedKey[i] = key[lo + ranks[i]];
+    }
+    memcpy(&(index[lo]), sortedIndex, n * sizeof (IndexT));
+    memcpy(&(key[lo]), sortedKey, n * sizeof (DULong64));
+    delete[] sortedKey;
+    delete[] sortedIndex;
+    gdlAlignedFree(ranks);
+  }
+
+  template<typename IndexT>
+  static void StringSortRefine(const DString* val, IndexT* index, DULong64* key, SizeT lo, SizeT hi, SizeT depth);
+
+  // index[lo..hi-1] share the same key at 'depth' and their strings continue: order them on the following bytes.
+  template<typename IndexT>
+  static void StringSortRefineRun(const DString* val, IndexT* index, DULong64* key, SizeT lo, SizeT hi, SizeT depth)
+  {
+    for (;;) {
+      depth += STRING_SORT_KEY_BYTES;
+      bool allEqual = true;
+      key[lo] = StringSortKey(val[index[lo]], depth);
+      for (SizeT k = lo + 1; k < hi; ++k) {
+        key[k] = StringSortKey(val[index[k]], depth);
+        if (key[k] != key[lo]) allEqual = false;
+      }
+      if (!allEqual) break;
+      // a common prefix longer than the key: go on without sorting, or stop if the strings are all identical.
+      if ((key[lo] & 0xFF) != STRING_SORT_KEY_BYTES) return;
+    }
+    StringSortKeys(index, key, lo, hi);
+    StringSortRefine(val, index, key, lo, hi, depth);
+  }
+
+  template<typename IndexT>
+  static void StringSortRefine(const DString* val, IndexT* index, DULong64* key, SizeT lo, SizeT hi, SizeT depth)
+  {
+    SizeT i = lo;
+    while (i < hi) {
+      SizeT j = i + 1;
+      while (j < hi && key[j] == key[i]) ++j;
+      if (j - i > 1 && (key[i] & 0xFF) == STRING_SORT_KEY_BYTES) StringSortRefineRun(val, index, key, i, j, depth);
+      i = j;
+    }
+  }
+
+  // returns a gdlAlignedMalloc'ed array of the sorted indexes of val[0..nEl-1].
+  template<typename IndexT>
+  static IndexT* StringSortIndex(const DString* val, SizeT nEl)
+  {
+    DULong64* key = (DULong64*) gdlAlignedMalloc(nEl * sizeof (DULong64));
+#pragma omp parallel for if (nEl >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= nEl))
+    for (OMPInt i = 0; i < nEl; ++i) key[i] = StringSortKey(val[i], 0);
+
+    IndexT* index = RadixSort<IndexT>(key, nEl);
+
+    DULong64* sortedKey = (DULong64*) gdlAlignedMalloc(nEl * sizeof (DULong64));
+#pragma omp parallel for if (nEl >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= nEl))
+    for (OMPInt i = 0; i < nEl; ++i) sortedKey[i] = key[index[i]];
+    gdlAlignedFree(key);
+
+    // list the runs to be refined, then refine them in parallel (they do not overlap).
+    std::vector<SizeT> runStart;
+    std::vector<SizeT> runEnd;
+    SizeT i = 0;
+    while (i < nEl) {
+      SizeT j = i + 1;
+      while (j < nEl && sortedKey[j] == sortedKey[i]) ++j;
+      if (j - i > 1 && (sortedKey[i] & 0xFF) == STRING_SORT_KEY_BYTES) {
+        runStart.push_back(i);
+        runEnd.push_back(j);
+      }
+      i = j;
+    }
+    OMPInt nRuns = runStart.size();
+#pragma omp parallel for schedule(dynamic) if (nRuns > 1 && nEl >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= nEl))
+    for (OMPInt r = 0; r < nRuns; ++r) StringSortRefineRun(val, index, sortedKey, runStart[r], runEnd[r], 0);
+
+    gdlAlignedFree(sortedKey);
+    return index;
+  }
 //--------------------------------------------------------------------------------------------------------------------
 // Sorting algos: The "private" GDL_SORT enables keywords QUICK,MERGE,RADIX,INSERT. Those are not there to for the user
 // to choose the algo (s)he wants. They are primarily to test the relative speed of each of them and find, for a given machine,
@@ -1724,7 +1850,10 @@ template <typename T, typename IndexT>
         for (SizeT i = 0; i < nEl; ++i) magnitude[i] = std::norm(ff[i]);
         index = (DLong*) RadixSort<DULong>(magnitude, nEl);
         delete[] magnitude;
-      }
+      } else if (p0->Type() == GDL_STRING) {
+        DString* val = (DString*) (static_cast<DStringGDL*> (p0)->DataAddr());
+        index = StringSortIndex<DLong>(val, nEl);
+      } else e->Throw("FIXME.");
       res->SetBuffer(index);
       res->SetBufferSize(nEl);
       res->SetDim(dimension(nEl));
@@ -1918,6 +2047,27 @@ template <typename T, typename IndexT>
         }
         delete[] magnitude;
         return res;
+      } else if (p0->Type() == GDL_STRING) {
+        DString* val = (DString*) (static_cast<DStringGDL*> (p0)->DataAddr());
+        if (!(merge || quick || insert)) {
+          DLongGDL* res = new DLongGDL(dimension(nEl), BaseGDL::NOALLOC);
+          res->SetBuffer(StringSortIndex<DLong>(val, nEl));
+          res->SetBufferSize(nEl);
+          res->SetDim(dimension(nEl));
+          return res;
+        }
+        DLongGDL* res = new DLongGDL(dimension(nEl), BaseGDL::INDGEN);
+        DLong *hh = static_cast<DLong*> (res->DataAddr());
+        SizeT low = 0;
+        SizeT high = nEl - 1;
+        if (merge) {
+          MergeSortIndex(val, hh, low, high);
+        } else if (quick) {
+          QuickSortIndex(val, hh, low, high);
+        } else {
+          insertionSortIndex(val, hh, low, high);
+        }
+        return res;
       } else e->Throw("FIXME.");
     }
    return NULL;
@@ -2064,13 +2214,14 @@ template <typename T, typename IndexT>
       res->SetBufferSize(nEl);
       res->SetDim(dimension(nEl));
       return res;
-    } else if (p0->Type() == GDL_STRING) {
+    } else if (p0->Type() == GDL_STRING) { //multikey radix on cached prefixes, see StringSortIndex
       DString* val = (DString*)(static_cast<DStringGDL*>(p0)->DataAddr());
-      GDLIndexT* res = new GDLIndexT(dimension(nEl), BaseGDL::INDGEN);
-      IndexT *hh = static_cast<IndexT*> (res->DataAddr());
-      SizeT low=0; 
-      SizeT high=nEl-1; 
-      QuickSortIndex<DString, IndexT>( val, hh, low, high);
+      GDLIndexT* res = new GDLIndexT(dimension(nEl), BaseGDL::NOALLOC);
+      IndexT *index;
+      index=StringSortIndex<IndexT>( val, nEl);
+      res->SetBuffer(index);
+      res->SetBufferSize(nEl);
+      res->SetDim(dimension(nEl));
       return res;
     } else if (p0->Type() == GDL_PTR) {
         // actually it sorts the index in heap.
@@ -2101,5 +2252,418 @@ template <typename T, typename IndexT>
     bool l64 = e->KeywordSet(l64Ix);
     if (!l64) return do_sort_fun<DLongGDL,DLong>(p0);
     else return do_sort_fun<DLong64GDL,DLong64>(p0);
-  }  
+  }
+
+//------------------ UNIQ -------------------------------------------------------------------------------------------
+// UNIQ(Array [,Index]) returns the subscripts of the elements of Array (or of Array[Index]) that differ from their
+// successor, the last one being compared to the first, exactly as the former uniq.pro did with WHERE and SHIFT.
+// This is done in one parallel pass, without the shifted copies and, when Index is given, without gathering
+// Array[Index] first.
+// GDL extension: UNIQ(Array, /UNSORTED) returns what UNIQ(Array, SORT(Array)) would, but without sorting Array: the
+// elements are hashed and only the distinct values are sorted, which is much faster when Array has many duplicates.
+
+  // number of chunks used for the parallel passes over n elements
+  inline int UniqChunks(SizeT n)
+  {
+    if (CpuTPOOL_NTHREADS > 1 && n >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= n)) return CpuTPOOL_NTHREADS;
+    return 1;
+  }
+
+  // the scan: positions i of the (optionally indexed) values that are not equal to the following one.
+  template<typename T, typename IndexT>
+  static SizeT UniqScan(const T* val, const DLong64* ix, SizeT n, IndexT* &pos)
+  {
+    int nChunks = UniqChunks(n);
+    SizeT chunksize = n / nChunks;
+    std::vector<SizeT> count(nChunks + 1, 0);
+    // first pass counts, second pass writes at the offsets found
+    for (int pass = 0; pass < 2; ++pass) {
+#pragma omp parallel for num_threads(nChunks) if (nChunks > 1)
+      for (int c = 0; c < nChunks; ++c) {
+        SizeT start = c * chunksize;
+        SizeT stop = (c == nChunks - 1) ? n : start + chunksize;
+        SizeT k = (pass == 0) ? 0 : count[c];
+        for (SizeT i = start; i < stop; ++i) {
+          SizeT next = (i + 1 == n) ? 0 : i + 1;
+          bool differ = (ix == NULL) ? (val[i] != val[next]) : (val[ix[i]] != val[ix[next]]);
+          if (differ) {
+            if (pass == 1) pos[k] = i;
+            ++k;
+          }
+        }
+        if (pass == 0) count[c + 1] = k;
+      }
+      if (pass == 0) {
+        for (int c = 0; c < nChunks; ++c) count[c + 1] += count[c];
+        if (count[nChunks] == 0) return 0;
+        pos = (IndexT*) gdlAlignedMalloc(count[nChunks] * sizeof (IndexT));
+      }
+    }
+    return count[nChunks];
+  }
+
+  template<typename T>
+  inline bool UniqIsNaN(const T& v) { return false; }
+  template<>
+  inline bool UniqIsNaN(const DFloat& v) { return std::isnan(v); }
+  template<>
+  inline bool UniqIsNaN(const DDouble& v) { return std::isnan(v); }
+
+  // hashing and equality of the elements designated by their subscript
+  template<typename T>
+  struct UniqHash {
+    const T* val;
+    UniqHash(const T* v) : val(v) {}
+    std::size_t operator()(SizeT i) const { return std::hash<T>()(val[i]); }
+  };
+  template<typename T>
+  struct UniqEqual {
+    const T* val;
+    UniqEqual(const T* v) : val(v) {}
+    bool operator()(SizeT i, SizeT j) const { return val[i] == val[j]; }
+  };
+  // the order of SORT: NaNs last, in input order
+  template<typename T>
+  struct UniqLess {
+    const T* val;
+    UniqLess(const T* v) : val(v) {}
+    bool operator()(SizeT i, SizeT j) const {
+      bool ni = UniqIsNaN(val[i]);
+      bool nj = UniqIsNaN(val[j]);
+      if (ni || nj) return (ni == nj) ? i < j : nj;
+      return val[i] < val[j];
+    }
+  };
+
+  // subscripts of the last occurrence of each distinct value, in increasing value order.
+  template<typename T>
+  static void UniqHashed(const T* val, SizeT n, std::vector<SizeT>& last)
+  {
+    typedef std::unordered_map<SizeT, SizeT, UniqHash<T>, UniqEqual<T> > UniqMapT;
+    int nChunks = UniqChunks(n);
+    SizeT chunksize = n / nChunks;
+    std::vector<UniqMapT*> maps(nChunks);
+#pragma omp parallel for num_threads(nChunks) if (nChunks > 1)
+    for (int c = 0; c < nChunks; ++c) {
+      SizeT start = c * chunksize;
+      SizeT stop = (c == nChunks - 1) ? n : start + chunksize;
+      UniqMapT* m = new UniqMapT(1024, UniqHash<T>(val), UniqEqual<T>(val));
+      // NaNs never compare equal: each is a distinct entry, as each is a distinct element in UNIQ(a,SORT(a)).
+      for (SizeT i = start; i < stop; ++i) {
+        std::pair<typename UniqMapT::iterator, bool> r = m->insert(std::make_pair(i, i));
+        if (!r.second) r.first->second = i;
+      }
+      maps[c] = m;
+    }
+    // chunks are in input order: the later chunk's last occurrence wins.
+    UniqMapT* all = maps[0];
+    for (int c = 1; c < nChunks; ++c) {
+      for (typename UniqMapT::iterator it = maps[c]->begin(); it != maps[c]->end(); ++it) {
+        std::pair<typename UniqMapT::iterator, bool> r = all->insert(*it);
+        if (!r.second) r.first->second = it->second;
+      }
+      delete maps[c];
+    }
+    last.reserve(all->size());
+    for (typename UniqMapT::iterator it = all->begin(); it != all->end(); ++it) last.push_back(it->second);
+    delete all;
+    std::sort(last.begin(), last.end(), UniqLess<T>(val));
+  }
+
+  template<typename T>
+  static BaseGDL* uniq_hashed(BaseGDL* p0)
+  {
+    const T* val = static_cast<const T*> (p0->DataAddr());
+    SizeT nEl = p0->N_Elements();
+    std::vector<SizeT> last;
+    UniqHashed(val, nEl, last);
+    SizeT nRes = last.size();
+    if (nRes == 1) return new DLongGDL(nEl - 1); //a single value, as with UNIQ(a,SORT(a))
+    if (nEl > std::numeric_limits<DLong>::max()) {
+      DLong64GDL* res = new DLong64GDL(dimension(nRes), BaseGDL::NOZERO);
+      for (SizeT i = 0; i < nRes; ++i) (*res)[i] = last[i];
+      return res;
+    }
+    DLongGDL* res = new DLongGDL(dimension(nRes), BaseGDL::NOZERO);
+    for (SizeT i = 0; i < nRes; ++i) (*res)[i] = last[i];
+    return res;
+  }
+
+  template<typename T, typename GDLIndexT, typename IndexT>
+  static BaseGDL* uniq_scan(BaseGDL* p0, DLong64GDL* ix)
+  {
+    const T* val = static_cast<const T*> (p0->DataAddr());
+    const DLong64* ixP = (ix == NULL) ? NULL : static_cast<const DLong64*> (ix->DataAddr());
+    SizeT n = (ix == NULL) ? p0->N_Elements() : ix->N_Elements();
+    IndexT* pos = NULL;
+    SizeT nRes = UniqScan(val, ixP, n, pos);
+    if (nRes == 0) return new DLongGDL(p0->N_Elements() - 1);
+    if (ixP != NULL) for (SizeT i = 0; i < nRes; ++i) pos[i] = ixP[pos[i]];
+    GDLIndexT* res = new GDLIndexT(dimension(nRes), BaseGDL::NOALLOC);
+    res->SetBuffer(pos);
+    res->SetBufferSize(nRes);
+    res->SetDim(dimension(nRes));
+    return res;
+  }
+
+  template<typename T>
+  static BaseGDL* uniq_scan(BaseGDL* p0, DLong64GDL* ix)
+  {
+    SizeT n = (ix == NULL) ? p0->N_Elements() : ix->N_Elements();
+    if (n > std::numeric_limits<DLong>::max()) return uniq_scan<T, DLong64GDL, DLong64>(p0, ix);
+    return uniq_scan<T, DLongGDL, DLong>(p0, ix);
+  }
+
+  BaseGDL* uniq_fun( EnvT* e)
+  {
+    SizeT nParam = e->NParam(1);
+    BaseGDL* p0 = e->GetParDefined(0);
+    if (p0->Type() == GDL_STRUCT) e->Throw("Struct expression not allowed in this context: " +e->GetParString(0));
+    SizeT nEl = p0->N_Elements();
+    if (nEl <= 1) return new DLongGDL(0);
+
+    static int unsortedIx = e->KeywordIx("UNSORTED");
+    bool unsorted = e->KeywordSet(unsortedIx);
+
+    DLong64GDL* ix = NULL;
+    if (nParam > 1) {
+      // subscripts out of range are clipped, as they would be in Array[Index]
+      DLong64GDL* index = e->GetParAs<DLong64GDL>(1);
+      SizeT n = index->N_Elements();
+      if (n <= 1) return new DLongGDL(nEl - 1);
+      ix = new DLong64GDL(dimension(n), BaseGDL::NOZERO);
+      e->DeleteAtExit(ix);
+#pragma omp parallel for if (n >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= n))
+      for (OMPInt i = 0; i < n; ++i) {
+        DLong64 k = (*index)[i];
+        (*ix)[i] = (k < 0) ? 0 : ((k >= nEl) ? nEl - 1 : k);
+      }
+      unsorted = false;
+    }
+
+    // complex values are sorted on their modulus, the hash cannot reproduce that order.
+    if (unsorted && (p0->Type() == GDL_COMPLEX || p0->Type() == GDL_COMPLEXDBL)) {
+      ix = static_cast<DLong64GDL*> (do_sort_fun<DLong64GDL, DLong64>(p0));
+      e->DeleteAtExit(ix);
+      unsorted = false;
+    }
+
+    if (unsorted) {
+      switch (p0->Type()) {
+      case GDL_BYTE: return uniq_hashed<DByte>(p0);
+      case GDL_INT: return uniq_hashed<DInt>(p0);
+      case GDL_UINT: return uniq_hashed<DUInt>(p0);
+      case GDL_LONG: return uniq_hashed<DLong>(p0);
+      case GDL_ULONG: return uniq_hashed<DULong>(p0);
+      case GDL_LONG64: return uniq_hashed<DLong64>(p0);
+      case GDL_ULONG64: return uniq_hashed<DULong64>(p0);
+      case GDL_FLOAT: return uniq_hashed<DFloat>(p0);
+      case GDL_DOUBLE: return uniq_hashed<DDouble>(p0);
+      case GDL_STRING: return uniq_hashed<DString>(p0);
+      case GDL_PTR: return uniq_hashed<DPtr>(p0);
+      case GDL_OBJ: return uniq_hashed<DObj>(p0);
+      default: break;
+      }
+    }
+    switch (p0->Type()) {
+    case GDL_BYTE: return uniq_scan<DByte>(p0, ix);
+    case GDL_INT: return uniq_scan<DInt>(p0, ix);
+    case GDL_UINT: return uniq_scan<DUInt>(p0, ix);
+    case GDL_LONG: return uniq_scan<DLong>(p0, ix);
+    case GDL_ULONG: return uniq_scan<DULong>(p0, ix);
+    case GDL_LONG64: return uniq_scan<DLong64>(p0, ix);
+    case GDL_ULONG64: return uniq_scan<DULong64>(p0, ix);
+    case GDL_FLOAT: return uniq_scan<DFloat>(p0, ix);
+    case GDL_DOUBLE: return uniq_scan<DDouble>(p0, ix);
+    case GDL_COMPLEX: return uniq_scan<DComplex>(p0, ix);
+    case GDL_COMPLEXDBL: return uniq_scan<DComplexDbl>(p0, ix);
+    case GDL_STRING: return uniq_scan<DString>(p0, ix);
+    case GDL_PTR: return uniq_scan<DPtr>(p0, ix);
+    case GDL_OBJ: return uniq_scan<DObj>(p0, ix);
+    default: break;
+    }
+    e->Throw("Unhandled type: " + p0->TypeStr());
+    return NULL;
+  }
+
+//------------------ VALUE_LOCATE -----------------------------------------------------------------------------------
+// VALUE_LOCATE(Vector, Value) returns for each Value the subscript j such that Vector[j] <= Value < Vector[j+1]
+// (Vector[j] >= Value > Vector[j+1] for a decreasing Vector), -1 below Vector[0] and N-1 beyond Vector[N-1].
+// Each value is located by a branchless binary search (the loop has a fixed trip count and the select compiles to a
+// conditional move), values being distributed over the threads. When the values are themselves sorted in the
+// direction of Vector, each thread instead walks Vector forward from its previous result by galloping, which costs
+// O(N+M) instead of O(M log N).
+
+  struct ValueLocateIncreasing {
+    template<typename T>
+    bool operator()(const T& a, const T& v) const { return a <= v; }
+  };
+  struct ValueLocateDecreasing {
+    template<typename T>
+    bool operator()(const T& a, const T& v) const { return a >= v; }
+  };
+
+  // last j such that before(x[j], v), -1 if none.
+  template<typename T, typename Before>
+  inline OMPInt ValueLocateOne(const T* x, SizeT n, const T& v, Before before)
+  {
+    const T* base = x;
+    SizeT len = n;
+    while (len > 1) {
+      SizeT half = len / 2;
+      base = before(base[half], v) ? base + half : base;
+      len -= half;
+    }
+    return before(*base, v) ? base - x : -1;
+  }
+
+  template<typename T, typename IndexT, typename Before>
+  static void ValueLocateAll(const T* x, SizeT n, const T* u, SizeT m, IndexT* res, Before before)
+  {
+    bool parallel = (m >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= m));
+
+    bool sorted = true;
+    if (m > 1) {
+#pragma omp parallel for reduction(&&:sorted) if (parallel)
+      for (OMPInt i = 0; i < m - 1; ++i) sorted = sorted && before(u[i], u[i + 1]);
+    }
+
+    if (!sorted) {
+#pragma omp parallel for if (parallel)
+      for (OMPInt i = 0; i < m; ++i) res[i] = ValueLocateOne(x, n, u[i], before);
+      return;
+    }
+
+    int nChunks = (parallel && CpuTPOOL_NTHREADS > 1) ? CpuTPOOL_NTHREADS : 1;
+    SizeT chunksize = m / nChunks;
+#pragma omp parallel for num_threads(nChunks) if (nChunks > 1)
+    for (int c = 0; c < nChunks; ++c) {
+      SizeT start = c * chunksize;
+      SizeT stop = (c == nChunks - 1) ? m : start + chunksize;
+      OMPInt j = ValueLocateOne(x, n, u[start], before);
+      res[start] = j;
+      for (SizeT i = start + 1; i < stop; ++i) {
+        const T& v = u[i];
+        SizeT lo = j + 1;
+        if (lo < n && before(x[lo], v)) {
+          SizeT step = 1;
+          while (lo + step < n && before(x[lo + step], v)) {
+            lo += step;
+            step <<= 1;
+          }
+          SizeT hi = std::min(lo + step, n);
+          j = lo + ValueLocateOne(x + lo, hi - lo, v, before);
+        }
+        res[i] = j;
+      }
+    }
+  }
+
+  template<typename GDLT, typename GDLIndexT>
+  static BaseGDL* value_locate_template(BaseGDL* xIn, BaseGDL* uIn)
+  {
+    typedef typename GDLT::Ty T;
+    const T* x = static_cast<const T*> (xIn->DataAddr());
+    const T* u = static_cast<const T*> (uIn->DataAddr());
+    SizeT n = xIn->N_Elements();
+    SizeT m = uIn->N_Elements();
+    GDLIndexT* res = new GDLIndexT(uIn->Dim(), BaseGDL::NOZERO);
+    typename GDLIndexT::Ty* r = static_cast<typename GDLIndexT::Ty*> (res->DataAddr());
+    // a single element Vector is taken as increasing
+    if (n > 1 && x[n - 1] < x[0]) ValueLocateAll(x, n, u, m, r, ValueLocateDecreasing());
+    else ValueLocateAll(x, n, u, m, r, ValueLocateIncreasing());
+    return res;
+  }
+
+  template<typename GDLT>
+  static bool ValueLocateMonotonic(BaseGDL* xIn)
+  {
+    typedef typename GDLT::Ty T;
+    const T* x = static_cast<const T*> (xIn->DataAddr());
+    SizeT n = xIn->N_Elements();
+    bool up = true;
+    bool down = true;
+    for (SizeT i = 1; i < n; ++i) {
+      if (x[i] < x[i - 1]) up = false;
+      if (x[i - 1] < x[i]) down = false;
+    }
+    return up || down;
+  }
+
+  template<typename GDLIndexT>
+  static BaseGDL* value_locate_dispatch(BaseGDL* x, BaseGDL* u)
+  {
+    switch (x->Type()) {
+    case GDL_BYTE: return value_locate_template<DByteGDL, GDLIndexT>(x, u);
+    case GDL_INT: return value_locate_template<DIntGDL, GDLIndexT>(x, u);
+    case GDL_UINT: return value_locate_template<DUIntGDL, GDLIndexT>(x, u);
+    case GDL_LONG: return value_locate_template<DLongGDL, GDLIndexT>(x, u);
+    case GDL_ULONG: return value_locate_template<DULongGDL, GDLIndexT>(x, u);
+    case GDL_LONG64: return value_locate_template<DLong64GDL, GDLIndexT>(x, u);
+    case GDL_ULONG64: return value_locate_template<DULong64GDL, GDLIndexT>(x, u);
+    case GDL_FLOAT: return value_locate_template<DFloatGDL, GDLIndexT>(x, u);
+    case GDL_DOUBLE: return value_locate_template<DDoubleGDL, GDLIndexT>(x, u);
+    default: return value_locate_template<DStringGDL, GDLIndexT>(x, u);
+    }
+  }
+
+  BaseGDL* value_locate_fun( EnvT* e)
+  {
+    e->NParam(2);
+    BaseGDL* x = e->GetParDefined(0);
+    BaseGDL* u = e->GetParDefined(1);
+
+    DType xt = x->Type();
+    if (ComplexType(xt)) e->Throw("Complex expression not allowed in this context: " + e->GetParString(0));
+    if (xt == GDL_STRUCT) e->Throw("Struct expression not allowed in this context: " + e->GetParString(0));
+    if (xt == GDL_PTR) e->Throw("Pointer expression not allowed in this context: " + e->GetParString(0));
+    if (xt == GDL_OBJ) e->Throw("Object reference not allowed in this context: " + e->GetParString(0));
+    DType ut = u->Type();
+    if (ut == GDL_STRUCT) e->Throw("Struct expression not allowed in this context: " + e->GetParString(1));
+    if (ut == GDL_PTR) e->Throw("Pointer expression not allowed in this context: " + e->GetParString(1));
+    if (ut == GDL_OBJ) e->Throw("Object reference not allowed in this context: " + e->GetParString(1));
+
+    static int l64Ix = e->KeywordIx("L64");
+    bool l64 = e->KeywordSet(l64Ix) || (x->N_Elements() > std::numeric_limits<DLong>::max());
+
+    // the type in which the comparisons are made: none of the inputs is converted in the common case of equal types
+    DType ct;
+    if (xt == GDL_STRING) ct = GDL_STRING;
+    else {
+      DType uu = (ut == GDL_COMPLEX) ? GDL_FLOAT : (ut == GDL_COMPLEXDBL || ut == GDL_STRING) ? GDL_DOUBLE : ut;
+      int ox = DTypeOrder[xt];
+      int ou = DTypeOrder[uu];
+      if (uu == xt) ct = xt;
+      else if (IntType(xt) && IntType(uu)) ct = GDL_LONG64;
+      else if (std::max(ox, ou) == 8 && std::min(ox, ou) <= 3) ct = GDL_FLOAT;
+      else ct = GDL_DOUBLE;
+    }
+    if (xt != ct) {
+      x = x->Convert2(ct, BaseGDL::COPY);
+      e->DeleteAtExit(x);
+    }
+    if (ut != ct) {
+      u = u->Convert2(ct, BaseGDL::COPY);
+      e->DeleteAtExit(u);
+    }
+
+    bool monotonic = true;
+    switch (ct) {
+    case GDL_BYTE: monotonic = ValueLocateMonotonic<DByteGDL>(x); break;
+    case GDL_INT: monotonic = ValueLocateMonotonic<DIntGDL>(x); break;
+    case GDL_UINT: monotonic = ValueLocateMonotonic<DUIntGDL>(x); break;
+    case GDL_LONG: monotonic = ValueLocateMonotonic<DLongGDL>(x); break;
+    case GDL_ULONG: monotonic = ValueLocateMonotonic<DULongGDL>(x); break;
+    case GDL_LONG64: monotonic = ValueLocateMonotonic<DLong64GDL>(x); break;
+    case GDL_ULONG64: monotonic = ValueLocateMonotonic<DULong64GDL>(x); break;
+    case GDL_FLOAT: monotonic = ValueLocateMonotonic<DFloatGDL>(x); break;
+    case GDL_DOUBLE: monotonic = ValueLocateMonotonic<DDoubleGDL>(x); break;
+    default: monotonic = ValueLocateMonotonic<DStringGDL>(x); break;
+    }
+    // GDL extension, as in the former value_locate.pro
+    if (!monotonic) Warning("VALUE_LOCATE: Warning : input array \"" + e->GetParString(0) + "\" is NOT monotonically increasing or decreasing");
+
+    if (l64) return value_locate_dispatch<DLong64GDL>(x, u);
+    return value_locate_dispatch<DLongGDL>(x, u);
+  }
 }
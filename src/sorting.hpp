@@ -21,5 +21,7 @@ namespace lib {
 
   BaseGDL* sort_fun( EnvT* e);
   BaseGDL* gdl_sort_fun( EnvT* e);
+  BaseGDL* uniq_fun( EnvT* e);
+  BaseGDL* value_locate_fun( EnvT* e);
 } 
 #endif
@@ -0,0 +1,694 @@
+/***************************************************************************
+                          sparse.cpp  -  sparse matrices (SPRSIN...)
+                             -------------------
+    begin                : Oct 2026
+    copyright            : (C) 2026 by the GDL team
+    email                :
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+// SPRSIN, FULSTR, SPRSAX, SPRSAB, SPRSTP and LINBCG.
+// At the GDL level a sparse matrix is the row-indexed structure of IDL
+// (Numerical Recipes' storage) {SA, IJA}, with 0-based indices:
+//   SA[0:n-1]   the diagonal, SA[n] unused,
+//   IJA[0:n]    IJA[i]:IJA[i+1]-1 are the positions in SA/IJA of the
+//               off-diagonal elements of row i (IJA[0]=n+1),
+//   IJA[k]      (k > n) the column of SA[k].
+// Each routine converts it once to a compressed sparse row store (CSR)
+// holding the diagonal with the other elements; products, transposition
+// and the solver's iterations work on it, the rows in parallel.
+// Element (row i, column j) is A[j,i] of the dense array, as for ##.
+
+#include "includefirst.hpp"
+
+#include <cmath>
+#include <vector>
+#include <algorithm>
+#include <limits>
+#include <utility>
+
+#include "datatypes.hpp"
+#include "envt.hpp"
+#include "dstructgdl.hpp"
+#include "objects.hpp"
+#include "sparse.hpp"
+
+namespace lib {
+
+  using namespace std;
+
+  namespace {
+
+    template<typename T>
+    struct SparseCSR
+    {
+      SizeT n;
+      vector<SizeT> rowStart; // n+1 entries, row r is [rowStart[r], rowStart[r+1])
+      vector<DLong> col;
+      vector<T> val;
+    };
+
+    template<typename T>
+    inline bool SparseKeep( T v, DDouble thresh)
+    {
+      return v != T( 0) && std::abs( v) >= thresh;
+    }
+
+    // y = A x
+    template<typename T>
+    void SparseTimes( const SparseCSR<T>& a, const T* x, T* y)
+    {
+      const SizeT n = a.n;
+      const SizeT nnz = a.rowStart[ n];
+#pragma omp parallel for if (nnz >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= nnz))
+      for( OMPInt r = 0; r < n; ++r)
+	{
+	  T sum = 0;
+	  for( SizeT k = a.rowStart[ r]; k < a.rowStart[ r + 1]; ++k)
+	    sum += a.val[ k] * x[ a.col[ k]];
+	  y[ r] = sum;
+	}
+    }
+
+    template<typename T>
+    void SparseTranspose( const SparseCSR<T>& a, SparseCSR<T>& t)
+    {
+      const SizeT n = a.n;
+      const SizeT nnz = a.rowStart[ n];
+      t.n = n;
+      t.rowStart.assign( n + 1, 0);
+      t.col.resize( nnz);
+      t.val.resize( nnz);
+      for( SizeT k = 0; k < nnz; ++k) ++t.rowStart[ a.col[ k] + 1];
+      for( SizeT r = 0; r < n; ++r) t.rowStart[ r + 1] += t.rowStart[ r];
+      // rows of a in order: the columns of t come out sorted
+      vector<SizeT> next( t.rowStart.begin(), t.rowStart.end() - 1);
+      for( SizeT r = 0; r < n; ++r)
+	for( SizeT k = a.rowStart[ r]; k < a.rowStart[ r + 1]; ++k)
+	  {
+	    SizeT d = next[ a.col[ k]]++;
+	    t.col[ d] = r;
+	    t.val[ d] = a.val[ k];
+	  }
+    }
+
+    // C = A B, row by row (Gustavson) with a dense accumulator per thread
+    template<typename T>
+    void SparseProduct( const SparseCSR<T>& a, const SparseCSR<T>& b, SparseCSR<T>& c)
+    {
+      const SizeT n = a.n;
+      const SizeT nnz = a.rowStart[ n];
+      vector< vector<DLong> > rowCol( n);
+      vector< vector<T> > rowVal( n);
+#pragma omp parallel if (nnz >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= nnz))
+      {
+	vector<T> acc( n, T( 0));
+	vector<char> used( n, 0);
+	vector<DLong> cols;
+#pragma omp for
+	for( OMPInt r = 0; r < n; ++r)
+	  {
+	    cols.clear();
+	    for( SizeT ka = a.rowStart[ r]; ka < a.rowStart[ r + 1]; ++ka)
+	      {
+		const T av = a.val[ ka];
+		const SizeT br = a.col[ ka];
+		for( SizeT kb = b.rowStart[ br]; kb < b.rowStart[ br + 1]; ++kb)
+		  {
+		    const DLong j = b.col[ kb];
+		    if( !used[ j])
+		      {
+			used[ j] = 1;
+			cols.push_back( j);
+		      }
+		    acc[ j] += av * b.val[ kb];
+		  }
+	      }
+	    std::sort( cols.begin(), cols.end());
+	    rowCol[ r] = cols;
+	    rowVal[ r].resize( cols.size());
+	    for( SizeT i = 0; i < cols.size(); ++i)
+	      {
+		rowVal[ r][ i] = acc[ cols[ i]];
+		acc[ cols[ i]] = 0;
+		used[ cols[ i]] = 0;
+	      }
+	  }
+      }
+      c.n = n;
+      c.rowStart.resize( n + 1);
+      c.rowStart[ 0] = 0;
+      for( SizeT r = 0; r < n; ++r) c.rowStart[ r + 1] = c.rowStart[ r] + rowCol[ r].size();
+      c.col.resize( c.rowStart[ n]);
+      c.val.resize( c.rowStart[ n]);
+      for( SizeT r = 0; r < n; ++r)
+	{
+	  std::copy( rowCol[ r].begin(), rowCol[ r].end(), c.col.begin() + c.rowStart[ r]);
+	  std::copy( rowVal[ r].begin(), rowVal[ r].end(), c.val.begin() + c.rowStart[ r]);
+	}
+    }
+
+    // CSR -> {SA, IJA}; the diagonal is always stored, the other
+    // elements only if non zero and not below 'thresh' in magnitude
+    template<class Data>
+    DStructGDL* SparseToStruct( const SparseCSR<typename Data::Ty>& a, DDouble thresh)
+    {
+      typedef typename Data::Ty T;
+      const SizeT n = a.n;
+      vector<SizeT> start( n + 1);
+      start[ 0] = n + 1;
+      for( SizeT r = 0; r < n; ++r)
+	{
+	  SizeT cnt = 0;
+	  for( SizeT k = a.rowStart[ r]; k < a.rowStart[ r + 1]; ++k)
+	    if( a.col[ k] != static_cast<DLong>( r) && SparseKeep( a.val[ k], thresh)) ++cnt;
+	  start[ r + 1] = start[ r] + cnt;
+	}
+      const SizeT nTot = start[ n];
+
+      Data* sa = new Data( dimension( nTot)); // SA[n] stays 0
+      DLongGDL* ija = new DLongGDL( dimension( nTot), BaseGDL::NOZERO);
+      for( SizeT r = 0; r <= n; ++r) (*ija)[ r] = start[ r];
+#pragma omp parallel for if (nTot >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= nTot))
+      for( OMPInt r = 0; r < n; ++r)
+	{
+	  SizeT d = start[ r];
+	  T diag = 0;
+	  for( SizeT k = a.rowStart[ r]; k < a.rowStart[ r + 1]; ++k)
+	    {
+	      if( a.col[ k] == static_cast<DLong>( r))
+		diag += a.val[ k];
+	      else if( SparseKeep( a.val[ k], thresh))
+		{
+		  (*sa)[ d] = a.val[ k];
+		  (*ija)[ d] = a.col[ k];
+		  ++d;
+		}
+	    }
+	  (*sa)[ r] = diag;
+	}
+
+      DStructGDL* res = new DStructGDL( new DStructDesc( "$truct"));
+      res->NewTag( "SA", sa);
+      res->NewTag( "IJA", ija);
+      return res;
+    }
+
+    // parameter 'ix' must be a {SA, IJA} structure, converted to CSR
+    template<class Data>
+    void SparseFromStruct( EnvT* e, SizeT ix, SparseCSR<typename Data::Ty>& a)
+    {
+      BaseGDL* p = e->GetParDefined( ix);
+      const string bad = "Argument is not a sparse matrix structure (see SPRSIN): " + e->GetParString( ix);
+      if( p->Type() != GDL_STRUCT || !p->Scalar()) e->Throw( bad);
+      DStructGDL* s = static_cast<DStructGDL*>( p);
+      int saIx = s->Desc()->TagIndex( "SA");
+      int ijaIx = s->Desc()->TagIndex( "IJA");
+      if( saIx < 0 || ijaIx < 0) e->Throw( bad);
+      BaseGDL* saP = s->GetTag( saIx, 0);
+      BaseGDL* ijaP = s->GetTag( ijaIx, 0);
+      if( !NumericType( saP->Type()) || !IntType( ijaP->Type())) e->Throw( bad);
+
+      Data* sa = static_cast<Data*>( saP);
+      Guard<Data> saGuard;
+      if( saP->Type() != Data::t)
+	{
+	  sa = static_cast<Data*>( saP->Convert2( Data::t, BaseGDL::COPY));
+	  saGuard.Init( sa);
+	}
+      DLongGDL* ija = static_cast<DLongGDL*>( ijaP);
+      Guard<DLongGDL> ijaGuard;
+      if( ijaP->Type() != GDL_LONG)
+	{
+	  ija = static_cast<DLongGDL*>( ijaP->Convert2( GDL_LONG, BaseGDL::COPY));
+	  ijaGuard.Init( ija);
+	}
+
+      const SizeT nSa = sa->N_Elements();
+      const SizeT nIja = ija->N_Elements();
+      const DLong n1 = (*ija)[ 0];
+      if( n1 < 2 || static_cast<SizeT>( n1) > nIja) e->Throw( bad);
+      const SizeT n = n1 - 1;
+      for( SizeT r = 0; r < n; ++r)
+	if( (*ija)[ r + 1] < (*ija)[ r]) e->Throw( bad);
+      const SizeT end = (*ija)[ n];
+      if( end > nIja || end > nSa) e->Throw( bad);
+      for( SizeT k = n1; k < end; ++k)
+	if( (*ija)[ k] < 0 || (*ija)[ k] >= static_cast<DLong>( n)) e->Throw( bad);
+
+      // the diagonal is put first in each row
+      a.n = n;
+      a.rowStart.resize( n + 1);
+      for( SizeT r = 0; r <= n; ++r) a.rowStart[ r] = ((*ija)[ r] - n1) + r;
+      const SizeT nnz = a.rowStart[ n];
+      a.col.resize( nnz);
+      a.val.resize( nnz);
+#pragma omp parallel for if (nnz >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= nnz))
+      for( OMPInt r = 0; r < n; ++r)
+	{
+	  SizeT d = a.rowStart[ r];
+	  a.col[ d] = r;
+	  a.val[ d] = (*sa)[ r];
+	  for( SizeT k = (*ija)[ r]; k < static_cast<SizeT>( (*ija)[ r + 1]); ++k)
+	    {
+	      ++d;
+	      a.col[ d] = (*ija)[ k];
+	      a.val[ d] = (*sa)[ k];
+	    }
+	}
+    }
+
+    // true if the structure's SA is double
+    bool SparseIsDouble( EnvT* e, SizeT ix)
+    {
+      BaseGDL* p = e->GetParDefined( ix);
+      if( p->Type() != GDL_STRUCT) return false;
+      DStructGDL* s = static_cast<DStructGDL*>( p);
+      int saIx = s->Desc()->TagIndex( "SA");
+      return saIx >= 0 && s->GetTag( saIx, 0)->Type() == GDL_DOUBLE;
+    }
+
+    template<class Data>
+    BaseGDL* SprsinDense( EnvT* e, BaseGDL* p0, bool column, DDouble thresh)
+    {
+      typedef typename Data::Ty T;
+      const SizeT n = p0->Dim( 0);
+      Data* a = static_cast<Data*>( p0->Convert2( Data::t, BaseGDL::COPY));
+      Guard<Data> aGuard( a);
+      // element (r,c): A[c,r], or A[r,c] with /COLUMN
+      const SizeT sr = column ? 1 : n;
+      const SizeT sc = column ? n : 1;
+
+      SparseCSR<T> s;
+      s.n = n;
+      s.rowStart.resize( n + 1);
+      s.rowStart[ 0] = 0;
+      vector<SizeT> cnt( n);
+#pragma omp parallel for if (n*n >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= n*n))
+      for( OMPInt r = 0; r < n; ++r)
+	{
+	  SizeT c0 = 1; // diagonal
+	  for( SizeT c = 0; c < n; ++c)
+	    if( c != static_cast<SizeT>( r) && SparseKeep( (*a)[ r * sr + c * sc], thresh)) ++c0;
+	  cnt[ r] = c0;
+	}
+      for( SizeT r = 0; r < n; ++r) s.rowStart[ r + 1] = s.rowStart[ r] + cnt[ r];
+      s.col.resize( s.rowStart[ n]);
+      s.val.resize( s.rowStart[ n]);
+#pragma omp parallel for if (n*n >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= n*n))
+      for( OMPInt r = 0; r < n; ++r)
+	{
+	  SizeT d = s.rowStart[ r];
+	  for( SizeT c = 0; c < n; ++c)
+	    {
+	      T v = (*a)[ r * sr + c * sc];
+	      if( c == static_cast<SizeT>( r) || SparseKeep( v, thresh))
+		{
+		  s.col[ d] = c;
+		  s.val[ d] = v;
+		  ++d;
+		}
+	    }
+	}
+      return SparseToStruct<Data>( s, thresh);
+    }
+
+    template<class Data>
+    BaseGDL* SprsinTriplets( EnvT* e, DDouble thresh)
+    {
+      typedef typename Data::Ty T;
+      DLongGDL* cols = e->GetParAs<DLongGDL>( 0);
+      DLongGDL* rows = e->GetParAs<DLongGDL>( 1);
+      Data* vals = e->GetParAs<Data>( 2);
+      DLong nL;
+      e->AssureLongScalarPar( 3, nL);
+      if( nL < 1)
+	e->Throw( "Matrix size must be positive: " + e->GetParString( 3));
+      const SizeT n = nL;
+      const SizeT nEl = vals->N_Elements();
+      if( cols->N_Elements() != nEl || rows->N_Elements() != nEl)
+	e->Throw( "Columns, Rows and Values must have the same number of elements.");
+      for( SizeT i = 0; i < nEl; ++i)
+	if( (*cols)[ i] < 0 || (*cols)[ i] >= nL || (*rows)[ i] < 0 || (*rows)[ i] >= nL)
+	  e->Throw( "Index out of range (0 to " + i2s( n - 1) + ") in Columns or Rows.");
+
+      // bucket by row, then sort each row on the column, summing duplicates
+      SparseCSR<T> s;
+      s.n = n;
+      s.rowStart.assign( n + 1, 0);
+      for( SizeT i = 0; i < nEl; ++i) ++s.rowStart[ (*rows)[ i] + 1];
+      for( SizeT r = 0; r < n; ++r) s.rowStart[ r + 1] += s.rowStart[ r];
+      vector<SizeT> next( s.rowStart.begin(), s.rowStart.end() - 1);
+      vector< pair<DLong, T> > entries( nEl);
+      for( SizeT i = 0; i < nEl; ++i)
+	entries[ next[ (*rows)[ i]]++] = make_pair( (*cols)[ i], (*vals)[ i]);
+      s.col.resize( nEl);
+      s.val.resize( nEl);
+      SizeT d = 0;
+      for( SizeT r = 0; r < n; ++r)
+	{
+	  SizeT b = s.rowStart[ r];
+	  SizeT end = s.rowStart[ r + 1];
+	  std::stable_sort( entries.begin() + b, entries.begin() + end,
+			    [] ( const pair<DLong, T>& x, const pair<DLong, T>& y) { return x.first < y.first;});
+	  s.rowStart[ r] = d;
+	  for( SizeT k = b; k < end; ++k)
+	    {
+	      if( d > s.rowStart[ r] && s.col[ d - 1] == entries[ k].first)
+		s.val[ d - 1] += entries[ k].second;
+	      else
+		{
+		  s.col[ d] = entries[ k].first;
+		  s.val[ d] = entries[ k].second;
+		  ++d;
+		}
+	    }
+	}
+      s.rowStart[ n] = d;
+      return SparseToStruct<Data>( s, thresh);
+    }
+
+    template<class Data>
+    BaseGDL* FulstrTyped( EnvT* e)
+    {
+      typedef typename Data::Ty T;
+      SparseCSR<T> a;
+      SparseFromStruct<Data>( e, 0, a);
+      const SizeT n = a.n;
+      Data* res = new Data( dimension( n, n));
+      // rows are disjoint
+#pragma omp parallel for if (n*n >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= n*n))
+      for( OMPInt r = 0; r < n; ++r)
+	for( SizeT k = a.rowStart[ r]; k < a.rowStart[ r + 1]; ++k)
+	  (*res)[ a.col[ k] + r * n] += a.val[ k];
+      return res;
+    }
+
+    template<class Data>
+    BaseGDL* SprsaxTyped( EnvT* e)
+    {
+      SparseCSR<typename Data::Ty> a;
+      SparseFromStruct<Data>( e, 0, a);
+      Data* x = e->GetParAs<Data>( 1);
+      if( x->N_Elements() != a.n)
+	e->Throw( "X must have " + i2s( a.n) + " elements: " + e->GetParString( 1));
+      Data* res = new Data( dimension( a.n), BaseGDL::NOZERO);
+      SparseTimes( a, &(*x)[ 0], &(*res)[ 0]);
+      return res;
+    }
+
+    template<class Data>
+    BaseGDL* SprsabTyped( EnvT* e, DDouble thresh)
+    {
+      typedef typename Data::Ty T;
+      SparseCSR<T> a, b, c;
+      SparseFromStruct<Data>( e, 0, a);
+      SparseFromStruct<Data>( e, 1, b);
+      if( a.n != b.n)
+	e->Throw( "Sparse matrices must have the same size.");
+      SparseProduct( a, b, c);
+      return SparseToStruct<Data>( c, thresh);
+    }
+
+    template<class Data>
+    BaseGDL* SprstpTyped( EnvT* e)
+    {
+      typedef typename Data::Ty T;
+      SparseCSR<T> a, t;
+      SparseFromStruct<Data>( e, 0, a);
+      SparseTranspose( a, t);
+      return SparseToStruct<Data>( t, 0.0);
+    }
+
+    template<typename T>
+    T SparseNorm( const vector<T>& x, int itol)
+    {
+      T res = 0;
+      if( itol <= 3)
+	{
+	  for( SizeT i = 0; i < x.size(); ++i) res += x[ i] * x[ i];
+	  return std::sqrt( res);
+	}
+      for( SizeT i = 0; i < x.size(); ++i) res = std::max( res, static_cast<T>( std::abs( x[ i])));
+      return res;
+    }
+
+    template<typename T>
+    T SparseDot( const vector<T>& x, const vector<T>& y)
+    {
+      T res = 0;
+      for( SizeT i = 0; i < x.size(); ++i) res += x[ i] * y[ i];
+      return res;
+    }
+
+    // preconditioned biconjugate gradient (Numerical Recipes' linbcg),
+    // Jacobi preconditioner, the convergence test 'itol' as in IDL.
+    // x holds the initial guess, returns the number of iterations.
+    template<typename T>
+    DLong SparseBiCG( const SparseCSR<T>& a, const vector<T>& b, vector<T>& x,
+		      int itol, T tol, DLong itmax)
+    {
+      const SizeT n = a.n;
+      SparseCSR<T> at;
+      SparseTranspose( a, at);
+
+      vector<T> diag( n, T( 0));
+      for( SizeT r = 0; r < n; ++r)
+	for( SizeT k = a.rowStart[ r]; k < a.rowStart[ r + 1]; ++k)
+	  if( a.col[ k] == static_cast<DLong>( r)) diag[ r] += a.val[ k];
+      for( SizeT r = 0; r < n; ++r)
+	if( diag[ r] == T( 0)) diag[ r] = 1;
+
+      vector<T> p( n), pp( n), r( n), rr( n), z( n), zz( n);
+
+      SparseTimes( a, &x[ 0], &r[ 0]);
+      for( SizeT j = 0; j < n; ++j)
+	{
+	  r[ j] = b[ j] - r[ j];
+	  rr[ j] = r[ j];
+	}
+      T bnrm, znrm = 0;
+      if( itol == 1)
+	bnrm = SparseNorm( b, itol);
+      else
+	{
+	  for( SizeT j = 0; j < n; ++j) z[ j] = b[ j] / diag[ j];
+	  bnrm = SparseNorm( z, itol);
+	}
+      for( SizeT j = 0; j < n; ++j) z[ j] = r[ j] / diag[ j];
+      if( itol >= 3) znrm = SparseNorm( z, itol);
+      if( bnrm == T( 0)) bnrm = 1;
+
+      T bkden = 1;
+      T err = 0;
+      const T eps = std::numeric_limits<T>::epsilon();
+      DLong iter = 0;
+      while( iter < itmax)
+	{
+	  ++iter;
+	  for( SizeT j = 0; j < n; ++j) zz[ j] = rr[ j] / diag[ j];
+	  T bknum = SparseDot( z, rr);
+	  if( iter == 1)
+	    {
+	      p = z;
+	      pp = zz;
+	    }
+	  else
+	    {
+	      if( bkden == T( 0)) break; // breakdown
+	      T bk = bknum / bkden;
+	      for( SizeT j = 0; j < n; ++j)
+		{
+		  p[ j] = bk * p[ j] + z[ j];
+		  pp[ j] = bk * pp[ j] + zz[ j];
+		}
+	    }
+	  bkden = bknum;
+	  SparseTimes( a, &p[ 0], &z[ 0]);
+	  T akden = SparseDot( z, pp);
+	  if( akden == T( 0)) break;
+	  T ak = bknum / akden;
+	  SparseTimes( at, &pp[ 0], &zz[ 0]);
+	  for( SizeT j = 0; j < n; ++j)
+	    {
+	      x[ j] += ak * p[ j];
+	      r[ j] -= ak * z[ j];
+	      rr[ j] -= ak * zz[ j];
+	    }
+	  for( SizeT j = 0; j < n; ++j) z[ j] = r[ j] / diag[ j];
+	  if( itol == 1)
+	    err = SparseNorm( r, itol) / bnrm;
+	  else if( itol == 2)
+	    err = SparseNorm( z, itol) / bnrm;
+	  else
+	    {
+	      T zm1nrm = znrm;
+	      znrm = SparseNorm( z, itol);
+	      if( std::abs( zm1nrm - znrm) > eps * znrm)
+		{
+		  T dxnrm = std::abs( ak) * SparseNorm( p, itol);
+		  err = znrm / std::abs( zm1nrm - znrm) * dxnrm;
+		  T xnrm = SparseNorm( x, itol);
+		  if( err <= 0.5 * xnrm) err /= xnrm;
+		  else
+		    {
+		      err = znrm / bnrm;
+		      continue;
+		    }
+		}
+	      else
+		{
+		  err = znrm / bnrm;
+		  continue;
+		}
+	    }
+	  if( err <= tol) break;
+	}
+      return iter;
+    }
+
+    template<class Data>
+    BaseGDL* LinbcgTyped( EnvT* e, int itol, DDouble tol, DLong itmax, DLong& iter)
+    {
+      typedef typename Data::Ty T;
+      SparseCSR<T> a;
+      SparseFromStruct<Data>( e, 0, a);
+      const SizeT n = a.n;
+      Data* bP = e->GetParAs<Data>( 1);
+      Data* xP = e->GetParAs<Data>( 2);
+      if( bP->N_Elements() != n)
+	e->Throw( "B must have " + i2s( n) + " elements: " + e->GetParString( 1));
+      if( xP->N_Elements() != n)
+	e->Throw( "X must have " + i2s( n) + " elements: " + e->GetParString( 2));
+
+      vector<T> b( &(*bP)[ 0], &(*bP)[ 0] + n);
+      vector<T> x( &(*xP)[ 0], &(*xP)[ 0] + n);
+      iter = SparseBiCG( a, b, x, itol, static_cast<T>( tol), itmax);
+
+      Data* res = new Data( dimension( n), BaseGDL::NOZERO);
+      std::copy( x.begin(), x.end(), &(*res)[ 0]);
+      return res;
+    }
+
+  } // namespace
+
+  BaseGDL* sprsin_fun( EnvT* e)
+  {
+    SizeT nParam = e->NParam( 1);
+
+    static int columnIx = e->KeywordIx( "COLUMN");
+    static int doubleIx = e->KeywordIx( "DOUBLE");
+    static int thresholdIx = e->KeywordIx( "THRESHOLD");
+
+    DDouble thresh = 0;
+    e->AssureDoubleScalarKWIfPresent( thresholdIx, thresh);
+    bool isDouble = e->KeywordSet( doubleIx);
+
+    if( nParam == 4)
+      {
+	isDouble = isDouble || e->GetNumericParDefined( 2)->Type() == GDL_DOUBLE;
+	if( isDouble)
+	  return SprsinTriplets<DDoubleGDL>( e, thresh);
+	return SprsinTriplets<DFloatGDL>( e, thresh);
+      }
+    if( nParam != 1)
+      e->Throw( "Incorrect number of arguments.");
+
+    BaseGDL* p0 = e->GetNumericParDefined( 0);
+    if( p0->Type() == GDL_COMPLEX || p0->Type() == GDL_COMPLEXDBL)
+      e->Throw( "Complex expression not allowed in this context: " + e->GetParString( 0));
+    if( p0->Rank() != 2 || p0->Dim( 0) != p0->Dim( 1))
+      e->Throw( "Argument must be a square matrix: " + e->GetParString( 0));
+    isDouble = isDouble || p0->Type() == GDL_DOUBLE;
+    bool column = e->KeywordSet( columnIx);
+    if( isDouble)
+      return SprsinDense<DDoubleGDL>( e, p0, column, thresh);
+    return SprsinDense<DFloatGDL>( e, p0, column, thresh);
+  }
+
+  BaseGDL* fulstr_fun( EnvT* e)
+  {
+    e->NParam( 1);
+    if( SparseIsDouble( e, 0))
+      return FulstrTyped<DDoubleGDL>( e);
+    return FulstrTyped<DFloatGDL>( e);
+  }
+
+  BaseGDL* sprsax_fun( EnvT* e)
+  {
+    e->NParam( 2);
+    static int doubleIx = e->KeywordIx( "DOUBLE");
+    if( SparseIsDouble( e, 0) || e->KeywordSet( doubleIx) ||
+	e->GetNumericParDefined( 1)->Type() == GDL_DOUBLE)
+      return SprsaxTyped<DDoubleGDL>( e);
+    return SprsaxTyped<DFloatGDL>( e);
+  }
+
+  BaseGDL* sprsab_fun( EnvT* e)
+  {
+    e->NParam( 2);
+    static int doubleIx = e->KeywordIx( "DOUBLE");
+    static int thresholdIx = e->KeywordIx( "THRESHOLD");
+    DDouble thresh = 0;
+    e->AssureDoubleScalarKWIfPresent( thresholdIx, thresh);
+    if( SparseIsDouble( e, 0) || SparseIsDouble( e, 1) || e->KeywordSet( doubleIx))
+      return SprsabTyped<DDoubleGDL>( e, thresh);
+    return SprsabTyped<DFloatGDL>( e, thresh);
+  }
+
+  BaseGDL* sprstp_fun( EnvT* e)
+  {
+    e->NParam( 1);
+    if( SparseIsDouble( e, 0))
+      return SprstpTyped<DDoubleGDL>( e);
+    return SprstpTyped<DFloatGDL>( e);
+  }
+
+  BaseGDL* linbcg_fun( EnvT* e)
+  {
+    e->NParam( 3);
+    static int doubleIx = e->KeywordIx( "DOUBLE");
+    static int itolIx = e->KeywordIx( "ITOL");
+    static int tolIx = e->KeywordIx( "TOL");
+    static int iterIx = e->KeywordIx( "ITER");
+    static int itmaxIx = e->KeywordIx( "ITMAX");
+
+    DLong itol = 1;
+    e->AssureLongScalarKWIfPresent( itolIx, itol);
+    if( itol < 1 || itol > 4)
+      e->Throw( "ITOL must be 1, 2, 3 or 4.");
+    DDouble tol = 1.0e-7;
+    e->AssureDoubleScalarKWIfPresent( tolIx, tol);
+    DLong itmax = -1;
+    e->AssureLongScalarKWIfPresent( itmaxIx, itmax);
+
+    bool isDouble = SparseIsDouble( e, 0) || e->KeywordSet( doubleIx) ||
+      e->GetNumericParDefined( 1)->Type() == GDL_DOUBLE ||
+      e->GetNumericParDefined( 2)->Type() == GDL_DOUBLE;
+    // default: n^2 iterations
+    if( itmax < 0)
+      {
+	DLong nB = e->GetParDefined( 1)->N_Elements();
+	itmax = (nB > 46340) ? 2147483647 : nB * nB;
+      }
+
+    DLong iter = 0;
+    BaseGDL* res;
+    if( isDouble)
+      res = LinbcgTyped<DDoubleGDL>( e, itol, tol, itmax, iter);
+    else
+      res = LinbcgTyped<DFloatGDL>( e, itol, tol, itmax, iter);
+    if( e->KeywordPresent( iterIx))
+      e->SetKW( iterIx, new DLongGDL( iter));
+    return res;
+  }
+
+} // namespace lib
@@ -0,0 +1,35 @@
+/***************************************************************************
+                          sparse.hpp  -  sparse matrices (SPRSIN...)
+                             -------------------
+    begin                : Oct 2026
+    copyright            : (C) 2026 by the GDL team
+    email                :
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef SPARSE_HPP_
+#define SPARSE_HPP_
+
+#include "datatypes.hpp"
+#include "envt.hpp"
+
+namespace lib {
+
+  BaseGDL* sprsin_fun( EnvT* e);
+  BaseGDL* fulstr_fun( EnvT* e);
+  BaseGDL* sprsax_fun( EnvT* e);
+  BaseGDL* sprsab_fun( EnvT* e);
+  BaseGDL* sprstp_fun( EnvT* e);
+  BaseGDL* linbcg_fun( EnvT* e);
+
+}
+
+#endif
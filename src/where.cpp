@@ -17,9 +17,12 @@
 
 #include "includefirst.hpp"
 
+#include <functional>
+
 #include "nullgdl.hpp"
 #include "dstructgdl.hpp"
 #include "dinterpreter.hpp" //for sysVarList() 
+#include "simd_dispatch.hpp"
 
 
 //We create 'on the spot' arrays that must be aligned. this is the purpose of the gdl..lloc functions.
@@ -27,6 +30,206 @@
 #define REALLOC gdlAlignedRealloc 
 #define FREE gdlAlignedFree
 
+// WHERE works on a packed bit mask of the true elements. A first pass
+// builds the 64-bit mask words of fixed chunks of WHERE_CHUNK_WORDS words
+// and counts their bits; a second one writes the indices of each chunk, at
+// its offset in the exactly allocated results, by walking the set (or, for
+// COMPLEMENT, unset) bits of its words. Both passes run in parallel over
+// the chunks. The mask takes one bit per element, the former method a full
+// size index array per thread.
+static const SizeT WHERE_CHUNK_WORDS = 4096;
+
+template<typename Ty> inline bool WhereTrue(const Ty& v) { return v != 0; }
+inline bool WhereTrue(const DString& v) { return v != ""; }
+inline bool WhereTrue(const DComplex& v) { return v.real() && v.imag(); } //both needed
+inline bool WhereTrue(const DComplexDbl& v) { return v.real() && v.imag(); }
+
+// mask word of the n <= 64 elements starting at p
+template<typename Ty> inline uint64_t WhereMaskWord(const Ty* p, int n) {
+  uint64_t m = 0;
+  for (int b = 0; b < n; ++b) m |= static_cast<uint64_t>(WhereTrue(p[b])) << b;
+  return m;
+}
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+// bytes (the result of the comparison and logical operators): 8 at a time,
+// the high bit of each non-zero byte is set, then the 8 bits are gathered
+// by a multiplication.
+template<> inline uint64_t WhereMaskWord(const DByte* p, int n) {
+  if (n < 64) {
+    uint64_t m = 0;
+    for (int b = 0; b < n; ++b) m |= static_cast<uint64_t>(p[b] != 0) << b;
+    return m;
+  }
+  const uint64_t low7 = 0x7F7F7F7F7F7F7F7FULL;
+  uint64_t m = 0;
+  for (int k = 0; k < 8; ++k) {
+    uint64_t x;
+    memcpy(&x, p + 8 * k, 8);
+    uint64_t t = (((x & low7) + low7) | x) & ~low7;
+    m |= (((t >> 7) * 0x0102040810204080ULL) >> 56) << (8 * k);
+  }
+  return m;
+}
+#endif
+
+inline SizeT WhereMaskChunks(SizeT nEl) { return ((nEl + 63) / 64 + WHERE_CHUNK_WORDS - 1) / WHERE_CHUNK_WORDS; }
+
+inline bool WhereParallel(SizeT nEl) {
+  return (WhereMaskChunks(nEl) > 1 && nEl >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= nEl));
+}
+
+// first pass: the mask words and the running count of the true elements,
+// offset[c] before chunk c, offset[nChunks] in all
+template<typename Ty>
+static void WhereMaskPass(const Ty* data, SizeT nEl, uint64_t* mask, SizeT* offset, bool parallel) {
+  SizeT nWords = (nEl + 63) / 64;
+  SizeT nChunks = WhereMaskChunks(nEl);
+#pragma omp parallel for if (parallel)
+  for (OMPInt c = 0; c < nChunks; ++c) {
+    SizeT w1 = (c + 1) * WHERE_CHUNK_WORDS;
+    if (w1 > nWords) w1 = nWords;
+    SizeT count = 0;
+    for (SizeT w = c * WHERE_CHUNK_WORDS; w < w1; ++w) {
+      SizeT n = nEl - w * 64;
+      mask[w] = WhereMaskWord(data + w * 64, (n < 64) ? n : 64);
+      count += __builtin_popcountll(mask[w]);
+    }
+    offset[c + 1] = count;
+  }
+  offset[0] = 0;
+  for (SizeT c = 0; c < nChunks; ++c) offset[c + 1] += offset[c];
+}
+
+// the running count of WhereMaskPass() for the mask words already set
+static void WhereCountPass(const uint64_t* mask, SizeT nEl, SizeT* offset, bool parallel) {
+  SizeT nWords = (nEl + 63) / 64;
+  SizeT nChunks = WhereMaskChunks(nEl);
+#pragma omp parallel for if (parallel)
+  for (OMPInt c = 0; c < nChunks; ++c) {
+    SizeT w1 = (c + 1) * WHERE_CHUNK_WORDS;
+    if (w1 > nWords) w1 = nWords;
+    SizeT count = 0;
+    for (SizeT w = c * WHERE_CHUNK_WORDS; w < w1; ++w) count += __builtin_popcountll(mask[w]);
+    offset[c + 1] = count;
+  }
+  offset[0] = 0;
+  for (SizeT c = 0; c < nChunks; ++c) offset[c + 1] += offset[c];
+}
+
+// the bits of the nEl elements in the last mask word
+inline uint64_t WhereLastWordBits(SizeT nEl) {
+  SizeT n = nEl % 64;
+  return (n == 0) ? ~static_cast<uint64_t>(0) : (static_cast<uint64_t>(1) << n) - 1;
+}
+
+// second pass: the indices of the set (and for COMPLEMENT of the unset) bits
+template<typename IxT>
+static void WhereIndexPass(const uint64_t* mask, const SizeT* offset, SizeT nEl, bool comp, IxT* ret, IxT* comp_ret, bool parallel) {
+  SizeT nWords = (nEl + 63) / 64;
+  SizeT nChunks = WhereMaskChunks(nEl);
+#pragma omp parallel for if (parallel)
+  for (OMPInt c = 0; c < nChunks; ++c) {
+    SizeT w1 = (c + 1) * WHERE_CHUNK_WORDS;
+    if (w1 > nWords) w1 = nWords;
+    SizeT k = offset[c];
+    SizeT kc = c * WHERE_CHUNK_WORDS * 64 - offset[c]; // false elements before the chunk
+    for (SizeT w = c * WHERE_CHUNK_WORDS; w < w1; ++w) {
+      SizeT base = w * 64;
+      for (uint64_t m = mask[w]; m != 0; m &= m - 1) ret[k++] = base + __builtin_ctzll(m);
+      if (comp) {
+        SizeT n = nEl - base;
+        uint64_t valid = (n < 64) ? (static_cast<uint64_t>(1) << n) - 1 : ~static_cast<uint64_t>(0);
+        for (uint64_t m = ~mask[w] & valid; m != 0; m &= m - 1) comp_ret[kc++] = base + __builtin_ctzll(m);
+      }
+    }
+  }
+}
+
+// the results of WhereIndexPass(), exactly allocated
+template<typename IxT>
+static void WhereIndexOf(const uint64_t* mask, const SizeT* offset, SizeT nEl, bool comp, IxT* &ret, SizeT &passed_count, IxT* &comp_ret, bool parallel) {
+  passed_count = offset[WhereMaskChunks(nEl)];
+  ret = (passed_count > 0) ? (IxT*) MALLOC(passed_count * sizeof (IxT)) : NULL;
+  if (comp) comp_ret = (passed_count < nEl) ? (IxT*) MALLOC((nEl - passed_count) * sizeof (IxT)) : NULL;
+  WhereIndexPass(mask, offset, nEl, comp, ret, comp_ret, parallel);
+}
+
+template<typename IxT, typename Ty>
+static void WhereByMask(const Ty* data, SizeT nEl, bool comp, IxT* &ret, SizeT &passed_count, IxT* &comp_ret) {
+  SizeT nWords = (nEl + 63) / 64;
+  SizeT nChunks = WhereMaskChunks(nEl);
+  bool parallel = WhereParallel(nEl);
+  uint64_t* mask = (uint64_t*) MALLOC(nWords * sizeof (uint64_t));
+  SizeT* offset = (SizeT*) MALLOC((nChunks + 1) * sizeof (SizeT));
+  WhereMaskPass(data, nEl, mask, offset, parallel);
+  WhereIndexOf(mask, offset, nEl, comp, ret, passed_count, comp_ret, parallel);
+  FREE(offset);
+  FREE(mask);
+}
+
+// WHERE(a op b) (see lib::where_compare_mask): each chunk is compared by
+// blocks of WHERE_CMP_BLOCK elements into a byte buffer on the stack, with
+// the kernels of simd_dispatch for FLOAT and DOUBLE, and the mask words of
+// the block are gathered from it as for a BYTE condition. The BYTE array of
+// the comparison is never built.
+static const SizeT WHERE_CMP_BLOCK = 4096;
+
+template<typename Ty, typename Cmp>
+inline void WhereCompareLoop(DByte* res, const Ty* a, const Ty* b, bool bScalar, SizeT n, Cmp cmp) {
+  if (bScalar) {
+    const Ty s = b[0];
+    for (SizeT i = 0; i < n; ++i) res[i] = cmp(a[i], s);
+  } else {
+    for (SizeT i = 0; i < n; ++i) res[i] = cmp(a[i], b[i]);
+  }
+}
+
+// res[i] = (a[i] op b[i]), or (a[i] op b[0]) if bScalar
+template<typename Ty>
+static void WhereCompareBlock(SimdCmpOp op, bool bScalar, DByte* res, const Ty* a, const Ty* b, SizeT n) {
+  if (SimdFloat<Ty>::value) {
+    SimdFloat<Ty>::Kernels()->cmp[op][bScalar ? 1 : 0](res, a, b, n);
+    return;
+  }
+  switch (op) {
+  case SIMD_EQ: WhereCompareLoop(res, a, b, bScalar, n, std::equal_to<Ty>()); break;
+  case SIMD_NE: WhereCompareLoop(res, a, b, bScalar, n, std::not_equal_to<Ty>()); break;
+  case SIMD_LE: WhereCompareLoop(res, a, b, bScalar, n, std::less_equal<Ty>()); break;
+  case SIMD_LT: WhereCompareLoop(res, a, b, bScalar, n, std::less<Ty>()); break;
+  case SIMD_GE: WhereCompareLoop(res, a, b, bScalar, n, std::greater_equal<Ty>()); break;
+  case SIMD_GT: WhereCompareLoop(res, a, b, bScalar, n, std::greater<Ty>()); break;
+  default: assert(false);
+  }
+}
+
+// as WhereMaskPass() for the condition (a op b)
+template<typename Ty>
+static void WhereCompareMaskPass(SimdCmpOp op, const Ty* a, const Ty* b, bool bScalar, SizeT nEl, uint64_t* mask, SizeT* offset, bool parallel) {
+  SizeT nWords = (nEl + 63) / 64;
+  SizeT nChunks = WhereMaskChunks(nEl);
+#pragma omp parallel for if (parallel)
+  for (OMPInt c = 0; c < nChunks; ++c) {
+    DByte buf[WHERE_CMP_BLOCK];
+    SizeT w1 = (c + 1) * WHERE_CHUNK_WORDS;
+    if (w1 > nWords) w1 = nWords;
+    SizeT count = 0;
+    for (SizeT w0 = c * WHERE_CHUNK_WORDS; w0 < w1; w0 += WHERE_CMP_BLOCK / 64) {
+      SizeT e0 = w0 * 64;
+      SizeT nb = (nEl - e0 < WHERE_CMP_BLOCK) ? nEl - e0 : WHERE_CMP_BLOCK;
+      WhereCompareBlock(op, bScalar, buf, a + e0, bScalar ? b : b + e0, nb);
+      for (SizeT k = 0; k * 64 < nb; ++k) {
+        SizeT n = nb - k * 64;
+        mask[w0 + k] = WhereMaskWord(buf + k * 64, (n < 64) ? n : 64);
+        count += __builtin_popcountll(mask[w0 + k]);
+      }
+    }
+    offset[c + 1] = count;
+  }
+  offset[0] = 0;
+  for (SizeT c = 0; c < nChunks; ++c) offset[c + 1] += offset[c];
+}
+
 #define Sp SpDByte
 #include "where_inc.cpp"
 #undef Sp
@@ -63,935 +266,17 @@
 #include "where_inc.cpp"
 #undef Sp
 
-template<>
-void Data_<SpDString>::Where(DLong* &ret, SizeT &passed_count, bool comp, DLong* &comp_ret) {
-  SizeT nEl=this->N_Elements();
- //code is optimized for 1 thread (no thread) and for presence or absence of complement.
-  int nchunk=(nEl >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= nEl))?CpuTPOOL_NTHREADS:1;
-  if (comp) {
-    if (nchunk==1) {
-      DLong* yes = (DLong*)MALLOC(nEl*sizeof(DLong)); 
-      DLong* no = (DLong*)MALLOC(nEl*sizeof(DLong)); 
-      // computational magic of 0 and 1 to keep ony 'good' indexes. 
-      SizeT countyes=0;
-      SizeT countno=0;
-      for (SizeT i=0; i<nEl; ++i) {
-        bool tmp=((*this)[i]!="");
-        yes[countyes]=i;
-        no[countno]=i;
-        countyes+=tmp;
-        countno+=(!tmp);
-      }
-      passed_count=countyes;
-      if (countyes) ret=(DLong*)REALLOC(yes,countyes * sizeof (DLong)); else {FREE(yes); ret=NULL;}
-      if (countno) comp_ret=(DLong*)REALLOC(no,countno * sizeof (DLong)); else {FREE(no); comp_ret=NULL;}
-      return;
-    } else {
-      SizeT chunksize = nEl / nchunk;
-      DLong* partyes[nchunk];
-      DLong* partno[nchunk];
-      SizeT partialCountYes[nchunk];
-      SizeT partialCountNo[nchunk];
-      #pragma omp parallel num_threads(nchunk) //shared(partialCount,part) //if (nEl >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= nEl))
-      {
-        int thread_id = currentThreadNumber();
-        SizeT start_index, stop_index;
-        start_index = thread_id * chunksize;
-        if (thread_id != nchunk-1) //robust wrt. use of threads or not.
-        {
-          stop_index = start_index + chunksize;
-        } else
-        {
-          stop_index = nEl;
-        }
-
-        SizeT space=(stop_index-start_index)*sizeof (DLong);
-        SizeT i=0;
-        //compute a [0] or [1] serie
-        // allocate thread's subset of final result
-        partyes[thread_id] = (DLong*)MALLOC(space*sizeof(DLong)); 
-        partno[thread_id] = (DLong*)MALLOC(space*sizeof(DLong)); 
-        // computational magic of 0 and 1 to keep ony 'good' indexes. 
-        SizeT local_count_yes=0;
-        SizeT local_count_no=0;
-        for (i=start_index; i<stop_index; ++i) {
-          bool tmp=((*this)[i]!="");
-          partyes[thread_id][local_count_yes]=i;
-          partno[thread_id][local_count_no]=i;
-          local_count_yes+=tmp;
-          local_count_no+=(!tmp);
-        }
-        partialCountYes[thread_id]=local_count_yes;
-        partialCountNo[thread_id]=local_count_no;
-      } //end parallel section
-      //total count is sum of partial counts:
-      SizeT countyes=0;
-      SizeT countno=0;
-      for (int iloop=0; iloop<nchunk; ++iloop) countyes+=partialCountYes[iloop];
-      for (int iloop=0; iloop<nchunk; ++iloop) countno+=partialCountNo[iloop];
-      // allocate final result
-      if (countyes>0) {
-        ret=(DLong*)MALLOC(countyes * sizeof (DLong)); //allocate, nozero
-        //fill in
-        SizeT running_index=0;
-        for (int iloop=0; iloop<nchunk; ++iloop) {
-          for (SizeT jj=0; jj<partialCountYes[iloop]; ++jj) ret[running_index++]=partyes[iloop][jj];
-        }
-      }
-      if (countno>0) {
-        comp_ret=(DLong*)MALLOC(countno * sizeof (DLong)); //allocate, nozero
-        //fill in
-        SizeT running_index=0;
-        for (int iloop=0; iloop<nchunk; ++iloop) {
-          for (SizeT jj=0; jj<partialCountNo[iloop]; ++jj) comp_ret[running_index++]=partno[iloop][jj];
-        }
-      }
-      passed_count=countyes;
-      //free temporary arrays.
-      for (int iloop=0; iloop<nchunk; ++iloop) {
-        FREE(partyes[iloop]);
-        FREE(partno[iloop]);
-      }
-    }
-  } else {
-    if (nchunk==1) {
-      DLong* yes = (DLong*)MALLOC(nEl*sizeof(DLong)); 
-      // computational magic of 0 and 1 to keep ony 'good' indexes. 
-      SizeT count=0;
-      for (SizeT i=0; i<nEl; ++i) {
-        bool tmp=((*this)[i]!="");
-        yes[count]=i;
-        count+=tmp;
-      }
-      passed_count=count;
-      if (count) ret=(DLong*)REALLOC(yes,count * sizeof (DLong)); else {FREE(yes); ret=NULL;}
-      return;
-    } else {
-      SizeT chunksize = nEl / nchunk;
-      DLong* part[nchunk];
-      SizeT partialCount[nchunk];
-      #pragma omp parallel num_threads(nchunk) //shared(partialCount,part) //if (nEl >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= nEl))
-      {
-        int thread_id = currentThreadNumber();
-        SizeT start_index, stop_index;
-        start_index = thread_id * chunksize;
-        if (thread_id != nchunk-1) //robust wrt. use of threads or not.
-        {
-          stop_index = start_index + chunksize;
-        } else
-        {
-          stop_index = nEl;
-        }
-
-        SizeT space=(stop_index-start_index)*sizeof (DLong);
-        SizeT i=0;
-        //compute a [0] or [1] serie
-        // allocate thread's subset of final result
-        part[thread_id] = (DLong*)MALLOC(space*sizeof(DLong)); 
-        // computational magic of 0 and 1 to keep ony 'good' indexes. 
-        SizeT local_count=0;
-        for (i=start_index; i<stop_index; ++i) {
-          bool tmp=((*this)[i]!="");
-          part[thread_id][local_count]=i;
-          local_count+=tmp;
-        }
-        partialCount[thread_id]=local_count;
-      } //end parallel section
-      //total count is sum of partial counts:
-      SizeT count=0;
-      for (int iloop=0; iloop<nchunk; ++iloop) count+=partialCount[iloop];
-      // allocate final result
-      if (count > 0) {
-        ret=(DLong*)MALLOC(count * sizeof (DLong)); //allocate, nozero
-        //fill in
-        SizeT running_index=0;
-        for (int iloop=0; iloop<nchunk; ++iloop) {
-          for (SizeT jj=0; jj<partialCount[iloop]; ++jj) ret[running_index++]=part[iloop][jj];
-        }
-      }
-      passed_count=count;
-      //free temporary arrays.
-      for (int iloop=0; iloop<nchunk; ++iloop) {
-        FREE(part[iloop]);
-      }
-    }
-  }
-}
-
-template<>
-void Data_<SpDString>::Where(DLong64* &ret, SizeT &passed_count, bool comp, DLong64* &comp_ret) {
-  SizeT nEl=this->N_Elements();
- //code is optimized for 1 thread (no thread) and for presence or absence of complement.
-  int nchunk=(nEl >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= nEl))?CpuTPOOL_NTHREADS:1;
-  if (comp) {
-    if (nchunk==1) {
-      DLong64* yes = (DLong64*)MALLOC(nEl*sizeof(DLong64)); 
-      DLong64* no = (DLong64*)MALLOC(nEl*sizeof(DLong64)); 
-      // computational magic of 0 and 1 to keep ony 'good' indexes. 
-      SizeT countyes=0;
-      SizeT countno=0;
-      for (SizeT i=0; i<nEl; ++i) {
-        bool tmp=((*this)[i]!="");
-        yes[countyes]=i;
-        no[countno]=i;
-        countyes+=tmp;
-        countno+=(!tmp);
-      }
-      passed_count=countyes;
-      if (countyes) ret=(DLong64*)REALLOC(yes,countyes * sizeof (DLong64)); else {FREE(yes); ret=NULL;}
-      if (countno) comp_ret=(DLong64*)REALLOC(no,countno * sizeof (DLong64)); else {FREE(no); comp_ret=NULL;}
-      return;
-    } else {
-      SizeT chunksize = nEl / nchunk;
-      DLong64* partyes[nchunk];
-      DLong64* partno[nchunk];
-      SizeT partialCountYes[nchunk];
-      SizeT partialCountNo[nchunk];
-      #pragma omp parallel num_threads(nchunk) //shared(partialCount,part) //if (nEl >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= nEl))
-      {
-        int thread_id = currentThreadNumber();
-        SizeT start_index, stop_index;
-        start_index = thread_id * chunksize;
-        if (thread_id != nchunk-1) //robust wrt. use of threads or not.
-        {
-          stop_index = start_index + chunksize;
-        } else
-        {
-          stop_index = nEl;
-        }
-
-        SizeT space=(stop_index-start_index)*sizeof (DLong64);
-        SizeT i=0;
-        //compute a [0] or [1] serie
-        // allocate thread's subset of final result
-        partyes[thread_id] = (DLong64*)MALLOC(space*sizeof(DLong64)); 
-        partno[thread_id] = (DLong64*)MALLOC(space*sizeof(DLong64)); 
-        // computational magic of 0 and 1 to keep ony 'good' indexes. 
-        SizeT local_count_yes=0;
-        SizeT local_count_no=0;
-        for (i=start_index; i<stop_index; ++i) {
-          bool tmp=((*this)[i]!="");
-          partyes[thread_id][local_count_yes]=i;
-          partno[thread_id][local_count_no]=i;
-          local_count_yes+=tmp;
-          local_count_no+=(!tmp);
-        }
-        partialCountYes[thread_id]=local_count_yes;
-        partialCountNo[thread_id]=local_count_no;
-      } //end parallel section
-      //total count is sum of partial counts:
-      SizeT countyes=0;
-      SizeT countno=0;
-      for (int iloop=0; iloop<nchunk; ++iloop) countyes+=partialCountYes[iloop];
-      for (int iloop=0; iloop<nchunk; ++iloop) countno+=partialCountNo[iloop];
-      // allocate final result
-      if (countyes>0) {
-        ret=(DLong64*)MALLOC(countyes * sizeof (DLong64)); //allocate, nozero
-        //fill in
-        SizeT running_index=0;
-        for (int iloop=0; iloop<nchunk; ++iloop) {
-          for (SizeT jj=0; jj<partialCountYes[iloop]; ++jj) ret[running_index++]=partyes[iloop][jj];
-        }
-      }
-      if (countno>0) {
-        comp_ret=(DLong64*)MALLOC(countno * sizeof (DLong64)); //allocate, nozero
-        //fill in
-        SizeT running_index=0;
-        for (int iloop=0; iloop<nchunk; ++iloop) {
-          for (SizeT jj=0; jj<partialCountNo[iloop]; ++jj) comp_ret[running_index++]=partno[iloop][jj];
-        }
-      }
-      passed_count=countyes;
-      //free temporary arrays.
-      for (int iloop=0; iloop<nchunk; ++iloop) {
-        FREE(partyes[iloop]);
-        FREE(partno[iloop]);
-      }
-    }
-  } else {
-    if (nchunk==1) {
-      DLong64* yes = (DLong64*)MALLOC(nEl*sizeof(DLong64)); 
-      // computational magic of 0 and 1 to keep ony 'good' indexes. 
-      SizeT count=0;
-      for (SizeT i=0; i<nEl; ++i) {
-        bool tmp=((*this)[i]!="");
-        yes[count]=i;
-        count+=tmp;
-      }
-      passed_count=count;
-      if (count) ret=(DLong64*)REALLOC(yes,count * sizeof (DLong64)); else {FREE(yes); ret=NULL;}
-      return;
-    } else {
-      SizeT chunksize = nEl / nchunk;
-      DLong64* part[nchunk];
-      SizeT partialCount[nchunk];
-      #pragma omp parallel num_threads(nchunk) //shared(partialCount,part) //if (nEl >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= nEl))
-      {
-        int thread_id = currentThreadNumber();
-        SizeT start_index, stop_index;
-        start_index = thread_id * chunksize;
-        if (thread_id != nchunk-1) //robust wrt. use of threads or not.
-        {
-          stop_index = start_index + chunksize;
-        } else
-        {
-          stop_index = nEl;
-        }
-
-        SizeT space=(stop_index-start_index)*sizeof (DLong64);
-        SizeT i=0;
-        //compute a [0] or [1] serie
-        // allocate thread's subset of final result
-        part[thread_id] = (DLong64*)MALLOC(space*sizeof(DLong64)); 
-        // computational magic of 0 and 1 to keep ony 'good' indexes. 
-        SizeT local_count=0;
-        for (i=start_index; i<stop_index; ++i) {
-          bool tmp=((*this)[i]!="");
-          part[thread_id][local_count]=i;
-          local_count+=tmp;
-        }
-        partialCount[thread_id]=local_count;
-      } //end parallel section
-      //total count is sum of partial counts:
-      SizeT count=0;
-      for (int iloop=0; iloop<nchunk; ++iloop) count+=partialCount[iloop];
-      // allocate final result
-      if (count > 0) {
-        ret=(DLong64*)MALLOC(count * sizeof (DLong64)); //allocate, nozero
-        //fill in
-        SizeT running_index=0;
-        for (int iloop=0; iloop<nchunk; ++iloop) {
-          for (SizeT jj=0; jj<partialCount[iloop]; ++jj) ret[running_index++]=part[iloop][jj];
-        }
-      }
-      passed_count=count;
-      //free temporary arrays.
-      for (int iloop=0; iloop<nchunk; ++iloop) {
-        FREE(part[iloop]);
-      }
-    }
-  }
-}
-
-template<>
-void Data_<SpDComplex>::Where(DLong* &ret, SizeT &passed_count, bool comp, DLong* &comp_ret) {
-  SizeT nEl=this->N_Elements();
- //code is optimized for 1 thread (no thread) and for presence or absence of complement.
-  int nchunk=(nEl >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= nEl))?CpuTPOOL_NTHREADS:1;
-  if (comp) {
-    if (nchunk==1) {
-      DLong* yes = (DLong*)MALLOC(nEl*sizeof(DLong)); 
-      DLong* no = (DLong*)MALLOC(nEl*sizeof(DLong)); 
-      // computational magic of 0 and 1 to keep ony 'good' indexes. 
-      SizeT countyes=0;
-      SizeT countno=0;
-      for (SizeT i=0; i<nEl; ++i) {
-        bool tmp=((*this)[i].real() && (*this)[i].imag()); //both needed
-        yes[countyes]=i;
-        no[countno]=i;
-        countyes+=tmp;
-        countno+=(!tmp);
-      }
-      passed_count=countyes;
-      if (countyes) ret=(DLong*)REALLOC(yes,countyes * sizeof (DLong)); else {FREE(yes); ret=NULL;}
-      if (countno) comp_ret=(DLong*)REALLOC(no,countno * sizeof (DLong)); else {FREE(no); comp_ret=NULL;}
-      return;
-    } else {
-      SizeT chunksize = nEl / nchunk;
-      DLong* partyes[nchunk];
-      DLong* partno[nchunk];
-      SizeT partialCountYes[nchunk];
-      SizeT partialCountNo[nchunk];
-      #pragma omp parallel num_threads(nchunk) //shared(partialCount,part) //if (nEl >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= nEl))
-      {
-        int thread_id = currentThreadNumber();
-        SizeT start_index, stop_index;
-        start_index = thread_id * chunksize;
-        if (thread_id != nchunk-1) //robust wrt. use of threads or not.
-        {
-          stop_index = start_index + chunksize;
-        } else
-        {
-          stop_index = nEl;
-        }
-
-        SizeT space=(stop_index-start_index)*sizeof (DLong);
-        SizeT i=0;
-        //compute a [0] or [1] serie
-        // allocate thread's subset of final result
-        partyes[thread_id] = (DLong*)MALLOC(space*sizeof(DLong)); 
-        partno[thread_id] = (DLong*)MALLOC(space*sizeof(DLong)); 
-        // computational magic of 0 and 1 to keep ony 'good' indexes. 
-        SizeT local_count_yes=0;
-        SizeT local_count_no=0;
-        for (i=start_index; i<stop_index; ++i) {
-          bool tmp=((*this)[i].real() && (*this)[i].imag()); //both needed
-          partyes[thread_id][local_count_yes]=i;
-          partno[thread_id][local_count_no]=i;
-          local_count_yes+=tmp;
-          local_count_no+=(!tmp);
-        }
-        partialCountYes[thread_id]=local_count_yes;
-        partialCountNo[thread_id]=local_count_no;
-      } //end parallel section
-      //total count is sum of partial counts:
-      SizeT countyes=0;
-      SizeT countno=0;
-      for (int iloop=0; iloop<nchunk; ++iloop) countyes+=partialCountYes[iloop];
-      for (int iloop=0; iloop<nchunk; ++iloop) countno+=partialCountNo[iloop];
-      // allocate final result
-      if (countyes>0) {
-        ret=(DLong*)MALLOC(countyes * sizeof (DLong)); //allocate, nozero
-        //fill in
-        SizeT running_index=0;
-        for (int iloop=0; iloop<nchunk; ++iloop) {
-          for (SizeT jj=0; jj<partialCountYes[iloop]; ++jj) ret[running_index++]=partyes[iloop][jj];
-        }
-      }
-      if (countno>0) {
-        comp_ret=(DLong*)MALLOC(countno * sizeof (DLong)); //allocate, nozero
-        //fill in
-        SizeT running_index=0;
-        for (int iloop=0; iloop<nchunk; ++iloop) {
-          for (SizeT jj=0; jj<partialCountNo[iloop]; ++jj) comp_ret[running_index++]=partno[iloop][jj];
-        }
-      }
-      passed_count=countyes;
-      //free temporary arrays.
-      for (int iloop=0; iloop<nchunk; ++iloop) {
-        FREE(partyes[iloop]);
-        FREE(partno[iloop]);
-      }
-    }
-  } else {
-    if (nchunk==1) {
-      DLong* yes = (DLong*)MALLOC(nEl*sizeof(DLong)); 
-      // computational magic of 0 and 1 to keep ony 'good' indexes. 
-      SizeT count=0;
-      for (SizeT i=0; i<nEl; ++i) {
-        bool tmp=((*this)[i].real() && (*this)[i].imag()); //both needed
-        yes[count]=i;
-        count+=tmp;
-      }
-      passed_count=count;
-      if (count) ret=(DLong*)REALLOC(yes,count * sizeof (DLong)); else {FREE(yes); ret=NULL;}
-      return;
-    } else {
-      SizeT chunksize = nEl / nchunk;
-      DLong* part[nchunk];
-      SizeT partialCount[nchunk];
-      #pragma omp parallel num_threads(nchunk) //shared(partialCount,part) //if (nEl >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= nEl))
-      {
-        int thread_id = currentThreadNumber();
-        SizeT start_index, stop_index;
-        start_index = thread_id * chunksize;
-        if (thread_id != nchunk-1) //robust wrt. use of threads or not.
-        {
-          stop_index = start_index + chunksize;
-        } else
-        {
-          stop_index = nEl;
-        }
-
-        SizeT space=(stop_index-start_index)*sizeof (DLong);
-        SizeT i=0;
-        //compute a [0] or [1] serie
-        // allocate thread's subset of final result
-        part[thread_id] = (DLong*)MALLOC(space*sizeof(DLong)); 
-        // computational magic of 0 and 1 to keep ony 'good' indexes. 
-        SizeT local_count=0;
-        for (i=start_index; i<stop_index; ++i) {
-          bool tmp=((*this)[i].real() && (*this)[i].imag()); //both needed
-          part[thread_id][local_count]=i;
-          local_count+=tmp;
-        }
-        partialCount[thread_id]=local_count;
-      } //end parallel section
-      //total count is sum of partial counts:
-      SizeT count=0;
-      for (int iloop=0; iloop<nchunk; ++iloop) count+=partialCount[iloop];
-      // allocate final result
-      if (count > 0) {
-        ret=(DLong*)MALLOC(count * sizeof (DLong)); //allocate, nozero
-        //fill in
-        SizeT running_index=0;
-        for (int iloop=0; iloop<nchunk; ++iloop) {
-          for (SizeT jj=0; jj<partialCount[iloop]; ++jj) ret[running_index++]=part[iloop][jj];
-        }
-      }
-      passed_count=count;
-      //free temporary arrays.
-      for (int iloop=0; iloop<nchunk; ++iloop) {
-        FREE(part[iloop]);
-      }
-    }
-  }
-}
-
-template<>
-void Data_<SpDComplex>::Where(DLong64* &ret, SizeT &passed_count, bool comp, DLong64* &comp_ret) {
-  SizeT nEl=this->N_Elements();
- //code is optimized for 1 thread (no thread) and for presence or absence of complement.
-  int nchunk=(nEl >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= nEl))?CpuTPOOL_NTHREADS:1;
-  if (comp) {
-    if (nchunk==1) {
-      DLong64* yes = (DLong64*)MALLOC(nEl*sizeof(DLong64)); 
-      DLong64* no = (DLong64*)MALLOC(nEl*sizeof(DLong64)); 
-      // computational magic of 0 and 1 to keep ony 'good' indexes. 
-      SizeT countyes=0;
-      SizeT countno=0;
-      for (SizeT i=0; i<nEl; ++i) {
-        bool tmp=((*this)[i].real() && (*this)[i].imag()); //both needed
-        yes[countyes]=i;
-        no[countno]=i;
-        countyes+=tmp;
-        countno+=(!tmp);
-      }
-      passed_count=countyes;
-      if (countyes) ret=(DLong64*)REALLOC(yes,countyes * sizeof (DLong64)); else {FREE(yes); ret=NULL;}
-      if (countno) comp_ret=(DLong64*)REALLOC(no,countno * sizeof (DLong64)); else {FREE(no); comp_ret=NULL;}
-      return;
-    } else {
-      SizeT chunksize = nEl / nchunk;
-      DLong64* partyes[nchunk];
-      DLong64* partno[nchunk];
-      SizeT partialCountYes[nchunk];
-      SizeT partialCountNo[nchunk];
-      #pragma omp parallel num_threads(nchunk) //shared(partialCount,part) //if (nEl >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= nEl))
-      {
-        int thread_id = currentThreadNumber();
-        SizeT start_index, stop_index;
-        start_index = thread_id * chunksize;
-        if (thread_id != nchunk-1) //robust wrt. use of threads or not.
-        {
-          stop_index = start_index + chunksize;
-        } else
-        {
-          stop_index = nEl;
-        }
-
-        SizeT space=(stop_index-start_index)*sizeof (DLong64);
-        SizeT i=0;
-        //compute a [0] or [1] serie
-        // allocate thread's subset of final result
-        partyes[thread_id] = (DLong64*)MALLOC(space*sizeof(DLong64)); 
-        partno[thread_id] = (DLong64*)MALLOC(space*sizeof(DLong64)); 
-        // computational magic of 0 and 1 to keep ony 'good' indexes. 
-        SizeT local_count_yes=0;
-        SizeT local_count_no=0;
-        for (i=start_index; i<stop_index; ++i) {
-          bool tmp=((*this)[i].real() && (*this)[i].imag()); //both needed
-          partyes[thread_id][local_count_yes]=i;
-          partno[thread_id][local_count_no]=i;
-          local_count_yes+=tmp;
-          local_count_no+=(!tmp);
-        }
-        partialCountYes[thread_id]=local_count_yes;
-        partialCountNo[thread_id]=local_count_no;
-      } //end parallel section
-      //total count is sum of partial counts:
-      SizeT countyes=0;
-      SizeT countno=0;
-      for (int iloop=0; iloop<nchunk; ++iloop) countyes+=partialCountYes[iloop];
-      for (int iloop=0; iloop<nchunk; ++iloop) countno+=partialCountNo[iloop];
-      // allocate final result
-      if (countyes>0) {
-        ret=(DLong64*)MALLOC(countyes * sizeof (DLong64)); //allocate, nozero
-        //fill in
-        SizeT running_index=0;
-        for (int iloop=0; iloop<nchunk; ++iloop) {
-          for (SizeT jj=0; jj<partialCountYes[iloop]; ++jj) ret[running_index++]=partyes[iloop][jj];
-        }
-      }
-      if (countno>0) {
-        comp_ret=(DLong64*)MALLOC(countno * sizeof (DLong64)); //allocate, nozero
-        //fill in
-        SizeT running_index=0;
-        for (int iloop=0; iloop<nchunk; ++iloop) {
-          for (SizeT jj=0; jj<partialCountNo[iloop]; ++jj) comp_ret[running_index++]=partno[iloop][jj];
-        }
-      }
-      passed_count=countyes;
-      //free temporary arrays.
-      for (int iloop=0; iloop<nchunk; ++iloop) {
-        FREE(partyes[iloop]);
-        FREE(partno[iloop]);
-      }
-    }
-  } else {
-    if (nchunk==1) {
-      DLong64* yes = (DLong64*)MALLOC(nEl*sizeof(DLong64)); 
-      // computational magic of 0 and 1 to keep ony 'good' indexes. 
-      SizeT count=0;
-      for (SizeT i=0; i<nEl; ++i) {
-        bool tmp=((*this)[i].real() && (*this)[i].imag()); //both needed
-        yes[count]=i;
-        count+=tmp;
-      }
-      passed_count=count;
-      if (count) ret=(DLong64*)REALLOC(yes,count * sizeof (DLong64)); else {FREE(yes); ret=NULL;}
-      return;
-    } else {
-      SizeT chunksize = nEl / nchunk;
-      DLong64* part[nchunk];
-      SizeT partialCount[nchunk];
-      #pragma omp parallel num_threads(nchunk) //shared(partialCount,part) //if (nEl >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= nEl))
-      {
-        int thread_id = currentThreadNumber();
-        SizeT start_index, stop_index;
-        start_index = thread_id * chunksize;
-        if (thread_id != nchunk-1) //robust wrt. use of threads or not.
-        {
-          stop_index = start_index + chunksize;
-        } else
-        {
-          stop_index = nEl;
-        }
-
-        SizeT space=(stop_index-start_index)*sizeof (DLong64);
-        SizeT i=0;
-        //compute a [0] or [1] serie
-        // allocate thread's subset of final result
-        part[thread_id] = (DLong64*)MALLOC(space*sizeof(DLong64)); 
-        // computational magic of 0 and 1 to keep ony 'good' indexes. 
-        SizeT local_count=0;
-        for (i=start_index; i<stop_index; ++i) {
-          bool tmp=((*this)[i].real() && (*this)[i].imag()); //both needed
-          part[thread_id][local_count]=i;
-          local_count+=tmp;
-        }
-        partialCount[thread_id]=local_count;
-      } //end parallel section
-      //total count is sum of partial counts:
-      SizeT count=0;
-      for (int iloop=0; iloop<nchunk; ++iloop) count+=partialCount[iloop];
-      // allocate final result
-      if (count > 0) {
-        ret=(DLong64*)MALLOC(count * sizeof (DLong64)); //allocate, nozero
-        //fill in
-        SizeT running_index=0;
-        for (int iloop=0; iloop<nchunk; ++iloop) {
-          for (SizeT jj=0; jj<partialCount[iloop]; ++jj) ret[running_index++]=part[iloop][jj];
-        }
-      }
-      passed_count=count;
-      //free temporary arrays.
-      for (int iloop=0; iloop<nchunk; ++iloop) {
-        FREE(part[iloop]);
-      }
-    }
-  }
-}
+#define Sp SpDString
+#include "where_inc.cpp"
+#undef Sp
 
-template<>
-void Data_<SpDComplexDbl>::Where(DLong* &ret, SizeT &passed_count, bool comp, DLong* &comp_ret) {
-  SizeT nEl=this->N_Elements();
- //code is optimized for 1 thread (no thread) and for presence or absence of complement.
-  int nchunk=(nEl >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= nEl))?CpuTPOOL_NTHREADS:1;
-  if (comp) {
-    if (nchunk==1) {
-      DLong* yes = (DLong*)MALLOC(nEl*sizeof(DLong)); 
-      DLong* no = (DLong*)MALLOC(nEl*sizeof(DLong)); 
-      // computational magic of 0 and 1 to keep ony 'good' indexes. 
-      SizeT countyes=0;
-      SizeT countno=0;
-      for (SizeT i=0; i<nEl; ++i) {
-        bool tmp=((*this)[i].real() && (*this)[i].imag()); //both needed
-        yes[countyes]=i;
-        no[countno]=i;
-        countyes+=tmp;
-        countno+=(!tmp);
-      }
-      passed_count=countyes;
-      if (countyes) ret=(DLong*)REALLOC(yes,countyes * sizeof (DLong)); else {FREE(yes); ret=NULL;}
-      if (countno) comp_ret=(DLong*)REALLOC(no,countno * sizeof (DLong)); else {FREE(no); comp_ret=NULL;}
-      return;
-    } else {
-      SizeT chunksize = nEl / nchunk;
-      DLong* partyes[nchunk];
-      DLong* partno[nchunk];
-      SizeT partialCountYes[nchunk];
-      SizeT partialCountNo[nchunk];
-      #pragma omp parallel num_threads(nchunk) //shared(partialCount,part) //if (nEl >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= nEl))
-      {
-        int thread_id = currentThreadNumber();
-        SizeT start_index, stop_index;
-        start_index = thread_id * chunksize;
-        if (thread_id != nchunk-1) //robust wrt. use of threads or not.
-        {
-          stop_index = start_index + chunksize;
-        } else
-        {
-          stop_index = nEl;
-        }
-
-        SizeT space=(stop_index-start_index)*sizeof (DLong);
-        SizeT i=0;
-        //compute a [0] or [1] serie
-        // allocate thread's subset of final result
-        partyes[thread_id] = (DLong*)MALLOC(space*sizeof(DLong)); 
-        partno[thread_id] = (DLong*)MALLOC(space*sizeof(DLong)); 
-        // computational magic of 0 and 1 to keep ony 'good' indexes. 
-        SizeT local_count_yes=0;
-        SizeT local_count_no=0;
-        for (i=start_index; i<stop_index; ++i) {
-          bool tmp=((*this)[i].real() && (*this)[i].imag()); //both needed
-          partyes[thread_id][local_count_yes]=i;
-          partno[thread_id][local_count_no]=i;
-          local_count_yes+=tmp;
-          local_count_no+=(!tmp);
-        }
-        partialCountYes[thread_id]=local_count_yes;
-        partialCountNo[thread_id]=local_count_no;
-      } //end parallel section
-      //total count is sum of partial counts:
-      SizeT countyes=0;
-      SizeT countno=0;
-      for (int iloop=0; iloop<nchunk; ++iloop) countyes+=partialCountYes[iloop];
-      for (int iloop=0; iloop<nchunk; ++iloop) countno+=partialCountNo[iloop];
-      // allocate final result
-      if (countyes>0) {
-        ret=(DLong*)MALLOC(countyes * sizeof (DLong)); //allocate, nozero
-        //fill in
-        SizeT running_index=0;
-        for (int iloop=0; iloop<nchunk; ++iloop) {
-          for (SizeT jj=0; jj<partialCountYes[iloop]; ++jj) ret[running_index++]=partyes[iloop][jj];
-        }
-      }
-      if (countno>0) {
-        comp_ret=(DLong*)MALLOC(countno * sizeof (DLong)); //allocate, nozero
-        //fill in
-        SizeT running_index=0;
-        for (int iloop=0; iloop<nchunk; ++iloop) {
-          for (SizeT jj=0; jj<partialCountNo[iloop]; ++jj) comp_ret[running_index++]=partno[iloop][jj];
-        }
-      }
-      passed_count=countyes;
-      //free temporary arrays.
-      for (int iloop=0; iloop<nchunk; ++iloop) {
-        FREE(partyes[iloop]);
-        FREE(partno[iloop]);
-      }
-    }
-  } else {
-    if (nchunk==1) {
-      DLong* yes = (DLong*)MALLOC(nEl*sizeof(DLong)); 
-      // computational magic of 0 and 1 to keep ony 'good' indexes. 
-      SizeT count=0;
-      for (SizeT i=0; i<nEl; ++i) {
-        bool tmp=((*this)[i].real() && (*this)[i].imag()); //both needed
-        yes[count]=i;
-        count+=tmp;
-      }
-      passed_count=count;
-      if (count) ret=(DLong*)REALLOC(yes,count * sizeof (DLong)); else {FREE(yes); ret=NULL;}
-      return;
-    } else {
-      SizeT chunksize = nEl / nchunk;
-      DLong* part[nchunk];
-      SizeT partialCount[nchunk];
-      #pragma omp parallel num_threads(nchunk) //shared(partialCount,part) //if (nEl >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= nEl))
-      {
-        int thread_id = currentThreadNumber();
-        SizeT start_index, stop_index;
-        start_index = thread_id * chunksize;
-        if (thread_id != nchunk-1) //robust wrt. use of threads or not.
-        {
-          stop_index = start_index + chunksize;
-        } else
-        {
-          stop_index = nEl;
-        }
-
-        SizeT space=(stop_index-start_index)*sizeof (DLong);
-        SizeT i=0;
-        //compute a [0] or [1] serie
-        // allocate thread's subset of final result
-        part[thread_id] = (DLong*)MALLOC(space*sizeof(DLong)); 
-        // computational magic of 0 and 1 to keep ony 'good' indexes. 
-        SizeT local_count=0;
-        for (i=start_index; i<stop_index; ++i) {
-          bool tmp=((*this)[i].real() && (*this)[i].imag()); //both needed
-          part[thread_id][local_count]=i;
-          local_count+=tmp;
-        }
-        partialCount[thread_id]=local_count;
-      } //end parallel section
-      //total count is sum of partial counts:
-      SizeT count=0;
-      for (int iloop=0; iloop<nchunk; ++iloop) count+=partialCount[iloop];
-      // allocate final result
-      if (count > 0) {
-        ret=(DLong*)MALLOC(count * sizeof (DLong)); //allocate, nozero
-        //fill in
-        SizeT running_index=0;
-        for (int iloop=0; iloop<nchunk; ++iloop) {
-          for (SizeT jj=0; jj<partialCount[iloop]; ++jj) ret[running_index++]=part[iloop][jj];
-        }
-      }
-      passed_count=count;
-      //free temporary arrays.
-      for (int iloop=0; iloop<nchunk; ++iloop) {
-        FREE(part[iloop]);
-      }
-    }
-  }
-}
+#define Sp SpDComplex
+#include "where_inc.cpp"
+#undef Sp
 
-template<>
-void Data_<SpDComplexDbl>::Where(DLong64* &ret, SizeT &passed_count, bool comp, DLong64* &comp_ret) {
-  SizeT nEl=this->N_Elements();
- //code is optimized for 1 thread (no thread) and for presence or absence of complement.
-  int nchunk=(nEl >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= nEl))?CpuTPOOL_NTHREADS:1;
-  if (comp) {
-    if (nchunk==1) {
-      DLong64* yes = (DLong64*)MALLOC(nEl*sizeof(DLong64)); 
-      DLong64* no = (DLong64*)MALLOC(nEl*sizeof(DLong64)); 
-      // computational magic of 0 and 1 to keep ony 'good' indexes. 
-      SizeT countyes=0;
-      SizeT countno=0;
-      for (SizeT i=0; i<nEl; ++i) {
-        bool tmp=((*this)[i].real() && (*this)[i].imag()); //both needed
-        yes[countyes]=i;
-        no[countno]=i;
-        countyes+=tmp;
-        countno+=(!tmp);
-      }
-      passed_count=countyes;
-      if (countyes) ret=(DLong64*)REALLOC(yes,countyes * sizeof (DLong64)); else {FREE(yes); ret=NULL;}
-      if (countno) comp_ret=(DLong64*)REALLOC(no,countno * sizeof (DLong64)); else {FREE(no); comp_ret=NULL;}
-      return;
-    } else {
-      SizeT chunksize = nEl / nchunk;
-      DLong64* partyes[nchunk];
-      DLong64* partno[nchunk];
-      SizeT partialCountYes[nchunk];
-      SizeT partialCountNo[nchunk];
-      #pragma omp parallel num_threads(nchunk) //shared(partialCount,part) //if (nEl >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= nEl))
-      {
-        int thread_id = currentThreadNumber();
-        SizeT start_index, stop_index;
-        start_index = thread_id * chunksize;
-        if (thread_id != nchunk-1) //robust wrt. use of threads or not.
-        {
-          stop_index = start_index + chunksize;
-        } else
-        {
-          stop_index = nEl;
-        }
-
-        SizeT space=(stop_index-start_index)*sizeof (DLong64);
-        SizeT i=0;
-        //compute a [0] or [1] serie
-        // allocate thread's subset of final result
-        partyes[thread_id] = (DLong64*)MALLOC(space*sizeof(DLong64)); 
-        partno[thread_id] = (DLong64*)MALLOC(space*sizeof(DLong64)); 
-        // computational magic of 0 and 1 to keep ony 'good' indexes. 
-        SizeT local_count_yes=0;
-        SizeT local_count_no=0;
-        for (i=start_index; i<stop_index; ++i) {
-          bool tmp=((*this)[i].real() && (*this)[i].imag()); //both needed
-          partyes[thread_id][local_count_yes]=i;
-          partno[thread_id][local_count_no]=i;
-          local_count_yes+=tmp;
-          local_count_no+=(!tmp);
-        }
-        partialCountYes[thread_id]=local_count_yes;
-        partialCountNo[thread_id]=local_count_no;
-      } //end parallel section
-      //total count is sum of partial counts:
-      SizeT countyes=0;
-      SizeT countno=0;
-      for (int iloop=0; iloop<nchunk; ++iloop) countyes+=partialCountYes[iloop];
-      for (int iloop=0; iloop<nchunk; ++iloop) countno+=partialCountNo[iloop];
-      // allocate final result
-      if (countyes>0) {
-        ret=(DLong64*)MALLOC(countyes * sizeof (DLong64)); //allocate, nozero
-        //fill in
-        SizeT running_index=0;
-        for (int iloop=0; iloop<nchunk; ++iloop) {
-          for (SizeT jj=0; jj<partialCountYes[iloop]; ++jj) ret[running_index++]=partyes[iloop][jj];
-        }
-      }
-      if (countno>0) {
-        comp_ret=(DLong64*)MALLOC(countno * sizeof (DLong64)); //allocate, nozero
-        //fill in
-        SizeT running_index=0;
-        for (int iloop=0; iloop<nchunk; ++iloop) {
-          for (SizeT jj=0; jj<partialCountNo[iloop]; ++jj) comp_ret[running_index++]=partno[iloop][jj];
-        }
-      }
-      passed_count=countyes;
-      //free temporary arrays.
-      for (int iloop=0; iloop<nchunk; ++iloop) {
-        FREE(partyes[iloop]);
-        FREE(partno[iloop]);
-      }
-    }
-  } else {
-    if (nchunk==1) {
-      DLong64* yes = (DLong64*)MALLOC(nEl*sizeof(DLong64)); 
-      // computational magic of 0 and 1 to keep ony 'good' indexes. 
-      SizeT count=0;
-      for (SizeT i=0; i<nEl; ++i) {
-        bool tmp=((*this)[i].real() && (*this)[i].imag()); //both needed
-        yes[count]=i;
-        count+=tmp;
-      }
-      passed_count=count;
-      if (count) ret=(DLong64*)REALLOC(yes,count * sizeof (DLong64)); else {FREE(yes); ret=NULL;}
-      return;
-    } else {
-      SizeT chunksize = nEl / nchunk;
-      DLong64* part[nchunk];
-      SizeT partialCount[nchunk];
-      #pragma omp parallel num_threads(nchunk) //shared(partialCount,part) //if (nEl >= CpuTPOOL_MIN_ELTS && (CpuTPOOL_MAX_ELTS == 0 || CpuTPOOL_MAX_ELTS <= nEl))
-      {
-        int thread_id = currentThreadNumber();
-        SizeT start_index, stop_index;
-        start_index = thread_id * chunksize;
-        if (thread_id != nchunk-1) //robust wrt. use of threads or not.
-        {
-          stop_index = start_index + chunksize;
-        } else
-        {
-          stop_index = nEl;
-        }
-
-        SizeT space=(stop_index-start_index)*sizeof (DLong64);
-        SizeT i=0;
-        //compute a [0] or [1] serie
-        // allocate thread's subset of final result
-        part[thread_id] = (DLong64*)MALLOC(space*sizeof(DLong64)); 
-        // computational magic of 0 and 1 to keep ony 'good' indexes. 
-        SizeT local_count=0;
-        for (i=start_index; i<stop_index; ++i) {
-          bool tmp=((*this)[i].real() && (*this)[i].imag()); //both needed
-          part[thread_id][local_count]=i;
-          local_count+=tmp;
-        }
-        partialCount[thread_id]=local_count;
-      } //end parallel section
-      //total count is sum of partial counts:
-      SizeT count=0;
-      for (int iloop=0; iloop<nchunk; ++iloop) count+=partialCount[iloop];
-      // allocate final result
-      if (count > 0) {
-        ret=(DLong64*)MALLOC(count * sizeof (DLong64)); //allocate, nozero
-        //fill in
-        SizeT running_index=0;
-        for (int iloop=0; iloop<nchunk; ++iloop) {
-          for (SizeT jj=0; jj<partialCount[iloop]; ++jj) ret[running_index++]=part[iloop][jj];
-        }
-      }
-      passed_count=count;
-      //free temporary arrays.
-      for (int iloop=0; iloop<nchunk; ++iloop) {
-        FREE(part[iloop]);
-      }
-    }
-  }
-}
+#define Sp SpDComplexDbl
+#include "where_inc.cpp"
+#undef Sp
 
 template<>
 void Data_<SpDPtr>::Where(DLong* &ret, SizeT &passed_count, bool comp, DLong* &comp_ret){
@@ -1012,11 +297,158 @@ void Data_<SpDObj>::Where(DLong64* &ret, SizeT &passed_count, bool comp, DLong64
 }
 
 
+// a[WHERE(cond)]=src (see lib::where_assign): the mask of cond is built as
+// for WHERE, then src[0], or the successive elements of src, are stored at
+// the true elements of each chunk, without index array.
+static bool WhereMaskable(DType t) {
+  return NumericType(t) || t == GDL_STRING;
+}
+
+static void WhereMaskOf(BaseGDL* p, uint64_t* mask, SizeT* offset, bool parallel) {
+  SizeT nEl = p->N_Elements();
+  void* d = p->DataAddr();
+  switch (p->Type()) {
+  case GDL_BYTE: WhereMaskPass(static_cast<DByte*> (d), nEl, mask, offset, parallel); break;
+  case GDL_INT: WhereMaskPass(static_cast<DInt*> (d), nEl, mask, offset, parallel); break;
+  case GDL_UINT: WhereMaskPass(static_cast<DUInt*> (d), nEl, mask, offset, parallel); break;
+  case GDL_LONG: WhereMaskPass(static_cast<DLong*> (d), nEl, mask, offset, parallel); break;
+  case GDL_ULONG: WhereMaskPass(static_cast<DULong*> (d), nEl, mask, offset, parallel); break;
+  case GDL_LONG64: WhereMaskPass(static_cast<DLong64*> (d), nEl, mask, offset, parallel); break;
+  case GDL_ULONG64: WhereMaskPass(static_cast<DULong64*> (d), nEl, mask, offset, parallel); break;
+  case GDL_FLOAT: WhereMaskPass(static_cast<DFloat*> (d), nEl, mask, offset, parallel); break;
+  case GDL_DOUBLE: WhereMaskPass(static_cast<DDouble*> (d), nEl, mask, offset, parallel); break;
+  case GDL_COMPLEX: WhereMaskPass(static_cast<DComplex*> (d), nEl, mask, offset, parallel); break;
+  case GDL_COMPLEXDBL: WhereMaskPass(static_cast<DComplexDbl*> (d), nEl, mask, offset, parallel); break;
+  case GDL_STRING: WhereMaskPass(static_cast<DString*> (d), nEl, mask, offset, parallel); break;
+  default: assert(false);
+  }
+}
+
+template<typename Ty>
+static void WhereStorePass(Ty* var, const Ty* src, bool scalar, SizeT nEl, const uint64_t* mask, const SizeT* offset, bool parallel) {
+  SizeT nWords = (nEl + 63) / 64;
+  SizeT nChunks = WhereMaskChunks(nEl);
+#pragma omp parallel for if (parallel)
+  for (OMPInt c = 0; c < nChunks; ++c) {
+    SizeT w1 = (c + 1) * WHERE_CHUNK_WORDS;
+    if (w1 > nWords) w1 = nWords;
+    if (scalar) {
+      const Ty v = src[0];
+      for (SizeT w = c * WHERE_CHUNK_WORDS; w < w1; ++w)
+        for (uint64_t m = mask[w]; m != 0; m &= m - 1) var[w * 64 + __builtin_ctzll(m)] = v;
+    } else {
+      const Ty* s = src + offset[c];
+      for (SizeT w = c * WHERE_CHUNK_WORDS; w < w1; ++w)
+        for (uint64_t m = mask[w]; m != 0; m &= m - 1) var[w * 64 + __builtin_ctzll(m)] = *s++;
+    }
+  }
+}
+
+static void WhereStoreOf(BaseGDL* var, BaseGDL* src, SizeT nEl, const uint64_t* mask, const SizeT* offset, bool parallel) {
+  void* v = var->DataAddr();
+  void* s = src->DataAddr();
+  bool scalar = (src->N_Elements() == 1);
+  switch (var->Type()) {
+  case GDL_BYTE: WhereStorePass(static_cast<DByte*> (v), static_cast<DByte*> (s), scalar, nEl, mask, offset, parallel); break;
+  case GDL_INT: WhereStorePass(static_cast<DInt*> (v), static_cast<DInt*> (s), scalar, nEl, mask, offset, parallel); break;
+  case GDL_UINT: WhereStorePass(static_cast<DUInt*> (v), static_cast<DUInt*> (s), scalar, nEl, mask, offset, parallel); break;
+  case GDL_LONG: WhereStorePass(static_cast<DLong*> (v), static_cast<DLong*> (s), scalar, nEl, mask, offset, parallel); break;
+  case GDL_ULONG: WhereStorePass(static_cast<DULong*> (v), static_cast<DULong*> (s), scalar, nEl, mask, offset, parallel); break;
+  case GDL_LONG64: WhereStorePass(static_cast<DLong64*> (v), static_cast<DLong64*> (s), scalar, nEl, mask, offset, parallel); break;
+  case GDL_ULONG64: WhereStorePass(static_cast<DULong64*> (v), static_cast<DULong64*> (s), scalar, nEl, mask, offset, parallel); break;
+  case GDL_FLOAT: WhereStorePass(static_cast<DFloat*> (v), static_cast<DFloat*> (s), scalar, nEl, mask, offset, parallel); break;
+  case GDL_DOUBLE: WhereStorePass(static_cast<DDouble*> (v), static_cast<DDouble*> (s), scalar, nEl, mask, offset, parallel); break;
+  case GDL_COMPLEX: WhereStorePass(static_cast<DComplex*> (v), static_cast<DComplex*> (s), scalar, nEl, mask, offset, parallel); break;
+  case GDL_COMPLEXDBL: WhereStorePass(static_cast<DComplexDbl*> (v), static_cast<DComplexDbl*> (s), scalar, nEl, mask, offset, parallel); break;
+  case GDL_STRING: WhereStorePass(static_cast<DString*> (v), static_cast<DString*> (s), scalar, nEl, mask, offset, parallel); break;
+  default: assert(false);
+  }
+}
+
+static void WhereCompareOf(SimdCmpOp op, BaseGDL* a, BaseGDL* b, bool bScalar, SizeT nEl, uint64_t* mask, SizeT* offset, bool parallel) {
+  void* pa = a->DataAddr();
+  void* pb = b->DataAddr();
+  switch (a->Type()) {
+  case GDL_BYTE: WhereCompareMaskPass(op, static_cast<DByte*> (pa), static_cast<DByte*> (pb), bScalar, nEl, mask, offset, parallel); break;
+  case GDL_INT: WhereCompareMaskPass(op, static_cast<DInt*> (pa), static_cast<DInt*> (pb), bScalar, nEl, mask, offset, parallel); break;
+  case GDL_UINT: WhereCompareMaskPass(op, static_cast<DUInt*> (pa), static_cast<DUInt*> (pb), bScalar, nEl, mask, offset, parallel); break;
+  case GDL_LONG: WhereCompareMaskPass(op, static_cast<DLong*> (pa), static_cast<DLong*> (pb), bScalar, nEl, mask, offset, parallel); break;
+  case GDL_ULONG: WhereCompareMaskPass(op, static_cast<DULong*> (pa), static_cast<DULong*> (pb), bScalar, nEl, mask, offset, parallel); break;
+  case GDL_LONG64: WhereCompareMaskPass(op, static_cast<DLong64*> (pa), static_cast<DLong64*> (pb), bScalar, nEl, mask, offset, parallel); break;
+  case GDL_ULONG64: WhereCompareMaskPass(op, static_cast<DULong64*> (pa), static_cast<DULong64*> (pb), bScalar, nEl, mask, offset, parallel); break;
+  case GDL_FLOAT: WhereCompareMaskPass(op, static_cast<DFloat*> (pa), static_cast<DFloat*> (pb), bScalar, nEl, mask, offset, parallel); break;
+  case GDL_DOUBLE: WhereCompareMaskPass(op, static_cast<DDouble*> (pa), static_cast<DDouble*> (pb), bScalar, nEl, mask, offset, parallel); break;
+  default: assert(false);
+  }
+}
+
 #include "where.hpp"
 namespace lib {
 
+  WhereMaskT::WhereMaskT(SizeT n) : nEl(n), parallel(WhereParallel(n)), scalar(false) {
+    mask = (uint64_t*) MALLOC(((n + 63) / 64) * sizeof (uint64_t));
+    offset = (SizeT*) MALLOC((WhereMaskChunks(n) + 1) * sizeof (SizeT));
+  }
+
+  WhereMaskT::~WhereMaskT() {
+    FREE(offset);
+    FREE(mask);
+  }
+
+  // sets the results of WHERE in e from the count true elements at ret and
+  // the false ones at comp_ret (both taken over), returns the first one
+  template<typename IxGDL>
+  static BaseGDL* WhereReturn(EnvT* e, SizeT nEl, SizeT count, typename IxGDL::Ty* ret, typename IxGDL::Ty* comp_ret) {
+    SizeT nParam = e->NParam(1);
+
+    static int nullIx = e->KeywordIx("NULL");
+    bool nullKW = e->KeywordSet(nullIx);
+
+    SizeT nCount = nEl - count;
+
+    if (e->KeywordPresent(0)) // COMPLEMENT
+    {
+      if (nCount == 0) {
+        if (nullKW)
+          e->SetKW(0, NullGDL::GetSingleInstance());
+        else
+          e->SetKW(0, new DLongGDL(-1));
+      } else {
+        IxGDL* cRet=new IxGDL(dimension(nCount),BaseGDL::NOALLOC); //danger!!
+        cRet->SetBuffer((void*)comp_ret);
+        cRet->SetBufferSize(nCount);
+        cRet->SetDim(dimension(nCount));
+        e->SetKW(0, cRet);
+      }
+    }
+
+    if (e->KeywordPresent(1)) // NCOMPLEMENT
+    {
+      e->SetKW(1, new IxGDL(nCount));
+    }
+
+    if (nParam == 2) {
+      e->SetPar(1, new IxGDL(count));
+    }
+    //The system variable !ERR is set to the number of nonzero elements for compatibility with old versions of IDL
+    DVar *err = FindInVarList(sysVarList, "ERR");
+    (static_cast<DLongGDL*> (err->Data()))[0] = count; //thus, not a DLong64!
+
+    if (count == 0) {
+      if (nullKW) {
+        return NullGDL::GetSingleInstance();
+      }
+      return new DLongGDL(-1);
+    }
+    IxGDL* res=new IxGDL(dimension(count),BaseGDL::NOALLOC);
+    res->SetBuffer((void*)ret);
+    res->SetBufferSize(count);
+    res->SetDim(dimension(count));
+    return res;
+  }
+
   BaseGDL* where_fun(EnvT* e) {
-    SizeT nParam = e->NParam(1); //, "WHERE");
+    e->NParam(1); //, "WHERE");
 
     BaseGDL* p0 = e->GetParDefined( 0);//, "WHERE");
 
@@ -1024,9 +456,6 @@ namespace lib {
 
     SizeT count;
 
-    static int nullIx = e->KeywordIx("NULL");
-    bool nullKW = e->KeywordSet(nullIx);
-    
     static int l64Ix = e->KeywordIx("L64");
     bool doL64 = e->KeywordSet(l64Ix);
     doL64 = ( doL64 || nEl > std::numeric_limits<DLong>::max() ); //not tested!
@@ -1035,95 +464,153 @@ namespace lib {
       DLong* comp_ret=NULL;
 
       p0->Where(ret, count, e->KeywordPresent(0), comp_ret);
+      return WhereReturn<DLongGDL>(e, nEl, count, ret, comp_ret);
+    } else {
+      DLong64* ret=NULL;
+      DLong64* comp_ret=NULL;
 
-      SizeT nCount = nEl - count;
-
-      if (e->KeywordPresent(0)) // COMPLEMENT
-      {
-        if (nCount == 0) {
-          if (nullKW)
-            e->SetKW(0, NullGDL::GetSingleInstance());
-          else
-            e->SetKW(0, new DLongGDL(-1));
-        } else {
-          DLongGDL* cRet=new DLongGDL(dimension(nCount),BaseGDL::NOALLOC); //danger!!
-          cRet->SetBuffer((void*)comp_ret);
-          cRet->SetBufferSize(nCount);
-          cRet->SetDim(dimension(nCount));
-          e->SetKW(0, cRet);
-        }
-      }
+      p0->Where(ret, count, e->KeywordPresent(0), comp_ret);
+      return WhereReturn<DLong64GDL>(e, nEl, count, ret, comp_ret);
+    }
+  }
 
-      if (e->KeywordPresent(1)) // NCOMPLEMENT
-      {
-        e->SetKW(1, new DLongGDL(nCount));
-      }
+  // as where_fun(), the condition being already reduced to its mask m
+  BaseGDL* where_mask_fun(EnvT* e, WhereMaskT* m) {
+    SizeT nEl = m->nEl;
+    SizeT count;
+    bool comp = e->KeywordPresent(0);
 
-      if (nParam == 2) {
-        e->SetPar(1, new DLongGDL(count));
-      }
-      //The system variable !ERR is set to the number of nonzero elements for compatibility with old versions of IDL
-      DVar *err = FindInVarList(sysVarList, "ERR");
-      (static_cast<DLongGDL*> (err->Data()))[0] = count;
-
-      if (count == 0) {
-        if (nullKW) {
-          return NullGDL::GetSingleInstance();
-        }
-        return new DLongGDL(-1);
-      }
-      DLongGDL* res=new DLongGDL(dimension(count),BaseGDL::NOALLOC);
-      res->SetBuffer((void*)ret);
-      res->SetBufferSize(count);
-      res->SetDim(dimension(count));
-      return res;
+    static int l64Ix = e->KeywordIx("L64");
+    bool doL64 = (e->KeywordSet(l64Ix) || nEl > std::numeric_limits<DLong>::max());
+    if (!doL64) {
+      DLong* ret=NULL;
+      DLong* comp_ret=NULL;
+      WhereIndexOf(m->mask, m->offset, nEl, comp, ret, count, comp_ret, m->parallel);
+      return WhereReturn<DLongGDL>(e, nEl, count, ret, comp_ret);
     } else {
       DLong64* ret=NULL;
       DLong64* comp_ret=NULL;
+      WhereIndexOf(m->mask, m->offset, nEl, comp, ret, count, comp_ret, m->parallel);
+      return WhereReturn<DLong64GDL>(e, nEl, count, ret, comp_ret);
+    }
+  }
 
-      p0->Where(ret, count, e->KeywordPresent(0), comp_ret);
+  // WHERE(a op b): as Data_::GtOp() etc., a scalar is compared to all the
+  // elements of the other operand, else the arrays over the smaller number
+  // of elements. The comparison with a scalar first is swapped.
+  WhereMaskT* where_compare_mask(BaseGDL* a, BaseGDL* b, SimdCmpOp op) {
+    static const SimdCmpOp swapped[SIMD_NCMP] = {SIMD_EQ, SIMD_NE, SIMD_GE, SIMD_GT, SIMD_LE, SIMD_LT};
+    if (a == NULL || b == NULL || a->Type() != b->Type() ||
+      !NumericType(a->Type()) || ComplexType(a->Type()))
+      return NULL;
+    bool bScalar = b->StrictScalar();
+    if (!bScalar && a->StrictScalar()) {
+      std::swap(a, b);
+      op = swapped[op];
+      bScalar = true;
+    }
+    SizeT nEl = a->N_Elements();
+    if (!bScalar && b->N_Elements() < nEl) nEl = b->N_Elements();
 
-      SizeT nCount = nEl - count;
-
-      if (e->KeywordPresent(0)) // COMPLEMENT
-      {
-        if (nCount == 0) {
-          if (nullKW)
-            e->SetKW(0, NullGDL::GetSingleInstance());
-          else
-            e->SetKW(0, new DLongGDL(-1));
-        } else {
-          DLong64GDL* cRet=new DLong64GDL(dimension(nCount),BaseGDL::NOALLOC); //danger!!
-          cRet->SetBuffer((void*)comp_ret);
-          cRet->SetBufferSize(nCount);
-          cRet->SetDim(dimension(nCount));
-          e->SetKW(0, cRet);
-        }
-      }
+    WhereMaskT* m = new WhereMaskT(nEl);
+    m->scalar = bScalar && a->StrictScalar();
+    WhereCompareOf(op, a, b, bScalar, nEl, m->mask, m->offset, m->parallel);
+    return m;
+  }
 
-      if (e->KeywordPresent(1)) // NCOMPLEMENT
-      {
-        e->SetKW(1, new DLong64GDL(nCount));
-      }
+  // WHERE(c1 AND c2), WHERE(c1 OR c2) with the masks of the comparisons:
+  // the words are combined as AND_OP and OR_OP combine the bytes (0 or 1)
+  // of the conditions, a scalar with all the elements of the other one,
+  // else the arrays over the smaller number of elements.
+  WhereMaskT* where_logical_mask(WhereMaskT* a, WhereMaskT* b, bool isAnd) {
+    if (a->scalar && !b->scalar) std::swap(a, b);
+    bool bScalar = b->scalar;
+    SizeT nEl = bScalar ? a->nEl : std::min(a->nEl, b->nEl);
+    SizeT nWords = (nEl + 63) / 64;
+
+    WhereMaskT* m = new WhereMaskT(nEl);
+    m->scalar = a->scalar && bScalar;
+    const uint64_t* ma = a->mask;
+    const uint64_t* mb = b->mask;
+    uint64_t* r = m->mask;
+    const uint64_t s = (mb[0] & 1) ? ~static_cast<uint64_t>(0) : 0;
+#pragma omp parallel for if (m->parallel)
+    for (OMPInt w = 0; w < nWords; ++w) {
+      uint64_t y = bScalar ? s : mb[w];
+      r[w] = isAnd ? (ma[w] & y) : (ma[w] | y);
+    }
+    if (nWords > 0) r[nWords - 1] &= WhereLastWordBits(nEl);
+    WhereCountPass(r, nEl, m->offset, m->parallel);
+    return m;
+  }
 
-      if (nParam == 2) {
-        e->SetPar(1, new DLong64GDL(count));
-      }
-      //The system variable !ERR is set to the number of nonzero elements for compatibility with old versions of IDL
-      DVar *err = FindInVarList(sysVarList, "ERR");
-      (static_cast<DLongGDL*> (err->Data()))[0] = count; //thus, not a DLong64!
-
-      if (count == 0) {
-        if (nullKW) {
-          return NullGDL::GetSingleInstance();
-        }
-        return new DLongGDL(-1);
-      }
-      DLong64GDL* res=new DLong64GDL(dimension(count),BaseGDL::NOALLOC);
-      res->SetBuffer((void*)ret);
-      res->SetBufferSize(count);
-      res->SetDim(dimension(count));
-      return res;
+  // WHERE(~c) with the mask of the comparison c, as LOG_NEG of its bytes
+  void where_neg_mask(WhereMaskT* m) {
+    SizeT nWords = (m->nEl + 63) / 64;
+#pragma omp parallel for if (m->parallel)
+    for (OMPInt w = 0; w < nWords; ++w) m->mask[w] = ~m->mask[w];
+    if (nWords > 0) m->mask[nWords - 1] &= WhereLastWordBits(m->nEl);
+    WhereCountPass(m->mask, m->nEl, m->offset, m->parallel);
+  }
+
+  // for a condition combined with one which could not be reduced to a mask
+  BaseGDL* where_mask_value(WhereMaskT* m) {
+    if (m->scalar) return new DByteGDL(static_cast<DByte>(m->mask[0] & 1));
+    DByteGDL* res = new DByteGDL(dimension(m->nEl), BaseGDL::NOZERO);
+    DByte* r = static_cast<DByte*>(res->DataAddr());
+    for (SizeT i = 0; i < m->nEl; ++i) r[i] = (m->mask[i / 64] >> (i % 64)) & 1;
+    return res;
+  }
+
+  // a[WHERE(cond[, count][, /L64][, /NULL])]=right, called by
+  // ARRAYEXPRNode::LExpr() in place of where_fun() for the subscript.
+  // Stores right directly at the true elements of cond and returns NULL,
+  // or, when the assignment cannot be fused (COMPLEMENT, no true element,
+  // structures, pointers, objects, ...), returns the result of WHERE for
+  // the normal indexed assignment.
+  BaseGDL* where_assign(EnvT* e, BaseGDL* var, BaseGDL* right) {
+    BaseGDL* p0 = e->GetParDefined(0);
+
+    if (!WhereMaskable(p0->Type()))
+      return where_fun(e);
+
+    WhereMaskT m(p0->N_Elements());
+    WhereMaskOf(p0, m.mask, m.offset, m.parallel);
+    return where_mask_assign(e, &m, var, right);
+  }
+
+  // as where_assign(), the condition being already reduced to its mask m
+  BaseGDL* where_mask_assign(EnvT* e, WhereMaskT* m, BaseGDL* var, BaseGDL* right) {
+    SizeT nParam = e->NParam(1);
+
+    SizeT nEl = m->nEl;
+    SizeT rEl = right->N_Elements();
+    SizeT count = m->offset[WhereMaskChunks(nEl)];
+
+    if (e->KeywordPresent(0) || e->KeywordPresent(1) || // COMPLEMENT, NCOMPLEMENT
+      !WhereMaskable(var->Type()) || !WhereMaskable(right->Type()) ||
+      nEl > var->N_Elements() || right == var ||
+      // as Data_::AssignAt(): a scalar to all, else at least one element
+      // per index (one index with an array inserts it)
+      count == 0 || (rEl != 1 && (count == 1 || rEl < count)))
+      return where_mask_fun(e, m);
+
+    Guard<BaseGDL> conv_guard;
+    BaseGDL* src = right;
+    if (!var->EqType(right)) {
+      src = right->Convert2(var->Type(), BaseGDL::COPY);
+      conv_guard.Reset(src);
+    }
+    WhereStoreOf(var, src, nEl, m->mask, m->offset, m->parallel);
+
+    static int l64Ix = e->KeywordIx("L64");
+    bool doL64 = (e->KeywordSet(l64Ix) || nEl > std::numeric_limits<DLong>::max());
+    if (nParam == 2) {
+      if (doL64) e->SetPar(1, new DLong64GDL(count));
+      else e->SetPar(1, new DLongGDL(count));
     }
+    DVar *err = FindInVarList(sysVarList, "ERR");
+    (static_cast<DLongGDL*> (err->Data()))[0] = count;
+    return NULL;
   }
 }
@@ -25,10 +25,40 @@
 
 #include "datatypes.hpp"
 #include "envt.hpp"
+#include "simd_dispatch.hpp"
 
 namespace lib {
 
+  // packed bit mask of the true elements of a WHERE condition (see where.cpp)
+  struct WhereMaskT {
+    SizeT nEl;
+    bool parallel;
+    bool scalar; // the condition is a scalar (of a comparison of scalars)
+    uint64_t* mask;
+    SizeT* offset; // true elements before each chunk, and in all at the end
+    WhereMaskT( SizeT n);
+    ~WhereMaskT();
+  private:
+    WhereMaskT( const WhereMaskT&);
+    WhereMaskT& operator=( const WhereMaskT&);
+  };
+
   BaseGDL* where_fun( EnvT* e);
+  BaseGDL* where_assign( EnvT* e, BaseGDL* var, BaseGDL* right);
+
+  // WHERE(a op b) with the operands a and b of a comparison, converted to
+  // their common type (see FCALL_LIB_RETNEWNode::WhereCompareEnv()): the
+  // mask, or NULL if a and b are not of a real numeric type
+  WhereMaskT* where_compare_mask( BaseGDL* a, BaseGDL* b, SimdCmpOp op);
+  // the mask of (a AND b), or of (a OR b), from the masks of a and b
+  WhereMaskT* where_logical_mask( WhereMaskT* a, WhereMaskT* b, bool isAnd);
+  // m becomes the mask of ~cond
+  void where_neg_mask( WhereMaskT* m);
+  // the BYTE condition (0 or 1) of the mask m
+  BaseGDL* where_mask_value( WhereMaskT* m);
+  // where_fun() and where_assign() with the mask of their first parameter
+  BaseGDL* where_mask_fun( EnvT* e, WhereMaskT* m);
+  BaseGDL* where_mask_assign( EnvT* e, WhereMaskT* m, BaseGDL* var, BaseGDL* right);
 
 } // namespace
 
@@ -20,6 +20,11 @@
 ; -- filter= for PLOT
 ; -- more info in XDR (info_cpu, info_os, info_soft)
 ;
+; * 2026-10:
+; -- Adding BENCH_MATRIX_MULTIPLY_BACKENDS, comparing GDL internal
+;    code with the external BLAS (CPU, BLAS=0|1) when GDL is compiled
+;    with it (cmake -DBLAS=ON)
+;
 ; ------------------------------------------------------------
 ;
 pro PLOT_BENCH_MATRIX_MULTIPLY, filter=filter, xrange=xrange, yrange=yrange, $
@@ -254,3 +259,81 @@ if KEYWORD_SET(test) then STOP
 ;
 end
 ;
+; ------------------------------
+;
+; Same timings with GDL internal code and with the external BLAS
+; (if available), same matrices. Times are in seconds, the last
+; column is the speedup internal/BLAS.
+;
+pro BENCH_MATRIX_MULTIPLY_BACKENDS, n1, n2, n3, small=small, medium=medium, $
+                                    time_internal=time_internal, $
+                                    time_blas=time_blas, $
+                                    help=help, test=test
+;
+if KEYWORD_SET(help) then begin
+    print, 'pro BENCH_MATRIX_MULTIPLY_BACKENDS, n1, n2, n3, small=small, medium=medium, $'
+    print, '                                    time_internal=time_internal, $'
+    print, '                                    time_blas=time_blas, $'
+    print, '                                    help=help, test=test'
+    return
+endif
+;
+DEFSYSV, '!gdl', exist=it_is_GDL
+if ~it_is_GDL then MESSAGE, 'This benchmark compares GDL backends, GDL only.'
+;
+gdltags=TAG_NAMES(!gdl)
+ok=WHERE(gdltags EQ 'GDL_USE_BLAS', nb_ok)
+if (nb_ok EQ 0) then MESSAGE, 'This GDL has no BLAS backend switch, too old ?'
+;
+; remember and restore the user setting
+blas_init=!gdl.gdl_use_blas
+;
+CPU, BLAS=1
+has_blas=!gdl.gdl_use_blas
+if ~has_blas then MESSAGE, /info, 'GDL compiled without BLAS/LAPACK, internal code only'
+;
+types=['float','double','complex','dcomplex']
+time_internal=FLTARR(5,4)
+time_blas=FLTARR(5,4)+!values.f_nan
+;
+for ii=0, 3 do begin
+   ex={small:KEYWORD_SET(small), medium:KEYWORD_SET(medium)}
+   ;; float is the default type of BENCH_MATRIX_MULTIPLY_ONE
+   if (ii GT 0) then ex=CREATE_STRUCT(types[ii], 1, ex)
+   CPU, BLAS=0
+   case N_PARAMS() of
+      0: BENCH_MATRIX_MULTIPLY_ONE, time_res=tres, _extra=ex
+      1: BENCH_MATRIX_MULTIPLY_ONE, n1, time_res=tres, _extra=ex
+      2: BENCH_MATRIX_MULTIPLY_ONE, n1, n2, time_res=tres, _extra=ex
+      3: BENCH_MATRIX_MULTIPLY_ONE, n1, n2, n3, time_res=tres, _extra=ex
+   endcase
+   time_internal[*,ii]=tres
+   if has_blas then begin
+      CPU, BLAS=1
+      case N_PARAMS() of
+         0: BENCH_MATRIX_MULTIPLY_ONE, time_res=tres, _extra=ex
+         1: BENCH_MATRIX_MULTIPLY_ONE, n1, time_res=tres, _extra=ex
+         2: BENCH_MATRIX_MULTIPLY_ONE, n1, n2, time_res=tres, _extra=ex
+         3: BENCH_MATRIX_MULTIPLY_ONE, n1, n2, n3, time_res=tres, _extra=ex
+      endcase
+      time_blas[*,ii]=tres
+   endif
+endfor
+;
+CPU, BLAS=blas_init
+;
+cases=['a#b  ','MM a#b  ','MM aT#b ','MM a#bT ','MM aT#bT']
+print, ''
+print, 'type      case        internal      BLAS   speedup'
+for ii=0, 3 do begin
+   for jj=0, 4 do begin
+      print, format='(A-9,A-9,2F11.4,F9.2)', types[ii], cases[jj], $
+             time_internal[jj,ii], time_blas[jj,ii], $
+             time_internal[jj,ii]/time_blas[jj,ii]
+   endfor
+endfor
+;
+if KEYWORD_SET(test) then STOP
+;
+end
+;
@@ -0,0 +1,131 @@
+;
+; Basic benchmark on TOTAL(), MIN() and MAX() along each dimension
+; of a 3D cube (and over the whole cube, as a reference): the
+; reductions along the 2nd and 3rd dimensions used to walk the
+; memory with large strides.
+;
+; BENCH_REDUCE_DIMENSION, size=256, nb_loops=5, /save
+;
+; ----------
+; Modification history :
+;
+; * 2026-10-19 : creation
+;
+; --------------------------------------------------------------
+;
+pro PLOT_BENCH_REDUCE_DIMENSION, filter=filter, yrange=yrange, $
+                                 path=path, svg=svg, $
+                                 ylog=ylog, test=test, help=help
+;
+if KEYWORD_SET(help) then begin
+   print, 'pro PLOT_BENCH_REDUCE_DIMENSION, filter=filter, yrange=yrange, $'
+   print, '                                 path=path, svg=svg, $'
+   print, '                                 ylog=ylog, test=test, help=help'
+   return
+end
+;
+ON_ERROR, 2
+;
+CHECK_SAVE_RESTORE
+;
+if ~KEYWORD_SET(filter) then filter='bench_reduce_dim*.xdr'
+liste=BENCHMARK_FILE_SEARCH(filter, 'Reductions along dimensions', path=path)
+;
+BENCHMARK_SVG, svg=svg, /on, filename='bench_reduce_dimension.svg', infosvg=infosvg
+;
+if keyword_set(yrange) then ymax=yrange[1] else ymax=0
+BENCHMARK_COMPUTE_RANGE, liste, xrange_data, yrange_data, $
+                         'dim_list', 'time_total', ymax=ymax
+if ~KEYWORD_SET(yrange) then yrange=[0, 1.5*yrange_data[1]]
+if KEYWORD_SET(ylog) then yrange[0]=1.e-4
+;
+DEVICE, decompose=1
+;
+BENCHMARK_GRAPHIC_STYLE, liste, colors, mypsym, myline, flags, languages
+;
+PLOT, [-0.5, 3.5], yrange, /nodata, xrange=[-0.5, 3.5], xstyle=1, $
+      xtitle='DIMENSION (0: whole cube)', ytitle='time [s]', $
+      ylog=ylog, title='TOTAL() (full), MIN() (dashed) along dimensions'
+;
+for ii=0, N_ELEMENTS(liste)-1 do begin
+   print, 'Restoring '+liste[ii]
+   RESTORE, liste[ii]
+   jj=flags[ii]
+   OPLOT, dim_list, time_total, psym=mypsym[jj], line=0, col=colors[jj]
+   OPLOT, dim_list, time_min, psym=mypsym[jj], line=2, col=colors[jj]
+endfor
+;
+BENCHMARK_PLOT_CARTOUCHE, pos=['lt'], languages, /box, $
+            colors=colors, lines=lines, thick=1.5, title='Languages'
+;
+BENCHMARK_SVG, svg=svg, /off, infosvg=infosvg
+;
+if KEYWORD_SET(test) then STOP
+;
+end
+;
+; --------------------------------------------------------------
+;
+pro BENCH_REDUCE_DIMENSION, size=size, nb_loops=nb_loops, $
+                            save=save, double=double, display=display, $
+                            verbose=verbose, test=test, help=help
+;
+if KEYWORD_SET(help) then begin
+   print, 'pro BENCH_REDUCE_DIMENSION, size=size, nb_loops=nb_loops, $'
+   print, '                            save=save, double=double, display=display, $'
+   print, '                            verbose=verbose, test=test, help=help'
+   return
+endif
+;
+if KEYWORD_SET(save) then CHECK_SAVE_RESTORE
+;
+if KEYWORD_SET(double) then radical='reduce_dim_d' else radical='reduce_dim'
+;
+if (N_ELEMENTS(size) EQ 0) then size=256
+if (N_ELEMENTS(nb_loops) EQ 0) then nb_loops=5
+;
+cube=RANDOMU(seed, size, size, size, double=double)
+;
+dim_list=INDGEN(4)
+time_total=FLTARR(4)
+time_min=FLTARR(4)
+time_max=FLTARR(4)
+;
+for dim=0, 3 do begin
+   time0=SYSTIME(1)
+   for ii=0, nb_loops-1 do b=TOTAL(cube, dim)
+   time_total[dim]=(SYSTIME(1)-time0)/nb_loops
+   ;;
+   time0=SYSTIME(1)
+   for ii=0, nb_loops-1 do b=MIN(cube, dimension=dim)
+   time_min[dim]=(SYSTIME(1)-time0)/nb_loops
+   ;;
+   time0=SYSTIME(1)
+   for ii=0, nb_loops-1 do b=MAX(cube, sub, dimension=dim, min=mini)
+   time_max[dim]=(SYSTIME(1)-time0)/nb_loops
+   ;;
+   print, format='("dimension ", I1, " : TOTAL ", F8.4, " s, MIN ", F8.4, " s, MAX+MIN+index ", F8.4, " s")', $
+          dim, time_total[dim], time_min[dim], time_max[dim]
+endfor
+;
+if KEYWORD_SET(display) then begin
+   PLOT, dim_list, time_total, xtitle='DIMENSION (0: whole cube)', ytitle='time [s]', $
+         yrange=[0, MAX([time_total, time_min, time_max])]
+   OPLOT, dim_list, time_min, line=2
+   OPLOT, dim_list, time_max, line=1
+endif
+;
+if KEYWORD_SET(save) then begin
+   filename=BENCHMARK_GENERATE_FILENAME(radical)
+   ;;
+   info_cpu=BENCHMARK_INFO_CPU()
+   info_os=BENCHMARK_INFO_OS()
+   info_soft=BENCHMARK_INFO_SOFT()
+   ;;
+   SAVE, filename=filename, size, dim_list, time_total, time_min, time_max, $
+         info_cpu, info_os, info_soft
+endif
+;
+if KEYWORD_SET(test) then STOP
+;
+end
@@ -0,0 +1,113 @@
+;
+; under GNU GPL v2 or later
+;
+; Tests of the FFT (overlap-save) method of CONVOL, forced with FFT=1,
+; against the direct method (FFT=0): all EDGE_* modes, /CENTER or not,
+; /NORMALIZE, /NAN, INVALID= and MISSING=.
+;
+; ---------------------------------
+;
+; Modifications history :
+;
+; - 2026-10-19 : creation with the FFT=keyword (GDL extension)
+; - 2026-10-19 : NaN only in the /NAN cases, where the FFT method
+;   accepts them; check that FFT=1 is not the direct method
+;
+; ---------------------------------
+;
+pro TEST_CONVOL_FFT_ONE, a, kern, nb_errors, label, scale=scale, _extra=extra
+;
+if N_ELEMENTS(scale) EQ 0 then begin
+   direct=CONVOL(a, kern, FFT=0, _extra=extra)
+   byfft=CONVOL(a, kern, /FFT, _extra=extra)
+endif else begin
+   direct=CONVOL(a, kern, scale, FFT=0, _extra=extra)
+   byfft=CONVOL(a, kern, scale, /FFT, _extra=extra)
+endelse
+if SIZE(byfft, /type) NE SIZE(direct, /type) then $
+   ERRORS_ADD, nb_errors, label+': type'
+; MISSING values (NaN by default) must be at the same places
+bad=WHERE(FINITE(direct) NE FINITE(byfft), nbad)
+if nbad GT 0 then ERRORS_ADD, nb_errors, label+': missing values'
+ok=WHERE(FINITE(direct), nok)
+if nok GT 0 then begin
+   tol=1e-9*MAX(ABS(direct[ok]))+1e-9
+   if SIZE(a, /type) EQ 4 then tol=1e-5*MAX(ABS(direct[ok]))+1e-5
+   if MAX(ABS(direct[ok]-byfft[ok])) GT tol then ERRORS_ADD, nb_errors, label
+endif
+end
+;
+; ---------------------------------
+;
+; "a" must be finite (the FFT method leaves NaN and Inf to the direct
+; one without /NAN), "an" is the same array with NaN
+pro TEST_CONVOL_FFT_MODES, cumul_errors, a, an, kern, label, test=test
+;
+nb_errors=0
+edges=['', 'EDGE_WRAP', 'EDGE_TRUNCATE', 'EDGE_ZERO', 'EDGE_MIRROR']
+for ie=0, N_ELEMENTS(edges)-1 do begin
+   for center=0, 1 do begin
+      ex={center:center}
+      if edges[ie] NE '' then ex=CREATE_STRUCT(ex, edges[ie], 1)
+      lab=label+' '+edges[ie]+' center='+STRTRIM(center,2)
+      TEST_CONVOL_FFT_ONE, a, kern, nb_errors, lab, _extra=ex
+      TEST_CONVOL_FFT_ONE, a, kern, nb_errors, lab+' /NORMALIZE', /NORMALIZE, _extra=ex
+      TEST_CONVOL_FFT_ONE, a, kern, nb_errors, lab+' scale, bias', SCALE=3.5, BIAS=2, _extra=ex
+      TEST_CONVOL_FFT_ONE, a, kern, nb_errors, lab+' INVALID', INVALID=7, MISSING=0, _extra=ex
+      TEST_CONVOL_FFT_ONE, an, kern, nb_errors, lab+' /NAN', /NAN, _extra=ex
+      TEST_CONVOL_FFT_ONE, an, kern, nb_errors, lab+' /NAN /NORMALIZE', /NAN, /NORMALIZE, MISSING=-1, _extra=ex
+      TEST_CONVOL_FFT_ONE, an, kern, nb_errors, lab+' /NAN INVALID', /NAN, INVALID=7, MISSING=0, _extra=ex
+   endfor
+endfor
+;
+BANNER_FOR_TESTSUITE, 'TEST_CONVOL_FFT_MODES '+label, nb_errors, /short
+ERRORS_CUMUL, cumul_errors, nb_errors
+if KEYWORD_set(test) then STOP
+;
+end
+;
+; -------------------------------------------------
+;
+pro TEST_CONVOL_FFT, no_exit=no_exit, test=test
+;
+seed=42
+; 1D
+a=RANDOMN(seed, 1000, /double)
+a[500]=7
+an=a
+an[100:140]=!values.d_nan
+k=RANDOMU(seed, 31, /double)-0.2
+TEST_CONVOL_FFT_MODES, cumul_errors, a, an, k, '1D'
+;
+; FFT=1 must really use the FFT method: rounding differs from the direct one
+nb_errors=0
+if ARRAY_EQUAL(CONVOL(a, k, /FFT), CONVOL(a, k, FFT=0)) then $
+   ERRORS_ADD, nb_errors, 'FFT=1 gives the direct method'
+BANNER_FOR_TESTSUITE, 'TEST_CONVOL_FFT_USED', nb_errors, /short
+ERRORS_CUMUL, cumul_errors, nb_errors
+;
+; 2D, FLOAT, the kernel larger along the first dimension
+b=RANDOMU(seed, 120, 90)*10
+b[10:20, 60:80]=7
+bn=b
+bn[*, 40:45]=!values.f_nan
+TEST_CONVOL_FFT_MODES, cumul_errors, b, bn, RANDOMU(seed, 15, 9), '2D'
+;
+; 2D with a 1D kernel
+TEST_CONVOL_FFT_MODES, cumul_errors, b, bn, FINDGEN(21), '2D, 1D kernel'
+;
+; 3D
+c=RANDOMN(seed, 30, 25, 20, /double)
+cn=c
+cn[5:8, *, 3]=!values.d_nan
+TEST_CONVOL_FFT_MODES, cumul_errors, c, cn, RANDOMU(seed, 5, 7, 3, /double), '3D'
+;
+; ----------------- final message ----------
+;
+BANNER_FOR_TESTSUITE, 'TEST_CONVOL_FFT', cumul_errors
+;
+if (cumul_errors GT 0) AND ~KEYWORD_SET(no_exit) then EXIT, status=1
+;
+if KEYWORD_SET(test) then STOP
+;
+end
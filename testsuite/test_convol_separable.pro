@@ -0,0 +1,157 @@
+;
+; under GNU GPL v2 or later
+;
+; Tests of the separable-kernel method of CONVOL (successive 1D passes)
+; against the direct method (SEPARABLE=0, FFT=0): all EDGE_* modes,
+; /CENTER or not, /NORMALIZE, scale and bias, and the explicit
+; separable form (1D kernel with /SEPARABLE).
+;
+; ---------------------------------
+;
+; Modifications history :
+;
+; - 2026-10-19 : creation with the SEPARABLE=keyword (GDL extension)
+; - 2026-10-19 : BYTE and INT kernels with /SEPARABLE
+; - 2026-10-19 : FFT=0 alone forces the direct method
+;
+; ---------------------------------
+;
+pro TEST_CONVOL_SEPARABLE_ONE, a, kern, nb_errors, label, scale=scale, _extra=extra
+;
+if N_ELEMENTS(scale) EQ 0 then begin
+   direct=CONVOL(a, kern, SEPARABLE=0, FFT=0, _extra=extra)
+   bypass=CONVOL(a, kern, _extra=extra)
+endif else begin
+   direct=CONVOL(a, kern, scale, SEPARABLE=0, FFT=0, _extra=extra)
+   bypass=CONVOL(a, kern, scale, _extra=extra)
+endelse
+if SIZE(bypass, /type) NE SIZE(direct, /type) then $
+   ERRORS_ADD, nb_errors, label+': type'
+bad=WHERE(FINITE(direct) NE FINITE(bypass), nbad)
+if nbad GT 0 then ERRORS_ADD, nb_errors, label+': missing values'
+ok=WHERE(FINITE(direct), nok)
+if nok GT 0 then begin
+   tol=1e-9*MAX(ABS(direct[ok]))+1e-9
+   if SIZE(a, /type) EQ 4 then tol=1e-5*MAX(ABS(direct[ok]))+1e-5
+   if MAX(ABS(direct[ok]-bypass[ok])) GT tol then ERRORS_ADD, nb_errors, label
+endif
+end
+;
+; ---------------------------------
+;
+pro TEST_CONVOL_SEPARABLE_MODES, cumul_errors, a, kern, label, test=test
+;
+nb_errors=0
+edges=['', 'EDGE_WRAP', 'EDGE_TRUNCATE', 'EDGE_ZERO', 'EDGE_MIRROR']
+for ie=0, N_ELEMENTS(edges)-1 do begin
+   for center=0, 1 do begin
+      ex={center:center}
+      if edges[ie] NE '' then ex=CREATE_STRUCT(ex, edges[ie], 1)
+      lab=label+' '+edges[ie]+' center='+STRTRIM(center,2)
+      TEST_CONVOL_SEPARABLE_ONE, a, kern, nb_errors, lab, _extra=ex
+      TEST_CONVOL_SEPARABLE_ONE, a, kern, nb_errors, lab+' /NORMALIZE', /NORMALIZE, _extra=ex
+      TEST_CONVOL_SEPARABLE_ONE, a, kern, nb_errors, lab+' scale, bias', SCALE=3.5, BIAS=2, _extra=ex
+      TEST_CONVOL_SEPARABLE_ONE, a, kern, nb_errors, lab+' /NAN', /NAN, _extra=ex
+   endfor
+endfor
+;
+BANNER_FOR_TESTSUITE, 'TEST_CONVOL_SEPARABLE_MODES '+label, nb_errors, /short
+ERRORS_CUMUL, cumul_errors, nb_errors
+if KEYWORD_set(test) then STOP
+;
+end
+;
+; ---------------------------------
+;
+pro TEST_CONVOL_SEPARABLE_EXPLICIT, cumul_errors, test=test
+;
+nb_errors=0
+k=[1,4,6,4,1]
+; 2D: k # k
+a=FIX(RANDOMU(seed, 40, 30)*100)
+res=CONVOL(a, k, /SEPARABLE, /EDGE_MIRROR)
+exp=CONVOL(a, k # k, /EDGE_MIRROR)
+if SIZE(res, /type) NE 2 then ERRORS_ADD, nb_errors, 'explicit 2D: type'
+if ~ARRAY_EQUAL(res, exp) then ERRORS_ADD, nb_errors, 'explicit 2D'
+; BYTE and INT kernels whose products overflow their type (20*20, 1000*1000):
+; the taps are those of the LONG kernel used by the direct method
+ab=BYTE(RANDOMU(seed, 40, 30)*255)
+kb=[1b,20b,1b]
+res=CONVOL(ab, kb, /SEPARABLE, /EDGE_TRUNCATE)
+exp=CONVOL(ab, LONG(kb) # LONG(kb), /EDGE_TRUNCATE)
+if SIZE(res, /type) NE 1 || ~ARRAY_EQUAL(res, exp) then ERRORS_ADD, nb_errors, 'explicit 2D BYTE kernel'
+ki=[300,1000,300]
+res=CONVOL(a, ki, 1000000, /SEPARABLE, /EDGE_WRAP)
+exp=CONVOL(a, LONG(ki) # LONG(ki), 1000000, /EDGE_WRAP)
+if SIZE(res, /type) NE 2 || ~ARRAY_EQUAL(res, exp) then ERRORS_ADD, nb_errors, 'explicit 2D INT kernel'
+; and along the 1D passes of a FLOAT array
+f=RANDOMU(seed, 40, 30)
+res=CONVOL(f, kb, /SEPARABLE)
+exp=CONVOL(f, FLOAT(kb) # FLOAT(kb), SEPARABLE=0, FFT=0)
+if MAX(ABS(res-exp)) GT 1e-4*MAX(ABS(exp)) then ERRORS_ADD, nb_errors, 'explicit 2D FLOAT array, BYTE kernel'
+; 3D, DOUBLE
+c=RANDOMN(seed, 12, 10, 8, /double)
+k3=DBLARR(5, 5, 5)
+for i=0, 4 do k3[*, *, i]=(k # k)*k[i]
+res=CONVOL(c, DOUBLE(k), /SEPARABLE, /NORMALIZE, /EDGE_ZERO, /CENTER)
+exp=CONVOL(c, k3, /NORMALIZE, /EDGE_ZERO, /CENTER, SEPARABLE=0, FFT=0)
+if MAX(ABS(res-exp)) GT 1e-12 then ERRORS_ADD, nb_errors, 'explicit 3D'
+; FFT=0 is the direct method, even without SEPARABLE=0
+e=RANDOMN(seed, 50, 40, /double)
+ke=RANDOMU(seed, 7, /double) # RANDOMU(seed, 5, /double)
+if ~ARRAY_EQUAL(CONVOL(e, ke, FFT=0), CONVOL(e, ke, SEPARABLE=0, FFT=0)) then $
+   ERRORS_ADD, nb_errors, 'FFT=0 not direct'
+; 1D arrays ignore /SEPARABLE
+v=FINDGEN(20)
+if ~ARRAY_EQUAL(CONVOL(v, FLOAT(k), /SEPARABLE), CONVOL(v, FLOAT(k))) then $
+   ERRORS_ADD, nb_errors, 'explicit 1D'
+; the kernel must fit in every dimension
+CATCH, error_status
+if error_status EQ 0 then begin
+   res=CONVOL(FLTARR(40, 3), FLOAT(k), /SEPARABLE)
+   ERRORS_ADD, nb_errors, 'explicit: kernel too large not detected'
+endif
+CATCH, /cancel
+;
+BANNER_FOR_TESTSUITE, 'TEST_CONVOL_SEPARABLE_EXPLICIT', nb_errors, /short
+ERRORS_CUMUL, cumul_errors, nb_errors
+if KEYWORD_set(test) then STOP
+;
+end
+;
+; -------------------------------------------------
+;
+pro TEST_CONVOL_SEPARABLE, no_exit=no_exit, test=test
+;
+seed=42
+; 2D, FLOAT, gaussian kernel
+b=RANDOMU(seed, 120, 90)*10
+x=FINDGEN(11)-5
+g=EXP(-x^2/8.)
+TEST_CONVOL_SEPARABLE_MODES, cumul_errors, b, g # g[2:8], '2D gaussian'
+;
+; 2D DOUBLE, outer product with negative values
+d=RANDOMN(seed, 64, 50, /double)
+TEST_CONVOL_SEPARABLE_MODES, cumul_errors, d, [-1d,0,1] # [1d,2,1], '2D sobel'
+;
+; 3D, rank-1 kernel of size 1 along one dimension
+c=RANDOMN(seed, 30, 25, 20, /double)
+k3=DBLARR(5, 1, 4)
+u=RANDOMU(seed, 5, /double) & w=RANDOMU(seed, 4, /double)-0.5
+for i=0, 3 do k3[*, 0, i]=u*w[i]
+TEST_CONVOL_SEPARABLE_MODES, cumul_errors, c, k3, '3D'
+;
+; a kernel that is not separable must be unchanged
+TEST_CONVOL_SEPARABLE_MODES, cumul_errors, d, RANDOMU(seed, 3, 3, /double), '2D not separable'
+;
+TEST_CONVOL_SEPARABLE_EXPLICIT, cumul_errors
+;
+; ----------------- final message ----------
+;
+BANNER_FOR_TESTSUITE, 'TEST_CONVOL_SEPARABLE', cumul_errors
+;
+if (cumul_errors GT 0) AND ~KEYWORD_SET(no_exit) then EXIT, status=1
+;
+if KEYWORD_SET(test) then STOP
+;
+end
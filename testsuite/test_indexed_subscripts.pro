@@ -0,0 +1,183 @@
+;
+; under GNU GPL v2 or later
+;
+; Subscripting by an index array (a[ix] and a[ix]=b) converts the indices
+; by vectorized kernels (see src/simd_dispatch.hpp), and copies the
+; elements in parallel for large arrays. The results must be those of the
+; element by element loop: negative or too large indices are clipped (or
+; rejected under STRICTARRSUBS), and for repeated indices the last
+; assignment wins.
+;
+; ---------------------------------
+;
+; Modifications history :
+;
+; - 2026-10-19 : creation
+;
+; ---------------------------------
+;
+; a[ix] element by element, with the clipping of the indices
+function TEST_INDEXED_SUBSCRIPTS_GATHER_LOOP, a, ix
+;
+r=MAKE_ARRAY(N_ELEMENTS(ix), type=SIZE(a, /type))
+n=N_ELEMENTS(a)
+for i=0, N_ELEMENTS(ix)-1 do begin
+   k=ix[i]
+   if k LT 0 then k=0
+   if k GE n then k=n-1
+   r[i]=a[LONG64(k)]
+endfor
+return, r
+end
+;
+; ---------------------------------
+;
+; a[ix]=b element by element (b scalar or array)
+function TEST_INDEXED_SUBSCRIPTS_SCATTER_LOOP, a, ix, b
+;
+r=a
+n=N_ELEMENTS(a)
+nb=N_ELEMENTS(b)
+for i=0, N_ELEMENTS(ix)-1 do begin
+   k=ix[i]
+   if k LT 0 then k=0
+   if k GE n then k=n-1
+   r[LONG64(k)]=(nb EQ 1) ? b[0] : b[i]
+endfor
+return, r
+end
+;
+; ---------------------------------
+;
+function TEST_INDEXED_SUBSCRIPTS_STRICT, a, ix
+;
+compile_opt strictarrsubs
+;
+CATCH, error
+if error NE 0 then begin
+   CATCH, /cancel
+   return, 0
+endif
+r=a[ix]
+return, 1
+end
+;
+; ---------------------------------
+;
+pro TEST_INDEXED_SUBSCRIPTS_GATHER, cumul_errors, test=test
+;
+nb_errors=0
+seed=71
+SAVECPU=!CPU
+; also the blocks handled in parallel
+CPU, TPOOL_MIN_ELTS=1000
+;
+foreach n, [5, 300, 50001] do begin
+   a=RANDOMU(seed, n)
+   foreach m, [2, 17, 3000, 60000] do begin
+      ; beyond the bounds on both sides
+      d=RANDOMU(seed, m, /double)*(n+20)-10
+      ixs=LIST(BYTE(d > 0), FIX(d), UINT(d > 0), LONG(d), ULONG(d > 0), $
+               LONG64(d), ULONG64(d > 0), FLOAT(d), d)
+      foreach ix, ixs do begin
+         lab=SIZE(ix, /tname)+' n='+STRTRIM(n,2)+' m='+STRTRIM(m,2)
+         if ~ARRAY_EQUAL(a[ix], TEST_INDEXED_SUBSCRIPTS_GATHER_LOOP(a, ix)) then ERRORS_ADD, nb_errors, lab
+      endforeach
+   endforeach
+endforeach
+;
+; the dimensions are those of the index array
+a=LINDGEN(100)
+ix=LINDGEN(3, 4)*7
+if ~ARRAY_EQUAL(SIZE(a[ix], /dim), [3, 4]) then ERRORS_ADD, nb_errors, 'dimensions'
+;
+; real indices are truncated; huge values and NaN give the last element
+r=a[[-1e30, -0.9, 0.9, 5.5, 99.9, 1e30, !values.f_nan, !values.f_infinity]]
+if ~ARRAY_EQUAL(r, [0, 0, 0, 5, 99, 99, 99, 99]) then ERRORS_ADD, nb_errors, 'float indices'
+if ~ARRAY_EQUAL(a[[1d300, -1d300, 3.7d]], [99, 0, 3]) then ERRORS_ADD, nb_errors, 'double indices'
+;
+; STRICTARRSUBS still rejects the indices out of range
+b=FINDGEN(2000)
+if ~TEST_INDEXED_SUBSCRIPTS_STRICT(b, LINDGEN(1500)) then ERRORS_ADD, nb_errors, 'strict in range'
+if TEST_INDEXED_SUBSCRIPTS_STRICT(b, [LINDGEN(1500), 2000]) then ERRORS_ADD, nb_errors, 'strict too large'
+if TEST_INDEXED_SUBSCRIPTS_STRICT(b, [LINDGEN(1500), -1]) then ERRORS_ADD, nb_errors, 'strict negative'
+if TEST_INDEXED_SUBSCRIPTS_STRICT(b, [FINDGEN(1500), 1e30]) then ERRORS_ADD, nb_errors, 'strict huge float'
+;
+CPU, RESTORE=SAVECPU
+BANNER_FOR_TESTSUITE, 'TEST_INDEXED_SUBSCRIPTS_GATHER', nb_errors, /short
+ERRORS_CUMUL, cumul_errors, nb_errors
+if KEYWORD_set(test) then STOP
+;
+end
+;
+; ---------------------------------
+;
+pro TEST_INDEXED_SUBSCRIPTS_SCATTER, cumul_errors, test=test
+;
+nb_errors=0
+seed=72
+SAVECPU=!CPU
+CPU, TPOOL_MIN_ELTS=1000
+;
+foreach n, [7, 3000, 50001] do begin
+   a=DINDGEN(n)
+   foreach m, [3, 2500, 60000] do begin
+      d=RANDOMU(seed, m, /double)*(n+20)-10
+      ; unordered with repetitions, increasing with runs, decreasing,
+      ; a few targets only, a single one
+      ixs=LIST(LONG(d), LONG(d[SORT(d)]), REVERSE(LONG64(d[SORT(d)])), $
+               LONG(d) MOD 5, LONARR(m)+n/2, FLOAT(d))
+      foreach ix, ixs, k do begin
+         lab='case '+STRTRIM(k,2)+' n='+STRTRIM(n,2)+' m='+STRTRIM(m,2)
+         b=RANDOMU(seed, m, /double)
+         r=a
+         r[ix]=b
+         if ~ARRAY_EQUAL(r, TEST_INDEXED_SUBSCRIPTS_SCATTER_LOOP(a, ix, b)) then ERRORS_ADD, nb_errors, lab
+         r=a
+         r[ix]=-1d
+         if ~ARRAY_EQUAL(r, TEST_INDEXED_SUBSCRIPTS_SCATTER_LOOP(a, ix, -1d)) then ERRORS_ADD, nb_errors, 'scalar '+lab
+         ; converted source
+         r=a
+         r[ix]=LONG(b*1000)
+         if ~ARRAY_EQUAL(r, TEST_INDEXED_SUBSCRIPTS_SCATTER_LOOP(a, ix, DOUBLE(LONG(b*1000)))) then $
+            ERRORS_ADD, nb_errors, 'converted '+lab
+      endforeach
+   endforeach
+endforeach
+;
+; the source being the array itself
+a=LINDGEN(5000)
+ix=REVERSE(LINDGEN(5000))
+r=a
+r[ix]=r
+if ~ARRAY_EQUAL(r, REVERSE(a)) then ERRORS_ADD, nb_errors, 'a[ix]=a'
+;
+; subarray of a multidimensional array
+a=FLTARR(100, 100)
+ix=LINDGEN(2000)*5
+a[ix]=1
+if TOTAL(a) NE 2000 || ~ARRAY_EQUAL(a[ix], FLTARR(2000)+1) then ERRORS_ADD, nb_errors, 'multidimensional'
+;
+CPU, RESTORE=SAVECPU
+BANNER_FOR_TESTSUITE, 'TEST_INDEXED_SUBSCRIPTS_SCATTER', nb_errors, /short
+ERRORS_CUMUL, cumul_errors, nb_errors
+if KEYWORD_set(test) then STOP
+;
+end
+;
+; -------------------------------------------------
+;
+pro TEST_INDEXED_SUBSCRIPTS, no_exit=no_exit, test=test
+;
+TEST_INDEXED_SUBSCRIPTS_GATHER, cumul_errors
+TEST_INDEXED_SUBSCRIPTS_SCATTER, cumul_errors
+;
+; ----------------- final message ----------
+;
+BANNER_FOR_TESTSUITE, 'TEST_INDEXED_SUBSCRIPTS', cumul_errors
+;
+if (cumul_errors GT 0) AND ~KEYWORD_SET(no_exit) then EXIT, status=1
+;
+if KEYWORD_SET(test) then STOP
+;
+end
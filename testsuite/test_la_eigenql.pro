@@ -0,0 +1,160 @@
+;
+; under GNU GPL v2 or later
+;
+; Tests of LA_EIGENQL and EIGENQL: eigenvalues and eigenvectors of
+; real symmetric and complex Hermitian matrices, subsets, generalized
+; problems. The eigenvectors are the rows of EIGENVECTORS, they must
+; verify A ## v = lambda * v.
+;
+; ---------------------------------
+;
+; Modifications history :
+;
+; - 2026-10-19 : creation
+;
+; ---------------------------------
+;
+function TEST_LA_EIGENQL_SYM, n, seed, double=double, complex=complex, spd=spd
+;
+c=RANDOMU(seed, n, n, double=double)-0.5
+if KEYWORD_SET(complex) then c=COMPLEX(c, RANDOMU(seed, n, n, double=double)-0.5, double=double)
+if KEYWORD_SET(spd) then return, c ## CONJ(TRANSPOSE(c))+n*DIAG_MATRIX(REPLICATE(1., n))
+return, c+CONJ(TRANSPOSE(c))
+end
+;
+; ---------------------------------
+;
+pro TEST_LA_EIGENQL_BASIC, cumul_errors, test=test
+;
+nb_errors=0
+;
+res=LA_EIGENQL([[2.,1],[1,2]])
+if MAX(ABS(res-[1,3])) GT 1e-6 then ERRORS_ADD, nb_errors, '2x2'
+;
+seed=21
+n=7
+for dbl=0, 1 do begin
+   for cpx=0, 1 do begin
+      tol=(dbl ? 1e-10 : 1e-4)
+      lab='n=7 double='+STRTRIM(dbl,2)+' complex='+STRTRIM(cpx,2)
+      a=TEST_LA_EIGENQL_SYM(n, seed, double=dbl, complex=cpx)
+      for method=0, 2 do begin
+         res=LA_EIGENQL(a, eigenvectors=evec, method=method, status=status)
+         if status NE 0 then ERRORS_ADD, nb_errors, lab+' status'
+         if SIZE(res, /type) NE (dbl ? 5 : 4) then ERRORS_ADD, nb_errors, lab+' type'
+         if SIZE(evec, /type) NE SIZE(a, /type) then ERRORS_ADD, nb_errors, lab+' vector type'
+         if ~ARRAY_EQUAL(SIZE(evec, /dim), [n, n]) then ERRORS_ADD, nb_errors, lab+' vector dims'
+         if ~ARRAY_EQUAL(res, res[SORT(res)]) then ERRORS_ADD, nb_errors, lab+' order'
+         for i=0, n-1 do begin
+            r=a ## evec[*,i] - res[i]*evec[*,i]
+            if MAX(ABS(r)) GT tol then ERRORS_ADD, nb_errors, lab+' method='+STRTRIM(method,2)
+         endfor
+      endfor
+      ;; subsets
+      all=LA_EIGENQL(a)
+      sub=LA_EIGENQL(a, range=[2,4], eigenvectors=evec)
+      if N_ELEMENTS(sub) NE 3 || MAX(ABS(sub-all[2:4])) GT tol then ERRORS_ADD, nb_errors, lab+' RANGE'
+      if ~ARRAY_EQUAL(SIZE(evec, /dim), [n, 3]) then ERRORS_ADD, nb_errors, lab+' RANGE dims'
+      for i=0, 2 do if MAX(ABS(a ## evec[*,i] - sub[i]*evec[*,i])) GT tol then $
+         ERRORS_ADD, nb_errors, lab+' RANGE vectors'
+      lim=[(all[1]+all[2])/2, (all[5]+all[6])/2]
+      sub=LA_EIGENQL(a, search_range=lim)
+      if N_ELEMENTS(sub) NE 4 || MAX(ABS(sub-all[2:5])) GT tol then ERRORS_ADD, nb_errors, lab+' SEARCH_RANGE'
+   endfor
+endfor
+;
+; precision follows the input unless DOUBLE is given
+res=LA_EIGENQL(FIX(TEST_LA_EIGENQL_SYM(4, seed)*10), /double)
+if SIZE(res, /type) NE 5 then ERRORS_ADD, nb_errors, 'DOUBLE keyword'
+;
+BANNER_FOR_TESTSUITE, 'TEST_LA_EIGENQL_BASIC', nb_errors, /short
+ERRORS_CUMUL, cumul_errors, nb_errors
+if KEYWORD_set(test) then STOP
+;
+end
+;
+; ---------------------------------
+;
+pro TEST_LA_EIGENQL_GENERALIZED, cumul_errors, test=test
+;
+nb_errors=0
+seed=22
+n=6
+for cpx=0, 1 do begin
+   a=TEST_LA_EIGENQL_SYM(n, seed, /double, complex=cpx)
+   b=TEST_LA_EIGENQL_SYM(n, seed, /double, complex=cpx, /spd)
+   for itype=1, 3 do begin
+      for method=0, 1 do begin
+         lab='GENERALIZED='+STRTRIM(itype,2)+' method='+STRTRIM(method,2)+' complex='+STRTRIM(cpx,2)
+         res=LA_EIGENQL(a, b, generalized=itype, method=method, eigenvectors=evec)
+         for i=0, n-1 do begin
+            v=evec[*,i]
+            case itype of
+               1: r=a ## v - res[i]*(b ## v)
+               2: r=a ## (b ## v) - res[i]*v
+               3: r=b ## (a ## v) - res[i]*v
+            endcase
+            if MAX(ABS(r)) GT 1e-9 then ERRORS_ADD, nb_errors, lab
+         endfor
+      endfor
+   endfor
+endfor
+;
+; B not positive definite
+res=LA_EIGENQL(a, -b, status=status)
+if status EQ 0 then ERRORS_ADD, nb_errors, 'B not positive definite'
+;
+BANNER_FOR_TESTSUITE, 'TEST_LA_EIGENQL_GENERALIZED', nb_errors, /short
+ERRORS_CUMUL, cumul_errors, nb_errors
+if KEYWORD_set(test) then STOP
+;
+end
+;
+; ---------------------------------
+;
+pro TEST_EIGENQL, cumul_errors, test=test
+;
+nb_errors=0
+;
+; eigenvalues -5, 1 and 3
+q=[[2.,1,2],[-2,2,1],[1,2,-2]]/3.
+a=TRANSPOSE(q) ## DIAG_MATRIX([-5., 1, 3]) ## q
+;
+res=EIGENQL(a, eigenvectors=evec, residual=resid)
+if SIZE(res, /type) NE 4 then ERRORS_ADD, nb_errors, 'type'
+if MAX(ABS(res-[3,1,-5])) GT 1e-5 then ERRORS_ADD, nb_errors, 'descending'
+if MAX(ABS(resid)) GT 1e-5 then ERRORS_ADD, nb_errors, 'residual'
+for i=0, 2 do if MAX(ABS(a ## evec[*,i] - res[i]*evec[*,i])) GT 1e-5 then $
+   ERRORS_ADD, nb_errors, 'eigenvectors'
+;
+res=EIGENQL(a, /ascending)
+if MAX(ABS(res-[-5,1,3])) GT 1e-5 then ERRORS_ADD, nb_errors, '/ASCENDING'
+res=EIGENQL(a, /absolute)
+if MAX(ABS(res-[-5,3,1])) GT 1e-5 then ERRORS_ADD, nb_errors, '/ABSOLUTE'
+res=EIGENQL(a, /absolute, /ascending, /double)
+if SIZE(res, /type) NE 5 then ERRORS_ADD, nb_errors, '/DOUBLE'
+if MAX(ABS(res-[1,3,-5])) GT 1e-5 then ERRORS_ADD, nb_errors, '/ABSOLUTE /ASCENDING'
+;
+BANNER_FOR_TESTSUITE, 'TEST_EIGENQL', nb_errors, /short
+ERRORS_CUMUL, cumul_errors, nb_errors
+if KEYWORD_set(test) then STOP
+;
+end
+;
+; -------------------------------------------------
+;
+pro TEST_LA_EIGENQL, no_exit=no_exit, test=test
+;
+TEST_LA_EIGENQL_BASIC, cumul_errors
+TEST_LA_EIGENQL_GENERALIZED, cumul_errors
+TEST_EIGENQL, cumul_errors
+;
+; ----------------- final message ----------
+;
+BANNER_FOR_TESTSUITE, 'TEST_LA_EIGENQL', cumul_errors
+;
+if (cumul_errors GT 0) AND ~KEYWORD_SET(no_exit) then EXIT, status=1
+;
+if KEYWORD_SET(test) then STOP
+;
+end
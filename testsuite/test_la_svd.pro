@@ -0,0 +1,54 @@
+;
+; under GNU GPL v2 or later
+;
+; Tests of LA_SVD: for an array of ncol columns and nrow rows,
+; A = U ## DIAG_MATRIX(W) ## CONJ(TRANSPOSE(V)), with W in decreasing
+; order, U [k,nrow] and V [k,ncol], k=MIN([ncol,nrow]).
+;
+; ---------------------------------
+;
+; Modifications history :
+;
+; - 2026-10-19 : creation
+;
+; ---------------------------------
+;
+pro TEST_LA_SVD, no_exit=no_exit, test=test
+;
+nb_errors=0
+seed=31
+shapes=[[5,3],[3,5],[4,4],[2,6],[20,17]]
+for is=0, (SIZE(shapes, /dim))[1]-1 do begin
+   ncol=shapes[0,is] & nrow=shapes[1,is] & k=MIN(shapes[*,is])
+   for it=0, 3 do begin
+      type=([4,5,6,9])[it]
+      tol=(type EQ 5 || type EQ 9) ? 1e-10 : 1e-4
+      a=FIX(RANDOMU(seed, ncol, nrow, /double)-0.5, type=type)
+      if type GE 6 then a=a+COMPLEX(0,1)*(RANDOMU(seed, ncol, nrow)-0.5)
+      for dc=0, 1 do begin
+         lab='LA_SVD '+STRTRIM(ncol,2)+'x'+STRTRIM(nrow,2)+' type='+STRTRIM(type,2)+' dc='+STRTRIM(dc,2)
+         LA_SVD, a, w, u, v, divide_conquer=dc, status=status
+         if status NE 0 then ERRORS_ADD, nb_errors, lab+' status'
+         if SIZE(w, /type) NE ((type EQ 5 || type EQ 9) ? 5 : 4) then ERRORS_ADD, nb_errors, lab+' W type'
+         if SIZE(u, /type) NE type then ERRORS_ADD, nb_errors, lab+' U type'
+         if N_ELEMENTS(w) NE k then ERRORS_ADD, nb_errors, lab+' W dims'
+         if N_ELEMENTS(u) NE k*nrow then ERRORS_ADD, nb_errors, lab+' U dims'
+         if N_ELEMENTS(v) NE k*ncol then ERRORS_ADD, nb_errors, lab+' V dims'
+         if ~ARRAY_EQUAL(w, w[REVERSE(SORT(w))]) then ERRORS_ADD, nb_errors, lab+' order'
+         b=u ## DIAG_MATRIX(w) ## CONJ(TRANSPOSE(v))
+         if MAX(ABS(b-a)) GT tol then ERRORS_ADD, nb_errors, lab+' reconstruction'
+      endfor
+   endfor
+endfor
+;
+; float input is not promoted, unless DOUBLE is set
+LA_SVD, FINDGEN(3,4), w, u, v, /double
+if SIZE(w, /type) NE 5 || SIZE(u, /type) NE 5 then ERRORS_ADD, nb_errors, '/DOUBLE'
+;
+BANNER_FOR_TESTSUITE, 'TEST_LA_SVD', nb_errors
+;
+if (nb_errors GT 0) AND ~KEYWORD_SET(no_exit) then EXIT, status=1
+;
+if KEYWORD_SET(test) then STOP
+;
+end
@@ -0,0 +1,208 @@
+;
+; under GNU GPL v2 or later
+;
+; Tests of INVERT, LUDC/LUSOL, CHOLDC/CHOLSOL and MATRIX_MULTIPLY
+; on stacks of matrices, (n,n,m) arrays (GDL extension): each matrix
+; of the stack must give the same result as the single matrix call
+; and the solutions must solve the systems.
+;
+; ---------------------------------
+;
+; Modifications history :
+;
+; - 2026-10-19 : creation
+;
+; ---------------------------------
+;
+function TEST_MATRIX_BATCHED_STACK, n, m, seed, double=double, spd=spd
+;
+a=RANDOMU(seed, n, n, m, double=double)-0.5
+for k=0, m-1 do begin
+   s=a[*,*,k]
+   if KEYWORD_SET(spd) then s=s ## TRANSPOSE(s)
+   a[*,*,k]=s+DIAG_MATRIX(REPLICATE(n/2.+1, n))
+endfor
+return, a
+end
+;
+; ---------------------------------
+;
+pro TEST_MATRIX_BATCHED_INVERT, cumul_errors, test=test
+;
+nb_errors=0
+seed=11
+for n=2, 10 do begin
+   for dbl=0, 1 do begin
+      m=7
+      tol=(dbl ? 1e-10 : 1e-4)
+      a=TEST_MATRIX_BATCHED_STACK(n, m, seed, double=dbl)
+      inv=INVERT(a, status)
+      lab='INVERT n='+STRTRIM(n,2)+' double='+STRTRIM(dbl,2)
+      if SIZE(inv, /type) NE SIZE(a, /type) then ERRORS_ADD, nb_errors, lab+' type'
+      if ~ARRAY_EQUAL(SIZE(inv, /dim), [n, n, m]) then ERRORS_ADD, nb_errors, lab+' dims'
+      if ~ARRAY_EQUAL(SIZE(status, /dim), [m]) then ERRORS_ADD, nb_errors, lab+' status'
+      if TOTAL(status) NE 0 then ERRORS_ADD, nb_errors, lab+' status value'
+      for k=0, m-1 do begin
+         one=INVERT(a[*,*,k])
+         if MAX(ABS(one-inv[*,*,k])) GT tol then ERRORS_ADD, nb_errors, lab+' vs single'
+         id=a[*,*,k] # inv[*,*,k]
+         if MAX(ABS(id-DIAG_MATRIX(REPLICATE(1., n)))) GT tol then $
+            ERRORS_ADD, nb_errors, lab+' identity'
+      endfor
+   endfor
+endfor
+;
+; complex
+a=COMPLEX(TEST_MATRIX_BATCHED_STACK(4, 5, seed), TEST_MATRIX_BATCHED_STACK(4, 5, seed))
+inv=INVERT(a)
+if SIZE(inv, /type) NE 6 then ERRORS_ADD, nb_errors, 'INVERT complex type'
+for k=0, 4 do begin
+   id=a[*,*,k] # inv[*,*,k]
+   if MAX(ABS(id-DIAG_MATRIX(REPLICATE(1., 4)))) GT 1e-4 then $
+      ERRORS_ADD, nb_errors, 'INVERT complex identity'
+endfor
+;
+; a singular matrix in the stack
+a=TEST_MATRIX_BATCHED_STACK(3, 4, seed, /double)
+a[*,*,2]=[[1d,2,0],[3,4,0],[5,6,0]]
+inv=INVERT(a, status)
+if ~ARRAY_EQUAL(status NE 0, [0,0,1,0]) then ERRORS_ADD, nb_errors, 'INVERT singular status'
+;
+BANNER_FOR_TESTSUITE, 'TEST_MATRIX_BATCHED_INVERT', nb_errors, /short
+ERRORS_CUMUL, cumul_errors, nb_errors
+if KEYWORD_set(test) then STOP
+;
+end
+;
+; ---------------------------------
+;
+pro TEST_MATRIX_BATCHED_LU, cumul_errors, test=test
+;
+nb_errors=0
+seed=12
+for n=2, 10 do begin
+   m=6
+   a=TEST_MATRIX_BATCHED_STACK(n, m, seed, /double)
+   b=RANDOMU(seed, n, m, /double)
+   lu=a
+   LUDC, lu, index
+   x=LUSOL(lu, index, b)
+   lab='LUDC/LUSOL n='+STRTRIM(n,2)
+   if ~ARRAY_EQUAL(SIZE(x, /dim), [n, m]) then ERRORS_ADD, nb_errors, lab+' dims'
+   for k=0, m-1 do begin
+      ;; as for a single matrix, LUSOL solves A ## x = b
+      r=a[*,*,k] ## x[*,k] - b[*,k]
+      if MAX(ABS(r)) GT 1e-10 then ERRORS_ADD, nb_errors, lab+' residual'
+      lu1=a[*,*,k]
+      LUDC, lu1, index1
+      x1=LUSOL(lu1, index1, b[*,k])
+      if MAX(ABS(x1-x[*,k])) GT 1e-10 then ERRORS_ADD, nb_errors, lab+' vs single'
+   endfor
+endfor
+;
+BANNER_FOR_TESTSUITE, 'TEST_MATRIX_BATCHED_LU', nb_errors, /short
+ERRORS_CUMUL, cumul_errors, nb_errors
+if KEYWORD_set(test) then STOP
+;
+end
+;
+; ---------------------------------
+;
+pro TEST_MATRIX_BATCHED_CHOLESKY, cumul_errors, test=test
+;
+nb_errors=0
+seed=13
+for n=2, 10 do begin
+   for dbl=0, 1 do begin
+      m=6
+      tol=(dbl ? 1e-9 : 1e-3)
+      a=TEST_MATRIX_BATCHED_STACK(n, m, seed, double=dbl, /spd)
+      b=RANDOMU(seed, n, m, double=dbl)
+      c=a
+      CHOLDC, c, p
+      x=CHOLSOL(c, p, b)
+      lab='CHOLDC/CHOLSOL n='+STRTRIM(n,2)+' double='+STRTRIM(dbl,2)
+      if ~ARRAY_EQUAL(SIZE(p, /dim), [n, m]) then ERRORS_ADD, nb_errors, lab+' dims'
+      if SIZE(x, /type) NE SIZE(a, /type) then ERRORS_ADD, nb_errors, lab+' type'
+      for k=0, m-1 do begin
+         r=a[*,*,k] ## x[*,k] - b[*,k]
+         if MAX(ABS(r)) GT tol then ERRORS_ADD, nb_errors, lab+' residual'
+      endfor
+   endfor
+endfor
+;
+; not positive definite
+a=TEST_MATRIX_BATCHED_STACK(3, 3, seed, /double, /spd)
+a[*,*,1]=-a[*,*,1]
+CATCH, err
+if err EQ 0 then begin
+   CHOLDC, a, p
+   ERRORS_ADD, nb_errors, 'CHOLDC not positive definite'
+endif
+CATCH, /cancel
+;
+BANNER_FOR_TESTSUITE, 'TEST_MATRIX_BATCHED_CHOLESKY', nb_errors, /short
+ERRORS_CUMUL, cumul_errors, nb_errors
+if KEYWORD_set(test) then STOP
+;
+end
+;
+; ---------------------------------
+;
+pro TEST_MATRIX_BATCHED_MULTIPLY, cumul_errors, test=test
+;
+nb_errors=0
+seed=14
+shapes=[[3,3,3],[4,4,4],[8,8,8],[9,9,9],[2,5,3],[6,1,4]]
+for is=0, (SIZE(shapes, /dim))[1]-1 do begin
+   n1=shapes[0,is] & n2=shapes[1,is] & n3=shapes[2,is]
+   m=5
+   for it=0, 3 do begin
+      type=([3,4,5,9])[it]
+      a=FIX(RANDOMU(seed, n1, n2, m)*10, type=type)
+      b=FIX(RANDOMU(seed, n3, n1, m)*10, type=type)
+      lab='MATRIX_MULTIPLY '+STRJOIN(STRTRIM([n1,n2,n3],2),'x')+' type='+STRTRIM(type,2)
+      ab=MATRIX_MULTIPLY(b, a)
+      abt=MATRIX_MULTIPLY(TRANSPOSE(b,[1,0,2]), a, /atranspose)
+      abtt=MATRIX_MULTIPLY(TRANSPOSE(b,[1,0,2]), TRANSPOSE(a,[1,0,2]), /atranspose, /btranspose)
+      if SIZE(ab, /type) NE type then ERRORS_ADD, nb_errors, lab+' type'
+      for k=0, m-1 do begin
+         ref=b[*,*,k] # a[*,*,k]
+         if ~ARRAY_EQUAL(ab[*,*,k], ref) then ERRORS_ADD, nb_errors, lab
+         if ~ARRAY_EQUAL(abt[*,*,k], ref) then ERRORS_ADD, nb_errors, lab+' /at'
+         if ~ARRAY_EQUAL(abtt[*,*,k], ref) then ERRORS_ADD, nb_errors, lab+' /at /bt'
+      endfor
+   endfor
+endfor
+;
+; one matrix applied to a whole stack
+a=RANDOMU(seed, 4, 4, 10)
+r=RANDOMU(seed, 4, 4)
+ra=MATRIX_MULTIPLY(r, a)
+for k=0, 9 do if MAX(ABS(ra[*,*,k]-(r # a[*,*,k]))) GT 1e-5 then $
+   ERRORS_ADD, nb_errors, 'MATRIX_MULTIPLY broadcast'
+;
+BANNER_FOR_TESTSUITE, 'TEST_MATRIX_BATCHED_MULTIPLY', nb_errors, /short
+ERRORS_CUMUL, cumul_errors, nb_errors
+if KEYWORD_set(test) then STOP
+;
+end
+;
+; -------------------------------------------------
+;
+pro TEST_MATRIX_BATCHED, no_exit=no_exit, test=test
+;
+TEST_MATRIX_BATCHED_INVERT, cumul_errors
+TEST_MATRIX_BATCHED_LU, cumul_errors
+TEST_MATRIX_BATCHED_CHOLESKY, cumul_errors
+TEST_MATRIX_BATCHED_MULTIPLY, cumul_errors
+;
+; ----------------- final message ----------
+;
+BANNER_FOR_TESTSUITE, 'TEST_MATRIX_BATCHED', cumul_errors
+;
+if (cumul_errors GT 0) AND ~KEYWORD_SET(no_exit) then EXIT, status=1
+;
+if KEYWORD_SET(test) then STOP
+;
+end
@@ -84,6 +84,73 @@ end
 ;
 ; ---------------------------------------------
 ;
+; When GDL is compiled with an external BLAS/LAPACK (-DBLAS=ON),
+; results with and without it (CPU, BLAS=0|1) must be the same.
+;
+pro TEST_MATRIX_BACKENDS, nb_errors=nb_errors, test=test, verbose=verbose
+;
+if ~KEYWORD_SET(nb_errors) then nb_errors=0
+;
+DEFSYSV, '!gdl', exist=it_is_GDL
+if ~it_is_GDL then return
+gdltags=TAG_NAMES(!gdl)
+ok=WHERE(gdltags EQ 'GDL_USE_BLAS', nb_ok)
+if (nb_ok EQ 0) then return
+;
+blas_init=!gdl.gdl_use_blas
+CPU, BLAS=1
+if ~!gdl.gdl_use_blas then begin
+   if KEYWORD_SET(verbose) then MESSAGE, /continue, 'no BLAS backend, skipping'
+   CPU, BLAS=blas_init
+   return
+endif
+;
+errors=0
+liste_type=[4,5,6,9]
+tolerance=[1e-4,1e-10,1e-4,1e-10]
+dims=[[1,7,7],[5,1,5],[7,6,5],[33,17,65],[64,64,64]]
+;
+for it=0, N_ELEMENTS(liste_type)-1 do begin
+   for id=0, (SIZE(dims,/dim))[1]-1 do begin
+      n1=dims[0,id] & n2=dims[1,id] & n3=dims[2,id]
+      a=FIX(RANDOMU(seed, n1, n2)*10, type=liste_type[it])
+      b=FIX(RANDOMU(seed, n3, n1)*10, type=liste_type[it])
+      m=FIX(RANDOMU(seed, n2, n2)*10, type=liste_type[it])+DIAG_MATRIX(REPLICATE(10,n2))
+      ;;
+      CPU, BLAS=0
+      r0=LIST(a##b, b#a, MATRIX_MULTIPLY(TRANSPOSE(b),a,/at), $
+              MATRIX_MULTIPLY(b,TRANSPOSE(a),/bt), $
+              MATRIX_MULTIPLY(TRANSPOSE(b),TRANSPOSE(a),/at,/bt), INVERT(m))
+      CPU, BLAS=1
+      r1=LIST(a##b, b#a, MATRIX_MULTIPLY(TRANSPOSE(b),a,/at), $
+              MATRIX_MULTIPLY(b,TRANSPOSE(a),/bt), $
+              MATRIX_MULTIPLY(TRANSPOSE(b),TRANSPOSE(a),/at,/bt), INVERT(m))
+      for ii=0, N_ELEMENTS(r0)-1 do begin
+         x0=r0[ii] & x1=r1[ii]
+         if ~ARRAY_EQUAL(SIZE(x0), SIZE(x1)) then begin
+            errors++
+            if KEYWORD_SET(verbose) then print, 'shape differs: ', it, id, ii
+         endif else if (MAX(ABS(x0-x1)) GT tolerance[it]*(1+MAX(ABS(x0)))) then begin
+            errors++
+            if KEYWORD_SET(verbose) then print, 'values differ: ', it, id, ii
+         endif
+      endfor
+   endfor
+endfor
+;
+CPU, BLAS=blas_init
+;
+if (errors GT 0) then begin
+    print, 'nb errors internal vs BLAS : ', errors
+    nb_errors=nb_errors+errors
+endif
+;
+if KEYWORD_SET(test) then STOP
+;
+end
+;
+; ---------------------------------------------
+;
 pro  TEST_MATRIX_MULTIPLY, no_exit=no_exit, extended=extended,$
                            help=help, verbose=verbose, test=test
 ;
@@ -114,6 +181,8 @@ for itailles=0, N_ELEMENTS(liste_taille)-1 do begin
     endfor
 endfor
 ;
+TEST_MATRIX_BACKENDS, nb_errors=nb_errors, verbose=verbose
+;
 if KEYWORD_SET(test) then STOP
 ;
 if (nb_errors GT 0) then begin
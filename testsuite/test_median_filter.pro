@@ -0,0 +1,112 @@
+;
+; under GNU GPL v2 or later
+;
+; Tests of the 2D median filter MEDIAN(array, width) on integer types.
+; BYTE, INT, UINT, LONG ... all use the constant-time histogram filter,
+; hence must give the same values, of the type of the input.
+;
+; ---------------------------------
+;
+; Modifications history :
+;
+; - 2026-10-19 : creation when the constant-time filter was extended
+;   to all integer types
+; - 2026-10-19 : BYTE images with a width above 255 stay BYTE
+;
+; ---------------------------------
+;
+; brute force version, borders replicated as in the constant-time filter.
+function MEDIAN_FILTER_REFERENCE, a, width
+;
+r=width/2
+sz=SIZE(a, /dim)
+res=a
+for j=0, sz[1]-1 do begin
+   for i=0, sz[0]-1 do begin
+      ix=(i+INDGEN(width)-r) > 0 < (sz[0]-1)
+      iy=(j+INDGEN(width)-r) > 0 < (sz[1]-1)
+      win=a[ix#REPLICATE(1,width)+REPLICATE(1,width)#iy*sz[0]]
+      res[i,j]=win[(SORT(win))[N_ELEMENTS(win)/2]]
+   endfor
+endfor
+return, res
+end
+;
+; ---------------------------------
+;
+pro TEST_MEDIAN_FILTER_BYTE, cumul_errors, test=test
+;
+nb_errors=0
+seed=33
+a=BYTE(RANDOMU(seed, 40, 27)*256)
+for width=3, 9, 2 do begin
+   if ~ARRAY_EQUAL(MEDIAN(a, width), MEDIAN_FILTER_REFERENCE(a, width)) then $
+      ERRORS_ADD, nb_errors, 'byte, width '+STRTRIM(width,2)
+endfor
+;
+; widths above 255 do not fit the 16-bit histogram bins: generic filter,
+; but the result is still of type BYTE
+b=BYTE(RANDOMU(seed, 260, 259)*256)
+res=MEDIAN(b, 257)
+if SIZE(res, /type) NE 1 then ERRORS_ADD, nb_errors, 'byte, width 257: type'
+if ~ARRAY_EQUAL(res, BYTE(MEDIAN(FLOAT(b), 257))) then ERRORS_ADD, nb_errors, 'byte, width 257'
+;
+BANNER_FOR_TESTSUITE, 'TEST_MEDIAN_FILTER_BYTE', nb_errors, /short
+ERRORS_CUMUL, cumul_errors, nb_errors
+if KEYWORD_set(test) then STOP
+;
+end
+;
+; ---------------------------------
+;
+pro TEST_MEDIAN_FILTER_INTEGERS, cumul_errors, test=test
+;
+nb_errors=0
+seed=12
+a=BYTE(RANDOMU(seed, 300, 200)*256)
+types=[2,3,12,13,14,15]
+; spread and offset the values so that the whole range of the type is used
+scale=[128,1000000,256,1000000,1000000,1000000]
+offset=[-32768,-7,0,7,-7,7]
+for width=3, 21, 6 do begin
+   ref=MEDIAN(a, width)
+   for k=0, N_ELEMENTS(types)-1 do begin
+      b=FIX(a, type=types[k])*FIX(scale[k], type=types[k])+FIX(offset[k], type=types[k])
+      res=MEDIAN(b, width)
+      if SIZE(res, /type) NE types[k] then $
+         ERRORS_ADD, nb_errors, 'type '+STRTRIM(types[k],2)
+      expected=FIX(ref, type=types[k])*FIX(scale[k], type=types[k])+FIX(offset[k], type=types[k])
+      if ~ARRAY_EQUAL(res, expected) then $
+         ERRORS_ADD, nb_errors, 'type '+STRTRIM(types[k],2)+', width '+STRTRIM(width,2)
+   endfor
+endfor
+;
+; LONG values spread over 1e9 are mapped to their ranks...
+c=LONG(RANDOMU(seed, 400, 400)*1e9)
+if ~ARRAY_EQUAL(MEDIAN(c[0:30,0:30], 5), MEDIAN_FILTER_REFERENCE(c[0:30,0:30], 5)) then $
+   ERRORS_ADD, nb_errors, 'long, ranks'
+; ... unless there are more than 65536 of them: generic filter
+if N_ELEMENTS(MEDIAN(c, 5)) NE 400L*400 then ERRORS_ADD, nb_errors, 'long, many values'
+;
+BANNER_FOR_TESTSUITE, 'TEST_MEDIAN_FILTER_INTEGERS', nb_errors, /short
+ERRORS_CUMUL, cumul_errors, nb_errors
+if KEYWORD_set(test) then STOP
+;
+end
+;
+; -------------------------------------------------
+;
+pro TEST_MEDIAN_FILTER, no_exit=no_exit, test=test
+;
+TEST_MEDIAN_FILTER_BYTE, cumul_errors
+TEST_MEDIAN_FILTER_INTEGERS, cumul_errors
+;
+; ----------------- final message ----------
+;
+BANNER_FOR_TESTSUITE, 'TEST_MEDIAN_FILTER', cumul_errors
+;
+if (cumul_errors GT 0) AND ~KEYWORD_SET(no_exit) then EXIT, status=1
+;
+if KEYWORD_SET(test) then STOP
+;
+end
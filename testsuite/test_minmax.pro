@@ -281,7 +281,59 @@ end
 ;
 ; calling all tests
 ;
-pro TEST_MINMAX, verbose=verbose
+;
+; values and subscripts of MIN, MAX and TOTAL along each dimension,
+; against the same reductions on the extracted vectors
+pro DIMENSION_VALUES_TEST_MINMAX, cumul_errors
+;
+nb_errors=0
+seed=12
+dims=[7, 600, 3]
+ix=LINDGEN(dims)
+for type=0, 3 do begin
+   case type of
+      0: begin & data=RANDOMN(seed, dims) & data[[3, 50, 4000, 12000]]=!values.f_nan & end
+      1: data=LONG(RANDOMN(seed, dims)*100)
+      2: data=BYTE(RANDOMU(seed, dims)*5)
+      3: data=RANDOMN(seed, dims, /double)
+   endcase
+   if type EQ 0 then data[*, *, 1]=!values.f_nan ; whole columns of NaNs
+   for dim=1, 3 do begin
+      lab='type '+STRTRIM(type,2)+' dim '+STRTRIM(dim,2)
+      perm=[dim-1, WHERE(INDGEN(3) NE dim-1)]
+      t=REFORM(TRANSPOSE(data, perm), dims[dim-1], N_ELEMENTS(data)/dims[dim-1])
+      it=REFORM(TRANSPOSE(ix, perm), dims[dim-1], N_ELEMENTS(data)/dims[dim-1])
+      for opt=0, 2 do begin
+         nan=(opt EQ 1) & abs=(opt EQ 2)
+         mini=MIN(data, imin, dim=dim, max=maxi, sub=imax, nan=nan, abs=abs)
+         maxi2=MAX(data, imax2, dim=dim, nan=nan, abs=abs)
+         for j=0, N_ELEMENTS(mini)-1 do begin
+            ref=MIN(t[*,j], i1, max=refmax, sub=i2, nan=nan, abs=abs)
+            ; a column of NaNs gives its first value at index 0
+            if nan && ~FINITE(ref) then begin
+               if imin[j] NE 0 || imax[j] NE 0 then ERRORS_ADD, nb_errors, 'NaN column '+lab
+               continue
+            endif
+            v=[mini[j], maxi[j], maxi2[j]] & r=[ref, refmax, refmax]
+            same=(v EQ r) OR (~FINITE(v) AND ~FINITE(r))
+            if (TOTAL(same) NE 3) || imin[j] NE it[i1,j] || imax[j] NE it[i2,j] || imax2[j] NE it[i2,j] then begin
+               ERRORS_ADD, nb_errors, lab+' opt '+STRTRIM(opt,2)+' output '+STRTRIM(j,2)
+               break
+            endif
+         endfor
+      endfor
+      tot=TOTAL(data, dim, /nan)
+      reft=TOTAL(t, 1, /nan)
+      if MAX(ABS(tot-REFORM(reft, SIZE(tot, /dim)))) GT 1e-3 then ERRORS_ADD, nb_errors, 'TOTAL '+lab
+   endfor
+endfor
+;
+BANNER_FOR_TESTSUITE, 'DIMENSION_VALUES_TEST_MINMAX', nb_errors, /short
+ERRORS_CUMUL, cumul_errors, nb_errors
+;
+end
+;
+pro TEST_MINMAX, verbose=verbose, no_exit=no_exit
 ;
 filename='minmax.'+GDL_IDL_FL()
 if FILE_TEST(filename) then begin
@@ -304,4 +356,10 @@ BENCH_TEST_MINMAX, lun, nbp=1e7
 printf,lun, '' & printf,lun, 'Testing the DIMENSION keyword (no output)'
 DIMENSION_TEST_MINMAX
 ;
+DIMENSION_VALUES_TEST_MINMAX, cumul_errors
+;
+FREE_LUN, lun
+BANNER_FOR_TESTSUITE, 'TEST_MINMAX', cumul_errors
+if (cumul_errors GT 0) AND ~KEYWORD_SET(no_exit) then EXIT, status=1
+;
 end
@@ -0,0 +1,149 @@
+;
+; under GNU GPL v2 or later
+;
+; Tests of MOMENT (and its wrappers VARIANCE, STDDEV, SKEWNESS,
+; KURTOSIS) against explicit two-pass formulas, with /NAN, /DOUBLE,
+; MAXMOMENT and DIMENSION.
+;
+; ---------------------------------
+;
+; Modifications history :
+;
+; - 2026-10-19 : creation
+;
+; ---------------------------------
+;
+; reference moments of a vector, two passes, in double
+function TEST_MOMENT_REF, x
+;
+x=DOUBLE(x)
+n=N_ELEMENTS(x)
+m=TOTAL(x)/n
+d=x-m
+var=TOTAL(d^2)/(n-1)
+return, [m, var, TOTAL(d^3)/n/var^1.5, TOTAL(d^4)/n/var^2-3, SQRT(var), TOTAL(ABS(d))/n]
+end
+;
+; ---------------------------------
+;
+function TEST_MOMENT_CLOSE, a, b, tol
+return, MAX(ABS(a-b)/(ABS(b) > 1)) LE tol
+end
+;
+; ---------------------------------
+;
+pro TEST_MOMENT_BASIC, cumul_errors, test=test
+;
+nb_errors=0
+seed=41
+;
+; an offset large compared to the spread: a one-pass naive formula fails
+x=1d8+RANDOMU(seed, 100003, /double)
+ref=TEST_MOMENT_REF(x)
+r=MOMENT(x, sdev=sdev, mdev=mdev)
+if ~TEST_MOMENT_CLOSE(r, ref[0:3], 1d-9) then ERRORS_ADD, nb_errors, 'double, offset'
+if ~TEST_MOMENT_CLOSE([sdev, mdev], ref[4:5], 1d-9) then ERRORS_ADD, nb_errors, 'sdev, mdev'
+;
+x=RANDOMN(seed, 5001)*3+2
+ref=TEST_MOMENT_REF(x)
+r=MOMENT(x)
+if SIZE(r, /type) NE 4 || N_ELEMENTS(r) NE 4 then ERRORS_ADD, nb_errors, 'float result'
+if ~TEST_MOMENT_CLOSE(r, ref[0:3], 1e-5) then ERRORS_ADD, nb_errors, 'float'
+if SIZE(MOMENT(x, /double), /type) NE 5 then ERRORS_ADD, nb_errors, '/DOUBLE'
+if ~TEST_MOMENT_CLOSE(VARIANCE(x), ref[1], 1e-5) then ERRORS_ADD, nb_errors, 'VARIANCE'
+if ~TEST_MOMENT_CLOSE(STDDEV(x), ref[4], 1e-5) then ERRORS_ADD, nb_errors, 'STDDEV'
+if ~TEST_MOMENT_CLOSE(SKEWNESS(x), ref[2], 1e-4) then ERRORS_ADD, nb_errors, 'SKEWNESS'
+if ~TEST_MOMENT_CLOSE(KURTOSIS(x), ref[3], 1e-4) then ERRORS_ADD, nb_errors, 'KURTOSIS'
+;
+; integer input
+r=MOMENT(INDGEN(10), mean=m, variance=v)
+if m NE 4.5 || ABS(v-55/6.) GT 1e-5 then ERRORS_ADD, nb_errors, 'integer'
+if r[2] NE 0 then ERRORS_ADD, nb_errors, 'integer, skewness'
+;
+; MAXMOMENT
+r=MOMENT(x, maxmoment=2)
+if ~FINITE(r[1]) || FINITE(r[2]) || FINITE(r[3]) then ERRORS_ADD, nb_errors, 'MAXMOMENT=2'
+r=MOMENT(x, maxmoment=1)
+if ~FINITE(r[0]) || FINITE(r[1]) then ERRORS_ADD, nb_errors, 'MAXMOMENT=1'
+; constant values: no skewness, no kurtosis
+r=MOMENT(REPLICATE(3., 10))
+if r[0] NE 3 || r[1] NE 0 || FINITE(r[2]) then ERRORS_ADD, nb_errors, 'constant'
+;
+; /NAN
+y=x & y[[3, 1000, 5000]]=!values.f_nan
+ref=TEST_MOMENT_REF(y[WHERE(FINITE(y))])
+r=MOMENT(y, /nan, mdev=mdev)
+if ~TEST_MOMENT_CLOSE([r, mdev], ref[[0,1,2,3,5]], 1e-4) then ERRORS_ADD, nb_errors, '/NAN'
+if FINITE(MEAN(MOMENT(y))) then ERRORS_ADD, nb_errors, 'NaN without /NAN'
+;
+BANNER_FOR_TESTSUITE, 'TEST_MOMENT_BASIC', nb_errors, /short
+ERRORS_CUMUL, cumul_errors, nb_errors
+if KEYWORD_set(test) then STOP
+;
+end
+;
+; ---------------------------------
+;
+pro TEST_MOMENT_DIMENSION, cumul_errors, test=test
+;
+nb_errors=0
+seed=42
+;
+; some columns cross the blocks used along the dimension
+dims=[7, 300, 5]
+x=RANDOMU(seed, dims, /double)*10+RANDOMN(seed, dims, /double)^2
+x[2,17,3]=!values.d_nan
+for dim=1, 3 do begin
+   lab='DIMENSION='+STRTRIM(dim,2)
+   r=MOMENT(x, dimension=dim, /nan, sdev=sdev, mdev=mdev, kurtosis=kurt)
+   odims=dims[WHERE(INDGEN(3) NE dim-1)]
+   if ~ARRAY_EQUAL(SIZE(r, /dim), [odims, 4]) then ERRORS_ADD, nb_errors, 'size '+lab
+   if ~ARRAY_EQUAL(SIZE(sdev, /dim), odims) then ERRORS_ADD, nb_errors, 'SDEV size '+lab
+   r=REFORM(r, PRODUCT(odims), 4)
+   ; move the dimension first to compare with the reference
+   perm=[dim-1, WHERE(INDGEN(3) NE dim-1)]
+   t=REFORM(TRANSPOSE(x, perm), dims[dim-1], PRODUCT(odims))
+   for j=0, PRODUCT(odims)-1 do begin
+      v=t[*,j]
+      ref=TEST_MOMENT_REF(v[WHERE(FINITE(v))])
+      if ~TEST_MOMENT_CLOSE([REFORM(r[j,*]), sdev[j], mdev[j]], ref, 1d-9) then begin
+         ERRORS_ADD, nb_errors, lab+' output '+STRTRIM(j,2)
+         break
+      endif
+   endfor
+   if ~ARRAY_EQUAL(KURTOSIS(x, dimension=dim, /nan), REFORM(r[*,3], odims)) then $
+      ERRORS_ADD, nb_errors, 'KURTOSIS '+lab
+endfor
+;
+; same values whatever the number of threads
+SAVECPU=!CPU
+z=RANDOMU(seed, 1000, 2000)
+CPU, TPOOL_NTHREADS=1
+r1=LIST(MOMENT(z), MOMENT(z, dim=1), MOMENT(z, dim=2))
+CPU, TPOOL_NTHREADS=!CPU.HW_NCPU > 4, TPOOL_MIN_ELTS=1000
+r2=LIST(MOMENT(z), MOMENT(z, dim=1), MOMENT(z, dim=2))
+CPU, RESTORE=SAVECPU
+for i=0, 2 do if ~ARRAY_EQUAL(r1[i], r2[i]) then ERRORS_ADD, nb_errors, 'threads, case '+STRTRIM(i,2)
+;
+BANNER_FOR_TESTSUITE, 'TEST_MOMENT_DIMENSION', nb_errors, /short
+ERRORS_CUMUL, cumul_errors, nb_errors
+if KEYWORD_set(test) then STOP
+;
+end
+;
+; -------------------------------------------------
+;
+pro TEST_MOMENT, no_exit=no_exit, test=test
+;
+TEST_MOMENT_BASIC, cumul_errors
+TEST_MOMENT_DIMENSION, cumul_errors
+;
+; ----------------- final message ----------
+;
+BANNER_FOR_TESTSUITE, 'TEST_MOMENT', cumul_errors
+;
+if (cumul_errors GT 0) AND ~KEYWORD_SET(no_exit) then EXIT, status=1
+;
+if KEYWORD_SET(test) then STOP
+;
+end
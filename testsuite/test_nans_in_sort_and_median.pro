@@ -89,6 +89,33 @@ if ~ARRAY_EQUAL(MEDIAN(a, dim=1), [!VALUES.F_INFINITY, 500]) then begin
     error_median++
 endif
 ;
+; DIMENSION over the non-leading axes of a cube containing NaNs
+a = RANDOMU(seed, 7, 5, 6)
+a[WHERE(RANDOMU(seed, 7, 5, 6) LT 0.2)] = !VALUES.F_NAN
+a[*, 2, *] = !VALUES.F_NAN
+m2 = MEDIAN(a, dim=2)
+m3 = MEDIAN(a, dim=3, /even)
+nb = 0
+for i = 0, 6 do for k = 0, 5 do begin
+    ref = MEDIAN(REFORM(a[i, *, k]))
+    if ~((m2[i, k] EQ ref) OR (FINITE(m2[i, k]) EQ 0 AND FINITE(ref) EQ 0)) then nb++
+endfor
+for i = 0, 6 do for j = 0, 4 do begin
+    ok = WHERE(FINITE(a[i, j, *]), nok)
+    if nok EQ 0 then begin
+        if FINITE(m3[i, j]) then nb++
+        continue
+    endif
+    s = (REFORM(a[i, j, *]))[ok]
+    s = s[SORT(s)]
+    ref = (nok MOD 2) ? s[nok/2] : 0.5*(s[nok/2]+s[nok/2-1])
+    if ABS(m3[i, j]-ref) GT 1e-6 then nb++
+endfor
+if nb GT 0 then begin
+    MESSAGE, '[M9] MEDIAN() failed with DIMENSION=2 or 3 on a 3D array containing NaNs', /conti
+    error_median++
+endif
+;
 if ((error_sort GT 0) OR (error_median GT 0)) then begin
     MESSAGE, /continue, 'Errors detected'
     if (error_sort GT 0) then MESSAGE, /continue, STRING(error_sort)+' in SORT() test'
@@ -0,0 +1,140 @@
+;
+; under GNU GPL v2 or later
+;
+; With the (default) dSFMT generator, RANDOMU/RANDOMN draw large arrays
+; in blocks, each from its own jumped-ahead stream: for a given seed the
+; values must not depend on the !CPU settings (number of threads,
+; TPOOL_MIN_ELTS). Also basic moments of the distributions.
+;
+; ---------------------------------
+;
+; Modifications history :
+;
+; - 2026-10-19 : creation
+; - 2026-10-19 : binomial by inversion
+; - 2026-10-19 : fixed number of streams, whatever the host
+;
+; ---------------------------------
+;
+function TEST_RANDOM_STREAMS_DRAW, kind, nbp
+;
+seed=33
+case kind of
+   0: r=RANDOMU(seed, nbp)
+   1: r=RANDOMU(seed, nbp, /double)
+   2: r=RANDOMN(seed, nbp, /double)
+   3: r=RANDOMU(seed, nbp, gamma=5, /double)
+   4: r=RANDOMU(seed, nbp, poisson=3.5, /double)
+   5: r=RANDOMU(seed, nbp, poisson=40, /double)
+   6: r=RANDOMU(seed, nbp, binomial=[20, 0.3], /double)
+   7: r=RANDOMU(seed, nbp, /long)
+endcase
+; the state of the generator after the call must also be the same
+return, {r:r, next:RANDOMU(seed, 3, /double)}
+end
+;
+; ---------------------------------
+;
+pro TEST_RANDOM_STREAMS_THREADS, cumul_errors, test=test
+;
+nb_errors=0
+nbp=1000001L
+SAVECPU=!CPU
+;
+names=['uniform','uniform double','normal','gamma','poisson small','poisson large','binomial','long']
+for kind=0, N_ELEMENTS(names)-1 do begin
+   CPU, TPOOL_NTHREADS=1
+   ref=TEST_RANDOM_STREAMS_DRAW(kind, nbp)
+   CPU, TPOOL_NTHREADS=!CPU.HW_NCPU, TPOOL_MIN_ELTS=1000
+   r=TEST_RANDOM_STREAMS_DRAW(kind, nbp)
+   if ~ARRAY_EQUAL(r.r, ref.r) then ERRORS_ADD, nb_errors, 'threads: '+names[kind]
+   if ~ARRAY_EQUAL(r.next, ref.next) then ERRORS_ADD, nb_errors, 'threads, next values: '+names[kind]
+   CPU, TPOOL_NTHREADS=3, TPOOL_MIN_ELTS=100000
+   r=TEST_RANDOM_STREAMS_DRAW(kind, nbp)
+   if ~ARRAY_EQUAL(r.r, ref.r) then ERRORS_ADD, nb_errors, '3 threads: '+names[kind]
+   CPU, RESTORE=SAVECPU
+endfor
+;
+; the number of streams is fixed: 64 states of 382+1 values plus the seed
+seed=33
+r=RANDOMU(seed, 10)
+if N_ELEMENTS(seed) NE 1+383L*64 then ERRORS_ADD, nb_errors, 'state size'
+;
+CPU, RESTORE=SAVECPU
+BANNER_FOR_TESTSUITE, 'TEST_RANDOM_STREAMS_THREADS', nb_errors, /short
+ERRORS_CUMUL, cumul_errors, nb_errors
+if KEYWORD_set(test) then STOP
+;
+end
+;
+; ---------------------------------
+;
+pro TEST_RANDOM_STREAMS_MOMENTS, cumul_errors, test=test
+;
+nb_errors=0
+nbp=2000000L
+seed=34
+;
+; [expected mean, expected variance] for each distribution
+r=RANDOMU(seed, nbp, /double)
+if ABS(MEAN(r)-0.5) GT 2e-3 || ABS(VARIANCE(r)-1/12d) GT 2e-3 then ERRORS_ADD, nb_errors, 'uniform'
+if MIN(r) LT 0 || MAX(r) GE 1 then ERRORS_ADD, nb_errors, 'uniform range'
+;
+r=RANDOMN(seed, nbp, /double)
+if ABS(MEAN(r)) GT 3e-3 || ABS(VARIANCE(r)-1) GT 5e-3 then ERRORS_ADD, nb_errors, 'normal'
+if ABS(TOTAL(r^3)/nbp) GT 1e-2 || ABS(TOTAL(r^4)/nbp-3) GT 3e-2 then ERRORS_ADD, nb_errors, 'normal moments'
+; an odd number of values
+r=RANDOMN(seed, 7)
+if N_ELEMENTS(r) NE 7 || SIZE(r, /type) NE 4 then ERRORS_ADD, nb_errors, 'normal, odd size'
+;
+foreach g, [1, 4, 30] do begin
+   r=RANDOMU(seed, nbp, gamma=g, /double)
+   if ABS(MEAN(r)-g) GT 5e-3*g || ABS(VARIANCE(r)-g) GT 1e-2*g then $
+      ERRORS_ADD, nb_errors, 'gamma='+STRTRIM(g,2)
+   if MIN(r) LE 0 then ERRORS_ADD, nb_errors, 'gamma range'
+endforeach
+;
+foreach mu, [0.5, 3.5, 40] do begin
+   r=RANDOMU(seed, nbp, poisson=mu)
+   if ABS(MEAN(r)-mu) GT 5e-3*(mu > 1) || ABS(VARIANCE(r)-mu) GT 1e-2*(mu > 1) then $
+      ERRORS_ADD, nb_errors, 'poisson='+STRTRIM(mu,2)
+   if ~ARRAY_EQUAL(r, FLOOR(r)) then ERRORS_ADD, nb_errors, 'poisson integer values'
+endforeach
+;
+; binomial and poisson go by inversion of a tabulated CDF, except for few values of a wide
+; distribution
+foreach b, LIST([20, 0.3], [1000, 0.002], [1e6, 0.4], [50, 0.999]) do begin
+   m=b[0]*b[1] & v=m*(1-b[1])
+   r=RANDOMU(seed, nbp, binomial=b, /double)
+   if ABS(MEAN(r)-m) GT 5e-3*(m > 1) || ABS(VARIANCE(r)-v) GT 2e-2*(v > 1) then $
+      ERRORS_ADD, nb_errors, 'binomial='+STRJOIN(STRTRIM(b,2),',')
+   if ~ARRAY_EQUAL(r, FLOOR(r)) || MIN(r) LT 0 || MAX(r) GT b[0] then ERRORS_ADD, nb_errors, 'binomial values'
+endforeach
+if ~ARRAY_EQUAL(RANDOMU(seed, 100, binomial=[10, 0.]), 0) then ERRORS_ADD, nb_errors, 'binomial p=0'
+if ~ARRAY_EQUAL(RANDOMU(seed, 100, binomial=[10, 1.]), 10) then ERRORS_ADD, nb_errors, 'binomial p=1'
+r=RANDOMU(seed, 10, binomial=[1e9, 0.5], /double)
+if MAX(ABS(r-5e8)) GT 2e5 then ERRORS_ADD, nb_errors, 'binomial, few values'
+if ~ARRAY_EQUAL(RANDOMU(seed, 100, poisson=0.), 0) then ERRORS_ADD, nb_errors, 'poisson=0'
+;
+BANNER_FOR_TESTSUITE, 'TEST_RANDOM_STREAMS_MOMENTS', nb_errors, /short
+ERRORS_CUMUL, cumul_errors, nb_errors
+if KEYWORD_set(test) then STOP
+;
+end
+;
+; -------------------------------------------------
+;
+pro TEST_RANDOM_STREAMS, no_exit=no_exit, test=test
+;
+TEST_RANDOM_STREAMS_THREADS, cumul_errors
+TEST_RANDOM_STREAMS_MOMENTS, cumul_errors
+;
+; ----------------- final message ----------
+;
+BANNER_FOR_TESTSUITE, 'TEST_RANDOM_STREAMS', cumul_errors
+;
+if (cumul_errors GT 0) AND ~KEYWORD_SET(no_exit) then EXIT, status=1
+;
+if KEYWORD_SET(test) then STOP
+;
+end
@@ -0,0 +1,148 @@
+;
+; under GNU GPL v2 or later
+;
+; Conversions between BYTE, INT, UINT, LONG and FLOAT or DOUBLE arrays use
+; vectorized kernels (see src/simd_dispatch.hpp), and FLOAT or DOUBLE
+; arrays combined by + - * / with an array of such an inferior type convert
+; it within the operation. The results must be those of the element by
+; element conversion (truncation towards zero for the integer types).
+;
+; ---------------------------------
+;
+; Modifications history :
+;
+; - 2026-10-19 : creation
+;
+; ---------------------------------
+;
+; the conversion of each element (single elements are not vectorized)
+function TEST_SIMD_CONVERT_SCALAR, fun, a
+;
+r=CALL_FUNCTION(fun, a)
+for i=0, N_ELEMENTS(a)-1 do r[i]=CALL_FUNCTION(fun, a[i])
+return, r
+end
+;
+; ---------------------------------
+;
+pro TEST_SIMD_CONVERT_TYPES, cumul_errors, test=test
+;
+nb_errors=0
+seed=61
+SAVECPU=!CPU
+; also the blocks handled in parallel
+CPU, TPOOL_MIN_ELTS=1000
+;
+funs=['BYTE','FIX','UINT','LONG','FLOAT','DOUBLE']
+foreach n, [2, 7, 17, 300, 50001] do begin
+   d=RANDOMU(seed, n, /double)*400-200
+   d[0]=-0.75
+   f=FLOAT(d)
+   ; the integer sources, also negative values
+   b=BYTE(RANDOMU(seed, n)*256)
+   i=FIX(RANDOMU(seed, n)*65536-32768)
+   u=UINT(RANDOMU(seed, n)*65536)
+   l=LONG(RANDOMU(seed, n, /double)*4d9-2d9)
+   srcs=LIST(b, i, u, l, f, d)
+   foreach a, srcs, k do begin
+      foreach fun, funs, j do begin
+         ; integer to integer conversions are not concerned
+         if (j LT 4) && (k LT 4) then continue
+         lab=fun+' of '+SIZE(a, /tname)+' n='+STRTRIM(n,2)
+         r=CALL_FUNCTION(fun, a)
+         s=TEST_SIMD_CONVERT_SCALAR(fun, a)
+         if SIZE(r, /type) NE SIZE(s, /type) then ERRORS_ADD, nb_errors, 'type '+lab
+         if ~ARRAY_EQUAL(r, s) then ERRORS_ADD, nb_errors, lab
+      endforeach
+   endforeach
+endforeach
+;
+; truncation towards zero, as IDL
+x=[-2.7d, -1.5, -0.5, 0.5, 1.5, 2.7, 100.9, -100.9]
+if ~ARRAY_EQUAL(FIX(x), [-2, -1, 0, 0, 1, 2, 100, -100]) then ERRORS_ADD, nb_errors, 'FIX truncation'
+if ~ARRAY_EQUAL(LONG(FLOAT(x)), [-2, -1, 0, 0, 1, 2, 100, -100]) then ERRORS_ADD, nb_errors, 'LONG truncation'
+;
+; the dimensions are kept
+a=FINDGEN(3, 4, 5)
+if ~ARRAY_EQUAL(SIZE(LONG(a), /dim), [3, 4, 5]) then ERRORS_ADD, nb_errors, 'dimensions'
+;
+CPU, RESTORE=SAVECPU
+BANNER_FOR_TESTSUITE, 'TEST_SIMD_CONVERT_TYPES', nb_errors, /short
+ERRORS_CUMUL, cumul_errors, nb_errors
+if KEYWORD_set(test) then STOP
+;
+end
+;
+; ---------------------------------
+;
+pro TEST_SIMD_CONVERT_MIXED, cumul_errors, test=test
+;
+nb_errors=0
+seed=62
+SAVECPU=!CPU
+CPU, TPOOL_MIN_ELTS=1000
+;
+foreach n, [3, 17, 2049, 50001] do begin
+   for dbl=0, 1 do begin
+      x=RANDOMU(seed, n, double=dbl)*100+1
+      tx=(dbl ? 'DOUBLE' : 'FLOAT')
+      others=LIST(BYTE(RANDOMU(seed, n)*255+1), FIX(RANDOMU(seed, n)*200-100), $
+                  UINT(RANDOMU(seed, n)*60000), LONG(RANDOMU(seed, n)*2e6-1e6))
+      if dbl then others.Add, RANDOMU(seed, n)*10-5
+      foreach y, others do begin
+         lab=tx+' and '+SIZE(y, /tname)+' n='+STRTRIM(n,2)
+         yc=CALL_FUNCTION(tx, y)
+         ; both orders; variables, then expressions (temporaries)
+         if ~ARRAY_EQUAL(x+y, x+yc) || ~ARRAY_EQUAL(y+x, yc+x) then ERRORS_ADD, nb_errors, '+ '+lab
+         if ~ARRAY_EQUAL(x-y, x-yc) || ~ARRAY_EQUAL(y-x, yc-x) then ERRORS_ADD, nb_errors, '- '+lab
+         if ~ARRAY_EQUAL(x*y, x*yc) || ~ARRAY_EQUAL(y*x, yc*x) then ERRORS_ADD, nb_errors, '* '+lab
+         if ~ARRAY_EQUAL(x/y, x/yc) || ~ARRAY_EQUAL(y/x, yc/x) then ERRORS_ADD, nb_errors, '/ '+lab
+         if ~ARRAY_EQUAL((x*1B)+(y*1B), x+yc) then ERRORS_ADD, nb_errors, '+ temporaries '+lab
+         if ~ARRAY_EQUAL((y*1B)-(x*1B), yc-x) then ERRORS_ADD, nb_errors, '- temporaries '+lab
+         if ~ARRAY_EQUAL((x*1B)*(y*1B), x*yc) then ERRORS_ADD, nb_errors, '* temporaries '+lab
+         if ~ARRAY_EQUAL((y*1B)/(x*1B), yc/x) then ERRORS_ADD, nb_errors, '/ temporaries '+lab
+         if SIZE(x+y, /type) NE SIZE(x, /type) || SIZE(y*x, /type) NE SIZE(x, /type) then $
+            ERRORS_ADD, nb_errors, 'type '+lab
+      endforeach
+   endfor
+endforeach
+;
+; the result has the dimensions of the smaller operand, of the first one
+; if of the same size
+a=FINDGEN(4, 5)
+b=INDGEN(20)
+c=LINDGEN(2, 3)
+if ~ARRAY_EQUAL(SIZE(a+b, /dim), [4, 5]) then ERRORS_ADD, nb_errors, 'dim a+b'
+if ~ARRAY_EQUAL(SIZE(b+a, /dim), [20]) then ERRORS_ADD, nb_errors, 'dim b+a'
+if ~ARRAY_EQUAL(SIZE(a*c, /dim), [2, 3]) then ERRORS_ADD, nb_errors, 'dim a*c'
+if ~ARRAY_EQUAL(a*c, a[0:5]*FLOAT(c[*])) then ERRORS_ADD, nb_errors, 'values a*c'
+if ~ARRAY_EQUAL(c-a, FLOAT(c[*])-a[0:5]) then ERRORS_ADD, nb_errors, 'values c-a'
+;
+; the operands are not modified
+b0=b
+r=a/b
+if ~ARRAY_EQUAL(b, b0) || SIZE(b, /type) NE 2 then ERRORS_ADD, nb_errors, 'operand modified'
+;
+CPU, RESTORE=SAVECPU
+BANNER_FOR_TESTSUITE, 'TEST_SIMD_CONVERT_MIXED', nb_errors, /short
+ERRORS_CUMUL, cumul_errors, nb_errors
+if KEYWORD_set(test) then STOP
+;
+end
+;
+; -------------------------------------------------
+;
+pro TEST_SIMD_CONVERT, no_exit=no_exit, test=test
+;
+TEST_SIMD_CONVERT_TYPES, cumul_errors
+TEST_SIMD_CONVERT_MIXED, cumul_errors
+;
+; ----------------- final message ----------
+;
+BANNER_FOR_TESTSUITE, 'TEST_SIMD_CONVERT', cumul_errors
+;
+if (cumul_errors GT 0) AND ~KEYWORD_SET(no_exit) then EXIT, status=1
+;
+if KEYWORD_SET(test) then STOP
+;
+end
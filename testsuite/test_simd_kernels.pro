@@ -0,0 +1,268 @@
+;
+; under GNU GPL v2 or later
+;
+; FLOAT and DOUBLE arithmetic, the < and > operators, comparisons and
+; byte swapping run through kernels selected at startup for the CPU
+; (SSE2/NEON, AVX2, AVX-512, see !GDL.GDL_SIMD and GDL_SIMD). The array
+; results must be the ones of the element by element (scalar) operations,
+; for all the array sizes (vector tails) and with NaN.
+;
+; ---------------------------------
+;
+; Modifications history :
+;
+; - 2026-10-19 : creation
+;
+; ---------------------------------
+;
+; same values, same NaN
+function TEST_SIMD_SAME, x, y
+;
+if N_ELEMENTS(x) NE N_ELEMENTS(y) then return, 0
+if SIZE(x, /type) NE SIZE(y, /type) then return, 0
+nx=~FINITE(x, /nan)
+if ~ARRAY_EQUAL(nx, ~FINITE(y, /nan)) then return, 0
+ok=WHERE(nx EQ 0, nok)
+if nok EQ 0 then return, 1
+return, ARRAY_EQUAL(x[ok], y[ok])
+end
+;
+; ---------------------------------
+;
+; indices checked element by element: the head, the tail and some others
+function TEST_SIMD_INDICES, n, seed
+;
+if n LE 64 then return, LINDGEN(n)
+idx=[LINDGEN(32), n-32+LINDGEN(32), LONG(RANDOMU(seed, 64)*n)]
+return, idx[UNIQ(idx, SORT(idx))]
+end
+;
+; ---------------------------------
+;
+pro TEST_SIMD_KERNELS_SYSVAR, cumul_errors, test=test
+;
+nb_errors=0
+;
+DEFSYSV, '!gdl', exist=it_is_GDL
+if it_is_GDL then begin
+   gdltags=TAG_NAMES(!gdl)
+   ok=WHERE(gdltags EQ 'GDL_SIMD', nb_ok)
+   if nb_ok EQ 0 then ERRORS_ADD, nb_errors, 'no !GDL.GDL_SIMD' $
+   else if STRLEN(!gdl.gdl_simd) EQ 0 then ERRORS_ADD, nb_errors, 'empty !GDL.GDL_SIMD'
+endif
+;
+BANNER_FOR_TESTSUITE, 'TEST_SIMD_KERNELS_SYSVAR', nb_errors, /short
+ERRORS_CUMUL, cumul_errors, nb_errors
+if KEYWORD_set(test) then STOP
+;
+end
+;
+; ---------------------------------
+;
+pro TEST_SIMD_KERNELS_ARITH, cumul_errors, test=test
+;
+nb_errors=0
+seed=41
+SAVECPU=!CPU
+; also the blocks handled in parallel
+CPU, TPOOL_MIN_ELTS=1000
+;
+ops=['+','-','*','/','<','>']
+foreach n, [1, 2, 3, 7, 15, 17, 33, 1001, 50001] do begin
+   for dbl=0, 1 do begin
+      a=RANDOMU(seed, n, double=dbl)*10-5
+      b=RANDOMU(seed, n, double=dbl)*10-5
+      s=(dbl ? -1.25d : -1.25)
+      if n GT 4 then begin
+         a[1]=!values.f_nan
+         b[2]=!values.f_nan
+         b[3]=0
+      endif
+      idx=TEST_SIMD_INDICES(n, seed)
+      for k=0, N_ELEMENTS(ops)-1 do begin
+         lab=ops[k]+' n='+STRTRIM(n,2)+' double='+STRTRIM(dbl,2)
+         case k of
+            0: begin & vv=a+b & vs=a+s & sv=s+a & end
+            1: begin & vv=a-b & vs=a-s & sv=s-a & end
+            2: begin & vv=a*b & vs=a*s & sv=s*a & end
+            3: begin & vv=a/b & vs=a/s & sv=s/a & end
+            4: begin & vv=a<b & vs=a<s & sv=s<a & end
+            5: begin & vv=a>b & vs=a>s & sv=s>a & end
+         endcase
+         ; in place
+         ip=a
+         case k of
+            0: ip+=b
+            1: ip-=b
+            2: ip*=b
+            3: ip/=b
+            4: ip=TEMPORARY(ip)<b
+            5: ip=TEMPORARY(ip)>b
+         endcase
+         rvv=vv[idx] & rvs=vs[idx] & rsv=sv[idx]
+         for j=0, N_ELEMENTS(idx)-1 do begin
+            i=idx[j]
+            case k of
+               0: begin & rvv[j]=a[i]+b[i] & rvs[j]=a[i]+s & rsv[j]=s+a[i] & end
+               1: begin & rvv[j]=a[i]-b[i] & rvs[j]=a[i]-s & rsv[j]=s-a[i] & end
+               2: begin & rvv[j]=a[i]*b[i] & rvs[j]=a[i]*s & rsv[j]=s*a[i] & end
+               3: begin & rvv[j]=a[i]/b[i] & rvs[j]=a[i]/s & rsv[j]=s/a[i] & end
+               4: begin & rvv[j]=a[i]<b[i] & rvs[j]=a[i]<s & rsv[j]=s<a[i] & end
+               5: begin & rvv[j]=a[i]>b[i] & rvs[j]=a[i]>s & rsv[j]=s>a[i] & end
+            endcase
+         endfor
+         if ~TEST_SIMD_SAME(vv[idx], rvv) then ERRORS_ADD, nb_errors, 'array op array '+lab
+         if ~TEST_SIMD_SAME(vs[idx], rvs) then ERRORS_ADD, nb_errors, 'array op scalar '+lab
+         ; scalar < array may be evaluated as array < scalar (NaN aside)
+         fin=(k GE 4) ? WHERE(FINITE(a[idx])) : LINDGEN(N_ELEMENTS(idx))
+         if ~TEST_SIMD_SAME((sv[idx])[fin], rsv[fin]) then ERRORS_ADD, nb_errors, 'scalar op array '+lab
+         if ~TEST_SIMD_SAME(ip, vv) then ERRORS_ADD, nb_errors, 'in place '+lab
+      endfor
+   endfor
+endforeach
+;
+; the < and > operators keep the left operand when comparing with NaN
+nan=!values.f_nan
+if ~TEST_SIMD_SAME([nan, 1, 2]<[1, nan, 0], [nan, 1, 0]) then ERRORS_ADD, nb_errors, '< with NaN'
+if ~TEST_SIMD_SAME([nan, 1, 2]>[1, nan, 3], [nan, 1, 3]) then ERRORS_ADD, nb_errors, '> with NaN'
+;
+CPU, RESTORE=SAVECPU
+BANNER_FOR_TESTSUITE, 'TEST_SIMD_KERNELS_ARITH', nb_errors, /short
+ERRORS_CUMUL, cumul_errors, nb_errors
+if KEYWORD_set(test) then STOP
+;
+end
+;
+; ---------------------------------
+;
+pro TEST_SIMD_KERNELS_COMPARE, cumul_errors, test=test
+;
+nb_errors=0
+seed=42
+SAVECPU=!CPU
+CPU, TPOOL_MIN_ELTS=1000
+;
+ops=['EQ','NE','LE','LT','GE','GT']
+foreach n, [3, 17, 1001, 50001] do begin
+   for dbl=0, 1 do begin
+      ; few distinct values for EQ
+      a=FLOAT(FIX(RANDOMU(seed, n)*4))
+      b=FLOAT(FIX(RANDOMU(seed, n)*4))
+      if dbl then begin & a=DOUBLE(a) & b=DOUBLE(b) & endif
+      a[1]=!values.f_nan
+      b[2]=!values.f_nan
+      s=a[0]
+      idx=TEST_SIMD_INDICES(n, seed)
+      for k=0, N_ELEMENTS(ops)-1 do begin
+         lab=ops[k]+' n='+STRTRIM(n,2)+' double='+STRTRIM(dbl,2)
+         case k of
+            0: begin & vv=a EQ b & vs=a EQ s & sv=s EQ a & end
+            1: begin & vv=a NE b & vs=a NE s & sv=s NE a & end
+            2: begin & vv=a LE b & vs=a LE s & sv=s LE a & end
+            3: begin & vv=a LT b & vs=a LT s & sv=s LT a & end
+            4: begin & vv=a GE b & vs=a GE s & sv=s GE a & end
+            5: begin & vv=a GT b & vs=a GT s & sv=s GT a & end
+         endcase
+         if SIZE(vv, /type) NE 1 then ERRORS_ADD, nb_errors, 'type '+lab
+         rvv=vv[idx] & rvs=vs[idx] & rsv=sv[idx]
+         for j=0, N_ELEMENTS(idx)-1 do begin
+            i=idx[j]
+            case k of
+               0: begin & rvv[j]=a[i] EQ b[i] & rvs[j]=a[i] EQ s & rsv[j]=s EQ a[i] & end
+               1: begin & rvv[j]=a[i] NE b[i] & rvs[j]=a[i] NE s & rsv[j]=s NE a[i] & end
+               2: begin & rvv[j]=a[i] LE b[i] & rvs[j]=a[i] LE s & rsv[j]=s LE a[i] & end
+               3: begin & rvv[j]=a[i] LT b[i] & rvs[j]=a[i] LT s & rsv[j]=s LT a[i] & end
+               4: begin & rvv[j]=a[i] GE b[i] & rvs[j]=a[i] GE s & rsv[j]=s GE a[i] & end
+               5: begin & rvv[j]=a[i] GT b[i] & rvs[j]=a[i] GT s & rsv[j]=s GT a[i] & end
+            endcase
+         endfor
+         if ~ARRAY_EQUAL(vv[idx], rvv) then ERRORS_ADD, nb_errors, 'array op array '+lab
+         if ~ARRAY_EQUAL(vs[idx], rvs) then ERRORS_ADD, nb_errors, 'array op scalar '+lab
+         if ~ARRAY_EQUAL(sv[idx], rsv) then ERRORS_ADD, nb_errors, 'scalar op array '+lab
+      endfor
+      ; the shorter operand gives the size
+      if N_ELEMENTS(a[0:n/2] LT b) NE n/2+1 then ERRORS_ADD, nb_errors, 'size, n='+STRTRIM(n,2)
+      if ~ARRAY_EQUAL(a[0:n/2] LT b, b[0:n/2] GT a) then ERRORS_ADD, nb_errors, 'shorter operand, n='+STRTRIM(n,2)
+   endfor
+endforeach
+;
+CPU, RESTORE=SAVECPU
+BANNER_FOR_TESTSUITE, 'TEST_SIMD_KERNELS_COMPARE', nb_errors, /short
+ERRORS_CUMUL, cumul_errors, nb_errors
+if KEYWORD_set(test) then STOP
+;
+end
+;
+; ---------------------------------
+;
+pro TEST_SIMD_KERNELS_BYTEORDER, cumul_errors, test=test
+;
+nb_errors=0
+seed=43
+SAVECPU=!CPU
+CPU, TPOOL_MIN_ELTS=1000
+;
+foreach n, [1, 3, 17, 50001] do begin
+   lab=' n='+STRTRIM(n,2)
+   ; each element reversed byte by byte
+   x=UINT(RANDOMU(seed, n)*65535)
+   y=x & BYTEORDER, y, /SSWAP
+   if ~ARRAY_EQUAL(BYTE(y, 0, 2, n), REVERSE(BYTE(x, 0, 2, n), 1)) then ERRORS_ADD, nb_errors, '/SSWAP'+lab
+   x=ULONG(RANDOMU(seed, n, /double)*4d9)
+   y=x & BYTEORDER, y, /LSWAP
+   if ~ARRAY_EQUAL(BYTE(y, 0, 4, n), REVERSE(BYTE(x, 0, 4, n), 1)) then ERRORS_ADD, nb_errors, '/LSWAP'+lab
+   x=RANDOMU(seed, n, /double)
+   y=x & BYTEORDER, y, /L64SWAP
+   if ~ARRAY_EQUAL(BYTE(y, 0, 8, n), REVERSE(BYTE(x, 0, 8, n), 1)) then ERRORS_ADD, nb_errors, '/L64SWAP'+lab
+   BYTEORDER, y, /L64SWAP
+   if ~ARRAY_EQUAL(y, x) then ERRORS_ADD, nb_errors, '/L64SWAP back'+lab
+   ; complex: real and imaginary parts
+   x=COMPLEX(RANDOMU(seed, n), RANDOMU(seed, n))
+   y=x & BYTEORDER, y, /LSWAP
+   if ~ARRAY_EQUAL(BYTE(y, 0, 4, 2*n), REVERSE(BYTE(x, 0, 4, 2*n), 1)) then ERRORS_ADD, nb_errors, 'complex /LSWAP'+lab
+   ;
+   ; unformatted I/O with /SWAP_ENDIAN
+   file=FILEPATH('test_simd_kernels.dat', /tmp)
+   x=RANDOMU(seed, n, /double)
+   c=DCOMPLEX(x, -x)
+   OPENW, lun, file, /GET_LUN, /SWAP_ENDIAN
+   WRITEU, lun, x, c
+   FREE_LUN, lun
+   y=DBLARR(n) & d=DCOMPLEXARR(n)
+   OPENR, lun, file, /GET_LUN
+   READU, lun, y, d
+   FREE_LUN, lun
+   if ~ARRAY_EQUAL(BYTE(y, 0, 8, n), REVERSE(BYTE(x, 0, 8, n), 1)) then ERRORS_ADD, nb_errors, 'WRITEU /SWAP_ENDIAN'+lab
+   if ~ARRAY_EQUAL(BYTE(d, 0, 8, 2*n), REVERSE(BYTE(c, 0, 8, 2*n), 1)) then ERRORS_ADD, nb_errors, 'WRITEU /SWAP_ENDIAN complex'+lab
+   OPENR, lun, file, /GET_LUN, /SWAP_ENDIAN
+   READU, lun, y, d
+   FREE_LUN, lun
+   if ~ARRAY_EQUAL(y, x) || ~ARRAY_EQUAL(d, c) then ERRORS_ADD, nb_errors, 'READU /SWAP_ENDIAN'+lab
+   FILE_DELETE, file
+endforeach
+;
+CPU, RESTORE=SAVECPU
+BANNER_FOR_TESTSUITE, 'TEST_SIMD_KERNELS_BYTEORDER', nb_errors, /short
+ERRORS_CUMUL, cumul_errors, nb_errors
+if KEYWORD_set(test) then STOP
+;
+end
+;
+; -------------------------------------------------
+;
+pro TEST_SIMD_KERNELS, no_exit=no_exit, test=test
+;
+TEST_SIMD_KERNELS_SYSVAR, cumul_errors
+TEST_SIMD_KERNELS_ARITH, cumul_errors
+TEST_SIMD_KERNELS_COMPARE, cumul_errors
+TEST_SIMD_KERNELS_BYTEORDER, cumul_errors
+;
+; ----------------- final message ----------
+;
+BANNER_FOR_TESTSUITE, 'TEST_SIMD_KERNELS', cumul_errors
+;
+if (cumul_errors GT 0) AND ~KEYWORD_SET(no_exit) then EXIT, status=1
+;
+if KEYWORD_SET(test) then STOP
+;
+end
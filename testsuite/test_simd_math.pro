@@ -0,0 +1,285 @@
+;
+; under GNU GPL v2 or later
+;
+; SIN, COS, TAN, ATAN, EXP, ALOG, ALOG10 and the power operator of FLOAT
+; and DOUBLE arrays, and SIN, COS, EXP and ALOG of complex arrays, use
+; vectorized kernels (see src/simd_math.hpp); a single element is still
+; computed by the libm. The array results must be within a few ulp of the
+; scalar ones, also around the special values (0, Inf, NaN, large or
+; negative arguments) left to the libm.
+;
+; ---------------------------------
+;
+; Modifications history :
+;
+; - 2026-10-19 : creation
+; - 2026-10-19 : ATAN, the power operator, complex SIN, COS and ALOG
+;
+; ---------------------------------
+;
+; relative difference within 'nulp' ulp, same Inf and NaN
+function TEST_SIMD_MATH_CLOSE, x, y, nulp
+;
+if N_ELEMENTS(x) NE N_ELEMENTS(y) then return, 0
+if SIZE(x, /type) NE SIZE(y, /type) then return, 0
+if ~ARRAY_EQUAL(FINITE(x), FINITE(y)) then return, 0
+if ~ARRAY_EQUAL(FINITE(x, /nan), FINITE(y, /nan)) then return, 0
+if ~ARRAY_EQUAL(FINITE(x, /inf, sign=1), FINITE(y, /inf, sign=1)) then return, 0
+ok=WHERE(FINITE(y), nok)
+if nok EQ 0 then return, 1
+dbl=(SIZE(y, /type) EQ 5) || (SIZE(y, /type) EQ 9)
+eps=(MACHAR(double=dbl)).eps
+return, TOTAL(ABS(x[ok]-y[ok]) GT nulp*eps*ABS(y[ok])) EQ 0
+end
+;
+; ---------------------------------
+;
+; the array result against the function of each element
+function TEST_SIMD_MATH_SCALAR, fun, a
+;
+r=CALL_FUNCTION(fun, a)
+for i=0, N_ELEMENTS(a)-1 do r[i]=CALL_FUNCTION(fun, a[i])
+return, r
+end
+;
+; ---------------------------------
+;
+pro TEST_SIMD_MATH_REAL, cumul_errors, test=test
+;
+nb_errors=0
+seed=51
+SAVECPU=!CPU
+; also the blocks handled in parallel
+CPU, TPOOL_MIN_ELTS=1000
+;
+funs=['SIN','COS','TAN','ATAN','EXP','ALOG','ALOG10']
+; tan: 2.5 ulp in double
+nulp=[2, 2, 4, 2, 2, 2, 2]
+foreach n, [2, 7, 17, 300, 50001] do begin
+   for dbl=0, 1 do begin
+      for k=0, N_ELEMENTS(funs)-1 do begin
+         lab=funs[k]+' n='+STRTRIM(n,2)+' double='+STRTRIM(dbl,2)
+         case funs[k] of
+            'EXP': a=RANDOMU(seed, n, double=dbl)*160-80
+            'ALOG': a=EXP(RANDOMU(seed, n, double=dbl)*160-80)
+            'ALOG10': a=EXP(RANDOMU(seed, n, double=dbl)*160-80)
+            else: a=RANDOMU(seed, n, double=dbl)*2000-1000
+         endcase
+         r=CALL_FUNCTION(funs[k], a)
+         if ~TEST_SIMD_MATH_CLOSE(r, TEST_SIMD_MATH_SCALAR(funs[k], a), nulp[k]) then $
+            ERRORS_ADD, nb_errors, lab
+         ; in place (temporary argument)
+         b=a
+         r2=CALL_FUNCTION(funs[k], TEMPORARY(b))
+         if ~ARRAY_EQUAL(r2, r) then ERRORS_ADD, nb_errors, 'in place '+lab
+      endfor
+   endfor
+endforeach
+;
+; integer arguments are converted to FLOAT
+x=INDGEN(1000)-500
+foreach f, funs do begin
+   if ~ARRAY_EQUAL(CALL_FUNCTION(f, x), CALL_FUNCTION(f, FLOAT(x))) then ERRORS_ADD, nb_errors, 'integer '+f
+endforeach
+;
+CPU, RESTORE=SAVECPU
+BANNER_FOR_TESTSUITE, 'TEST_SIMD_MATH_REAL', nb_errors, /short
+ERRORS_CUMUL, cumul_errors, nb_errors
+if KEYWORD_set(test) then STOP
+;
+end
+;
+; ---------------------------------
+;
+pro TEST_SIMD_MATH_SPECIAL, cumul_errors, test=test
+;
+nb_errors=0
+seed=52
+;
+funs=['SIN','COS','TAN','ATAN','EXP','ALOG','ALOG10']
+for dbl=0, 1 do begin
+   inf=(dbl ? !values.d_infinity : !values.f_infinity)
+   nan=(dbl ? !values.d_nan : !values.f_nan)
+   big=(dbl ? 1d300 : 1e30)
+   sp=[0, -1, 1, 1000, -1000, big, -big, inf, -inf, nan]
+   if dbl then sp=DOUBLE(sp) else sp=FLOAT(sp)
+   for k=0, N_ELEMENTS(funs)-1 do begin
+      lab=funs[k]+' double='+STRTRIM(dbl,2)
+      ; the special values alone, and within a long array
+      if ~TEST_SIMD_MATH_CLOSE(CALL_FUNCTION(funs[k], sp), TEST_SIMD_MATH_SCALAR(funs[k], sp), 2) then $
+         ERRORS_ADD, nb_errors, 'special values '+lab
+      a=RANDOMU(seed, 1000, double=dbl)+0.5
+      a[500+INDGEN(N_ELEMENTS(sp))]=sp
+      r=CALL_FUNCTION(funs[k], a)
+      if ~TEST_SIMD_MATH_CLOSE(r[500:500+N_ELEMENTS(sp)-1], TEST_SIMD_MATH_SCALAR(funs[k], sp), 2) then $
+         ERRORS_ADD, nb_errors, 'special values in array '+lab
+      if ~TEST_SIMD_MATH_CLOSE(r, TEST_SIMD_MATH_SCALAR(funs[k], a), 4) then $
+         ERRORS_ADD, nb_errors, 'array with special values '+lab
+   endfor
+   ; odd functions keep the sign of zero
+   z=(dbl ? -0d : -0.)
+   z=[z, z, z]
+   if ~ARRAY_EQUAL(FINITE(1/SIN(z), /inf, sign=-1), [1, 1, 1]) then ERRORS_ADD, nb_errors, 'SIN(-0) double='+STRTRIM(dbl,2)
+   if ~ARRAY_EQUAL(FINITE(1/TAN(z), /inf, sign=-1), [1, 1, 1]) then ERRORS_ADD, nb_errors, 'TAN(-0) double='+STRTRIM(dbl,2)
+   if ~ARRAY_EQUAL(FINITE(1/ATAN(z), /inf, sign=-1), [1, 1, 1]) then ERRORS_ADD, nb_errors, 'ATAN(-0) double='+STRTRIM(dbl,2)
+endfor
+;
+BANNER_FOR_TESTSUITE, 'TEST_SIMD_MATH_SPECIAL', nb_errors, /short
+ERRORS_CUMUL, cumul_errors, nb_errors
+if KEYWORD_set(test) then STOP
+;
+end
+;
+; ---------------------------------
+;
+; x^y element by element, x or y may be a single element
+function TEST_SIMD_MATH_POW_LOOP, x, y
+;
+nx=N_ELEMENTS(x)
+ny=N_ELEMENTS(y)
+r=(nx GE ny) ? x : y
+for i=0, (nx > ny)-1 do r[i]=x[i < (nx-1)]^y[i < (ny-1)]
+return, r
+end
+;
+; ---------------------------------
+;
+pro TEST_SIMD_MATH_POW, cumul_errors, test=test
+;
+nb_errors=0
+seed=54
+SAVECPU=!CPU
+CPU, TPOOL_MIN_ELTS=1000
+;
+foreach n, [2, 17, 300, 50001] do begin
+   for dbl=0, 1 do begin
+      lab=' n='+STRTRIM(n,2)+' double='+STRTRIM(dbl,2)
+      x=RANDOMU(seed, n, double=dbl)*4
+      y=RANDOMU(seed, n, double=dbl)*60-30
+      ; negative bases with integral exponents
+      neg=LINDGEN((n+2)/3)*3
+      x[neg]=-x[neg]
+      y[neg]=ROUND(y[neg])
+      s=(dbl ? 1.7d : 1.7)
+      if ~TEST_SIMD_MATH_CLOSE(x^y, TEST_SIMD_MATH_POW_LOOP(x, y), 2) then ERRORS_ADD, nb_errors, 'x^y'+lab
+      if ~TEST_SIMD_MATH_CLOSE(ABS(x)^s, TEST_SIMD_MATH_POW_LOOP(ABS(x), s), 2) then ERRORS_ADD, nb_errors, 'x^s'+lab
+      if ~TEST_SIMD_MATH_CLOSE(s^y, TEST_SIMD_MATH_POW_LOOP(s, y), 2) then ERRORS_ADD, nb_errors, 's^y'+lab
+      ; in place (temporary operands)
+      r=x^y
+      a=x
+      if ~ARRAY_EQUAL(TEMPORARY(a)^y, r) then ERRORS_ADD, nb_errors, 'in place x^y'+lab
+      b=y
+      if ~ARRAY_EQUAL(x^TEMPORARY(b), r) then ERRORS_ADD, nb_errors, 'in place inverse x^y'+lab
+      ; results which overflow or underflow, special values
+      if dbl then begin
+         x[0:1]=[1d300, 1d-300]
+         x[n-1]=!values.d_nan
+      endif else begin
+         x[0:1]=[1e30, 1e-40]
+         x[n-1]=!values.f_infinity
+      endelse
+      y[0:1]=[3, 5]
+      if ~TEST_SIMD_MATH_CLOSE(x^y, TEST_SIMD_MATH_POW_LOOP(x, y), 2) then ERRORS_ADD, nb_errors, 'x^y special'+lab
+   endfor
+endforeach
+;
+; special values alone
+for dbl=0, 1 do begin
+   inf=(dbl ? !values.d_infinity : !values.f_infinity)
+   nan=(dbl ? !values.d_nan : !values.f_nan)
+   sp=[0, -0.5, -2, 1, 2, inf, -inf, nan]
+   if dbl then sp=DOUBLE(sp) else sp=FLOAT(sp)
+   x=REFORM(REBIN(sp, N_ELEMENTS(sp), N_ELEMENTS(sp)), N_ELEMENTS(sp)^2)
+   y=REFORM(REBIN(TRANSPOSE(sp), N_ELEMENTS(sp), N_ELEMENTS(sp)), N_ELEMENTS(sp)^2)
+   if ~TEST_SIMD_MATH_CLOSE(x^y, TEST_SIMD_MATH_POW_LOOP(x, y), 2) then $
+      ERRORS_ADD, nb_errors, 'special values double='+STRTRIM(dbl,2)
+endfor
+;
+CPU, RESTORE=SAVECPU
+BANNER_FOR_TESTSUITE, 'TEST_SIMD_MATH_POW', nb_errors, /short
+ERRORS_CUMUL, cumul_errors, nb_errors
+if KEYWORD_set(test) then STOP
+;
+end
+;
+; ---------------------------------
+;
+pro TEST_SIMD_MATH_COMPLEX, cumul_errors, test=test
+;
+nb_errors=0
+seed=53
+SAVECPU=!CPU
+CPU, TPOOL_MIN_ELTS=1000
+;
+foreach n, [3, 17, 50001] do begin
+   for dbl=0, 1 do begin
+      lab=' n='+STRTRIM(n,2)+' double='+STRTRIM(dbl,2)
+      re=RANDOMU(seed, n, double=dbl)*100-50
+      im=RANDOMU(seed, n, double=dbl)*200-100
+      z=(dbl ? DCOMPLEX(re, im) : COMPLEX(re, im))
+      r=EXP(z)
+      ; exp(x+iy) = exp(x) (cos(y) + i sin(y)), computed in double
+      e=EXP(DOUBLE(re))
+      ref=DCOMPLEX(e*COS(DOUBLE(im)), e*SIN(DOUBLE(im)))
+      eps=(MACHAR(double=dbl)).eps
+      if SIZE(r, /type) NE SIZE(z, /type) then ERRORS_ADD, nb_errors, 'type'+lab
+      if TOTAL(ABS(r-ref) GT 4*eps*ABS(ref)) GT 0 then ERRORS_ADD, nb_errors, 'EXP'+lab
+      r2=EXP(TEMPORARY(z))
+      if ~ARRAY_EQUAL(r2, r) then ERRORS_ADD, nb_errors, 'EXP in place'+lab
+      ; SIN, COS and ALOG against the function of each element, ALOG
+      ; also close to the unit circle
+      z=(dbl ? DCOMPLEX(re, im/5) : COMPLEX(re, im/5))
+      foreach f, ['SIN', 'COS', 'ALOG'] do begin
+         r=CALL_FUNCTION(f, z)
+         if ~TEST_SIMD_MATH_CLOSE(r, TEST_SIMD_MATH_SCALAR(f, z), 4) then ERRORS_ADD, nb_errors, f+lab
+         a=z
+         if ~ARRAY_EQUAL(CALL_FUNCTION(f, TEMPORARY(a)), r) then ERRORS_ADD, nb_errors, f+' in place'+lab
+      endforeach
+      t=RANDOMU(seed, n, double=dbl)*10
+      u=(1+(RANDOMU(seed, n, double=dbl)-0.5)*1e-5)*EXP((dbl ? DCOMPLEX(0, t) : COMPLEX(0, t)))
+      if ~TEST_SIMD_MATH_CLOSE(ALOG(u), TEST_SIMD_MATH_SCALAR('ALOG', u), 4) then ERRORS_ADD, nb_errors, 'ALOG |z| ~ 1'+lab
+   endfor
+endforeach
+;
+; overflow, Inf and NaN: as the scalar EXP
+z=COMPLEX([1, 100, 0, !values.f_infinity, !values.f_nan, 1], [1, 0, 1e30, 0, 0, !values.f_nan])
+r=EXP(z)
+for i=0, N_ELEMENTS(z)-1 do begin
+   s=EXP(z[i])
+   same=ARRAY_EQUAL(FINITE([r[i]], /nan), FINITE([s], /nan))
+   if FINITE(s) then same=same && ABS(r[i]-s) LE 4*(MACHAR()).eps*ABS(s)
+   if ~same then ERRORS_ADD, nb_errors, 'EXP special value '+STRTRIM(i,2)
+endfor
+; and for SIN, COS, ALOG (ALOG(0) = -Inf)
+z=COMPLEX([1, 0, 0, 100, 1e30, !values.f_infinity, !values.f_nan, -1, 0], $
+          [1, 0, 100, 0, 1, 0, 0, 0, -1e-40])
+foreach f, ['SIN', 'COS', 'ALOG'] do begin
+   r=CALL_FUNCTION(f, z)
+   if ~TEST_SIMD_MATH_CLOSE(r, TEST_SIMD_MATH_SCALAR(f, z), 4) then ERRORS_ADD, nb_errors, f+' special values'
+endforeach
+;
+CPU, RESTORE=SAVECPU
+BANNER_FOR_TESTSUITE, 'TEST_SIMD_MATH_COMPLEX', nb_errors, /short
+ERRORS_CUMUL, cumul_errors, nb_errors
+if KEYWORD_set(test) then STOP
+;
+end
+;
+; -------------------------------------------------
+;
+pro TEST_SIMD_MATH, no_exit=no_exit, test=test
+;
+TEST_SIMD_MATH_REAL, cumul_errors
+TEST_SIMD_MATH_SPECIAL, cumul_errors
+TEST_SIMD_MATH_POW, cumul_errors
+TEST_SIMD_MATH_COMPLEX, cumul_errors
+;
+; ----------------- final message ----------
+;
+BANNER_FOR_TESTSUITE, 'TEST_SIMD_MATH', cumul_errors
+;
+if (cumul_errors GT 0) AND ~KEYWORD_SET(no_exit) then EXIT, status=1
+;
+if KEYWORD_SET(test) then STOP
+;
+end
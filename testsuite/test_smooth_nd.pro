@@ -0,0 +1,94 @@
+;
+; under GNU GPL v2 or later
+;
+; SMOOTH on 2D and 3D arrays must be the same as successive 1D SMOOTH
+; along each dimension (first dimension first), in all edge modes,
+; with and without /NAN.
+;
+; ---------------------------------
+;
+; Modifications history :
+;
+; - 2026-10-19 : creation with the parallel 2D/3D SMOOTH
+;
+; ---------------------------------
+;
+function SMOOTH_ND_REFERENCE, a, width, _extra=extra
+;
+res=a
+dims=SIZE(a, /dim)
+nd=N_ELEMENTS(dims)
+if nd EQ 2 then dims=[dims, 1]
+for d=0, nd-1 do begin
+   if width[d] LE 1 then continue
+   for k=0, dims[2]-1 do begin
+      case d of
+         0: for j=0, dims[1]-1 do res[*, j, k]=SMOOTH(REFORM(res[*, j, k]), width[d], _extra=extra)
+         1: for i=0, dims[0]-1 do res[i, *, k]=SMOOTH(REFORM(res[i, *, k]), width[d], _extra=extra)
+         2: if k EQ 0 then for j=0, dims[1]-1 do for i=0, dims[0]-1 do $
+               res[i, j, *]=SMOOTH(REFORM(res[i, j, *]), width[d], _extra=extra)
+      endcase
+   endfor
+endfor
+return, res
+end
+;
+; ---------------------------------
+;
+pro TEST_SMOOTH_ND_ONE, cumul_errors, a, width, label, test=test
+;
+nb_errors=0
+edges=['', 'EDGE_WRAP', 'EDGE_TRUNCATE', 'EDGE_ZERO', 'EDGE_MIRROR']
+for ie=0, N_ELEMENTS(edges)-1 do begin
+   for nan=0, 1 do begin
+      ex={nan:nan}
+      if edges[ie] NE '' then ex=CREATE_STRUCT(ex, edges[ie], 1)
+      lab=label+' '+edges[ie]+' nan='+STRTRIM(nan,2)
+      res=SMOOTH(a, width, _extra=ex)
+      exp=SMOOTH_ND_REFERENCE(a, width, _extra=ex)
+      if SIZE(res, /type) NE SIZE(a, /type) then ERRORS_ADD, nb_errors, lab+': type'
+      bad=WHERE(FINITE(res) NE FINITE(exp), nbad)
+      if nbad GT 0 then ERRORS_ADD, nb_errors, lab+': NaN positions'
+      ok=WHERE(FINITE(exp), nok)
+      if nok GT 0 then if MAX(ABS(res[ok]-exp[ok])) GT 1e-4*MAX(ABS(exp[ok])) then $
+         ERRORS_ADD, nb_errors, lab
+   endfor
+endfor
+;
+BANNER_FOR_TESTSUITE, 'TEST_SMOOTH_ND_ONE '+label, nb_errors, /short
+ERRORS_CUMUL, cumul_errors, nb_errors
+if KEYWORD_set(test) then STOP
+;
+end
+;
+; -------------------------------------------------
+;
+pro TEST_SMOOTH_ND, no_exit=no_exit, test=test
+;
+seed=17
+; 2D, more rows than the blocks of rows done by each thread
+a=RANDOMU(seed, 77, 101)*100
+TEST_SMOOTH_ND_ONE, cumul_errors, a, [5, 9], '2D float'
+TEST_SMOOTH_ND_ONE, cumul_errors, DOUBLE(a), 7, '2D double'
+TEST_SMOOTH_ND_ONE, cumul_errors, a, [1, 11], '2D width 1'
+b=a
+b[10:12, 20:60]=!values.f_nan
+b[40, *]=!values.f_nan
+TEST_SMOOTH_ND_ONE, cumul_errors, b, [5, 3], '2D NaN'
+TEST_SMOOTH_ND_ONE, cumul_errors, FIX(a), 5, '2D int'
+;
+; 3D
+c=RANDOMN(seed, 19, 23, 35, /double)
+TEST_SMOOTH_ND_ONE, cumul_errors, c, [3, 5, 7], '3D'
+c[3:5, 2:20, 10]=!values.d_nan
+TEST_SMOOTH_ND_ONE, cumul_errors, c, 5, '3D NaN'
+;
+; ----------------- final message ----------
+;
+BANNER_FOR_TESTSUITE, 'TEST_SMOOTH_ND', cumul_errors
+;
+if (cumul_errors GT 0) AND ~KEYWORD_SET(no_exit) then EXIT, status=1
+;
+if KEYWORD_SET(test) then STOP
+;
+end
@@ -11,6 +11,7 @@
 ; - 2019-10-31 : AC. Creation, from a suggestion of @maynardGK in #659
 ;                but the original WHERE() is remplace by a TOTAL()
 ;                (less side-effect expected TBC)
+; - 2026-10-19 : strings (common prefixes, empty strings, equal elements)
 ;
 ; ---------------------------------
 ;
@@ -33,6 +34,38 @@ end
 ;
 ; -------------------------------------------------
 ;
+; strings sharing long prefixes, of various lengths, including
+; empty and identical ones: equal elements must be contiguous and
+; in input order (GDL string sort is stable).
+;
+pro TEST_SORT_STRINGS, cumul_errors, nbps, test=test
+;
+nb_errors=0
+;
+suffix=STRTRIM(LONG(RANDOMU(seed, nbps)*(nbps/3)),2)
+array='CATALOG_J'+STRMID(suffix, 0, 3)+'_'+suffix
+array[0:*:7]=''
+array[1:*:11]='CATALOG_J'
+;
+ii=SORT(array)
+sort_array=array[ii]
+;
+nb_errors=TOTAL(sort_array[1:*] LT sort_array)
+same=WHERE(sort_array[1:*] EQ sort_array, nsame)
+if nsame GT 0 then nb_errors=nb_errors+TOTAL(ii[same+1] LT ii[same])
+;
+if ~ARRAY_EQUAL(sort_array[0:1], ['','']) then nb_errors++
+;
+; ----- final ----
+;
+BANNER_FOR_TESTSUITE, 'TEST_SORT_STRINGS', nb_errors, /short
+ERRORS_CUMUL, cumul_errors, nb_errors
+if KEYWORD_set(test) then STOP
+;
+end
+;
+; -------------------------------------------------
+;
 pro TEST_SORT, no_exit=no_exit, test=test
 ;
 TEST_SORT_NELEMENTS, cumul_errors, 50
@@ -43,6 +76,9 @@ TEST_SORT_NELEMENTS, cumul_errors, 280
 TEST_SORT_NELEMENTS, cumul_errors, 990
 TEST_SORT_NELEMENTS, cumul_errors, 1190
 ;
+TEST_SORT_STRINGS, cumul_errors, 100
+TEST_SORT_STRINGS, cumul_errors, 10000
+;
 ; ----------------- final message ----------
 ;
 BANNER_FOR_TESTSUITE, 'TEST_SORT', cumul_errors
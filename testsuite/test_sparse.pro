@@ -0,0 +1,171 @@
+;
+; under GNU GPL v2 or later
+;
+; Tests of the sparse matrix routines SPRSIN, FULSTR, SPRSAX, SPRSAB,
+; SPRSTP and LINBCG against the dense operations (##, TRANSPOSE).
+;
+; ---------------------------------
+;
+; Modifications history :
+;
+; - 2026-10-19 : creation
+;
+; ---------------------------------
+;
+; a diagonally dominant sparse-ish matrix, about 'fill' of the
+; off-diagonal elements non zero
+function TEST_SPARSE_MATRIX, n, seed, fill=fill, double=double
+;
+if N_ELEMENTS(fill) EQ 0 then fill=0.1
+a=RANDOMU(seed, n, n, double=double)-0.5
+a=a*(RANDOMU(seed, n, n) LT fill)
+a=a+DIAG_MATRIX(REPLICATE(n*0.5+2., n))
+if KEYWORD_SET(double) then a=DOUBLE(a)
+return, a
+end
+;
+; ---------------------------------
+;
+pro TEST_SPARSE_CONVERSIONS, cumul_errors, test=test
+;
+nb_errors=0
+seed=21
+;
+for n=2, 41, 13 do begin
+   for dbl=0, 1 do begin
+      lab='n='+STRTRIM(n,2)+' double='+STRTRIM(dbl,2)
+      a=TEST_SPARSE_MATRIX(n, seed, double=dbl)
+      s=SPRSIN(a)
+      tname=TAG_NAMES(s)
+      if ~ARRAY_EQUAL(tname, ['SA','IJA']) then ERRORS_ADD, nb_errors, 'SPRSIN tags '+lab
+      if SIZE(s.sa, /type) NE (dbl ? 5 : 4) then ERRORS_ADD, nb_errors, 'SPRSIN type '+lab
+      if s.ija[0] NE n+1 then ERRORS_ADD, nb_errors, 'SPRSIN IJA[0] '+lab
+      nz=TOTAL(a NE 0)
+      if N_ELEMENTS(s.sa) NE nz+1 then ERRORS_ADD, nb_errors, 'SPRSIN size '+lab
+      if ~ARRAY_EQUAL(FULSTR(s), a) then ERRORS_ADD, nb_errors, 'FULSTR(SPRSIN) '+lab
+      if ~ARRAY_EQUAL(FULSTR(SPRSIN(a, /column)), TRANSPOSE(a)) then $
+         ERRORS_ADD, nb_errors, 'SPRSIN /COLUMN '+lab
+      if ~ARRAY_EQUAL(FULSTR(SPRSTP(s)), TRANSPOSE(a)) then $
+         ERRORS_ADD, nb_errors, 'SPRSTP '+lab
+   endfor
+endfor
+;
+; /DOUBLE on a float matrix
+a=TEST_SPARSE_MATRIX(10, seed)
+if SIZE((SPRSIN(a, /double)).sa, /type) NE 5 then ERRORS_ADD, nb_errors, 'SPRSIN /DOUBLE'
+;
+; THRESHOLD drops the small off-diagonal elements, never the diagonal
+a=[[1., 0.01, 0], [0.5, 0.001, 0.02], [0, -3, 4]]
+s=SPRSIN(a, threshold=0.1)
+f=FULSTR(s)
+expected=[[1., 0, 0], [0.5, 0.001, 0], [0, -3, 4]]
+if ~ARRAY_EQUAL(f, expected) then ERRORS_ADD, nb_errors, 'SPRSIN THRESHOLD'
+;
+; the (columns, rows, values, n) form, duplicates are summed
+s=SPRSIN([0, 2, 1, 2, 2], [0, 0, 1, 2, 0], [1., 2, 3, 4, 5], 3)
+expected=FLTARR(3, 3)
+expected[0,0]=1 & expected[2,0]=7 & expected[1,1]=3 & expected[2,2]=4
+if ~ARRAY_EQUAL(FULSTR(s), expected) then ERRORS_ADD, nb_errors, 'SPRSIN triplets'
+;
+; not a sparse structure
+CATCH, err
+if err EQ 0 then begin
+   f=FULSTR({sa:[1.,2], ija:[5L,0]})
+   ERRORS_ADD, nb_errors, 'FULSTR bad structure'
+endif
+CATCH, /cancel
+;
+BANNER_FOR_TESTSUITE, 'TEST_SPARSE_CONVERSIONS', nb_errors, /short
+ERRORS_CUMUL, cumul_errors, nb_errors
+if KEYWORD_set(test) then STOP
+;
+end
+;
+; ---------------------------------
+;
+pro TEST_SPARSE_PRODUCTS, cumul_errors, test=test
+;
+nb_errors=0
+seed=22
+;
+for n=2, 62, 20 do begin
+   for dbl=0, 1 do begin
+      lab='n='+STRTRIM(n,2)+' double='+STRTRIM(dbl,2)
+      tol=(dbl ? 1e-10 : 1e-3)
+      a=TEST_SPARSE_MATRIX(n, seed, double=dbl)
+      b=TEST_SPARSE_MATRIX(n, seed, double=dbl, fill=0.2)
+      x=RANDOMU(seed, n, double=dbl)
+      sa=SPRSIN(a)
+      sb=SPRSIN(b)
+      y=SPRSAX(sa, x)
+      if N_ELEMENTS(y) NE n then ERRORS_ADD, nb_errors, 'SPRSAX size '+lab
+      if MAX(ABS(y-REFORM(a ## x))) GT tol*n then ERRORS_ADD, nb_errors, 'SPRSAX '+lab
+      ab=FULSTR(SPRSAB(sa, sb))
+      if MAX(ABS(ab-(a ## b))) GT tol*n then ERRORS_ADD, nb_errors, 'SPRSAB '+lab
+   endfor
+endfor
+;
+CATCH, err
+if err EQ 0 then begin
+   y=SPRSAX(SPRSIN(TEST_SPARSE_MATRIX(4, seed)), [1., 2])
+   ERRORS_ADD, nb_errors, 'SPRSAX wrong size'
+endif
+CATCH, /cancel
+;
+BANNER_FOR_TESTSUITE, 'TEST_SPARSE_PRODUCTS', nb_errors, /short
+ERRORS_CUMUL, cumul_errors, nb_errors
+if KEYWORD_set(test) then STOP
+;
+end
+;
+; ---------------------------------
+;
+pro TEST_SPARSE_LINBCG, cumul_errors, test=test
+;
+nb_errors=0
+seed=23
+;
+n=200
+a=TEST_SPARSE_MATRIX(n, seed, /double, fill=0.02)
+b=RANDOMU(seed, n, /double)
+s=SPRSIN(a)
+for itol=1, 4 do begin
+   lab='ITOL='+STRTRIM(itol,2)
+   iter=0
+   x=LINBCG(s, b, DBLARR(n), itol=itol, tol=1d-12, iter=iter)
+   if SIZE(x, /type) NE 5 then ERRORS_ADD, nb_errors, 'LINBCG type '+lab
+   if iter LE 0 then ERRORS_ADD, nb_errors, 'LINBCG ITER '+lab
+   if MAX(ABS(REFORM(a ## x)-b)) GT 1e-8 then ERRORS_ADD, nb_errors, 'LINBCG '+lab
+endfor
+;
+; single precision, symmetric matrix
+a=TEST_SPARSE_MATRIX(50, seed, fill=0.05)
+a=a+TRANSPOSE(a)
+b=RANDOMU(seed, 50)
+x=LINBCG(SPRSIN(a), b, FLTARR(50))
+if SIZE(x, /type) NE 4 then ERRORS_ADD, nb_errors, 'LINBCG float type'
+if MAX(ABS(REFORM(a ## x)-b)) GT 1e-4 then ERRORS_ADD, nb_errors, 'LINBCG float'
+;
+BANNER_FOR_TESTSUITE, 'TEST_SPARSE_LINBCG', nb_errors, /short
+ERRORS_CUMUL, cumul_errors, nb_errors
+if KEYWORD_set(test) then STOP
+;
+end
+;
+; -------------------------------------------------
+;
+pro TEST_SPARSE, no_exit=no_exit, test=test
+;
+TEST_SPARSE_CONVERSIONS, cumul_errors
+TEST_SPARSE_PRODUCTS, cumul_errors
+TEST_SPARSE_LINBCG, cumul_errors
+;
+; ----------------- final message ----------
+;
+BANNER_FOR_TESTSUITE, 'TEST_SPARSE', cumul_errors
+;
+if (cumul_errors GT 0) AND ~KEYWORD_SET(no_exit) then EXIT, status=1
+;
+if KEYWORD_SET(test) then STOP
+;
+end
@@ -0,0 +1,101 @@
+;
+; under GNU GPL v2 or later
+;
+; Subscripts made of ranges, strides, '*' and scalars are copied as
+; strided views (block copies). They must give the same elements as
+; the equivalent index arrays, which go element by element.
+; TOTAL(a[ranges]) reads the view in place: same result, to the bit, as
+; TOTAL of the copy.
+;
+; ---------------------------------
+;
+; Modifications history :
+;
+; - 2026-10-19 : creation with the strided view copies
+; - 2026-10-19 : TOTAL of a strided view
+;
+; ---------------------------------
+;
+pro TEST_SUBSCRIPT_RANGES_CHECK, res, exp, nb_errors, label
+if ~ARRAY_EQUAL(SIZE(res, /dim), SIZE(exp, /dim)) then $
+   ERRORS_ADD, nb_errors, label+': dimensions' $
+else if ~ARRAY_EQUAL(res, exp) then ERRORS_ADD, nb_errors, label
+end
+;
+; -------------------------------------------------
+;
+pro TEST_SUBSCRIPT_RANGES, no_exit=no_exit, test=test
+;
+nb_errors=0
+;
+; 1D
+v=LINDGEN(1000)
+TEST_SUBSCRIPT_RANGES_CHECK, v[10:20], v[10+LINDGEN(11)], nb_errors, '1D range'
+TEST_SUBSCRIPT_RANGES_CHECK, v[5:*:7], v[5+7*LINDGEN(142)], nb_errors, '1D stride'
+TEST_SUBSCRIPT_RANGES_CHECK, v[*], v, nb_errors, '1D all'
+;
+; 3D, several types
+types=[1,2,3,4,5,7,9,14]
+for it=0, N_ELEMENTS(types)-1 do begin
+   a=FIX(LINDGEN(30, 20, 10) MOD 20000, type=types[it])
+   if types[it] EQ 7 then a=STRTRIM(LINDGEN(30, 20, 10),2)
+   lab='type '+STRTRIM(types[it],2)+' '
+   i0=LINDGEN(30) & i1=LINDGEN(20) & i2=LINDGEN(10)
+   ; a[*, 5, *]
+   exp=a[i0 # REPLICATE(1,10) + 30*5 + 600*(REPLICATE(1,30) # i2)]
+   TEST_SUBSCRIPT_RANGES_CHECK, a[*, 5, *], REFORM(exp, 30, 1, 10), nb_errors, lab+'[*,5,*]'
+   ; a[10:20, *, 3]
+   ix=(10+LINDGEN(11)) # REPLICATE(1,20) + 30*(REPLICATE(1,11) # i1) + 600*3
+   TEST_SUBSCRIPT_RANGES_CHECK, a[10:20, *, 3], a[ix], nb_errors, lab+'[10:20,*,3]'
+   ; a[*, *, 2:8:3] is contiguous by planes
+   ix=REFORM(LINDGEN(600) # REPLICATE(1,3) + 600*(REPLICATE(1,600) # [2,5,8]), 30, 20, 3)
+   TEST_SUBSCRIPT_RANGES_CHECK, a[*, *, 2:8:3], a[ix], nb_errors, lab+'[*,*,2:8:3]'
+   ; strides in all dimensions
+   j0=1+2*LINDGEN(14) & j1=3*LINDGEN(7) & j2=[1,5,9]
+   ix=LONARR(14, 7, 3)
+   for k=0, 2 do for j=0, 6 do ix[*, j, k]=j0+30*j1[j]+600*j2[k]
+   TEST_SUBSCRIPT_RANGES_CHECK, a[1:*:2, 0:*:3, 1:9:4], a[ix], nb_errors, lab+'[1:*:2,0:*:3,1:9:4]'
+   ; a row
+   TEST_SUBSCRIPT_RANGES_CHECK, a[7, 3:12, 4], REFORM(a[7+30*(3+LINDGEN(10))+600*4], 1, 10), nb_errors, lab+'[7,3:12,4]'
+endfor
+;
+; large, parallel copies
+b=FINDGEN(500, 400)
+ix=LINDGEN(200) # REPLICATE(1,400) + 100 + 500*(REPLICATE(1,200) # LINDGEN(400))
+TEST_SUBSCRIPT_RANGES_CHECK, b[100:299, *], b[ix], nb_errors, 'large'
+;
+; TOTAL(a[ranges]) without copy, all numeric types
+types=[1,2,3,4,5,6,9,12,13,14,15]
+seed=5
+c=RANDOMU(seed, 300, 200, 4, /double)*1000-200
+for it=0, N_ELEMENTS(types)-1 do begin
+   a=FIX(c, type=types[it])
+   if types[it] EQ 6 || types[it] EQ 9 then a=COMPLEX(c, -c/3, double=(types[it] EQ 9))
+   lab='TOTAL type '+STRTRIM(types[it],2)+' '
+   r=a[1:*:2, 3:197, 1:3]
+   if ~ARRAY_EQUAL(TOTAL(a[1:*:2, 3:197, 1:3]), TOTAL(r)) then ERRORS_ADD, nb_errors, lab+'[1:*:2,3:197,1:3]'
+   if SIZE(TOTAL(a[1:*:2, 3:197, 1:3]), /type) NE SIZE(TOTAL(r), /type) then ERRORS_ADD, nb_errors, lab+'result type'
+   r=a[*, 50, *]
+   if ~ARRAY_EQUAL(TOTAL(a[*, 50, *]), TOTAL(r)) then ERRORS_ADD, nb_errors, lab+'[*,50,*]'
+   r=a[1000:*:7]
+   if ~ARRAY_EQUAL(TOTAL(a[1000:*:7]), TOTAL(r)) then ERRORS_ADD, nb_errors, lab+'[1000:*:7]'
+endfor
+; index arrays, a single element and keywords still go through the copy
+if TOTAL(v[[1, 5, 9]]) NE 15 then ERRORS_ADD, nb_errors, 'TOTAL index array'
+if TOTAL(v[7:7]) NE 7 then ERRORS_ADD, nb_errors, 'TOTAL one element'
+if ~ARRAY_EQUAL(TOTAL(v[0:9], /CUMULATIVE), TOTAL(LINDGEN(10), /CUMULATIVE)) then ERRORS_ADD, nb_errors, 'TOTAL /CUMULATIVE'
+if ~ARRAY_EQUAL(TOTAL(b[100:299, *], 2), TOTAL(b[ix], 2)) then ERRORS_ADD, nb_errors, 'TOTAL dimension'
+;
+; an index array with ranges is not a strided view
+ix=b[[3, 1, 4], 10:12]
+TEST_SUBSCRIPT_RANGES_CHECK, ix, b[[3,1,4] # [1,1,1] + 500*([1,1,1] # [10,11,12])], nb_errors, 'index array and range'
+;
+; ----------------- final message ----------
+;
+BANNER_FOR_TESTSUITE, 'TEST_SUBSCRIPT_RANGES', nb_errors
+;
+if (nb_errors GT 0) AND ~KEYWORD_SET(no_exit) then EXIT, status=1
+;
+if KEYWORD_SET(test) then STOP
+;
+end
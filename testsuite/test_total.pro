@@ -14,6 +14,13 @@
 ;
 ; - 2020-JUN-03 : AC. Add a test to trigged bug report #775
 ;
+; - 2026-OCT-19 : TEST_TOTAL_REPRODUCIBLE : TOTAL, PRODUCT, MEAN and
+;   MOMENT must not depend on the number of threads, float sums are
+;   accurate (accumulated in double, compensated)
+;
+; - 2026-OCT-19 : TEST_TOTAL_CUMULATIVE : parallel prefix scans of
+;   TOTAL and PRODUCT /CUMULATIVE, flat and with DIMENSION
+;
 ; ---------------------------------------
 ; Script : regression-total
 pro regression, a
@@ -354,6 +361,111 @@ if KEYWORD_set(test) then STOP
 end
 ; -----------------------------------------------------------------
 ;
+pro TEST_TOTAL_REPRODUCIBLE, cumul_errors, test=test, verbose=verbose
+;
+errors=0
+nbp=3000017L
+SAVECPU=!CPU
+;
+a=RANDOMU(seed, nbp)-0.5
+a[[10, 20000, 2000000]]=!values.f_nan
+d=RANDOMN(seed, nbp, /double)*1d6
+c=COMPLEX(a, REVERSE(a))
+p=1d + (RANDOMU(seed, nbp, /double)-0.5)*1d-6
+;
+res=PTRARR(2)
+for pass=0, 1 do begin
+   if pass EQ 0 then CPU, TPOOL_NTHREADS=1 else $
+      CPU, TPOOL_NTHREADS=!CPU.HW_NCPU > 4, TPOOL_MIN_ELTS=1000
+   r=LIST(TOTAL(a, /nan), TOTAL(d), TOTAL(d, /double), TOTAL(c, /nan), $
+          TOTAL(a, /nan, /double), PRODUCT(p), PRODUCT(a, /nan), $
+          MEAN(d), MEAN(a, /nan), MOMENT(d), MOMENT(a, /nan), MOMENT(c))
+   res[pass]=PTR_NEW(r)
+endfor
+CPU, RESTORE=SAVECPU
+;
+r0=*res[0] & r1=*res[1]
+for i=0, N_ELEMENTS(r0)-1 do $
+   if ~ARRAY_EQUAL(r0[i], r1[i]) then ERRORS_ADD, errors, 'threads, case '+STRTRIM(i,2)
+PTR_FREE, res
+;
+; float sums keep their accuracy (a float accumulator stops at 2^24)
+if TOTAL(REPLICATE(1., 20000000L)) NE 2e7 then ERRORS_ADD, errors, 'float accuracy'
+big=[REPLICATE(1., 10000000L), 0.5]
+if TOTAL(big, /double) NE 10000000.5d then ERRORS_ADD, errors, 'float accuracy, /double'
+x=FINDGEN(10000000L)
+if ABS(TOTAL(x)-49999995000000d)/49999995000000d GT 1e-7 then ERRORS_ADD, errors, 'float FINDGEN'
+; compensated double sums
+y=DBLARR(4096L*30)
+y[4096:4096L*29-1]=1d
+y[0]=1d20 & y[4096L*29]=-1d20
+if TOTAL(y) NE 4096d*28 then ERRORS_ADD, errors, 'double compensated'
+;
+; /INTEGER converts each value before summing
+if TOTAL([1.6, 1.6, 1.6], /integer) NE 3 then ERRORS_ADD, errors, '/INTEGER float values'
+;
+BANNER_FOR_TESTSUITE, "TEST_TOTAL_REPRODUCIBLE", errors, /short, verb=verbose
+ERRORS_CUMUL, cumul_errors, errors
+if KEYWORD_SET(test) then STOP
+;
+end
+; -----------------------------------------------------------------
+;
+pro TEST_TOTAL_CUMULATIVE, cumul_errors, test=test, verbose=verbose
+;
+errors=0
+nbp=1000003L
+SAVECPU=!CPU
+;
+; exact cases, the scan is done in several blocks
+x=DINDGEN(nbp)
+expected=x*(x+1)/2
+if ~ARRAY_EQUAL(TOTAL(x, /cumulative), expected) then ERRORS_ADD, errors, 'cumulative double'
+if ~ARRAY_EQUAL(TOTAL(LINDGEN(nbp), /cumulative, /integer), LONG64(expected)) then $
+   ERRORS_ADD, errors, 'cumulative /integer'
+s=REPLICATE(-1d, nbp)
+signs=1-2*((LINDGEN(nbp)+1) mod 2)
+if ~ARRAY_EQUAL(PRODUCT(s, /cumulative), signs) then ERRORS_ADD, errors, 'product cumulative'
+y=x & y[[5, 700000]]=!values.d_nan
+r=TOTAL(y, /cumulative, /nan)
+if r[nbp-1] NE expected[nbp-1]-5-700000 then ERRORS_ADD, errors, 'cumulative /nan'
+;
+; same values whatever the number of threads
+a=RANDOMU(seed, nbp)
+c=COMPLEX(a, 1-a)
+b=RANDOMU(seed, 7, 3000, 5)
+res=PTRARR(2)
+for pass=0, 1 do begin
+   if pass EQ 0 then CPU, TPOOL_NTHREADS=1 else $
+      CPU, TPOOL_NTHREADS=!CPU.HW_NCPU > 4, TPOOL_MIN_ELTS=1000
+   r=LIST(TOTAL(a, /cumulative), TOTAL(c, /cumulative), PRODUCT(1+a*1e-6, /cumulative), $
+          TOTAL(b, 1, /cumulative), TOTAL(b, 2, /cumulative), TOTAL(b, 3, /cumulative), $
+          PRODUCT(1+b*1e-3, 2, /cumulative))
+   res[pass]=PTR_NEW(r)
+endfor
+CPU, RESTORE=SAVECPU
+r0=*res[0] & r1=*res[1]
+for i=0, N_ELEMENTS(r0)-1 do $
+   if ~ARRAY_EQUAL(r0[i], r1[i]) then ERRORS_ADD, errors, 'threads, case '+STRTRIM(i,2)
+PTR_FREE, res
+;
+; DIMENSION against an explicit cumulation
+r=TOTAL(b, 2, /cumulative)
+ref=b
+for j=1, 2999 do ref[*,j,*]=ref[*,j-1,*]+b[*,j,*]
+if ~ARRAY_EQUAL(r, ref) then ERRORS_ADD, errors, 'cumulative dimension 2'
+r=PRODUCT(b, 3, /cumulative)
+ref=b
+for k=1, 4 do ref[*,*,k]=ref[*,*,k-1]*b[*,*,k]
+if ~ARRAY_EQUAL(r, ref) then ERRORS_ADD, errors, 'product cumulative dimension 3'
+;
+BANNER_FOR_TESTSUITE, "TEST_TOTAL_CUMULATIVE", errors, /short, verb=verbose
+ERRORS_CUMUL, cumul_errors, errors
+if KEYWORD_SET(test) then STOP
+;
+end
+; -----------------------------------------------------------------
+;
 pro TEST_TOTAL, help=help, test=test, verbose=verbose, no_exit=no_exit
 ;
 if KEYWORD_SET(help) then begin
@@ -371,6 +483,10 @@ TEST_TOTAL_INT, cumul_errors, test=test, verbose=verbose
 ;
 TEST_TOTAL_DIM, cumul_errors, test=test, verbose=verbose
 ;
+TEST_TOTAL_REPRODUCIBLE, cumul_errors, test=test, verbose=verbose
+;
+TEST_TOTAL_CUMULATIVE, cumul_errors, test=test, verbose=verbose
+;
 ; ----------------- final message ----------
 ;
 BANNER_FOR_TESTSUITE, 'TEST_TOTAL', cumul_errors, short=short
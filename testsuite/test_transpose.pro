@@ -0,0 +1,79 @@
+;
+; under GNU GPL v2 or later
+;
+; TRANSPOSE of 2D to 5D arrays of all types, with and without
+; permutation, against an element by element reference. Sizes are
+; chosen to go through the tiles of the blocked kernels and their
+; borders, dimensions of size 1 and permutations keeping the first
+; dimension.
+;
+; ---------------------------------
+;
+; Modifications history :
+;
+; - 2026-10-19 : creation with the blocked TRANSPOSE
+;
+; ---------------------------------
+;
+pro TEST_TRANSPOSE_ONE, a, perm, nb_errors, label
+;
+dims=SIZE(a, /dim)
+nd=N_ELEMENTS(dims)
+if N_ELEMENTS(perm) EQ 0 then p=REVERSE(INDGEN(nd)) else p=perm
+if N_ELEMENTS(perm) EQ 0 then res=TRANSPOSE(a) else res=TRANSPOSE(a, perm)
+;
+resdims=dims[p]
+if ~ARRAY_EQUAL(SIZE(res, /dim), resdims) then begin
+   ERRORS_ADD, nb_errors, label+': dimensions'
+   return
+endif
+if SIZE(res, /type) NE SIZE(a, /type) then ERRORS_ADD, nb_errors, label+': type'
+;
+; reference: source index of each result element
+idx=L64INDGEN(N_ELEMENTS(a))
+rest=idx
+src=0LL*idx
+stride=LON64ARR(nd)+1
+for d=1, nd-1 do stride[d]=stride[d-1]*dims[d-1]
+for d=0, nd-1 do begin
+   src+=(rest MOD resdims[d])*stride[p[d]]
+   rest/=resdims[d]
+endfor
+if ~ARRAY_EQUAL(res[*], a[src]) then ERRORS_ADD, nb_errors, label
+end
+;
+; -------------------------------------------------
+;
+pro TEST_TRANSPOSE, no_exit=no_exit, test=test
+;
+nb_errors=0
+types=[1,2,3,4,5,6,7,9,12,13,14,15]
+shapes=LIST([67,45], [300,129], [50,1,3], [5,3,70], [17,1,9,4], [3,4,5,6,7])
+perms=LIST(!NULL, [0,1], [1,0,2], [0,2,1], [1,0,3,2], [4,0,1,2,3])
+for it=0, N_ELEMENTS(types)-1 do begin
+   for is=0, N_ELEMENTS(shapes)-1 do begin
+      sh=shapes[is]
+      a=FIX(LINDGEN(sh) MOD 30000, type=types[it])
+      if types[it] EQ 7 then a=STRTRIM(LINDGEN(sh),2)
+      if types[it] EQ 6 || types[it] EQ 9 then a=COMPLEX(LINDGEN(sh), -LINDGEN(sh), double=(types[it] EQ 9))
+      lab='type '+STRTRIM(types[it],2)+' shape '+STRJOIN(STRTRIM(sh,2),'x')
+      TEST_TRANSPOSE_ONE, a, perms[is], nb_errors, lab
+      ; the default permutation reverses all dimensions
+      TEST_TRANSPOSE_ONE, a, !NULL, nb_errors, lab+' default'
+   endfor
+endfor
+;
+; large 2D, over several threads
+b=FINDGEN(1031, 517)
+TEST_TRANSPOSE_ONE, b, !NULL, nb_errors, 'large float'
+TEST_TRANSPOSE_ONE, DOUBLE(b), !NULL, nb_errors, 'large double'
+;
+; ----------------- final message ----------
+;
+BANNER_FOR_TESTSUITE, 'TEST_TRANSPOSE', nb_errors
+;
+if (nb_errors GT 0) AND ~KEYWORD_SET(no_exit) then EXIT, status=1
+;
+if KEYWORD_SET(test) then STOP
+;
+end
@@ -0,0 +1,99 @@
+;
+; under GNU GPL v2 or later
+;
+; Tests of the native UNIQ(), against the definition used by the
+; former uniq.pro (WHERE(a NE SHIFT(a,-1))), and of the GDL
+; extension UNIQ(a, /UNSORTED) against UNIQ(a, SORT(a)).
+;
+; ---------------------------------
+;
+; Modifications history :
+;
+; - 2026-10-19 : creation when UNIQ became native
+;
+; ---------------------------------
+;
+function UNIQ_REFERENCE, arr, index
+;
+nEl=N_ELEMENTS(arr)
+if nEl le 1 then return, 0
+if N_PARAMS() eq 1 then begin
+   ix=WHERE(arr ne SHIFT(arr, -1))
+   if ix[0] ne -1 then return, ix else return, nEl-1
+endif
+tmp=arr[index]
+ix=WHERE(tmp ne SHIFT(tmp, -1))
+if ix[0] ne -1 then return, index[ix] else return, nEl-1
+end
+;
+; ---------------------------------
+;
+pro TEST_UNIQ_BASIC, cumul_errors, test=test
+;
+nb_errors=0
+;
+if ~ARRAY_EQUAL(UNIQ([1,1,2,2,2,3]), [1,4,5]) then ERRORS_ADD, nb_errors, 'sorted ints'
+if UNIQ(5) NE 0 then ERRORS_ADD, nb_errors, 'scalar'
+res=UNIQ([7,7,7,7])
+if (SIZE(res, /n_dim) NE 0) OR (res NE 3) then ERRORS_ADD, nb_errors, 'all equal'
+; the last element is compared to the first one
+if ~ARRAY_EQUAL(UNIQ([1,2,1]), [0,1]) then ERRORS_ADD, nb_errors, 'cyclic'
+if ~ARRAY_EQUAL(UNIQ(['a','a','b','c','c']), [1,2,4]) then ERRORS_ADD, nb_errors, 'strings'
+;
+a=[3,1,3,2,1]
+if ~ARRAY_EQUAL(UNIQ(a, SORT(a)), UNIQ_REFERENCE(a, SORT(a))) then ERRORS_ADD, nb_errors, 'with index'
+;
+; NaNs are never equal, each of them is unique
+b=[1.,!values.f_nan,!values.f_nan,2.]
+if ~ARRAY_EQUAL(UNIQ(b), UNIQ_REFERENCE(b)) then ERRORS_ADD, nb_errors, 'NaN'
+;
+BANNER_FOR_TESTSUITE, 'TEST_UNIQ_BASIC', nb_errors, /short
+ERRORS_CUMUL, cumul_errors, nb_errors
+if KEYWORD_set(test) then STOP
+;
+end
+;
+; ---------------------------------
+;
+pro TEST_UNIQ_RANDOM, cumul_errors, nbps, test=test
+;
+nb_errors=0
+;
+for type=1, 7 do begin
+   if type EQ 6 then continue
+   a=FIX(RANDOMU(seed, nbps)*(nbps/10), type=(type EQ 7) ? 3 : type)
+   if type EQ 7 then a=STRTRIM(a,2)
+   ix=SORT(a)
+   sa=a[ix]
+   if ~ARRAY_EQUAL(UNIQ(sa), UNIQ_REFERENCE(sa)) then $
+      ERRORS_ADD, nb_errors, 'sorted, type '+STRTRIM(type,2)
+   if ~ARRAY_EQUAL(UNIQ(a, ix), UNIQ_REFERENCE(a, ix)) then $
+      ERRORS_ADD, nb_errors, 'index, type '+STRTRIM(type,2)
+   ; only the choice among equal elements may differ
+   if ~ARRAY_EQUAL(a[UNIQ(a, /UNSORTED)], a[UNIQ(a, ix)]) then $
+      ERRORS_ADD, nb_errors, 'unsorted, type '+STRTRIM(type,2)
+endfor
+;
+BANNER_FOR_TESTSUITE, 'TEST_UNIQ_RANDOM', nb_errors, /short
+ERRORS_CUMUL, cumul_errors, nb_errors
+if KEYWORD_set(test) then STOP
+;
+end
+;
+; -------------------------------------------------
+;
+pro TEST_UNIQ, no_exit=no_exit, test=test
+;
+TEST_UNIQ_BASIC, cumul_errors
+TEST_UNIQ_RANDOM, cumul_errors, 1000
+TEST_UNIQ_RANDOM, cumul_errors, 1000000
+;
+; ----------------- final message ----------
+;
+BANNER_FOR_TESTSUITE, 'TEST_UNIQ', cumul_errors
+;
+if (cumul_errors GT 0) AND ~KEYWORD_SET(no_exit) then EXIT, status=1
+;
+if KEYWORD_SET(test) then STOP
+;
+end
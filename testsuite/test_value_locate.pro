@@ -0,0 +1,95 @@
+;
+; under GNU GPL v2 or later
+;
+; Tests of the native VALUE_LOCATE(), increasing and decreasing
+; vectors, values hitting the vector points, sorted and unsorted
+; values (different code paths), /L64 and output dimensions.
+;
+; ---------------------------------
+;
+; Modifications history :
+;
+; - 2026-10-19 : creation when VALUE_LOCATE became native
+;
+; ---------------------------------
+;
+pro TEST_VALUE_LOCATE_BASIC, cumul_errors, test=test
+;
+nb_errors=0
+;
+x=[0.,1,2,5,10]
+u=[-2.,0,0.5,1,4.9,5,10,11]
+exp=[-1,0,0,1,2,3,4,4]
+if ~ARRAY_EQUAL(VALUE_LOCATE(x, u), exp) then ERRORS_ADD, nb_errors, 'increasing'
+if ~ARRAY_EQUAL(VALUE_LOCATE(x, REVERSE(u)), REVERSE(exp)) then ERRORS_ADD, nb_errors, 'increasing, unsorted values'
+;
+; decreasing: Vector[i] >= Value > Vector[i+1]
+xd=REVERSE(x)
+ud=[11.,10.5,7,3,1.5,0.5,-1]
+expd=[-1,-1,0,1,2,3,4]
+if ~ARRAY_EQUAL(VALUE_LOCATE(xd, ud), expd) then ERRORS_ADD, nb_errors, 'decreasing'
+;
+; mixed types, scalar value, single element vector
+if ~ARRAY_EQUAL(VALUE_LOCATE(INDGEN(5), [1.5,3.5]), [1,3]) then ERRORS_ADD, nb_errors, 'mixed types'
+res=VALUE_LOCATE(x, 3)
+if (SIZE(res, /n_dim) NE 0) OR (res NE 2) then ERRORS_ADD, nb_errors, 'scalar'
+if ~ARRAY_EQUAL(VALUE_LOCATE([5], [4,5,6]), [-1,0,0]) then ERRORS_ADD, nb_errors, 'one element vector'
+;
+res=VALUE_LOCATE(x, REFORM(u, 2, 4), /L64)
+if SIZE(res, /type) NE 14 then ERRORS_ADD, nb_errors, '/L64 type'
+if ~ARRAY_EQUAL(SIZE(res, /dim), [2,4]) then ERRORS_ADD, nb_errors, 'dimensions'
+if ~ARRAY_EQUAL(res, REFORM(exp, 2, 4)) then ERRORS_ADD, nb_errors, '/L64 values'
+;
+BANNER_FOR_TESTSUITE, 'TEST_VALUE_LOCATE_BASIC', nb_errors, /short
+ERRORS_CUMUL, cumul_errors, nb_errors
+if KEYWORD_set(test) then STOP
+;
+end
+;
+; ---------------------------------
+;
+pro TEST_VALUE_LOCATE_RANDOM, cumul_errors, nbps, test=test
+;
+nb_errors=0
+;
+x=TOTAL(RANDOMU(seed, 1000), /cumulative)
+u=RANDOMU(seed, nbps)*(MAX(x)+2)-1
+;
+res=VALUE_LOCATE(x, u)
+ok=WHERE(res GE 0 AND res LT 999, nok)
+if nok GT 0 then begin
+   bad=WHERE(x[res[ok]] GT u[ok] OR x[res[ok]+1] LE u[ok], nbad)
+   if nbad GT 0 then ERRORS_ADD, nb_errors, 'random values'
+endif
+below=WHERE(res EQ -1, nbelow)
+if nbelow GT 0 then if MAX(u[below]) GE x[0] then ERRORS_ADD, nb_errors, 'below'
+above=WHERE(res EQ 999, nabove)
+if nabove GT 0 then if MIN(u[above]) LT x[999] then ERRORS_ADD, nb_errors, 'above'
+;
+; sorted values must give the same answers
+ix=SORT(u)
+if ~ARRAY_EQUAL(VALUE_LOCATE(x, u[ix]), res[ix]) then ERRORS_ADD, nb_errors, 'sorted values'
+;
+BANNER_FOR_TESTSUITE, 'TEST_VALUE_LOCATE_RANDOM', nb_errors, /short
+ERRORS_CUMUL, cumul_errors, nb_errors
+if KEYWORD_set(test) then STOP
+;
+end
+;
+; -------------------------------------------------
+;
+pro TEST_VALUE_LOCATE, no_exit=no_exit, test=test
+;
+TEST_VALUE_LOCATE_BASIC, cumul_errors
+TEST_VALUE_LOCATE_RANDOM, cumul_errors, 1000
+TEST_VALUE_LOCATE_RANDOM, cumul_errors, 1000000
+;
+; ----------------- final message ----------
+;
+BANNER_FOR_TESTSUITE, 'TEST_VALUE_LOCATE', cumul_errors
+;
+if (cumul_errors GT 0) AND ~KEYWORD_SET(no_exit) then EXIT, status=1
+;
+if KEYWORD_SET(test) then STOP
+;
+end
@@ -160,6 +160,313 @@ end
 ;
 ; ------------------------
 ;
+; sizes around the 64-element words and the chunks of the bit mask
+; used by WHERE, all types, against an explicit loop
+pro TEST_WHERE_MASK, cumul_errors, verbose=verbose, test=test
+;
+nb_errors=0
+seed=8
+SAVECPU=!CPU
+CPU, TPOOL_MIN_ELTS=1000
+foreach nbp, [1, 63, 64, 65, 1000, 262143, 262144, 262145, 1000003] do begin
+   for type=0, 4 do begin
+      r=RANDOMU(seed, nbp) LT 0.3
+      case type of
+         0: a=BYTE(r*(1+RANDOMU(seed, nbp)*254))
+         1: a=r*RANDOMN(seed, nbp)
+         2: a=LONG64(r)*(-3)
+         3: a=COMPLEX(r, r)
+         4: a=(['', 'x'])[r]
+      endcase
+      ; the true indices first, each group in increasing order
+      order=SORT((1-LONG64(r))*nbp+L64INDGEN(nbp))
+      k=LONG(TOTAL(r)) & kc=nbp-k
+      if k GT 0 then ref=order[0:k-1]
+      if kc GT 0 then refc=order[k:*]
+      lab='type '+STRTRIM(type,2)+' size '+STRTRIM(nbp,2)
+      w=WHERE(a, count, complement=c, ncomplement=nc)
+      if count NE k || nc NE kc then ERRORS_ADD, nb_errors, 'count '+lab
+      if k GT 0 then if ~ARRAY_EQUAL(w, ref) then ERRORS_ADD, nb_errors, 'indices '+lab
+      if kc GT 0 then if ~ARRAY_EQUAL(c, refc) then ERRORS_ADD, nb_errors, 'complement '+lab
+      if k EQ 0 && w[0] NE -1 then ERRORS_ADD, nb_errors, 'no index '+lab
+      if kc EQ 0 && c[0] NE -1 then ERRORS_ADD, nb_errors, 'no complement '+lab
+      w64=WHERE(a, /l64)
+      if k GT 0 then if SIZE(w64, /type) NE 14 || ~ARRAY_EQUAL(w64, ref) then $
+         ERRORS_ADD, nb_errors, '/L64 '+lab
+   endfor
+endforeach
+CPU, RESTORE=SAVECPU
+;
+BANNER_FOR_TESTSUITE, 'TEST_WHERE_MASK', nb_errors, /status
+ERRORS_CUMUL, cumul_errors, nb_errors
+if KEYWORD_SET(test) then STOP
+;
+end
+;
+; ------------------------
+;
+; a[WHERE(cond)]=value is done without the index array when possible:
+; compare to the assignment through the index in a variable
+pro TEST_WHERE_ASSIGN, cumul_errors, verbose=verbose, test=test
+;
+nb_errors=0
+seed=9
+SAVECPU=!CPU
+CPU, TPOOL_MIN_ELTS=1000
+foreach nbp, [1, 65, 262145, 1000003] do begin
+   lab=' size '+STRTRIM(nbp,2)
+   a=RANDOMN(seed, nbp)
+   b=a
+   a[WHERE(a LT 0, count)]=0
+   idx=WHERE(b LT 0, ref_count)
+   b[idx]=0
+   if ~ARRAY_EQUAL(a, b) || count NE ref_count then ERRORS_ADD, nb_errors, 'scalar'+lab
+   if !ERR NE ref_count then ERRORS_ADD, nb_errors, '!ERR'+lab
+   ; values of another type, converted
+   a=b
+   a[WHERE(FINITE(a) AND a EQ 0)]='7'
+   b[idx]=7
+   if ~ARRAY_EQUAL(a, b) then ERRORS_ADD, nb_errors, 'string value'+lab
+   ; an array of values, possibly longer than the number of indices
+   v=LINDGEN(nbp)+1
+   a[WHERE(a GT 1, count, /L64)]=v
+   idx=WHERE(b GT 1)
+   b[idx]=v
+   if ~ARRAY_EQUAL(a, b) then ERRORS_ADD, nb_errors, 'array values'+lab
+   if SIZE(count, /type) NE 14 then ERRORS_ADD, nb_errors, '/L64 count'+lab
+   ; no true element: same as through the -1 index
+   a[WHERE(a GT 100)]=-5
+   b[WHERE(b GT 100)]=-5
+   if ~ARRAY_EQUAL(a, b) then ERRORS_ADD, nb_errors, 'no index'+lab
+   ; other types, condition shorter than the array
+   s=STRING(b, format='(I0)')
+   t=s
+   s[WHERE(b[0:nbp/2] LT 3)]='x'
+   idx=WHERE(b[0:nbp/2] LT 3)
+   t[idx]='x'
+   if ~ARRAY_EQUAL(s, t) then ERRORS_ADD, nb_errors, 'string'+lab
+   c=COMPLEX(b, -b)
+   d=c
+   c[WHERE(c)]=COMPLEX(1, 2)
+   idx=WHERE(d)
+   d[idx]=COMPLEX(1, 2)
+   if ~ARRAY_EQUAL(c, d) then ERRORS_ADD, nb_errors, 'complex'+lab
+   ; not fused: COMPLEMENT
+   a[WHERE(a LT 3, complement=ca)]=1
+   idx=WHERE(b LT 3, complement=cb)
+   b[idx]=1
+   if ~ARRAY_EQUAL(a, b) || ~ARRAY_EQUAL(ca, cb) then ERRORS_ADD, nb_errors, 'complement'+lab
+endforeach
+; one index and an array: inserted
+a=FINDGEN(10)
+b=a
+a[WHERE(a EQ 3)]=[20, 21, 22]
+b[3]=[20, 21, 22]
+if ~ARRAY_EQUAL(a, b) then ERRORS_ADD, nb_errors, 'one index, array'
+; too few values
+CATCH, err
+if err EQ 0 then begin
+   a[WHERE(a GT 4)]=[1, 2]
+   ERRORS_ADD, nb_errors, 'too few values'
+endif
+CATCH, /cancel
+; not fused: other dimension, self assignment
+a=FINDGEN(4, 5)
+b=a
+a[1, WHERE(a[1,*] GT 6)]=-1
+b[1, [2, 3, 4]]=-1
+if ~ARRAY_EQUAL(a, b) then ERRORS_ADD, nb_errors, '2D'
+a=FINDGEN(10)-5
+b=a
+a[WHERE(a GE 0)]=a
+b[[5, 6, 7, 8, 9]]=b[0:4]
+if ~ARRAY_EQUAL(a, b) then ERRORS_ADD, nb_errors, 'self'
+CPU, RESTORE=SAVECPU
+;
+BANNER_FOR_TESTSUITE, 'TEST_WHERE_ASSIGN', nb_errors, /status
+ERRORS_CUMUL, cumul_errors, nb_errors
+if KEYWORD_SET(test) then STOP
+;
+end
+;
+; ------------------------
+;
+; WHERE(a op b) is made from the operands, without the BYTE array of the
+; comparison: compare to WHERE on the comparison stored in a variable
+function TEST_WHERE_COMPARE_FUSED, a, b, op, count, c, nc
+case op of
+   0: w=WHERE(a EQ b, count, complement=c, ncomplement=nc)
+   1: w=WHERE(a NE b, count, complement=c, ncomplement=nc)
+   2: w=WHERE(a LE b, count, complement=c, ncomplement=nc)
+   3: w=WHERE(a LT b, count, complement=c, ncomplement=nc)
+   4: w=WHERE(a GE b, count, complement=c, ncomplement=nc)
+   5: w=WHERE(a GT b, count, complement=c, ncomplement=nc)
+   ; operands which are expressions
+   6: w=WHERE(a*1 GT b*1, count, complement=c, ncomplement=nc)
+   7: w=WHERE(a*1 EQ b*1, count, complement=c, ncomplement=nc)
+endcase
+return, w
+end
+;
+function TEST_WHERE_COMPARE_REF, a, b, op, count, c, nc
+case op of
+   0: cond=a EQ b
+   1: cond=a NE b
+   2: cond=a LE b
+   3: cond=a LT b
+   4: cond=a GE b
+   5: cond=a GT b
+   6: cond=a*1 GT b*1
+   7: cond=a*1 EQ b*1
+endcase
+return, WHERE(cond, count, complement=c, ncomplement=nc)
+end
+;
+pro TEST_WHERE_COMPARE, cumul_errors, verbose=verbose, test=test
+;
+nb_errors=0
+seed=10
+SAVECPU=!CPU
+CPU, TPOOL_MIN_ELTS=1000
+foreach nbp, [1, 65, 4097, 262145, 1000003] do begin
+   x=FLOOR(RANDOMU(seed, nbp)*5)
+   y=FLOOR(RANDOMU(seed, nbp)*5)
+   f=RANDOMN(seed, nbp)
+   f[0]=!values.f_nan
+   ; same types, scalar on either side, mixed types, shorter array,
+   ; NaN, and types compared through their BYTE result
+   pairs=LIST(LIST(x, y), LIST(BYTE(x), 2b), LIST(3, UINT(y)), LIST(LONG64(x), y[0:nbp/2]), $
+              LIST(f, 0.), LIST(0d, f), LIST(FIX(x), DOUBLE(y)+0.5), LIST(ULONG(x), 2.5), $
+              LIST(COMPLEX(x, 0), COMPLEX(y, 0)), LIST(STRING(x), '2'))
+   foreach pr, pairs, k do begin
+      for op=0, 7 do begin
+         lab='pair '+STRTRIM(k,2)+' op '+STRTRIM(op,2)+' size '+STRTRIM(nbp,2)
+         if (k EQ 8 || k EQ 9) && op NE 0 && op NE 1 && op NE 7 then continue
+         if k EQ 9 && op EQ 7 then continue
+         w=TEST_WHERE_COMPARE_FUSED(pr[0], pr[1], op, count, c, nc)
+         r=TEST_WHERE_COMPARE_REF(pr[0], pr[1], op, rcount, rc, rnc)
+         if count NE rcount || nc NE rnc then ERRORS_ADD, nb_errors, 'count '+lab
+         if ~ARRAY_EQUAL(w, r) || ~ARRAY_EQUAL(c, rc) then ERRORS_ADD, nb_errors, lab
+         if SIZE(w, /type) NE 3 then ERRORS_ADD, nb_errors, 'type '+lab
+      endfor
+   endforeach
+   lab=' size '+STRTRIM(nbp,2)
+   ; /L64, /NULL, !ERR
+   w=WHERE(x GE 1, /L64)
+   if SIZE(w, /type) NE 14 || ~ARRAY_EQUAL(w, WHERE(BYTE(x GE 1))) then ERRORS_ADD, nb_errors, '/L64'+lab
+   w=WHERE(x GT 10, count, /NULL, complement=c)
+   if ~ISA(w, /null) || count NE 0 || N_ELEMENTS(c) NE nbp || !ERR NE 0 then ERRORS_ADD, nb_errors, '/NULL'+lab
+   w=WHERE(x LT 10, complement=c)
+   if c[0] NE -1 || N_ELEMENTS(w) NE nbp then ERRORS_ADD, nb_errors, 'no complement'+lab
+   ; a[WHERE(a op b)]=value
+   a=f
+   b=f
+   a[WHERE(a LT 0, count)]=0
+   b[WHERE(BYTE(b LT 0), ref_count)]=0
+   if ~ARRAY_EQUAL(a, b) || count NE ref_count then ERRORS_ADD, nb_errors, 'assign'+lab
+   a=x
+   b=x
+   a[WHERE(3 LE a)]=-LINDGEN(nbp)
+   b[WHERE(BYTE(3 LE b))]=-LINDGEN(nbp)
+   if ~ARRAY_EQUAL(a, b) then ERRORS_ADD, nb_errors, 'assign array'+lab
+endforeach
+; the count variable being an operand
+x=[1, 5, 2, 7]
+w=WHERE(x GT 2, x)
+if ~ARRAY_EQUAL(w, [1, 3]) || x NE 2 then ERRORS_ADD, nb_errors, 'count in operand'
+; pointers: through their BYTE result (and not ordered)
+p=PTRARR(3)
+w=WHERE(p EQ p[0], count)
+if count NE 3 then ERRORS_ADD, nb_errors, 'pointers'
+CATCH, err
+if err EQ 0 then begin
+   w=WHERE(p GT p)
+   ERRORS_ADD, nb_errors, 'pointers compared'
+endif
+CATCH, /cancel
+CPU, RESTORE=SAVECPU
+;
+BANNER_FOR_TESTSUITE, 'TEST_WHERE_COMPARE', nb_errors, /status
+ERRORS_CUMUL, cumul_errors, nb_errors
+if KEYWORD_SET(test) then STOP
+;
+end
+;
+; ------------------------
+;
+; WHERE of AND, OR and ~ of comparisons combines the masks of the
+; comparisons: compare to WHERE on the condition stored in a variable
+function TEST_WHERE_COMBINED_FUSED, x, y, f, s, op, count, c
+case op of
+   0: w=WHERE(x GT 0 AND y LT 3, count, complement=c)
+   1: w=WHERE(x GT 3 OR y LT 1, count, complement=c)
+   2: w=WHERE(~(x GT 2), count, complement=c)
+   3: w=WHERE((x GT 0 AND y LT 3) OR ~(f LT 0), count, complement=c)
+   4: w=WHERE(x GE 1 AND y[0:N_ELEMENTS(y)/2] LE 2, count, complement=c)
+   5: w=WHERE(s GT 0 AND x LT 3, count, complement=c)
+   6: w=WHERE(x LT 3 OR s GT 0, count, complement=c)
+   7: w=WHERE(STRING(x) EQ '2' OR y GT 3, count, complement=c)
+   8: w=WHERE(~(f GT 0 AND ~(x NE y)), count, complement=c)
+endcase
+return, w
+end
+;
+function TEST_WHERE_COMBINED_REF, x, y, f, s, op, count, c
+case op of
+   0: cond=x GT 0 AND y LT 3
+   1: cond=x GT 3 OR y LT 1
+   2: cond=~(x GT 2)
+   3: cond=(x GT 0 AND y LT 3) OR ~(f LT 0)
+   4: cond=x GE 1 AND y[0:N_ELEMENTS(y)/2] LE 2
+   5: cond=s GT 0 AND x LT 3
+   6: cond=x LT 3 OR s GT 0
+   7: cond=STRING(x) EQ '2' OR y GT 3
+   8: cond=~(f GT 0 AND ~(x NE y))
+endcase
+return, WHERE(cond, count, complement=c)
+end
+;
+pro TEST_WHERE_COMBINED, cumul_errors, verbose=verbose, test=test
+;
+nb_errors=0
+seed=11
+SAVECPU=!CPU
+CPU, TPOOL_MIN_ELTS=1000
+foreach nbp, [1, 65, 4097, 262145, 1000003] do begin
+   x=FLOOR(RANDOMU(seed, nbp)*5)
+   y=FLOOR(RANDOMU(seed, nbp)*5)
+   f=RANDOMN(seed, nbp)
+   f[0]=!values.f_nan
+   ; a scalar condition, true or false, with the arrays
+   foreach s, [1, -1] do begin
+      for op=0, 8 do begin
+         lab='op '+STRTRIM(op,2)+' s '+STRTRIM(s,2)+' size '+STRTRIM(nbp,2)
+         w=TEST_WHERE_COMBINED_FUSED(x, y, f, s, op, count, c)
+         r=TEST_WHERE_COMBINED_REF(x, y, f, s, op, rcount, rc)
+         if count NE rcount then ERRORS_ADD, nb_errors, 'count '+lab
+         if ~ARRAY_EQUAL(w, r) || ~ARRAY_EQUAL(c, rc) then ERRORS_ADD, nb_errors, lab
+      endfor
+   endforeach
+   ; two scalars
+   if WHERE(3 GT 2 AND 1 LT 0) NE -1 || WHERE(3 GT 2 OR 1 LT 0) NE 0 then $
+      ERRORS_ADD, nb_errors, 'scalars size '+STRTRIM(nbp,2)
+   ; a[WHERE(c1 AND c2)]=value
+   a=x
+   b=x
+   a[WHERE(x GT 1 AND y LT 3, count)]=-1
+   b[WHERE(BYTE(x GT 1 AND y LT 3), ref_count)]=-1
+   if ~ARRAY_EQUAL(a, b) || count NE ref_count then ERRORS_ADD, nb_errors, 'assign size '+STRTRIM(nbp,2)
+endforeach
+CPU, RESTORE=SAVECPU
+;
+BANNER_FOR_TESTSUITE, 'TEST_WHERE_COMBINED', nb_errors, /status
+ERRORS_CUMUL, cumul_errors, nb_errors
+if KEYWORD_SET(test) then STOP
+;
+end
+;
+; ------------------------
+;
 pro TEST_WHERE, size, help=help, verbose=verbose, no_exit=no_exit, test=test
 ;
 if KEYWORD_SET(help) then begin
@@ -177,6 +484,14 @@ TEST_WHERE_NULL, nb_errors, verbose=verbose
 ;
 TEST_WHERE_WITH_RANDOM, size, nb_errors, verbose=verbose
 ;
+TEST_WHERE_MASK, nb_errors, verbose=verbose
+;
+TEST_WHERE_ASSIGN, nb_errors, verbose=verbose
+;
+TEST_WHERE_COMPARE, nb_errors, verbose=verbose
+;
+TEST_WHERE_COMBINED, nb_errors, verbose=verbose
+;
 ; ----------------- final message ----------
 ;
 BANNER_FOR_TESTSUITE, 'TEST_WHERE', nb_errors